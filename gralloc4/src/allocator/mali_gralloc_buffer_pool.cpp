@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#include "gralloc_helper.h"
+#include "mali_gralloc_log.h"
+#include "mali_gralloc_buffer_pool.h"
+
+/* Pooled buffers checked for idleness by one allocation at most */
+#define GRALLOC_BUFFER_POOL_MAX_SCAN 16
+
+struct pool_key
+{
+	unsigned int heap_mask;
+	unsigned int flags;
+	size_t size;
+
+	bool operator<(const pool_key &op) const
+	{
+		if (heap_mask != op.heap_mask)
+		{
+			return heap_mask < op.heap_mask;
+		}
+		if (flags != op.flags)
+		{
+			return flags < op.flags;
+		}
+		return size < op.size;
+	}
+};
+
+struct pooled_buffer;
+typedef std::list<pooled_buffer> pooled_list;
+typedef std::multimap<pool_key, pooled_list::iterator> pooled_index;
+
+struct pooled_buffer
+{
+	int fd;
+	pool_key key;
+	uint64_t freed_ms;
+	pooled_index::iterator index;
+};
+
+struct lent_buffer
+{
+	pool_key key;
+	buffer_pool_backend *backend;
+};
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static buffer_pool_backend *pool_backend = nullptr;
+static size_t pool_size = GRALLOC_BUFFER_POOL_SIZE;
+static size_t pooled_bytes = 0;
+/* Freed buffers, oldest first */
+static pooled_list pooled;
+static pooled_index pooled_by_key;
+/* Recyclable buffers given out, by fd */
+static std::unordered_map<int, lent_buffer> lent;
+static std::map<unsigned int, buffer_pool_heap_stats> heap_stats;
+/* Wakes the trim thread when the pool gets empty */
+static pthread_cond_t trim_cond;
+static pthread_once_t trim_cond_once = PTHREAD_ONCE_INIT;
+static bool trim_thread_running = false;
+
+static uint64_t now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static buffer_pool_heap_stats &get_heap_stats(unsigned int heap_mask)
+{
+	buffer_pool_heap_stats &stats = heap_stats[heap_mask];
+
+	stats.heap_mask = heap_mask;
+	return stats;
+}
+
+/* Takes a buffer out of the pool, returns its fd */
+static int unpool_locked(pooled_list::iterator it)
+{
+	int fd = it->fd;
+
+	pooled_bytes -= it->key.size;
+	get_heap_stats(it->key.heap_mask).pooled_bytes -= it->key.size;
+	pooled_by_key.erase(it->index);
+	pooled.erase(it);
+
+	return fd;
+}
+
+/*
+ * Releases pooled buffers that are too old and then the oldest ones until
+ * at most max_bytes are left. The fds to close are added to fds, closing
+ * them can take long so it is done without pool_lock.
+ */
+static void trim_locked(size_t max_bytes, uint64_t now, std::vector<int> &fds)
+{
+	while (!pooled.empty() &&
+	       (pooled_bytes > max_bytes || now - pooled.front().freed_ms > GRALLOC_BUFFER_POOL_MAX_AGE_MS))
+	{
+		get_heap_stats(pooled.front().key.heap_mask).trimmed++;
+		fds.push_back(unpool_locked(pooled.begin()));
+	}
+
+	if (pooled.empty() && trim_thread_running)
+	{
+		pthread_cond_signal(&trim_cond);
+	}
+}
+
+static void close_fds(const std::vector<int> &fds)
+{
+	for (int fd : fds)
+	{
+		close(fd);
+	}
+}
+
+static void init_trim_cond(void)
+{
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&trim_cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+/*
+ * Releases the buffers that expire while the allocator is idle, nothing else
+ * trims the pool then. It runs as long as buffers are pooled.
+ */
+static void *trim_thread(void *arg)
+{
+	std::vector<int> fds;
+
+	GRALLOC_UNUSED(arg);
+
+	pthread_mutex_lock(&pool_lock);
+	while (!pooled.empty())
+	{
+		const uint64_t expiry_ms = pooled.front().freed_ms + GRALLOC_BUFFER_POOL_MAX_AGE_MS + 1;
+		const struct timespec expiry = { (time_t)(expiry_ms / 1000), (long)(expiry_ms % 1000) * 1000000 };
+
+		pthread_cond_timedwait(&trim_cond, &pool_lock, &expiry);
+		trim_locked(pool_size, now_ms(), fds);
+		if (!fds.empty())
+		{
+			pthread_mutex_unlock(&pool_lock);
+			close_fds(fds);
+			fds.clear();
+			pthread_mutex_lock(&pool_lock);
+		}
+	}
+	trim_thread_running = false;
+	pthread_mutex_unlock(&pool_lock);
+
+	return nullptr;
+}
+
+static void start_trim_thread_locked(void)
+{
+	pthread_t thread;
+
+	if (trim_thread_running)
+	{
+		return;
+	}
+
+	pthread_once(&trim_cond_once, init_trim_cond);
+	if (pthread_create(&thread, nullptr, trim_thread, nullptr) != 0)
+	{
+		MALI_GRALLOC_LOGW("no buffer pool trim thread, idle buffers are kept until the next allocation");
+		return;
+	}
+	pthread_detach(thread);
+	trim_thread_running = true;
+}
+
+bool mali_gralloc_dmabuf_idle(int fd)
+{
+	char path[64];
+	char info[1024];
+	ssize_t len;
+	int info_fd;
+
+	snprintf(path, sizeof(path), "/proc/self/fdinfo/%d", fd);
+	info_fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (info_fd < 0)
+	{
+		return false;
+	}
+
+	len = read(info_fd, info, sizeof(info) - 1);
+	close(info_fd);
+	if (len <= 0)
+	{
+		return false;
+	}
+	info[len] = '\0';
+
+	return mali_gralloc_fdinfo_idle(info);
+}
+
+bool mali_gralloc_fdinfo_idle(const char *fdinfo)
+{
+	/* Kernels without the dma-buf fdinfo give no count, their buffers are never reused */
+	const char *count = strstr(fdinfo, "\ncount:");
+	if (count == nullptr)
+	{
+		return false;
+	}
+
+	return strtol(count + strlen("\ncount:"), nullptr, 10) == 1;
+}
+
+class memfd_backend : public buffer_pool_backend
+{
+public:
+	const char *name() const override
+	{
+		return "memfd";
+	}
+
+	int alloc(size_t size, unsigned int heap_mask, unsigned int flags) override
+	{
+		GRALLOC_UNUSED(heap_mask);
+		GRALLOC_UNUSED(flags);
+
+		int fd = syscall(__NR_memfd_create, "gralloc", MFD_CLOEXEC);
+		if (fd < 0)
+		{
+			MALI_GRALLOC_LOGE("memfd_create failed with %s", strerror(errno));
+			return -1;
+		}
+
+		if (ftruncate(fd, size) != 0)
+		{
+			MALI_GRALLOC_LOGE("ftruncate( %zu ) failed with %s", size, strerror(errno));
+			close(fd);
+			return -1;
+		}
+
+		return fd;
+	}
+
+	/* memfd buffers are never sent to another process */
+	bool idle(int fd) override
+	{
+		GRALLOC_UNUSED(fd);
+		return true;
+	}
+};
+
+buffer_pool_backend *mali_gralloc_memfd_backend(void)
+{
+	static memfd_backend backend;
+	return &backend;
+}
+
+void mali_gralloc_buffer_pool_set_backend(buffer_pool_backend *backend)
+{
+	std::vector<int> fds;
+
+	pthread_mutex_lock(&pool_lock);
+	if (pool_backend != backend)
+	{
+		trim_locked(0, now_ms(), fds);
+		pool_backend = backend;
+	}
+	pthread_mutex_unlock(&pool_lock);
+
+	close_fds(fds);
+}
+
+int mali_gralloc_buffer_pool_alloc(size_t size, unsigned int heap_mask, unsigned int flags, bool recycle)
+{
+	const pool_key key = { heap_mask, flags, size };
+	buffer_pool_backend *backend;
+	std::vector<int> fds;
+	bool pool_empty;
+	int fd = -1;
+
+	pthread_mutex_lock(&pool_lock);
+	backend = pool_backend;
+	if (backend == nullptr)
+	{
+		pthread_mutex_unlock(&pool_lock);
+		MALI_GRALLOC_LOGE("no buffer pool backend");
+		return -1;
+	}
+
+	if (recycle && pool_size > 0)
+	{
+		buffer_pool_heap_stats &stats = get_heap_stats(heap_mask);
+		int scanned = 0;
+
+		trim_locked(pool_size, now_ms(), fds);
+
+		/* The smallest idle buffer of the same heap and flags that is large enough */
+		for (auto it = pooled_by_key.lower_bound(key);
+		     it != pooled_by_key.end() && it->first.heap_mask == heap_mask && it->first.flags == flags &&
+		     it->first.size <= size + size / GRALLOC_BUFFER_POOL_SLACK && scanned < GRALLOC_BUFFER_POOL_MAX_SCAN;
+		     ++it, scanned++)
+		{
+			if (backend->idle(it->second->fd))
+			{
+				const pool_key pooled_key = it->first;
+
+				fd = unpool_locked(it->second);
+				lent[fd] = { pooled_key, backend };
+				stats.allocated_bytes += pooled_key.size;
+				stats.hits++;
+				break;
+			}
+		}
+
+		if (fd < 0)
+		{
+			stats.misses++;
+		}
+	}
+	pool_empty = pooled.empty();
+	pthread_mutex_unlock(&pool_lock);
+
+	close_fds(fds);
+	if (fd >= 0)
+	{
+		return fd;
+	}
+
+	fd = backend->alloc(size, heap_mask, flags);
+	if (fd < 0 && !pool_empty)
+	{
+		/* Out of memory, give the pooled buffers back and try again */
+		MALI_GRALLOC_LOGW("%s allocation of %zu bytes failed, trimming the buffer pool", backend->name(), size);
+		mali_gralloc_buffer_pool_trim(0);
+		fd = backend->alloc(size, heap_mask, flags);
+	}
+
+	if (fd >= 0 && recycle)
+	{
+		pthread_mutex_lock(&pool_lock);
+		lent[fd] = { key, backend };
+		get_heap_stats(heap_mask).allocated_bytes += size;
+		pthread_mutex_unlock(&pool_lock);
+	}
+
+	return fd;
+}
+
+void mali_gralloc_buffer_pool_free(int fd)
+{
+	std::vector<int> fds;
+
+	if (fd < 0)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&pool_lock);
+	auto it = lent.find(fd);
+	if (it == lent.end())
+	{
+		pthread_mutex_unlock(&pool_lock);
+		close(fd);
+		return;
+	}
+
+	const lent_buffer buffer = it->second;
+	lent.erase(it);
+	get_heap_stats(buffer.key.heap_mask).allocated_bytes -= buffer.key.size;
+
+	if (buffer.backend != pool_backend || buffer.key.size > pool_size)
+	{
+		fds.push_back(fd);
+	}
+	else
+	{
+		const uint64_t now = now_ms();
+
+		pooled.push_back({ fd, buffer.key, now, pooled_by_key.end() });
+		pooled.back().index = pooled_by_key.insert({ buffer.key, std::prev(pooled.end()) });
+		pooled_bytes += buffer.key.size;
+		get_heap_stats(buffer.key.heap_mask).pooled_bytes += buffer.key.size;
+
+		trim_locked(pool_size, now, fds);
+		if (!pooled.empty())
+		{
+			start_trim_thread_locked();
+		}
+	}
+	pthread_mutex_unlock(&pool_lock);
+
+	close_fds(fds);
+}
+
+void mali_gralloc_buffer_pool_trim(size_t max_bytes)
+{
+	std::vector<int> fds;
+
+	pthread_mutex_lock(&pool_lock);
+	trim_locked(max_bytes, now_ms(), fds);
+	pthread_mutex_unlock(&pool_lock);
+
+	close_fds(fds);
+}
+
+void mali_gralloc_buffer_pool_set_size(size_t max_bytes)
+{
+	std::vector<int> fds;
+
+	pthread_mutex_lock(&pool_lock);
+	pool_size = max_bytes;
+	trim_locked(pool_size, now_ms(), fds);
+	pthread_mutex_unlock(&pool_lock);
+
+	close_fds(fds);
+}
+
+void mali_gralloc_buffer_pool_get_stats(std::vector<buffer_pool_heap_stats> &stats)
+{
+	stats.clear();
+
+	pthread_mutex_lock(&pool_lock);
+	for (const auto &heap : heap_stats)
+	{
+		stats.push_back(heap.second);
+	}
+	pthread_mutex_unlock(&pool_lock);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MALI_GRALLOC_BUFFER_POOL_H_
+#define MALI_GRALLOC_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Bytes of freed buffers kept for reuse, 0 disables recycling.
+ * Boards set it with SOONG_CONFIG_arm_gralloc_gralloc_buffer_pool_size.
+ */
+#ifndef GRALLOC_BUFFER_POOL_SIZE
+#define GRALLOC_BUFFER_POOL_SIZE (64 * 1024 * 1024)
+#endif
+
+/* A pooled buffer not reused for this long is released, by a thread if the allocator is idle */
+#ifndef GRALLOC_BUFFER_POOL_MAX_AGE_MS
+#define GRALLOC_BUFFER_POOL_MAX_AGE_MS 5000
+#endif
+
+/* Buffers of the same heap and flags are reused for requests up to 1/N smaller */
+#define GRALLOC_BUFFER_POOL_SLACK 8
+
+/*
+ * Source of the buffers of the pool.
+ */
+class buffer_pool_backend
+{
+public:
+	virtual ~buffer_pool_backend() {}
+
+	virtual const char *name() const = 0;
+
+	/*
+	 * Allocates a buffer
+	 *
+	 * @param size      [in]    Buffer size (in bytes).
+	 * @param heap_mask [in]    Heaps to allocate from.
+	 * @param flags     [in]    Allocation attributes.
+	 *
+	 * @return File descriptor of the buffer, on success
+	 *         -1, otherwise.
+	 */
+	virtual int alloc(size_t size, unsigned int heap_mask, unsigned int flags) = 0;
+
+	/*
+	 * @return true when fd holds the last reference to its buffer, so no
+	 *         other process can still see the buffer.
+	 */
+	virtual bool idle(int fd) = 0;
+};
+
+/* dmabuf fds, idle when the file count in fdinfo is 1 */
+bool mali_gralloc_dmabuf_idle(int fd);
+
+/* The check of mali_gralloc_dmabuf_idle() on the text of /proc/<pid>/fdinfo/<fd> */
+bool mali_gralloc_fdinfo_idle(const char *fdinfo);
+
+/* memfd buffers, for tests and benchmarks on a Linux host */
+buffer_pool_backend *mali_gralloc_memfd_backend(void);
+
+struct buffer_pool_heap_stats
+{
+	unsigned int heap_mask;
+	uint64_t allocated_bytes; /* buffers given out by the pool */
+	uint64_t pooled_bytes;    /* freed buffers kept for reuse */
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t trimmed;         /* pooled buffers released unused */
+};
+
+/*
+ * Sets the backend of the pool. Buffers pooled from the previous backend are
+ * released, the ones still given out go back to it when freed.
+ */
+void mali_gralloc_buffer_pool_set_backend(buffer_pool_backend *backend);
+
+/*
+ * Allocates a buffer, recycling a freed one when allowed
+ *
+ * @param size      [in]    Requested buffer size (in bytes).
+ * @param heap_mask [in]    Heaps to allocate from.
+ * @param flags     [in]    Allocation attributes.
+ * @param recycle   [in]    A freed buffer with stale content may be returned.
+ *
+ * @return File descriptor of the buffer, on success
+ *         -1, otherwise.
+ */
+int mali_gralloc_buffer_pool_alloc(size_t size, unsigned int heap_mask, unsigned int flags, bool recycle);
+
+/*
+ * Frees a buffer from mali_gralloc_buffer_pool_alloc(). Any other fd is closed.
+ */
+void mali_gralloc_buffer_pool_free(int fd);
+
+/*
+ * Releases pooled buffers until at most max_bytes are left.
+ */
+void mali_gralloc_buffer_pool_trim(size_t max_bytes);
+
+/*
+ * Sets the size of the pool, trimming it if needed. 0 disables recycling.
+ */
+void mali_gralloc_buffer_pool_set_size(size_t max_bytes);
+
+void mali_gralloc_buffer_pool_get_stats(std::vector<buffer_pool_heap_stats> &stats);
+
+#endif /* MALI_GRALLOC_BUFFER_POOL_H_ */
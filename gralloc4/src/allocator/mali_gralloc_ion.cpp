@@ -27,6 +27,8 @@
 #include <cutils/atomic.h>
 
 #include <linux/dma-buf.h>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <sys/ioctl.h>
 
@@ -44,6 +46,7 @@
 #include "core/mali_gralloc_bufferallocation.h"
 
 #include "mali_gralloc_ion.h"
+#include "mali_gralloc_buffer_pool.h"
 
 #define INIT_ZERO(obj) (memset(&(obj), 0, sizeof((obj))))
 
@@ -68,6 +71,7 @@ struct ion_device
 		ion_device &dev = get_inst();
 		if (dev.ion_client >= 0)
 		{
+			mali_gralloc_buffer_pool_set_backend(nullptr);
 			exynos_ion_close(dev.ion_client);
 			dev.ion_client = -1;
 		}
@@ -99,14 +103,44 @@ struct ion_device
 	 * @param heap_type [in]    Requested heap type.
 	 * @param flags     [in]    ION allocation attributes defined by ION_FLAG_*.
 	 * @param min_pgsz  [out]   Minimum page size (in bytes).
+	 * @param recycle   [in]    A freed buffer with stale content may be returned.
 	 *
 	 * @return File handle which can be used for allocation, on success
 	 *         -1, otherwise.
 	 */
-	int alloc_from_ion_heap(uint64_t usage, size_t size, unsigned int flags, int *min_pgsz);
+	int alloc_from_ion_heap(uint64_t usage, size_t size, unsigned int flags, int *min_pgsz, bool recycle);
 
 private:
+	/* Allocates the buffers of the buffer pool from ION */
+	class ion_backend : public buffer_pool_backend
+	{
+	public:
+		ion_backend(int client)
+		    : ion_client(client)
+		{
+		}
+
+		const char *name() const override
+		{
+			return "ion";
+		}
+
+		int alloc(size_t size, unsigned int heap_mask, unsigned int flags) override
+		{
+			return exynos_ion_alloc(ion_client, size, heap_mask, flags);
+		}
+
+		bool idle(int fd) override
+		{
+			return mali_gralloc_dmabuf_idle(fd);
+		}
+
+	private:
+		int ion_client;
+	};
+
 	int ion_client;
+	std::unique_ptr<ion_backend> backend;
 
 	ion_device()
 	    : ion_client(-1)
@@ -235,7 +269,7 @@ static unsigned int select_heap_mask(uint64_t usage)
 	return heap_mask;
 }
 
-int ion_device::alloc_from_ion_heap(uint64_t usage, size_t size, unsigned int flags, int *min_pgsz)
+int ion_device::alloc_from_ion_heap(uint64_t usage, size_t size, unsigned int flags, int *min_pgsz, bool recycle)
 {
 	int shared_fd = -1;
 	int ret = -1;
@@ -250,7 +284,7 @@ int ion_device::alloc_from_ion_heap(uint64_t usage, size_t size, unsigned int fl
 
 	unsigned int heap_mask = select_heap_mask(usage);
 
-	shared_fd = exynos_ion_alloc(ion_client, size, heap_mask, flags);
+	shared_fd = mali_gralloc_buffer_pool_alloc(size, heap_mask, flags, recycle);
 
 	*min_pgsz = SZ_4K;
 
@@ -274,6 +308,9 @@ int ion_device::open_and_query_ion()
 		return -1;
 	}
 
+	backend.reset(new ion_backend(ion_client));
+	mali_gralloc_buffer_pool_set_backend(backend.get());
+
 	return 0;
 }
 
@@ -353,6 +390,154 @@ int mali_gralloc_ion_sync_end(const private_handle_t * const hnd,
 }
 
 
+/*
+ * Syncs part of a dma-buf.
+ *
+ * @return true, when the range was synced;
+ *         false, when the whole buffer has to be synced instead
+ */
+static bool dmabuf_sync_partial(const int fd, const ion_sync_range_t &range,
+                                const bool read, const bool write, const bool start)
+{
+#ifdef DMA_BUF_IOCTL_SYNC_PARTIAL
+	/* Cleared when the kernel does not support partial dma-buf syncs, buffers are synced from any thread */
+	static std::atomic<bool> supported(true);
+
+	if (!supported.load(std::memory_order_relaxed) || range.offset > UINT32_MAX || range.size > UINT32_MAX)
+	{
+		return false;
+	}
+
+	struct dma_buf_sync_partial sync;
+	sync.flags = (start ? DMA_BUF_SYNC_START : DMA_BUF_SYNC_END) |
+	             (read ? DMA_BUF_SYNC_READ : 0) |
+	             (write ? DMA_BUF_SYNC_WRITE : 0);
+	sync.offset = (uint32_t)range.offset;
+	sync.len = (uint32_t)range.size;
+
+	if (ioctl(fd, DMA_BUF_IOCTL_SYNC_PARTIAL, &sync) < 0)
+	{
+		if (errno == ENOTTY)
+		{
+			MALI_GRALLOC_LOGW("partial dma-buf sync unsupported, syncing whole buffers");
+			supported.store(false, std::memory_order_relaxed);
+		}
+		return false;
+	}
+
+	return true;
+#else
+	GRALLOC_UNUSED(fd);
+	GRALLOC_UNUSED(range);
+	GRALLOC_UNUSED(read);
+	GRALLOC_UNUSED(write);
+	GRALLOC_UNUSED(start);
+	return false;
+#endif
+}
+
+static int mali_gralloc_ion_sync_range(const private_handle_t * const hnd,
+                                       const bool read,
+                                       const bool write,
+                                       const bool start,
+                                       const ion_sync_range_t *ranges,
+                                       const int num_ranges)
+{
+	int ret = 0;
+
+	if (hnd == NULL)
+	{
+		return -EINVAL;
+	}
+
+	ion_device *dev = ion_device::get();
+	int direction = 0;
+
+	if (read)
+	{
+		direction |= ION_SYNC_READ;
+	}
+	if (write)
+	{
+		direction |= ION_SYNC_WRITE;
+	}
+
+	/* fds without a range are not accessed by the CPU and are skipped */
+	for (int idx = 0; idx < hnd->fd_count; idx++)
+	{
+		bool full = false;
+
+		for (int i = 0; i < num_ranges && !full; i++)
+		{
+			if (ranges[i].fd_idx == idx)
+			{
+				full = !dmabuf_sync_partial(hnd->fds[idx], ranges[i], read, write, start);
+			}
+		}
+
+		if (!full)
+		{
+			continue;
+		}
+
+		if (start)
+		{
+			ret |= exynos_ion_sync_start(dev->client(), hnd->fds[idx], direction);
+		}
+		else
+		{
+			ret |= exynos_ion_sync_end(dev->client(), hnd->fds[idx], direction);
+		}
+	}
+
+	return ret;
+}
+
+
+/*
+ * Signal start of CPU access to parts of the DMABUFs exported from ION.
+ *
+ * @param hnd        [in]    Buffer handle
+ * @param read       [in]    Flag indicating CPU read access to memory
+ * @param write      [in]    Flag indicating CPU write access to memory
+ * @param ranges     [in]    Bytes accessed by the CPU, other fds are not synced
+ * @param num_ranges [in]    Number of ranges
+ *
+ * @return              0 in case of success
+ *                      errno for all error cases
+ */
+int mali_gralloc_ion_sync_range_start(const private_handle_t * const hnd,
+                                      const bool read,
+                                      const bool write,
+                                      const ion_sync_range_t *ranges,
+                                      const int num_ranges)
+{
+	return mali_gralloc_ion_sync_range(hnd, read, write, true, ranges, num_ranges);
+}
+
+
+/*
+ * Signal end of CPU access to parts of the DMABUFs exported from ION.
+ *
+ * @param hnd        [in]    Buffer handle
+ * @param read       [in]    Flag indicating CPU read access to memory
+ * @param write      [in]    Flag indicating CPU write access to memory
+ * @param ranges     [in]    Bytes accessed by the CPU, other fds are not synced
+ * @param num_ranges [in]    Number of ranges
+ *
+ * @return              0 in case of success
+ *                      errno for all error cases
+ */
+int mali_gralloc_ion_sync_range_end(const private_handle_t * const hnd,
+                                    const bool read,
+                                    const bool write,
+                                    const ion_sync_range_t *ranges,
+                                    const int num_ranges)
+{
+	return mali_gralloc_ion_sync_range(hnd, read, write, false, ranges, num_ranges);
+}
+
+
 void mali_gralloc_ion_free(private_handle_t * const hnd)
 {
 	for (int i = 0; i < hnd->fd_count; i++)
@@ -368,7 +553,7 @@ void mali_gralloc_ion_free(private_handle_t * const hnd)
 				MALI_GRALLOC_LOGE("Failed to munmap handle %p", hnd);
 			}
 		}
-		close(hnd->fds[i]);
+		mali_gralloc_buffer_pool_free(hnd->fds[i]);
 		hnd->fds[i] = -1;
 		hnd->bases[i] = 0;
 	}
@@ -409,7 +594,7 @@ int mali_gralloc_ion_allocate_attr(private_handle_t *hnd)
 
 	ion_flags = ION_FLAG_CACHED;
 
-	hnd->fds[idx] = dev->alloc_from_ion_heap(usage, hnd->attr_size, ion_flags, &min_pgsz);
+	hnd->fds[idx] = dev->alloc_from_ion_heap(usage, hnd->attr_size, ion_flags, &min_pgsz, false);
 	if (hnd->fds[idx] < 0)
 	{
 		MALI_GRALLOC_LOGE("ion_alloc failed from client ( %d )", dev->client());
@@ -468,7 +653,7 @@ static int allocate_to_container(buffer_descriptor_t *bufDescriptor, uint32_t io
 		for (int fidx = 0; fidx < bufDescriptor->fd_count; fidx++)
 		{
 			hfr_fds[fidx][layer] =dev->alloc_from_ion_heap(usage,
-					bufDescriptor->alloc_sizes[fidx], ion_flags, min_pgsz);
+					bufDescriptor->alloc_sizes[fidx], ion_flags, min_pgsz, false);
 
 			if (hfr_fds[fidx][layer] < 0)
 			{
@@ -567,9 +752,15 @@ int mali_gralloc_ion_allocate(const gralloc_buffer_descriptor_t *descriptors,
 		}
 		else
 		{
+			/*
+			 * Only buffers the client did not need zeroed are recycled, they may
+			 * hold the content of a buffer freed earlier by this process.
+			 */
+			const bool recycle = (ion_flags & ION_FLAG_NOZEROED) && !(ion_flags & ION_FLAG_PROTECTED);
+
 			for (int fidx = 0; fidx < bufDescriptor->fd_count; fidx++)
 			{
-				fds[fidx] = dev->alloc_from_ion_heap(usage, bufDescriptor->alloc_sizes[fidx], ion_flags, &min_pgsz);
+				fds[fidx] = dev->alloc_from_ion_heap(usage, bufDescriptor->alloc_sizes[fidx], ion_flags, &min_pgsz, recycle);
 
 				if (fds[fidx] < 0)
 				{
@@ -577,7 +768,7 @@ int mali_gralloc_ion_allocate(const gralloc_buffer_descriptor_t *descriptors,
 
 					for (int cidx = 0; cidx < fidx; cidx++)
 					{
-						close(fds[cidx]);
+						mali_gralloc_buffer_pool_free(fds[cidx]);
 					}
 
 					/* need to free already allocated memory. not just this one */
@@ -604,7 +795,7 @@ int mali_gralloc_ion_allocate(const gralloc_buffer_descriptor_t *descriptors,
 			/* Close the obtained shared file descriptor for the current handle */
 			for (int j = 0; j < bufDescriptor->fd_count; j++)
 			{
-				close(fds[j]);
+				mali_gralloc_buffer_pool_free(fds[j]);
 			}
 
 			mali_gralloc_ion_free_internal(pHandle, numDescriptors);
@@ -29,6 +29,21 @@ int mali_gralloc_ion_sync_start(const private_handle_t * const hnd,
                                 const bool read, const bool write);
 int mali_gralloc_ion_sync_end(const private_handle_t * const hnd,
                               const bool read, const bool write);
+
+/* Bytes of one buffer fd, for cache maintenance of part of a buffer */
+typedef struct
+{
+	int fd_idx;
+	uint64_t offset;
+	uint64_t size;
+} ion_sync_range_t;
+
+int mali_gralloc_ion_sync_range_start(const private_handle_t * const hnd,
+                                      const bool read, const bool write,
+                                      const ion_sync_range_t *ranges, const int num_ranges);
+int mali_gralloc_ion_sync_range_end(const private_handle_t * const hnd,
+                                    const bool read, const bool write,
+                                    const ion_sync_range_t *ranges, const int num_ranges);
 int mali_gralloc_ion_map(private_handle_t *hnd);
 void mali_gralloc_ion_unmap(private_handle_t *hnd);
 void mali_gralloc_ion_close(void);
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018-2020 ARM Limited. All rights reserved.
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FORMAT_INDEX_H_
+#define FORMAT_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Format ID to table index hash, built at compile time from a format table.
+ *
+ * Entries are placed with linear probing, so the first of several entries
+ * with the same ID is found first, as with a linear scan of the table. The
+ * longest probe sequence is computed with the table and bounds the lookup.
+ */
+#define FORMAT_INDEX_BITS 8
+#define FORMAT_INDEX_SIZE (1 << FORMAT_INDEX_BITS)
+#define FORMAT_INDEX_MAX_PROBE 8
+
+typedef struct
+{
+	int16_t idx[FORMAT_INDEX_SIZE];  /* Table index, -1 where empty. */
+	uint8_t max_probe;               /* Longest probe sequence. */
+} format_index_t;
+
+static constexpr uint32_t format_index_hash(const uint32_t id)
+{
+	return (id * 0x9e3779b1u) >> (32 - FORMAT_INDEX_BITS);
+}
+
+template <typename T, size_t N, uint32_t T::*key>
+static constexpr format_index_t make_format_index(const T (&table)[N])
+{
+	format_index_t index = {};
+
+	for (int slot = 0; slot < FORMAT_INDEX_SIZE; slot++)
+	{
+		index.idx[slot] = -1;
+	}
+
+	for (size_t i = 0; i < N; i++)
+	{
+		const uint32_t hash = format_index_hash(table[i].*key);
+		uint8_t probe = 0;
+
+		while (index.idx[(hash + probe) % FORMAT_INDEX_SIZE] != -1)
+		{
+			probe++;
+		}
+		index.idx[(hash + probe) % FORMAT_INDEX_SIZE] = (int16_t)i;
+
+		if (probe > index.max_probe)
+		{
+			index.max_probe = probe;
+		}
+	}
+
+	return index;
+}
+
+template <typename T, size_t N, uint32_t T::*key>
+static inline int32_t lookup_format_index(const format_index_t &index, const T (&table)[N], const uint32_t id)
+{
+	const uint32_t hash = format_index_hash(id);
+
+	for (int probe = 0; probe <= index.max_probe; probe++)
+	{
+		const int32_t idx = index.idx[(hash + probe) % FORMAT_INDEX_SIZE];
+		if (idx < 0)
+		{
+			break;
+		}
+		if (table[idx].*key == id)
+		{
+			return idx;
+		}
+	}
+
+	return -1;
+}
+
+#endif
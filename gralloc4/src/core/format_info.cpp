@@ -19,6 +19,7 @@
 #include "gralloc_helper.h"
 #include "mali_gralloc_formats.h"
 #include "format_info.h"
+#include "format_index.h"
 #include "mali_gralloc_usages.h"
 #include <exynos_format.h>
 
@@ -31,7 +32,7 @@
  * NOTE: This table should only be used within
  * the gralloc library and not by clients directly.
  */
-const format_info_t formats[] = {
+constexpr format_info_t formats[] = {
 	{
 		.id = MALI_GRALLOC_FORMAT_INTERNAL_RGB_565,
 		.npln = 1, .ncmp = { 3, 0, 0 }, .bps = 6, .bpp_afbc = { 16, 0, 0 }, .bpp = { 16, 0, 0 },
@@ -387,13 +388,13 @@ const format_info_t formats[] = {
 	{ .id = HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC_L60,  .npln = 2, .ncmp = {1, 2, 0}, .bps = 10, .bpp_afbc = { 0, 0, 0 },   .bpp = { 16, 32, 0 }, .hsub = 2, .vsub = 2, .align_w = 2, .align_h = 2, ALIGN_W_CPU_DEFAULT, .tile_size = 1, .has_alpha = false, .is_rgb = false, .is_yuv = true,  .afbc = false,  .linear = true, .yuv_transform = false, .flex = true,  },
 	{ .id = HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC_L80,  .npln = 2, .ncmp = {1, 2, 0}, .bps = 10, .bpp_afbc = { 0, 0, 0 },   .bpp = { 16, 32, 0 }, .hsub = 2, .vsub = 2, .align_w = 2, .align_h = 2, ALIGN_W_CPU_DEFAULT, .tile_size = 1, .has_alpha = false, .is_rgb = false, .is_yuv = true,  .afbc = false,  .linear = true, .yuv_transform = false, .flex = true,  },
 };
-const size_t num_formats = sizeof(formats)/sizeof(formats[0]);
+constexpr size_t num_formats = sizeof(formats)/sizeof(formats[0]);
 
 /*
  * This table represents the superset of flags for each base format and producer/consumer.
  * Where IP does not support a capability, it should be defined and not set.
  */
-const format_ip_support_t formats_ip_support[] = {
+constexpr format_ip_support_t formats_ip_support[] = {
 	{
 		.id = MALI_GRALLOC_FORMAT_INTERNAL_RGB_565,
 		.cpu_rd = F_LIN,
@@ -872,7 +873,7 @@ const format_ip_support_t formats_ip_support[] = {
 	{ .id = HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC_L80,  .cpu_wr = F_LIN,  .cpu_rd = F_LIN,   .gpu_wr = F_LIN         , .gpu_rd = F_LIN         , .dpu_wr = F_NONE, .dpu_rd = F_LIN,               .dpu_aeu_wr = F_NONE, .vpu_wr = F_LIN,  .vpu_rd = F_LIN},
 };
 
-const size_t num_ip_formats = sizeof(formats_ip_support)/sizeof(formats_ip_support[0]);
+constexpr size_t num_ip_formats = sizeof(formats_ip_support)/sizeof(formats_ip_support[0]);
 
 typedef struct
 {
@@ -882,7 +883,7 @@ typedef struct
 } hal_int_fmt;
 
 
-static const hal_int_fmt hal_to_internal_format[] =
+static constexpr hal_int_fmt hal_to_internal_format[] =
 {
 	{ HAL_PIXEL_FORMAT_RGBA_8888,              false, MALI_GRALLOC_FORMAT_INTERNAL_RGBA_8888 },
 	{ HAL_PIXEL_FORMAT_RGBX_8888,              false, MALI_GRALLOC_FORMAT_INTERNAL_RGBX_8888 },
@@ -948,7 +949,34 @@ static const hal_int_fmt hal_to_internal_format[] =
 	{ HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC_L80,  false, HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC_L80  },
 };
 
-const size_t num_hal_formats = sizeof(hal_to_internal_format)/sizeof(hal_to_internal_format[0]);
+static constexpr size_t num_hal_formats = sizeof(hal_to_internal_format)/sizeof(hal_to_internal_format[0]);
+
+
+static constexpr format_index_t formats_index =
+	make_format_index<format_info_t, num_formats, &format_info_t::id>(formats);
+static constexpr format_index_t formats_ip_support_index =
+	make_format_index<format_ip_support_t, num_ip_formats, &format_ip_support_t::id>(formats_ip_support);
+static constexpr format_index_t hal_to_internal_format_index =
+	make_format_index<hal_int_fmt, num_hal_formats, &hal_int_fmt::hal_format>(hal_to_internal_format);
+
+static_assert(num_formats < FORMAT_INDEX_SIZE / 2 &&
+              num_ip_formats < FORMAT_INDEX_SIZE / 2 &&
+              num_hal_formats < FORMAT_INDEX_SIZE / 2,
+              "FORMAT_INDEX_BITS too small for the format tables");
+static_assert(formats_index.max_probe <= FORMAT_INDEX_MAX_PROBE &&
+              formats_ip_support_index.max_probe <= FORMAT_INDEX_MAX_PROBE &&
+              hal_to_internal_format_index.max_probe <= FORMAT_INDEX_MAX_PROBE,
+              "format index probe sequence too long, change format_index_hash()");
+
+
+/*
+ * Same as get_format_index() without logging, for queries where an
+ * unknown format is an expected answer.
+ */
+int32_t find_format_index(const uint32_t base_format)
+{
+	return lookup_format_index<format_info_t, num_formats, &format_info_t::id>(formats_index, formats, base_format);
+}
 
 
 /*
@@ -962,15 +990,8 @@ const size_t num_hal_formats = sizeof(hal_to_internal_format)/sizeof(hal_to_inte
  */
 int32_t get_format_index(const uint32_t base_format)
 {
-	int32_t format_idx;
-	for (format_idx = 0; format_idx < (int32_t)num_formats; format_idx++)
-	{
-		if (formats[format_idx].id == base_format)
-		{
-			break;
-		}
-	}
-	if (format_idx >= (int32_t)num_formats)
+	const int32_t format_idx = find_format_index(base_format);
+	if (format_idx < 0)
 	{
 		MALI_GRALLOC_LOGE("ERROR: Format allocation info not found for format: %" PRIx32, base_format);
 		return -1;
@@ -982,15 +1003,11 @@ int32_t get_format_index(const uint32_t base_format)
 
 int32_t get_ip_format_index(const uint32_t base_format)
 {
-	int32_t format_idx;
-	for (format_idx = 0; format_idx < (int32_t)num_ip_formats; format_idx++)
-	{
-		if (formats_ip_support[format_idx].id == base_format)
-		{
-			break;
-		}
-	}
-	if (format_idx >= (int32_t)num_ip_formats)
+	const int32_t format_idx =
+		lookup_format_index<format_ip_support_t, num_ip_formats, &format_ip_support_t::id>(formats_ip_support_index,
+		                                                                                    formats_ip_support,
+		                                                                                    base_format);
+	if (format_idx < 0)
 	{
 		MALI_GRALLOC_LOGE("ERROR: IP support not found for format: %" PRIx32, base_format);
 		return -1;
@@ -1018,16 +1035,11 @@ uint32_t get_internal_format(const uint32_t base_format, const bool map_to_inter
 {
 	uint32_t internal_format = base_format;
 
-	for (int idx = 0; idx < (int)num_hal_formats; idx++)
+	const int32_t idx = lookup_format_index<hal_int_fmt, num_hal_formats, &hal_int_fmt::hal_format>(
+		hal_to_internal_format_index, hal_to_internal_format, base_format);
+	if (idx >= 0 && (hal_to_internal_format[idx].is_flex || map_to_internal))
 	{
-		if (hal_to_internal_format[idx].hal_format == base_format)
-		{
-			if (hal_to_internal_format[idx].is_flex || map_to_internal)
-			{
-				internal_format = hal_to_internal_format[idx].internal_format;
-			}
-			break;
-		}
+		internal_format = hal_to_internal_format[idx].internal_format;
 	}
 
 	/* Ensure internal format is valid when expected. */
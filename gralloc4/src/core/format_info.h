@@ -103,6 +103,7 @@ extern const size_t num_formats;
 extern const size_t num_ip_formats;
 
 extern int32_t get_format_index(const uint32_t base_format);
+extern int32_t find_format_index(const uint32_t base_format);
 extern int32_t get_ip_format_index(const uint32_t base_format);
 extern uint32_t get_internal_format(const uint32_t base_format, const bool map_to_internal);
 void get_format_dataspace(uint32_t base_format,
@@ -18,6 +18,9 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <inttypes.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 /* For error codes. */
 #include <hardware/gralloc1.h>
 
@@ -25,6 +28,7 @@
 #include "mali_gralloc_formats.h"
 #include "mali_gralloc_usages.h"
 #include "allocator/mali_gralloc_ion.h"
+#include "mali_gralloc_bufferaccess.h"
 #include "gralloc_helper.h"
 #include "format_info.h"
 
@@ -60,18 +64,121 @@ static enum tx_direction get_tx_direction(const uint64_t usage)
 	return dir;
 }
 
+/* Buffers locked by this process */
+static std::mutex lock_ranges_mutex;
+static std::unordered_map<const private_handle_t *, lock_ranges_t> lock_ranges;
+
+
+/*
+ *  Computes the rows of each plane covered by an access region.
+ *
+ * @param hnd      [in]    Buffer handle.
+ * @param t        [in]    Access region top offset (in pixels).
+ * @param h        [in]    Access region requested height (in pixels).
+ * @param out      [out]   Byte ranges, num_ranges is -1 where the whole
+ *                         buffer must be synced.
+ *
+ * Whole rows are synced, a row of a plane is contiguous in memory. Exynos
+ * private layouts (tiled, SBWC, separate 2-bit planes), compressed and
+ * multi-layer buffers are synced whole.
+ */
+void get_lock_ranges(const private_handle_t * const hnd, const int t, const int h,
+                     lock_ranges_t * const out)
+{
+	const uint32_t base_format = hnd->alloc_format & MALI_GRALLOC_INTFMT_FMT_MASK;
+
+	out->num_ranges = -1;
+
+	if (is_exynos_format(base_format) || base_format == HAL_PIXEL_FORMAT_BLOB ||
+	    (hnd->alloc_format & MALI_GRALLOC_INTFMT_EXT_MASK) != 0 ||
+	    hnd->layer_count > 1 || h <= 0)
+	{
+		return;
+	}
+
+	const int32_t format_idx = get_format_index(base_format);
+	if (format_idx < 0 || !formats[format_idx].linear)
+	{
+		return;
+	}
+
+	const format_info_t &info = formats[format_idx];
+	for (int pidx = 0; pidx < info.npln && pidx < MAX_PLANES; pidx++)
+	{
+		const plane_info_t &plane = hnd->plane_info[pidx];
+		const uint64_t vsub = (pidx > 0 && info.is_yuv && info.vsub > 1) ? info.vsub : 1;
+		const uint64_t first = t / vsub;
+		const uint64_t last = std::min<uint64_t>((t + h + vsub - 1) / vsub, plane.alloc_height);
+
+		if (plane.byte_stride == 0 || last <= first)
+		{
+			return;
+		}
+
+		out->ranges[pidx].fd_idx = plane.fd_idx;
+		out->ranges[pidx].offset = plane.offset + first * plane.byte_stride;
+		out->ranges[pidx].size = (last - first) * plane.byte_stride;
+	}
+
+	out->num_ranges = info.npln;
+}
+
+
+/* Extends the ranges of a buffer locked again without an unlock */
+static void merge_lock_ranges(lock_ranges_t * const ranges, const lock_ranges_t &add)
+{
+	if (ranges->num_ranges != add.num_ranges)
+	{
+		ranges->num_ranges = -1;
+		return;
+	}
+
+	for (int i = 0; i < ranges->num_ranges; i++)
+	{
+		const uint64_t begin = std::min(ranges->ranges[i].offset, add.ranges[i].offset);
+		const uint64_t end = std::max(ranges->ranges[i].offset + ranges->ranges[i].size,
+		                              add.ranges[i].offset + add.ranges[i].size);
+
+		ranges->ranges[i].offset = begin;
+		ranges->ranges[i].size = end - begin;
+	}
+}
+
+
 static void buffer_sync(private_handle_t * const hnd,
-                        const enum tx_direction direction)
+                        const enum tx_direction direction,
+                        const int t, const int h)
 {
 	if (direction != TX_NONE)
 	{
+		lock_ranges_t ranges;
+		get_lock_ranges(hnd, t, h, &ranges);
+
+		{
+			std::lock_guard<std::mutex> lock(lock_ranges_mutex);
+			auto it = lock_ranges.find(hnd);
+			if (it != lock_ranges.end() && (hnd->cpu_read || hnd->cpu_write))
+			{
+				merge_lock_ranges(&it->second, ranges);
+			}
+			else
+			{
+				lock_ranges[hnd] = ranges;
+			}
+		}
+
 		hnd->cpu_read = (direction == TX_FROM_DEVICE || direction == TX_BOTH) ? 1 : 0;
 		hnd->cpu_write = (direction == TX_TO_DEVICE || direction == TX_BOTH) ? 1 : 0;
 
 #if defined(GRALLOC_ION_SYNC_ON_LOCK) && GRALLOC_ION_SYNC_ON_LOCK == 1
-		const int status = mali_gralloc_ion_sync_start(hnd,
+		const int status = (ranges.num_ranges < 0) ?
+		                   mali_gralloc_ion_sync_start(hnd,
 		                                               hnd->cpu_read ? true : false,
-		                                               hnd->cpu_write ? true : false);
+		                                               hnd->cpu_write ? true : false) :
+		                   mali_gralloc_ion_sync_range_start(hnd,
+		                                                     hnd->cpu_read ? true : false,
+		                                                     hnd->cpu_write ? true : false,
+		                                                     ranges.ranges, ranges.num_ranges);
 		if (status < 0)
 		{
 			return;
@@ -80,10 +187,28 @@ static void buffer_sync(private_handle_t * const hnd,
 	}
 	else if (hnd->cpu_read || hnd->cpu_write)
 	{
+		lock_ranges_t ranges;
+		ranges.num_ranges = -1;
+
+		{
+			std::lock_guard<std::mutex> lock(lock_ranges_mutex);
+			auto it = lock_ranges.find(hnd);
+			if (it != lock_ranges.end())
+			{
+				ranges = it->second;
+				lock_ranges.erase(it);
+			}
+		}
+
 #if defined(GRALLOC_ION_SYNC_ON_LOCK) && GRALLOC_ION_SYNC_ON_LOCK == 1
-		const int status = mali_gralloc_ion_sync_end(hnd,
+		const int status = (ranges.num_ranges < 0) ?
+		                   mali_gralloc_ion_sync_end(hnd,
 		                                             hnd->cpu_read ? true : false,
-		                                             hnd->cpu_write ? true : false);
+		                                             hnd->cpu_write ? true : false) :
+		                   mali_gralloc_ion_sync_range_end(hnd,
+		                                                   hnd->cpu_read ? true : false,
+		                                                   hnd->cpu_write ? true : false,
+		                                                   ranges.ranges, ranges.num_ranges);
 		if (status < 0)
 		{
 			return;
@@ -249,7 +374,7 @@ int mali_gralloc_lock(buffer_handle_t buffer,
 
 		*vaddr = (void *)hnd->bases[0];
 
-		buffer_sync(hnd, get_tx_direction(usage));
+		buffer_sync(hnd, get_tx_direction(usage), t, h);
 	}
 
 	return 0;
@@ -279,7 +404,7 @@ int mali_gralloc_unlock(buffer_handle_t buffer)
 	}
 
 	private_handle_t *hnd = (private_handle_t *)buffer;
-	buffer_sync(hnd, TX_NONE);
+	buffer_sync(hnd, TX_NONE, 0, 0);
 
 	return 0;
 }
@@ -20,6 +20,17 @@
 #define MALI_GRALLOC_BUFFERACCESS_H_
 
 #include "gralloc_priv.h"
+#include "allocator/mali_gralloc_ion.h"
+
+/* Bytes of a locked buffer that the CPU may access */
+typedef struct
+{
+	int num_ranges;                      /* -1 for the whole buffer. */
+	ion_sync_range_t ranges[MAX_PLANES]; /* One per plane. */
+} lock_ranges_t;
+
+void get_lock_ranges(const private_handle_t * const hnd, const int t, const int h,
+                     lock_ranges_t * const out);
 
 int mali_gralloc_lock(buffer_handle_t buffer, uint64_t usage, int l, int t, int w, int h,
                       void **vaddr);
@@ -24,6 +24,7 @@
 #include <hardware/hardware.h>
 
 #include "mali_gralloc_debug.h"
+#include "allocator/mali_gralloc_buffer_pool.h"
 
 static pthread_mutex_t dump_lock = PTHREAD_MUTEX_INITIALIZER;
 static std::vector<private_handle_t *> dump_buffers;
@@ -95,6 +96,21 @@ void mali_gralloc_dump_buffers(android::String8 &dumpStrings, uint32_t *outSize)
 	}
 
 	pthread_mutex_unlock(&dump_lock);
+
+	std::vector<buffer_pool_heap_stats> pool_stats;
+	mali_gralloc_buffer_pool_get_stats(pool_stats);
+	if (!pool_stats.empty())
+	{
+		mali_gralloc_dump_string(dumpStrings, "\n  heap mask |  allocated |     pooled |     hits |   misses |  trimmed |\n");
+		for (const buffer_pool_heap_stats &stats : pool_stats)
+		{
+			mali_gralloc_dump_string(dumpStrings, "  %08x | %10" PRIu64 " | %10" PRIu64 " | %8" PRIu64 " | %8" PRIu64
+			                                      " | %8" PRIu64 " |\n",
+			                         stats.heap_mask, stats.allocated_bytes, stats.pooled_bytes, stats.hits,
+			                         stats.misses, stats.trimmed);
+		}
+	}
+
 	mali_gralloc_dump_string(
 	    dumpStrings, "---------------------End dump Gralloc buffers info with num %zu----------------------\n", num);
 
@@ -428,20 +428,10 @@ static format_support_flags ip_supports_base_format(const uint16_t producers,
  */
 bool is_subsampled_yuv(const uint32_t base_format)
 {
-	unsigned long i;
+	const int32_t format_idx = find_format_index(base_format & MALI_GRALLOC_INTFMT_FMT_MASK);
 
-	for (i = 0; i < num_formats; i++)
-	{
-		if (formats[i].id == (base_format & MALI_GRALLOC_INTFMT_FMT_MASK))
-		{
-			if (formats[i].is_yuv == true &&
-			    (formats[i].hsub > 1 || formats[i].vsub > 1))
-			{
-				return true;
-			}
-		}
-	}
-	return false;
+	return format_idx >= 0 && formats[format_idx].is_yuv == true &&
+	       (formats[format_idx].hsub > 1 || formats[format_idx].vsub > 1);
 }
 
 
@@ -18,13 +18,48 @@
 
 #include <hardware/gralloc1.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
 #include "mali_gralloc_buffer.h"
 #include "allocator/mali_gralloc_ion.h"
 #include "allocator/mali_gralloc_shared_memory.h"
 #include "mali_gralloc_bufferallocation.h"
 #include "mali_gralloc_debug.h"
 
-static pthread_mutex_t s_map_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Number of independently locked parts of the registry. Must be a power of 2. */
+#define REFERENCE_SHARDS 16
+
+/* A first retain mapping its buffer */
+struct reference_mapping
+{
+	int waiters;   /* Other retains of the buffer waiting for the mapping. */
+	bool done;
+	int result;
+};
+
+/*
+ * Handles are spread over the shards by address, a shard lock only
+ * serializes the retains and releases of its handles. The first retain
+ * of a handle maps it without holding the lock, other retains of that
+ * handle wait for the mapping in 'mapped'.
+ */
+struct reference_shard
+{
+	std::mutex lock;
+	std::condition_variable mapped;
+	std::unordered_map<const private_handle_t *, reference_mapping> mapping;
+} __attribute__((aligned(64)));
+
+static reference_shard s_shards[REFERENCE_SHARDS];
+
+static reference_shard &get_shard(const private_handle_t *hnd)
+{
+	/* Handles are heap allocated, skip the bits alignment leaves at zero */
+	const uintptr_t key = reinterpret_cast<uintptr_t>(hnd);
+	return s_shards[((key >> 4) ^ (key >> 12)) & (REFERENCE_SHARDS - 1)];
+}
 
 int mali_gralloc_reference_retain(buffer_handle_t handle)
 {
@@ -35,13 +70,31 @@ int mali_gralloc_reference_retain(buffer_handle_t handle)
 	}
 
 	private_handle_t *hnd = (private_handle_t *)handle;
-	pthread_mutex_lock(&s_map_lock);
+	reference_shard &shard = get_shard(hnd);
+	std::unique_lock<std::mutex> lock(shard.lock);
 
 	if (hnd->allocating_pid == getpid() || hnd->remote_pid == getpid())
 	{
+		int retval = 0;
+
 		hnd->ref_count++;
-		pthread_mutex_unlock(&s_map_lock);
-		return 0;
+
+		auto it = shard.mapping.find(hnd);
+		if (it != shard.mapping.end())
+		{
+			reference_mapping &mapping = it->second;
+
+			mapping.waiters++;
+			shard.mapped.wait(lock, [&mapping] { return mapping.done; });
+			retval = mapping.result;
+
+			if (--mapping.waiters == 0)
+			{
+				shard.mapping.erase(hnd);
+			}
+		}
+
+		return retval;
 	}
 	else
 	{
@@ -49,12 +102,26 @@ int mali_gralloc_reference_retain(buffer_handle_t handle)
 		hnd->ref_count = 1;
 	}
 
+	reference_mapping &mapping = shard.mapping[hnd];
+	mapping = { 0, false, 0 };
+	lock.unlock();
+
 	int retval= mali_gralloc_ion_map(hnd);
 
 	/* Import ION handle to let ION driver know who's using the buffer */
 	import_exynos_ion_handles(hnd);
 
-	pthread_mutex_unlock(&s_map_lock);
+	lock.lock();
+	mapping.done = true;
+	mapping.result = retval;
+	if (mapping.waiters == 0)
+	{
+		shard.mapping.erase(hnd);
+	}
+	else
+	{
+		shard.mapped.notify_all();
+	}
 
 	return retval;
 }
@@ -68,12 +135,11 @@ int mali_gralloc_reference_release(buffer_handle_t handle, bool canFree)
 	}
 
 	private_handle_t *hnd = (private_handle_t *)handle;
-	pthread_mutex_lock(&s_map_lock);
+	std::lock_guard<std::mutex> lock(get_shard(hnd).lock);
 
 	if (hnd->ref_count == 0)
 	{
 		MALI_GRALLOC_LOGE("Buffer %p should have already been released", handle);
-		pthread_mutex_unlock(&s_map_lock);
 		return -EINVAL;
 	}
 
@@ -111,6 +177,5 @@ int mali_gralloc_reference_release(buffer_handle_t handle, bool canFree)
 		     hnd->remote_pid, getpid());
 	}
 
-	pthread_mutex_unlock(&s_map_lock);
 	return 0;
 }
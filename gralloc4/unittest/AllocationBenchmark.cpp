@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of the allocation path off-device: format negotiation and size
+ * calculation, whole allocations and AFBC header initialisation, for the
+ * buffer mixes of the main gralloc clients. Each benchmark runs with IP
+ * capabilities without and with AFBC, and reports latency percentiles.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <exynos_format.h>
+#include <hardware/gralloc1.h>
+
+#include "FakeCapabilities.h"
+#include "core/mali_gralloc_bufferallocation.h"
+#include "core/mali_gralloc_bufferdescriptor.h"
+#include "mali_gralloc_usages.h"
+
+struct BufferRequest
+{
+	uint32_t width;
+	uint32_t height;
+	uint64_t format;
+	uint64_t usage;
+};
+
+typedef std::vector<BufferRequest> UsageMix;
+
+static const UsageMix kCameraMix = {
+	/* Preview, still capture, RAW and JPEG output */
+	{ 1920, 1080, HAL_PIXEL_FORMAT_IMPLEMENTATION_DEFINED,
+	  GRALLOC_USAGE_HW_CAMERA_WRITE | GRALLOC_USAGE_HW_COMPOSER | GRALLOC_USAGE_HW_TEXTURE },
+	{ 4032, 3024, HAL_PIXEL_FORMAT_YCBCR_420_888,
+	  GRALLOC_USAGE_HW_CAMERA_WRITE | GRALLOC_USAGE_SW_READ_OFTEN },
+	{ 4032, 3024, HAL_PIXEL_FORMAT_RAW16,
+	  GRALLOC_USAGE_HW_CAMERA_WRITE | GRALLOC_USAGE_SW_READ_OFTEN },
+	{ 4032 * 3024, 1, HAL_PIXEL_FORMAT_BLOB,
+	  GRALLOC_USAGE_HW_CAMERA_WRITE | GRALLOC_USAGE_SW_READ_OFTEN },
+};
+
+static const UsageMix kVideoDecodeMix = {
+	/* 4K and FHD decoder output, 8 and 10 bit */
+	{ 3840, 2160, HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M,
+	  GRALLOC_USAGE_HW_VIDEO_DECODER | GRALLOC_USAGE_DECODER },
+	{ 1920, 1080, HAL_PIXEL_FORMAT_YCBCR_420_888,
+	  GRALLOC_USAGE_HW_VIDEO_DECODER | GRALLOC_USAGE_HW_TEXTURE | GRALLOC_USAGE_HW_COMPOSER },
+	{ 3840, 2160, HAL_PIXEL_FORMAT_YCBCR_P010,
+	  GRALLOC_USAGE_HW_VIDEO_DECODER | GRALLOC_USAGE_HW_TEXTURE | GRALLOC_USAGE_HW_COMPOSER },
+	{ 1920, 1080, HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC,
+	  GRALLOC_USAGE_HW_VIDEO_DECODER | GRALLOC_USAGE_DECODER },
+};
+
+static const UsageMix kComposerMix = {
+	/* Client target, app layers, cursor and an HDR layer */
+	{ 2400, 1080, HAL_PIXEL_FORMAT_RGBA_8888,
+	  GRALLOC_USAGE_HW_FB | GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_COMPOSER },
+	{ 1080, 2400, HAL_PIXEL_FORMAT_RGBA_8888,
+	  GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE | GRALLOC_USAGE_HW_COMPOSER },
+	{ 64, 64, HAL_PIXEL_FORMAT_RGBA_8888,
+	  GRALLOC_USAGE_CURSOR | GRALLOC_USAGE_SW_WRITE_OFTEN | GRALLOC_USAGE_HW_COMPOSER },
+	{ 1080, 2400, HAL_PIXEL_FORMAT_RGBA_1010102,
+	  GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE | GRALLOC_USAGE_HW_COMPOSER },
+};
+
+static const UsageMix kGpuMix = {
+	/* Textures, render targets and a CPU written texture */
+	{ 1024, 1024, HAL_PIXEL_FORMAT_RGBA_8888, GRALLOC_USAGE_HW_TEXTURE },
+	{ 2048, 2048, HAL_PIXEL_FORMAT_RGBA_FP16, GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE },
+	{ 512, 512, HAL_PIXEL_FORMAT_RGB_565, GRALLOC_USAGE_HW_TEXTURE | GRALLOC_USAGE_SW_WRITE_OFTEN },
+	{ 1920, 1080, HAL_PIXEL_FORMAT_RGBA_8888, GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE },
+};
+
+static buffer_descriptor_t makeDescriptor(const BufferRequest &request)
+{
+	buffer_descriptor_t descriptor;
+
+	descriptor.width = request.width;
+	descriptor.height = request.height;
+	descriptor.layer_count = 1;
+	descriptor.hal_format = request.format;
+	descriptor.producer_usage = request.usage;
+	descriptor.consumer_usage = request.usage;
+	descriptor.format_type = MALI_GRALLOC_FORMAT_TYPE_USAGE;
+	descriptor.signature = sizeof(buffer_descriptor_t);
+
+	return descriptor;
+}
+
+/* Times single operations and reports their latency percentiles */
+class LatencyRecorder
+{
+public:
+	explicit LatencyRecorder(benchmark::State &state) : state(state)
+	{
+	}
+
+	~LatencyRecorder()
+	{
+		if (samples.empty())
+		{
+			return;
+		}
+
+		std::sort(samples.begin(), samples.end());
+		state.counters["p50_ns"] = percentile(0.50);
+		state.counters["p90_ns"] = percentile(0.90);
+		state.counters["p99_ns"] = percentile(0.99);
+		state.counters["max_ns"] = samples.back();
+	}
+
+	template <typename Op>
+	void time(Op op)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		op();
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+		samples.push_back(elapsed.count());
+		state.SetIterationTime(elapsed.count() / 1e9);
+	}
+
+private:
+	double percentile(double p) const
+	{
+		return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+	}
+
+	benchmark::State &state;
+	std::vector<double> samples;
+};
+
+static void applyCapabilities(benchmark::State &state)
+{
+	setFakeCapabilities(static_cast<FakeCapabilities>(state.range(0)));
+}
+
+/* Format negotiation, including calc_allocation_size */
+static void BM_DeriveFormatAndSize(benchmark::State &state, const UsageMix &mix)
+{
+	applyCapabilities(state);
+
+	LatencyRecorder latency(state);
+	size_t next = 0;
+
+	for (auto _ : state)
+	{
+		buffer_descriptor_t descriptor = makeDescriptor(mix[next++ % mix.size()]);
+		int err = 0;
+
+		latency.time([&] { err = mali_gralloc_derive_format_and_size(&descriptor); });
+		if (err != 0)
+		{
+			state.SkipWithError("mali_gralloc_derive_format_and_size failed");
+			break;
+		}
+		benchmark::DoNotOptimize(descriptor.alloc_sizes[0]);
+	}
+}
+
+/* Whole allocations, the buffers are freed outside of the timed section */
+static void BM_BufferAllocate(benchmark::State &state, const UsageMix &mix)
+{
+	applyCapabilities(state);
+
+	LatencyRecorder latency(state);
+	size_t next = 0;
+
+	for (auto _ : state)
+	{
+		buffer_descriptor_t descriptor = makeDescriptor(mix[next++ % mix.size()]);
+		gralloc_buffer_descriptor_t gralloc_descriptor = reinterpret_cast<gralloc_buffer_descriptor_t>(&descriptor);
+		buffer_handle_t handle = nullptr;
+		int err = 0;
+
+		latency.time([&] { err = mali_gralloc_buffer_allocate(&gralloc_descriptor, 1, &handle, nullptr); });
+		if (err != 0)
+		{
+			state.SkipWithError("mali_gralloc_buffer_allocate failed");
+			break;
+		}
+		mali_gralloc_buffer_free(handle);
+	}
+}
+
+/* Each mix with IP capabilities without (afbc:0) and with AFBC (afbc:1) */
+#define MIX_ARGS ArgName("afbc")->DenseRange(FAKE_CAPS_LINEAR, FAKE_CAPS_AFBC)->UseManualTime()
+
+BENCHMARK_CAPTURE(BM_DeriveFormatAndSize, camera, kCameraMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_DeriveFormatAndSize, video_decode, kVideoDecodeMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_DeriveFormatAndSize, composer, kComposerMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_DeriveFormatAndSize, gpu, kGpuMix)->MIX_ARGS;
+
+BENCHMARK_CAPTURE(BM_BufferAllocate, camera, kCameraMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_BufferAllocate, video_decode, kVideoDecodeMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_BufferAllocate, composer, kComposerMix)->MIX_ARGS;
+BENCHMARK_CAPTURE(BM_BufferAllocate, gpu, kGpuMix)->MIX_ARGS;
+
+/* AFBC header initialisation of one RGBA buffer, sizes already AFBC aligned */
+static void BM_InitAfbc(benchmark::State &state)
+{
+	const int width = state.range(0);
+	const int height = state.range(1);
+	const uint64_t alloc_format = MALI_GRALLOC_FORMAT_INTERNAL_RGBA_8888 | MALI_GRALLOC_INTFMT_AFBC_BASIC;
+	std::vector<uint8_t> header((width * height / 256) * 16);
+
+	LatencyRecorder latency(state);
+
+	for (auto _ : state)
+	{
+		latency.time([&] { init_afbc(header.data(), alloc_format, false, width, height); });
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * header.size());
+}
+BENCHMARK(BM_InitAfbc)->Args({ 1920, 1088 })->Args({ 3840, 2160 })->UseManualTime();
+
+BENCHMARK_MAIN();
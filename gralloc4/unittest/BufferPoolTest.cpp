@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gralloc_helper.h"
+#include "allocator/mali_gralloc_buffer_pool.h"
+
+static const size_t MiB = 1024 * 1024;
+
+/* The memfd backend, with buffers that can be marked as still used elsewhere */
+class BusyBackend : public buffer_pool_backend
+{
+public:
+	const char *name() const override
+	{
+		return "busy memfd";
+	}
+
+	int alloc(size_t size, unsigned int heap_mask, unsigned int flags) override
+	{
+		return mali_gralloc_memfd_backend()->alloc(size, heap_mask, flags);
+	}
+
+	bool idle(int fd) override
+	{
+		GRALLOC_UNUSED(fd);
+		return !busy;
+	}
+
+	bool busy = false;
+};
+
+class BufferPoolTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		mali_gralloc_buffer_pool_set_backend(mali_gralloc_memfd_backend());
+		mali_gralloc_buffer_pool_set_size(GRALLOC_BUFFER_POOL_SIZE);
+		mali_gralloc_buffer_pool_trim(0);
+
+		std::vector<buffer_pool_heap_stats> all;
+		mali_gralloc_buffer_pool_get_stats(all);
+		for (const buffer_pool_heap_stats &heap : all)
+		{
+			baseline[heap.heap_mask] = heap;
+		}
+	}
+
+	void TearDown() override
+	{
+		for (int fd : fds)
+		{
+			mali_gralloc_buffer_pool_free(fd);
+		}
+		mali_gralloc_buffer_pool_trim(0);
+		mali_gralloc_buffer_pool_set_backend(mali_gralloc_memfd_backend());
+	}
+
+	int alloc(size_t size, unsigned int heap_mask, unsigned int flags = 0, bool recycle = true)
+	{
+		int fd = mali_gralloc_buffer_pool_alloc(size, heap_mask, flags, recycle);
+		if (fd >= 0)
+		{
+			fds.push_back(fd);
+		}
+		return fd;
+	}
+
+	void release(int fd)
+	{
+		fds.erase(std::find(fds.begin(), fds.end(), fd));
+		mali_gralloc_buffer_pool_free(fd);
+	}
+
+	/* The stats are kept for the life of the process, they are counted from SetUp() */
+	static buffer_pool_heap_stats getStats(unsigned int heap_mask)
+	{
+		std::vector<buffer_pool_heap_stats> all;
+
+		mali_gralloc_buffer_pool_get_stats(all);
+		for (const buffer_pool_heap_stats &heap : all)
+		{
+			if (heap.heap_mask == heap_mask)
+			{
+				return heap;
+			}
+		}
+		return { heap_mask, 0, 0, 0, 0, 0 };
+	}
+
+	buffer_pool_heap_stats stats(unsigned int heap_mask)
+	{
+		buffer_pool_heap_stats heap = getStats(heap_mask);
+		const auto it = baseline.find(heap_mask);
+
+		if (it != baseline.end())
+		{
+			heap.allocated_bytes -= it->second.allocated_bytes;
+			heap.pooled_bytes -= it->second.pooled_bytes;
+			heap.hits -= it->second.hits;
+			heap.misses -= it->second.misses;
+			heap.trimmed -= it->second.trimmed;
+		}
+		return heap;
+	}
+
+	static bool isOpen(int fd)
+	{
+		return fcntl(fd, F_GETFD) != -1;
+	}
+
+	std::vector<int> fds;
+	std::map<unsigned int, buffer_pool_heap_stats> baseline;
+};
+
+TEST_F(BufferPoolTest, FreedBufferIsReused)
+{
+	const unsigned int heap = 1 << 0;
+
+	int first = alloc(MiB, heap);
+	ASSERT_GE(first, 0);
+	release(first);
+
+	EXPECT_EQ(first, alloc(MiB, heap));
+
+	buffer_pool_heap_stats heap_stats = stats(heap);
+	EXPECT_EQ(1u, heap_stats.hits);
+	EXPECT_EQ(1u, heap_stats.misses);
+	EXPECT_EQ(MiB, heap_stats.allocated_bytes);
+	EXPECT_EQ(0u, heap_stats.pooled_bytes);
+}
+
+TEST_F(BufferPoolTest, SizeClassAllowsSlack)
+{
+	const unsigned int heap = 1 << 1;
+
+	int pooled = alloc(MiB, heap);
+	ASSERT_GE(pooled, 0);
+	release(pooled);
+
+	/* More than 1/8 smaller than the pooled buffer */
+	int small = alloc(896 * 1024, heap);
+	EXPECT_NE(pooled, small);
+	/* Within 1/8, the larger pooled buffer is given out */
+	EXPECT_EQ(pooled, alloc(960 * 1024, heap));
+
+	buffer_pool_heap_stats heap_stats = stats(heap);
+	EXPECT_EQ(1u, heap_stats.hits);
+	EXPECT_EQ(2u, heap_stats.misses);
+	EXPECT_EQ(MiB + 896 * 1024, heap_stats.allocated_bytes);
+}
+
+TEST_F(BufferPoolTest, OtherHeapOrFlagsMiss)
+{
+	const unsigned int heap = 1 << 2;
+	const unsigned int other_heap = 1 << 3;
+
+	int pooled = alloc(MiB, heap, 1);
+	ASSERT_GE(pooled, 0);
+	release(pooled);
+
+	EXPECT_NE(pooled, alloc(MiB, other_heap, 1));
+	EXPECT_NE(pooled, alloc(MiB, heap, 2));
+	EXPECT_NE(pooled, alloc(MiB, heap, 1, false));
+	EXPECT_EQ(pooled, alloc(MiB, heap, 1));
+
+	EXPECT_EQ(0u, stats(other_heap).hits);
+	EXPECT_EQ(1u, stats(heap).hits);
+}
+
+TEST_F(BufferPoolTest, OldestIsTrimmedFirst)
+{
+	const unsigned int heap = 1 << 4;
+
+	mali_gralloc_buffer_pool_set_size(2 * MiB);
+
+	int oldest = alloc(MiB, heap);
+	int middle = alloc(MiB, heap);
+	int newest = alloc(MiB, heap);
+	release(oldest);
+	release(middle);
+	release(newest);
+
+	EXPECT_FALSE(isOpen(oldest));
+	EXPECT_TRUE(isOpen(middle));
+	EXPECT_TRUE(isOpen(newest));
+
+	buffer_pool_heap_stats heap_stats = stats(heap);
+	EXPECT_EQ(1u, heap_stats.trimmed);
+	EXPECT_EQ(2 * MiB, heap_stats.pooled_bytes);
+	EXPECT_EQ(0u, heap_stats.allocated_bytes);
+
+	/* Shrinking the pool trims it */
+	mali_gralloc_buffer_pool_set_size(MiB);
+	EXPECT_FALSE(isOpen(middle));
+	EXPECT_EQ(MiB, stats(heap).pooled_bytes);
+
+	mali_gralloc_buffer_pool_trim(0);
+	EXPECT_FALSE(isOpen(newest));
+	EXPECT_EQ(3u, stats(heap).trimmed);
+	EXPECT_EQ(0u, stats(heap).pooled_bytes);
+}
+
+TEST_F(BufferPoolTest, OldBufferExpires)
+{
+	const unsigned int heap = 1 << 5;
+
+	int pooled = alloc(MiB, heap);
+	ASSERT_GE(pooled, 0);
+	release(pooled);
+
+	/* The test is built with a short GRALLOC_BUFFER_POOL_MAX_AGE_MS */
+	std::this_thread::sleep_for(std::chrono::milliseconds(GRALLOC_BUFFER_POOL_MAX_AGE_MS * 2));
+
+	int fresh = alloc(MiB, heap);
+	EXPECT_GE(fresh, 0);
+
+	buffer_pool_heap_stats heap_stats = stats(heap);
+	EXPECT_EQ(0u, heap_stats.hits);
+	EXPECT_EQ(1u, heap_stats.trimmed);
+	EXPECT_EQ(0u, heap_stats.pooled_bytes);
+}
+
+TEST_F(BufferPoolTest, IdleAllocatorReleasesBuffers)
+{
+	const unsigned int heap = 1 << 8;
+
+	int pooled = alloc(MiB, heap);
+	ASSERT_GE(pooled, 0);
+	release(pooled);
+	EXPECT_TRUE(isOpen(pooled));
+
+	/* No allocation or free follows, the buffer is released anyway */
+	for (int i = 0; i < 20 && stats(heap).pooled_bytes != 0; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(GRALLOC_BUFFER_POOL_MAX_AGE_MS));
+	}
+
+	EXPECT_FALSE(isOpen(pooled));
+	EXPECT_EQ(1u, stats(heap).trimmed);
+	EXPECT_EQ(0u, stats(heap).pooled_bytes);
+}
+
+TEST_F(BufferPoolTest, BusyBufferIsNotReused)
+{
+	const unsigned int heap = 1 << 6;
+	BusyBackend backend;
+
+	mali_gralloc_buffer_pool_set_backend(&backend);
+
+	int pooled = alloc(MiB, heap);
+	ASSERT_GE(pooled, 0);
+	release(pooled);
+
+	backend.busy = true;
+	EXPECT_NE(pooled, alloc(MiB, heap));
+	backend.busy = false;
+	EXPECT_EQ(pooled, alloc(MiB, heap));
+
+	/* Pooled buffers of the local backend are released */
+	mali_gralloc_buffer_pool_set_backend(mali_gralloc_memfd_backend());
+}
+
+TEST_F(BufferPoolTest, ZeroSizeDisablesRecycling)
+{
+	const unsigned int heap = 1 << 7;
+
+	mali_gralloc_buffer_pool_set_size(0);
+
+	int first = alloc(MiB, heap);
+	ASSERT_GE(first, 0);
+	release(first);
+
+	EXPECT_FALSE(isOpen(first));
+	EXPECT_EQ(0u, stats(heap).pooled_bytes);
+}
+
+TEST_F(BufferPoolTest, FdinfoCount)
+{
+	EXPECT_TRUE(mali_gralloc_fdinfo_idle("pos:\t0\nflags:\t02000002\nmnt_id:\t14\nino:\t1234\n"
+	                                     "size:\t1048576\ncount:\t1\nexp_name:\tion\n"));
+	EXPECT_FALSE(mali_gralloc_fdinfo_idle("pos:\t0\nflags:\t02000002\nmnt_id:\t14\nino:\t1234\n"
+	                                      "size:\t1048576\ncount:\t2\nexp_name:\tion\n"));
+	/* Older kernels */
+	EXPECT_FALSE(mali_gralloc_fdinfo_idle("pos:\t0\nflags:\t02000002\nmnt_id:\t14\n"));
+
+	/* A memfd has no dma-buf count */
+	int fd = mali_gralloc_memfd_backend()->alloc(4096, 0, 0);
+	ASSERT_GE(fd, 0);
+	EXPECT_FALSE(mali_gralloc_dmabuf_idle(fd));
+	close(fd);
+	EXPECT_FALSE(mali_gralloc_dmabuf_idle(fd));
+}
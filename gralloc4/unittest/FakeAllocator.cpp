@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host stand-in for the ION allocator. Buffers are memfds handed out by the
+ * buffer pool, so the core allocation path runs unchanged off-device.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <mutex>
+
+#include <hardware/gralloc1.h>
+
+#include "allocator/mali_gralloc_buffer_pool.h"
+#include "allocator/mali_gralloc_ion.h"
+#include "core/mali_gralloc_bufferallocation.h"
+#include "gralloc_helper.h"
+#include "mali_gralloc_log.h"
+#include "mali_gralloc_usages.h"
+
+static std::once_flag backend_once;
+
+static void install_backend(void)
+{
+	std::call_once(backend_once, [] { mali_gralloc_buffer_pool_set_backend(mali_gralloc_memfd_backend()); });
+}
+
+static void free_handles(buffer_handle_t *pHandle, uint32_t num_hnds)
+{
+	for (uint32_t i = 0; i < num_hnds; i++)
+	{
+		if (pHandle[i] != nullptr)
+		{
+			private_handle_t *hnd = (private_handle_t *)pHandle[i];
+
+			mali_gralloc_ion_free(hnd);
+			delete hnd;
+			pHandle[i] = nullptr;
+		}
+	}
+}
+
+int mali_gralloc_ion_allocate(const gralloc_buffer_descriptor_t *descriptors,
+                              uint32_t numDescriptors, buffer_handle_t *pHandle, bool *shared_backend)
+{
+	GRALLOC_UNUSED(shared_backend);
+
+	install_backend();
+
+	for (uint32_t i = 0; i < numDescriptors; i++)
+	{
+		buffer_descriptor_t *bufDescriptor = (buffer_descriptor_t *)(descriptors[i]);
+		const uint64_t usage = bufDescriptor->consumer_usage | bufDescriptor->producer_usage;
+		const bool recycle = (usage & GRALLOC_USAGE_NOZEROED) && !(usage & GRALLOC_USAGE_PROTECTED);
+		int fds[5] = { -1, -1, -1, -1, -1 };
+
+		pHandle[i] = nullptr;
+		for (uint32_t fidx = 0; fidx < bufDescriptor->fd_count; fidx++)
+		{
+			fds[fidx] = mali_gralloc_buffer_pool_alloc(bufDescriptor->alloc_sizes[fidx], 0, 0, recycle);
+			if (fds[fidx] < 0)
+			{
+				for (uint32_t cidx = 0; cidx < fidx; cidx++)
+				{
+					mali_gralloc_buffer_pool_free(fds[cidx]);
+				}
+				free_handles(pHandle, i);
+				return -1;
+			}
+		}
+
+		pHandle[i] = new private_handle_t(
+		    0, bufDescriptor->alloc_sizes,
+		    bufDescriptor->consumer_usage, bufDescriptor->producer_usage,
+		    fds, bufDescriptor->fd_count,
+		    bufDescriptor->hal_format, bufDescriptor->alloc_format,
+		    bufDescriptor->width, bufDescriptor->height, bufDescriptor->pixel_stride,
+		    bufDescriptor->layer_count, bufDescriptor->plane_info);
+	}
+
+	/* AFBC headers are always initialised, as with GRALLOC_INIT_AFBC on device */
+	for (uint32_t i = 0; i < numDescriptors; i++)
+	{
+		buffer_descriptor_t *bufDescriptor = (buffer_descriptor_t *)(descriptors[i]);
+		private_handle_t *hnd = (private_handle_t *)(pHandle[i]);
+
+		if (!(bufDescriptor->alloc_format & MALI_GRALLOC_INTFMT_AFBCENABLE_MASK))
+		{
+			continue;
+		}
+
+		uint8_t *cpu_ptr = (uint8_t *)mmap(NULL, bufDescriptor->alloc_sizes[0], PROT_READ | PROT_WRITE,
+		                                   MAP_SHARED, hnd->fds[0], 0);
+		if (MAP_FAILED == cpu_ptr)
+		{
+			MALI_GRALLOC_LOGE("mmap failed, fd ( %d )", hnd->fds[0]);
+			free_handles(pHandle, numDescriptors);
+			return -1;
+		}
+
+		const plane_info_t *plane_info = bufDescriptor->plane_info;
+		const bool is_multi_plane = hnd->is_multi_plane();
+		for (int p = 0; p < MAX_PLANES && (p == 0 || plane_info[p].byte_stride != 0); p++)
+		{
+			init_afbc(cpu_ptr + plane_info[p].offset,
+			          bufDescriptor->alloc_format,
+			          is_multi_plane,
+			          plane_info[p].alloc_width,
+			          plane_info[p].alloc_height);
+		}
+
+		munmap(cpu_ptr, bufDescriptor->alloc_sizes[0]);
+	}
+
+	return 0;
+}
+
+int mali_gralloc_ion_allocate_attr(private_handle_t *hnd)
+{
+	int idx = hnd->get_share_attr_fd_index();
+	if (idx < 0)
+	{
+		return -1;
+	}
+
+	install_backend();
+
+	hnd->fds[idx] = mali_gralloc_buffer_pool_alloc(hnd->attr_size, 0, 0, false);
+	if (hnd->fds[idx] < 0)
+	{
+		return -1;
+	}
+
+	hnd->incr_numfds(1);
+
+	return 0;
+}
+
+void mali_gralloc_ion_free(private_handle_t * const hnd)
+{
+	for (int i = 0; i < hnd->fd_count; i++)
+	{
+		if (hnd->bases[i] != 0)
+		{
+			munmap(reinterpret_cast<void *>(hnd->bases[i]), hnd->alloc_sizes[i]);
+		}
+		mali_gralloc_buffer_pool_free(hnd->fds[i]);
+		hnd->fds[i] = -1;
+		hnd->bases[i] = 0;
+	}
+}
+
+int mali_gralloc_ion_sync_start(const private_handle_t * const hnd,
+                                const bool read, const bool write)
+{
+	GRALLOC_UNUSED(hnd);
+	GRALLOC_UNUSED(read);
+	GRALLOC_UNUSED(write);
+	return 0;
+}
+
+int mali_gralloc_ion_sync_end(const private_handle_t * const hnd,
+                              const bool read, const bool write)
+{
+	GRALLOC_UNUSED(hnd);
+	GRALLOC_UNUSED(read);
+	GRALLOC_UNUSED(write);
+	return 0;
+}
+
+int mali_gralloc_ion_sync_range_start(const private_handle_t * const hnd,
+                                      const bool read, const bool write,
+                                      const ion_sync_range_t *ranges, const int num_ranges)
+{
+	GRALLOC_UNUSED(ranges);
+	GRALLOC_UNUSED(num_ranges);
+	return mali_gralloc_ion_sync_start(hnd, read, write);
+}
+
+int mali_gralloc_ion_sync_range_end(const private_handle_t * const hnd,
+                                    const bool read, const bool write,
+                                    const ion_sync_range_t *ranges, const int num_ranges)
+{
+	GRALLOC_UNUSED(ranges);
+	GRALLOC_UNUSED(num_ranges);
+	return mali_gralloc_ion_sync_end(hnd, read, write);
+}
+
+int mali_gralloc_ion_map(private_handle_t *hnd)
+{
+	for (int fidx = 0; fidx < hnd->fd_count; fidx++)
+	{
+		void *mappedAddress = mmap(NULL, hnd->alloc_sizes[fidx], PROT_READ | PROT_WRITE,
+		                           MAP_SHARED, hnd->fds[fidx], 0);
+		if (MAP_FAILED == mappedAddress)
+		{
+			int err = errno;
+
+			for (int cidx = 0; cidx < fidx; cidx++)
+			{
+				munmap((void *)hnd->bases[cidx], hnd->alloc_sizes[cidx]);
+				hnd->bases[cidx] = 0;
+			}
+			return -err;
+		}
+
+		hnd->bases[fidx] = uintptr_t(mappedAddress);
+	}
+
+	return 0;
+}
+
+void mali_gralloc_ion_unmap(private_handle_t *hnd)
+{
+	for (int i = 0; i < hnd->fd_count; i++)
+	{
+		if (hnd->bases[i] != 0)
+		{
+			munmap(reinterpret_cast<void *>(hnd->bases[i]), hnd->alloc_sizes[i]);
+			hnd->bases[i] = 0;
+		}
+	}
+}
+
+void mali_gralloc_ion_close(void)
+{
+	mali_gralloc_buffer_pool_set_backend(nullptr);
+}
+
+int import_exynos_ion_handles(private_handle_t *hnd)
+{
+	GRALLOC_UNUSED(hnd);
+	return 0;
+}
+
+void free_exynos_ion_handles(private_handle_t *hnd)
+{
+	GRALLOC_UNUSED(hnd);
+}
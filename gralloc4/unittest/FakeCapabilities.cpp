@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+
+#include "FakeCapabilities.h"
+#include "core/format_info.h"
+
+mali_gralloc_format_caps cpu_runtime_caps;
+mali_gralloc_format_caps dpu_runtime_caps;
+mali_gralloc_format_caps vpu_runtime_caps;
+mali_gralloc_format_caps gpu_runtime_caps;
+mali_gralloc_format_caps cam_runtime_caps;
+
+struct fake_ip_caps
+{
+	uint64_t cpu;
+	uint64_t dpu;
+	uint64_t vpu;
+	uint64_t gpu;
+	uint64_t cam;
+};
+
+static const fake_ip_caps fake_caps[] = {
+	/* FAKE_CAPS_LINEAR */
+	{
+		.cpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102 |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA16161616,
+		.dpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102,
+		.vpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT,
+		.gpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102 |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA16161616,
+		.cam = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT,
+	},
+	/* FAKE_CAPS_AFBC */
+	{
+		.cpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102 |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA16161616,
+		.dpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_BASIC |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_SPLITBLK |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_WIDEBLK |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_YUV_READ |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102,
+		.vpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_BASIC |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_YUV_READ |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_YUV_WRITE,
+		.gpu = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_BASIC |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_SPLITBLK |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_WIDEBLK |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_TILED_HEADERS |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_YUV_READ |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_AFBC_YUV_WRITE |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA1010102 |
+		       MALI_GRALLOC_FORMAT_CAPABILITY_PIXFMT_RGBA16161616,
+		.cam = MALI_GRALLOC_FORMAT_CAPABILITY_OPTIONS_PRESENT,
+	},
+};
+
+static std::once_flag sanitize_once;
+static FakeCapabilities fake_profile = FAKE_CAPS_AFBC;
+
+void setFakeCapabilities(FakeCapabilities profile)
+{
+	fake_profile = profile;
+	get_ip_capabilities();
+}
+
+void get_ip_capabilities(void)
+{
+	const fake_ip_caps &caps = fake_caps[fake_profile];
+
+	std::call_once(sanitize_once, sanitize_formats);
+
+	cpu_runtime_caps.caps_mask = caps.cpu;
+	dpu_runtime_caps.caps_mask = caps.dpu;
+	vpu_runtime_caps.caps_mask = caps.vpu;
+	gpu_runtime_caps.caps_mask = caps.gpu;
+	cam_runtime_caps.caps_mask = caps.cam;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_CAPABILITIES_H_
+#define FAKE_CAPABILITIES_H_
+
+#include "capabilities/gralloc_capabilities.h"
+
+/*
+ * Host stand-in for the IP capabilities normally set from the board
+ * configuration. get_ip_capabilities() loads the selected profile.
+ */
+enum FakeCapabilities
+{
+	FAKE_CAPS_LINEAR = 0, /* no IP handles AFBC */
+	FAKE_CAPS_AFBC,       /* GPU, DPU and VPU with AFBC, as on recent SoCs */
+};
+
+void setFakeCapabilities(FakeCapabilities profile);
+
+#endif /* FAKE_CAPABILITIES_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include "FakeIon.h"
+#include "allocator/mali_gralloc_ion.h"
+#include "core/mali_gralloc_bufferallocation.h"
+#include "gralloc_helper.h"
+
+FakeIon gFakeIon;
+
+int mali_gralloc_ion_map(private_handle_t *hnd)
+{
+	const int mapping = ++gFakeIon.mapping;
+	int max = gFakeIon.max_mapping;
+	while (mapping > max && !gFakeIon.max_mapping.compare_exchange_weak(max, mapping))
+	{
+	}
+
+	const int ret = gFakeIon.map_hook ? gFakeIon.map_hook(hnd) : 0;
+	if (ret == 0)
+	{
+		hnd->bases[0] = 0x1000;
+	}
+
+	gFakeIon.maps++;
+	gFakeIon.mapping--;
+	return ret;
+}
+
+void mali_gralloc_ion_unmap(private_handle_t *hnd)
+{
+	hnd->bases[0] = 0;
+	gFakeIon.unmaps++;
+}
+
+int import_exynos_ion_handles(private_handle_t *hnd)
+{
+	GRALLOC_UNUSED(hnd);
+	return 0;
+}
+
+void free_exynos_ion_handles(private_handle_t *hnd)
+{
+	GRALLOC_UNUSED(hnd);
+}
+
+int mali_gralloc_buffer_free(buffer_handle_t pHandle)
+{
+	GRALLOC_UNUSED(pHandle);
+	return 0;
+}
+
+private_handle_t *createRemoteHandle(int width, int height)
+{
+	uint64_t sizes[3] = { (uint64_t)width * height * 4, 0, 0 };
+	int fds[5] = { -1, -1, -1, -1, -1 };
+	plane_info_t planes[MAX_PLANES] = {};
+
+	planes[0].byte_stride = width * 4;
+	planes[0].alloc_width = width;
+	planes[0].alloc_height = height;
+	planes[0].size = sizes[0];
+
+	private_handle_t *hnd = new private_handle_t(0, sizes, 0, 0, fds, 1,
+			HAL_PIXEL_FORMAT_RGBA_8888, HAL_PIXEL_FORMAT_RGBA_8888,
+			width, height, width, 1, planes);
+
+	/* Imported by this process rather than allocated by it */
+	hnd->allocating_pid = getpid() + 1;
+	hnd->remote_pid = -1;
+	hnd->ref_count = 0;
+
+	return hnd;
+}
+
+void deleteHandle(private_handle_t *hnd)
+{
+	delete hnd;
+}
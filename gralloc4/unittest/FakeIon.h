@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_ION_H_
+#define FAKE_ION_H_
+
+#include <atomic>
+#include <functional>
+
+#include <hardware/gralloc1.h>
+
+#include "mali_gralloc_buffer.h"
+
+/*
+ * Host stand-in for the ION mapping calls of the reference registry.
+ * Buffers are never really mapped, map_hook can add a delay or fail.
+ */
+struct FakeIon
+{
+	std::atomic<int> maps{0};
+	std::atomic<int> unmaps{0};
+	std::atomic<int> mapping{0};       /* maps in progress */
+	std::atomic<int> max_mapping{0};   /* most maps in progress at once */
+	std::function<int(private_handle_t *)> map_hook;
+
+	void reset()
+	{
+		maps = 0;
+		unmaps = 0;
+		mapping = 0;
+		max_mapping = 0;
+		map_hook = nullptr;
+	}
+};
+
+extern FakeIon gFakeIon;
+
+/* Handle of a buffer allocated by another process */
+private_handle_t *createRemoteHandle(int width, int height);
+void deleteHandle(private_handle_t *hnd);
+
+#endif /* FAKE_ION_H_ */
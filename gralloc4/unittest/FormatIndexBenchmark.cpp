@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of a format table lookup: the linear scan the tables used to have
+ * against the hashed index, for every format of the table.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "mali_gralloc_formats.h"
+#include "core/format_info.h"
+
+static int32_t linear_format_index(uint32_t id)
+{
+	for (size_t i = 0; i < num_formats; i++)
+	{
+		if (formats[i].id == id)
+		{
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+static int32_t linear_ip_format_index(uint32_t id)
+{
+	for (size_t i = 0; i < num_ip_formats; i++)
+	{
+		if (formats_ip_support[i].id == id)
+		{
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+static std::vector<uint32_t> table_ids()
+{
+	std::vector<uint32_t> ids;
+
+	for (size_t i = 0; i < num_formats; i++)
+	{
+		ids.push_back(formats[i].id);
+	}
+	return ids;
+}
+
+static void BM_FormatIndexLinear(benchmark::State &state)
+{
+	const std::vector<uint32_t> ids = table_ids();
+
+	for (auto _ : state)
+	{
+		for (uint32_t id : ids)
+		{
+			benchmark::DoNotOptimize(linear_format_index(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_FormatIndexLinear);
+
+static void BM_FormatIndexHashed(benchmark::State &state)
+{
+	const std::vector<uint32_t> ids = table_ids();
+
+	for (auto _ : state)
+	{
+		for (uint32_t id : ids)
+		{
+			benchmark::DoNotOptimize(find_format_index(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_FormatIndexHashed);
+
+static void BM_IpFormatIndexLinear(benchmark::State &state)
+{
+	const std::vector<uint32_t> ids = table_ids();
+
+	for (auto _ : state)
+	{
+		for (uint32_t id : ids)
+		{
+			benchmark::DoNotOptimize(linear_ip_format_index(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_IpFormatIndexLinear);
+
+/* Every format of the format table has IP support, so nothing is logged */
+static void BM_IpFormatIndexHashed(benchmark::State &state)
+{
+	const std::vector<uint32_t> ids = table_ids();
+
+	for (auto _ : state)
+	{
+		for (uint32_t id : ids)
+		{
+			benchmark::DoNotOptimize(get_ip_format_index(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_IpFormatIndexHashed);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "mali_gralloc_formats.h"
+#include "core/format_index.h"
+#include "core/format_info.h"
+
+/* The scan the hashed index replaces: first entry with the ID */
+template <typename T, uint32_t T::*key>
+static int32_t linear_index(const T *table, size_t count, uint32_t id)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (table[i].*key == id)
+		{
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+struct test_entry
+{
+	uint32_t id;
+};
+
+/* Dense IDs collide in the hash, duplicates check that the first entry wins */
+static constexpr test_entry test_table[] = {
+	{ 0 }, { 1 }, { 2 }, { 3 }, { 0x100 }, { 0x101 }, { 0x102 }, { 2 }, { 0x11 }, { 0x12 },
+	{ 0x23 }, { 0x24 }, { 0x100 }, { 0x1000 }, { 0x10000 }, { 0xffffffff }, { 0x30 }, { 0x31 },
+	{ 0x32 }, { 0x33 }, { 0x34 }, { 0x35 }, { 0x36 }, { 0x37 }, { 0x38 }, { 0x39 }, { 0x3a },
+	{ 0x3b }, { 0x3c }, { 0x3d }, { 0x3e }, { 0x3f }, { 0x23 },
+};
+static constexpr size_t test_table_count = sizeof(test_table) / sizeof(test_table[0]);
+static constexpr format_index_t test_index =
+	make_format_index<test_entry, test_table_count, &test_entry::id>(test_table);
+
+static int32_t test_lookup(uint32_t id)
+{
+	return lookup_format_index<test_entry, test_table_count, &test_entry::id>(test_index, test_table, id);
+}
+
+TEST(FormatIndexTest, FirstOfDuplicates)
+{
+	EXPECT_EQ(2, test_lookup(2));
+	EXPECT_EQ(4, test_lookup(0x100));
+	EXPECT_EQ(10, test_lookup(0x23));
+	EXPECT_EQ(15, test_lookup(0xffffffff));
+}
+
+TEST(FormatIndexTest, MatchesLinearScan)
+{
+	for (uint32_t id = 0; id < 0x20000; id++)
+	{
+		ASSERT_EQ((linear_index<test_entry, &test_entry::id>(test_table, test_table_count, id)), test_lookup(id))
+			<< "id " << id;
+	}
+
+	std::mt19937 rng(1);
+	for (int i = 0; i < 100000; i++)
+	{
+		const uint32_t id = rng();
+		ASSERT_EQ((linear_index<test_entry, &test_entry::id>(test_table, test_table_count, id)), test_lookup(id))
+			<< "id " << id;
+	}
+}
+
+TEST(FormatIndexTest, FormatTableMatchesLinearScan)
+{
+	/* HAL, Exynos and internal format IDs are all in this range */
+	for (uint32_t id = 0; id < 0x20000; id++)
+	{
+		ASSERT_EQ((linear_index<format_info_t, &format_info_t::id>(formats, num_formats, id)), find_format_index(id))
+			<< "id " << id;
+	}
+
+	for (size_t i = 0; i < num_formats; i++)
+	{
+		EXPECT_EQ((linear_index<format_info_t, &format_info_t::id>(formats, num_formats, formats[i].id)),
+		          get_format_index(formats[i].id));
+	}
+}
+
+TEST(FormatIndexTest, IpTableMatchesLinearScan)
+{
+	for (size_t i = 0; i < num_ip_formats; i++)
+	{
+		const uint32_t id = formats_ip_support[i].id;
+
+		EXPECT_EQ((linear_index<format_ip_support_t, &format_ip_support_t::id>(formats_ip_support, num_ip_formats, id)),
+		          get_ip_format_index(id));
+	}
+}
+
+TEST(FormatIndexTest, UnknownFormat)
+{
+	EXPECT_EQ(-1, find_format_index(MALI_GRALLOC_FORMAT_INTERNAL_UNDEFINED));
+	EXPECT_EQ(-1, find_format_index(0xfffff));
+}
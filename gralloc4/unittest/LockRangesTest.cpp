@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <hardware/gralloc1.h>
+
+#include "FakeCapabilities.h"
+#include "core/mali_gralloc_bufferaccess.h"
+#include "core/mali_gralloc_bufferallocation.h"
+#include "core/mali_gralloc_bufferdescriptor.h"
+#include "mali_gralloc_usages.h"
+
+static const uint64_t kCpuUsage = GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN;
+
+class LockRangesTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		setFakeCapabilities(FAKE_CAPS_LINEAR);
+	}
+
+	void TearDown() override
+	{
+		for (buffer_handle_t handle : handles)
+		{
+			mali_gralloc_buffer_free(handle);
+		}
+	}
+
+	private_handle_t *allocate(uint32_t width, uint32_t height, uint64_t format,
+	                           uint64_t usage = kCpuUsage)
+	{
+		buffer_descriptor_t descriptor;
+
+		descriptor.width = width;
+		descriptor.height = height;
+		descriptor.layer_count = 1;
+		descriptor.hal_format = format;
+		descriptor.producer_usage = usage;
+		descriptor.consumer_usage = usage;
+		descriptor.format_type = MALI_GRALLOC_FORMAT_TYPE_USAGE;
+		descriptor.signature = sizeof(buffer_descriptor_t);
+
+		gralloc_buffer_descriptor_t gralloc_descriptor = reinterpret_cast<gralloc_buffer_descriptor_t>(&descriptor);
+		buffer_handle_t handle = nullptr;
+
+		if (mali_gralloc_buffer_allocate(&gralloc_descriptor, 1, &handle, nullptr) != 0)
+		{
+			return nullptr;
+		}
+		handles.push_back(handle);
+		return (private_handle_t *)handle;
+	}
+
+	/* Rows [first, last) of a plane */
+	static void expectRows(const private_handle_t *hnd, const lock_ranges_t &ranges, int plane,
+	                       uint64_t first, uint64_t last)
+	{
+		const plane_info_t &info = hnd->plane_info[plane];
+
+		EXPECT_EQ(info.fd_idx, ranges.ranges[plane].fd_idx) << "plane " << plane;
+		EXPECT_EQ(info.offset + first * info.byte_stride, ranges.ranges[plane].offset) << "plane " << plane;
+		EXPECT_EQ((last - first) * info.byte_stride, ranges.ranges[plane].size) << "plane " << plane;
+	}
+
+	std::vector<buffer_handle_t> handles;
+};
+
+TEST_F(LockRangesTest, LinearRows)
+{
+	private_handle_t *hnd = allocate(64, 64, HAL_PIXEL_FORMAT_RGBA_8888);
+	ASSERT_NE(nullptr, hnd);
+
+	lock_ranges_t ranges;
+	get_lock_ranges(hnd, 10, 20, &ranges);
+
+	ASSERT_EQ(1, ranges.num_ranges);
+	expectRows(hnd, ranges, 0, 10, 30);
+}
+
+TEST_F(LockRangesTest, LinearRowsClampedToPlane)
+{
+	private_handle_t *hnd = allocate(64, 64, HAL_PIXEL_FORMAT_RGBA_8888);
+	ASSERT_NE(nullptr, hnd);
+
+	lock_ranges_t ranges;
+	get_lock_ranges(hnd, 40, 1000, &ranges);
+
+	ASSERT_EQ(1, ranges.num_ranges);
+	expectRows(hnd, ranges, 0, 40, hnd->plane_info[0].alloc_height);
+}
+
+TEST_F(LockRangesTest, TwoPlaneYuvChromaRows)
+{
+	private_handle_t *hnd = allocate(64, 64, HAL_PIXEL_FORMAT_YCBCR_P010);
+	ASSERT_NE(nullptr, hnd);
+
+	lock_ranges_t ranges;
+	/* Odd rows, the chroma rows shared with the rows outside are synced too */
+	get_lock_ranges(hnd, 11, 20, &ranges);
+
+	ASSERT_EQ(2, ranges.num_ranges);
+	expectRows(hnd, ranges, 0, 11, 31);
+	expectRows(hnd, ranges, 1, 5, 16);
+}
+
+TEST_F(LockRangesTest, ThreePlaneYuvChromaRows)
+{
+	private_handle_t *hnd = allocate(64, 64, HAL_PIXEL_FORMAT_YV12);
+	ASSERT_NE(nullptr, hnd);
+
+	lock_ranges_t ranges;
+	get_lock_ranges(hnd, 8, 32, &ranges);
+
+	ASSERT_EQ(3, ranges.num_ranges);
+	expectRows(hnd, ranges, 0, 8, 40);
+	expectRows(hnd, ranges, 1, 4, 20);
+	expectRows(hnd, ranges, 2, 4, 20);
+}
+
+TEST_F(LockRangesTest, WholeBuffer)
+{
+	lock_ranges_t ranges;
+
+	private_handle_t *rgba = allocate(64, 64, HAL_PIXEL_FORMAT_RGBA_8888);
+	ASSERT_NE(nullptr, rgba);
+	get_lock_ranges(rgba, 0, 0, &ranges);
+	EXPECT_EQ(-1, ranges.num_ranges);
+
+	/* Exynos formats */
+	private_handle_t *nv21 = allocate(64, 64, HAL_PIXEL_FORMAT_YCrCb_420_SP);
+	ASSERT_NE(nullptr, nv21);
+	get_lock_ranges(nv21, 0, 1, &ranges);
+	EXPECT_EQ(-1, ranges.num_ranges);
+
+	private_handle_t *blob = allocate(4096, 1, HAL_PIXEL_FORMAT_BLOB);
+	ASSERT_NE(nullptr, blob);
+	get_lock_ranges(blob, 0, 1, &ranges);
+	EXPECT_EQ(-1, ranges.num_ranges);
+
+	/* Compressed buffers */
+	rgba->alloc_format |= MALI_GRALLOC_INTFMT_AFBC_BASIC;
+	get_lock_ranges(rgba, 0, 1, &ranges);
+	EXPECT_EQ(-1, ranges.num_ranges);
+	rgba->alloc_format &= ~MALI_GRALLOC_INTFMT_AFBC_BASIC;
+}
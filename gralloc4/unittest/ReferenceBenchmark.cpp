@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "FakeIon.h"
+#include "core/mali_gralloc_reference.h"
+
+/* Rough time a map of a buffer spends in the ION driver on device */
+static const auto kMapCost = std::chrono::microseconds(20);
+static const int kHandlesPerThread = 8;
+
+static int slowMap(private_handle_t *)
+{
+	std::this_thread::sleep_for(kMapCost);
+	return 0;
+}
+
+/* Import (map) and free of buffers, each thread with its own buffers */
+static void BM_ImportRelease(benchmark::State &state)
+{
+	std::vector<private_handle_t *> handles;
+
+	if (state.thread_index() == 0)
+	{
+		gFakeIon.reset();
+		gFakeIon.map_hook = slowMap;
+	}
+	for (int i = 0; i < kHandlesPerThread; i++)
+	{
+		handles.push_back(createRemoteHandle(64, 64));
+	}
+
+	for (auto _ : state)
+	{
+		for (private_handle_t *hnd : handles)
+		{
+			mali_gralloc_reference_retain(hnd);
+		}
+		for (private_handle_t *hnd : handles)
+		{
+			mali_gralloc_reference_release(hnd, true);
+			/* Next import is of a new clone of the handle */
+			hnd->remote_pid = -1;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kHandlesPerThread);
+
+	for (private_handle_t *hnd : handles)
+	{
+		deleteHandle(hnd);
+	}
+}
+BENCHMARK(BM_ImportRelease)->ThreadRange(1, 16)->UseRealTime();
+
+/* Retain and release of buffers already imported, as done per frame */
+static void BM_RetainRelease(benchmark::State &state)
+{
+	std::vector<private_handle_t *> handles;
+
+	for (int i = 0; i < kHandlesPerThread; i++)
+	{
+		handles.push_back(createRemoteHandle(64, 64));
+		mali_gralloc_reference_retain(handles.back());
+	}
+
+	for (auto _ : state)
+	{
+		for (private_handle_t *hnd : handles)
+		{
+			mali_gralloc_reference_retain(hnd);
+			mali_gralloc_reference_release(hnd, true);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kHandlesPerThread);
+
+	for (private_handle_t *hnd : handles)
+	{
+		mali_gralloc_reference_release(hnd, true);
+		deleteHandle(hnd);
+	}
+}
+BENCHMARK(BM_RetainRelease)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2020 Arm Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "FakeIon.h"
+#include "core/mali_gralloc_reference.h"
+
+class ReferenceTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		gFakeIon.reset();
+	}
+
+	void TearDown() override
+	{
+		gFakeIon.reset();
+		for (private_handle_t *hnd : handles)
+		{
+			deleteHandle(hnd);
+		}
+	}
+
+	private_handle_t *newHandle()
+	{
+		handles.push_back(createRemoteHandle(64, 64));
+		return handles.back();
+	}
+
+	std::vector<private_handle_t *> handles;
+};
+
+/* Blocks maps until released */
+class MapGate
+{
+public:
+	int wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cond.wait(lock, [this] { return open; });
+		return result;
+	}
+
+	void release(int map_result = 0)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		open = true;
+		result = map_result;
+		cond.notify_all();
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool open = false;
+	int result = 0;
+};
+
+TEST_F(ReferenceTest, ConcurrentRetainsMapOnce)
+{
+	const int kThreads = 8;
+	private_handle_t *hnd = newHandle();
+	MapGate gate;
+
+	gFakeIon.map_hook = [&gate](private_handle_t *) { return gate.wait(); };
+
+	std::vector<std::future<int>> retains;
+	for (int i = 0; i < kThreads; i++)
+	{
+		retains.push_back(std::async(std::launch::async, [hnd] { return mali_gralloc_reference_retain(hnd); }));
+	}
+
+	/* Nobody returns before the buffer is mapped */
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	for (auto &retain : retains)
+	{
+		EXPECT_EQ(std::future_status::timeout, retain.wait_for(std::chrono::seconds(0)));
+	}
+
+	gate.release();
+	for (auto &retain : retains)
+	{
+		EXPECT_EQ(0, retain.get());
+	}
+
+	EXPECT_EQ(1, gFakeIon.maps);
+	EXPECT_EQ(kThreads, hnd->ref_count);
+	EXPECT_NE(0u, hnd->bases[0]);
+
+	for (int i = 0; i < kThreads; i++)
+	{
+		EXPECT_EQ(0, mali_gralloc_reference_release(hnd, true));
+	}
+	EXPECT_EQ(1, gFakeIon.unmaps);
+	EXPECT_EQ(0, hnd->ref_count);
+}
+
+TEST_F(ReferenceTest, WaitersGetMapError)
+{
+	private_handle_t *hnd = newHandle();
+	MapGate gate;
+
+	gFakeIon.map_hook = [&gate](private_handle_t *) { return gate.wait(); };
+
+	auto first = std::async(std::launch::async, [hnd] { return mali_gralloc_reference_retain(hnd); });
+	while (gFakeIon.mapping == 0)
+	{
+		std::this_thread::yield();
+	}
+	auto second = std::async(std::launch::async, [hnd] { return mali_gralloc_reference_retain(hnd); });
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	gate.release(-ENOMEM);
+
+	EXPECT_EQ(-ENOMEM, first.get());
+	EXPECT_EQ(-ENOMEM, second.get());
+	EXPECT_EQ(1, gFakeIon.maps);
+}
+
+TEST_F(ReferenceTest, MapDoesNotBlockOtherHandles)
+{
+	const int kOthers = 64;
+	private_handle_t *blocked = newHandle();
+	std::vector<private_handle_t *> others;
+	MapGate gate;
+
+	for (int i = 0; i < kOthers; i++)
+	{
+		others.push_back(newHandle());
+	}
+
+	gFakeIon.map_hook = [&gate, blocked](private_handle_t *hnd) { return hnd == blocked ? gate.wait() : 0; };
+
+	auto retain = std::async(std::launch::async, [blocked] { return mali_gralloc_reference_retain(blocked); });
+	while (gFakeIon.mapping == 0)
+	{
+		std::this_thread::yield();
+	}
+
+	/* Handles in every shard, including the one of the blocked handle */
+	auto others_done = std::async(std::launch::async, [&others] {
+		for (private_handle_t *hnd : others)
+		{
+			EXPECT_EQ(0, mali_gralloc_reference_retain(hnd));
+			EXPECT_EQ(0, mali_gralloc_reference_release(hnd, true));
+		}
+	});
+	EXPECT_EQ(std::future_status::ready, others_done.wait_for(std::chrono::seconds(5)));
+
+	gate.release();
+	EXPECT_EQ(0, retain.get());
+	EXPECT_EQ(0, mali_gralloc_reference_release(blocked, true));
+	EXPECT_EQ(kOthers + 1, gFakeIon.maps);
+	EXPECT_EQ(kOthers + 1, gFakeIon.unmaps);
+}
+
+TEST_F(ReferenceTest, StressRetainRelease)
+{
+	const int kThreads = 16;
+	const int kHandles = 256;
+	const int kIterations = 20000;
+
+	for (int i = 0; i < kHandles; i++)
+	{
+		newHandle();
+	}
+
+	gFakeIon.map_hook = [](private_handle_t *) {
+		std::this_thread::yield();
+		return 0;
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; t++)
+	{
+		threads.emplace_back([this, t] {
+			std::mt19937 rng(t);
+			std::uniform_int_distribution<int> pick(0, kHandles - 1);
+			std::vector<private_handle_t *> imported(handles);
+			std::vector<private_handle_t *> held;
+
+			/* Every thread imports every handle, in its own order */
+			std::shuffle(imported.begin(), imported.end(), rng);
+			for (private_handle_t *hnd : imported)
+			{
+				ASSERT_EQ(0, mali_gralloc_reference_retain(hnd));
+				ASSERT_NE(0u, hnd->bases[0]);
+			}
+
+			for (int i = 0; i < kIterations; i++)
+			{
+				if (held.empty() || (rng() & 1))
+				{
+					private_handle_t *hnd = handles[pick(rng)];
+					ASSERT_EQ(0, mali_gralloc_reference_retain(hnd));
+					ASSERT_NE(0u, hnd->bases[0]);
+					held.push_back(hnd);
+				}
+				else
+				{
+					ASSERT_EQ(0, mali_gralloc_reference_release(held.back(), true));
+					held.pop_back();
+				}
+			}
+
+			held.insert(held.end(), imported.begin(), imported.end());
+			for (private_handle_t *hnd : held)
+			{
+				ASSERT_EQ(0, mali_gralloc_reference_release(hnd, true));
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	for (private_handle_t *hnd : handles)
+	{
+		EXPECT_EQ(0, hnd->ref_count);
+		EXPECT_EQ(0u, hnd->bases[0]);
+	}
+	EXPECT_EQ(kHandles, gFakeIon.maps);
+	EXPECT_EQ(kHandles, gFakeIon.unmaps);
+}
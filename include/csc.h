@@ -107,6 +107,18 @@ typedef enum _CSC_EQ_RANGE {
     CSC_EQ_RANGE_FULL
 } CSC_EQ_RANGE;
 
+/* 10 bit to 8 bit software conversion */
+typedef enum _CSC_DITHER {
+    CSC_DITHER_NONE = 0,
+    CSC_DITHER_ORDERED,
+} CSC_DITHER;
+
+typedef enum _CSC_RANGE_MAP {
+    CSC_RANGE_MAP_NONE = 0,
+    CSC_RANGE_MAP_NARROW_TO_FULL,
+    CSC_RANGE_MAP_FULL_TO_NARROW,
+} CSC_RANGE_MAP;
+
 typedef enum _CSC_HW_FILTER {
     CSC_FT_NONE = 0,
     CSC_FT_BLUR,
@@ -159,6 +171,12 @@ typedef struct _CSC_HANDLE {
     CSC_HW_FILTER    filter;
 
     unsigned int     frame_rate;
+
+    /* Software conversion */
+    unsigned int     sw_thread_count;
+    void            *sw_pool;
+    CSC_DITHER       dither;
+    CSC_RANGE_MAP    range_map;
 } CSC_HANDLE;
 
 /*
@@ -238,6 +256,44 @@ CSC_ERRORCODE csc_set_method(
     void           *handle,
     CSC_METHOD      method);
 
+/*
+ * Set the number of threads used by CSC_METHOD_SW.
+ * Frames are split into row stripes, one per thread.
+ *
+ * @param handle
+ *   CSC handle[in]
+ *
+ * @param count
+ *   number of threads, 1 converts on the calling thread only[in]
+ *
+ * @return
+ *   error code
+ */
+CSC_ERRORCODE csc_set_sw_thread_count(
+    void           *handle,
+    unsigned int    count);
+
+/*
+ * Set how CSC_METHOD_SW reduces P010 to 8 bit NV12, NV21 or YUV420P.
+ * Without dithering the samples are rounded to nearest.
+ *
+ * @param handle
+ *   CSC handle[in]
+ *
+ * @param dither
+ *   CSC_DITHER_ORDERED spreads the rounding error over a 4x4 pattern[in]
+ *
+ * @param range_map
+ *   quantization range change done with the conversion[in]
+ *
+ * @return
+ *   error code
+ */
+CSC_ERRORCODE csc_set_depth_conversion(
+    void           *handle,
+    CSC_DITHER      dither,
+    CSC_RANGE_MAP   range_map);
+
 /*
  * Set hw property
  *
@@ -402,4 +402,93 @@ void csc_RGBA8888_to_YUV420SP(
     unsigned int width,
     unsigned int height);
 
+/* range mapping of csc_P010_to_YUV420SP() and csc_P010_to_YUV420P() */
+#define CSC_P010_RANGE_KEEP             0   /* 10 bit narrow to 8 bit narrow, or full to full */
+#define CSC_P010_RANGE_NARROW_TO_FULL   1
+#define CSC_P010_RANGE_FULL_TO_NARROW   2
+
+/*
+ * C code or SIMD
+ * Converts P010 to 8 bit YUV420SP(NV12 or NV21)
+ *
+ * @param y_dst
+ *   Y plane address of YUV420SP[out]
+ *
+ * @param uv_dst
+ *   UV plane address of YUV420SP[out]
+ *
+ * @param y_src
+ *   Y plane address of P010[in]
+ *
+ * @param uv_src
+ *   UV plane address of P010[in]
+ *
+ * @param width
+ *   Width of P010 in pixels, it should be even[in]
+ *
+ * @param height
+ *   Height of P010[in]
+ *
+ * @param swap_uv
+ *   1 writes CrCb(NV21)[in]
+ *
+ * @param dither
+ *   1 applies a 4x4 ordered dither, 0 rounds to nearest[in]
+ *
+ * @param range
+ *   CSC_P010_RANGE_*[in]
+ */
+void csc_P010_to_YUV420SP(
+    unsigned char  *y_dst,
+    unsigned char  *uv_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    swap_uv,
+    unsigned int    dither,
+    unsigned int    range);
+
+/*
+ * C code or SIMD
+ * Converts P010 to 8 bit YUV420P
+ *
+ * @param y_dst
+ *   Y plane address of YUV420P[out]
+ *
+ * @param u_dst
+ *   U plane address of YUV420P[out]
+ *
+ * @param v_dst
+ *   V plane address of YUV420P[out]
+ *
+ * @param y_src
+ *   Y plane address of P010[in]
+ *
+ * @param uv_src
+ *   UV plane address of P010[in]
+ *
+ * @param width
+ *   Width of P010 in pixels, it should be even[in]
+ *
+ * @param height
+ *   Height of P010[in]
+ *
+ * @param dither
+ *   1 applies a 4x4 ordered dither, 0 rounds to nearest[in]
+ *
+ * @param range
+ *   CSC_P010_RANGE_*[in]
+ */
+void csc_P010_to_YUV420P(
+    unsigned char  *y_dst,
+    unsigned char  *u_dst,
+    unsigned char  *v_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    dither,
+    unsigned int    range);
+
 #endif /*COLOR_SPACE_CONVERTOR_H_*/
@@ -668,6 +668,8 @@ ExynosCamera::~ExynosCamera()
     TIME_LOGGER_UPDATE(m_cameraId, 0, 0, CUMULATIVE_CNT, DESTRUCTOR_END, 0);
     TIME_LOGGER_SAVE(m_cameraId);
 #endif
+
+    TIME_LOGGER_TRACE_SAVE(m_cameraId);
 }
 
 void ExynosCamera::release()
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraBufferIndex.h
+ * \brief     header file for the buffer index queue and the fd index of ExynosCameraBufferManager
+ */
+
+#ifndef EXYNOS_CAMERA_BUFFER_INDEX_H__
+#define EXYNOS_CAMERA_BUFFER_INDEX_H__
+
+#include <string.h>
+
+/* bigger than VIDEO_MAX_FRAME and SWBUFFER_MAX_COUNT */
+#define BUFFER_INDEX_MAX_COUNT      (128)
+/* power of two, twice of BUFFER_INDEX_MAX_COUNT to keep the probes short */
+#define BUFFER_FD_INDEX_TABLE_SIZE  (BUFFER_INDEX_MAX_COUNT * 2)
+
+namespace android {
+
+/*
+ * FIFO of buffer indexes linked through arrays indexed by the buffer index,
+ * so push, pop, erase and the membership check don't walk the queue.
+ * An index is in the queue at most once. It isn't thread safe, the owner locks it.
+ */
+class ExynosCameraBufferIndexQ {
+public:
+    ExynosCameraBufferIndexQ()
+    {
+        clear();
+    }
+
+    void clear(void)
+    {
+        for (int i = 0; i < BUFFER_INDEX_MAX_COUNT; i++) {
+            m_prev[i] = -1;
+            m_next[i] = -1;
+            m_isQueued[i] = false;
+        }
+
+        m_head = -1;
+        m_tail = -1;
+        m_count = 0;
+    }
+
+    /* false if the index is out of bound or already in the queue */
+    bool push_back(int index)
+    {
+        if (m_isValid(index) == false || m_isQueued[index] == true)
+            return false;
+
+        m_prev[index] = m_tail;
+        m_next[index] = -1;
+
+        if (m_tail < 0)
+            m_head = index;
+        else
+            m_next[m_tail] = index;
+
+        m_tail = index;
+        m_isQueued[index] = true;
+        m_count++;
+
+        return true;
+    }
+
+    bool pop_front(int *index)
+    {
+        if (m_head < 0)
+            return false;
+
+        *index = m_head;
+
+        return erase(m_head);
+    }
+
+    /* false if the index isn't in the queue */
+    bool erase(int index)
+    {
+        if (has(index) == false)
+            return false;
+
+        if (m_prev[index] < 0)
+            m_head = m_next[index];
+        else
+            m_next[m_prev[index]] = m_next[index];
+
+        if (m_next[index] < 0)
+            m_tail = m_prev[index];
+        else
+            m_prev[m_next[index]] = m_prev[index];
+
+        m_prev[index] = -1;
+        m_next[index] = -1;
+        m_isQueued[index] = false;
+        m_count--;
+
+        return true;
+    }
+
+    bool has(int index)
+    {
+        return (m_isValid(index) == true && m_isQueued[index] == true);
+    }
+
+    bool empty(void)
+    {
+        return (m_count == 0);
+    }
+
+    int size(void)
+    {
+        return m_count;
+    }
+
+    /* -1 at the end, for the dump */
+    int front(void)
+    {
+        return m_head;
+    }
+
+    int next(int index)
+    {
+        return (has(index) == true) ? m_next[index] : -1;
+    }
+
+private:
+    bool m_isValid(int index)
+    {
+        return (0 <= index && index < BUFFER_INDEX_MAX_COUNT);
+    }
+
+private:
+    int     m_prev[BUFFER_INDEX_MAX_COUNT];
+    int     m_next[BUFFER_INDEX_MAX_COUNT];
+    bool    m_isQueued[BUFFER_INDEX_MAX_COUNT];
+    int     m_head;
+    int     m_tail;
+    int     m_count;
+};
+
+/*
+ * Hash of fd[0] to the buffer index, open addressing with linear probing.
+ * A buffer has one entry, setting a new fd of the buffer drops the old one.
+ * The fd of a buffer can change without it (service buffers get new fds on every request),
+ * so the caller checks the found index against the buffer and sets it again on a miss.
+ * It isn't thread safe, the owner locks it.
+ */
+class ExynosCameraBufferFdIndex {
+public:
+    ExynosCameraBufferFdIndex()
+    {
+        clear();
+    }
+
+    void clear(void)
+    {
+        for (int i = 0; i < BUFFER_FD_INDEX_TABLE_SIZE; i++) {
+            m_table[i].fd = -1;
+            m_table[i].index = -1;
+        }
+
+        for (int i = 0; i < BUFFER_INDEX_MAX_COUNT; i++)
+            m_fdOfIndex[i] = -1;
+    }
+
+    /* -1 if the fd has no entry */
+    int find(int fd)
+    {
+        if (fd < 0)
+            return -1;
+
+        for (int slot = m_hash(fd); m_table[slot].fd >= 0; slot = m_nextSlot(slot)) {
+            if (m_table[slot].fd == fd)
+                return m_table[slot].index;
+        }
+
+        return -1;
+    }
+
+    void set(int fd, int index)
+    {
+        int slot, oldIndex;
+
+        if (fd < 0 || index < 0 || BUFFER_INDEX_MAX_COUNT <= index)
+            return;
+
+        if (m_fdOfIndex[index] >= 0)
+            m_erase(m_fdOfIndex[index]);
+
+        /* the fd can be left by another buffer, which has a new fd now */
+        oldIndex = find(fd);
+        if (oldIndex >= 0) {
+            m_fdOfIndex[oldIndex] = -1;
+            m_erase(fd);
+        }
+
+        for (slot = m_hash(fd); m_table[slot].fd >= 0; slot = m_nextSlot(slot))
+            ;
+
+        m_table[slot].fd = fd;
+        m_table[slot].index = index;
+        m_fdOfIndex[index] = fd;
+    }
+
+private:
+    int m_hash(int fd)
+    {
+        /* fds are small and dense, spread them with a multiplicative hash */
+        return (int)(((unsigned int)fd * 2654435761u) >> 8) & (BUFFER_FD_INDEX_TABLE_SIZE - 1);
+    }
+
+    int m_nextSlot(int slot)
+    {
+        return (slot + 1) & (BUFFER_FD_INDEX_TABLE_SIZE - 1);
+    }
+
+    /* moves the following entries back, so a probe never stops at the hole */
+    void m_erase(int fd)
+    {
+        int slot = m_hash(fd);
+        int hole, home;
+
+        while (m_table[slot].fd >= 0 && m_table[slot].fd != fd)
+            slot = m_nextSlot(slot);
+
+        if (m_table[slot].fd < 0)
+            return;
+
+        hole = slot;
+        for (slot = m_nextSlot(hole); m_table[slot].fd >= 0; slot = m_nextSlot(slot)) {
+            home = m_hash(m_table[slot].fd);
+
+            /* the entry can move to the hole only if the hole is between its home and it */
+            if (((slot - home) & (BUFFER_FD_INDEX_TABLE_SIZE - 1))
+                >= ((slot - hole) & (BUFFER_FD_INDEX_TABLE_SIZE - 1))) {
+                m_table[hole] = m_table[slot];
+                hole = slot;
+            }
+        }
+
+        m_table[hole].fd = -1;
+        m_table[hole].index = -1;
+    }
+
+private:
+    typedef struct buffer_fd_entry {
+        int fd;
+        int index;
+    } buffer_fd_entry_t;
+
+    buffer_fd_entry_t   m_table[BUFFER_FD_INDEX_TABLE_SIZE];
+    int                 m_fdOfIndex[BUFFER_INDEX_MAX_COUNT];
+};
+
+}; /* namespace android */
+#endif
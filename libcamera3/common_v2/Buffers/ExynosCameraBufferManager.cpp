@@ -173,6 +173,9 @@ status_t ExynosCameraBufferManager::m_free(void)
         m_availableBufferIndexQLock.lock();
         m_availableBufferIndexQ.clear();
         m_availableBufferIndexQLock.unlock();
+        m_fdIndexLock.lock();
+        m_fdIndex.clear();
+        m_fdIndexLock.unlock();
         m_allocatedBufCount  = 0;
         m_allowedMaxBufCount = 0;
         m_flagAllocated = false;
@@ -198,6 +201,26 @@ void ExynosCameraBufferManager::m_resetSequenceQ()
     return;
 }
 
+/* the cached index is used only if the buffer still has the fd, or it's searched and cached again */
+int ExynosCameraBufferManager::m_findIndexByFd(int fd, const struct ExynosCameraBuffer *buffer)
+{
+    Mutex::Autolock lock(m_fdIndexLock);
+    int index = m_fdIndex.find(fd);
+
+    if (m_indexOffset <= index && index < m_reqBufCount + m_indexOffset
+        && buffer[index].fd[0] == fd)
+        return index;
+
+    for (index = m_indexOffset; index < m_reqBufCount + m_indexOffset; index++) {
+        if (buffer[index].fd[0] == fd) {
+            m_fdIndex.set(fd, index);
+            return index;
+        }
+    }
+
+    return -1;
+}
+
 void ExynosCameraBufferManager::setContigBufCount(int reservedMemoryCount)
 {
     CLOGI("reservedMemoryCount(%d)", reservedMemoryCount);
@@ -319,7 +342,6 @@ status_t ExynosCameraBufferManager::putBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
     bool found = false;
     enum EXYNOS_CAMERA_BUFFER_PERMISSION permission;
 
@@ -333,12 +355,7 @@ status_t ExynosCameraBufferManager::putBuffer(
     }
 
     m_availableBufferIndexQLock.lock();
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        if (bufIndex == *r) {
-            found = true;
-            break;
-        }
-    }
+    found = m_availableBufferIndexQ.has(bufIndex);
     m_availableBufferIndexQLock.unlock();
 
     if (found == true) {
@@ -374,7 +391,6 @@ status_t ExynosCameraBufferManager::getBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
 
     int  bufferIndex;
     enum EXYNOS_CAMERA_BUFFER_PERMISSION permission;
@@ -392,10 +408,7 @@ reDo:
     if (bufferIndex < 0 || m_allocatedBufCount + m_indexOffset <= bufferIndex) {
         /* find availableBuffer */
         m_availableBufferIndexQLock.lock();
-        if (m_availableBufferIndexQ.empty() == false) {
-            r = m_availableBufferIndexQ.begin();
-            bufferIndex = *r;
-            m_availableBufferIndexQ.erase(r);
+        if (m_availableBufferIndexQ.pop_front(&bufferIndex) == true) {
 #ifdef EXYNOS_CAMERA_BUFFER_TRACE
             CLOGI("available buffer [index=%d]...", bufferIndex);
 #endif
@@ -404,12 +417,7 @@ reDo:
     } else {
         m_availableBufferIndexQLock.lock();
         /* get the Buffer of requested */
-        for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-            if (bufferIndex == *r) {
-                m_availableBufferIndexQ.erase(r);
-                break;
-            }
-        }
+        m_availableBufferIndexQ.erase(bufferIndex);
         m_availableBufferIndexQLock.unlock();
     }
 
@@ -529,13 +537,7 @@ status_t ExynosCameraBufferManager::getIndexByFd(int fd, int *index)
         return BAD_VALUE;
     }
 
-    *index = -1;
-    for (int bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
-        if (m_buffer[bufIndex].fd[0] == fd) {
-            *index = bufIndex;
-            break;
-        }
-    }
+    *index = m_findIndexByFd(fd, m_buffer);
 
     if (*index < 0 || *index > m_allowedMaxBufCount + m_indexOffset) {
         CLOGE("Invalid buffer index %d. fd %d", *index, fd);
@@ -1128,13 +1130,12 @@ void ExynosCameraBufferManager::printBufferState(int bufIndex, int planeIndex)
 
 void ExynosCameraBufferManager::printBufferQState()
 {
-    List<int>::iterator r;
     int  bufferIndex;
 
     Mutex::Autolock lock(m_availableBufferIndexQLock);
 
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        bufferIndex = *r;
+    for (bufferIndex = m_availableBufferIndexQ.front(); bufferIndex >= 0;
+         bufferIndex = m_availableBufferIndexQ.next(bufferIndex)) {
         CLOGV("bufferIndex=%d", bufferIndex);
     }
 
@@ -1241,7 +1242,9 @@ bool InternalExynosCameraBufferManager::m_allocationThreadFunc(void)
             CLOGE("increase the buffer failed");
         } else {
             m_lock.lock();
+            m_availableBufferIndexQLock.lock();
             m_availableBufferIndexQ.push_back(m_buffer[m_allocatedBufCount + m_indexOffset].index);
+            m_availableBufferIndexQLock.unlock();
             m_allocatedBufCount++;
             m_lock.unlock();
         }
@@ -1465,7 +1468,6 @@ status_t InternalExynosCameraBufferManager::m_decrease(void)
     ExynosCameraAutoTimer autoTimer(__FUNCTION__);
 
     status_t ret = true;
-    List<int>::iterator r;
 
     int  bufferIndex = -1;
 
@@ -1492,13 +1494,9 @@ status_t InternalExynosCameraBufferManager::m_decrease(void)
         }
     }
 
+    /* the last buffer is freed */
     m_availableBufferIndexQLock.lock();
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        if ((bufferIndex + m_indexOffset) == *r) {
-            m_availableBufferIndexQ.erase(r);
-            break;
-        }
-    }
+    m_availableBufferIndexQ.erase(bufferIndex - 1 + m_indexOffset);
     m_availableBufferIndexQLock.unlock();
     m_allocatedBufCount--;
 
@@ -1880,7 +1878,9 @@ bool ServiceExynosCameraBufferManager::m_allocationThreadFunc(void)
             CLOGE("increase the buffer failed");
         } else {
             m_lock.lock();
+            m_availableBufferIndexQLock.lock();
             m_availableBufferIndexQ.push_back(m_buffer[m_allocatedBufCount + m_indexOffset].index);
+            m_availableBufferIndexQLock.unlock();
             m_allocatedBufCount++;
             m_lock.unlock();
         }
@@ -1997,7 +1997,6 @@ status_t ServiceExynosCameraBufferManager::putBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
     bool found = false;
     int totalPlaneCount = 0;
     enum EXYNOS_CAMERA_BUFFER_PERMISSION permission;
@@ -2012,12 +2011,7 @@ status_t ServiceExynosCameraBufferManager::putBuffer(
     }
 
     m_availableBufferIndexQLock.lock();
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        if (bufIndex == *r) {
-            found = true;
-            break;
-        }
-    }
+    found = m_availableBufferIndexQ.has(bufIndex);
     m_availableBufferIndexQLock.unlock();
 
     if (found == true) {
@@ -2074,7 +2068,6 @@ status_t ServiceExynosCameraBufferManager::getBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
 
     int  bufferIndex;
     int planeCount;
@@ -2094,10 +2087,7 @@ reDo:
     if (bufferIndex < 0 || m_allocatedBufCount + m_indexOffset <= bufferIndex) {
         /* find availableBuffer */
         m_availableBufferIndexQLock.lock();
-        if (m_availableBufferIndexQ.empty() == false) {
-            r = m_availableBufferIndexQ.begin();
-            bufferIndex = *r;
-            m_availableBufferIndexQ.erase(r);
+        if (m_availableBufferIndexQ.pop_front(&bufferIndex) == true) {
 #ifdef EXYNOS_CAMERA_BUFFER_TRACE
             CLOGI("available buffer [index=%d]...", bufferIndex);
 #endif
@@ -2106,12 +2096,7 @@ reDo:
     } else {
         m_availableBufferIndexQLock.lock();
         /* get the Buffer of requested */
-        for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-            if (bufferIndex == *r) {
-                m_availableBufferIndexQ.erase(r);
-                break;
-            }
-        }
+        m_availableBufferIndexQ.erase(bufferIndex);
         m_availableBufferIndexQLock.unlock();
     }
 
@@ -2833,7 +2818,6 @@ status_t SWExynosCameraBufferManager::getBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
 
     int  bufferIndex;
     enum EXYNOS_CAMERA_BUFFER_PERMISSION permission;
@@ -2851,10 +2835,7 @@ reDo:
     if (bufferIndex < 0 || m_allocatedBufCount + m_indexOffset <= bufferIndex) {
         /* find availableBuffer */
         m_availableBufferIndexQLock.lock();
-        if (m_availableBufferIndexQ.empty() == false) {
-            r = m_availableBufferIndexQ.begin();
-            bufferIndex = *r;
-            m_availableBufferIndexQ.erase(r);
+        if (m_availableBufferIndexQ.pop_front(&bufferIndex) == true) {
 #ifdef EXYNOS_CAMERA_BUFFER_TRACE
             CLOGI("available buffer [index=%d]...", bufferIndex);
 #endif
@@ -2863,12 +2844,7 @@ reDo:
     } else {
         m_availableBufferIndexQLock.lock();
         /* get the Buffer of requested */
-        for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-            if (bufferIndex == *r) {
-                m_availableBufferIndexQ.erase(r);
-                break;
-            }
-        }
+        m_availableBufferIndexQ.erase(bufferIndex);
         m_availableBufferIndexQLock.unlock();
     }
 
@@ -2945,7 +2921,6 @@ status_t SWExynosCameraBufferManager::putBuffer(
     Mutex::Autolock lock(m_lock);
 
     status_t ret = NO_ERROR;
-    List<int>::iterator r;
     bool found = false;
     enum EXYNOS_CAMERA_BUFFER_PERMISSION permission;
 
@@ -2959,12 +2934,7 @@ status_t SWExynosCameraBufferManager::putBuffer(
     }
 
     m_availableBufferIndexQLock.lock();
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        if (bufIndex == *r) {
-            found = true;
-            break;
-        }
-    }
+    found = m_availableBufferIndexQ.has(bufIndex);
     m_availableBufferIndexQLock.unlock();
 
     if (found == true) {
@@ -3025,13 +2995,7 @@ status_t SWExynosCameraBufferManager::getIndexByFd(int fd, int *index)
         return BAD_VALUE;
     }
 
-    *index = -1;
-    for (int bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
-        if (m_swBuffer[bufIndex].fd[0] == fd) {
-            *index = bufIndex;
-            break;
-        }
-    }
+    *index = m_findIndexByFd(fd, m_swBuffer);
 
     if (*index < 0 || *index > m_allowedMaxBufCount + m_indexOffset) {
         CLOGE("Invalid buffer index %d. fd %d", *index, fd);
@@ -3793,7 +3757,6 @@ status_t SWExynosCameraBufferManager::m_decrease(void)
     ExynosCameraAutoTimer autoTimer(__FUNCTION__);
 
     status_t ret = true;
-    List<int>::iterator r;
 
     int  bufferIndex = -1;
 
@@ -3822,13 +3785,9 @@ status_t SWExynosCameraBufferManager::m_decrease(void)
         }
     }
 
+    /* the last buffer is freed */
     m_availableBufferIndexQLock.lock();
-    for (r = m_availableBufferIndexQ.begin(); r != m_availableBufferIndexQ.end(); r++) {
-        if ((bufferIndex + m_indexOffset) == *r) {
-            m_availableBufferIndexQ.erase(r);
-            break;
-        }
-    }
+    m_availableBufferIndexQ.erase(bufferIndex - 1 + m_indexOffset);
     m_availableBufferIndexQLock.unlock();
     m_allocatedBufCount--;
 
@@ -3891,7 +3850,9 @@ bool SWExynosCameraBufferManager::m_allocationThreadFunc(void)
             CLOGE("increase the buffer failed");
         } else {
             m_lock.lock();
+            m_availableBufferIndexQLock.lock();
             m_availableBufferIndexQ.push_back(m_swBuffer[m_allocatedBufCount + m_indexOffset].index);
+            m_availableBufferIndexQLock.unlock();
             m_allocatedBufCount++;
             m_lock.unlock();
         }
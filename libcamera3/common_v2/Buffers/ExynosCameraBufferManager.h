@@ -46,6 +46,7 @@
 #include "ExynosCameraList.h"
 #include "ExynosCameraAutoTimer.h"
 #include "ExynosCameraBuffer.h"
+#include "ExynosCameraBufferIndex.h"
 #include "ExynosCameraMemory.h"
 #include "ExynosCameraThread.h"
 
@@ -210,6 +211,7 @@ protected:
     int              m_getTotalPlaneCount(int planeCount, int batchSize, bool hasMetaPlane);
 
     virtual void     m_resetSequenceQ(void);
+    int              m_findIndexByFd(int fd, const struct ExynosCameraBuffer *buffer);
 
     virtual status_t m_setAllocator(void *allocator) = 0;
     virtual status_t m_alloc(int bIndex, int eIndex) = 0;
@@ -234,8 +236,10 @@ protected:
     ExynosCameraIonAllocator    *m_defaultAllocator;
     bool                        m_isCreateDefaultAllocator;
     struct ExynosCameraBuffer   m_buffer[VIDEO_MAX_FRAME];
-    List<int>                   m_availableBufferIndexQ;
+    ExynosCameraBufferIndexQ    m_availableBufferIndexQ;
     mutable Mutex               m_availableBufferIndexQLock;
+    ExynosCameraBufferFdIndex   m_fdIndex;
+    mutable Mutex               m_fdIndexLock;
 
     buffer_manager_allocation_mode_t m_allocMode;
     int                         m_indexOffset;
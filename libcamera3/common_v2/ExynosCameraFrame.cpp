@@ -20,6 +20,7 @@
 #include <log/log.h>
 
 #include "ExynosCameraFrame.h"
+#include "ExynosCameraTimeLogger.h"
 
 namespace android {
 
@@ -67,6 +68,40 @@ ExynosCameraFrame::~ExynosCameraFrame()
     m_deinit();
 }
 
+void *ExynosCameraFrame::operator new(size_t size)
+{
+    void *ptr = ExynosCameraFramePool::allocHeap(size);
+
+    /* the constructor must not run on NULL, and the HAL doesn't handle bad_alloc */
+    LOG_ALWAYS_FATAL_IF(ptr == NULL, "ExynosCameraFrame: allocation of %zu bytes failed", size);
+
+    return ptr;
+}
+
+void *ExynosCameraFrame::operator new(size_t size, ExynosCameraFramePool *pool)
+{
+    void *ptr;
+
+    if (pool == NULL)
+        ptr = ExynosCameraFramePool::allocHeap(size);
+    else
+        ptr = pool->alloc(size);
+
+    LOG_ALWAYS_FATAL_IF(ptr == NULL, "ExynosCameraFrame: allocation of %zu bytes failed", size);
+
+    return ptr;
+}
+
+void ExynosCameraFrame::operator delete(void *ptr)
+{
+    ExynosCameraFramePool::release(ptr);
+}
+
+void ExynosCameraFrame::operator delete(void *ptr, __unused ExynosCameraFramePool *pool)
+{
+    ExynosCameraFramePool::release(ptr);
+}
+
 #ifdef DEBUG_FRAME_MEMORY_LEAK
 long long int ExynosCameraFrame::getCheckLeakCount()
 {
@@ -671,6 +706,9 @@ status_t ExynosCameraFrame::setEntityState(uint32_t pipeId,
 
     entity->setEntityState(state);
 
+    if (state == ENTITY_STATE_FRAME_DONE)
+        TIME_LOGGER_TRACE(m_cameraId, m_frameCount, pipeId, PIPE_DONE);
+
     return NO_ERROR;
 }
 
@@ -26,6 +26,7 @@
 #include "ExynosCameraBuffer.h"
 #include "ExynosCameraList.h"
 #include "ExynosCameraNode.h"
+#include "ExynosCameraFramePool.h"
 
 typedef ExynosCameraList<uint32_t> frame_key_queue_t;
 
@@ -331,6 +332,12 @@ private:
     ~ExynosCameraFrame();
 
 public:
+    /* the memory of a frame is recycled through the pool of CreateWorker */
+    static void     *operator new(size_t size);
+    static void     *operator new(size_t size, ExynosCameraFramePool *pool);
+    static void     operator delete(void *ptr);
+    static void     operator delete(void *ptr, ExynosCameraFramePool *pool);
+
     /* If curEntity is NULL, newEntity is added to m_linkageList */
     status_t        addSiblingEntity(
                         ExynosCameraFrameEntity *curEntity,
@@ -166,6 +166,8 @@ status_t CreateWorker::m_deinit()
             m_lock = NULL;
         }
 
+        /* the frames still running keep the pool */
+        m_framePool = NULL;
         break;
     case FRAMEMGR_OPER::SLIENT:
         m_setEnable(false);
@@ -188,6 +190,7 @@ status_t CreateWorker::m_deinit()
             m_lock = NULL;
         }
 
+        m_framePool = NULL;
         break;
     case FRAMEMGR_OPER::NONE:
     default:
@@ -243,6 +246,13 @@ status_t CreateWorker::start()
         m_worklist->release();
     }
 
+    /*
+     * Up to the max margin of frames wait in the worklist, and they are refilled when
+     * the worklist goes down to the min margin, so the pool covers both of them.
+     * It keeps the old blocks if frames of the previous session are still running.
+     */
+    m_framePool->setCount(m_getMargin(FRAME_MARGIN_MAX) + m_getMargin(FRAME_MARGIN_MIN));
+
     switch (m_operMode) {
     case FRAMEMGR_OPER::ONDEMAND:
         m_setEnable(true);
@@ -282,6 +292,7 @@ status_t CreateWorker::stop()
             m_worklist->popProcessQ(&frame);
             frame = NULL;
         }
+        m_framePool->dump();
         break;
     case FRAMEMGR_OPER::NONE:
     default:
@@ -299,7 +310,7 @@ ExynosCameraFrameSP_sptr_t CreateWorker::m_execute()
 
     switch (m_operMode) {
     case FRAMEMGR_OPER::ONDEMAND:
-        frame = new ExynosCameraFrame(m_cameraId);
+        frame = new (m_framePool.get()) ExynosCameraFrame(m_cameraId);
         break;
     case FRAMEMGR_OPER::SLIENT:
         m_worklist->popProcessQ(&frame);
@@ -328,6 +339,8 @@ status_t CreateWorker::m_init()
 {
     int32_t ret = FRAMEMGR_ERRCODE::OK;
 
+    m_framePool = new ExynosCameraFramePool(m_name, m_cameraId, sizeof(ExynosCameraFrame));
+
     switch (m_operMode) {
     case FRAMEMGR_OPER::ONDEMAND:
         m_worklist = new frame_manager_queue_t;
@@ -385,7 +398,7 @@ bool CreateWorker::workerMain()
     while ((m_getEnable() == true) && (cmd == FrameWorkerCommand::START)
         && (m_worklist->getSizeOfProcessQ() < m_getMargin(FRAME_MARGIN_MAX))) {
         frame = NULL;
-        frame = new ExynosCameraFrame(m_cameraId);
+        frame = new (m_framePool.get()) ExynosCameraFrame(m_cameraId);
         m_worklist->pushProcessQ(&frame);
 #if defined EXYNOS_CAMERA_FRAME_CREATE_PERFORMANCE
         count++;
@@ -887,6 +900,7 @@ status_t RunWorker::m_init()
         m_worklist.clear();
         m_framekeyQueue = new frame_key_queue_t(m_numOfMargin);
         m_framekeyQueue->setWaitTime(RUN_THREAD_TIMEOUT);
+        m_framekeyQueue->setRingSize(m_numOfDumpMargin);
         break;
     case FRAMEMGR_OPER::SLIENT:
         m_thread =  new FrameManagerThread(this,
@@ -896,6 +910,7 @@ status_t RunWorker::m_init()
         m_worklist.clear();
         m_framekeyQueue = new frame_key_queue_t(m_numOfMargin);
         m_framekeyQueue->setWaitTime(RUN_THREAD_TIMEOUT);
+        m_framekeyQueue->setRingSize(m_numOfDumpMargin);
         break;
     case FRAMEMGR_OPER::NONE:
     default:
@@ -43,6 +43,7 @@
 #include "ExynosCameraConfigurations.h"
 #include "ExynosCameraThread.h"
 #include "ExynosCameraFrame.h"
+#include "ExynosCameraFramePool.h"
 #include "ExynosCameraList.h"
 
 namespace android {
@@ -238,6 +239,7 @@ private:
 private:
     frame_manager_queue_t   *m_worklist;
     mutable Mutex           *m_lock;
+    sp<ExynosCameraFramePool> m_framePool;
 
 #if defined EXYNOS_CAMERA_FRAME_CREATE_PERFORMANCE
     ExynosCameraDurationTimer	m_createTimer;
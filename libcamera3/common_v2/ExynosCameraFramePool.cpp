@@ -0,0 +1,192 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/* #define LOG_NDEBUG 0 */
+#define LOG_TAG "ExynosCameraFramePool"
+#include <log/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosCameraFramePool.h"
+
+namespace android {
+
+#define FRAME_POOL_ALIGN(size) (((size) + sizeof(frame_pool_header_t) - 1) & ~(sizeof(frame_pool_header_t) - 1))
+
+ExynosCameraFramePool::ExynosCameraFramePool(const char *name, int cameraId, size_t blockSize)
+{
+    m_cameraId = cameraId;
+    memset(m_name, 0x00, sizeof(m_name));
+    strncpy(m_name, name, EXYNOS_CAMERA_NAME_STR_SIZE - 1);
+
+    m_blockSize = FRAME_POOL_ALIGN(blockSize);
+    m_count = 0;
+    m_slab = NULL;
+    m_freeList = NULL;
+    m_freeCount = 0;
+    m_hitCount = 0;
+    m_missCount = 0;
+}
+
+ExynosCameraFramePool::~ExynosCameraFramePool()
+{
+    dump();
+    m_freeSlab();
+}
+
+status_t ExynosCameraFramePool::setCount(int32_t count)
+{
+    Mutex::Autolock lock(m_lock);
+    size_t stride = sizeof(frame_pool_header_t) + m_blockSize;
+
+    if (count == m_count)
+        return NO_ERROR;
+
+    if (m_freeCount != m_count) {
+        CLOGW("%d blocks are in use, keep %d blocks", m_count - m_freeCount, m_count);
+        return INVALID_OPERATION;
+    }
+
+    if (count < 0 || count > FRAME_POOL_COUNT_MAX) {
+        CLOGE("invalid count(%d), max(%d)", count, FRAME_POOL_COUNT_MAX);
+        return BAD_VALUE;
+    }
+
+    m_freeSlab();
+
+    if (count == 0)
+        return NO_ERROR;
+
+    m_slab = (char *)malloc(stride * count);
+    m_freeList = new frame_pool_header_t*[count];
+    if (m_slab == NULL || m_freeList == NULL) {
+        CLOGE("failed to allocate %d blocks of %zu bytes", count, m_blockSize);
+        m_freeSlab();
+        return NO_MEMORY;
+    }
+
+    /* the first block is handed out first */
+    for (int32_t i = 0; i < count; i++)
+        m_freeList[i] = (frame_pool_header_t *)(m_slab + stride * (count - 1 - i));
+
+    m_count = count;
+    m_freeCount = count;
+
+    CLOGD("%d blocks of %zu bytes", m_count, m_blockSize);
+
+    return NO_ERROR;
+}
+
+int32_t ExynosCameraFramePool::getCount(void)
+{
+    Mutex::Autolock lock(m_lock);
+    return m_count;
+}
+
+int32_t ExynosCameraFramePool::getFreeCount(void)
+{
+    Mutex::Autolock lock(m_lock);
+    return m_freeCount;
+}
+
+void *ExynosCameraFramePool::alloc(size_t size)
+{
+    frame_pool_header_t *header = NULL;
+
+    if (size <= m_blockSize) {
+        Mutex::Autolock lock(m_lock);
+        if (m_freeCount > 0) {
+            header = m_freeList[--m_freeCount];
+            m_hitCount++;
+        } else {
+            m_missCount++;
+        }
+    }
+
+    if (header == NULL)
+        return allocHeap(size);
+
+    header->pool = this;
+    incStrong(header);
+
+    return header + 1;
+}
+
+void ExynosCameraFramePool::dump(void)
+{
+    Mutex::Autolock lock(m_lock);
+
+    CLOGD("blocks(%d) free(%d) hit(%u) miss(%u)",
+            m_count, m_freeCount, m_hitCount, m_missCount);
+}
+
+void *ExynosCameraFramePool::allocHeap(size_t size)
+{
+    frame_pool_header_t *header = (frame_pool_header_t *)malloc(sizeof(frame_pool_header_t) + size);
+    if (header == NULL)
+        return NULL;
+
+    header->pool = NULL;
+
+    return header + 1;
+}
+
+void ExynosCameraFramePool::release(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    frame_pool_header_t *header = (frame_pool_header_t *)ptr - 1;
+    ExynosCameraFramePool *pool = header->pool;
+
+    if (pool == NULL) {
+        free(header);
+        return;
+    }
+
+    pool->m_release(header);
+
+    /* it can be the last reference when the worker is already gone */
+    pool->decStrong(header);
+}
+
+void ExynosCameraFramePool::m_release(frame_pool_header_t *header)
+{
+    Mutex::Autolock lock(m_lock);
+
+    header->pool = NULL;
+    m_freeList[m_freeCount++] = header;
+}
+
+void ExynosCameraFramePool::m_freeSlab(void)
+{
+    if (m_slab != NULL) {
+        free(m_slab);
+        m_slab = NULL;
+    }
+
+    if (m_freeList != NULL) {
+        delete[] m_freeList;
+        m_freeList = NULL;
+    }
+
+    m_count = 0;
+    m_freeCount = 0;
+}
+
+}; /* namespace android */
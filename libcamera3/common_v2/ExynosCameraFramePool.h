@@ -0,0 +1,93 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraFramePool.h
+ * \brief     header file for ExynosCameraFramePool
+ */
+
+#ifndef EXYNOS_CAMERA_FRAME_POOL_H
+#define EXYNOS_CAMERA_FRAME_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utils/Errors.h>
+#include <utils/Mutex.h>
+#include <utils/RefBase.h>
+
+#include "ExynosCameraCommonDefine.h"
+
+namespace android {
+
+#define FRAME_POOL_COUNT_MAX (1024)
+
+class ExynosCameraFramePool;
+
+/* every block starts with it, the pool is NULL for a block from the heap */
+typedef struct frame_pool_header {
+    ExynosCameraFramePool *pool;
+} __attribute__((aligned(16))) frame_pool_header_t;
+
+/*
+ * Fixed size blocks carved out of one preallocated slab, for the frames of a CreateWorker.
+ * A frame is constructed into a block and destructed as before, only its memory is recycled.
+ * A block in use holds a reference of its pool, so the slab lives until the last frame is released
+ * even if the worker is gone. When the slab is used up, blocks come from the heap.
+ */
+class ExynosCameraFramePool : public virtual RefBase {
+public:
+    ExynosCameraFramePool(const char *name, int cameraId, size_t blockSize);
+    virtual ~ExynosCameraFramePool();
+
+    /* allocates the slab again, only while no block is in use */
+    status_t        setCount(int32_t count);
+    int32_t         getCount(void);
+    int32_t         getFreeCount(void);
+
+    /* a block of the slab, or of the heap if the slab is used up */
+    void            *alloc(size_t size);
+    void            dump(void);
+
+    /* a block made by any pool or by allocHeap */
+    static void     *allocHeap(size_t size);
+    static void     release(void *ptr);
+
+private:
+    void            m_release(frame_pool_header_t *header);
+    void            m_freeSlab(void);
+
+private:
+    int                     m_cameraId;
+    char                    m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
+
+    size_t                  m_blockSize;
+    int32_t                 m_count;
+    char                    *m_slab;
+
+    /* stack of the free blocks */
+    frame_pool_header_t     **m_freeList;
+    int32_t                 m_freeCount;
+
+    uint32_t                m_hitCount;
+    uint32_t                m_missCount;
+
+    mutable Mutex           m_lock;
+};
+
+}; /* namespace android */
+#endif
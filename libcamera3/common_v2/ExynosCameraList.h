@@ -39,13 +39,20 @@
 #include <sys/poll.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
+#include <atomic>
 #include <utils/threads.h>
+#include <utils/Timers.h>
 
 #include <utils/RefBase.h>
 #include <utils/String8.h>
 #include <utils/List.h>
 #include "cutils/properties.h"
 
+#include "ExynosCameraRing.h"
+
 #define THREAD_NAME_DEFAULT "ExynosList%d"
 #define WAIT_TIME (150 * 1000000)
 #define DEFAULT_PROCESSQ_MARGIN (1)
@@ -69,6 +76,7 @@ public:
         m_waitTime = WAIT_TIME;
         m_thread = NULL;
         m_processQMargin = processQMargin;
+        m_initRing();
     }
 
     ExynosCameraList(sp<Thread> thread, uint32_t processQMargin = DEFAULT_PROCESSQ_MARGIN)
@@ -80,11 +88,43 @@ public:
 
         m_thread = thread;
         m_processQMargin = processQMargin;
+        m_initRing();
+        m_hasThread.store(thread != NULL, std::memory_order_release);
     }
 
     ~ExynosCameraList()
     {
         release();
+
+        if (m_ring != NULL)
+            delete m_ring;
+    }
+
+    /*
+     * Puts the items into a preallocated lock-free ring of the size instead of the list,
+     * 0 goes back to the list. Waiting takes a futex instead of the mutex and condition.
+     * Items pushed while the ring is full go to the list after it, so nothing is dropped.
+     * The raw list can't be used with the ring. It can be changed only while the queue is empty.
+     */
+    status_t setRingSize(uint32_t size)
+    {
+        Mutex::Autolock lock(m_processQMutex);
+
+        if (m_processQ.size() > 0 || (m_ring != NULL && m_ring->size() > 0)
+            || m_waitProcessQ || m_ringWaiter.load() > 0) {
+            ALOGE("ERR(%s[%d]):queue is in use, can't change the ring size(%d)", __FUNCTION__, __LINE__, size);
+            return INVALID_OPERATION;
+        }
+
+        if (m_ring != NULL) {
+            delete m_ring;
+            m_ring = NULL;
+        }
+
+        if (size > 0)
+            m_ring = new ExynosCameraRing<T>(size);
+
+        return NO_ERROR;
     }
 
     void setName(const char* name, ...)
@@ -105,6 +145,7 @@ public:
     {
         m_processQMutex.lock();
         m_thread = thread;
+        m_hasThread.store(thread != NULL, std::memory_order_release);
         m_processQMutex.unlock();
     }
 
@@ -112,6 +153,11 @@ public:
     {
         setStatusException(TIMED_OUT);
 
+        if (m_ring != NULL) {
+            m_wakeRing(INT_MAX);
+            return;
+        }
+
         Mutex::Autolock lock(m_processQMutex);
         if (m_waitProcessQ)
             m_processQCondition.signal();
@@ -144,50 +190,23 @@ public:
     /* Process Queue */
     void pushProcessQ(T *buf)
     {
-        status_t ret = NO_ERROR;
-        int retryCount = 3;
-        bool retryFlag = false;
-
         if (buf == NULL) {
             ALOGW("WARN(%s[%d]):Input buf is NULL", __FUNCTION__, __LINE__);
             return;
         }
 
+        if (m_ring != NULL) {
+            m_pushRing(buf);
+            return;
+        }
+
         Mutex::Autolock lock(m_processQMutex);
         m_processQ.push_back(*buf);
 
         if (m_waitProcessQ && m_processQ.size() >= m_processQMargin) {
             m_processQCondition.signal();
         } else if (m_thread != NULL && m_thread->isRunning() == false && m_processQ.size() >= m_processQMargin) {
-            do {
-                if (m_name.empty())
-                    setName(THREAD_NAME_DEFAULT, gettid());
-
-                ret = m_thread->run(m_name.c_str());
-                switch (ret) {
-                    case INVALID_OPERATION:
-                        /* Already running */
-                        ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                    case UNKNOWN_ERROR:
-                        /* Failed to run thread */
-                        ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
-                                __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
-
-                        retryFlag = true;
-                        break;
-                    default:
-                        /* Success to run thread */
-                        ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                }
-            } while (retryFlag == true && retryCount-- > 0);
+            m_runThread();
         }
     };
 
@@ -195,6 +214,9 @@ public:
     {
         iterator r;
 
+        if (m_ring != NULL)
+            return (m_popRing(buf) == true) ? OK : TIMED_OUT;
+
         Mutex::Autolock lock(m_processQMutex);
         if (m_processQ.empty())
             return TIMED_OUT;
@@ -210,6 +232,9 @@ public:
     {
         iterator r;
 
+        if (m_ring != NULL)
+            return m_waitAndPopRing(buf);
+
         status_t ret;
         m_processQMutex.lock();
         if (m_processQ.size() < m_processQMargin) {
@@ -257,6 +282,9 @@ public:
 
     int getSizeOfProcessQ(void)
     {
+        if (m_ring != NULL)
+            return m_getRingQSize();
+
         Mutex::Autolock lock(m_processQMutex);
         return m_processQ.size();
     };
@@ -266,6 +294,11 @@ public:
     {
         setStatusException(TIMED_OUT);
 
+        if (m_ring != NULL) {
+            m_releaseRing();
+            return;
+        }
+
         m_processQMutex.lock();
         if (m_waitProcessQ)
             m_processQCondition.signal();
@@ -286,6 +319,9 @@ public:
     }
 
     bool isWaiting(void) {
+        if (m_ring != NULL)
+            return (m_ringWaiter.load() > 0);
+
         Mutex::Autolock lock(m_processQMutex);
         return m_waitProcessQ;
     }
@@ -300,11 +336,211 @@ public:
         m_processQMutex.unlock();
     }
 
-    /* for all element control in loop */
+    /* for all element control in loop, only the overflowed items are in the list with the ring */
     List<T> *getRawProcessList(void) {
+        if (m_ring != NULL)
+            ALOGE("ERR(%s[%d]):the queue uses a ring, the list isn't all of the items", __FUNCTION__, __LINE__);
+
         return &m_processQ;
     }
 
+private:
+    /* called with m_processQMutex */
+    void m_runThread(void)
+    {
+        status_t ret = NO_ERROR;
+        int retryCount = 3;
+        bool retryFlag = false;
+
+        do {
+            if (m_name.empty())
+                setName(THREAD_NAME_DEFAULT, gettid());
+
+            ret = m_thread->run(m_name.c_str());
+            switch (ret) {
+                case INVALID_OPERATION:
+                    /* Already running */
+                    ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+                case UNKNOWN_ERROR:
+                    /* Failed to run thread */
+                    ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
+                            __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
+
+                    retryFlag = true;
+                    break;
+                default:
+                    /* Success to run thread */
+                    ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+            }
+        } while (retryFlag == true && retryCount-- > 0);
+    }
+
+    void m_initRing(void)
+    {
+        m_ring = NULL;
+        m_overflowCount.store(0);
+        m_ringEvent.store(0);
+        m_ringWaiter.store(0);
+        m_hasThread.store(false);
+    }
+
+    uint32_t m_getRingQSize(void)
+    {
+        return m_ring->size() + m_overflowCount.load(std::memory_order_acquire);
+    }
+
+    void m_pushRing(T *buf)
+    {
+        /* once an item went to the list, the next ones follow it to keep the order */
+        if (m_overflowCount.load(std::memory_order_acquire) > 0 || m_ring->push(*buf) == false) {
+            Mutex::Autolock lock(m_processQMutex);
+            if (m_processQ.empty())
+                ALOGW("WARN(%s[%d]):ring(%d) is full, use the list", __FUNCTION__, __LINE__, m_ring->getCapacity());
+
+            m_processQ.push_back(*buf);
+            m_overflowCount.fetch_add(1, std::memory_order_release);
+        }
+
+        m_ringEvent.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_getRingQSize() < m_processQMargin)
+            return;
+
+        if (m_ringWaiter.load(std::memory_order_seq_cst) > 0) {
+            m_futexWake(1);
+        } else if (m_hasThread.load(std::memory_order_acquire) == true) {
+            Mutex::Autolock lock(m_processQMutex);
+            if (m_thread != NULL && m_thread->isRunning() == false)
+                m_runThread();
+        }
+    }
+
+    bool m_popRing(T *buf)
+    {
+        iterator r;
+
+        if (m_ring->pop(buf) == true)
+            return true;
+
+        if (m_overflowCount.load(std::memory_order_acquire) == 0)
+            return false;
+
+        Mutex::Autolock lock(m_processQMutex);
+        if (m_processQ.empty())
+            return false;
+
+        r = m_processQ.begin();
+        *buf = *r;
+        m_processQ.erase(r);
+        m_overflowCount.fetch_sub(1, std::memory_order_release);
+
+        return true;
+    }
+
+    status_t m_waitAndPopRing(T *buf)
+    {
+        status_t ret = NO_ERROR;
+
+        if (m_getRingQSize() < m_processQMargin) {
+            nsecs_t timeout = systemTime(SYSTEM_TIME_MONOTONIC) + m_waitTime;
+            nsecs_t remain;
+            uint32_t event;
+
+            setStatusException(NO_ERROR);
+            m_ringWaiter.fetch_add(1, std::memory_order_seq_cst);
+
+            /* a push or a wakeup after the event is read makes the futex return at once */
+            while (1) {
+                event = m_ringEvent.load(std::memory_order_seq_cst);
+
+                if (m_getRingQSize() >= m_processQMargin)
+                    break;
+
+                ret = getStatusException();
+                if (ret != NO_ERROR)
+                    break;
+
+                remain = timeout - systemTime(SYSTEM_TIME_MONOTONIC);
+                if (remain <= 0) {
+                    ret = TIMED_OUT;
+                    break;
+                }
+
+                m_futexWait(event, remain);
+            }
+
+            m_ringWaiter.fetch_sub(1, std::memory_order_seq_cst);
+
+            if (ret != NO_ERROR) {
+                if (ret == TIMED_OUT) {
+                    ALOGV("DEBUG(%s):Time out or canceled(%d), Skip to pop process Q", __FUNCTION__, ret);
+                } else {
+                    ALOGW("WARN(%s[%d]): Exception status(%d)", __FUNCTION__, __LINE__, ret);
+                }
+                return ret;
+            }
+        }
+
+        if (m_popRing(buf) == false) {
+            ALOGE("ERR(%s[%d]): processQ is empty, invalid state", __FUNCTION__, __LINE__);
+            return INVALID_OPERATION;
+        }
+
+        return OK;
+    }
+
+    void m_releaseRing(void)
+    {
+        T item;
+        uint32_t count = 0;
+
+        m_wakeRing(INT_MAX);
+
+        while (m_ring->pop(&item) == true)
+            count++;
+
+        m_processQMutex.lock();
+        count += m_processQ.size();
+        m_processQ.clear();
+        m_overflowCount.store(0, std::memory_order_release);
+        m_processQMutex.unlock();
+
+        if (count > 0) {
+            ALOGD("DEBUG(%s):Remained item %u will be deleted",
+                    __FUNCTION__, count);
+        }
+    }
+
+    void m_wakeRing(int count)
+    {
+        m_ringEvent.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_ringWaiter.load(std::memory_order_seq_cst) > 0)
+            m_futexWake(count);
+    }
+
+    void m_futexWait(uint32_t event, nsecs_t timeout)
+    {
+        struct timespec ts;
+
+        ts.tv_sec = timeout / 1000000000LL;
+        ts.tv_nsec = timeout % 1000000000LL;
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_ringEvent), FUTEX_WAIT_PRIVATE, event, &ts, NULL, 0);
+    }
+
+    void m_futexWake(int count)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_ringEvent), FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+
 private:
     List<T>             m_processQ;
     Mutex               m_processQMutex;
@@ -318,5 +554,14 @@ private:
 
     String8             m_name;
     sp<Thread>          m_thread;
+
+    /* NULL while the list is used */
+    ExynosCameraRing<T>     *m_ring;
+    /* items in the list because the ring was full */
+    std::atomic<uint32_t>   m_overflowCount;
+    /* futex word, it's increased at every push and wakeup */
+    std::atomic<uint32_t>   m_ringEvent;
+    std::atomic<uint32_t>   m_ringWaiter;
+    std::atomic<bool>       m_hasThread;
 };
 #endif
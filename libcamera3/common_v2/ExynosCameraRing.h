@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraRing.h
+ * \brief     header file for ExynosCameraRing
+ */
+
+#ifndef EXYNOS_CAMERA_RING_H__
+#define EXYNOS_CAMERA_RING_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#define RING_CACHE_LINE_SIZE (64)
+
+/*
+ * Bounded multi-producer multi-consumer ring, the cells are allocated once.
+ * A producer owns a cell when its sequence is the position, a consumer owns it
+ * when the sequence is the position + 1. Both sides race only for the position
+ * with a compare-and-swap, so a single producer and consumer never retry.
+ */
+template<typename T>
+class ExynosCameraRing {
+public:
+    /* size is rounded up to a power of two */
+    ExynosCameraRing(uint32_t size)
+    {
+        uint32_t ringSize = 2;
+        while (ringSize < size)
+            ringSize <<= 1;
+
+        m_cell = new ring_cell_t[ringSize];
+        m_mask = ringSize - 1;
+
+        for (uint32_t i = 0; i < ringSize; i++)
+            m_cell[i].sequence.store(i, std::memory_order_relaxed);
+
+        m_pushPos.store(0, std::memory_order_relaxed);
+        m_popPos.store(0, std::memory_order_relaxed);
+    }
+
+    ~ExynosCameraRing()
+    {
+        delete[] m_cell;
+    }
+
+    /* false if the ring is full */
+    bool push(const T &data)
+    {
+        ring_cell_t *cell;
+        size_t pos = m_pushPos.load(std::memory_order_relaxed);
+
+        while (1) {
+            cell = &m_cell[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0) {
+                if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_pushPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = data;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* false if the ring is empty, the cell drops its copy so a sp<> doesn't stay in the ring */
+    bool pop(T *data)
+    {
+        ring_cell_t *cell;
+        size_t pos = m_popPos.load(std::memory_order_relaxed);
+
+        while (1) {
+            cell = &m_cell[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (diff == 0) {
+                if (m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_popPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *data = cell->data;
+        cell->data = T();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* it can be stale while other threads push or pop */
+    uint32_t size(void)
+    {
+        size_t pushPos = m_pushPos.load(std::memory_order_acquire);
+        size_t popPos = m_popPos.load(std::memory_order_acquire);
+
+        return (pushPos > popPos) ? (uint32_t)(pushPos - popPos) : 0;
+    }
+
+    uint32_t getCapacity(void)
+    {
+        return m_mask + 1;
+    }
+
+private:
+    typedef struct ring_cell {
+        std::atomic<size_t> sequence;
+        T data;
+    } ring_cell_t;
+
+    ring_cell_t *m_cell;
+    uint32_t m_mask;
+
+    /* producers and consumers don't share the cache line of their position */
+    char m_pad0[RING_CACHE_LINE_SIZE];
+    std::atomic<size_t> m_pushPos;
+    char m_pad1[RING_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_popPos;
+    char m_pad2[RING_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+#endif
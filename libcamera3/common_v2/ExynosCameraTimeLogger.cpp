@@ -26,6 +26,10 @@ ExynosCameraTimeLogger::ExynosCameraTimeLogger()
 {
     strncpy(m_name, "TimeLogger", (EXYNOS_CAMERA_NAME_STR_SIZE - 1));
 
+    /* the trace looks up any category, including the range markers */
+    memset(m_typeStr, 0x00, sizeof(m_typeStr));
+    memset(m_categoryStr, 0x00, sizeof(m_categoryStr));
+
     m_typeStr[LOGGER_TYPE_BASE]                                         = MAKE_STRING(INIT);
     m_typeStr[LOGGER_TYPE_INTERVAL]                                     = MAKE_STRING(INTERVAL);
     m_typeStr[LOGGER_TYPE_DURATION]                                     = MAKE_STRING(DURATION);
@@ -127,6 +131,11 @@ ExynosCameraTimeLogger::ExynosCameraTimeLogger()
         m_stopFlag[i] = true;
         m_firstCheckFlag[i] = true;
     }
+
+#ifdef TIME_LOGGER_TRACE_ENABLE
+    m_traceRecorder.setLoggerName(m_typeStr, LOGGER_TYPE_MAX, m_categoryStr, LOGGER_CATEGORY_MAX);
+    m_traceRecorder.setEnable(true);
+#endif
 }
 
 ExynosCameraTimeLogger::~ExynosCameraTimeLogger()
@@ -259,6 +268,16 @@ p_logger:
             m_categoryStr[buffer->category],
             buffer->calTime);
 
+#ifdef TIME_LOGGER_TRACE_ENABLE
+    if (m_traceRecorder.isEnabled() == true) {
+        uint64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        uint64_t start = (type == LOGGER_TYPE_DURATION) ? now - (uint64_t)buffer->calTime * 1000 : now;
+
+        m_traceRecorder.record(CAMERA_TRACE_EVENT_LOGGER, cameraId, pipeId, key, start, now,
+                               buffer->calTime, type, category);
+    }
+#endif
+
     return ret;
 }
 
@@ -323,6 +342,43 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
     return ret;
 }
 
+#ifdef TIME_LOGGER_TRACE_ENABLE
+void ExynosCameraTimeLogger::setTracePipeName(int cameraId, uint32_t pipeId, const char *name)
+{
+    m_traceRecorder.setPipeName(cameraId, pipeId, name);
+}
+
+status_t ExynosCameraTimeLogger::saveTrace(int cameraId)
+{
+    status_t ret = NO_ERROR;
+    char filePath[128];
+    long long now = (long long)systemTime(SYSTEM_TIME_MONOTONIC);
+
+    if (m_traceRecorder.isEnabled() == false)
+        return ret;
+
+    snprintf(filePath, sizeof(filePath), TIME_LOGGER_TRACE_PATH, cameraId, now, "json");
+    ret = m_traceRecorder.exportTrace(CAMERA_TRACE_FORMAT_CHROME_JSON, filePath);
+    if (ret != NO_ERROR) {
+        CLOGE3(cameraId, "can't save the trace(%s)", filePath);
+        return ret;
+    }
+
+    CLOGD3(cameraId, "save the trace(%s)", filePath);
+
+    snprintf(filePath, sizeof(filePath), TIME_LOGGER_TRACE_PATH, cameraId, now, "bin");
+    ret = m_traceRecorder.exportTrace(CAMERA_TRACE_FORMAT_BINARY, filePath);
+    if (ret != NO_ERROR) {
+        CLOGE3(cameraId, "can't save the trace(%s)", filePath);
+        return ret;
+    }
+
+    CLOGD3(cameraId, "save the trace(%s)", filePath);
+
+    return ret;
+}
+#endif
+
 bool ExynosCameraTimeLogger::checkCondition(LOGGER_CATEGORY category)
 {
     if (category > LOGGER_CATEGORY_LAUNCHING_TIME_START
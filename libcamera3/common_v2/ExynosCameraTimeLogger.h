@@ -36,6 +36,10 @@
 #include "ExynosCameraCommonInclude.h"
 #include "ExynosCameraSingleton.h"
 #include "ExynosCameraSensorInfoBase.h"
+#ifdef TIME_LOGGER_TRACE_ENABLE
+/* ExynosCameraTraceRecorder.cpp has to be in the source list of the HAL to turn it on */
+#include "ExynosCameraTraceRecorder.h"
+#endif
 
 #define TIME_LOGGER_SIZE (1024 * 100) /* 100K * logger */
 #ifdef CAMERA_GED_FEATURE
@@ -43,6 +47,11 @@
 #else
 #define TIME_LOGGER_PATH "/data/camera/exynos_camera_time_logger_cam%d_%lld.csv"
 #endif
+#ifdef CAMERA_GED_FEATURE
+#define TIME_LOGGER_TRACE_PATH "/data/dump/exynos_camera_trace_cam%d_%lld.%s"
+#else
+#define TIME_LOGGER_TRACE_PATH "/data/camera/exynos_camera_trace_cam%d_%lld.%s"
+#endif
 
 #define TIME_LOGGER_INIT_BASE(logger, cameraId)          \
             ({ (logger)->init(cameraId); })
@@ -75,6 +84,32 @@
 #define TIME_LOGGER_SAVE(cameraId)
 #endif
 
+/*
+ * Pipe events for the trace export, TIME_LOGGER_TRACE_ENABLE turns them on.
+ * type : PIPE_PUSH, PIPE_DONE (you can remove "CAMERA_TRACE_EVENT_" prefix)
+ */
+#if defined(TIME_LOGGER_ENABLE) && defined(TIME_LOGGER_TRACE_ENABLE)
+#define TIME_LOGGER_TRACE(cameraId, key, pipeId, type)  \
+        ({                                              \
+            ExynosCameraTimeLogger *logger = ExynosCameraSingleton<ExynosCameraTimeLogger>::getInstance(); \
+            logger->trace(cameraId, key, pipeId, CAMERA_TRACE_EVENT_ ## type); \
+        })
+#define TIME_LOGGER_TRACE_PIPE_NAME(cameraId, pipeId, name) \
+        ({                                              \
+            ExynosCameraTimeLogger *logger = ExynosCameraSingleton<ExynosCameraTimeLogger>::getInstance(); \
+            logger->setTracePipeName(cameraId, pipeId, name); \
+        })
+#define TIME_LOGGER_TRACE_SAVE(cameraId)                \
+        ({                                              \
+            ExynosCameraTimeLogger *logger = ExynosCameraSingleton<ExynosCameraTimeLogger>::getInstance(); \
+            logger->saveTrace(cameraId);                \
+        })
+#else
+#define TIME_LOGGER_TRACE(cameraId, key, pipeId, type)
+#define TIME_LOGGER_TRACE_PIPE_NAME(cameraId, pipeId, name)
+#define TIME_LOGGER_TRACE_SAVE(cameraId)
+#endif
+
 using namespace android;
 
 typedef enum LOGGER_TYPE {
@@ -233,6 +268,29 @@ public:
      */
     status_t save(int cameraId);
 
+#ifdef TIME_LOGGER_TRACE_ENABLE
+    /*
+     * pipe events of a frame, the trace links them by the key
+     *  @key : frameCount
+     *  @type : CAMERA_TRACE_EVENT_PIPE_PUSH or CAMERA_TRACE_EVENT_PIPE_DONE
+     */
+    void trace(int cameraId, uint64_t key, uint32_t pipeId, enum camera_trace_event_type type)
+    {
+        if (m_traceRecorder.isEnabled() == false)
+            return;
+
+        uint64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        m_traceRecorder.record(type, cameraId, pipeId, key, now, now);
+    }
+
+    void setTracePipeName(int cameraId, uint32_t pipeId, const char *name);
+
+    /*
+     * save the trace of all cameras to a Chrome trace JSON and a binary dump for camera_trace_summary
+     */
+    status_t saveTrace(int cameraId);
+#endif
+
     /*
      * check define condition to do logging
      */
@@ -252,5 +310,8 @@ private:
     char                    m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
     char                    *m_typeStr[LOGGER_TYPE_MAX];
     char                    *m_categoryStr[LOGGER_CATEGORY_MAX];
+#ifdef TIME_LOGGER_TRACE_ENABLE
+    ExynosCameraTraceRecorder   m_traceRecorder;
+#endif
 };
 #endif //EXYNOS_CAMERA_TIME_LOGGER_H
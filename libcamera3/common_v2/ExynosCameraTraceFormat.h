@@ -0,0 +1,84 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraTraceFormat.h
+ * \brief     header file for the binary dump of ExynosCameraTraceRecorder
+ */
+
+#ifndef EXYNOS_CAMERA_TRACE_FORMAT_H
+#define EXYNOS_CAMERA_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+/*
+ * File of exportTrace(CAMERA_TRACE_FORMAT_BINARY), parsed on the PC by tools/camera_trace_summary.
+ * camera_trace_file_header_t, the pipe names (pipe_num x camera_trace_pipe_t), then the records of
+ * all threads sorted by start_ns (record_num x camera_trace_record_t). Little endian, no padding.
+ */
+
+#define CAMERA_TRACE_FILE_MAGIC         0x52544345  /* "ECTR" */
+#define CAMERA_TRACE_FILE_VERSION       1
+
+#define CAMERA_TRACE_PIPE_NAME_SIZE     32
+
+enum camera_trace_event_type {
+    /* the frame is pushed into the input queue of the pipe, an instant */
+    CAMERA_TRACE_EVENT_PIPE_PUSH = 1,
+    /* the pipe sets the entity of the frame to FRAME_DONE, an instant */
+    CAMERA_TRACE_EVENT_PIPE_DONE = 2,
+    /* ExynosCameraTimeLogger::update(), the logger type and category are in the record */
+    CAMERA_TRACE_EVENT_LOGGER = 3
+};
+
+enum camera_trace_format {
+    CAMERA_TRACE_FORMAT_CHROME_JSON = 0,
+    CAMERA_TRACE_FORMAT_BINARY = 1
+};
+
+typedef struct _camera_trace_file_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pipe_num;
+    uint32_t record_num;
+    /* records lost because a ring of a thread wrapped */
+    uint64_t dropped_num;
+} camera_trace_file_header_t;
+
+typedef struct _camera_trace_pipe_t {
+    uint32_t camera_id;
+    uint32_t pipe_id;
+    char name[CAMERA_TRACE_PIPE_NAME_SIZE];
+} camera_trace_pipe_t;
+
+typedef struct _camera_trace_record_t {
+    uint32_t type;
+    uint32_t camera_id;
+    uint32_t pipe_id;
+    uint32_t tid;
+    /* the frame count for the pipe events, the key of update() for the logger */
+    uint64_t key;
+    /* monotonic ns, end_ns is start_ns for an instant */
+    uint64_t start_ns;
+    uint64_t end_ns;
+    /* logger: calTime of update() */
+    uint64_t value;
+    /* logger: LOGGER_TYPE and LOGGER_CATEGORY */
+    uint32_t logger_type;
+    uint32_t logger_category;
+} camera_trace_record_t;
+
+#endif
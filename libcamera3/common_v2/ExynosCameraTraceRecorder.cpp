@@ -0,0 +1,575 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* #define LOG_NDEBUG 0 */
+#define LOG_TAG "ExynosCameraTraceRecorder"
+#include <log/log.h>
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "ExynosCameraTraceRecorder.h"
+
+namespace android {
+
+typedef struct trace_ring_cache {
+    uint32_t    recorderId;
+    void        *ring;
+} trace_ring_cache_t;
+
+/* rings of a thread, given back to the recorders that still live when the thread exits */
+class TraceRingOwner {
+public:
+    ~TraceRingOwner();
+    void add(uint32_t recorderId, std::atomic<bool> *owned);
+
+private:
+    std::vector<std::pair<uint32_t, std::atomic<bool> *> > m_owned;
+};
+
+static std::atomic<uint32_t> g_traceRecorderId(0);
+/* ids of the recorders that aren't destroyed, a recorder frees its rings after it leaves the set */
+static pthread_mutex_t g_traceRecorderLock = PTHREAD_MUTEX_INITIALIZER;
+static std::set<uint32_t> g_traceRecorderIdSet;
+/* the ring of the last recorder the thread recorded to, a NULL ring means it has none */
+static thread_local trace_ring_cache_t t_ringCache = {0, NULL};
+static thread_local TraceRingOwner t_ringOwner;
+
+TraceRingOwner::~TraceRingOwner()
+{
+    pthread_mutex_lock(&g_traceRecorderLock);
+    for (size_t i = 0; i < m_owned.size(); i++) {
+        if (g_traceRecorderIdSet.count(m_owned[i].first))
+            m_owned[i].second->store(false, std::memory_order_release);
+    }
+    pthread_mutex_unlock(&g_traceRecorderLock);
+}
+
+void TraceRingOwner::add(uint32_t recorderId, std::atomic<bool> *owned)
+{
+    size_t num = 0;
+
+    pthread_mutex_lock(&g_traceRecorderLock);
+    /* drops the rings of destroyed recorders */
+    for (size_t i = 0; i < m_owned.size(); i++) {
+        if (g_traceRecorderIdSet.count(m_owned[i].first))
+            m_owned[num++] = m_owned[i];
+    }
+    m_owned.resize(num);
+    m_owned.push_back(std::make_pair(recorderId, owned));
+    pthread_mutex_unlock(&g_traceRecorderLock);
+}
+
+/* "key":"value", thread names are set by the threads and can hold any byte */
+static void writeJsonField(FILE *fp, const char *key, const char *value)
+{
+    fprintf(fp, "\"%s\":\"", key);
+    for (; *value; value++) {
+        unsigned char c = (unsigned char)*value;
+
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fputc(c, fp);
+    }
+    fputc('"', fp);
+}
+
+/* ts and dur of the trace-event format are us */
+static void writeJsonTime(FILE *fp, const char *name, uint64_t ns)
+{
+    fprintf(fp, ",\"%s\":%llu.%03llu", name, (unsigned long long)(ns / 1000), (unsigned long long)(ns % 1000));
+}
+
+static void writeJsonSeparator(FILE *fp, bool *first)
+{
+    if (*first == false)
+        fprintf(fp, ",\n");
+    *first = false;
+}
+
+static bool compareRecordTime(const camera_trace_record_t &a, const camera_trace_record_t &b)
+{
+    return a.start_ns < b.start_ns;
+}
+
+ExynosCameraTraceRecorder::ExynosCameraTraceRecorder()
+{
+    m_id = g_traceRecorderId.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_enabled = false;
+    m_capacity = TRACE_RECORDER_DEFAULT_RECORD_NUM;
+    m_lostNum = 0;
+
+    m_typeStr = NULL;
+    m_typeNum = 0;
+    m_categoryStr = NULL;
+    m_categoryNum = 0;
+
+    pthread_mutex_lock(&g_traceRecorderLock);
+    g_traceRecorderIdSet.insert(m_id);
+    pthread_mutex_unlock(&g_traceRecorderLock);
+}
+
+ExynosCameraTraceRecorder::~ExynosCameraTraceRecorder()
+{
+    /* an exiting thread doesn't touch the rings after this */
+    pthread_mutex_lock(&g_traceRecorderLock);
+    g_traceRecorderIdSet.erase(m_id);
+    pthread_mutex_unlock(&g_traceRecorderLock);
+
+    for (size_t i = 0; i < m_ring.size(); i++) {
+        delete[] m_ring[i]->slot;
+        delete m_ring[i];
+    }
+    m_ring.clear();
+}
+
+status_t ExynosCameraTraceRecorder::setEnable(bool enable)
+{
+    Mutex::Autolock lock(m_lock);
+
+    m_enabled.store(enable, std::memory_order_release);
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraTraceRecorder::setCapacity(uint32_t recordNum)
+{
+    Mutex::Autolock lock(m_lock);
+
+    /* the rings are indexed with the old capacity by the threads that own them */
+    if (m_ring.size() != 0) {
+        CLOGE2("%zu threads have a ring of %u records already", m_ring.size(), m_capacity);
+        return INVALID_OPERATION;
+    }
+
+    if (recordNum == 0)
+        return BAD_VALUE;
+
+    m_capacity = 1;
+    while (m_capacity < recordNum)
+        m_capacity <<= 1;
+
+    return NO_ERROR;
+}
+
+uint32_t ExynosCameraTraceRecorder::getCapacity(void)
+{
+    Mutex::Autolock lock(m_lock);
+
+    return m_capacity;
+}
+
+uint32_t ExynosCameraTraceRecorder::getThreadCount(void)
+{
+    Mutex::Autolock lock(m_lock);
+
+    return m_ring.size();
+}
+
+void ExynosCameraTraceRecorder::setPipeName(int cameraId, uint32_t pipeId, const char *name)
+{
+    Mutex::Autolock lock(m_lock);
+    camera_trace_pipe_t pipe;
+
+    if (name == NULL)
+        return;
+
+    for (size_t i = 0; i < m_pipe.size(); i++) {
+        if (m_pipe[i].camera_id == (uint32_t)cameraId && m_pipe[i].pipe_id == pipeId) {
+            strncpy(m_pipe[i].name, name, CAMERA_TRACE_PIPE_NAME_SIZE - 1);
+            return;
+        }
+    }
+
+    if (m_pipe.size() >= TRACE_RECORDER_MAX_PIPE_NUM)
+        return;
+
+    memset(&pipe, 0x00, sizeof(pipe));
+    pipe.camera_id = cameraId;
+    pipe.pipe_id = pipeId;
+    strncpy(pipe.name, name, CAMERA_TRACE_PIPE_NAME_SIZE - 1);
+    m_pipe.push_back(pipe);
+}
+
+void ExynosCameraTraceRecorder::setLoggerName(char **typeStr, uint32_t typeNum, char **categoryStr, uint32_t categoryNum)
+{
+    Mutex::Autolock lock(m_lock);
+
+    m_typeStr = typeStr;
+    m_typeNum = typeNum;
+    m_categoryStr = categoryStr;
+    m_categoryNum = categoryNum;
+}
+
+ExynosCameraTraceRecorder::trace_ring_t *ExynosCameraTraceRecorder::m_getRing(void)
+{
+    trace_ring_t *ring = NULL;
+    char name[TRACE_RECORDER_THREAD_NAME_SIZE];
+    uint32_t tid;
+
+    if (t_ringCache.recorderId == m_id)
+        return (trace_ring_t *)t_ringCache.ring;
+
+    Mutex::Autolock lock(m_lock);
+
+    /* the thread has a ring already when it recorded to another recorder in between */
+    tid = (uint32_t)gettid();
+    for (size_t i = 0; i < m_ring.size(); i++) {
+        if (m_ring[i]->owned.load(std::memory_order_relaxed) && m_ring[i]->tid == tid) {
+            ring = m_ring[i];
+            break;
+        }
+    }
+
+    if (ring == NULL) {
+        /* the records of the exited thread are kept until they are overwritten */
+        for (size_t i = 0; i < m_ring.size(); i++) {
+            if (m_ring[i]->owned.load(std::memory_order_acquire) == false) {
+                ring = m_ring[i];
+                break;
+            }
+        }
+
+        if (ring == NULL && m_ring.size() < TRACE_RECORDER_MAX_THREAD_NUM) {
+            ring = new trace_ring_t;
+            ring->writePos.store(0, std::memory_order_relaxed);
+            ring->slot = new trace_slot_t[m_capacity];
+            for (uint32_t i = 0; i < m_capacity; i++)
+                ring->slot[i].sequence.store(0, std::memory_order_relaxed);
+            m_ring.push_back(ring);
+        }
+
+        if (ring != NULL) {
+            ring->tid = tid;
+            ring->owned.store(true, std::memory_order_relaxed);
+            t_ringOwner.add(m_id, &ring->owned);
+
+            memset(name, 0x00, sizeof(name));
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            m_threadName[tid] = name;
+        }
+    }
+
+    t_ringCache.recorderId = m_id;
+    t_ringCache.ring = ring;
+
+    return ring;
+}
+
+void ExynosCameraTraceRecorder::record(enum camera_trace_event_type type, int cameraId, uint32_t pipeId, uint64_t key,
+                                       uint64_t startNs, uint64_t endNs,
+                                       uint64_t value, uint32_t loggerType, uint32_t loggerCategory)
+{
+    trace_ring_t *ring;
+    trace_slot_t *slot;
+    uint64_t pos;
+
+    if (m_enabled.load(std::memory_order_relaxed) == false)
+        return;
+
+    ring = m_getRing();
+    if (ring == NULL) {
+        m_lostNum.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    pos = ring->writePos.load(std::memory_order_relaxed);
+    slot = &ring->slot[pos & (m_capacity - 1)];
+
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->record.type = type;
+    slot->record.camera_id = cameraId;
+    slot->record.pipe_id = pipeId;
+    slot->record.tid = ring->tid;
+    slot->record.key = key;
+    slot->record.start_ns = startNs;
+    slot->record.end_ns = endNs;
+    slot->record.value = value;
+    slot->record.logger_type = loggerType;
+    slot->record.logger_category = loggerCategory;
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    ring->writePos.store(pos + 1, std::memory_order_release);
+}
+
+uint32_t ExynosCameraTraceRecorder::m_snapshot(std::vector<camera_trace_record_t> *records, uint64_t *droppedNum)
+{
+    *droppedNum = m_lostNum.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < m_ring.size(); i++) {
+        trace_ring_t *ring = m_ring[i];
+        uint64_t writePos = ring->writePos.load(std::memory_order_acquire);
+        uint64_t beginPos = (writePos > m_capacity) ? (writePos - m_capacity) : 0;
+
+        *droppedNum += beginPos;
+
+        /* the owner thread can wrap onto a slot while it's copied, the sequence tells it */
+        for (uint64_t pos = beginPos; pos < writePos; pos++) {
+            trace_slot_t *slot = &ring->slot[pos & (m_capacity - 1)];
+
+            if (slot->sequence.load(std::memory_order_acquire) != pos + 1)
+                continue;
+
+            camera_trace_record_t record = slot->record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot->sequence.load(std::memory_order_relaxed) != pos + 1)
+                continue;
+
+            records->push_back(record);
+        }
+    }
+
+    /* the rings are merged in time, the pipe events of a frame are paired in this order */
+    std::stable_sort(records->begin(), records->end(), compareRecordTime);
+
+    return records->size();
+}
+
+const char *ExynosCameraTraceRecorder::m_getPipeName(uint32_t cameraId, uint32_t pipeId)
+{
+    for (size_t i = 0; i < m_pipe.size(); i++) {
+        if (m_pipe[i].camera_id == cameraId && m_pipe[i].pipe_id == pipeId)
+            return m_pipe[i].name;
+    }
+
+    return NULL;
+}
+
+const char *ExynosCameraTraceRecorder::m_getThreadName(uint32_t tid)
+{
+    std::map<uint32_t, std::string>::iterator iter = m_threadName.find(tid);
+    if (iter != m_threadName.end())
+        return iter->second.c_str();
+
+    return "";
+}
+
+const char *ExynosCameraTraceRecorder::m_getLoggerStr(char **str, uint32_t num, uint32_t index)
+{
+    if (str == NULL || index >= num || str[index] == NULL)
+        return "unknown";
+
+    return str[index];
+}
+
+/*
+ * A camera is a process and the recording threads are its threads.
+ * A pipe event is a zero length slice on its thread and the pipe events of a frame
+ * are linked by a flow in time order. A push and the next done of the same pipe and
+ * frame make an async slice of the stage, named after the pipe.
+ */
+status_t ExynosCameraTraceRecorder::m_exportChromeJson(FILE *fp, std::vector<camera_trace_record_t> *records)
+{
+    typedef std::pair<uint32_t, uint64_t> frame_key_t;
+    typedef std::pair<std::pair<uint32_t, uint32_t>, uint64_t> stage_key_t;
+
+    std::map<frame_key_t, uint32_t> frameEventNum, frameEventIndex;
+    std::map<stage_key_t, const camera_trace_record_t *> pushRecord;
+    std::set<uint32_t> cameraSet;
+    std::set<std::pair<uint32_t, uint32_t> > threadSet;
+    bool first = true;
+    char pipeName[CAMERA_TRACE_PIPE_NAME_SIZE];
+    char eventName[CAMERA_TRACE_PIPE_NAME_SIZE + 8];
+
+    for (size_t i = 0; i < records->size(); i++) {
+        const camera_trace_record_t &record = records->at(i);
+
+        cameraSet.insert(record.camera_id);
+        threadSet.insert(std::make_pair(record.camera_id, record.tid));
+        if (record.type != CAMERA_TRACE_EVENT_LOGGER)
+            frameEventNum[frame_key_t(record.camera_id, record.key)]++;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (std::set<uint32_t>::iterator iter = cameraSet.begin(); iter != cameraSet.end(); iter++) {
+        writeJsonSeparator(fp, &first);
+        fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"camera%u\"}}", *iter, *iter);
+    }
+
+    for (std::set<std::pair<uint32_t, uint32_t> >::iterator iter = threadSet.begin(); iter != threadSet.end(); iter++) {
+        writeJsonSeparator(fp, &first);
+        fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{", iter->first, iter->second);
+        writeJsonField(fp, "name", m_getThreadName(iter->second));
+        fprintf(fp, "}}");
+    }
+
+    for (size_t i = 0; i < records->size(); i++) {
+        const camera_trace_record_t &record = records->at(i);
+
+        if (record.type == CAMERA_TRACE_EVENT_LOGGER) {
+            const char *category = m_getLoggerStr(m_categoryStr, m_categoryNum, record.logger_category);
+            const char *type = m_getLoggerStr(m_typeStr, m_typeNum, record.logger_type);
+
+            writeJsonSeparator(fp, &first);
+            fprintf(fp, "{");
+            writeJsonField(fp, "name", category);
+            fprintf(fp, ",\"cat\":\"logger\",\"pid\":%u,\"tid\":%u", record.camera_id, record.tid);
+            writeJsonTime(fp, "ts", record.start_ns);
+
+            if (record.end_ns > record.start_ns) {
+                /* DURATION */
+                fprintf(fp, ",\"ph\":\"X\"");
+                writeJsonTime(fp, "dur", record.end_ns - record.start_ns);
+            } else {
+                fprintf(fp, ",\"ph\":\"i\",\"s\":\"t\"");
+            }
+
+            fprintf(fp, ",\"args\":{");
+            writeJsonField(fp, "type", type);
+            fprintf(fp, ",\"key\":%llu,\"pipeId\":%u,\"value\":%llu}}",
+                    (unsigned long long)record.key, record.pipe_id, (unsigned long long)record.value);
+            continue;
+        }
+
+        const char *name = m_getPipeName(record.camera_id, record.pipe_id);
+        if (name == NULL) {
+            snprintf(pipeName, sizeof(pipeName), "PIPE_%u", record.pipe_id);
+            name = pipeName;
+        }
+
+        stage_key_t stageKey(std::make_pair(record.camera_id, record.pipe_id), record.key);
+        frame_key_t frameKey(record.camera_id, record.key);
+        bool isPush = (record.type == CAMERA_TRACE_EVENT_PIPE_PUSH);
+
+        snprintf(eventName, sizeof(eventName), "%s %s", isPush ? "push" : "done", name);
+
+        writeJsonSeparator(fp, &first);
+        fprintf(fp, "{");
+        writeJsonField(fp, "name", eventName);
+        fprintf(fp, ",\"cat\":\"pipe\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u", record.camera_id, record.tid);
+        writeJsonTime(fp, "ts", record.start_ns);
+        fprintf(fp, ",\"dur\":0,\"args\":{\"frame\":%llu}}", (unsigned long long)record.key);
+
+        uint32_t eventNum = frameEventNum[frameKey];
+        uint32_t eventIndex = frameEventIndex[frameKey]++;
+        if (eventNum > 1) {
+            const char *phase = (eventIndex == 0) ? "s" : ((eventIndex + 1 == eventNum) ? "f" : "t");
+
+            writeJsonSeparator(fp, &first);
+            fprintf(fp, "{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"%s\",\"id\":\"%u:%llu\",\"pid\":%u,\"tid\":%u",
+                    phase, record.camera_id, (unsigned long long)record.key, record.camera_id, record.tid);
+            writeJsonTime(fp, "ts", record.start_ns);
+            fprintf(fp, ",\"bp\":\"e\"}");
+        }
+
+        if (isPush) {
+            pushRecord[stageKey] = &record;
+            continue;
+        }
+
+        std::map<stage_key_t, const camera_trace_record_t *>::iterator iter = pushRecord.find(stageKey);
+        if (iter == pushRecord.end())
+            continue;
+
+        for (int phase = 0; phase < 2; phase++) {
+            const camera_trace_record_t *event = (phase == 0) ? iter->second : &record;
+
+            writeJsonSeparator(fp, &first);
+            fprintf(fp, "{");
+            writeJsonField(fp, "name", name);
+            fprintf(fp, ",\"cat\":\"stage\",\"ph\":\"%s\",\"id\":\"%u:%u:%llu\",\"pid\":%u,\"tid\":%u",
+                    (phase == 0) ? "b" : "e", record.camera_id, record.pipe_id,
+                    (unsigned long long)record.key, record.camera_id, event->tid);
+            writeJsonTime(fp, "ts", event->start_ns);
+            fprintf(fp, ",\"args\":{\"frame\":%llu}}", (unsigned long long)record.key);
+        }
+
+        pushRecord.erase(iter);
+    }
+
+    fprintf(fp, "\n]}\n");
+
+    return ferror(fp) ? INVALID_OPERATION : NO_ERROR;
+}
+
+status_t ExynosCameraTraceRecorder::m_exportBinary(FILE *fp, std::vector<camera_trace_record_t> *records, uint64_t droppedNum)
+{
+    camera_trace_file_header_t header;
+
+    memset(&header, 0x00, sizeof(header));
+    header.magic = CAMERA_TRACE_FILE_MAGIC;
+    header.version = CAMERA_TRACE_FILE_VERSION;
+    header.pipe_num = m_pipe.size();
+    header.record_num = records->size();
+    header.dropped_num = droppedNum;
+
+    if (fwrite(&header, sizeof(header), 1, fp) != 1)
+        return INVALID_OPERATION;
+
+    if (header.pipe_num != 0
+        && fwrite(m_pipe.data(), sizeof(camera_trace_pipe_t), header.pipe_num, fp) != header.pipe_num)
+        return INVALID_OPERATION;
+
+    if (header.record_num != 0
+        && fwrite(records->data(), sizeof(camera_trace_record_t), header.record_num, fp) != header.record_num)
+        return INVALID_OPERATION;
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraTraceRecorder::exportTrace(int format, const char *path)
+{
+    status_t ret = NO_ERROR;
+    std::vector<camera_trace_record_t> records;
+    uint64_t droppedNum = 0;
+    FILE *fp = NULL;
+
+    if (format != CAMERA_TRACE_FORMAT_CHROME_JSON && format != CAMERA_TRACE_FORMAT_BINARY) {
+        CLOGE2("unknown trace format(%d)", format);
+        return BAD_VALUE;
+    }
+
+    fp = fopen(path, (format == CAMERA_TRACE_FORMAT_BINARY) ? "wb" : "w");
+    if (fp == NULL) {
+        CLOGE2("can't open file(%s)", path);
+        return INVALID_OPERATION;
+    }
+
+    /* m_lock keeps m_ring and m_pipe still, the threads keep recording into their rings meanwhile */
+    {
+        Mutex::Autolock lock(m_lock);
+
+        m_snapshot(&records, &droppedNum);
+        if (droppedNum != 0)
+            CLOGD2("%llu records wrapped or had no ring", (unsigned long long)droppedNum);
+
+        if (format == CAMERA_TRACE_FORMAT_BINARY)
+            ret = m_exportBinary(fp, &records, droppedNum);
+        else
+            ret = m_exportChromeJson(fp, &records);
+    }
+
+    if (ret != NO_ERROR)
+        CLOGE2("fail to write %s", path);
+
+    fclose(fp);
+
+    return ret;
+}
+
+}; /* namespace android */
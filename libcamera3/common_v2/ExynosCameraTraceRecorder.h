@@ -0,0 +1,128 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraTraceRecorder.h
+ * \brief     header file for ExynosCameraTraceRecorder
+ */
+
+#ifndef EXYNOS_CAMERA_TRACE_RECORDER_H
+#define EXYNOS_CAMERA_TRACE_RECORDER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <utils/Errors.h>
+#include <utils/Mutex.h>
+
+#include "ExynosCameraCommonDefine.h"
+#include "ExynosCameraTraceFormat.h"
+
+#define TRACE_RECORDER_DEFAULT_RECORD_NUM   (2048)  /* per thread */
+#define TRACE_RECORDER_MAX_THREAD_NUM       (128)
+#define TRACE_RECORDER_MAX_PIPE_NUM         (512)
+#define TRACE_RECORDER_THREAD_NAME_SIZE     (16)
+
+namespace android {
+
+/*
+ * Records the pipe pushes and dones and the ExynosCameraTimeLogger updates of the camera threads.
+ * Each thread that records gets its own ring of records, so record() in the frame path never
+ * takes m_lock and never writes a cache line another thread writes. With tracing off, record()
+ * only tests m_enabled.
+ * exportTrace() merges the rings into a Chrome trace-event JSON, which Perfetto also loads,
+ * or into the binary file of ExynosCameraTraceFormat.h.
+ */
+class ExynosCameraTraceRecorder {
+public:
+    ExynosCameraTraceRecorder();
+    virtual ~ExynosCameraTraceRecorder();
+
+    status_t        setEnable(bool enable);
+    bool            isEnabled(void)
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /* records per thread, a power of two at least recordNum; INVALID_OPERATION once a thread has a ring */
+    status_t        setCapacity(uint32_t recordNum);
+    uint32_t        getCapacity(void);
+    /* the number of rings, a ring is shared in turn by threads that don't live at the same time */
+    uint32_t        getThreadCount(void);
+
+    void            setPipeName(int cameraId, uint32_t pipeId, const char *name);
+    /* the names of LOGGER_TYPE and LOGGER_CATEGORY, the arrays are kept by the caller */
+    void            setLoggerName(char **typeStr, uint32_t typeNum, char **categoryStr, uint32_t categoryNum);
+
+    void            record(enum camera_trace_event_type type, int cameraId, uint32_t pipeId, uint64_t key,
+                           uint64_t startNs, uint64_t endNs,
+                           uint64_t value = 0, uint32_t loggerType = 0, uint32_t loggerCategory = 0);
+
+    /* enum camera_trace_format */
+    status_t        exportTrace(int format, const char *path);
+
+private:
+    typedef struct trace_slot {
+        /* 0 while the owner thread fills the record, then its writePos + 1 for exportTrace() to check */
+        std::atomic<uint64_t>   sequence;
+        camera_trace_record_t   record;
+    } trace_slot_t;
+
+    typedef struct trace_ring {
+        uint32_t                tid;
+        /* cleared when the thread of the ring exits, the next new thread takes the ring */
+        std::atomic<bool>       owned;
+        /* written only by the thread of the ring */
+        std::atomic<uint64_t>   writePos;
+        trace_slot_t            *slot;
+    } trace_ring_t;
+
+    trace_ring_t    *m_getRing(void);
+    uint32_t        m_snapshot(std::vector<camera_trace_record_t> *records, uint64_t *droppedNum);
+    const char      *m_getPipeName(uint32_t cameraId, uint32_t pipeId);
+    const char      *m_getThreadName(uint32_t tid);
+    const char      *m_getLoggerStr(char **str, uint32_t num, uint32_t index);
+    status_t        m_exportChromeJson(FILE *fp, std::vector<camera_trace_record_t> *records);
+    status_t        m_exportBinary(FILE *fp, std::vector<camera_trace_record_t> *records, uint64_t droppedNum);
+
+private:
+    /* tells the cached ring of a thread from the one of another recorder */
+    uint32_t                    m_id;
+
+    std::atomic<bool>           m_enabled;
+    uint32_t                    m_capacity;
+
+    /* rings are made at the first record of a thread when no ring is free, and kept until the recorder is destroyed */
+    Mutex                       m_lock;
+    std::vector<trace_ring_t *> m_ring;
+    /* records of the threads over TRACE_RECORDER_MAX_THREAD_NUM living at the same time */
+    std::atomic<uint64_t>       m_lostNum;
+    /* names of every thread that recorded, the records of an exited thread stay in the ring it left */
+    std::map<uint32_t, std::string> m_threadName;
+
+    std::vector<camera_trace_pipe_t> m_pipe;
+    char                        **m_typeStr;
+    uint32_t                    m_typeNum;
+    char                        **m_categoryStr;
+    uint32_t                    m_categoryNum;
+};
+
+}; /* namespace android */
+#endif
@@ -696,6 +696,7 @@ status_t ExynosCameraMCPipe::pushFrame(ExynosCameraFrameSP_dptr_t newFrame)
         return BAD_VALUE;
     }
 
+    TIME_LOGGER_TRACE(m_cameraId, newFrame->getFrameCount(), getPipeId(), PIPE_PUSH);
     m_inputFrameQ->pushProcessQ(&newFrame);
 
     return NO_ERROR;
@@ -911,6 +912,7 @@ status_t ExynosCameraMCPipe::setPipeName(const char *pipeName)
     CLOGD("");
 
     strncpy(m_name,  pipeName, (EXYNOS_CAMERA_NAME_STR_SIZE - 1));
+    TIME_LOGGER_TRACE_PIPE_NAME(m_cameraId, getPipeId(), m_name);
 
     return NO_ERROR;
 }
@@ -529,6 +529,7 @@ status_t ExynosCameraPipe::pushFrame(ExynosCameraFrameSP_dptr_t newFrame)
         return BAD_VALUE;
     }
 
+    TIME_LOGGER_TRACE(m_cameraId, newFrame->getFrameCount(), getPipeId(), PIPE_PUSH);
     m_inputFrameQ->pushProcessQ(&newFrame);
 
     return NO_ERROR;
@@ -669,6 +670,7 @@ status_t ExynosCameraPipe::getPrevPipeID(void)
 status_t ExynosCameraPipe::setPipeName(const char *pipeName)
 {
     strncpy(m_name,  pipeName,  EXYNOS_CAMERA_NAME_STR_SIZE - 1);
+    TIME_LOGGER_TRACE_PIPE_NAME(m_cameraId, getPipeId(), m_name);
 
     return NO_ERROR;
 }
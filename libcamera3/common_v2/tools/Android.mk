@@ -0,0 +1,15 @@
+# Copyright 2017 The Android Open Source Project
+
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    camera_trace_summary.cpp
+
+LOCAL_MODULE := camera_trace_summary
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/..
+
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,250 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * camera_trace_summary
+ *
+ * Summarizes a binary trace of ExynosCameraTimeLogger::saveTrace().
+ * For each camera it prints the latency of each stage and of the frames.
+ *
+ * A stage is a push of a frame into a pipe and the next FRAME_DONE of the pipe
+ * for the frame, so it includes the wait in the input queue of the pipe.
+ * The latency of a frame is from its first push to its last done.
+ *
+ * camera_trace_summary <trace file> [--camera N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ExynosCameraTraceFormat.h"
+
+using namespace std;
+
+struct duration_stat {
+    vector<uint64_t> values;
+    uint64_t sum;
+
+    duration_stat() : sum(0) {}
+
+    void add(uint64_t value)
+    {
+        values.push_back(value);
+        sum += value;
+    }
+
+    double avgMs(void) const
+    {
+        return values.empty() ? 0.0 : (double)sum / values.size() / 1000000.0;
+    }
+
+    /* nearest rank */
+    double percentileMs(double percent)
+    {
+        if (values.empty())
+            return 0.0;
+
+        sort(values.begin(), values.end());
+        size_t rank = (size_t)(percent / 100.0 * values.size() + 0.5);
+        rank = (rank == 0) ? 0 : min(rank - 1, values.size() - 1);
+
+        return values[rank] / 1000000.0;
+    }
+};
+
+struct trace_dump {
+    camera_trace_file_header_t header;
+    /* camera id, pipe id */
+    map<pair<uint32_t, uint32_t>, string> pipes;
+    vector<camera_trace_record_t> records;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s <trace file> [--camera N]\n"
+            "  <trace file>  exynos_camera_trace_cam*.bin written by ExynosCameraTimeLogger\n"
+            "  --camera      prints only the camera N\n",
+            prog);
+}
+
+static bool readDump(const char *path, trace_dump *dump)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    bool ret = false;
+    camera_trace_pipe_t pipe;
+
+    if (fread(&dump->header, sizeof(dump->header), 1, fp) != 1) {
+        fprintf(stderr, "%s is too short\n", path);
+        goto EXIT;
+    }
+
+    if ((dump->header.magic != CAMERA_TRACE_FILE_MAGIC) || (dump->header.version != CAMERA_TRACE_FILE_VERSION)) {
+        fprintf(stderr, "%s isn't a trace of version %d\n", path, CAMERA_TRACE_FILE_VERSION);
+        goto EXIT;
+    }
+
+    for (uint32_t i = 0; i < dump->header.pipe_num; i++) {
+        if (fread(&pipe, sizeof(pipe), 1, fp) != 1) {
+            fprintf(stderr, "pipe %u of %s is truncated\n", i, path);
+            goto EXIT;
+        }
+        pipe.name[CAMERA_TRACE_PIPE_NAME_SIZE - 1] = '\0';
+        dump->pipes[make_pair(pipe.camera_id, pipe.pipe_id)] = pipe.name;
+    }
+
+    dump->records.resize(dump->header.record_num);
+    if ((dump->header.record_num) &&
+        (fread(&dump->records[0], sizeof(camera_trace_record_t), dump->header.record_num, fp) != dump->header.record_num)) {
+        fprintf(stderr, "records of %s are truncated\n", path);
+        goto EXIT;
+    }
+
+    ret = true;
+
+EXIT:
+    fclose(fp);
+    return ret;
+}
+
+static string getPipeName(trace_dump *dump, uint32_t camera_id, uint32_t pipe_id)
+{
+    map<pair<uint32_t, uint32_t>, string>::iterator iter = dump->pipes.find(make_pair(camera_id, pipe_id));
+    if (iter != dump->pipes.end())
+        return iter->second;
+
+    char name[CAMERA_TRACE_PIPE_NAME_SIZE];
+    snprintf(name, sizeof(name), "PIPE_%u", pipe_id);
+
+    return name;
+}
+
+static void summarizeCamera(trace_dump *dump, uint32_t camera_id)
+{
+    /* pipe id, frame count */
+    map<pair<uint32_t, uint64_t>, uint64_t> push_ns;
+    map<uint32_t, duration_stat> stage_stat;
+    map<uint32_t, uint32_t> unfinished_cnt;
+    /* frame count, first push and last done */
+    map<uint64_t, pair<uint64_t, uint64_t> > frame_ns;
+    duration_stat frame_stat;
+
+    /* the records are in time order */
+    for (size_t i = 0; i < dump->records.size(); i++) {
+        const camera_trace_record_t *record = &dump->records[i];
+
+        if (record->camera_id != camera_id)
+            continue;
+
+        pair<uint32_t, uint64_t> stage_key = make_pair(record->pipe_id, record->key);
+
+        switch (record->type) {
+        case CAMERA_TRACE_EVENT_PIPE_PUSH:
+            push_ns[stage_key] = record->start_ns;
+            if (frame_ns.count(record->key) == 0)
+                frame_ns[record->key] = make_pair(record->start_ns, 0);
+            break;
+        case CAMERA_TRACE_EVENT_PIPE_DONE:
+            if (push_ns.count(stage_key)) {
+                stage_stat[record->pipe_id].add(record->start_ns - push_ns[stage_key]);
+                push_ns.erase(stage_key);
+            }
+            if (frame_ns.count(record->key))
+                frame_ns[record->key].second = record->start_ns;
+            break;
+        default:
+            break;
+        }
+    }
+
+    map<pair<uint32_t, uint64_t>, uint64_t>::iterator push_iter;
+    for (push_iter = push_ns.begin(); push_iter != push_ns.end(); push_iter++)
+        unfinished_cnt[push_iter->first.first]++;
+
+    map<uint64_t, pair<uint64_t, uint64_t> >::iterator frame_iter;
+    for (frame_iter = frame_ns.begin(); frame_iter != frame_ns.end(); frame_iter++) {
+        if (frame_iter->second.second > frame_iter->second.first)
+            frame_stat.add(frame_iter->second.second - frame_iter->second.first);
+    }
+
+    printf("camera %u\n", camera_id);
+    printf("  frames: %zu, latency avg %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           frame_stat.values.size(), frame_stat.avgMs(), frame_stat.percentileMs(50),
+           frame_stat.percentileMs(90), frame_stat.percentileMs(99), frame_stat.percentileMs(100));
+
+    printf("  %-32s %8s %10s %10s %10s %10s %10s %10s\n",
+           "stage", "frames", "avg ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "no done");
+    map<uint32_t, duration_stat>::iterator stat_iter;
+    for (stat_iter = stage_stat.begin(); stat_iter != stage_stat.end(); stat_iter++) {
+        duration_stat &stat = stat_iter->second;
+
+        printf("  %-32s %8zu %10.3f %10.3f %10.3f %10.3f %10.3f %10u\n",
+               getPipeName(dump, camera_id, stat_iter->first).c_str(), stat.values.size(), stat.avgMs(),
+               stat.percentileMs(50), stat.percentileMs(90), stat.percentileMs(99), stat.percentileMs(100),
+               unfinished_cnt[stat_iter->first]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int camera_id = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--camera") == 0) && (i + 1 < argc)) {
+            camera_id = atoi(argv[++i]);
+        } else if ((argv[i][0] != '-') && (path == NULL)) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (path == NULL) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    trace_dump dump;
+    if (!readDump(path, &dump))
+        return 1;
+
+    printf("%u records, %llu dropped\n", dump.header.record_num, (unsigned long long)dump.header.dropped_num);
+
+    map<uint32_t, bool> cameras;
+    for (size_t i = 0; i < dump.records.size(); i++)
+        cameras[dump.records[i].camera_id] = true;
+
+    map<uint32_t, bool>::iterator iter;
+    for (iter = cameras.begin(); iter != cameras.end(); iter++) {
+        if ((camera_id < 0) || ((uint32_t)camera_id == iter->first))
+            summarizeCamera(&dump, iter->first);
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+# Copyright 2017 The Android Open Source Project
+
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ../ExynosCameraFramePool.cpp \
+    ExynosCameraFramePoolTest.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_framepool_test
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ../ExynosCameraFramePool.cpp \
+    ExynosCameraFramePoolBenchmark.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_framepool_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_BENCHMARK)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraListTest.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_list_test
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraListBenchmark.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_list_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_BENCHMARK)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraBufferIndexTest.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_bufferindex_test
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2/Buffers
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraBufferIndexBenchmark.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_bufferindex_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2/Buffers
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_BENCHMARK)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ../ExynosCameraTraceRecorder.cpp \
+    ExynosCameraTraceRecorderTest.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_tracerecorder_test
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ../ExynosCameraTraceRecorder.cpp \
+    ExynosCameraTraceRecorderBenchmark.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := libexynoscamera_tracerecorder_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(BUILD_HOST_NATIVE_BENCHMARK)
@@ -0,0 +1,194 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Stress of the getBuffer/putBuffer/getIndexByFd bookkeeping of ExynosCameraBufferManager,
+ * with the List walked as before and with the index queue and the fd index.
+ * Arg is the number of buffers, the threads share one manager like the pipes do.
+ * A thread puts its buffers back in a random order and looks up a buffer by fd for each of them.
+ */
+
+#include <mutex>
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <utils/List.h>
+
+#include "ExynosCameraBufferIndex.h"
+
+namespace android {
+
+#define BENCH_FD_BASE       (100)
+#define BENCH_IN_FLIGHT     (4)
+
+class ListBufferManager {
+public:
+    void reset(int count)
+    {
+        m_count = count;
+        m_queue.clear();
+        for (int i = 0; i < count; i++)
+            m_queue.push_back(i);
+    }
+
+    int getBuffer(void)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        int index = -1;
+
+        if (m_queue.empty() == false) {
+            List<int>::iterator r = m_queue.begin();
+            index = *r;
+            m_queue.erase(r);
+        }
+
+        return index;
+    }
+
+    void putBuffer(int index)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        for (List<int>::iterator r = m_queue.begin(); r != m_queue.end(); r++) {
+            if (*r == index)
+                return;
+        }
+
+        m_queue.push_back(index);
+    }
+
+    int getIndexByFd(int fd)
+    {
+        for (int i = 0; i < m_count; i++) {
+            if (BENCH_FD_BASE + i == fd)
+                return i;
+        }
+
+        return -1;
+    }
+
+private:
+    std::mutex      m_lock;
+    List<int>       m_queue;
+    int             m_count;
+};
+
+class IndexBufferManager {
+public:
+    void reset(int count)
+    {
+        m_count = count;
+        m_queue.clear();
+        m_fdIndex.clear();
+        for (int i = 0; i < count; i++)
+            m_queue.push_back(i);
+    }
+
+    int getBuffer(void)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        int index = -1;
+
+        m_queue.pop_front(&index);
+
+        return index;
+    }
+
+    void putBuffer(int index)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (m_queue.has(index) == true)
+            return;
+
+        m_queue.push_back(index);
+    }
+
+    int getIndexByFd(int fd)
+    {
+        std::lock_guard<std::mutex> lock(m_fdIndexLock);
+        int index = m_fdIndex.find(fd);
+
+        if (0 <= index && index < m_count && BENCH_FD_BASE + index == fd)
+            return index;
+
+        for (index = 0; index < m_count; index++) {
+            if (BENCH_FD_BASE + index == fd) {
+                m_fdIndex.set(fd, index);
+                return index;
+            }
+        }
+
+        return -1;
+    }
+
+private:
+    std::mutex                  m_lock;
+    std::mutex                  m_fdIndexLock;
+    ExynosCameraBufferIndexQ    m_queue;
+    ExynosCameraBufferFdIndex   m_fdIndex;
+    int                         m_count;
+};
+
+template<typename MANAGER>
+static void runStress(benchmark::State &state)
+{
+    static MANAGER manager;
+    std::mt19937 random(state.thread_index());
+    int buffers[BENCH_IN_FLIGHT];
+    int64_t count = 0;
+
+    if (state.thread_index() == 0)
+        manager.reset(state.range(0));
+
+    for (auto _ : state) {
+        int numOfBuffer = 0;
+
+        for (int i = 0; i < BENCH_IN_FLIGHT; i++) {
+            buffers[numOfBuffer] = manager.getBuffer();
+            if (buffers[numOfBuffer] >= 0)
+                numOfBuffer++;
+        }
+
+        std::shuffle(buffers, buffers + numOfBuffer, random);
+
+        for (int i = 0; i < numOfBuffer; i++) {
+            benchmark::DoNotOptimize(manager.getIndexByFd(BENCH_FD_BASE + buffers[i]));
+            manager.putBuffer(buffers[i]);
+        }
+
+        count += numOfBuffer;
+    }
+
+    state.SetItemsProcessed(count);
+}
+
+static void BM_ListBufferManager(benchmark::State &state)
+{
+    runStress<ListBufferManager>(state);
+}
+BENCHMARK(BM_ListBufferManager)->Arg(8)->Arg(32)->Arg(80)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_IndexBufferManager(benchmark::State &state)
+{
+    runStress<IndexBufferManager>(state);
+}
+BENCHMARK(BM_IndexBufferManager)->Arg(8)->Arg(32)->Arg(80)->Threads(1)->Threads(4)->UseRealTime();
+
+}; /* namespace android */
+
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraBufferIndex.h"
+
+namespace android {
+
+TEST(ExynosCameraBufferIndexQTest, KeepsOrder)
+{
+    ExynosCameraBufferIndexQ queue;
+    int index;
+
+    for (int i = 0; i < 8; i++)
+        EXPECT_TRUE(queue.push_back(i));
+
+    EXPECT_TRUE(queue.erase(3));
+    EXPECT_TRUE(queue.erase(0));
+    EXPECT_TRUE(queue.erase(7));
+    EXPECT_FALSE(queue.erase(3));
+    EXPECT_EQ(5, queue.size());
+
+    const int expected[] = {1, 2, 4, 5, 6};
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(queue.pop_front(&index));
+        EXPECT_EQ(expected[i], index);
+    }
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop_front(&index));
+}
+
+TEST(ExynosCameraBufferIndexQTest, RejectsDuplicateAndOutOfBound)
+{
+    ExynosCameraBufferIndexQ queue;
+
+    EXPECT_TRUE(queue.push_back(5));
+    EXPECT_FALSE(queue.push_back(5));
+    EXPECT_FALSE(queue.push_back(-1));
+    EXPECT_FALSE(queue.push_back(BUFFER_INDEX_MAX_COUNT));
+    EXPECT_FALSE(queue.has(BUFFER_INDEX_MAX_COUNT));
+    EXPECT_EQ(1, queue.size());
+
+    queue.clear();
+    EXPECT_FALSE(queue.has(5));
+    EXPECT_EQ(-1, queue.front());
+}
+
+/* random operations against a deque walked like the list was */
+TEST(ExynosCameraBufferIndexQTest, MatchesList)
+{
+    ExynosCameraBufferIndexQ queue;
+    std::deque<int> list;
+    std::mt19937 random(1234);
+    int index;
+
+    for (int n = 0; n < 100000; n++) {
+        int value = random() % 80;
+        std::deque<int>::iterator r = std::find(list.begin(), list.end(), value);
+
+        switch (random() % 3) {
+        case 0:
+            EXPECT_EQ(r == list.end(), queue.push_back(value));
+            if (r == list.end())
+                list.push_back(value);
+            break;
+        case 1:
+            EXPECT_EQ(r != list.end(), queue.erase(value));
+            if (r != list.end())
+                list.erase(r);
+            break;
+        default:
+            EXPECT_EQ(list.empty() == false, queue.pop_front(&index));
+            if (list.empty() == false) {
+                EXPECT_EQ(list.front(), index);
+                list.pop_front();
+            }
+            break;
+        }
+
+        ASSERT_EQ((int)list.size(), queue.size());
+    }
+
+    index = queue.front();
+    for (size_t i = 0; i < list.size(); i++) {
+        ASSERT_EQ(list[i], index);
+        index = queue.next(index);
+    }
+    EXPECT_EQ(-1, index);
+}
+
+TEST(ExynosCameraBufferFdIndexTest, FollowsNewFd)
+{
+    ExynosCameraBufferFdIndex fdIndex;
+
+    EXPECT_EQ(-1, fdIndex.find(10));
+
+    fdIndex.set(10, 0);
+    fdIndex.set(11, 1);
+    EXPECT_EQ(0, fdIndex.find(10));
+    EXPECT_EQ(1, fdIndex.find(11));
+
+    /* the buffer got a new fd, the old one is dropped */
+    fdIndex.set(20, 0);
+    EXPECT_EQ(-1, fdIndex.find(10));
+    EXPECT_EQ(0, fdIndex.find(20));
+
+    /* the fd moved to another buffer */
+    fdIndex.set(11, 2);
+    EXPECT_EQ(2, fdIndex.find(11));
+    fdIndex.set(30, 2);
+    EXPECT_EQ(-1, fdIndex.find(11));
+
+    fdIndex.clear();
+    EXPECT_EQ(-1, fdIndex.find(20));
+}
+
+/* fds change like service buffers, entries collide and get erased in the table */
+TEST(ExynosCameraBufferFdIndexTest, MatchesMap)
+{
+    ExynosCameraBufferFdIndex fdIndex;
+    std::map<int, int> fdOfIndex;
+    std::mt19937 random(5678);
+
+    for (int n = 0; n < 100000; n++) {
+        int index = random() % BUFFER_INDEX_MAX_COUNT;
+        int fd = random() % 1024;
+
+        for (std::map<int, int>::iterator r = fdOfIndex.begin(); r != fdOfIndex.end(); r++) {
+            if (r->second == fd) {
+                fdOfIndex.erase(r);
+                break;
+            }
+        }
+        fdOfIndex[index] = fd;
+        fdIndex.set(fd, index);
+
+        if (n % 64 == 0) {
+            for (std::map<int, int>::iterator r = fdOfIndex.begin(); r != fdOfIndex.end(); r++)
+                ASSERT_EQ(r->first, fdIndex.find(r->second)) << "fd " << r->second;
+        }
+    }
+}
+
+}; /* namespace android */
@@ -0,0 +1,125 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef EXYNOS_CAMERA_FAKE_FRAME_H
+#define EXYNOS_CAMERA_FAKE_FRAME_H
+
+#include <string.h>
+
+#include <atomic>
+#include <list>
+
+#include <log/log.h>
+#include <utils/RefBase.h>
+
+#include "ExynosCameraFramePool.h"
+
+namespace android {
+
+#define FAKE_FRAME_META_SIZE (64 * 1024)
+
+/*
+ * Stands for ExynosCameraFrame on the host, which needs the whole HAL to build.
+ * It allocates like ExynosCameraFrame: a big inline metadata area, an entity list
+ * that is filled while running and the same operator new and delete.
+ */
+class ExynosCameraFakeFrame : public RefBase {
+public:
+    ExynosCameraFakeFrame(int cameraId)
+    {
+        m_cameraId = cameraId;
+        m_frameCount = 0;
+        m_uniqueKey = 0;
+        m_frameState = 0;
+        memset(m_metaData, 0x0, sizeof(m_metaData));
+        constructCount++;
+    }
+
+    virtual ~ExynosCameraFakeFrame()
+    {
+        m_entityList.clear();
+        destructCount++;
+    }
+
+    static void *operator new(size_t size)
+    {
+        void *ptr = ExynosCameraFramePool::allocHeap(size);
+
+        LOG_ALWAYS_FATAL_IF(ptr == NULL, "ExynosCameraFakeFrame: allocation of %zu bytes failed", size);
+
+        return ptr;
+    }
+
+    static void *operator new(size_t size, ExynosCameraFramePool *pool)
+    {
+        void *ptr;
+
+        if (pool == NULL)
+            ptr = ExynosCameraFramePool::allocHeap(size);
+        else
+            ptr = pool->alloc(size);
+
+        LOG_ALWAYS_FATAL_IF(ptr == NULL, "ExynosCameraFakeFrame: allocation of %zu bytes failed", size);
+
+        return ptr;
+    }
+
+    static void operator delete(void *ptr)
+    {
+        ExynosCameraFramePool::release(ptr);
+    }
+
+    static void operator delete(void *ptr, __attribute__((unused)) ExynosCameraFramePool *pool)
+    {
+        ExynosCameraFramePool::release(ptr);
+    }
+
+    /* what a running frame leaves behind */
+    void run(uint32_t frameCount)
+    {
+        m_frameCount = frameCount;
+        m_uniqueKey = frameCount + 1000;
+        m_frameState = 3;
+        memset(m_metaData, 0x5a, sizeof(m_metaData));
+        for (int i = 0; i < 8; i++)
+            m_entityList.push_back(i);
+    }
+
+    bool isSameState(const ExynosCameraFakeFrame *other) const
+    {
+        return (m_cameraId == other->m_cameraId)
+            && (m_frameCount == other->m_frameCount)
+            && (m_uniqueKey == other->m_uniqueKey)
+            && (m_frameState == other->m_frameState)
+            && (m_entityList == other->m_entityList)
+            && (memcmp(m_metaData, other->m_metaData, sizeof(m_metaData)) == 0);
+    }
+
+    static std::atomic<int> constructCount;
+    static std::atomic<int> destructCount;
+
+private:
+    int             m_cameraId;
+    uint32_t        m_frameCount;
+    uint32_t        m_uniqueKey;
+    int             m_frameState;
+    std::list<int>  m_entityList;
+    unsigned char   m_metaData[FAKE_FRAME_META_SIZE];
+};
+
+}; /* namespace android */
+#endif
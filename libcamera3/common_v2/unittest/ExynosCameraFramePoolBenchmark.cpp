@@ -0,0 +1,67 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Frames per second that can be created and released, from the heap as CreateWorker did
+ * and from the frame pool. Arg is the number of frames running at the same time.
+ * Both of them clear the metadata in the constructor like ExynosCameraFrame::m_init.
+ */
+
+#include <deque>
+
+#include <benchmark/benchmark.h>
+
+#include "ExynosCameraFakeFrame.h"
+
+namespace android {
+
+std::atomic<int> ExynosCameraFakeFrame::constructCount(0);
+std::atomic<int> ExynosCameraFakeFrame::destructCount(0);
+
+static void runFrames(benchmark::State &state, ExynosCameraFramePool *pool)
+{
+    std::deque<sp<ExynosCameraFakeFrame> > running;
+    uint32_t frameCount = 0;
+
+    for (auto _ : state) {
+        running.push_back(new (pool) ExynosCameraFakeFrame(frameCount++));
+
+        if (running.size() > (size_t)state.range(0))
+            running.pop_front();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_HeapFrame(benchmark::State &state)
+{
+    runFrames(state, NULL);
+}
+BENCHMARK(BM_HeapFrame)->Arg(8)->Arg(64);
+
+static void BM_PoolFrame(benchmark::State &state)
+{
+    sp<ExynosCameraFramePool> pool = new ExynosCameraFramePool("FRAME POOL BENCHMARK", 0, sizeof(ExynosCameraFakeFrame));
+    pool->setCount(state.range(0) * 2);
+
+    runFrames(state, pool.get());
+}
+BENCHMARK(BM_PoolFrame)->Arg(8)->Arg(64);
+
+}; /* namespace android */
+
+BENCHMARK_MAIN();
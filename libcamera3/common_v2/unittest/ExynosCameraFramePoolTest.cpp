@@ -0,0 +1,162 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraFakeFrame.h"
+
+namespace android {
+
+std::atomic<int> ExynosCameraFakeFrame::constructCount(0);
+std::atomic<int> ExynosCameraFakeFrame::destructCount(0);
+
+class ExynosCameraFramePoolTest : public ::testing::Test {
+protected:
+    sp<ExynosCameraFramePool> m_pool;
+
+    virtual void SetUp()
+    {
+        m_pool = new ExynosCameraFramePool("FRAME POOL TEST", 0, sizeof(ExynosCameraFakeFrame));
+        ExynosCameraFakeFrame::constructCount = 0;
+        ExynosCameraFakeFrame::destructCount = 0;
+    }
+
+    virtual void TearDown()
+    {
+        m_pool = NULL;
+    }
+};
+
+TEST_F(ExynosCameraFramePoolTest, ReusesReleasedBlock)
+{
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(2));
+
+    sp<ExynosCameraFakeFrame> frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    ExynosCameraFakeFrame *first = frame.get();
+    EXPECT_EQ(1, m_pool->getFreeCount());
+
+    frame = NULL;
+    EXPECT_EQ(2, m_pool->getFreeCount());
+    EXPECT_EQ(1, ExynosCameraFakeFrame::destructCount);
+
+    frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    EXPECT_EQ(first, frame.get());
+}
+
+TEST_F(ExynosCameraFramePoolTest, RecycledFrameIsSameAsFresh)
+{
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(1));
+
+    sp<ExynosCameraFakeFrame> frame = new (m_pool.get()) ExynosCameraFakeFrame(1);
+    frame->run(30);
+    frame = NULL;
+
+    sp<ExynosCameraFakeFrame> recycled = new (m_pool.get()) ExynosCameraFakeFrame(1);
+    sp<ExynosCameraFakeFrame> fresh = new ExynosCameraFakeFrame(1);
+    EXPECT_EQ(0, m_pool->getFreeCount());
+    EXPECT_TRUE(recycled->isSameState(fresh.get()));
+
+    /* and both of them run the same way */
+    recycled->run(31);
+    fresh->run(31);
+    EXPECT_TRUE(recycled->isSameState(fresh.get()));
+}
+
+TEST_F(ExynosCameraFramePoolTest, FallsBackToHeapWhenUsedUp)
+{
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(2));
+
+    sp<ExynosCameraFakeFrame> frames[3];
+    for (int i = 0; i < 3; i++)
+        frames[i] = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    EXPECT_EQ(0, m_pool->getFreeCount());
+
+    for (int i = 0; i < 3; i++)
+        frames[i] = NULL;
+    EXPECT_EQ(2, m_pool->getFreeCount());
+    EXPECT_EQ(3, ExynosCameraFakeFrame::destructCount);
+}
+
+TEST_F(ExynosCameraFramePoolTest, KeepsCountWhileBlocksAreInUse)
+{
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(2));
+
+    sp<ExynosCameraFakeFrame> frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    EXPECT_EQ(INVALID_OPERATION, m_pool->setCount(4));
+    EXPECT_EQ(2, m_pool->getCount());
+
+    frame = NULL;
+    EXPECT_EQ(NO_ERROR, m_pool->setCount(4));
+    EXPECT_EQ(4, m_pool->getFreeCount());
+
+    EXPECT_EQ(BAD_VALUE, m_pool->setCount(-1));
+    EXPECT_EQ(BAD_VALUE, m_pool->setCount(FRAME_POOL_COUNT_MAX + 1));
+    EXPECT_EQ(NO_ERROR, m_pool->setCount(0));
+
+    /* no slab, every frame comes from the heap */
+    frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    EXPECT_TRUE(frame != NULL);
+}
+
+TEST_F(ExynosCameraFramePoolTest, FrameOutlivesWorker)
+{
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(2));
+
+    sp<ExynosCameraFakeFrame> frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+    ExynosCameraFramePool *pool = m_pool.get();
+    EXPECT_EQ(2, pool->getStrongCount());
+
+    /* the worker is gone, the running frame keeps the slab */
+    m_pool = NULL;
+    EXPECT_EQ(1, pool->getStrongCount());
+    EXPECT_EQ(1, pool->getFreeCount());
+
+    /* the pool goes with the frame, a sanitizer build catches a leak or a use after free */
+    frame->run(1);
+    frame = NULL;
+    EXPECT_EQ(1, ExynosCameraFakeFrame::destructCount);
+}
+
+TEST_F(ExynosCameraFramePoolTest, ReleasesFromManyThreads)
+{
+    const int threadCount = 4;
+    const int frameCount = 2000;
+
+    ASSERT_EQ(NO_ERROR, m_pool->setCount(16));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([this, frameCount]() {
+            for (int i = 0; i < frameCount; i++) {
+                sp<ExynosCameraFakeFrame> frame = new (m_pool.get()) ExynosCameraFakeFrame(0);
+                frame->run(i);
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    EXPECT_EQ(16, m_pool->getFreeCount());
+    EXPECT_EQ(threadCount * frameCount, ExynosCameraFakeFrame::constructCount);
+    EXPECT_EQ(threadCount * frameCount, ExynosCameraFakeFrame::destructCount);
+}
+
+}; /* namespace android */
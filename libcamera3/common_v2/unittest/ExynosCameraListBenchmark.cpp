@@ -0,0 +1,99 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Latency of a frame through a chain of queues, like the pipes pass a frame to the next one.
+ * A thread per hop waits on its queue and pushes to the next, the list and the ring are compared.
+ * Arg is the number of hops, the counters are the latency of a hop in ns.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <log/log.h>
+
+#include "ExynosCameraList.h"
+
+namespace android {
+
+typedef ExynosCameraList<nsecs_t> bench_queue_t;
+
+static void runChain(benchmark::State &state, uint32_t ringSize)
+{
+    int numOfHop = state.range(0);
+    std::vector<bench_queue_t *> queues;
+    std::vector<std::thread> threads;
+    std::vector<nsecs_t> latency;
+    std::atomic<bool> exit(false);
+
+    for (int i = 0; i <= numOfHop; i++) {
+        queues.push_back(new bench_queue_t());
+        queues[i]->setRingSize(ringSize);
+    }
+
+    for (int i = 0; i < numOfHop; i++) {
+        threads.push_back(std::thread([&, i]() {
+            nsecs_t item;
+            while (exit.load() == false) {
+                if (queues[i]->waitAndPopProcessQ(&item) == OK)
+                    queues[i + 1]->pushProcessQ(&item);
+            }
+        }));
+    }
+
+    for (auto _ : state) {
+        nsecs_t item = systemTime(SYSTEM_TIME_MONOTONIC);
+
+        queues[0]->pushProcessQ(&item);
+        while (queues[numOfHop]->waitAndPopProcessQ(&item) != OK)
+            ;
+
+        latency.push_back((systemTime(SYSTEM_TIME_MONOTONIC) - item) / numOfHop);
+    }
+
+    exit.store(true);
+    for (int i = 0; i < numOfHop; i++) {
+        queues[i]->wakeupAll();
+        threads[i].join();
+    }
+
+    for (int i = 0; i <= numOfHop; i++)
+        delete queues[i];
+
+    std::sort(latency.begin(), latency.end());
+    state.counters["p50_ns"] = latency[latency.size() / 2];
+    state.counters["p99_ns"] = latency[latency.size() * 99 / 100];
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ListChain(benchmark::State &state)
+{
+    runChain(state, 0);
+}
+BENCHMARK(BM_ListChain)->Arg(1)->Arg(4)->UseRealTime();
+
+static void BM_RingChain(benchmark::State &state)
+{
+    runChain(state, 64);
+}
+BENCHMARK(BM_RingChain)->Arg(1)->Arg(4)->UseRealTime();
+
+}; /* namespace android */
+
+BENCHMARK_MAIN();
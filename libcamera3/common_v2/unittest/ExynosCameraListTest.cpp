@@ -0,0 +1,243 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "ExynosCameraList.h"
+
+namespace android {
+
+#define LIST_TEST_WAIT_TIME (20 * 1000000)
+
+class ExynosCameraListItem : public virtual RefBase {
+public:
+    ExynosCameraListItem(uint32_t key) { this->key = key; }
+    uint32_t key;
+};
+
+/* the same cases run on the list and on the ring */
+class ExynosCameraListTest : public ::testing::TestWithParam<uint32_t> {
+protected:
+    virtual void SetUp()
+    {
+        m_queue = new ExynosCameraList<uint32_t>();
+        ASSERT_EQ(NO_ERROR, m_queue->setRingSize(GetParam()));
+        m_queue->setWaitTime(LIST_TEST_WAIT_TIME);
+    }
+
+    virtual void TearDown()
+    {
+        delete m_queue;
+    }
+
+    ExynosCameraList<uint32_t> *m_queue;
+};
+
+TEST_P(ExynosCameraListTest, KeepsOrder)
+{
+    uint32_t item;
+
+    /* more than the ring, the rest goes through the list */
+    for (uint32_t i = 0; i < 40; i++)
+        m_queue->pushProcessQ(&i);
+
+    EXPECT_EQ(40, m_queue->getSizeOfProcessQ());
+
+    for (uint32_t i = 0; i < 20; i++) {
+        ASSERT_EQ(OK, m_queue->popProcessQ(&item));
+        EXPECT_EQ(i, item);
+    }
+
+    for (uint32_t i = 40; i < 50; i++)
+        m_queue->pushProcessQ(&i);
+
+    for (uint32_t i = 20; i < 50; i++) {
+        ASSERT_EQ(OK, m_queue->waitAndPopProcessQ(&item));
+        EXPECT_EQ(i, item);
+    }
+
+    EXPECT_EQ(0, m_queue->getSizeOfProcessQ());
+    EXPECT_EQ(TIMED_OUT, m_queue->popProcessQ(&item));
+}
+
+TEST_P(ExynosCameraListTest, WaitTimesOut)
+{
+    uint32_t item;
+    nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+
+    EXPECT_EQ(TIMED_OUT, m_queue->waitAndPopProcessQ(&item));
+    EXPECT_GE(systemTime(SYSTEM_TIME_MONOTONIC) - start, LIST_TEST_WAIT_TIME / 2);
+    EXPECT_FALSE(m_queue->isWaiting());
+}
+
+TEST_P(ExynosCameraListTest, WaitsForMargin)
+{
+    ExynosCameraList<uint32_t> queue(3);
+    uint32_t item = 0;
+    status_t ret = NO_ERROR;
+
+    ASSERT_EQ(NO_ERROR, queue.setRingSize(GetParam()));
+    queue.setWaitTime(1000 * 1000000);
+
+    std::thread consumer([&]() { ret = queue.waitAndPopProcessQ(&item); });
+
+    for (uint32_t i = 1; i <= 3; i++) {
+        while (queue.isWaiting() == false)
+            usleep(1000);
+        queue.pushProcessQ(&i);
+    }
+
+    consumer.join();
+
+    EXPECT_EQ(OK, ret);
+    EXPECT_EQ(1u, item);
+    EXPECT_EQ(2, queue.getSizeOfProcessQ());
+}
+
+TEST_P(ExynosCameraListTest, WakeupAllCancelsWait)
+{
+    uint32_t item;
+    status_t ret = NO_ERROR;
+
+    m_queue->setWaitTime(1000 * 1000000);
+
+    std::thread consumer([&]() { ret = m_queue->waitAndPopProcessQ(&item); });
+
+    while (m_queue->isWaiting() == false)
+        usleep(1000);
+    m_queue->wakeupAll();
+
+    consumer.join();
+
+    EXPECT_EQ(TIMED_OUT, ret);
+}
+
+TEST_P(ExynosCameraListTest, ReleaseDropsItems)
+{
+    ExynosCameraList<sp<ExynosCameraListItem> > queue;
+    sp<ExynosCameraListItem> item = new ExynosCameraListItem(7);
+    sp<ExynosCameraListItem> out;
+
+    ASSERT_EQ(NO_ERROR, queue.setRingSize(GetParam()));
+
+    for (int i = 0; i < 40; i++)
+        queue.pushProcessQ(&item);
+    EXPECT_EQ(41, item->getStrongCount());
+
+    ASSERT_EQ(OK, queue.popProcessQ(&out));
+    EXPECT_EQ(7u, out->key);
+    out = NULL;
+
+    /* the popped cell doesn't keep the item */
+    EXPECT_EQ(40, item->getStrongCount());
+
+    queue.release();
+
+    EXPECT_EQ(1, item->getStrongCount());
+    EXPECT_EQ(0, queue.getSizeOfProcessQ());
+}
+
+TEST_P(ExynosCameraListTest, RunsThreadAtMargin)
+{
+    class CountThread : public Thread {
+    public:
+        CountThread(ExynosCameraList<uint32_t> *queue) { m_queue = queue; count = 0; }
+        std::atomic<int> count;
+    private:
+        virtual bool threadLoop()
+        {
+            uint32_t item;
+            if (m_queue->waitAndPopProcessQ(&item) != OK)
+                return false;
+            count++;
+            return true;
+        }
+        ExynosCameraList<uint32_t> *m_queue;
+    };
+
+    sp<CountThread> thread = new CountThread(m_queue);
+
+    m_queue->setup(thread);
+
+    for (uint32_t i = 0; i < 10; i++)
+        m_queue->pushProcessQ(&i);
+
+    thread->join();
+
+    EXPECT_EQ(10, thread->count.load());
+}
+
+TEST_P(ExynosCameraListTest, MultiProducerMultiConsumer)
+{
+    const uint32_t numOfProducer = 3;
+    const uint32_t numOfItem = 3000;
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> popCount(0);
+    std::vector<std::atomic<uint32_t> > seen(numOfProducer * numOfItem);
+
+    m_queue->setWaitTime(1000 * 1000000);
+
+    for (uint32_t c = 0; c < 2; c++) {
+        threads.push_back(std::thread([&]() {
+            uint32_t item;
+            while (popCount.load() < numOfProducer * numOfItem) {
+                if (m_queue->popProcessQ(&item) == OK) {
+                    seen[item]++;
+                    popCount++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    for (uint32_t p = 0; p < numOfProducer; p++) {
+        threads.push_back(std::thread([&, p]() {
+            for (uint32_t i = 0; i < numOfItem; i++) {
+                uint32_t item = p * numOfItem + i;
+                m_queue->pushProcessQ(&item);
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    for (size_t i = 0; i < seen.size(); i++)
+        ASSERT_EQ(1u, seen[i].load()) << "item " << i;
+}
+
+TEST(ExynosCameraListRingTest, SizeChangesOnlyWhenEmpty)
+{
+    ExynosCameraList<uint32_t> queue;
+    uint32_t item = 1;
+
+    ASSERT_EQ(NO_ERROR, queue.setRingSize(8));
+    queue.pushProcessQ(&item);
+    EXPECT_EQ(INVALID_OPERATION, queue.setRingSize(0));
+
+    ASSERT_EQ(OK, queue.popProcessQ(&item));
+    EXPECT_EQ(NO_ERROR, queue.setRingSize(0));
+}
+
+INSTANTIATE_TEST_CASE_P(Backend, ExynosCameraListTest, ::testing::Values(0u, 16u));
+
+}; /* namespace android */
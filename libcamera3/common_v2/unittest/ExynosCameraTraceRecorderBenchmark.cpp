@@ -0,0 +1,56 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * CPU time of a pipe event, with tracing disabled and enabled.
+ * The threads record at once, each one into its own ring.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "ExynosCameraTraceRecorder.h"
+
+namespace android {
+
+static ExynosCameraTraceRecorder *g_recorder = NULL;
+
+static void BM_Record(benchmark::State &state)
+{
+    uint64_t frameCount = 0;
+
+    if (state.thread_index() == 0) {
+        g_recorder = new ExynosCameraTraceRecorder();
+        g_recorder->setEnable(state.range(0) != 0);
+    }
+
+    for (auto _ : state) {
+        g_recorder->record(CAMERA_TRACE_EVENT_PIPE_DONE, 0, state.thread_index(), frameCount, frameCount, frameCount);
+        frameCount++;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete g_recorder;
+        g_recorder = NULL;
+    }
+}
+BENCHMARK(BM_Record)->Arg(0)->Arg(1)->Threads(1)->Threads(4);
+
+}; /* namespace android */
+
+BENCHMARK_MAIN();
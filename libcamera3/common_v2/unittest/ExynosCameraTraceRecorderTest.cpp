@@ -0,0 +1,361 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraTraceRecorder.h"
+
+namespace android {
+
+typedef struct trace_dump {
+    camera_trace_file_header_t header;
+    std::vector<camera_trace_pipe_t> pipes;
+    std::vector<camera_trace_record_t> records;
+} trace_dump_t;
+
+class ExynosCameraTraceRecorderTest : public ::testing::Test {
+protected:
+    ExynosCameraTraceRecorder *m_recorder;
+    std::string m_path;
+
+    virtual void SetUp()
+    {
+        m_recorder = new ExynosCameraTraceRecorder();
+        m_path = ::testing::TempDir() + "camera_trace_" + std::to_string(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        delete m_recorder;
+        unlink(m_path.c_str());
+    }
+
+    bool readDump(trace_dump_t *dump)
+    {
+        bool ret = false;
+        FILE *fp = NULL;
+
+        if (m_recorder->exportTrace(CAMERA_TRACE_FORMAT_BINARY, m_path.c_str()) != NO_ERROR)
+            return false;
+
+        fp = fopen(m_path.c_str(), "rb");
+        if (fp == NULL)
+            return false;
+
+        if (fread(&dump->header, sizeof(dump->header), 1, fp) != 1)
+            goto EXIT;
+
+        dump->pipes.resize(dump->header.pipe_num);
+        if (dump->header.pipe_num != 0
+            && fread(dump->pipes.data(), sizeof(camera_trace_pipe_t), dump->header.pipe_num, fp) != dump->header.pipe_num)
+            goto EXIT;
+
+        dump->records.resize(dump->header.record_num);
+        if (dump->header.record_num != 0
+            && fread(dump->records.data(), sizeof(camera_trace_record_t), dump->header.record_num, fp) != dump->header.record_num)
+            goto EXIT;
+
+        ret = (fgetc(fp) == EOF);
+
+EXIT:
+        fclose(fp);
+        return ret;
+    }
+
+    std::string readJson(void)
+    {
+        std::string json;
+        char buf[4096];
+        size_t size;
+        FILE *fp = NULL;
+
+        if (m_recorder->exportTrace(CAMERA_TRACE_FORMAT_CHROME_JSON, m_path.c_str()) != NO_ERROR)
+            return json;
+
+        fp = fopen(m_path.c_str(), "r");
+        if (fp == NULL)
+            return json;
+
+        while ((size = fread(buf, 1, sizeof(buf), fp)) > 0)
+            json.append(buf, size);
+
+        fclose(fp);
+        return json;
+    }
+
+    static int countOf(const std::string &str, const std::string &pattern)
+    {
+        int count = 0;
+
+        for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+            count++;
+
+        return count;
+    }
+
+    void recordPipe(enum camera_trace_event_type type, uint32_t pipeId, uint64_t frameCount, uint64_t ns)
+    {
+        m_recorder->record(type, 0, pipeId, frameCount, ns, ns);
+    }
+};
+
+TEST_F(ExynosCameraTraceRecorderTest, DisabledRecordsNothing)
+{
+    trace_dump_t dump;
+
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, 0, 100);
+
+    ASSERT_TRUE(readDump(&dump));
+    EXPECT_EQ((uint32_t)CAMERA_TRACE_FILE_MAGIC, dump.header.magic);
+    EXPECT_EQ(0u, dump.header.record_num);
+    EXPECT_EQ(0u, m_recorder->getThreadCount());
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, MergesRingsOfThreadsInTime)
+{
+    const int threadNum = 4;
+    const int recordNum = 100;
+    std::vector<std::thread> threads;
+    std::set<uint32_t> tids;
+    trace_dump_t dump;
+
+    m_recorder->setEnable(true);
+
+    std::atomic<int> doneNum(0);
+
+    for (int i = 0; i < threadNum; i++) {
+        threads.push_back(std::thread([this, i, &doneNum]() {
+            for (int j = 0; j < recordNum; j++)
+                recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, i, j, (uint64_t)j * threadNum + i);
+
+            /* a ring of an exited thread would be taken by the next one */
+            doneNum++;
+            while (doneNum.load() < threadNum)
+                usleep(100);
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    EXPECT_EQ((uint32_t)threadNum, m_recorder->getThreadCount());
+
+    ASSERT_TRUE(readDump(&dump));
+    ASSERT_EQ((uint32_t)(threadNum * recordNum), dump.header.record_num);
+    EXPECT_EQ(0u, dump.header.dropped_num);
+
+    for (size_t i = 0; i < dump.records.size(); i++) {
+        EXPECT_EQ(i, dump.records[i].start_ns);
+        EXPECT_EQ(dump.records[i].start_ns % threadNum, dump.records[i].pipe_id);
+        tids.insert(dump.records[i].tid);
+    }
+    EXPECT_EQ((size_t)threadNum, tids.size());
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, RingIsReusedAfterThreadExit)
+{
+    const int threadNum = TRACE_RECORDER_MAX_THREAD_NUM * 2;
+    trace_dump_t dump;
+
+    m_recorder->setEnable(true);
+
+    for (int i = 0; i < threadNum; i++) {
+        std::thread thread([this, i]() {
+            pthread_setname_np(pthread_self(), ("trace_" + std::to_string(i)).c_str());
+            recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, i, i);
+        });
+        thread.join();
+    }
+
+    EXPECT_EQ(1u, m_recorder->getThreadCount());
+
+    ASSERT_TRUE(readDump(&dump));
+    ASSERT_EQ((uint32_t)threadNum, dump.header.record_num);
+    EXPECT_EQ(0u, dump.header.dropped_num);
+
+    /* the exited threads keep their names */
+    std::string json = readJson();
+    EXPECT_NE(std::string::npos, json.find("\"trace_0\""));
+    EXPECT_NE(std::string::npos, json.find("\"trace_" + std::to_string(threadNum - 1) + "\""));
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, RingIsKeptAcrossRecorders)
+{
+    ExynosCameraTraceRecorder other;
+    trace_dump_t dump;
+
+    m_recorder->setEnable(true);
+    other.setEnable(true);
+
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, 0, 0);
+    other.record(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, 1, 0, 0, 0);
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_DONE, 1, 0, 1);
+
+    EXPECT_EQ(1u, m_recorder->getThreadCount());
+    EXPECT_EQ(1u, other.getThreadCount());
+
+    ASSERT_TRUE(readDump(&dump));
+    EXPECT_EQ(2u, dump.header.record_num);
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, WrappedRingCountsDropped)
+{
+    trace_dump_t dump;
+
+    ASSERT_EQ(NO_ERROR, m_recorder->setCapacity(10));
+    EXPECT_EQ(16u, m_recorder->getCapacity());
+    m_recorder->setEnable(true);
+
+    for (int i = 0; i < 40; i++)
+        recordPipe(CAMERA_TRACE_EVENT_PIPE_DONE, 1, i, i);
+
+    /* the ring is made, a record could be being written into it */
+    EXPECT_EQ(INVALID_OPERATION, m_recorder->setCapacity(32));
+
+    ASSERT_TRUE(readDump(&dump));
+    ASSERT_EQ(16u, dump.header.record_num);
+    EXPECT_EQ(24u, dump.header.dropped_num);
+    EXPECT_EQ(24u, dump.records[0].key);
+    EXPECT_EQ(39u, dump.records[15].key);
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, BinaryKeepsPipeNames)
+{
+    trace_dump_t dump;
+
+    m_recorder->setPipeName(0, 1, "PIPE_3AA");
+    m_recorder->setPipeName(1, 1, "PIPE_3AA");
+    m_recorder->setPipeName(0, 1, "PIPE_3AA_REPROCESSING");
+
+    ASSERT_TRUE(readDump(&dump));
+    ASSERT_EQ(2u, dump.header.pipe_num);
+    EXPECT_EQ(0u, dump.pipes[0].camera_id);
+    EXPECT_STREQ("PIPE_3AA_REPROCESSING", dump.pipes[0].name);
+    EXPECT_EQ(1u, dump.pipes[1].camera_id);
+    EXPECT_STREQ("PIPE_3AA", dump.pipes[1].name);
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, JsonLinksPipesOfFrame)
+{
+    std::string json;
+
+    m_recorder->setPipeName(0, 1, "PIPE_3AA");
+    m_recorder->setPipeName(0, 2, "PIPE_MCSC");
+    m_recorder->setEnable(true);
+
+    /* frame 7 goes through 3AA and MCSC, frame 8 is only pushed */
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, 7, 1000);
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_DONE, 1, 7, 5500);
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 2, 7, 6000);
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_DONE, 2, 7, 9000);
+    recordPipe(CAMERA_TRACE_EVENT_PIPE_PUSH, 1, 8, 9500);
+
+    json = readJson();
+    ASSERT_FALSE(json.empty());
+
+    EXPECT_EQ(1, countOf(json, "\"process_name\""));
+    EXPECT_EQ(1, countOf(json, "\"thread_name\""));
+
+    EXPECT_EQ(2, countOf(json, "\"name\":\"push PIPE_3AA\""));
+    EXPECT_EQ(1, countOf(json, "\"name\":\"done PIPE_MCSC\""));
+
+    /* the flow of frame 7 starts at the first push and finishes at the last done */
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"s\",\"id\":\"0:7\""));
+    EXPECT_EQ(2, countOf(json, "\"ph\":\"t\",\"id\":\"0:7\""));
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"f\",\"id\":\"0:7\""));
+    EXPECT_EQ(0, countOf(json, "\"id\":\"0:8\""));
+
+    /* a stage is an async slice from the push to the done, the push of frame 8 has no done */
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"b\",\"id\":\"0:1:7\",\"pid\":0,\"tid\":"));
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"e\",\"id\":\"0:1:7\""));
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"b\",\"id\":\"0:2:7\""));
+    EXPECT_EQ(2, countOf(json, "\"ph\":\"b\""));
+    /* the done slice, the flow step and the end of the stage */
+    EXPECT_EQ(3, countOf(json, "\"ts\":5.500"));
+
+    EXPECT_EQ(countOf(json, "{"), countOf(json, "}"));
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, JsonNamesLoggerEvents)
+{
+    const char *typeStr[] = {"INIT", "INTERVAL", "DURATION"};
+    const char *categoryStr[] = {"INIT", "QBUF", NULL};
+    std::string json;
+
+    m_recorder->setLoggerName((char **)typeStr, 3, (char **)categoryStr, 3);
+    m_recorder->setEnable(true);
+
+    m_recorder->record(CAMERA_TRACE_EVENT_LOGGER, 1, 3, 5, 2000, 7000, 5, 2, 1);
+    m_recorder->record(CAMERA_TRACE_EVENT_LOGGER, 1, 3, 6, 8000, 8000, 33, 1, 2);
+    m_recorder->record(CAMERA_TRACE_EVENT_LOGGER, 1, 3, 6, 9000, 9000, 1, 7, 9);
+
+    json = readJson();
+    ASSERT_FALSE(json.empty());
+
+    EXPECT_EQ(1, countOf(json, "\"name\":\"QBUF\",\"cat\":\"logger\",\"pid\":1"));
+    EXPECT_EQ(1, countOf(json, "\"ph\":\"X\",\"dur\":5.000,\"args\":{\"type\":\"DURATION\""));
+    /* a category without a name and a type out of bound */
+    EXPECT_EQ(2, countOf(json, "\"name\":\"unknown\""));
+    EXPECT_EQ(1, countOf(json, "\"type\":\"unknown\""));
+    EXPECT_EQ(2, countOf(json, "\"ph\":\"i\""));
+}
+
+TEST_F(ExynosCameraTraceRecorderTest, ExportsWhileRecording)
+{
+    std::atomic<bool> stop(false);
+    trace_dump_t dump;
+
+    ASSERT_EQ(NO_ERROR, m_recorder->setCapacity(64));
+    m_recorder->setEnable(true);
+
+    std::thread writer([this, &stop]() {
+        uint64_t ns = 0;
+        while (stop.load() == false) {
+            recordPipe(CAMERA_TRACE_EVENT_PIPE_DONE, 1, ns, ns);
+            ns++;
+        }
+    });
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(readDump(&dump));
+        ASSERT_LE(dump.header.record_num, 64u);
+
+        /* a torn record would break the key and the time of a record */
+        for (size_t j = 0; j < dump.records.size(); j++) {
+            EXPECT_EQ(dump.records[j].key, dump.records[j].start_ns);
+            if (j > 0) {
+                EXPECT_LT(dump.records[j - 1].start_ns, dump.records[j].start_ns);
+            }
+        }
+    }
+
+    stop = true;
+    writer.join();
+}
+
+}; /* namespace android */
@@ -7,7 +7,8 @@ LOCAL_PROPRIETARY_MODULE := true
 LOCAL_HEADER_LIBRARIES := libsystem_headers
 
 LOCAL_SRC_FILES := \
-	csc.c
+	csc.c \
+	csc_stripe.c
 
 LOCAL_C_INCLUDES := \
 	hardware/samsung_slsi-linaro/$(TARGET_BOARD_PLATFORM)/include \
@@ -39,6 +40,10 @@ ifeq ($(BOARD_USES_FIMC), true)
 LOCAL_SHARED_LIBRARIES += libexynosfimc
 endif
 
+ifeq ($(BOARD_USE_NV12T_128X64), true)
+LOCAL_CFLAGS += -DUSE_NV12T_128X64
+endif
+
 LOCAL_CFLAGS += -Wno-unused-variable -Wno-unused-label
 
 include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
@@ -31,12 +31,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <log/log.h>
 #include <system/graphics.h>
 
 #include "csc.h"
 #include "exynos_format.h"
 #include "swconverter.h"
+#include "csc_stripe.h"
 
 #ifdef USES_FIMC
 #include "exynos_fimc.h"
@@ -49,7 +51,16 @@
 #define FIMC_IMG_ALIGN_HEIGHT 2
 #define MFC_IMG_ALIGN_WIDTH 16
 
-static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
+/* stripes of a software conversion are at least this many lines */
+#define CSC_SW_STRIPE_MIN_HEIGHT 64
+/* default number of threads of a software conversion */
+#define CSC_SW_DEFAULT_THREADS 4
+
+/* visit the rows of a plane owned by the current stripe */
+#define for_each_stripe_row(i, stripe, rows) \
+    for (i = (int)csc_stripe_start(stripe, rows, 1); i < (int)csc_stripe_end(stripe, rows, 1); i++)
+
+static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle, const CSC_STRIPE *stripe) {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
     int i;
@@ -66,7 +77,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -74,7 +85,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_U_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             memcpy(pDst + ((handle->src_format.crop_width >> 1) * i),
                    pSrc + (ALIGN((handle->src_format.crop_width >> 1), MFC_IMG_ALIGN_WIDTH) * i),
                    (handle->src_format.crop_width >> 1));
@@ -82,7 +93,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_V_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             memcpy(pDst + ((handle->src_format.crop_width >> 1) * i),
                    pSrc + (ALIGN((handle->src_format.crop_width >> 1), MFC_IMG_ALIGN_WIDTH) * i),
                    (handle->src_format.crop_width >> 1));
@@ -95,7 +106,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -103,7 +114,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -112,7 +123,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_P010_M:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + ((handle->src_format.crop_width * 2) * i),
                    pSrc + ((handle->src_format.width * 2) * i),
                    (handle->src_format.crop_width * 2));
@@ -120,7 +131,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             memcpy(pDst + ((handle->src_format.crop_width * 2) * i),
                    pSrc + ((handle->src_format.width * 2) * i),
                    (handle->src_format.crop_width * 2));
@@ -134,9 +145,9 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
         if ((handle->src_format.width == handle->dst_format.width) &&
             (handle->src_format.crop_width == handle->dst_format.crop_width)) {
-            memcpy(pDst, pSrc, (handle->src_format.width * handle->src_format.height));
+            csc_stripe_memcpy(stripe, pDst, pSrc, (handle->src_format.width * handle->src_format.height));
         } else {
-            for (i = 0; i < (int)handle->src_format.height; i++) {
+            for_each_stripe_row(i, stripe, handle->src_format.height) {
                 memcpy(pDst + (handle->dst_format.width * i),
                        pSrc + (handle->src_format.crop_width * i),
                        handle->src_format.crop_width);
@@ -145,7 +156,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_U_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        for (i = 0; i < (int)(handle->src_format.height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.height >> 1)) {
             memcpy(pDst + (ALIGN((handle->dst_format.width >> 1), MFC_IMG_ALIGN_WIDTH) * i),
                    pSrc + ((handle->src_format.crop_width >> 1) * i),
                    (handle->src_format.crop_width >> 1));
@@ -153,7 +164,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
         pSrc = (char *)handle->src_buffer.planes[CSC_V_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.height >> 1)) {
             memcpy(pDst + (ALIGN((handle->dst_format.width >> 1), MFC_IMG_ALIGN_WIDTH) * i),
                    pSrc + ((handle->src_format.crop_width >> 1) * i),
                    (handle->src_format.crop_width >> 1));
@@ -165,15 +176,15 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
             (handle->src_format.crop_width == handle->dst_format.crop_width)) {
             pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-            memcpy(pDst, pSrc, (handle->src_format.width * handle->src_format.height));
+            csc_stripe_memcpy(stripe, pDst, pSrc, (handle->src_format.width * handle->src_format.height));
 
             pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-            memcpy(pDst, pSrc, (handle->src_format.width * (handle->src_format.height >> 1)));
+            csc_stripe_memcpy(stripe, pDst, pSrc, (handle->src_format.width * (handle->src_format.height >> 1)));
         } else {
             pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-            for (i = 0; i < (int)handle->src_format.height; i++) {
+            for_each_stripe_row(i, stripe, handle->src_format.height) {
                 memcpy(pDst + (handle->dst_format.width * i),
                        pSrc + (handle->src_format.crop_width * i),
                        handle->src_format.crop_width);
@@ -181,7 +192,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
             pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-            for (i = 0; i < (int)(handle->src_format.height >> 1); i++) {
+            for_each_stripe_row(i, stripe, (handle->src_format.height >> 1)) {
                 memcpy(pDst + (handle->dst_format.width * i),
                        pSrc + (handle->src_format.crop_width * i),
                        handle->src_format.crop_width);
@@ -193,15 +204,15 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
             (handle->src_format.crop_width == handle->dst_format.crop_width)) {
             pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-            memcpy(pDst, pSrc, ((handle->src_format.width * 2) * handle->src_format.height));
+            csc_stripe_memcpy(stripe, pDst, pSrc, ((handle->src_format.width * 2) * handle->src_format.height));
 
             pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-            memcpy(pDst, pSrc, ((handle->src_format.width * 2) * (handle->src_format.height >> 1)));
+            csc_stripe_memcpy(stripe, pDst, pSrc, ((handle->src_format.width * 2) * (handle->src_format.height >> 1)));
         } else {
             pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-            for (i = 0; i < (int)handle->src_format.height; i++) {
+            for_each_stripe_row(i, stripe, handle->src_format.height) {
                 memcpy(pDst + ((handle->dst_format.width * 2) * i),
                        pSrc + ((handle->src_format.crop_width * 2) * i),
                        (handle->src_format.crop_width * 2));
@@ -209,7 +220,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
 
             pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
             pDst = (char *)handle->dst_buffer.planes[CSC_UV_PLANE];
-            for (i = 0; i < (int)(handle->src_format.height >> 1); i++) {
+            for_each_stripe_row(i, stripe, (handle->src_format.height >> 1)) {
                 memcpy(pDst + ((handle->dst_format.width * 2) * i),
                        pSrc + ((handle->src_format.crop_width * 2) * i),
                        (handle->src_format.crop_width * 2));
@@ -221,7 +232,7 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     case HAL_PIXEL_FORMAT_EXYNOS_ARGB_8888:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        memcpy(pDst, pSrc, (handle->src_format.width * handle->src_format.height * 4));
+        csc_stripe_memcpy(stripe, pDst, pSrc, (handle->src_format.width * handle->src_format.height * 4));
         break;
     default:
         ret = CSC_ErrorUnsupportFormat;
@@ -231,16 +242,132 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     return ret;
 }
 
+/*
+ * Row stripes of the swconverter helpers.
+ * Luma is split on even lines so that a stripe always owns whole chroma rows.
+ */
+static void stripe_rgb_to_yuv420p(
+    CSC_HANDLE       *handle,
+    const CSC_STRIPE *stripe,
+    void            (*func)(unsigned char *, unsigned char *, unsigned char *, unsigned char *, unsigned int, unsigned int),
+    unsigned char    *y_dst,
+    unsigned char    *u_dst,
+    unsigned char    *v_dst,
+    unsigned char    *rgb_src)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int start = csc_stripe_start(stripe, handle->src_format.height, 2);
+    unsigned int end = csc_stripe_end(stripe, handle->src_format.height, 2);
+    unsigned int c_offset = (start / 2) * ((width + 1) / 2);
+
+    if (start >= end)
+        return;
+
+    func(y_dst + start * width,
+         u_dst + c_offset,
+         v_dst + c_offset,
+         rgb_src + start * width * 4,
+         width,
+         end - start);
+}
+
+static void stripe_rgb_to_yuv420sp(
+    CSC_HANDLE       *handle,
+    const CSC_STRIPE *stripe,
+    void            (*func)(unsigned char *, unsigned char *, unsigned char *, unsigned int, unsigned int),
+    unsigned char    *y_dst,
+    unsigned char    *uv_dst,
+    unsigned char    *rgb_src)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int start = csc_stripe_start(stripe, handle->src_format.height, 2);
+    unsigned int end = csc_stripe_end(stripe, handle->src_format.height, 2);
+
+    if (start >= end)
+        return;
+
+    func(y_dst + start * width,
+         uv_dst + (start / 2) * 2 * ((width + 1) / 2),
+         rgb_src + start * width * 4,
+         width,
+         end - start);
+}
+
+/* rows of a NV12T plane owned by stripe, returns 0 if there are none */
+static int stripe_tiled_rows(
+    const CSC_STRIPE *stripe,
+    unsigned int      rows,
+    unsigned int     *start,
+    unsigned int     *end)
+{
+#ifdef USE_NV12T_128X64
+    /* 64x32 tiles are laid out in a Z order over two tile rows, keep the plane in one piece */
+    *start = 0;
+    *end = (stripe->index == 0) ? rows : 0;
+#else
+    /* 16x16 tiles are stored row after row */
+    *start = csc_stripe_start(stripe, rows, 16);
+    *end = csc_stripe_end(stripe, rows, 16);
+#endif
+    return *start < *end;
+}
+
+static void stripe_tiled_to_linear(
+    CSC_HANDLE       *handle,
+    const CSC_STRIPE *stripe,
+    unsigned char    *dst,
+    unsigned char    *src,
+    unsigned int      rows,
+    int               is_uv)
+{
+    unsigned int width = handle->src_format.crop_width;
+    unsigned int start, end;
+    unsigned int src_offset, dst_offset;
+
+    if (!stripe_tiled_rows(stripe, rows, &start, &end))
+        return;
+
+    src_offset = start * ALIGN(width, 16);
+    dst_offset = start * width;
+
+    if (is_uv)
+        csc_tiled_to_linear_uv(dst + dst_offset, src + src_offset, width, end - start);
+    else
+        csc_tiled_to_linear_y(dst + dst_offset, src + src_offset, width, end - start);
+}
+
+static void stripe_tiled_to_linear_deinterleave(
+    CSC_HANDLE       *handle,
+    const CSC_STRIPE *stripe,
+    unsigned char    *u_dst,
+    unsigned char    *v_dst,
+    unsigned char    *uv_src,
+    unsigned int      rows)
+{
+    unsigned int width = handle->src_format.crop_width;
+    unsigned int start, end;
+    unsigned int src_offset, dst_offset;
+
+    if (!stripe_tiled_rows(stripe, rows, &start, &end))
+        return;
+
+    src_offset = start * ALIGN(width, 16);
+    dst_offset = start * (width / 2);
+
+    csc_tiled_to_linear_uv_deinterleave(u_dst + dst_offset, v_dst + dst_offset, uv_src + src_offset, width, end - start);
+}
+
 /* source is BRGA888 */
 static CSC_ERRORCODE conv_sw_src_argb888(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
     switch (handle->dst_format.color_format) {
     case HAL_PIXEL_FORMAT_BGRA_8888:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
             ret = CSC_ErrorUnsupportFormat;
         }
@@ -248,36 +375,39 @@ static CSC_ERRORCODE conv_sw_src_argb888(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_BGRA8888_to_YUV420P(
+        stripe_rgb_to_yuv420p(
+            handle,
+            stripe,
+            csc_BGRA8888_to_YUV420P,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_BGRA8888_to_YUV420SP(
+        stripe_rgb_to_yuv420sp(
+            handle,
+            stripe,
+            csc_BGRA8888_to_YUV420SP,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_YV12:
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        csc_BGRA8888_to_YUV420P(
+        stripe_rgb_to_yuv420p(
+            handle,
+            stripe,
+            csc_BGRA8888_to_YUV420P,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -290,14 +420,15 @@ static CSC_ERRORCODE conv_sw_src_argb888(
 
 /* source is RGBA888 */
 static CSC_ERRORCODE conv_sw_src_rgba888(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
     switch (handle->dst_format.color_format) {
     case HAL_PIXEL_FORMAT_RGBA_8888:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
             ret = CSC_ErrorUnsupportFormat;
         }
@@ -305,36 +436,39 @@ static CSC_ERRORCODE conv_sw_src_rgba888(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_RGBA8888_to_YUV420P(
+        stripe_rgb_to_yuv420p(
+            handle,
+            stripe,
+            csc_RGBA8888_to_YUV420P,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_RGBA8888_to_YUV420SP(
+        stripe_rgb_to_yuv420sp(
+            handle,
+            stripe,
+            csc_RGBA8888_to_YUV420SP,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_YV12:
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        csc_RGBA8888_to_YUV420P(
+        stripe_rgb_to_yuv420p(
+            handle,
+            stripe,
+            csc_RGBA8888_to_YUV420P,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE]);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -348,7 +482,8 @@ static CSC_ERRORCODE conv_sw_src_rgba888(
 
 /* source is NV12T */
 static CSC_ERRORCODE conv_sw_src_nv12t(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -356,16 +491,19 @@ static CSC_ERRORCODE conv_sw_src_nv12t(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_tiled_to_linear_y(
+        stripe_tiled_to_linear(
+            handle,
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height);
-        csc_tiled_to_linear_uv_deinterleave(
+            handle->src_format.crop_height,
+            0);
+        stripe_tiled_to_linear_deinterleave(
+            handle,
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
             (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-            handle->src_format.crop_width,
             handle->src_format.crop_height / 2);
         ret = CSC_ErrorNone;
         break;
@@ -373,16 +511,20 @@ static CSC_ERRORCODE conv_sw_src_nv12t(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_tiled_to_linear_y(
+        stripe_tiled_to_linear(
+            handle,
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height);
-        csc_tiled_to_linear_uv(
+            handle->src_format.crop_height,
+            0);
+        stripe_tiled_to_linear(
+            handle,
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height / 2);
+            handle->src_format.crop_height / 2,
+            1);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -395,7 +537,8 @@ static CSC_ERRORCODE conv_sw_src_nv12t(
 
 /* source is YUV420P */
 static CSC_ERRORCODE conv_sw_src_yuv420p(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -404,17 +547,17 @@ static CSC_ERRORCODE conv_sw_src_yuv420p(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-                   handle->src_format.width * handle->src_format.height);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
-                   (handle->src_format.width * handle->src_format.height) >> 2);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
-                   (handle->src_format.width * handle->src_format.height) >> 2);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                              handle->src_format.width * handle->src_format.height);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
+                              (handle->src_format.width * handle->src_format.height) >> 2);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
+                              (handle->src_format.width * handle->src_format.height) >> 2);
             ret = CSC_ErrorNone;
         }
         break;
@@ -422,10 +565,11 @@ static CSC_ERRORCODE conv_sw_src_yuv420p(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-               (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-               handle->src_format.width * handle->src_format.height);
-        csc_interleave_memcpy(
+        csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                          (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                          handle->src_format.width * handle->src_format.height);
+        csc_stripe_interleave_memcpy(
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
@@ -442,7 +586,8 @@ static CSC_ERRORCODE conv_sw_src_yuv420p(
 
 /* source is YVU420P */
 static CSC_ERRORCODE conv_sw_src_yvu420p(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -450,17 +595,17 @@ static CSC_ERRORCODE conv_sw_src_yvu420p(
     case HAL_PIXEL_FORMAT_YV12:  /* bypass */
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-                   handle->src_format.width * handle->src_format.height);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
-                   (handle->src_format.width * handle->src_format.height) >> 2);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
-                   (handle->src_format.width * handle->src_format.height) >> 2);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                              handle->src_format.width * handle->src_format.height);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
+                              (handle->src_format.width * handle->src_format.height) >> 2);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
+                              (handle->src_format.width * handle->src_format.height) >> 2);
             ret = CSC_ErrorNone;
         }
         break;
@@ -468,10 +613,11 @@ static CSC_ERRORCODE conv_sw_src_yvu420p(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-               (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-               handle->src_format.width * handle->src_format.height);
-        csc_interleave_memcpy(
+        csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                          (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                          handle->src_format.width * handle->src_format.height);
+        csc_stripe_interleave_memcpy(
+            stripe,
             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
             (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
@@ -488,7 +634,8 @@ static CSC_ERRORCODE conv_sw_src_yvu420p(
 
 /* source is YUV420SP */
 static CSC_ERRORCODE conv_sw_src_yuv420sp(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -505,14 +652,14 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-                   handle->src_format.width * handle->src_format.height);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-                   handle->src_format.width * handle->src_format.height >> 1);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                              handle->src_format.width * handle->src_format.height);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
+                              handle->src_format.width * handle->src_format.height >> 1);
             ret = CSC_ErrorNone;
         }
         break;
@@ -522,7 +669,7 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
     {
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -531,7 +678,7 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
         pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
         pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
                 srcOffset = (i * handle->src_format.width) + (j * 2);
                 dstOffset = i * (handle->src_format.crop_width >> 1);
@@ -547,7 +694,7 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -556,7 +703,7 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
         pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
         pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
                 srcOffset = (i * handle->src_format.width) + (j * 2);
                 dstOffset = i * (handle->src_format.crop_width >> 1);
@@ -577,7 +724,8 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
 
 /* source is YVU420SP */
 static CSC_ERRORCODE conv_sw_src_yvu420sp(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -593,14 +741,14 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-                   handle->src_format.width * handle->src_format.height);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-                   handle->src_format.width * handle->src_format.height >> 1);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                              handle->src_format.width * handle->src_format.height);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
+                              handle->src_format.width * handle->src_format.height >> 1);
             ret = CSC_ErrorNone;
         }
         break;
@@ -609,7 +757,7 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -618,7 +766,7 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
         pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
         pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
                 srcOffset = (i * handle->src_format.width) + (j * 2);
                 dstOffset = i * (handle->src_format.crop_width >> 1);
@@ -633,7 +781,7 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
         pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
         pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
+        for_each_stripe_row(i, stripe, handle->src_format.crop_height) {
             memcpy(pDst + (handle->src_format.crop_width * i),
                    pSrc + (handle->src_format.width * i),
                    handle->src_format.crop_width);
@@ -642,7 +790,7 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
         pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
         pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
         pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
+        for_each_stripe_row(i, stripe, (handle->src_format.crop_height >> 1)) {
             for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
                 srcOffset = (i * handle->src_format.width) + (j * 2);
                 dstOffset = i * (handle->src_format.crop_width >> 1);
@@ -661,9 +809,61 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
     return ret;
 }
 
+static unsigned int p010_range(
+    CSC_RANGE_MAP range_map)
+{
+    switch (range_map) {
+    case CSC_RANGE_MAP_NARROW_TO_FULL:
+        return CSC_P010_RANGE_NARROW_TO_FULL;
+    case CSC_RANGE_MAP_FULL_TO_NARROW:
+        return CSC_P010_RANGE_FULL_TO_NARROW;
+    default:
+        return CSC_P010_RANGE_KEEP;
+    }
+}
+
+/*
+ * P010 to 8 bit YUV420SP or YUV420P, the planes keep the width of the source.
+ * Stripes start on a multiple of 8 rows so the dither pattern stays in phase.
+ */
+static void stripe_p010_to_8bit(
+    CSC_HANDLE       *handle,
+    const CSC_STRIPE *stripe,
+    int               planar,
+    unsigned int      swap_uv)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int start = csc_stripe_start(stripe, handle->src_format.height, 8);
+    unsigned int end = csc_stripe_end(stripe, handle->src_format.height, 8);
+    unsigned short *y_src = (unsigned short *)handle->src_buffer.planes[CSC_Y_PLANE] + start * width;
+    unsigned short *uv_src = (unsigned short *)handle->src_buffer.planes[CSC_UV_PLANE] + (start / 2) * width;
+    unsigned char *y_dst = (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE] + start * width;
+    unsigned char *u_dst, *v_dst;
+    unsigned int dither = (handle->dither == CSC_DITHER_ORDERED);
+    unsigned int range = p010_range(handle->range_map);
+
+    if (start >= end)
+        return;
+
+    if (!planar) {
+        csc_P010_to_YUV420SP(y_dst,
+                             (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE] + (start / 2) * width,
+                             y_src, uv_src, width, end - start, swap_uv, dither, range);
+        return;
+    }
+
+    u_dst = (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE] + (start / 2) * (width / 2);
+    v_dst = (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE] + (start / 2) * (width / 2);
+    if (swap_uv)
+        csc_P010_to_YUV420P(y_dst, v_dst, u_dst, y_src, uv_src, width, end - start, dither, range);
+    else
+        csc_P010_to_YUV420P(y_dst, u_dst, v_dst, y_src, uv_src, width, end - start, dither, range);
+}
+
 /* source is P010 */
 static CSC_ERRORCODE conv_sw_src_yuvP010(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
@@ -678,17 +878,40 @@ static CSC_ERRORCODE conv_sw_src_yuvP010(
     case HAL_PIXEL_FORMAT_YCBCR_P010:  /* bypass */
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_P010_M:
         if (handle->src_buffer.mem_type == CSC_MEMORY_MFC) {
-            ret = copy_mfc_data(handle);
+            ret = copy_mfc_data(handle, stripe);
         } else {
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-                   (handle->src_format.width * 2) * handle->src_format.height);
-            memcpy((unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-                   (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-                   (handle->src_format.width * 2) * handle->src_format.height >> 1);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
+                              (handle->src_format.width * 2) * handle->src_format.height);
+            csc_stripe_memcpy(stripe, (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
+                              (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
+                              (handle->src_format.width * 2) * handle->src_format.height >> 1);
             ret = CSC_ErrorNone;
         }
         break;
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
+        stripe_p010_to_8bit(handle, stripe, 0, 0);
+        ret = CSC_ErrorNone;
+        break;
+    case HAL_PIXEL_FORMAT_YCrCb_420_SP:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
+        stripe_p010_to_8bit(handle, stripe, 0, 1);
+        ret = CSC_ErrorNone;
+        break;
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
+        stripe_p010_to_8bit(handle, stripe, 1, 0);
+        ret = CSC_ErrorNone;
+        break;
+    case HAL_PIXEL_FORMAT_YV12:
+    case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
+        stripe_p010_to_8bit(handle, stripe, 1, 1);
+        ret = CSC_ErrorNone;
+        break;
     default:
         ret = CSC_ErrorUnsupportFormat;
         break;
@@ -698,47 +921,48 @@ static CSC_ERRORCODE conv_sw_src_yuvP010(
 }
 
 static CSC_ERRORCODE conv_sw(
-    CSC_HANDLE *handle)
+    CSC_HANDLE *handle,
+    const CSC_STRIPE *stripe)
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
     switch (handle->src_format.color_format) {
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_TILED:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_TILED:
-        ret = conv_sw_src_nv12t(handle);
+        ret = conv_sw_src_nv12t(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        ret = conv_sw_src_yuv420p(handle);
+        ret = conv_sw_src_yuv420p(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_YV12:
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        ret = conv_sw_src_yvu420p(handle);
+        ret = conv_sw_src_yvu420p(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_S10B:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        ret = conv_sw_src_yuv420sp(handle);
+        ret = conv_sw_src_yuv420sp(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_YCBCR_P010:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_P010_M:
-        ret = conv_sw_src_yuvP010(handle);
+        ret = conv_sw_src_yuvP010(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_YCrCb_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
-        ret = conv_sw_src_yvu420sp(handle);
+        ret = conv_sw_src_yvu420sp(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_BGRA_8888:
-        ret = conv_sw_src_argb888(handle);
+        ret = conv_sw_src_argb888(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_RGBA_8888:
-        ret = conv_sw_src_rgba888(handle);
+        ret = conv_sw_src_rgba888(handle, stripe);
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_ARGB_8888:
-        ret = copy_mfc_data(handle);
+        ret = copy_mfc_data(handle, stripe);
         break;
     default:
         ret = CSC_ErrorUnsupportFormat;
@@ -748,6 +972,55 @@ static CSC_ERRORCODE conv_sw(
     return ret;
 }
 
+typedef struct _CSC_SW_JOB {
+    CSC_HANDLE    *handle;
+    CSC_ERRORCODE  ret[CSC_STRIPE_MAX_THREADS];
+} CSC_SW_JOB;
+
+static void conv_sw_stripe(
+    void             *arg,
+    const CSC_STRIPE *stripe)
+{
+    CSC_SW_JOB *job = (CSC_SW_JOB *)arg;
+
+    job->ret[stripe->index] = conv_sw(job->handle, stripe);
+}
+
+static CSC_ERRORCODE conv_sw_parallel(
+    CSC_HANDLE *handle)
+{
+    CSC_SW_JOB job;
+    CSC_STRIPE whole = { 0, 1 };
+    unsigned int count = handle->sw_thread_count;
+    unsigned int i;
+
+    /* small frames are not worth waking up the workers */
+    if (count > handle->src_format.height / CSC_SW_STRIPE_MIN_HEIGHT)
+        count = handle->src_format.height / CSC_SW_STRIPE_MIN_HEIGHT;
+
+    if (count > 1 && handle->sw_pool == NULL)
+        handle->sw_pool = csc_stripe_pool_create(handle->sw_thread_count);
+
+    if (count <= 1 || handle->sw_pool == NULL)
+        return conv_sw(handle, &whole);
+
+    if (count > CSC_STRIPE_MAX_THREADS)
+        count = CSC_STRIPE_MAX_THREADS;
+
+    job.handle = handle;
+    for (i = 0; i < count; i++)
+        job.ret[i] = CSC_ErrorNone;
+
+    csc_stripe_pool_run(handle->sw_pool, count, conv_sw_stripe, &job);
+
+    for (i = 0; i < count; i++) {
+        if (job.ret[i] != CSC_ErrorNone)
+            return job.ret[i];
+    }
+
+    return CSC_ErrorNone;
+}
+
 static CSC_ERRORCODE conv_hw(
     CSC_HANDLE *handle)
 {
@@ -959,6 +1232,16 @@ static CSC_ERRORCODE csc_set_buffer(
     return ret;
 }
 
+static unsigned int csc_default_sw_thread_count(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (cpus < 1)
+        return 1;
+
+    return (cpus > CSC_SW_DEFAULT_THREADS) ? CSC_SW_DEFAULT_THREADS : (unsigned int)cpus;
+}
+
 void *csc_init(
     CSC_METHOD method)
 {
@@ -971,6 +1254,7 @@ void *csc_init(
     csc_handle->hw_property.fixed_node = DEFAULT_CSC_HW;	/* CSC_HW_SC1 == 5 */
     csc_handle->hw_property.mode_drm = 0;
     csc_handle->csc_method = method;
+    csc_handle->sw_thread_count = csc_default_sw_thread_count();
 
     return (void *)csc_handle;
 }
@@ -1004,6 +1288,9 @@ CSC_ERRORCODE csc_deinit(
         }
     }
 
+    if (csc_handle->sw_pool != NULL)
+        csc_stripe_pool_destroy(csc_handle->sw_pool);
+
     free(csc_handle);
     ret = CSC_ErrorNone;
 
@@ -1050,6 +1337,49 @@ CSC_ERRORCODE csc_set_method(
     return ret;
 }
 
+CSC_ERRORCODE csc_set_sw_thread_count(
+    void           *handle,
+    unsigned int    count)
+{
+    CSC_HANDLE *csc_handle;
+
+    if (handle == NULL)
+        return CSC_ErrorNotInit;
+    csc_handle = (CSC_HANDLE *)handle;
+
+    if (count == 0 || count > CSC_STRIPE_MAX_THREADS)
+        return CSC_Error;
+
+    if (count != csc_handle->sw_thread_count && csc_handle->sw_pool != NULL) {
+        /* recreated with the new size by the next conversion */
+        csc_stripe_pool_destroy(csc_handle->sw_pool);
+        csc_handle->sw_pool = NULL;
+    }
+    csc_handle->sw_thread_count = count;
+
+    return CSC_ErrorNone;
+}
+
+CSC_ERRORCODE csc_set_depth_conversion(
+    void           *handle,
+    CSC_DITHER      dither,
+    CSC_RANGE_MAP   range_map)
+{
+    CSC_HANDLE *csc_handle;
+
+    if (handle == NULL)
+        return CSC_ErrorNotInit;
+    csc_handle = (CSC_HANDLE *)handle;
+
+    if (dither > CSC_DITHER_ORDERED || range_map > CSC_RANGE_MAP_FULL_TO_NARROW)
+        return CSC_Error;
+
+    csc_handle->dither = dither;
+    csc_handle->range_map = range_map;
+
+    return CSC_ErrorNone;
+}
+
 CSC_ERRORCODE csc_set_hw_property(
     void                *handle,
     CSC_HW_PROPERTY_TYPE property,
@@ -1339,7 +1669,7 @@ CSC_ERRORCODE csc_convert(
     if (csc_handle->csc_method == CSC_METHOD_HW)
         ret = conv_hw(csc_handle);
     else
-        ret = conv_sw(csc_handle);
+        ret = conv_sw_parallel(csc_handle);
 
     return ret;
 }
@@ -1376,7 +1706,7 @@ CSC_ERRORCODE csc_convert_with_rotation(
     if (csc_handle->csc_method == CSC_METHOD_HW)
         ret = conv_hw(csc_handle);
     else
-        ret = conv_sw(csc_handle);
+        ret = conv_sw_parallel(csc_handle);
 
     return ret;
 }
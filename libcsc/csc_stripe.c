@@ -0,0 +1,230 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        csc_stripe.c
+ *
+ * @brief       worker pool splitting software conversions into row stripes
+ *
+ * @version     1.0.0
+ */
+#define LOG_TAG "libcsc"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <log/log.h>
+
+#include "csc_stripe.h"
+#include "swconverter.h"
+
+typedef struct _CSC_STRIPE_POOL {
+    pthread_mutex_t  lock;
+    pthread_cond_t   work_cond;
+    pthread_cond_t   done_cond;
+
+    pthread_t        threads[CSC_STRIPE_MAX_THREADS];
+    unsigned int     thread_count;
+
+    /* current job */
+    CSC_STRIPE_FUNC  func;
+    void            *arg;
+    unsigned int     count;
+    unsigned int     next;
+    unsigned int     pending;
+
+    int              exit;
+} CSC_STRIPE_POOL;
+
+static void *csc_stripe_worker(void *data)
+{
+    CSC_STRIPE_POOL *pool = (CSC_STRIPE_POOL *)data;
+    CSC_STRIPE stripe;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->exit && (pool->next >= pool->count))
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+
+        if (pool->exit)
+            break;
+
+        stripe.index = pool->next++;
+        stripe.count = pool->count;
+
+        pthread_mutex_unlock(&pool->lock);
+        pool->func(pool->arg, &stripe);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done_cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+void *csc_stripe_pool_create(
+    unsigned int thread_count)
+{
+    CSC_STRIPE_POOL *pool;
+    unsigned int i;
+
+    if (thread_count < 1)
+        thread_count = 1;
+    if (thread_count > CSC_STRIPE_MAX_THREADS)
+        thread_count = CSC_STRIPE_MAX_THREADS;
+
+    pool = (CSC_STRIPE_POOL *)malloc(sizeof(CSC_STRIPE_POOL));
+    if (pool == NULL)
+        return NULL;
+
+    memset(pool, 0, sizeof(CSC_STRIPE_POOL));
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    /* stripe 0 is done by the caller */
+    pool->thread_count = 1;
+    for (i = 1; i < thread_count; i++) {
+        if (pthread_create(&pool->threads[i], NULL, csc_stripe_worker, pool) != 0) {
+            ALOGE("%s:: failed to create worker %u, use %u threads", __func__, i, pool->thread_count);
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    return (void *)pool;
+}
+
+void csc_stripe_pool_destroy(
+    void *handle)
+{
+    CSC_STRIPE_POOL *pool = (CSC_STRIPE_POOL *)handle;
+    unsigned int i;
+
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->exit = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 1; i < pool->thread_count; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+void csc_stripe_pool_run(
+    void            *handle,
+    unsigned int     count,
+    CSC_STRIPE_FUNC  func,
+    void            *arg)
+{
+    CSC_STRIPE_POOL *pool = (CSC_STRIPE_POOL *)handle;
+    CSC_STRIPE stripe;
+
+    if ((pool == NULL) || (count > pool->thread_count))
+        count = (pool == NULL) ? 1 : pool->thread_count;
+    if (count < 1)
+        count = 1;
+
+    stripe.index = 0;
+    stripe.count = count;
+
+    if (count == 1) {
+        func(arg, &stripe);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->func = func;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 1;
+    pool->pending = count - 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    func(arg, &stripe);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+unsigned int csc_stripe_start(
+    const CSC_STRIPE *stripe,
+    unsigned int      rows,
+    unsigned int      align)
+{
+    unsigned long long units = (rows + align - 1) / align;
+    unsigned int start = (unsigned int)((units * stripe->index / stripe->count) * align);
+
+    return (start < rows) ? start : rows;
+}
+
+unsigned int csc_stripe_end(
+    const CSC_STRIPE *stripe,
+    unsigned int      rows,
+    unsigned int      align)
+{
+    unsigned long long units = (rows + align - 1) / align;
+    unsigned int end = (unsigned int)((units * (stripe->index + 1) / stripe->count) * align);
+
+    return (end < rows) ? end : rows;
+}
+
+void csc_stripe_memcpy(
+    const CSC_STRIPE *stripe,
+    void             *dst,
+    const void       *src,
+    size_t            size)
+{
+    /* 64 byte chunks keep stripes on separate cache lines */
+    size_t chunks = (size + 63) / 64;
+    size_t start = (chunks * stripe->index / stripe->count) * 64;
+    size_t end = (chunks * (stripe->index + 1) / stripe->count) * 64;
+
+    if (end > size)
+        end = size;
+    if (start >= end)
+        return;
+
+    memcpy((char *)dst + start, (const char *)src + start, end - start);
+}
+
+void csc_stripe_interleave_memcpy(
+    const CSC_STRIPE *stripe,
+    unsigned char    *dest,
+    unsigned char    *src1,
+    unsigned char    *src2,
+    unsigned int      src_size)
+{
+    unsigned int start = csc_stripe_start(stripe, src_size, 64);
+    unsigned int end = csc_stripe_end(stripe, src_size, 64);
+
+    if (start >= end)
+        return;
+
+    csc_interleave_memcpy(dest + (start * 2), src1 + start, src2 + start, end - start);
+}
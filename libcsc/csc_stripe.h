@@ -0,0 +1,97 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        csc_stripe.h
+ *
+ * @brief       worker pool splitting software conversions into row stripes
+ *
+ * @version     1.0.0
+ */
+
+#ifndef CSC_STRIPE_H
+#define CSC_STRIPE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CSC_STRIPE_MAX_THREADS 8
+
+typedef struct _CSC_STRIPE {
+    unsigned int index;
+    unsigned int count;
+} CSC_STRIPE;
+
+typedef void (*CSC_STRIPE_FUNC)(void *arg, const CSC_STRIPE *stripe);
+
+/*
+ * Create a pool of thread_count - 1 workers.
+ * The thread calling csc_stripe_pool_run() always takes stripe 0.
+ */
+void *csc_stripe_pool_create(
+    unsigned int thread_count);
+
+void csc_stripe_pool_destroy(
+    void *pool);
+
+/*
+ * Run func for stripes 0 .. count - 1 and wait for all of them.
+ * count is clamped to the thread count of the pool.
+ */
+void csc_stripe_pool_run(
+    void            *pool,
+    unsigned int     count,
+    CSC_STRIPE_FUNC  func,
+    void            *arg);
+
+/*
+ * First and last(exclusive) row of a plane with 'rows' lines owned by stripe.
+ * Boundaries are multiples of align, so tiles or 2x2 chroma blocks are never split.
+ */
+unsigned int csc_stripe_start(
+    const CSC_STRIPE *stripe,
+    unsigned int      rows,
+    unsigned int      align);
+
+unsigned int csc_stripe_end(
+    const CSC_STRIPE *stripe,
+    unsigned int      rows,
+    unsigned int      align);
+
+/* memcpy of the part of [0, size) owned by stripe */
+void csc_stripe_memcpy(
+    const CSC_STRIPE *stripe,
+    void             *dst,
+    const void       *src,
+    size_t            size);
+
+/* csc_interleave_memcpy of the part of [0, src_size) owned by stripe */
+void csc_stripe_interleave_memcpy(
+    const CSC_STRIPE *stripe,
+    unsigned char    *dest,
+    unsigned char    *src1,
+    unsigned char    *src2,
+    unsigned int      src_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -21,7 +21,7 @@
 
 #include <hardware/exynos/hdr10pMetaInterface.h>
 
-#define HDR_IF_VER      (1.1)
+#define HDR_IF_VER      (1.2)
 
 enum RenderSource {
     REND_ORI = 0,
@@ -81,6 +81,11 @@ struct HdrLayerInfo {
     bool bypass;
 };
 
+enum HdrCoefMode {
+    HDR_COEF_FULL = 0,  /* every coef group of the layer */
+    HDR_COEF_DELTA,     /* only the groups changed since the last coef data of the layer */
+};
+
 enum DebugMode {
     OFF = 0,
     BYPASS_OFF,
@@ -118,6 +123,13 @@ public:
     // debug phase
     virtual void setLogLevel(int __attribute__((unused)) log_level) {}
     virtual void setDebugMode(enum DebugMode __attribute__((unused)) debug_mode) {}
+
+    // appended to keep the vtable of the earlier virtuals
+    // HDR_COEF_DELTA leaves out the groups the hw already has, ask HDR_COEF_FULL again when it lost them
+    virtual int getHdrCoefDataByMode(enum HdrHwId hw_id, int layer_index,
+                             struct hdrCoefParcel *parcel, enum HdrCoefMode __attribute__((unused)) mode) {
+        return getHdrCoefData(hw_id, layer_index, parcel);
+    }
 };
 
 #endif /* __HDR_INTERFACE_H__ */
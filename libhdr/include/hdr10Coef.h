@@ -4,6 +4,7 @@
 #include "libhdr_parcel_header.h"
 #include "hdrUtil.h"
 #include "hdrHwInfo.h"
+#include "hdrCoefCache.h"
 #include <algorithm>
 
 struct hdr10Node {
@@ -31,6 +32,10 @@ private:
     std::unordered_map<int, struct hdr10Module> layerToHdr10Mod;
     void parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx);
     void __parse__(int hw_id, struct hdrContext *ctx);
+    bool parseXml(int hw_id, const std::string &fn);
+    bool loadCache(int hw_id, const std::string &fn, const std::string &blob);
+    void serialize(hdrCoefCacheWriter &out);
+    bool deserialize(hdrCoefCacheReader &in);
     void parse_hdr10Mods(
         int hw_id,
         xmlDocPtr xml_doc,
@@ -73,6 +78,8 @@ public:
     int coefBuildup(int layer_index,
                 struct hdrContext *out);
     void init(struct hdrContext *ctx);
+    bool compileCache(hdrHwInfo *hwInfo, int hw_id,
+                const std::string &lut, const std::string &blob, bool verify);
 };
 
 #endif
@@ -0,0 +1,88 @@
+#ifndef __HDR_COEF_CACHE_H__
+#define __HDR_COEF_CACHE_H__
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "libhdr_parcel_header.h"
+#include "hdrUtil.h"
+
+/*
+ * Prepacked coefficients of a LUT xml, written by hdr_coef_compiler through
+ * compileCache() of each coef class and read back by its loadCache().
+ * The blob sits next to its xml ("hdr10Lut.xml" -> "hdr10Lut.bin") and is
+ * loaded instead of the xml as long as it was built by this version from
+ * the same hw xml, the packing depends on it, and the xml is not newer
+ * than the blob and still has the size it was packed from. The xml itself
+ * is not read, that is what the blob saves.
+ *
+ * layout : header | body
+ * body   : 32 bit words, written and read in the same order by the
+ *          serialize()/deserialize() of each coef class
+ */
+#define HDR_COEF_CACHE_MAGIC    0x46454F43  /* "COEF" */
+#define HDR_COEF_CACHE_VERSION  2
+
+/* also the option values of hdr_coef_compiler, so none is 0 */
+enum hdrCoefCacheKind {
+    HDR_COEF_CACHE_WCG = 1,
+    HDR_COEF_CACHE_HDR10,
+    HDR_COEF_CACHE_HDR10P,
+    HDR_COEF_CACHE_HLG,
+};
+
+struct hdrCoefCacheHeader {
+    u32 magic;
+    u32 version;
+    u32 kind;
+    u32 hw_id;
+    uint64_t lut_size;
+    uint64_t hw_hash;
+    uint64_t body_hash;
+    u32 body_size;
+    u32 reserved;
+};
+
+uint64_t hdrCoefHash(const void *data, size_t size);
+/* false if the file can not be read */
+bool hdrCoefHashFile(const std::string &path, uint64_t &hash);
+/* false if the file can not be read */
+bool hdrCoefFileSize(const std::string &path, uint64_t &size);
+/* "hdr10Lut.xml" -> "hdr10Lut.bin", ".bin" is appended to other names */
+std::string hdrCoefCacheName(const std::string &lut);
+
+class hdrCoefCacheWriter {
+private:
+    std::vector<u32> body;
+public:
+    void putInt(int v);
+    void putString(const std::string &s);
+    void putDat(const struct hdr_dat_node &dat);
+    const std::vector<u32> &getBody(void) { return body; }
+    bool write(const std::string &blob, int kind, int hw_id,
+            uint64_t lut_size, uint64_t hw_hash);
+};
+
+class hdrCoefCacheReader {
+private:
+    void *map = NULL;
+    size_t mapSize = 0;
+    const u32 *body = NULL;
+    size_t bodyWords = 0;
+    size_t pos = 0;
+    bool error = false;
+public:
+    ~hdrCoefCacheReader();
+    /* false if the blob is missing, broken or stale against lut */
+    bool open(const std::string &blob, const std::string &lut,
+            int kind, int hw_id, uint64_t hw_hash);
+    void close(void);
+    bool getInt(int &v);
+    /* a count of items that still fit in the body */
+    bool getCount(int &n);
+    bool getString(std::string &s);
+    bool getDat(struct hdr_dat_node &dat);
+    /* every word was read and none was out of bounds */
+    bool done(void) { return !error && pos == bodyWords; }
+};
+
+#endif
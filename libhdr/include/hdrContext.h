@@ -52,6 +52,9 @@ struct _HdrLayerInfo_ {
     unsigned int max_cll = 0;
     /* dynamic meta */
     ExynosHdrDynamicInfo_t dyn_meta;
+    /* dynamic meta as given by the last change, to tell a repeated one */
+    bool has_raw_dyn_meta = false;
+    ExynosHdrDynamicInfo raw_dyn_meta;
     /* final src lum by static/dynamic meta combination */
     unsigned int source_luminance = 0;
 
@@ -66,6 +69,17 @@ struct _HdrLayerInfo_ {
     std::list<struct hdr_dat_node*> need;
     std::unordered_map<int, struct hdr_dat_node> group[HDR_HW_MAX];
 
+    /* coef data given by the last getHdrCoefData, by byte_offset, for HDR_COEF_DELTA */
+    struct sentCoef {
+        std::vector<char> data; /* every group at the offset, in the order given */
+        size_t pos = 0;
+        unsigned int serial = 0;
+        bool dirty = false;
+    };
+    std::unordered_map<unsigned int, struct sentCoef> sent;
+    unsigned int sent_serial = 0;
+    bool sent_delta = false; /* the last coef data written was HDR_COEF_DELTA */
+
     bool compare_matrix(float (*mat1)[4], float (*mat2)[4]);
     void refineTransfer(int &ids);
     void printDynamicMeta(ExynosHdrDynamicInfo_t *dyn_meta, std::string opt = "");
@@ -76,7 +90,9 @@ struct _HdrLayerInfo_ {
     void transfer(void);
     void setActive (void);
     void setInActive (void);
-    int getHdrCoefData(void *hdrCoef);
+    int getHdrCoefData(void *hdrCoef, enum HdrCoefMode mode = HDR_COEF_FULL);
+    void updateSent(void);
+    bool isSent(struct hdr_dat_node *dat);
     int getCoefSize (void);
     void clean_duplicate (void);
     void dump_changed(struct HdrLayerInfo *lInfo);
@@ -113,8 +129,13 @@ struct hdrContext {
     unsigned int source_luminance = 0;
     unsigned int target_luminance[HdrTargetLuminanceType::MAX] = {0};
     class hdrModuleSpecifiers moduleSpecifiers;
-    class hdrMetaInterface* metaIf;
+    class hdrMetaInterface* metaIf = nullptr;
 
+    hdrContext() = default;
+    /* metaIf is owned and the layers point back to the context */
+    hdrContext(const hdrContext &) = delete;
+    hdrContext &operator=(const hdrContext &) = delete;
+    ~hdrContext();
     void init (class hdrHwInfo *hwInfo);
     std::string getTargetName(void);
     int getOSVersion(void);
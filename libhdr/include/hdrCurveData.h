@@ -27,6 +27,9 @@
 #define META_JSON_2094_EBZ_KNEE_POINT_BITS       12
 #define META_JSON_2094_EBZ_KNEE_POINT_MAX        ((1 << META_JSON_2094_EBZ_KNEE_POINT_BITS)-1)
 
+/* default number of generated curves kept, see setCurveCacheSize() */
+#define CURVE_CACHE_ENTRIES                      32
+
 #define META_MAX_PSLL_SIZE                       15
 #define META_MAX_PCOEFF_SIZE                     14
 
@@ -119,4 +122,8 @@ void genTMCurve(CurveInfo info,
 void genEOTFCurve(CurveInfo info,
                         std::vector<int> &arrX, std::vector<int> &arrY,
                         int numArray, int x_bits, int y_bits, int minx_bits);
+/* generated curves kept for the same inputs, 0 turns the cache off */
+void setCurveCacheSize(unsigned int entries);
+/* drops the curves computed by the interface, before it is destroyed */
+void releaseCurveMetaIf(class hdrMetaInterface *metaIf);
 #endif
@@ -3,6 +3,7 @@
 #include <hardware/exynos/hdrInterface.h>
 #include <unordered_map>
 #include <string>
+#include <stdint.h>
 #include "hdrHwDPU.h"
 
 struct supportedHdrHw {
@@ -26,9 +27,14 @@ private:
     std::unordered_map<int, std::string> idToStrId;
     std::unordered_map<int, std::string> idToFileName;
     std::unordered_map<int ,IHdrHw*> idToIHdr;
+    std::unordered_map<int, uint64_t> idToHash;
 public:
+    /* hw xml read by init() instead of the one on the device */
+    void setHwInfoFile(int hw_id, const std::string &file);
     void init(void);
     IHdrHw *getIf (int hw_id);
+    /* content hash of the hw xml, 0 if it could not be read */
+    uint64_t getHwHash(int hw_id);
     std::vector<struct supportedHdrHw> *getListHdrHw(void);
 };
 
@@ -213,6 +213,9 @@ struct hdr_dat_node {
     }
 };
 
+/* optional_flag of hdr_coef_header */
+#define HDR_COEF_FLAG_DELTA     (1 << 0)    /* groups not listed keep the value of the last coef data */
+
 struct hdr_coef_header {
     unsigned int total_bytesize;
     union hdr_coef_header_type {
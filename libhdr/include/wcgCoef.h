@@ -6,6 +6,7 @@
 #include "libhdr_parcel_header.h"
 #include "hdrUtil.h"
 #include "hdrHwInfo.h"
+#include "hdrCoefCache.h"
 
 class wcgCoef {
 private:
@@ -346,8 +347,16 @@ private:
 
     hdrHwInfo *hwInfo = NULL;
 
+    void initStrMaps(void);
     void parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx);
     void __parse__(int hw_id, struct hdrContext *ctx);
+    bool parseXml(int hw_id, const std::string &fn);
+    bool loadCache(int hw_id, const std::string &fn, const std::string &blob);
+    /* the raw coefficients kept for dump() are not in the blob */
+    void serialize(hdrCoefCacheWriter &out);
+    void serialize_wcgMod(hdrCoefCacheWriter &out, struct wcgModule &wcg_module);
+    bool deserialize(hdrCoefCacheReader &in);
+    bool deserialize_wcgMod(hdrCoefCacheReader &in, struct wcgModule &wcg_module);
     void parse_wcgMods(
         int hw_id,
         xmlDocPtr xml_doc,
@@ -411,6 +420,8 @@ public:
                 struct hdrContext *ctx);
     int coefBuildup(int layer_index,
                 struct hdrContext *out);
+    bool compileCache(hdrHwInfo *hwInfo, int hw_id,
+                const std::string &lut, const std::string &blob, bool verify);
 };
 
 #endif
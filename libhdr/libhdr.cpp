@@ -119,6 +119,12 @@ int hdrImplementation::setLayerInfo(int __attribute__((unused)) layer_index,
 int hdrImplementation::getHdrCoefData(enum HdrHwId __attribute__((unused)) hw_id,
                             int __attribute__((unused)) layer_index,
                             struct hdrCoefParcel __attribute__((unused)) *parcel)
+{
+    return getHdrCoefDataByMode(hw_id, layer_index, parcel, HDR_COEF_FULL);
+}
+
+int hdrImplementation::getHdrCoefDataByMode(enum HdrHwId hw_id, int layer_index,
+                            struct hdrCoefParcel *parcel, enum HdrCoefMode mode)
 {
     LIBHDR_LOGD(Ctx.log_level, "%s +", __func__);
     if (Ctx.state < hdrPerFrameState::BUILD_UP_READY)
@@ -128,7 +134,7 @@ int hdrImplementation::getHdrCoefData(enum HdrHwId __attribute__((unused)) hw_id
     if (layer_info->state != hdrPerLayerState::BUILD_UP_READY)
         return HDR_ERR_INVAL;
     LIBHDR_LOGD(Ctx.log_level, "%s -", __func__);
-    return Ctx.Layers[hw_id][layer_index].getHdrCoefData(parcel->hdrCoef);
+    return Ctx.Layers[hw_id][layer_index].getHdrCoefData(parcel->hdrCoef, mode);
 }
 
 void hdrImplementation::setLogLevel(int __attribute__((unused)) log_level)
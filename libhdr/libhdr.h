@@ -37,6 +37,9 @@ public:
                 struct hdrCoefParcel __attribute__((unused)) *parcel);
 
     void setLogLevel(int __attribute__((unused)) log_level);
+
+    int getHdrCoefDataByMode(enum HdrHwId hw_id, int layer_index,
+                struct hdrCoefParcel *parcel, enum HdrCoefMode mode);
 };
 
 #endif
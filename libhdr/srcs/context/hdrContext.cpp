@@ -1,4 +1,5 @@
 #include <hdrContext.h>
+#include "hdrCurveData.h"
 
 bool _HdrLayerInfo_::compare_matrix(float (*mat1)[4], float (*mat2)[4])
 {
@@ -135,9 +136,12 @@ bool _HdrLayerInfo_::changed(struct HdrLayerInfo *lInfo) {
                 goto changed;
         }
 
-    if (lInfo->dynamic_metadata)
-        if (lInfo->dynamic_len == sizeof(ExynosHdrDynamicInfo))
+    if (lInfo->dynamic_metadata && lInfo->dynamic_len == sizeof(ExynosHdrDynamicInfo)) {
+        if (this->has_raw_dyn_meta == false ||
+                memcmp(&this->raw_dyn_meta, lInfo->dynamic_metadata, sizeof(ExynosHdrDynamicInfo)))
             goto changed;
+    } else if (this->has_raw_dyn_meta == true)
+        goto changed;
 
     this->transfer();
     return false;
@@ -161,8 +165,11 @@ void _HdrLayerInfo_::save(int layer_index, struct HdrLayerInfo *lInfo) {
             this->mastering_luminance = (unsigned int)(((ExynosHdrStaticInfo*)lInfo->static_metadata)->sType1.mMaxDisplayLuminance / 10000);
             this->max_cll = (unsigned int)(((ExynosHdrStaticInfo*)lInfo->static_metadata)->sType1.mMaxContentLightLevel);
         }
+    this->has_raw_dyn_meta = false;
     if (lInfo->dynamic_metadata && lInfo->dynamic_len == sizeof(ExynosHdrDynamicInfo)) {
         ExynosHdrDynamicInfo out_metadata;
+        memcpy(&this->raw_dyn_meta, lInfo->dynamic_metadata, sizeof(ExynosHdrDynamicInfo));
+        this->has_raw_dyn_meta = true;
         if (ctx->metaIf != nullptr && ctx->metaIf->convertHDR10pMeta(
                     (ExynosHdrDynamicInfo*)lInfo->dynamic_metadata,
                     sizeof(ExynosHdrDynamicInfo),
@@ -215,42 +222,52 @@ void _HdrLayerInfo_::setInActive (void) {
     this->active = false;
 }
 
-int _HdrLayerInfo_::getHdrCoefData(void *hdrCoef) {
+int _HdrLayerInfo_::getHdrCoefData(void *hdrCoef, enum HdrCoefMode mode) {
     char *dat = (char*)hdrCoef;
-    int wr_offset = 0;
+    int wr_offset = sizeof(struct hdr_coef_header);
     struct hdr_coef_header header_g;
-    unsigned int total_bytesize = sizeof(struct hdr_coef_header);
     unsigned int _shall = 0, _need = 0;
+    bool delta = (mode == HDR_COEF_DELTA);
+    /* a full dump replaces the delta left in the fd even if nothing changed */
+    bool write = this->layer_changed || (delta == false && sent_delta == true);
 
     clean_duplicate();
-    for (auto iter = this->shall.begin(); iter != this->shall.end(); iter++) {
+    /* full dumps only keep track once the layer has asked for a delta */
+    if (write && (delta == true || sent.empty() == false))
+        updateSent();
+
+    for (auto iter = shall.begin(); iter != shall.end(); iter++) {
+        if (delta && isSent(*iter))
+            continue;
+        if (write)
+            (*iter)->serialize(dat, wr_offset, (*iter)->size());
+        wr_offset += (*iter)->size();
         _shall++;
-        total_bytesize += (*iter)->size();
     }
     for (auto iter = need.begin(); iter != need.end(); iter++) {
+        if (delta && isSent(*iter))
+            continue;
+        if (write)
+            (*iter)->serialize(dat, wr_offset, (*iter)->size());
+        wr_offset += (*iter)->size();
         _need++;
-        total_bytesize += (*iter)->size();
     }
-    header_g.init(total_bytesize, this->layer_index,
+
+    header_g.init(wr_offset, this->layer_index,
             log_level,
             (unsigned int)this->premult_alpha,
             (unsigned int)this->active,
             _shall, _need);
+    if (delta)
+        header_g.type.unpack.optional_flag |= HDR_COEF_FLAG_DELTA;
 
-    if (this->layer_changed) {
+    if (write) {
         /* copy layer info to fd */
-        memcpy(dat + wr_offset, &header_g, sizeof(header_g));
-        wr_offset += sizeof(header_g);
-
-        for (auto iter = shall.begin(); iter != shall.end(); iter++) {
-            (*iter)->serialize(dat, wr_offset, (*iter)->size());
-            wr_offset+=(*iter)->size();
-        }
-
-        for (auto iter = need.begin(); iter != need.end(); iter++) {
-            (*iter)->serialize(dat, wr_offset, (*iter)->size());
-            wr_offset+=(*iter)->size();
-        }
+        memcpy(dat, &header_g, sizeof(header_g));
+        sent_delta = delta;
+        /* the hw may drop the coef of an inactive layer */
+        if (this->active != true)
+            sent.clear();
     }
 
     if (log_level > 1) {
@@ -263,6 +280,54 @@ int _HdrLayerInfo_::getHdrCoefData(void *hdrCoef) {
     return HDR_ERR_NO;
 }
 
+/*
+ * Compares the coef data of this call with the one given last time.
+ * Groups sharing a byte_offset are compared as one, the hw ends up with
+ * the last of them only if all of them are written again.
+ */
+void _HdrLayerInfo_::updateSent(void) {
+    std::list<struct hdr_dat_node*> *lists[] = {&shall, &need};
+
+    sent_serial++;
+    for (auto list : lists) {
+        for (auto iter = list->begin(); iter != list->end(); iter++) {
+            struct sentCoef &s = sent[(*iter)->header.byte_offset];
+            size_t len = (*iter)->header.length * 4;
+
+            if (s.serial != sent_serial) {
+                s.serial = sent_serial;
+                s.pos = 0;
+                s.dirty = false;
+            }
+            if (s.dirty == false && (s.pos + len > s.data.size() ||
+                        memcmp(s.data.data() + s.pos, (*iter)->data, len)))
+                s.dirty = true;
+            if (s.dirty == true) {
+                s.data.resize(s.pos + len);
+                memcpy(s.data.data() + s.pos, (*iter)->data, len);
+            }
+            s.pos += len;
+        }
+    }
+
+    for (auto iter = sent.begin(); iter != sent.end();) {
+        if (iter->second.serial != sent_serial) {
+            iter = sent.erase(iter);
+            continue;
+        }
+        if (iter->second.pos != iter->second.data.size()) {
+            iter->second.data.resize(iter->second.pos);
+            iter->second.dirty = true;
+        }
+        iter++;
+    }
+}
+
+bool _HdrLayerInfo_::isSent(struct hdr_dat_node *dat) {
+    auto iter = sent.find(dat->header.byte_offset);
+    return (iter != sent.end() && iter->second.dirty == false);
+}
+
 int _HdrLayerInfo_::getCoefSize (void) {
     int size = sizeof(struct hdr_coef_header);
     for (auto iter = shall.begin(); iter != shall.end(); ++iter)
@@ -327,12 +392,19 @@ void _HdrLayerInfo_::setLogLevel(int log_level) {
     this->log_level = log_level;
 }
 
+hdrContext::~hdrContext() {
+    /* curves computed by the tone mapper of the plugin go with it */
+    releaseCurveMetaIf(metaIf);
+    delete metaIf;
+}
+
 void hdrContext::init (class hdrHwInfo *hwInfo) {
     Target.dataspace = -1;
     target_name = this->getTargetName();
     std::vector<struct supportedHdrHw> *hwList = hwInfo->getListHdrHw();
     this->OS_Version = this->getOSVersion();
-    metaIf = hdrMetaInterface::createInstance();
+    if (metaIf == nullptr)
+        metaIf = hdrMetaInterface::createInstance();
     moduleSpecifiers.init(hwInfo);
     for (auto iter = hwList->begin(); iter != hwList->end(); iter++) {
         Layers[iter->id].clear();
@@ -92,18 +92,16 @@ void hdr10Coef::parse_hdr10Mods(
     }
 }
 
-void hdr10Coef::__parse__(int hw_id, struct hdrContext *ctx)
+bool hdr10Coef::parseXml(int hw_id, const std::string &fn)
 {
     xmlDocPtr doc;
     xmlNodePtr root;
 
-    std::string fn_target = hdr10info.getFileName(&ctx->Target);
-
-    doc = xmlParseFile(fn_target.c_str());
+    doc = xmlParseFile(fn.c_str());
     if (doc == NULL) {
         ALOGD("no document or can not parse the document(%s)",
-                fn_target.c_str());
-        goto ret;
+                fn.c_str());
+        return false;
     }
 
     root = xmlDocGetRootElement(doc);
@@ -123,8 +121,83 @@ free_root:
     //xmlFree(root);
 free_doc:
     xmlFreeDoc(doc);
-ret:
-    return;
+    return true;
+}
+
+void hdr10Coef::serialize(hdrCoefCacheWriter &out)
+{
+    std::vector<int> layers;
+
+    /* in layer order, the same tables give the same blob */
+    for (auto &mod : layerToHdr10Mod)
+        layers.push_back(mod.first);
+    std::sort(layers.begin(), layers.end());
+
+    out.putInt(layers.size());
+    for (auto layer : layers) {
+        out.putInt(layer);
+        out.putInt(layerToHdr10Mod[layer].hdr10NodeTable.size());
+        for (auto &node : layerToHdr10Mod[layer].hdr10NodeTable) {
+            out.putInt(node.max_luminance);
+            out.putInt(node.coef_packed.size());
+            for (auto &dat : node.coef_packed)
+                out.putDat(dat);
+        }
+    }
+}
+
+bool hdr10Coef::deserialize(hdrCoefCacheReader &in)
+{
+    std::unordered_map<int, struct hdr10Module> table;
+    int num_mods, num_nodes, num_dats;
+
+    if (!in.getCount(num_mods))
+        return false;
+    for (int i = 0; i < num_mods; i++) {
+        int modId;
+        struct hdr10Module hdr10Mod;
+        if (!in.getInt(modId) || !in.getCount(num_nodes))
+            return false;
+        hdr10Mod.hdr10NodeTable.resize(num_nodes);
+        for (auto &node : hdr10Mod.hdr10NodeTable) {
+            if (!in.getInt(node.max_luminance) || !in.getCount(num_dats))
+                return false;
+            node.coef_packed.resize(num_dats);
+            for (auto &dat : node.coef_packed) {
+                if (!in.getDat(dat))
+                    return false;
+            }
+        }
+        table.insert(make_pair(modId, hdr10Mod));
+    }
+    if (!in.done())
+        return false;
+
+    for (auto &mod : table)
+        layerToHdr10Mod.insert(mod);
+    return true;
+}
+
+bool hdr10Coef::loadCache(int hw_id, const std::string &fn, const std::string &blob)
+{
+    hdrCoefCacheReader in;
+
+    if (!in.open(blob, fn, HDR_COEF_CACHE_HDR10, hw_id, hwInfo->getHwHash(hw_id)))
+        return false;
+    if (!deserialize(in)) {
+        ALOGE("can not load %s, falling back to %s", blob.c_str(), fn.c_str());
+        return false;
+    }
+    return true;
+}
+
+void hdr10Coef::__parse__(int hw_id, struct hdrContext *ctx)
+{
+    std::string fn_target = hdr10info.getFileName(&ctx->Target);
+
+    if (loadCache(hw_id, fn_target, hdrCoefCacheName(fn_target)))
+        return;
+    parseXml(hw_id, fn_target);
 }
 
 void hdr10Coef::parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
@@ -148,6 +221,38 @@ void hdr10Coef::parse(hdrHwInfo *hwInfo, struct hdrContext *ctx)
     //this->dump();
 }
 
+bool hdr10Coef::compileCache(hdrHwInfo *hwInfo, int hw_id,
+        const std::string &lut, const std::string &blob, bool verify)
+{
+    hdrCoefCacheWriter out;
+    uint64_t lut_size;
+
+    this->hwInfo = hwInfo;
+    layerToHdr10Mod.clear();
+    if (!hdrCoefFileSize(lut, lut_size) || !parseXml(hw_id, lut))
+        return false;
+
+    serialize(out);
+    if (!out.write(blob, HDR_COEF_CACHE_HDR10, hw_id, lut_size, hwInfo->getHwHash(hw_id)))
+        return false;
+
+    if (verify) {
+        /* the blob gives back the tables of the xml */
+        hdr10Coef loaded;
+        hdrCoefCacheWriter reloaded;
+
+        loaded.hwInfo = hwInfo;
+        if (!loaded.loadCache(hw_id, lut, blob))
+            return false;
+        loaded.serialize(reloaded);
+        if (reloaded.getBody() != out.getBody()) {
+            ALOGE("%s does not match %s", blob.c_str(), lut.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 void hdr10Coef::tm_coefBuildup(int hw_id, int layer_index,
         struct _HdrLayerInfo_ *layer,
         struct hdrContext *ctx,
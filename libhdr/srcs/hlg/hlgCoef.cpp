@@ -88,18 +88,16 @@ void hlgCoef::parse_hlgMods(
     }
 }
 
-void hlgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+bool hlgCoef::parseXml(int hw_id, const std::string &fn)
 {
     xmlDocPtr doc;
     xmlNodePtr root;
 
-    std::string fn_target = hlginfo.getFileName(&ctx->Target);
-
-    doc = xmlParseFile(fn_target.c_str());
+    doc = xmlParseFile(fn.c_str());
     if (doc == NULL) {
         ALOGD("no document or can not parse the document(%s)",
-                fn_target.c_str());
-        goto ret;
+                fn.c_str());
+        return false;
     }
 
     root = xmlDocGetRootElement(doc);
@@ -119,8 +117,81 @@ free_root:
     //xmlFree(root);
 free_doc:
     xmlFreeDoc(doc);
-ret:
-    return;
+    return true;
+}
+
+void hlgCoef::serialize(hdrCoefCacheWriter &out)
+{
+    std::vector<int> layers;
+
+    for (auto &mod : layerToHlgMod)
+        layers.push_back(mod.first);
+    std::sort(layers.begin(), layers.end());
+
+    out.putInt(layers.size());
+    for (auto layer : layers) {
+        out.putInt(layer);
+        out.putInt(layerToHlgMod[layer].hlgNodeTable.size());
+        for (auto &node : layerToHlgMod[layer].hlgNodeTable) {
+            out.putInt(node.coef_packed.size());
+            for (auto &dat : node.coef_packed)
+                out.putDat(dat);
+        }
+    }
+}
+
+bool hlgCoef::deserialize(hdrCoefCacheReader &in)
+{
+    std::unordered_map<int, struct hlgModule> table;
+    int num_mods, num_nodes, num_dats;
+
+    if (!in.getCount(num_mods))
+        return false;
+    for (int i = 0; i < num_mods; i++) {
+        int modId;
+        struct hlgModule hlgMod;
+        if (!in.getInt(modId) || !in.getCount(num_nodes))
+            return false;
+        hlgMod.hlgNodeTable.resize(num_nodes);
+        for (auto &node : hlgMod.hlgNodeTable) {
+            if (!in.getCount(num_dats))
+                return false;
+            node.coef_packed.resize(num_dats);
+            for (auto &dat : node.coef_packed) {
+                if (!in.getDat(dat))
+                    return false;
+            }
+        }
+        table.insert(make_pair(modId, hlgMod));
+    }
+    if (!in.done())
+        return false;
+
+    for (auto &mod : table)
+        layerToHlgMod.insert(mod);
+    return true;
+}
+
+bool hlgCoef::loadCache(int hw_id, const std::string &fn, const std::string &blob)
+{
+    hdrCoefCacheReader in;
+
+    if (!in.open(blob, fn, HDR_COEF_CACHE_HLG, hw_id, hwInfo->getHwHash(hw_id)))
+        return false;
+    if (!deserialize(in)) {
+        ALOGE("can not load %s, falling back to %s", blob.c_str(), fn.c_str());
+        return false;
+    }
+    return true;
+}
+
+void hlgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+{
+    std::string fn_target = hlginfo.getFileName(&ctx->Target);
+
+    if (loadCache(hw_id, fn_target, hdrCoefCacheName(fn_target)))
+        return;
+    parseXml(hw_id, fn_target);
 }
 
 void hlgCoef::parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
@@ -144,6 +215,37 @@ void hlgCoef::parse(hdrHwInfo *hwInfo, struct hdrContext *ctx)
     //this->dump();
 }
 
+bool hlgCoef::compileCache(hdrHwInfo *hwInfo, int hw_id,
+        const std::string &lut, const std::string &blob, bool verify)
+{
+    hdrCoefCacheWriter out;
+    uint64_t lut_size;
+
+    this->hwInfo = hwInfo;
+    layerToHlgMod.clear();
+    if (!hdrCoefFileSize(lut, lut_size) || !parseXml(hw_id, lut))
+        return false;
+
+    serialize(out);
+    if (!out.write(blob, HDR_COEF_CACHE_HLG, hw_id, lut_size, hwInfo->getHwHash(hw_id)))
+        return false;
+
+    if (verify) {
+        hlgCoef loaded;
+        hdrCoefCacheWriter reloaded;
+
+        loaded.hwInfo = hwInfo;
+        if (!loaded.loadCache(hw_id, lut, blob))
+            return false;
+        loaded.serialize(reloaded);
+        if (reloaded.getBody() != out.getBody()) {
+            ALOGE("%s does not match %s", blob.c_str(), lut.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 void hlgCoef::tm_coefBuildup(int hw_id, int layer_index,
         struct _HdrLayerInfo_ *layer,
         struct tonemapModuleSpecifier *tmModSpecifier)
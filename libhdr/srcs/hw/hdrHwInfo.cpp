@@ -1,8 +1,17 @@
 #include "hdrHwInfo.h"
 #include "hdrUtil.h"
+#include "hdrCoefCache.h"
 
 using namespace std;
 
+void hdrHwInfo::setHwInfoFile(int hw_id, const std::string &file)
+{
+    for (auto &item : listHdrHw) {
+        if (item.id == hw_id)
+            item.hdrHwInfoFile = file;
+    }
+}
+
 void hdrHwInfo::init(void)
 {
     for (int i = 0; i < listHdrHw.size(); i++) {
@@ -12,6 +21,10 @@ void hdrHwInfo::init(void)
         idToFileName[listHdrHw[i].id] = listHdrHw[i].hdrHwInfoFile;
 
         listHdrHw[i].IHw->parse(hdrHwInfoid, listHdrHw[i].hdrHwInfoFile);
+
+        uint64_t hash = 0;
+        hdrCoefHashFile(listHdrHw[i].hdrHwInfoFile, hash);
+        idToHash[listHdrHw[i].id] = hash;
     }
 }
 
@@ -20,6 +33,11 @@ IHdrHw *hdrHwInfo::getIf (int hw_id)
     return idToIHdr[hw_id];
 }
 
+uint64_t hdrHwInfo::getHwHash(int hw_id)
+{
+    return idToHash[hw_id];
+}
+
 std::vector<struct supportedHdrHw> *hdrHwInfo::getListHdrHw(void)
 {
     return &listHdrHw;
@@ -0,0 +1,281 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstring>
+#include "hdrCoefCache.h"
+
+using namespace std;
+
+/* FNV-1a */
+uint64_t hdrCoefHash(const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool hdrCoefHashFile(const std::string &path, uint64_t &hash)
+{
+    struct stat st;
+    void *addr;
+    int fd;
+
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        hash = hdrCoefHash(NULL, 0);
+        return true;
+    }
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    hash = hdrCoefHash(addr, st.st_size);
+    munmap(addr, st.st_size);
+    return true;
+}
+
+bool hdrCoefFileSize(const std::string &path, uint64_t &size)
+{
+    struct stat st;
+
+    if (stat(path.c_str(), &st) < 0)
+        return false;
+    size = st.st_size;
+    return true;
+}
+
+/* a was modified after b */
+static bool isNewer(const struct stat &a, const struct stat &b)
+{
+    if (a.st_mtim.tv_sec != b.st_mtim.tv_sec)
+        return a.st_mtim.tv_sec > b.st_mtim.tv_sec;
+    return a.st_mtim.tv_nsec > b.st_mtim.tv_nsec;
+}
+
+std::string hdrCoefCacheName(const std::string &lut)
+{
+    const std::string ext = ".xml";
+
+    if (lut.size() > ext.size() &&
+            !lut.compare(lut.size() - ext.size(), ext.size(), ext))
+        return lut.substr(0, lut.size() - ext.size()) + ".bin";
+    return lut + ".bin";
+}
+
+void hdrCoefCacheWriter::putInt(int v)
+{
+    body.push_back((u32)v);
+}
+
+void hdrCoefCacheWriter::putString(const std::string &s)
+{
+    size_t words = (s.size() + 3) / 4;
+    size_t at = body.size();
+
+    putInt((int)s.size());
+    body.resize(at + 1 + words, 0);
+    memcpy(&body[at + 1], s.data(), s.size());
+}
+
+void hdrCoefCacheWriter::putDat(const struct hdr_dat_node &dat)
+{
+    putInt(dat.header.byte_offset);
+    putInt(dat.header.length);
+    putInt(dat.header.magic);
+    putInt(dat.group_id);
+    putInt(dat.data != NULL);
+    if (dat.data != NULL) {
+        size_t at = body.size();
+        body.resize(at + dat.header.length);
+        memcpy(&body[at], dat.data, dat.header.length * 4);
+    }
+}
+
+bool hdrCoefCacheWriter::write(const std::string &blob, int kind, int hw_id,
+        uint64_t lut_size, uint64_t hw_hash)
+{
+    struct hdrCoefCacheHeader header;
+    std::string tmp = blob + ".tmp";
+    size_t size = body.size() * sizeof(u32);
+    bool ok;
+    int fd;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = HDR_COEF_CACHE_MAGIC;
+    header.version = HDR_COEF_CACHE_VERSION;
+    header.kind = kind;
+    header.hw_id = hw_id;
+    header.lut_size = lut_size;
+    header.hw_hash = hw_hash;
+    header.body_hash = hdrCoefHash(body.data(), size);
+    header.body_size = size;
+
+    /* a reader never sees a half written blob */
+    fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ALOGE("can not create %s", tmp.c_str());
+        return false;
+    }
+    ok = (::write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) &&
+        (::write(fd, body.data(), size) == (ssize_t)size);
+    close(fd);
+
+    if (!ok || rename(tmp.c_str(), blob.c_str()) < 0) {
+        ALOGE("can not write %s", blob.c_str());
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+hdrCoefCacheReader::~hdrCoefCacheReader()
+{
+    close();
+}
+
+bool hdrCoefCacheReader::open(const std::string &blob, const std::string &lut,
+        int kind, int hw_id, uint64_t hw_hash)
+{
+    const struct hdrCoefCacheHeader *header;
+    struct stat st, lut_st;
+    int fd;
+
+    close();
+
+    fd = ::open(blob.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(*header)) {
+        ::close(fd);
+        ALOGE("%s is too small", blob.c_str());
+        return false;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        map = NULL;
+        return false;
+    }
+    mapSize = st.st_size;
+
+    header = (const struct hdrCoefCacheHeader *)map;
+    if (header->magic != HDR_COEF_CACHE_MAGIC ||
+            header->version != HDR_COEF_CACHE_VERSION ||
+            header->kind != (u32)kind || header->hw_id != (u32)hw_id ||
+            header->body_size != mapSize - sizeof(*header) ||
+            (header->body_size % sizeof(u32))) {
+        ALOGD("%s does not match this version or hw(%d)", blob.c_str(), hw_id);
+        goto fail;
+    }
+    if (header->hw_hash != hw_hash) {
+        ALOGD("%s is stale, the hw xml changed", blob.c_str());
+        goto fail;
+    }
+    if (stat(lut.c_str(), &lut_st) < 0 ||
+            header->lut_size != (uint64_t)lut_st.st_size || isNewer(lut_st, st)) {
+        ALOGD("%s is stale against %s", blob.c_str(), lut.c_str());
+        goto fail;
+    }
+
+    body = (const u32 *)(header + 1);
+    bodyWords = header->body_size / sizeof(u32);
+    if (header->body_hash != hdrCoefHash(body, header->body_size)) {
+        ALOGE("%s is broken", blob.c_str());
+        goto fail;
+    }
+    pos = 0;
+    error = false;
+    return true;
+
+fail:
+    close();
+    return false;
+}
+
+void hdrCoefCacheReader::close(void)
+{
+    if (map != NULL)
+        munmap(map, mapSize);
+    map = NULL;
+    mapSize = 0;
+    body = NULL;
+    bodyWords = 0;
+    pos = 0;
+    error = false;
+}
+
+bool hdrCoefCacheReader::getInt(int &v)
+{
+    if (error || pos >= bodyWords) {
+        error = true;
+        return false;
+    }
+    v = (int)body[pos++];
+    return true;
+}
+
+bool hdrCoefCacheReader::getCount(int &n)
+{
+    if (!getInt(n))
+        return false;
+    if (n < 0 || (size_t)n > bodyWords - pos) {
+        error = true;
+        return false;
+    }
+    return true;
+}
+
+bool hdrCoefCacheReader::getString(std::string &s)
+{
+    int len;
+
+    if (!getInt(len))
+        return false;
+    if (len < 0 || ((size_t)len + 3) / 4 > bodyWords - pos) {
+        error = true;
+        return false;
+    }
+    s.assign((const char *)&body[pos], len);
+    pos += (len + 3) / 4;
+    return true;
+}
+
+bool hdrCoefCacheReader::getDat(struct hdr_dat_node &dat)
+{
+    int byte_offset, length, magic, group_id, has_data;
+
+    if (!getInt(byte_offset) || !getInt(length) || !getInt(magic) ||
+            !getInt(group_id) || !getInt(has_data))
+        return false;
+
+    if (has_data) {
+        if (length < 0 || (size_t)length > bodyWords - pos) {
+            error = true;
+            return false;
+        }
+        dat.set_header(byte_offset, length);
+        memcpy(dat.data, &body[pos], length * 4);
+        pos += length;
+    } else {
+        dat.header.byte_offset = byte_offset;
+        dat.header.length = length;
+    }
+    dat.header.magic = magic;
+    dat.set_group_id(group_id);
+    return true;
+}
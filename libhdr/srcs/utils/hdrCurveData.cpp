@@ -19,6 +19,10 @@
 #include <vector>
 #include <set>
 #include <queue>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <cmath>
 
 #include <system/graphics.h>
@@ -57,13 +61,19 @@ public:
 class OETFCurveData : public curveData<ExynosHdrDynamicInfo_t> {
 public:
     OETFCurveData(ExynosHdrDynamicInfo_t &meta, int inputrange, int outputrange, int minx)
-        : curveData(meta, inputrange, outputrange, minx) {}
+        : curveData(meta, inputrange, outputrange, minx)
+    {
+        curveParam.setValues(info.data.tone_mapping.knee_point_x,
+                             info.data.tone_mapping.knee_point_y,
+                             info.data.tone_mapping.bezier_curve_anchors,
+                             info.data.tone_mapping.num_bezier_curve_anchors + 1,
+                             META_JSON_2094_EBZ_KNEE_POINT_MAX,
+                             META_JSON_2094_EBZ_PCOEFF_MAX);
+    }
     virtual ~OETFCurveData() {}
 
     int lookupTonemapGain(int px)
     {
-        static float powX[META_MAX_PCOEFF_SIZE];
-        static float powDX[META_MAX_PCOEFF_SIZE];
         static const float EBZ_COEFF[META_MAX_PCOEFF_SIZE + 2][META_MAX_PCOEFF_SIZE] =
         {
             /*order 0*/{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
@@ -84,14 +94,6 @@ public:
             /*order 15*/{ 15, 105, 455, 1365, 3003, 5005, 6435, 6435, 5005, 3003, 1365, 455, 105, 15 }
         };
 
-        CurveParameters curveParam;
-        curveParam.setValues(info.data.tone_mapping.knee_point_x,
-                             info.data.tone_mapping.knee_point_y,
-                             info.data.tone_mapping.bezier_curve_anchors,
-                             info.data.tone_mapping.num_bezier_curve_anchors + 1,
-                             META_JSON_2094_EBZ_KNEE_POINT_MAX,
-                             META_JSON_2094_EBZ_PCOEFF_MAX);
-
         const float sx = curveParam.KPx;
         const float sy = curveParam.KPy;
         const int order = curveParam.order;
@@ -148,6 +150,11 @@ public:
     {
         return lookupTonemapGain(max(px, minX));
     }
+
+    /* the same for every px, scratch of this curve only */
+    CurveParameters curveParam;
+    float powX[META_MAX_PCOEFF_SIZE];
+    float powDX[META_MAX_PCOEFF_SIZE];
 };
 
 // copy Android ToneMapper from frameworks/native/libs/tonemap/tonemap.cpp
@@ -155,10 +162,16 @@ class ATMCurveData : public curveData<CurveInfo> {
 public:
     ATMCurveData(CurveInfo &info, int inputrange, int outputrange, int minx)
         : curveData(info, inputrange, outputrange, minx) {
-            int transfer = info.inDataspace & HAL_DATASPACE_TRANSFER_MASK;
-            if (transfer != HAL_DATASPACE_TRANSFER_HLG && info.metaIf != nullptr)
-                info.metaIf->configHDR10Tonemap(info.maxInLumi, info.maxOutLumi);
+            configTonemap(info);
         }
+
+    /* the tone mapper of the meta plugin keeps the luminances of the last curve */
+    static void configTonemap(CurveInfo &info)
+    {
+        int transfer = info.inDataspace & HAL_DATASPACE_TRANSFER_MASK;
+        if (transfer != HAL_DATASPACE_TRANSFER_HLG && info.metaIf != nullptr)
+            info.metaIf->configHDR10Tonemap(info.maxInLumi, info.maxOutLumi);
+    }
     virtual ~ATMCurveData() {}
 
     double lookupTonemapGainO(double nit)
@@ -484,7 +497,7 @@ public:
         }
     }
 
-    void select(int numArray, std::vector<int> &arrX, std::vector<int> &arrY)
+    int select(int numArray, std::vector<int> &arrX, std::vector<int> &arrY)
     {
         // Select node already contains start and end point, so subtract two.
         select_from_candidate(numArray - 2);
@@ -500,6 +513,8 @@ public:
         // The last coordinate has difference with prior value
         arrX[i - 1] -= arrX[i - 2];
         arrY[i - 1] -= arrY[i - 2];
+
+        return i;
     }
 
 private:
@@ -508,12 +523,157 @@ private:
     curveData<T> &curvedata;
 };
 
+/*
+ * Curves already generated, by all of their inputs.
+ * HDR10+ metadata repeats for whole scenes and the static curves only
+ * change with the luminances, their knee points are copied instead of
+ * searched again. Shared by every layer and thread.
+ */
+class curveCache {
+public:
+    curveCache(unsigned int capacity) : capacity(capacity) {}
+
+    bool get(const std::string &key, std::vector<int> &arrX, std::vector<int> &arrY)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto iter = index.find(key);
+        if (iter == index.end())
+            return false;
+
+        lru.splice(lru.begin(), lru, iter->second);
+        std::copy(iter->second->arrX.begin(), iter->second->arrX.end(), arrX.begin());
+        std::copy(iter->second->arrY.begin(), iter->second->arrY.end(), arrY.begin());
+        return true;
+    }
+
+    void put(const std::string &key, std::vector<int> &arrX, std::vector<int> &arrY, int num,
+            unsigned long metaId = 0)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (capacity == 0 || index.find(key) != index.end())
+            return;
+
+        lru.push_front({key, std::vector<int>(arrX.begin(), arrX.begin() + num),
+                std::vector<int>(arrY.begin(), arrY.begin() + num), metaId});
+        index[key] = lru.begin();
+        shrink();
+    }
+
+    /* drops the curves computed by a meta interface, and forgets the interface */
+    void releaseMetaIf(class hdrMetaInterface *metaIf)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto id = metaIds.find(metaIf);
+        if (id == metaIds.end())
+            return;
+
+        for (auto iter = lru.begin(); iter != lru.end();) {
+            if (iter->metaId == id->second) {
+                index.erase(iter->key);
+                iter = lru.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+        metaIds.erase(id);
+    }
+
+    /*
+     * Interfaces are told apart by an id that is never reused, a new
+     * interface allocated at the address of a destroyed one doesn't
+     * get the curves of the old one. 0 is no interface.
+     */
+    unsigned long getMetaId(class hdrMetaInterface *metaIf)
+    {
+        if (metaIf == nullptr)
+            return 0;
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto id = metaIds.find(metaIf);
+        if (id != metaIds.end())
+            return id->second;
+        return metaIds[metaIf] = ++lastMetaId;
+    }
+
+    void resize(unsigned int entries)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        capacity = entries;
+        shrink();
+    }
+
+private:
+    struct entry {
+        std::string key;
+        /* only the points written by the knee point search */
+        std::vector<int> arrX;
+        std::vector<int> arrY;
+        /* id of the meta interface that computed the curve */
+        unsigned long metaId;
+    };
+
+    void shrink(void)
+    {
+        while (lru.size() > capacity) {
+            index.erase(lru.back().key);
+            lru.pop_back();
+        }
+    }
+
+    std::mutex lock;
+    std::list<entry> lru;
+    std::unordered_map<std::string, std::list<entry>::iterator> index;
+    unsigned int capacity;
+    std::unordered_map<class hdrMetaInterface *, unsigned long> metaIds;
+    unsigned long lastMetaId = 0;
+};
+
+static curveCache curves(CURVE_CACHE_ENTRIES);
+
+enum curveType {
+    CURVE_TM_DYNAMIC = 0,
+    CURVE_TM_STATIC,
+    CURVE_EOTF,
+};
+
+/* compared as a whole, the hash of the map only picks the bucket */
+static std::string curveKey(enum curveType type, CurveInfo &info, int numArray,
+        int x_bits, int y_bits, int minx_bits, unsigned long metaId = 0,
+        const void *meta = nullptr, size_t meta_size = 0)
+{
+    const int params[] = {type, info.inDataspace, (int)info.maxInLumi, (int)info.maxOutLumi,
+        numArray, x_bits, y_bits, minx_bits};
+    std::string key((const char *)params, sizeof(params));
+
+    /* the static curve may be computed by the tone mapper of the meta plugin */
+    key.append((const char *)&metaId, sizeof(metaId));
+    if (meta != nullptr)
+        key.append((const char *)meta, meta_size);
+    return key;
+}
+
+void setCurveCacheSize(unsigned int entries)
+{
+    curves.resize(entries);
+}
+
+void releaseCurveMetaIf(class hdrMetaInterface *metaIf)
+{
+    if (metaIf != nullptr)
+        curves.releaseMetaIf(metaIf);
+}
+
 void genTMCurve(
         CurveInfo info,
         void *data,
         std::vector<int> &arrX, std::vector<int> &arrY, int numArray,
         int x_bits, int y_bits, int minx_bits)
 {
+    std::string key = curveKey(CURVE_TM_DYNAMIC, info, numArray, x_bits, y_bits, minx_bits,
+            0, data, sizeof(ExynosHdrDynamicInfo_t));
+    if (curves.get(key, arrX, arrY))
+        return;
+
     ExynosHdrDynamicInfo_t meta = *(ExynosHdrDynamicInfo_t *)data;
 
     meta2meta(info.maxOutLumi, info.maxInLumi, meta);
@@ -524,7 +684,7 @@ void genTMCurve(
     OETFCurveData curvedata(meta, NUM_X, NUM_Y, MIN_X);
     kneePointExtractor<ExynosHdrDynamicInfo_t, NodeMultiPoints> points(curvedata);
 
-    points.select(numArray, arrX, arrY);
+    curves.put(key, arrX, arrY, points.select(numArray, arrX, arrY));
 }
 
 void genTMCurve(
@@ -532,13 +692,20 @@ void genTMCurve(
         std::vector<int> &arrX, std::vector<int> &arrY, int numArray,
         int x_bits, int y_bits, int minx_bits)
 {
+    unsigned long metaId = curves.getMetaId(info.metaIf);
+    std::string key = curveKey(CURVE_TM_STATIC, info, numArray, x_bits, y_bits, minx_bits, metaId);
+    if (curves.get(key, arrX, arrY)) {
+        ATMCurveData::configTonemap(info);
+        return;
+    }
+
     int NUM_X = 1 << x_bits;
     int NUM_Y = 1 << y_bits;
     int MIN_X = 1 << minx_bits;
     ATMCurveData curvedata(info, NUM_X, NUM_Y, MIN_X);
     kneePointExtractor<CurveInfo, NodeMultiPoints> points(curvedata);
 
-    points.select(numArray, arrX, arrY);
+    curves.put(key, arrX, arrY, points.select(numArray, arrX, arrY), metaId);
 }
 
 void genEOTFCurve(
@@ -546,12 +713,15 @@ void genEOTFCurve(
         std::vector<int> &arrX, std::vector<int> &arrY, int numArray,
         int x_bits, int y_bits, int minx_bits)
 {
+    std::string key = curveKey(CURVE_EOTF, info, numArray, x_bits, y_bits, minx_bits);
+    if (curves.get(key, arrX, arrY))
+        return;
+
     int NUM_X = 1 << x_bits;
     int NUM_Y = (1 << y_bits) - 1;
     int MIN_X = 1 << minx_bits;
     EOTFCurveData curvedata(info, NUM_X, NUM_Y, MIN_X);
     kneePointExtractor<CurveInfo, NodeMultiPoints> points(curvedata);
 
-    points.select(numArray, arrX, arrY);
+    curves.put(key, arrX, arrY, points.select(numArray, arrX, arrY));
 }
-
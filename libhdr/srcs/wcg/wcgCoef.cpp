@@ -1,6 +1,7 @@
 #include "wcgCoef.h"
 #include "hdrContext.h"
 #include <unistd.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -322,24 +323,16 @@ void wcgCoef::parse_wcgMods(
     }
 }
 
-void wcgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+bool wcgCoef::parseXml(int hw_id, const std::string &fn)
 {
     xmlDocPtr doc;
     xmlNodePtr root;
 
-    std::string fn_default = filename + (std::string)".xml";
-    std::string fn_target = filename + ctx->target_name;
-
-    doc = xmlParseFile(fn_target.c_str());
+    doc = xmlParseFile(fn.c_str());
     if (doc == NULL) {
         ALOGD("no document or can not parse the document(%s)",
-                fn_target.c_str());
-        doc = xmlParseFile(fn_default.c_str());
-        if (doc == NULL) {
-            ALOGD("no document or can not parse the default document(%s)",
-                fn_default.c_str());
-            goto ret;
-        }
+                fn.c_str());
+        return false;
     }
 
     root = xmlDocGetRootElement(doc);
@@ -359,8 +352,205 @@ free_root:
     //xmlFree(root);
 free_doc:
     xmlFreeDoc(doc);
-ret:
-    return;
+    return true;
+}
+
+template <typename T>
+static vector<string> sortedKeys(unordered_map<string, T> &data)
+{
+    vector<string> keys;
+    for (auto &item : data)
+        keys.push_back(item.first);
+    sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void wcgCoef::serialize_wcgMod(hdrCoefCacheWriter &out, struct wcgModule &wcg_module)
+{
+    out.putInt(wcg_module.modEnTable.size());
+    for (auto &node : wcg_module.modEnTable) {
+        out.putInt(node.data.size());
+        for (auto &name : sortedKeys(node.data)) {
+            out.putString(name);
+            out.putInt(node.data[name].modEnCoef);
+            out.putDat(node.data[name].modEnCoef_packed);
+        }
+    }
+    out.putInt(wcg_module.eotfTable.size());
+    for (auto &node : wcg_module.eotfTable) {
+        out.putInt(node.data.size());
+        for (auto &name : sortedKeys(node.data)) {
+            out.putString(name);
+            out.putDat(node.data[name].eotfCoef_packed);
+        }
+    }
+    out.putInt(wcg_module.oetfTable.size());
+    for (auto &node : wcg_module.oetfTable) {
+        out.putInt(node.data.size());
+        for (auto &name : sortedKeys(node.data)) {
+            out.putString(name);
+            out.putDat(node.data[name].oetfCoef_packed);
+        }
+    }
+    out.putInt(wcg_module.gmTable.size());
+    for (auto &in : wcg_module.gmTable) {
+        out.putInt(in.out.size());
+        for (auto &node : in.out) {
+            out.putInt(node.data.size());
+            for (auto &name : sortedKeys(node.data)) {
+                out.putString(name);
+                out.putDat(node.data[name].gmCoef_packed);
+            }
+        }
+    }
+
+    vector<int> dataspaces;
+    for (auto &custom : wcg_module.customTable)
+        dataspaces.push_back(custom.first);
+    sort(dataspaces.begin(), dataspaces.end());
+    out.putInt(dataspaces.size());
+    for (auto ds : dataspaces) {
+        out.putInt(ds);
+        out.putInt(wcg_module.customTable[ds].dataspace);
+        out.putInt(wcg_module.customTable[ds].capa);
+    }
+}
+
+void wcgCoef::serialize(hdrCoefCacheWriter &out)
+{
+    vector<int> layers;
+
+    for (auto &mod : layerToWcgMod)
+        layers.push_back(mod.first);
+    sort(layers.begin(), layers.end());
+
+    out.putInt(layers.size());
+    for (auto layer : layers) {
+        out.putInt(layer);
+        serialize_wcgMod(out, layerToWcgMod[layer]);
+    }
+}
+
+bool wcgCoef::deserialize_wcgMod(hdrCoefCacheReader &in, struct wcgModule &wcg_module)
+{
+    int num, count;
+    string name;
+
+    /* the tables are sized by the constructor, the blob has to agree */
+    if (!in.getInt(num) || num != (int)wcg_module.modEnTable.size())
+        return false;
+    for (auto &node : wcg_module.modEnTable) {
+        if (!in.getCount(count))
+            return false;
+        for (int i = 0; i < count; i++) {
+            struct modEn tmp;
+            int en;
+            if (!in.getString(name) || !in.getInt(en) || !in.getDat(tmp.modEnCoef_packed))
+                return false;
+            tmp.modEnCoef = (bool)en;
+            node.data.insert(make_pair(name, tmp));
+        }
+    }
+    if (!in.getInt(num) || num != (int)wcg_module.eotfTable.size())
+        return false;
+    for (auto &node : wcg_module.eotfTable) {
+        if (!in.getCount(count))
+            return false;
+        for (int i = 0; i < count; i++) {
+            struct eotf tmp;
+            if (!in.getString(name) || !in.getDat(tmp.eotfCoef_packed))
+                return false;
+            node.data.insert(make_pair(name, tmp));
+        }
+    }
+    if (!in.getInt(num) || num != (int)wcg_module.oetfTable.size())
+        return false;
+    for (auto &node : wcg_module.oetfTable) {
+        if (!in.getCount(count))
+            return false;
+        for (int i = 0; i < count; i++) {
+            struct oetf tmp;
+            if (!in.getString(name) || !in.getDat(tmp.oetfCoef_packed))
+                return false;
+            node.data.insert(make_pair(name, tmp));
+        }
+    }
+    if (!in.getInt(num) || num != (int)wcg_module.gmTable.size())
+        return false;
+    for (auto &gm_in : wcg_module.gmTable) {
+        if (!in.getInt(num) || num != (int)gm_in.out.size())
+            return false;
+        for (auto &node : gm_in.out) {
+            if (!in.getCount(count))
+                return false;
+            for (int i = 0; i < count; i++) {
+                struct gm tmp;
+                if (!in.getString(name) || !in.getDat(tmp.gmCoef_packed))
+                    return false;
+                node.data.insert(make_pair(name, tmp));
+            }
+        }
+    }
+    if (!in.getCount(count))
+        return false;
+    for (int i = 0; i < count; i++) {
+        int ds;
+        struct customOutNode custom;
+        if (!in.getInt(ds) || !in.getInt(custom.dataspace) || !in.getInt(custom.capa))
+            return false;
+        wcg_module.customTable[ds] = custom;
+    }
+    return true;
+}
+
+bool wcgCoef::deserialize(hdrCoefCacheReader &in)
+{
+    unordered_map<int, struct wcgModule> table;
+    int num_mods;
+
+    if (!in.getCount(num_mods))
+        return false;
+    for (int i = 0; i < num_mods; i++) {
+        int modId;
+        struct wcgModule wcgMod;
+        if (!in.getInt(modId) || !deserialize_wcgMod(in, wcgMod))
+            return false;
+        table.insert(make_pair(modId, wcgMod));
+    }
+    if (!in.done())
+        return false;
+
+    for (auto &mod : table)
+        layerToWcgMod.insert(mod);
+    return true;
+}
+
+bool wcgCoef::loadCache(int hw_id, const std::string &fn, const std::string &blob)
+{
+    hdrCoefCacheReader in;
+
+    if (!in.open(blob, fn, HDR_COEF_CACHE_WCG, hw_id, hwInfo->getHwHash(hw_id)))
+        return false;
+    if (!deserialize(in)) {
+        ALOGE("can not load %s, falling back to %s", blob.c_str(), fn.c_str());
+        return false;
+    }
+    return true;
+}
+
+void wcgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+{
+    std::string fn_default = filename + (std::string)".xml";
+    std::string fn_target = filename + ctx->target_name;
+
+    if (loadCache(hw_id, fn_target, hdrCoefCacheName(fn_target)) ||
+            parseXml(hw_id, fn_target))
+        return;
+    if (loadCache(hw_id, fn_default, hdrCoefCacheName(fn_default)) ||
+            parseXml(hw_id, fn_default))
+        return;
+    ALOGD("no document or can not parse the default document(%s)",
+            fn_default.c_str());
 }
 
 void wcgCoef::parse(vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
@@ -377,7 +567,7 @@ void wcgCoef::parse(vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
     }
 }
 
-void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
+void wcgCoef::initStrMaps(void)
 {
     capStrMap = mapStringToCapa();
     tfStrMap.clear();
@@ -386,12 +576,49 @@ void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
     stStrMap.clear();
     for (auto &st : standardTable)
         stStrMap[st.str] = st.id;
+}
+
+void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
+{
+    initStrMaps();
 
     this->hwInfo = hwInfo;
     parse(hwInfo->getListHdrHw(), ctx);
     //this->dump();
 }
 
+bool wcgCoef::compileCache(hdrHwInfo *hwInfo, int hw_id,
+        const std::string &lut, const std::string &blob, bool verify)
+{
+    hdrCoefCacheWriter out;
+    uint64_t lut_size;
+
+    initStrMaps();
+    this->hwInfo = hwInfo;
+    layerToWcgMod.clear();
+    if (!hdrCoefFileSize(lut, lut_size) || !parseXml(hw_id, lut))
+        return false;
+
+    serialize(out);
+    if (!out.write(blob, HDR_COEF_CACHE_WCG, hw_id, lut_size, hwInfo->getHwHash(hw_id)))
+        return false;
+
+    if (verify) {
+        wcgCoef loaded;
+        hdrCoefCacheWriter reloaded;
+
+        loaded.hwInfo = hwInfo;
+        if (!loaded.loadCache(hw_id, lut, blob))
+            return false;
+        loaded.serialize(reloaded);
+        if (reloaded.getBody() != out.getBody()) {
+            ALOGE("%s does not match %s", blob.c_str(), lut.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 int wcgCoef::coefBuildup(int layer_index, struct hdrContext *ctx)
 {
     int ret = HDR_ERR_NO;
@@ -0,0 +1,138 @@
+/*
+ * hdr_coef_compiler
+ *
+ * Packs the LUT xml files of libhdr into the blobs loaded by the coef
+ * classes at init, see hdrCoefCache.h. Run it on the same hw xml as the
+ * device, the blobs of another hw xml are ignored there.
+ * libhdr_coef_blobs_erd8835 in Android.bp runs it at build time.
+ *
+ * hdr_coef_compiler --hw hdrHwDPU.xml [--out dir] [--verify]
+ *         [--wcg wcgLut.xml] [--hdr10 hdr10Lut.xml]
+ *         [--hdr10p hdr10pLut.xml] [--hlg hlgLut.xml] ...
+ */
+#include <getopt.h>
+#include <stdio.h>
+#include "hdrHwInfo.h"
+#include "hdrCoefCache.h"
+#include "wcgCoef.h"
+#include "hdr10Coef.h"
+#include "hdr10pCoef.h"
+#include "hlgCoef.h"
+
+using namespace std;
+
+struct lutFile {
+    enum hdrCoefCacheKind kind;
+    string lut;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s --hw <hw xml> [--out <dir>] [--verify]\n"
+            "       [--wcg <xml>] [--hdr10 <xml>] [--hdr10p <xml>] [--hlg <xml>] ...\n"
+            "  --hw      hw xml of the device, as /vendor/etc/dqe/hdrHwDPU.xml\n"
+            "  --out     directory of the blobs, next to each xml by default\n"
+            "  --verify  reload every blob and compare it with its xml\n",
+            prog);
+}
+
+static string blobName(const string &lut, const string &out_dir)
+{
+    string blob = hdrCoefCacheName(lut);
+
+    if (out_dir.empty())
+        return blob;
+    size_t slash = blob.rfind('/');
+    return out_dir + "/" + (slash == string::npos ? blob : blob.substr(slash + 1));
+}
+
+static bool compile(hdrHwInfo *hwInfo, struct lutFile &file,
+        const string &blob, bool verify)
+{
+    switch (file.kind) {
+        case HDR_COEF_CACHE_WCG: {
+            wcgCoef coef;
+            return coef.compileCache(hwInfo, HDR_HW_DPU, file.lut, blob, verify);
+        }
+        case HDR_COEF_CACHE_HDR10: {
+            hdr10Coef coef;
+            return coef.compileCache(hwInfo, HDR_HW_DPU, file.lut, blob, verify);
+        }
+        case HDR_COEF_CACHE_HDR10P: {
+            hdr10pCoef coef;
+            return coef.compileCache(hwInfo, HDR_HW_DPU, file.lut, blob, verify);
+        }
+        case HDR_COEF_CACHE_HLG: {
+            hlgCoef coef;
+            return coef.compileCache(hwInfo, HDR_HW_DPU, file.lut, blob, verify);
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"hw",      required_argument,  NULL, 'w'},
+        {"out",     required_argument,  NULL, 'o'},
+        {"verify",  no_argument,        NULL, 'v'},
+        {"wcg",     required_argument,  NULL, HDR_COEF_CACHE_WCG},
+        {"hdr10",   required_argument,  NULL, HDR_COEF_CACHE_HDR10},
+        {"hdr10p",  required_argument,  NULL, HDR_COEF_CACHE_HDR10P},
+        {"hlg",     required_argument,  NULL, HDR_COEF_CACHE_HLG},
+        {NULL,      0,                  NULL, 0},
+    };
+    vector<struct lutFile> files;
+    string hw, out_dir;
+    bool verify = false;
+    int opt, failed = 0;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+            case 'w':
+                hw = optarg;
+                break;
+            case 'o':
+                out_dir = optarg;
+                break;
+            case 'v':
+                verify = true;
+                break;
+            case HDR_COEF_CACHE_WCG:
+            case HDR_COEF_CACHE_HDR10:
+            case HDR_COEF_CACHE_HDR10P:
+            case HDR_COEF_CACHE_HLG:
+                files.push_back({(enum hdrCoefCacheKind)opt, optarg});
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (hw.empty() || files.empty() || optind != argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    hdrHwInfo hwInfo;
+    hwInfo.setHwInfoFile(HDR_HW_DPU, hw);
+    hwInfo.init();
+    if (hwInfo.getHwHash(HDR_HW_DPU) == 0) {
+        fprintf(stderr, "can not read %s\n", hw.c_str());
+        return 1;
+    }
+
+    for (auto &file : files) {
+        string blob = blobName(file.lut, out_dir);
+        if (compile(&hwInfo, file, blob, verify)) {
+            printf("%s -> %s%s\n", file.lut.c_str(), blob.c_str(),
+                    verify ? " (verified)" : "");
+        } else {
+            fprintf(stderr, "%s: failed\n", file.lut.c_str());
+            failed++;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
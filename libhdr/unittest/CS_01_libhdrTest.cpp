@@ -20,6 +20,8 @@
 #include <hardware/exynos/hdrInterface.h>
 #include <system/graphics.h>
 #include <cutils/properties.h>
+#include <chrono>
+#include <map>
 
 #include "wcgTestVector.h"
 #include "hdrTestVector.h"
@@ -240,6 +242,20 @@ class CS_01_libhdrTest : public ::testing::Test {
                 dat = (struct hdr_lut_header*)((char*)dat + offset);
             }
         }
+        /* writes the coef data to regs as the hw does, returns its size */
+        unsigned int Apply_Coef(void *coef, std::map<unsigned int, int> &regs) {
+            struct hdr_coef_header *header_g = (struct hdr_coef_header *)coef;
+            int num = header_g->num.unpack.shall + header_g->num.unpack.need;
+            struct hdr_lut_header *dat = (struct hdr_lut_header*)((char*)header_g + sizeof(struct hdr_coef_header));
+
+            for (int i = 0; i < num; i++) {
+                int *words = (int*)((char*)dat + sizeof(struct hdr_lut_header));
+                for (unsigned int j = 0; j < dat->length; j++)
+                    regs[dat->byte_offset + (j * 4)] = words[j];
+                dat = (struct hdr_lut_header*)((char*)words + (dat->length * 4));
+            }
+            return header_g->total_bytesize;
+        }
         void setDynamicMeta(ExynosHdrDynamicInfo *d_meta, int index) {
             hdr10pTV.setDynamicMeta(d_meta, index);
         }
@@ -508,6 +524,101 @@ TEST_F (CS_01_libhdrTest, CS_01_07_RandomSequence) {
     }
 }
 
+TEST_F (CS_01_libhdrTest, CS_01_08_DeltaMatchesFull) {
+    class hdrInterface *IhdrDelta = hdrInterface::createInstance();
+    struct hdrCoefParcel full_data[2], delta_data[2];
+    std::map<unsigned int, int> full_regs[2], delta_regs[2];
+    unsigned long full_bytes = 0, delta_bytes = 0;
+    std::chrono::nanoseconds full_time(0), delta_time(0);
+    int frames = 0;
+
+    /* an fd per layer, as the coef data of an unchanged layer is not written again */
+    for (int layer = 0; layer < 2; layer++) {
+        full_data[layer].hdrCoef = new char[buf_size];
+        delta_data[layer].hdrCoef = new char[buf_size];
+        memset(full_data[layer].hdrCoef, 0, buf_size);
+        memset(delta_data[layer].hdrCoef, 0, buf_size);
+    }
+    IhdrDelta->setLogLevel(0);
+
+    ExynosHdrStaticInfo s_meta;
+    s_meta.sType1.mMaxDisplayLuminance = (1000 * 10000);
+    ExynosHdrDynamicInfo d_meta;
+
+    tInfo = {HAL_DATASPACE_V0_SRGB, 0, 1000, HDR_BPC_10, HDR_CAPA_INNER};
+    Ihdr->setTargetInfo(&tInfo);
+    IhdrDelta->setTargetInfo(&tInfo);
+
+    /* scenes of a HDR10+ clip next to a SDR layer, then HDR10 and a target change */
+    for (int scene = 0; scene < 10; scene++) {
+        if (scene == 6) {
+            tInfo = {HAL_DATASPACE_V0_SRGB, 0, 700, HDR_BPC_10, HDR_CAPA_INNER};
+            Ihdr->setTargetInfo(&tInfo);
+            IhdrDelta->setTargetInfo(&tInfo);
+        }
+        for (int frame = 0; frame < 12; frame++, frames++) {
+            setDynamicMeta(&d_meta, scene % 4);
+
+            struct HdrLayerInfo layers[2] = {
+                {HAL_DATASPACE_BT2020_PQ,
+                    &s_meta, sizeof(ExynosHdrStaticInfo),
+                    (scene < 8) ? &d_meta : NULL, (scene < 8) ? (int)sizeof(ExynosHdrDynamicInfo) : 0,
+                    true, HDR_BPC_10, REND_ORI, NULL, false},
+                {(scene % 3) ? HAL_DATASPACE_V0_SRGB : HAL_DATASPACE_BT2020,
+                    NULL, 0, NULL, 0,
+                    true, HDR_BPC_8, REND_ORI, NULL, false},
+            };
+
+            Ihdr->initHdrCoefBuildup(HDR_HW_DPU);
+            IhdrDelta->initHdrCoefBuildup(HDR_HW_DPU);
+            Ihdr->setHDRlayer(true);
+            IhdrDelta->setHDRlayer(true);
+            for (int layer = 0; layer < 2; layer++) {
+                struct HdrLayerInfo full_info = layers[layer], delta_info = layers[layer];
+
+                Ihdr->setLayerInfo(layer, &full_info);
+                IhdrDelta->setLayerInfo(layer, &delta_info);
+
+                auto start = std::chrono::steady_clock::now();
+                Ihdr->getHdrCoefDataByMode(HDR_HW_DPU, layer, &full_data[layer], HDR_COEF_FULL);
+                auto mid = std::chrono::steady_clock::now();
+                IhdrDelta->getHdrCoefDataByMode(HDR_HW_DPU, layer, &delta_data[layer], HDR_COEF_DELTA);
+                auto end = std::chrono::steady_clock::now();
+                full_time += (mid - start);
+                delta_time += (end - mid);
+
+                full_bytes += Apply_Coef(full_data[layer].hdrCoef, full_regs[layer]);
+                delta_bytes += Apply_Coef(delta_data[layer].hdrCoef, delta_regs[layer]);
+                ASSERT_EQ(((struct hdr_coef_header*)delta_data[layer].hdrCoef)->type.unpack.optional_flag
+                        & HDR_COEF_FLAG_DELTA, HDR_COEF_FLAG_DELTA);
+                ASSERT_TRUE(full_regs[layer] == delta_regs[layer])
+                    << "hw state differs, layer " << layer << " scene " << scene << " frame " << frame;
+            }
+        }
+    }
+
+    /* a full dump asked in delta use gives the whole state again */
+    for (int layer = 0; layer < 2; layer++) {
+        std::map<unsigned int, int> regs;
+        IhdrDelta->getHdrCoefDataByMode(HDR_HW_DPU, layer, &delta_data[layer], HDR_COEF_FULL);
+        Apply_Coef(delta_data[layer].hdrCoef, regs);
+        ASSERT_EQ(((struct hdr_coef_header*)delta_data[layer].hdrCoef)->type.unpack.optional_flag
+                & HDR_COEF_FLAG_DELTA, 0);
+        ASSERT_TRUE(regs == full_regs[layer]) << "full dump differs, layer " << layer;
+    }
+    EXPECT_LT(delta_bytes, full_bytes);
+
+    printf("coef data per frame : full %lu bytes %.2f us, delta %lu bytes %.2f us\n",
+            full_bytes / frames, full_time.count() / 1000.0 / frames,
+            delta_bytes / frames, delta_time.count() / 1000.0 / frames);
+
+    for (int layer = 0; layer < 2; layer++) {
+        delete[] (char*)full_data[layer].hdrCoef;
+        delete[] (char*)delta_data[layer].hdrCoef;
+    }
+    delete IhdrDelta;
+}
+
 }
 }
 }
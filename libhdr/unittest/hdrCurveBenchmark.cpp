@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <system/graphics.h>
+
+#include <hdrCurveData.h>
+
+/* tone curve of the DPU, see tm-x in hdrHwDPU.xml */
+static const int kNumPoints = 33;
+static const int kXBits = 27;
+static const int kYBits = 20;
+static const int kMinXBits = 10;
+/* frames of a scene sharing its HDR10+ metadata */
+static const int kSceneFrames = 24;
+static const int kScenes = 8;
+
+static ExynosHdrDynamicInfo_t sceneMeta(int scene)
+{
+    ExynosHdrDynamicInfo_t meta;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.valid = 1;
+    meta.data.display_maximum_luminance = 1000;
+    for (int i = 0; i < 3; i++)
+        meta.data.maxscl[i] = 40000 + 5000 * scene + 1000 * i;
+
+    meta.data.num_maxrgb_percentiles = 9;
+    const unsigned char percentages[9] = {1, 5, 10, 25, 50, 75, 90, 95, 99};
+    for (int i = 0; i < 9; i++) {
+        meta.data.maxrgb_percentages[i] = percentages[i];
+        meta.data.maxrgb_percentiles[i] = (i + 1) * (2000 + 300 * scene);
+    }
+
+    meta.data.tone_mapping.tone_mapping_flag = 1;
+    meta.data.tone_mapping.knee_point_x = 100 + 20 * scene;
+    meta.data.tone_mapping.knee_point_y = 200 + 20 * scene;
+    meta.data.tone_mapping.num_bezier_curve_anchors = 9;
+    for (int i = 0; i < 9; i++)
+        meta.data.tone_mapping.bezier_curve_anchors[i] = 100 * (i + 1) + 4 * scene;
+
+    return meta;
+}
+
+/* Arg: entries of the curve cache, 0 turns it off */
+static void BM_HDR10pToneCurveScenes(benchmark::State &state)
+{
+    std::vector<ExynosHdrDynamicInfo_t> scenes;
+    std::vector<int> arrX(kNumPoints), arrY(kNumPoints);
+    int frame = 0;
+
+    for (int i = 0; i < kScenes; i++)
+        scenes.push_back(sceneMeta(i));
+    setCurveCacheSize(state.range(0));
+
+    for (auto _ : state) {
+        ExynosHdrDynamicInfo_t meta = scenes[(frame++ / kSceneFrames) % kScenes];
+        genTMCurve({HAL_DATASPACE_BT2020_PQ, 4000, 500}, &meta,
+                arrX, arrY, kNumPoints, kXBits, kYBits, kMinXBits);
+        benchmark::DoNotOptimize(arrY.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    setCurveCacheSize(CURVE_CACHE_ENTRIES);
+}
+BENCHMARK(BM_HDR10pToneCurveScenes)->Arg(0)->Arg(CURVE_CACHE_ENTRIES);
+
+/* every frame has its own metadata, the cost of a miss */
+static void BM_HDR10pToneCurveUnique(benchmark::State &state)
+{
+    ExynosHdrDynamicInfo_t meta = sceneMeta(0);
+    std::vector<int> arrX(kNumPoints), arrY(kNumPoints);
+
+    setCurveCacheSize(state.range(0));
+
+    for (auto _ : state) {
+        meta.data.maxrgb_percentiles[8]++;
+        genTMCurve({HAL_DATASPACE_BT2020_PQ, 4000, 500}, &meta,
+                arrX, arrY, kNumPoints, kXBits, kYBits, kMinXBits);
+        benchmark::DoNotOptimize(arrY.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    setCurveCacheSize(CURVE_CACHE_ENTRIES);
+}
+BENCHMARK(BM_HDR10pToneCurveUnique)->Arg(0)->Arg(CURVE_CACHE_ENTRIES);
+
+static void BM_PQEotfCurve(benchmark::State &state)
+{
+    std::vector<int> arrX(kNumPoints), arrY(kNumPoints);
+
+    setCurveCacheSize(state.range(0));
+
+    for (auto _ : state) {
+        genEOTFCurve({HAL_DATASPACE_BT2020_PQ, 4000, 0},
+                arrX, arrY, kNumPoints, 10, 16, 0);
+        benchmark::DoNotOptimize(arrY.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    setCurveCacheSize(CURVE_CACHE_ENTRIES);
+}
+BENCHMARK(BM_PQEotfCurve)->Arg(0)->Arg(CURVE_CACHE_ENTRIES);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log/log.h>
+
+#include "SbwcDecompConnection.h"
+
+SbwcDecompConnection::SbwcDecompConnection(Connector connector)
+    : mConnector(connector), mConnectCount(0)
+{
+}
+
+std::shared_ptr<SbwcDecompServiceProxy> SbwcDecompConnection::getProxy()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mProxy) {
+        mProxy = mConnector(*this);
+        if (!mProxy) {
+            ALOGE("failed to connect to SbwcDecompService");
+            return nullptr;
+        }
+        mConnectCount++;
+    }
+
+    return mProxy;
+}
+
+void SbwcDecompConnection::invalidate(const SbwcDecompServiceProxy *proxy)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // A late notification must not drop a newer connection
+    if (mProxy.get() == proxy)
+        mProxy.reset();
+}
+
+unsigned int SbwcDecompConnection::getConnectCount()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    return mConnectCount;
+}
+
+bool SbwcDecompConnection::decodeOne(std::shared_ptr<SbwcDecompServiceProxy> &proxy,
+                                     const SbwcDecompJob &job)
+{
+    for (int retry = 0; retry < 2; retry++) {
+        if (!proxy) {
+            proxy = getProxy();
+            if (!proxy)
+                return false;
+        }
+
+        int ret = proxy->decodeWithCrop(job.src, job.dst, job.attr, job.cropWidth, job.cropHeight);
+        if (ret != SbwcDecompServiceProxy::DECODE_DEAD)
+            return ret == SbwcDecompServiceProxy::DECODE_OK;
+
+        ALOGW("SbwcDecompService died, reconnecting");
+        invalidate(proxy.get());
+        proxy.reset();
+    }
+
+    return false;
+}
+
+bool SbwcDecompConnection::decode(const SbwcDecompJob &job)
+{
+    std::shared_ptr<SbwcDecompServiceProxy> proxy = getProxy();
+
+    return decodeOne(proxy, job);
+}
+
+bool SbwcDecompConnection::decode(const std::vector<SbwcDecompJob> &jobs, std::vector<bool> &results)
+{
+    std::shared_ptr<SbwcDecompServiceProxy> proxy = getProxy();
+    bool allDone = true;
+
+    results.assign(jobs.size(), false);
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        results[i] = decodeOne(proxy, jobs[i]);
+        allDone = allDone && results[i];
+    }
+
+    return allDone;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_SBWCDECOMPCONNECTION_H
+#define HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_SBWCDECOMPCONNECTION_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cutils/native_handle.h>
+
+/*
+ * Transport to the decompression service.
+ * decodeWithCrop() returns DECODE_DEAD when the service went away, so that
+ * the connection can drop it and look the service up again.
+ */
+class SbwcDecompServiceProxy {
+public:
+    enum {
+        DECODE_OK = 0,
+        DECODE_FAILED,
+        DECODE_DEAD,
+    };
+
+    virtual ~SbwcDecompServiceProxy() { }
+
+    virtual int decodeWithCrop(const native_handle_t *src, const native_handle_t *dst,
+                               unsigned int attr, unsigned int cropWidth, unsigned int cropHeight) = 0;
+};
+
+struct SbwcDecompJob {
+    const native_handle_t *src;
+    const native_handle_t *dst;
+    unsigned int attr;
+    unsigned int cropWidth;
+    unsigned int cropHeight;
+};
+
+/*
+ * Long-lived connection to the decompression service.
+ * The service is looked up once through the connector and kept until it
+ * dies; the next request after that reconnects.
+ */
+class SbwcDecompConnection {
+public:
+    typedef std::function<std::shared_ptr<SbwcDecompServiceProxy>(SbwcDecompConnection &)> Connector;
+
+    explicit SbwcDecompConnection(Connector connector);
+
+    // Decode one job, reconnecting once if the service died in between
+    bool decode(const SbwcDecompJob &job);
+
+    // Decode all jobs on the same connection. results[i] tells whether jobs[i]
+    // succeeded. Returns true only if every job succeeded.
+    bool decode(const std::vector<SbwcDecompJob> &jobs, std::vector<bool> &results);
+
+    // Drop the current service. Called from the death notification.
+    void invalidate(const SbwcDecompServiceProxy *proxy);
+
+    unsigned int getConnectCount();
+
+private:
+    std::shared_ptr<SbwcDecompServiceProxy> getProxy();
+    bool decodeOne(std::shared_ptr<SbwcDecompServiceProxy> &proxy, const SbwcDecompJob &job);
+
+    Connector mConnector;
+
+    std::mutex mLock;
+    std::shared_ptr<SbwcDecompServiceProxy> mProxy;
+    unsigned int mConnectCount;
+};
+
+#endif
@@ -18,6 +18,15 @@
 #ifndef HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_SBWCDECOMP_H
 #define HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_SBWCDECOMP_H
 
+#include <vector>
+
+struct SbwcDecompRequest {
+    ::android::sp<::android::GraphicBuffer> srcBuf;
+    ::android::sp<::android::GraphicBuffer> dstBuf;
+    unsigned int cropWidth;
+    unsigned int cropHeight;
+};
+
 class SbwcDecomp {
 public:
     SbwcDecomp();
@@ -25,6 +34,9 @@ public:
 
     bool decomp(const ::android::sp<::android::GraphicBuffer>& srcBuf, const ::android::sp<::android::GraphicBuffer>& dstBuf);
     bool decomp(const ::android::sp<::android::GraphicBuffer>& srcBuf, const ::android::sp<::android::GraphicBuffer>& dstBuf, unsigned int cropWidth, unsigned int cropHeight);
+    // Decompress all requests over one service connection.
+    // results[i] tells whether requests[i] succeeded.
+    bool decomp(const std::vector<SbwcDecompRequest>& requests, std::vector<bool>& results);
 };
 
 #endif
@@ -22,6 +22,8 @@
 
 #include <vendor/samsung_slsi/hardware/SbwcDecompService/1.0/ISbwcDecompService.h>
 
+#include "SbwcDecompConnection.h"
+
 enum {
     HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M      = 0x105,   /* HAL_PIXEL_FORMAT_YCbCr_420_SP */
     /* 10-bit format (2 fd, 10bit, 2x byte) custom formats */
@@ -52,6 +54,67 @@ enum {
 using namespace android;
 using namespace vendor::samsung_slsi::hardware::SbwcDecompService::V1_0;
 
+class HidlSbwcDecompProxy : public SbwcDecompServiceProxy, public hardware::hidl_death_recipient {
+public:
+    HidlSbwcDecompProxy(SbwcDecompConnection &connection, const sp<ISbwcDecompService> &service)
+        : mConnection(connection), mService(service) { }
+
+    int decodeWithCrop(const native_handle_t *src, const native_handle_t *dst,
+                       unsigned int attr, unsigned int cropWidth, unsigned int cropHeight) override {
+        hardware::hidl_handle srcHH(src);
+        hardware::hidl_handle dstHH(dst);
+
+        hardware::Return<uint32_t> ret = mService->decodeWithCrop(srcHH, dstHH, attr, cropWidth, cropHeight);
+        if (!ret.isOk()) {
+            ALOGE("SbwcDecompService transaction failed: %s", ret.description().c_str());
+            return ret.isDeadObject() ? DECODE_DEAD : DECODE_FAILED;
+        }
+
+        return (static_cast<uint32_t>(ret) == NO_ERROR) ? DECODE_OK : DECODE_FAILED;
+    }
+
+    void serviceDied(uint64_t /* cookie */, const wp<hidl::base::V1_0::IBase>& /* who */) override {
+        ALOGW("SbwcDecompService died");
+        mConnection.invalidate(this);
+    }
+
+    const sp<ISbwcDecompService> &getService() { return mService; }
+
+private:
+    SbwcDecompConnection &mConnection;
+    sp<ISbwcDecompService> mService;
+};
+
+static std::shared_ptr<SbwcDecompServiceProxy> connectSbwcDecompService(SbwcDecompConnection &connection)
+{
+    sp<ISbwcDecompService> service = ISbwcDecompService::getService();
+    if (!service) {
+        ALOGE("failed to getService to ISbwcDecompService");
+        return nullptr;
+    }
+
+    // The death recipient is refcounted by HIDL, hand the proxy over with a
+    // strong reference so that it outlives the notification
+    sp<HidlSbwcDecompProxy> proxy = new HidlSbwcDecompProxy(connection, service);
+    hardware::Return<bool> linked = service->linkToDeath(proxy, 0);
+    if (!linked.isOk() || !linked)
+        ALOGW("failed to link to SbwcDecompService death");
+
+    return std::shared_ptr<SbwcDecompServiceProxy>(proxy.get(),
+                                                   [holder = proxy](SbwcDecompServiceProxy *) mutable {
+                                                       holder->getService()->unlinkToDeath(holder);
+                                                       holder.clear();
+                                                   });
+}
+
+// Shared by every SbwcDecomp instance of the process
+static SbwcDecompConnection &getConnection()
+{
+    static SbwcDecompConnection *connection = new SbwcDecompConnection(connectSbwcDecompService);
+
+    return *connection;
+}
+
 SbwcDecomp::SbwcDecomp()
 {
 }
@@ -117,26 +180,49 @@ bool SbwcDecomp::decomp(const sp<GraphicBuffer>& srcBuf, const sp<GraphicBuffer>
     return decomp(srcBuf, dstBuf, srcBuf->getWidth(), srcBuf->getHeight());
 }
 
-bool SbwcDecomp::decomp(const ::android::sp<::android::GraphicBuffer>& srcBuf, const ::android::sp<::android::GraphicBuffer>& dstBuf, unsigned int cropWidth, unsigned int cropHeight)
+static SbwcDecompJob makeJob(const sp<GraphicBuffer>& srcBuf, const sp<GraphicBuffer>& dstBuf,
+                             unsigned int cropWidth, unsigned int cropHeight)
 {
-    sp<ISbwcDecompService> sbwcDecompService = ISbwcDecompService::getService();
-    if (!sbwcDecompService) {
-        ALOGE("failed to getService to ISbwcDecompService");
-        return false;
-    }
+    unsigned int attr = 0;
+
+    if (srcBuf->getUsage() & GRALLOC_USAGE_PROTECTED)
+        attr |= SBWCDECODER_ATTR_SECURE_BUFFER;
 
+    return { srcBuf->handle, dstBuf->handle, attr, cropWidth, cropHeight };
+}
+
+bool SbwcDecomp::decomp(const ::android::sp<::android::GraphicBuffer>& srcBuf, const ::android::sp<::android::GraphicBuffer>& dstBuf, unsigned int cropWidth, unsigned int cropHeight)
+{
     if (!isValideForDecomp(srcBuf, dstBuf))
         return false;
 
-    unsigned int attr = 0;
+    return getConnection().decode(makeJob(srcBuf, dstBuf, cropWidth, cropHeight));
+}
 
-    if (srcBuf->getUsage() & GRALLOC_USAGE_PROTECTED)
-        attr |= SBWCDECODER_ATTR_SECURE_BUFFER;
+bool SbwcDecomp::decomp(const std::vector<SbwcDecompRequest>& requests, std::vector<bool>& results)
+{
+    std::vector<SbwcDecompJob> jobs;
+    std::vector<size_t> jobIndex;
+
+    results.assign(requests.size(), false);
+
+    for (size_t i = 0; i < requests.size(); i++) {
+        const SbwcDecompRequest &req = requests[i];
+
+        if (!isValideForDecomp(req.srcBuf, req.dstBuf))
+            continue;
+
+        jobs.push_back(makeJob(req.srcBuf, req.dstBuf, req.cropWidth, req.cropHeight));
+        jobIndex.push_back(i);
+    }
+
+    std::vector<bool> jobResults;
+    bool allDone = getConnection().decode(jobs, jobResults);
 
-    hardware::hidl_handle srcHH(srcBuf->handle);
-    hardware::hidl_handle dstHH(dstBuf->handle);
+    for (size_t i = 0; i < jobs.size(); i++)
+        results[jobIndex[i]] = jobResults[i];
 
-    return sbwcDecompService->decodeWithCrop(srcHH, dstHH, attr, cropWidth, cropHeight) == NO_ERROR;
+    return allDone && (jobs.size() == requests.size());
 }
 
 extern "C" void *createSbwcDecomp(void)
@@ -170,3 +256,25 @@ extern "C" bool decomp(void *handle,
 
     return sbwcDecomp->decomp(srcBuf, dstBuf, cropWidth, cropHeight);
 }
+
+extern "C" bool decompBatch(void *handle, const SbwcDecompRequest *requests, size_t count, bool *results) {
+    if (requests == nullptr || results == nullptr) {
+        return false;
+    }
+
+    if (handle == nullptr) {
+        ALOGE("handle is nullptr");
+        return false;
+    }
+
+    SbwcDecomp *sbwcDecomp = static_cast<SbwcDecomp*>(handle);
+    std::vector<SbwcDecompRequest> batch(requests, requests + count);
+    std::vector<bool> batchResults;
+
+    bool ret = sbwcDecomp->decomp(batch, batchResults);
+
+    for (size_t i = 0; i < count; i++)
+        results[i] = batchResults[i];
+
+    return ret;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_FAKESBWCDECOMPSERVICE_H
+#define HARDWARE_SAMSUNG_SLSI_EXYNOS_LIBSBWCDECOMP_FAKESBWCDECOMPSERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../SbwcDecompConnection.h"
+
+// In-process stand-in for SbwcDecompService
+class FakeSbwcDecompService : public SbwcDecompServiceProxy {
+public:
+    int decodeWithCrop(const native_handle_t *src, const native_handle_t *dst,
+                       unsigned int /* attr */, unsigned int /* cropWidth */, unsigned int /* cropHeight */) override {
+        if (dead)
+            return DECODE_DEAD;
+
+        decodeCount++;
+
+        return (src != nullptr && dst != nullptr) ? DECODE_OK : DECODE_FAILED;
+    }
+
+    std::atomic<bool> dead { false };
+    std::atomic<unsigned int> decodeCount { 0 };
+};
+
+// Service manager lookup, lookupDelay simulates the cost of getService()
+class FakeServiceManager {
+public:
+    explicit FakeServiceManager(std::chrono::microseconds lookupDelay = std::chrono::microseconds(0))
+        : mLookupDelay(lookupDelay) { }
+
+    SbwcDecompConnection::Connector connector() {
+        return [this](SbwcDecompConnection &) -> std::shared_ptr<SbwcDecompServiceProxy> {
+            lookupCount++;
+            if (mLookupDelay.count() > 0)
+                std::this_thread::sleep_for(mLookupDelay);
+            if (!available)
+                return nullptr;
+            current = std::make_shared<FakeSbwcDecompService>();
+            return current;
+        };
+    }
+
+    std::atomic<bool> available { true };
+    std::atomic<unsigned int> lookupCount { 0 };
+    std::shared_ptr<FakeSbwcDecompService> current;
+
+private:
+    std::chrono::microseconds mLookupDelay;
+};
+
+#endif
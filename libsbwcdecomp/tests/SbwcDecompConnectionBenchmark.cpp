@@ -0,0 +1,68 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "FakeSbwcDecompService.h"
+
+// Rough cost of a hwservicemanager lookup on device
+static const std::chrono::microseconds kLookupDelay(20);
+
+static std::vector<SbwcDecompJob> makeJobs(size_t count)
+{
+    std::vector<SbwcDecompJob> jobs;
+
+    for (uintptr_t i = 0; i < count; i++)
+        jobs.push_back({ reinterpret_cast<const native_handle_t *>(0x1000 + i * 2),
+                         reinterpret_cast<const native_handle_t *>(0x1001 + i * 2), 0, 1920, 1080 });
+
+    return jobs;
+}
+
+// Previous behaviour: look the service up for every frame
+static void BM_LookupPerFrame(benchmark::State &state)
+{
+    FakeServiceManager manager(kLookupDelay);
+    std::vector<SbwcDecompJob> jobs = makeJobs(state.range(0));
+
+    for (auto _ : state) {
+        for (const SbwcDecompJob &job : jobs) {
+            SbwcDecompConnection connection(manager.connector());
+            benchmark::DoNotOptimize(connection.decode(job));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * jobs.size());
+}
+BENCHMARK(BM_LookupPerFrame)->Arg(1)->Arg(4);
+
+static void BM_PersistentConnection(benchmark::State &state)
+{
+    FakeServiceManager manager(kLookupDelay);
+    SbwcDecompConnection connection(manager.connector());
+    std::vector<SbwcDecompJob> jobs = makeJobs(state.range(0));
+
+    for (auto _ : state) {
+        for (const SbwcDecompJob &job : jobs)
+            benchmark::DoNotOptimize(connection.decode(job));
+    }
+
+    state.SetItemsProcessed(state.iterations() * jobs.size());
+}
+BENCHMARK(BM_PersistentConnection)->Arg(1)->Arg(4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FakeSbwcDecompService.h"
+
+static const native_handle_t *fakeHandle(uintptr_t id)
+{
+    return reinterpret_cast<const native_handle_t *>(id);
+}
+
+static SbwcDecompJob fakeJob(uintptr_t id)
+{
+    return { fakeHandle(id), fakeHandle(id + 1), 0, 1920, 1080 };
+}
+
+TEST(SbwcDecompConnectionTest, LookupOnce)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+
+    for (uintptr_t i = 0; i < 10; i++)
+        EXPECT_TRUE(connection.decode(fakeJob(0x1000 + i * 2)));
+
+    EXPECT_EQ(manager.lookupCount, 1u);
+    EXPECT_EQ(manager.current->decodeCount, 10u);
+}
+
+TEST(SbwcDecompConnectionTest, ReconnectAfterDeath)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+
+    manager.current->dead = true;
+
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+    EXPECT_EQ(manager.lookupCount, 2u);
+    EXPECT_EQ(connection.getConnectCount(), 2u);
+}
+
+TEST(SbwcDecompConnectionTest, StaleDeathNotification)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+
+    FakeSbwcDecompService old;
+    connection.invalidate(&old);
+
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+    EXPECT_EQ(manager.lookupCount, 1u);
+}
+
+TEST(SbwcDecompConnectionTest, ServiceUnavailable)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+
+    manager.available = false;
+    EXPECT_FALSE(connection.decode(fakeJob(0x1000)));
+
+    manager.available = true;
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+}
+
+TEST(SbwcDecompConnectionTest, BatchPartialFailure)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+    std::vector<SbwcDecompJob> jobs = { fakeJob(0x1000), { nullptr, fakeHandle(0x2000), 0, 64, 64 }, fakeJob(0x3000) };
+    std::vector<bool> results;
+
+    EXPECT_FALSE(connection.decode(jobs, results));
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_FALSE(results[1]);
+    EXPECT_TRUE(results[2]);
+    EXPECT_EQ(manager.lookupCount, 1u);
+}
+
+TEST(SbwcDecompConnectionTest, BatchSurvivesDeath)
+{
+    FakeServiceManager manager;
+    SbwcDecompConnection connection(manager.connector());
+    std::vector<SbwcDecompJob> jobs = { fakeJob(0x1000), fakeJob(0x2000) };
+    std::vector<bool> results;
+
+    EXPECT_TRUE(connection.decode(fakeJob(0x1000)));
+    manager.current->dead = true;
+
+    EXPECT_TRUE(connection.decode(jobs, results));
+    EXPECT_EQ(manager.lookupCount, 2u);
+}
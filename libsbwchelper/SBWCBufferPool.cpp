@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2021 Samsung Electronics Co. Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SBWCBufferPool.h"
+
+namespace SBWCHelper
+{
+
+BufferPool::BufferPool(BufferAllocator &allocator, size_t maxIdle)
+	: mAllocator(allocator),
+	  mMaxIdle(maxIdle),
+	  mAllocated(0),
+	  mReused(0),
+	  mReleased(0)
+{
+}
+
+BufferPool::~BufferPool()
+{
+	std::list<AHardwareBuffer *> victims;
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		trimLocked(0, victims);
+	}
+
+	releaseAll(victims);
+}
+
+int BufferPool::get(const BufferKey &key, AHardwareBuffer **outAHB)
+{
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		auto found = mIdleIndex.find(key);
+		if (found != mIdleIndex.end())
+		{
+			AHardwareBuffer *ahb = found->second->ahb;
+
+			mIdle.erase(found->second);
+			mIdleIndex.erase(found);
+			mInUse.insert({ahb, key});
+			mReused++;
+
+			*outAHB = ahb;
+			return 0;
+		}
+	}
+
+	// Allocate outside the lock, the allocator may block for a long time
+	AHardwareBuffer *ahb = nullptr;
+	int result = mAllocator.allocate(key, &ahb);
+
+	if (result != 0)
+	{
+		return result;
+	}
+
+	std::lock_guard<std::mutex> lock(mLock);
+
+	mInUse.insert({ahb, key});
+	mAllocated++;
+
+	*outAHB = ahb;
+	return 0;
+}
+
+bool BufferPool::put(AHardwareBuffer *inAHB)
+{
+	std::list<AHardwareBuffer *> victims;
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		auto found = mInUse.find(inAHB);
+		if (found == mInUse.end())
+		{
+			return false;
+		}
+
+		BufferKey key = found->second;
+		mInUse.erase(found);
+
+		mIdle.push_front({key, inAHB});
+		mIdleIndex.insert({key, mIdle.begin()});
+
+		trimLocked(mMaxIdle, victims);
+	}
+
+	releaseAll(victims);
+
+	return true;
+}
+
+void BufferPool::trim(size_t keep)
+{
+	std::list<AHardwareBuffer *> victims;
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		trimLocked(keep, victims);
+	}
+
+	releaseAll(victims);
+}
+
+void BufferPool::setMaxIdle(size_t maxIdle)
+{
+	std::list<AHardwareBuffer *> victims;
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mMaxIdle = maxIdle;
+		trimLocked(mMaxIdle, victims);
+	}
+
+	releaseAll(victims);
+}
+
+BufferPool::Stats BufferPool::getStats()
+{
+	std::lock_guard<std::mutex> lock(mLock);
+
+	return {mAllocated, mReused, mReleased, mIdle.size(), mInUse.size()};
+}
+
+void BufferPool::trimLocked(size_t keep, std::list<AHardwareBuffer *> &victims)
+{
+	while (mIdle.size() > keep)
+	{
+		auto oldest = std::prev(mIdle.end());
+		auto range = mIdleIndex.equal_range(oldest->key);
+
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == oldest)
+			{
+				mIdleIndex.erase(it);
+				break;
+			}
+		}
+
+		victims.push_back(oldest->ahb);
+		mIdle.erase(oldest);
+		mReleased++;
+	}
+}
+
+void BufferPool::releaseAll(std::list<AHardwareBuffer *> &victims)
+{
+	for (AHardwareBuffer *ahb : victims)
+	{
+		mAllocator.release(ahb);
+	}
+}
+
+} // namespace SBWCHelper
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2021 Samsung Electronics Co. Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SBWC_BUFFER_POOL_H
+#define SBWC_BUFFER_POOL_H
+
+#include <list>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+struct AHardwareBuffer;
+
+namespace SBWCHelper
+{
+
+/** Attributes which decide whether two YUV buffers are interchangeable
+ */
+struct BufferKey
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint64_t usage;
+
+	bool operator==(const BufferKey &other) const
+	{
+		return (width == other.width) && (height == other.height)
+			&& (format == other.format) && (usage == other.usage);
+	}
+};
+
+struct BufferKeyHash
+{
+	size_t operator()(const BufferKey &key) const
+	{
+		uint64_t h = (static_cast<uint64_t>(key.width) << 32) | key.height;
+		h ^= (static_cast<uint64_t>(key.format) << 17) ^ key.usage;
+		return std::hash<uint64_t>()(h * 0x9E3779B97F4A7C15ULL);
+	}
+};
+
+/** Backend used by BufferPool to create and destroy buffers
+ */
+class BufferAllocator
+{
+public:
+	virtual ~BufferAllocator() = default;
+
+	/** Allocate a new buffer
+	 *
+	 * @param[in] key attributes of the buffer
+	 * @param[out] outAHB newly allocated buffer
+	 * @return 0 on success, error code otherwise
+	 */
+	virtual int allocate(const BufferKey &key, AHardwareBuffer **outAHB) = 0;
+
+	/** Destroy a buffer previously returned by allocate()
+	 *
+	 * @param[in] inAHB buffer to destroy
+	 */
+	virtual void release(AHardwareBuffer *inAHB) = 0;
+};
+
+/** Thread-safe pool of YUV buffers keyed by size and format
+ *
+ * Buffers returned with put() are not destroyed right away but kept idle
+ * so that the next get() with the same key reuses them. When the number of
+ * idle buffers exceeds maxIdle, the least recently returned one is released.
+ */
+class BufferPool
+{
+public:
+	struct Stats
+	{
+		uint64_t allocated;
+		uint64_t reused;
+		uint64_t released;
+		size_t idle;
+		size_t inUse;
+	};
+
+	BufferPool(BufferAllocator &allocator, size_t maxIdle);
+	~BufferPool();
+
+	BufferPool(const BufferPool &) = delete;
+	BufferPool &operator=(const BufferPool &) = delete;
+
+	/** Get a buffer, reusing an idle one when possible
+	 *
+	 * @param[in] key attributes of the buffer
+	 * @param[out] outAHB buffer handed out to the caller
+	 * @return 0 on success, error code of the allocator otherwise
+	 */
+	int get(const BufferKey &key, AHardwareBuffer **outAHB);
+
+	/** Return a buffer obtained with get() to the pool
+	 *
+	 * @param[in] inAHB buffer to return
+	 * @return false if the buffer does not belong to this pool
+	 */
+	bool put(AHardwareBuffer *inAHB);
+
+	/** Release idle buffers until at most keep of them remain
+	 *
+	 * @param[in] keep number of idle buffers to keep
+	 */
+	void trim(size_t keep);
+
+	/** Change the idle limit, trimming if needed
+	 *
+	 * @param[in] maxIdle new limit
+	 */
+	void setMaxIdle(size_t maxIdle);
+
+	Stats getStats();
+
+private:
+	struct IdleEntry
+	{
+		BufferKey key;
+		AHardwareBuffer *ahb;
+	};
+
+	void trimLocked(size_t keep, std::list<AHardwareBuffer *> &victims);
+	void releaseAll(std::list<AHardwareBuffer *> &victims);
+
+	BufferAllocator &mAllocator;
+	size_t mMaxIdle;
+
+	std::mutex mLock;
+
+	// Idle buffers, most recently returned at the front
+	std::list<IdleEntry> mIdle;
+	std::unordered_multimap<BufferKey, std::list<IdleEntry>::iterator, BufferKeyHash> mIdleIndex;
+	std::unordered_map<AHardwareBuffer *, BufferKey> mInUse;
+
+	uint64_t mAllocated;
+	uint64_t mReused;
+	uint64_t mReleased;
+};
+
+} // namespace SBWCHelper
+
+#endif // SBWC_BUFFER_POOL_H
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <mutex>
 #include <utility>
 #include <unordered_map>
 
@@ -29,6 +30,7 @@
 #include <vendor/samsung_slsi/hardware/SbwcDecompService/1.0/ISbwcDecompService.h>
 
 #include "SBWCHelper.h"
+#include "SBWCBufferPool.h"
 #include "exynos_format.h"
 #include "ExynosGraphicBufferCore.h"
 
@@ -42,11 +44,58 @@ static std::unordered_map<AHardwareBuffer*, AHardwareBuffer*> yuvToSbwc;
 static std::unordered_map<AHardwareBuffer*, AHardwareBuffer*> sbwcToYuv;
 static std::unordered_map<AHardwareBuffer*, int32_t> ref;
 
+// Protects yuvToSbwc, sbwcToYuv and ref
+static std::mutex mapLock;
+
+// Protects lastSrc, lastDst and the service connection
+static std::mutex decompLock;
 static buffer_handle_t lastSrc, lastDst;
 
 static bool debugEnabled = android::base::GetBoolProperty("vendor.sbwchelper.debug.enabled", false);
 static bool traceEnabled = android::base::GetBoolProperty("vendor.sbwchelper.trace.enabled", false);
 
+/** BufferAllocator backed by AHardwareBuffer_allocate()
+ */
+class AHBAllocator : public BufferAllocator
+{
+public:
+	int allocate(const BufferKey &key, AHardwareBuffer **outAHB) override
+	{
+		AHardwareBuffer_Desc desc;
+
+		desc.width = key.width;
+		desc.height = key.height;
+		desc.layers = 1;
+		desc.rfu0 = 0;
+		desc.rfu1 = 0;
+		desc.usage = key.usage;
+		desc.format = key.format;
+
+		return AHardwareBuffer_allocate(&desc, outAHB);
+	}
+
+	void release(AHardwareBuffer *inAHB) override
+	{
+		AHardwareBuffer_release(inAHB);
+	}
+};
+
+/** Get the pool YUV AHardwareBuffers are recycled through
+ *
+ * The pool is never destroyed to avoid releasing buffers after
+ * libnativewindow is torn down at process exit.
+ *
+ * @return pool instance
+ */
+static BufferPool &getYuvPool()
+{
+	static AHBAllocator *allocator = new AHBAllocator();
+	static BufferPool *pool = new BufferPool(*allocator,
+			android::base::GetUintProperty<size_t>("vendor.sbwchelper.pool.size", 4));
+
+	return *pool;
+}
+
 /** Check format is 10bit or not
  *
  * @param[in] format exynos HAL format
@@ -54,7 +103,7 @@ static bool traceEnabled = android::base::GetBoolProperty("vendor.sbwchelper.tra
  */
 static bool is10Bit(uint32_t format);
 
-/** Allocate YUV AHardwareBuffer used SBWC AHardwareBuffer's information
+/** Get YUV AHardwareBuffer from the pool used SBWC AHardwareBuffer's information
  *
  * @param[in] inSbwcAHB SBWC AHardwareBuffer
  * @param[out] outYuvAHB YUV AHardwareaBuffer
@@ -62,6 +111,24 @@ static bool is10Bit(uint32_t format);
  */
 static int64_t allocAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB);
 
+/** Take a reference to the YUV AHardwareBuffer registered for a SBWC one
+ *
+ * Must be called with mapLock held.
+ *
+ * @param[in] inSbwcAHB SBWC AHardwareBuffer
+ * @return registered YUV AHardwareBuffer, nullptr if there is none
+ */
+static AHardwareBuffer *refRegisteredYuvAHB(AHardwareBuffer *inSbwcAHB);
+
+/** Forget the last decompressed pair if it refers to the given YUV buffer
+ *
+ * Recycled YUV buffers keep their handle, so a stale pair could make
+ * requestDecompress() skip a decompression which is really needed.
+ *
+ * @param[in] inYuvAHB YUV AHardwareBuffer going back to the pool
+ */
+static void forgetLastRequest(AHardwareBuffer *inYuvAHB);
+
 /** Get attribute for SbwcDecompService
  *
  * @param[in] handle native handle used to set attribute
@@ -192,26 +259,23 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 		return false;
 	}
 
-	if (sbwcToYuv.count(inSbwcAHB) > 0)
 	{
-		AHardwareBuffer *yuvAHB = sbwcToYuv.at(inSbwcAHB);
+		std::lock_guard<std::mutex> lock(mapLock);
 
-		*outYuvAHB = yuvAHB;
-
-		ref.at(yuvAHB) += 1;
+		yuvAHB = refRegisteredYuvAHB(inSbwcAHB);
+	}
 
-		if (debugEnabled)
-		{
-			ALOGD("[SBWC] %s: Increase ref counter AHB: %p ref: %" PRId32 "", __func__, yuvAHB, ref.at(yuvAHB));
-		}
+	if (yuvAHB != nullptr)
+	{
+		*outYuvAHB = yuvAHB;
 
 		AHardwareBuffer_acquire(inSbwcAHB);
 
 		return true;
 	}
 
-	// Allocate AHB per every request now
-	// To do: Make more efficiently
+	// Reuse an idle YUV AHB of the same size and format if there is one,
+	// without mapLock as allocating a new one may block for a long time
 	result = allocAHB(inSbwcAHB, &yuvAHB);
 
 	if (result != android::NO_ERROR)
@@ -221,10 +285,28 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 		return false;
 	}
 
-	yuvToSbwc.insert({yuvAHB, inSbwcAHB});
-	sbwcToYuv.insert({inSbwcAHB, yuvAHB});
+	AHardwareBuffer *registeredAHB;
+
+	{
+		std::lock_guard<std::mutex> lock(mapLock);
+
+		// Another thread may have registered the same SBWC AHB meanwhile
+		registeredAHB = refRegisteredYuvAHB(inSbwcAHB);
+
+		if (registeredAHB == nullptr)
+		{
+			yuvToSbwc.insert({yuvAHB, inSbwcAHB});
+			sbwcToYuv.insert({inSbwcAHB, yuvAHB});
+
+			ref.insert({yuvAHB, 1});
+		}
+	}
 
-	ref.insert({yuvAHB, 1});
+	if (registeredAHB != nullptr)
+	{
+		getYuvPool().put(yuvAHB);
+		yuvAHB = registeredAHB;
+	}
 
 	*outYuvAHB = yuvAHB;
 
@@ -270,19 +352,24 @@ bool decompress(AHardwareBuffer *inSbwcAHB)
 		ALOGD("[SBWC] %s: inSbwcAHB: %p", __func__, inSbwcAHB);
 	}
 
-	if (sbwcToYuv.count(inSbwcAHB) <= 0)
+	AHardwareBuffer *yuvAHB;
+
 	{
-		ALOGE("[SBWC] %s: Invalid value \"Not registered SBWC AHB\" AHB: %p %s:%d",
-				__func__, inSbwcAHB, __FILE__, __LINE__);
-		return false;
-	}
+		std::lock_guard<std::mutex> lock(mapLock);
+
+		if (sbwcToYuv.count(inSbwcAHB) <= 0)
+		{
+			ALOGE("[SBWC] %s: Invalid value \"Not registered SBWC AHB\" AHB: %p %s:%d",
+					__func__, inSbwcAHB, __FILE__, __LINE__);
+			return false;
+		}
 
-	AHardwareBuffer *yuvAHB = sbwcToYuv.at(inSbwcAHB);
+		yuvAHB = sbwcToYuv.at(inSbwcAHB);
+	}
 
 	return requestDecompress(yuvAHB, inSbwcAHB);
 }
 
-// To do: Deferred free
 bool freeYuvAHB(AHardwareBuffer **inYuvAHB)
 {
 	AHardwareBuffer *sbwcAHB;
@@ -302,6 +389,8 @@ bool freeYuvAHB(AHardwareBuffer **inYuvAHB)
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(mapLock);
+
 	if ((yuvToSbwc.count(*inYuvAHB) == 0) || (ref.at(*inYuvAHB) <= 0))
 	{
 		ALOGE("[SBWC] %s: Invalid value \"Not registered YUV AHB\" %s:%d",
@@ -338,15 +427,13 @@ bool freeYuvAHB(AHardwareBuffer **inYuvAHB)
 				__func__, *inYuvAHB);
 	}
 
-	AHardwareBuffer_release(*inYuvAHB);
+	// Deferred free: keep the YUV AHB idle in the pool for the next request
+	forgetLastRequest(*inYuvAHB);
+	getYuvPool().put(*inYuvAHB);
 	AHardwareBuffer_release(sbwcAHB);
 
 	*inYuvAHB = nullptr;
 
-	if ((sbwcToYuv.size() == 0) && (yuvToSbwc.size() == 0)) {
-		lastSrc = lastDst = 0;
-	}
-
 	return true;
 }
 
@@ -382,67 +469,12 @@ uint32_t getByteStride(uint32_t format, uint32_t alloc_width, [[maybe_unused]] u
 AHardwareBuffer *newYuvAHB(AHardwareBuffer *sbwcAHB)
 {
 	AHardwareBuffer *yuvAHB = nullptr;
-	int64_t result = android::NO_ERROR;
-
-	if (sbwcAHB == nullptr || (!isSbwcFormat(sbwcAHB)))
-	{
-		ALOGE("[SBWC] %s: Invalid value \"%s\" %s:%d",
-				__func__,
-				(sbwcAHB == nullptr) ? "Null pointer" : "No SBWC",
-				__FILE__,
-				__LINE__);
-		return nullptr;
-	}
-
-	if (sbwcToYuv.count(sbwcAHB) > 0)
-	{
-		AHardwareBuffer *yuvAHB = sbwcToYuv.at(sbwcAHB);
-
-		ref.at(yuvAHB) += 1;
-
-		if (debugEnabled)
-		{
-			ALOGD("[SBWC] %s: Increase ref counter AHB: %p ref: %" PRId32 "", __func__, yuvAHB, ref.at(yuvAHB));
-		}
-
-		AHardwareBuffer_acquire(sbwcAHB);
 
-		return yuvAHB;
-	}
-
-	// Allocate AHB per every request now
-	// To do: Make more efficiently
-	result = allocAHB(sbwcAHB, &yuvAHB);
-
-	if (result != android::NO_ERROR)
+	if (!newYuvAHB(sbwcAHB, &yuvAHB))
 	{
-		ALOGE("[SBWC] %s: \"YUV allocation failed\" %s:%d",
-				__func__, __FILE__, __LINE__);
 		return nullptr;
 	}
 
-	yuvToSbwc.insert({yuvAHB, sbwcAHB});
-	sbwcToYuv.insert({sbwcAHB, yuvAHB});
-
-	ref.insert({yuvAHB, 1});
-
-	if (debugEnabled)
-	{
-		const native_handle_t *handle = AHardwareBuffer_getNativeHandle(sbwcAHB);
-		uint32_t format = ExynosGraphicBufferMeta::get_format(handle);
-
-		ALOGD("[SBWC] %s: inSbwcAHB: %p format: 0x%" PRIX32 "",
-				__func__, sbwcAHB, format);
-
-		handle = AHardwareBuffer_getNativeHandle(yuvAHB);
-		format = ExynosGraphicBufferMeta::get_format(handle);
-
-		ALOGD("[SBWC] %s: outYuvAHB: %p format: 0x%" PRIX32 "",
-				__func__, yuvAHB, format);
-	}
-
-	AHardwareBuffer_acquire(sbwcAHB);
-
 	return yuvAHB;
 }
 
@@ -460,6 +492,8 @@ bool freeYuvAHB(AHardwareBuffer *yuvAHB)
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(mapLock);
+
 	if ((yuvToSbwc.count(yuvAHB) == 0) || (ref.at(yuvAHB) <= 0))
 	{
 		ALOGE("[SBWC] %s: Invalid value \"Not registered YUV AHB: %p\" %s:%d",
@@ -494,13 +528,11 @@ bool freeYuvAHB(AHardwareBuffer *yuvAHB)
 		ALOGD("[SBWC] %s: Deleted YUV AHB: %p", __func__, yuvAHB);
 	}
 
-	AHardwareBuffer_release(yuvAHB);
+	// Deferred free: keep the YUV AHB idle in the pool for the next request
+	forgetLastRequest(yuvAHB);
+	getYuvPool().put(yuvAHB);
 	AHardwareBuffer_release(sbwcAHB);
 
-	if ((sbwcToYuv.size() == 0) && (yuvToSbwc.size() == 0)) {
-		lastSrc = lastDst = 0;
-	}
-
 	return true;
 }
 
@@ -553,28 +585,58 @@ static bool is10Bit(uint32_t format)
 static int64_t allocAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 {
 	const native_handle_t *handle = AHardwareBuffer_getNativeHandle(inSbwcAHB);
-	AHardwareBuffer_Desc desc;
+	BufferKey key;
 
-	desc.width = ExynosGraphicBufferMeta::get_width(handle);
-	desc.height = ExynosGraphicBufferMeta::get_height(handle);
-	desc.layers = 1;
-	desc.rfu0 = 0;
-	desc.rfu1 = 0;
-	desc.usage = ExynosGraphicBufferMeta::get_usage(handle);
-	desc.format = AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420;
+	key.width = ExynosGraphicBufferMeta::get_width(handle);
+	key.height = ExynosGraphicBufferMeta::get_height(handle);
+	key.usage = ExynosGraphicBufferMeta::get_usage(handle);
+	key.format = AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420;
 
 	switch (ExynosGraphicBufferMeta::get_format(handle)) {
 		case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC:
-			desc.format = HAL_PIXEL_FORMAT_YCBCR_P010; // 0x36
+			key.format = HAL_PIXEL_FORMAT_YCBCR_P010; // 0x36
 	}
 
 	/*
 	 * AHardwareBuffer allocation allowed YUV format as AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420 only
 	 * So we need to set 10bit flag to allocate 10bit format
 	 */
-	desc.usage |= is10Bit(ExynosGraphicBufferMeta::get_format(handle)) ? SBWC_REQUEST_10BIT : 0;
+	key.usage |= is10Bit(ExynosGraphicBufferMeta::get_format(handle)) ? SBWC_REQUEST_10BIT : 0;
 
-	return AHardwareBuffer_allocate(&desc, outYuvAHB);
+	return getYuvPool().get(key, outYuvAHB);
+}
+
+static AHardwareBuffer *refRegisteredYuvAHB(AHardwareBuffer *inSbwcAHB)
+{
+	auto found = sbwcToYuv.find(inSbwcAHB);
+
+	if (found == sbwcToYuv.end())
+	{
+		return nullptr;
+	}
+
+	AHardwareBuffer *yuvAHB = found->second;
+
+	ref.at(yuvAHB) += 1;
+
+	if (debugEnabled)
+	{
+		ALOGD("[SBWC] %s: Increase ref counter AHB: %p ref: %" PRId32 "", __func__, yuvAHB, ref.at(yuvAHB));
+	}
+
+	return yuvAHB;
+}
+
+static void forgetLastRequest(AHardwareBuffer *inYuvAHB)
+{
+	const native_handle_t *yuvHandle = AHardwareBuffer_getNativeHandle(inYuvAHB);
+
+	std::lock_guard<std::mutex> lock(decompLock);
+
+	if (lastSrc == yuvHandle)
+	{
+		lastSrc = lastDst = 0;
+	}
 }
 
 static uint32_t getAttr(const native_handle_t *handle)
@@ -601,6 +663,8 @@ static bool requestDecompress(AHardwareBuffer *inYuvAHB, AHardwareBuffer *inSbwc
 
 	static android::sp<ISbwcDecompService> sbwcDecompService = nullptr;
 
+	std::lock_guard<std::mutex> lock(decompLock);
+
 	if ((lastSrc == yuvHandle) && (lastDst == sbwcHandle)) {
 		if (debugEnabled) {
 			ALOGD("[SBWC] Skip decompress because same request");
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Samsung Electronics Co. Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../SBWCBufferPool.h"
+#include "SBWCFakeAllocator.h"
+
+using namespace SBWCHelper;
+
+static const BufferKey fhdKey = {1920, 1080, 0x23, 0x100};
+
+/* One SBWC frame passing through the helper without pooling: allocate then free */
+static void BM_AllocateEveryFrame(benchmark::State &state)
+{
+	FakeAllocator allocator;
+
+	for (auto _ : state)
+	{
+		AHardwareBuffer *ahb = nullptr;
+
+		allocator.allocate(fhdKey, &ahb);
+		benchmark::DoNotOptimize(ahb);
+		allocator.release(ahb);
+	}
+}
+BENCHMARK(BM_AllocateEveryFrame);
+
+/* The same frame going through the pool, state.range(0) buffers in flight */
+static void BM_PooledFrame(benchmark::State &state)
+{
+	static FakeAllocator allocator;
+	static BufferPool pool(allocator, 16);
+
+	const int inFlight = state.range(0);
+	AHardwareBuffer *ahb[16];
+
+	for (auto _ : state)
+	{
+		for (int i = 0; i < inFlight; i++)
+		{
+			pool.get(fhdKey, &ahb[i]);
+		}
+
+		for (int i = 0; i < inFlight; i++)
+		{
+			pool.put(ahb[i]);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * inFlight);
+}
+BENCHMARK(BM_PooledFrame)->Arg(1)->Arg(4)->ThreadRange(1, 4);
+
+BENCHMARK_MAIN();
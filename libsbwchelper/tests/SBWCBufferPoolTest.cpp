@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021 Samsung Electronics Co. Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../SBWCBufferPool.h"
+#include "SBWCFakeAllocator.h"
+
+using namespace SBWCHelper;
+
+static const BufferKey fhdKey = {1920, 1080, 0x23, 0x100};
+static const BufferKey uhdKey = {3840, 2160, 0x23, 0x100};
+
+TEST(SBWCBufferPoolTest, ReuseSameKey)
+{
+	FakeAllocator allocator;
+	BufferPool pool(allocator, 4);
+
+	AHardwareBuffer *first = nullptr;
+	AHardwareBuffer *second = nullptr;
+
+	EXPECT_EQ(pool.get(fhdKey, &first), 0);
+	EXPECT_TRUE(pool.put(first));
+	EXPECT_EQ(pool.get(fhdKey, &second), 0);
+
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(allocator.allocated(), 1);
+
+	EXPECT_TRUE(pool.put(second));
+}
+
+TEST(SBWCBufferPoolTest, NoReuseDifferentKey)
+{
+	FakeAllocator allocator;
+	BufferPool pool(allocator, 4);
+
+	AHardwareBuffer *fhd = nullptr;
+	AHardwareBuffer *uhd = nullptr;
+
+	EXPECT_EQ(pool.get(fhdKey, &fhd), 0);
+	EXPECT_TRUE(pool.put(fhd));
+	EXPECT_EQ(pool.get(uhdKey, &uhd), 0);
+
+	EXPECT_NE(fhd, uhd);
+	EXPECT_EQ(allocator.allocated(), 2);
+
+	EXPECT_TRUE(pool.put(uhd));
+}
+
+TEST(SBWCBufferPoolTest, PutUnknownBuffer)
+{
+	FakeAllocator allocator;
+	BufferPool pool(allocator, 4);
+
+	AHardwareBuffer *ahb = nullptr;
+
+	EXPECT_EQ(pool.get(fhdKey, &ahb), 0);
+	EXPECT_TRUE(pool.put(ahb));
+	EXPECT_FALSE(pool.put(ahb));
+}
+
+TEST(SBWCBufferPoolTest, IdleLimitReleasesOldest)
+{
+	FakeAllocator allocator;
+	BufferPool pool(allocator, 2);
+
+	AHardwareBuffer *ahb[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(pool.get(fhdKey, &ahb[i]), 0);
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_TRUE(pool.put(ahb[i]));
+	}
+
+	EXPECT_EQ(allocator.live(), 2);
+	EXPECT_FALSE(allocator.isLive(ahb[0]));
+
+	pool.trim(0);
+	EXPECT_EQ(allocator.live(), 0);
+}
+
+TEST(SBWCBufferPoolTest, ConcurrentGetPut)
+{
+	FakeAllocator allocator;
+	BufferPool pool(allocator, 8);
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 8; t++)
+	{
+		threads.emplace_back([&pool]() {
+			for (int i = 0; i < 1000; i++)
+			{
+				AHardwareBuffer *ahb = nullptr;
+
+				ASSERT_EQ(pool.get(fhdKey, &ahb), 0);
+				ASSERT_TRUE(pool.put(ahb));
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	BufferPool::Stats stats = pool.getStats();
+
+	EXPECT_EQ(stats.inUse, 0u);
+	EXPECT_LE(allocator.allocated(), 8);
+	EXPECT_EQ(stats.allocated + stats.reused, 8000u);
+}
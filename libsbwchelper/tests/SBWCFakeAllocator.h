@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Samsung Electronics Co. Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SBWC_FAKE_ALLOCATOR_H
+#define SBWC_FAKE_ALLOCATOR_H
+
+#include <mutex>
+#include <cstring>
+#include <unordered_set>
+
+#include "../SBWCBufferPool.h"
+
+/** Heap backed BufferAllocator to run BufferPool without gralloc
+ *
+ * Every allocation touches its whole backing store, so that the cost of a
+ * miss roughly follows the cost of a real allocation which zeroes memory.
+ */
+class FakeAllocator : public SBWCHelper::BufferAllocator
+{
+public:
+	~FakeAllocator()
+	{
+		for (AHardwareBuffer *ahb : mLive)
+		{
+			delete[] reinterpret_cast<uint8_t *>(ahb);
+		}
+	}
+
+	int allocate(const SBWCHelper::BufferKey &key, AHardwareBuffer **outAHB) override
+	{
+		size_t size = static_cast<size_t>(key.width) * key.height * 3 / 2;
+		uint8_t *data = new uint8_t[size];
+
+		memset(data, 0, size);
+
+		std::lock_guard<std::mutex> lock(mLock);
+
+		*outAHB = reinterpret_cast<AHardwareBuffer *>(data);
+		mLive.insert(*outAHB);
+		mAllocated++;
+
+		return 0;
+	}
+
+	void release(AHardwareBuffer *inAHB) override
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		if (mLive.erase(inAHB) > 0)
+		{
+			delete[] reinterpret_cast<uint8_t *>(inAHB);
+		}
+	}
+
+	int allocated()
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		return mAllocated;
+	}
+
+	int live()
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		return mLive.size();
+	}
+
+	bool isLive(AHardwareBuffer *inAHB)
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		return mLive.count(inAHB) > 0;
+	}
+
+private:
+	std::mutex mLock;
+	std::unordered_set<AHardwareBuffer *> mLive;
+	int mAllocated = 0;
+};
+
+#endif // SBWC_FAKE_ALLOCATOR_H
@@ -0,0 +1,140 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "sbwcdecoder_sw.h"
+
+// Stripes shorter than this cost more to hand over than to copy
+#define SW_SBWC_MIN_STRIPE_LINES    64
+
+SwSbwcDecoder::SwSbwcDecoder(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+
+    mThreadCount = threadCount;
+
+    // The calling thread copies stripes too
+    for (unsigned int i = 1; i < mThreadCount; i++)
+        mWorkers.emplace_back(&SwSbwcDecoder::workerLoop, this);
+}
+
+SwSbwcDecoder::~SwSbwcDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mExit = true;
+    }
+    mWorkCond.notify_all();
+
+    for (auto &worker : mWorkers)
+        worker.join();
+}
+
+size_t SwSbwcDecoder::getContentStride(unsigned int width, unsigned int bytesPerSample)
+{
+    size_t samples = (static_cast<size_t>(width) + SW_SBWC_LINE_ALIGN - 1) / SW_SBWC_LINE_ALIGN * SW_SBWC_LINE_ALIGN;
+
+    return samples * bytesPerSample;
+}
+
+void SwSbwcDecoder::copyLines(const Stripe &stripe)
+{
+    const SwSbwcPlane &plane = *stripe.plane;
+    const uint8_t *src = plane.src + stripe.first * plane.srcStride;
+    uint8_t *dst = plane.dst + stripe.first * plane.dstStride;
+
+    for (unsigned int l = stripe.first; l < stripe.last; l++) {
+        memcpy(dst, src, plane.lineBytes);
+        src += plane.srcStride;
+        dst += plane.dstStride;
+    }
+}
+
+void SwSbwcDecoder::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true) {
+        mWorkCond.wait(lock, [this] { return mExit || !mStripes.empty(); });
+        if (mExit)
+            return;
+
+        Stripe stripe = mStripes.back();
+        mStripes.pop_back();
+
+        lock.unlock();
+        copyLines(stripe);
+        lock.lock();
+
+        if (--mPending == 0)
+            mDoneCond.notify_all();
+    }
+}
+
+bool SwSbwcDecoder::decodePlanes(const SwSbwcPlane *planes, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        const SwSbwcPlane &plane = planes[i];
+
+        if (!plane.src || !plane.dst || plane.lineBytes == 0 || plane.lines == 0)
+            return false;
+
+        if (plane.lineBytes > plane.srcStride || plane.lineBytes > plane.dstStride)
+            return false;
+    }
+
+    if (mThreadCount == 1) {
+        for (unsigned int i = 0; i < count; i++)
+            copyLines({ &planes[i], 0, planes[i].lines });
+        return true;
+    }
+
+    // The pending count covers one frame at a time
+    std::lock_guard<std::mutex> decodeLock(mDecodeLock);
+    std::unique_lock<std::mutex> lock(mLock);
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int lines = planes[i].lines;
+        unsigned int stripes = std::max(1u, std::min(mThreadCount, lines / SW_SBWC_MIN_STRIPE_LINES));
+        unsigned int linesPerStripe = (lines + stripes - 1) / stripes;
+
+        for (unsigned int first = 0; first < lines; first += linesPerStripe) {
+            mStripes.push_back({ &planes[i], first, std::min(lines, first + linesPerStripe) });
+            mPending++;
+        }
+    }
+    mWorkCond.notify_all();
+
+    // Take part in the copy instead of sleeping until the workers are done
+    while (!mStripes.empty()) {
+        Stripe stripe = mStripes.back();
+        mStripes.pop_back();
+
+        lock.unlock();
+        copyLines(stripe);
+        lock.lock();
+
+        mPending--;
+    }
+
+    mDoneCond.wait(lock, [this] { return mPending == 0; });
+
+    return true;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SBWCDECODER_SW_H__
+#define __SBWCDECODER_SW_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Producers that cannot compress (e.g. MFC with SBWC disabled) write plain
+ * YUV into a buffer allocated as SBWC and report the real format in
+ * ExynosVideoMeta::nPixelFormat. gralloc sizes lossless SBWC buffers so
+ * that such content fits: lines are aligned to 32 samples, 8-bit samples
+ * take one byte and 10-bit samples take a P010 word.
+ */
+#define SW_SBWC_LINE_ALIGN          32
+
+struct SwSbwcPlane {
+    const uint8_t *src;         // first line of the source plane
+    size_t srcStride;           // bytes between two source lines
+    uint8_t *dst;               // first line of the destination plane
+    size_t dstStride;           // bytes between two destination lines
+    size_t lineBytes;           // bytes copied per line
+    unsigned int lines;
+};
+
+/*
+ * CPU decoder for SBWC buffers holding uncompressed content.
+ * The lines of all planes are split into stripes and copied by a
+ * persistent worker pool. With one thread it is the reference path.
+ */
+class SwSbwcDecoder {
+public:
+    explicit SwSbwcDecoder(unsigned int threadCount = 0);
+    ~SwSbwcDecoder();
+
+    bool decodePlanes(const SwSbwcPlane *planes, unsigned int count);
+
+    unsigned int getThreadCount() const { return mThreadCount; }
+
+    // Bytes between two lines of uncompressed content in an SBWC buffer
+    static size_t getContentStride(unsigned int width, unsigned int bytesPerSample);
+
+private:
+    struct Stripe {
+        const SwSbwcPlane *plane;
+        unsigned int first;
+        unsigned int last;
+    };
+
+    static void copyLines(const Stripe &stripe);
+    void workerLoop();
+
+    unsigned int mThreadCount;
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mDecodeLock;
+    std::mutex mLock;
+    std::condition_variable mWorkCond;
+    std::condition_variable mDoneCond;
+    std::vector<Stripe> mStripes;
+    unsigned int mPending = 0;
+    bool mExit = false;
+};
+
+#endif // __SBWCDECODER_SW_H__
@@ -25,6 +25,7 @@
 
 #include "sbwcwrapper_common.h"
 #include "sbwcwrapper_mscl.h"
+#include "sbwcwrapper_sw.h"
 #ifdef LIBSBWC_DPU_ENABLED
 #include <hardware/exynos/sbwcdecoder_dpu.h>
 #else
@@ -39,6 +40,7 @@ enum decodeIP_t {
 
     DECODE_IP_MSCL = 1,
     DECODE_IP_DPU = 2,
+    DECODE_IP_SW = 3,
 };
 
 SbwcDecoderIP::SbwcDecoderIP(int decodeIPType) : mDecodeIPType(decodeIPType){
@@ -49,6 +51,9 @@ SbwcDecoderIP::SbwcDecoderIP(int decodeIPType) : mDecodeIPType(decodeIPType){
     case DECODE_IP_MSCL:
         mHandleIP = new SbwcAcrylInfo();
         break;
+    case DECODE_IP_SW:
+        mHandleIP = new SwSbwcDecoder();
+        break;
     default:
         ALOGE("failed to create SbwcDecoder type %d", decodeIPType);
         mHandleIP = NULL;
@@ -64,6 +69,9 @@ SbwcDecoderIP::~SbwcDecoderIP() {
     case DECODE_IP_MSCL:
         delete static_cast<SbwcAcrylInfo*>(mHandleIP);
         break;
+    case DECODE_IP_SW:
+        delete static_cast<SwSbwcDecoder*>(mHandleIP);
+        break;
     default:
         ALOGE("failed to remove SbwcDecoder type %d", mDecodeIPType);
         break;
@@ -81,6 +89,7 @@ static struct sbwcDecoderInfo {
 } arrDecoderInfo[] = {
     { "Dpu", 3, DECODE_IP_DPU },
     { "Mscl", 4, DECODE_IP_MSCL },
+    { "Sw", 2, DECODE_IP_SW },
 };
 
 bool SbwcWrapper::initSbwcDecoder(void)
@@ -88,6 +97,9 @@ bool SbwcWrapper::initSbwcDecoder(void)
     const char *priority = LIBSBWC_DECODER_PRIORITY;
     unsigned int i;
 
+    // SbwcDecoderIP owns its handle, so the vector must not reallocate
+    mVecSbwcDecoderIP.reserve(strlen(priority));
+
     while (*priority != '\0') {
         for (i = 0; i < ARRSIZE(arrDecoderInfo); i++) {
             if (strncmp(priority, arrDecoderInfo[i].name, arrDecoderInfo[i].len) == 0) {
@@ -196,6 +208,9 @@ bool SbwcWrapper::decode(void *srcHandle, void *dstHandle, unsigned int attr, un
         case DECODE_IP_MSCL:
             ret = decodeMSCL(decoderIP.mHandleIP, srcBH, dstBH, attr, cropWidth, cropHeight, framerate);
             break;
+        case DECODE_IP_SW:
+            ret = decodeSW(decoderIP.mHandleIP, srcBH, dstBH, attr, cropWidth, cropHeight);
+            break;
         default:
             ALOGE("invalid name for sbwc decompress IP type %d", decoderIP.mDecodeIPType);
             ret = false;
@@ -0,0 +1,178 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/mman.h>
+
+#include <log/log.h>
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+#include <exynos_format.h>
+
+#include "sbwcwrapper_common.h"
+#include "sbwcwrapper_sw.h"
+
+enum swSampleLayout_t {
+    SW_LAYOUT_NONE = 0,
+
+    SW_LAYOUT_CBCR_8B,
+    SW_LAYOUT_CRCB_8B,
+    SW_LAYOUT_CBCR_16B,
+};
+
+/* Layout of the uncompressed content a lossless SBWC buffer has room for */
+static swSampleLayout_t getSbwcBufferLayout(int format)
+{
+    switch (format) {
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_SBWC:
+        return SW_LAYOUT_CBCR_8B;
+    case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M_SBWC:
+        return SW_LAYOUT_CRCB_8B;
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_10B_SBWC:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN_10B_SBWC:
+        return SW_LAYOUT_CBCR_16B;
+    default:
+        // Lossy buffers are too small to hold uncompressed content
+        return SW_LAYOUT_NONE;
+    }
+}
+
+static swSampleLayout_t getPlainLayout(int format)
+{
+    switch (format) {
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
+    case HAL_PIXEL_FORMAT_EXYNOS_420_SPN_SBWC_DECOMP:
+        return SW_LAYOUT_CBCR_8B;
+    case HAL_PIXEL_FORMAT_YCrCb_420_SP:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
+        return SW_LAYOUT_CRCB_8B;
+    case HAL_PIXEL_FORMAT_YCBCR_P010:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_P010_M:
+    case HAL_PIXEL_FORMAT_EXYNOS_P010_N_SBWC_DECOMP:
+        return SW_LAYOUT_CBCR_16B;
+    default:
+        return SW_LAYOUT_NONE;
+    }
+}
+
+class SwBufferMapping {
+public:
+    SwBufferMapping(int fd, size_t len, int prot) : mLen(len) {
+        mAddr = (fd < 0 || len == 0) ? MAP_FAILED : mmap(0, len, prot, MAP_SHARED, fd, 0);
+    }
+    ~SwBufferMapping() {
+        if (mAddr != MAP_FAILED)
+            munmap(mAddr, mLen);
+    }
+
+    uint8_t *get() { return (mAddr == MAP_FAILED) ? nullptr : static_cast<uint8_t *>(mAddr); }
+    size_t size() { return mLen; }
+
+private:
+    void *mAddr;
+    size_t mLen;
+};
+
+/* Start of a plane of lines x stride bytes: its own fd, or an offset in the fd of the luma */
+static uint8_t *getPlane(SwBufferMapping *own, SwBufferMapping &luma, int64_t offset,
+                         unsigned int lines, size_t stride, size_t lineBytes)
+{
+    SwBufferMapping &mapping = (own && own->get()) ? *own : luma;
+
+    if (&mapping != &luma)
+        offset = 0;
+
+    if (!mapping.get() || offset < 0)
+        return nullptr;
+
+    size_t end = static_cast<size_t>(offset) + (lines - 1) * stride + lineBytes;
+    if (end > mapping.size())
+        return nullptr;
+
+    return mapping.get() + offset;
+}
+
+bool decodeSW(void *decoderHandle, buffer_handle_t srcBH, buffer_handle_t dstBH,
+              unsigned int attr, unsigned int cropWidth, unsigned int cropHeight)
+{
+    ATRACE_CALL();
+
+    auto *decoder = static_cast<SwSbwcDecoder*>(decoderHandle);
+    if (!decoder || cropWidth == 0 || cropHeight == 0)
+        return false;
+
+    // Protected buffers cannot be accessed by CPU
+    if (attr & SBWCDECODER_ATTR_SECURE_BUFFER)
+        return false;
+
+    // Compressed content has no format in the video meta, leave it to the hardware
+    int contentFmt = getFormatFromVideoMeta(srcBH);
+    if (contentFmt <= 0)
+        return false;
+
+    swSampleLayout_t layout = getSbwcBufferLayout(ExynosGraphicBufferMeta::get_internal_format(srcBH));
+    if (layout == SW_LAYOUT_NONE || getPlainLayout(contentFmt) != layout) {
+        ALOGD("content format %#x is not supported by software decoder", contentFmt);
+        return false;
+    }
+
+    int dstFmt = getFormatFromVideoMeta(dstBH);
+    if (!dstFmt)
+        dstFmt = ExynosGraphicBufferMeta::get_internal_format(dstBH);
+
+    if (getPlainLayout(dstFmt) != layout) {
+        ALOGD("format %#x cannot take content format %#x", dstFmt, contentFmt);
+        return false;
+    }
+
+    unsigned int bytesPerSample = (layout == SW_LAYOUT_CBCR_16B) ? 2 : 1;
+    size_t srcStride = SwSbwcDecoder::getContentStride(ExynosGraphicBufferMeta::get_stride(srcBH), bytesPerSample);
+    size_t dstStride = static_cast<size_t>(ExynosGraphicBufferMeta::get_stride(dstBH)) * bytesPerSample;
+    size_t lumaBytes = static_cast<size_t>(cropWidth) * bytesPerSample;
+    size_t chromaBytes = static_cast<size_t>((cropWidth + 1) & ~1u) * bytesPerSample;
+    unsigned int chromaLines = (cropHeight + 1) / 2;
+
+    bool multiFd = ExynosGraphicBufferMeta::get_num_image_fds(srcBH) > 1;
+    SwBufferMapping srcY(ExynosGraphicBufferMeta::get_fd(srcBH, 0), ExynosGraphicBufferMeta::get_size(srcBH, 0), PROT_READ);
+    SwBufferMapping srcC(multiFd ? ExynosGraphicBufferMeta::get_fd(srcBH, 1) : -1,
+                         multiFd ? ExynosGraphicBufferMeta::get_size(srcBH, 1) : 0, PROT_READ);
+
+    multiFd = ExynosGraphicBufferMeta::get_num_image_fds(dstBH) > 1;
+    SwBufferMapping dstY(ExynosGraphicBufferMeta::get_fd(dstBH, 0), ExynosGraphicBufferMeta::get_size(dstBH, 0), PROT_READ | PROT_WRITE);
+    SwBufferMapping dstC(multiFd ? ExynosGraphicBufferMeta::get_fd(dstBH, 1) : -1,
+                         multiFd ? ExynosGraphicBufferMeta::get_size(dstBH, 1) : 0, PROT_READ | PROT_WRITE);
+
+    SwSbwcPlane planes[2] = {
+        { getPlane(nullptr, srcY, 0, cropHeight, srcStride, lumaBytes), srcStride,
+          getPlane(nullptr, dstY, 0, cropHeight, dstStride, lumaBytes), dstStride,
+          lumaBytes, cropHeight },
+        { getPlane(&srcC, srcY, ExynosGraphicBufferMeta::get_plane_offset(srcBH, 1), chromaLines, srcStride, chromaBytes), srcStride,
+          getPlane(&dstC, dstY, ExynosGraphicBufferMeta::get_plane_offset(dstBH, 1), chromaLines, dstStride, chromaBytes), dstStride,
+          chromaBytes, chromaLines },
+    };
+
+    if (!planes[0].src || !planes[0].dst || !planes[1].src || !planes[1].dst) {
+        ALOGE("crop %ux%u does not fit in buffers", cropWidth, cropHeight);
+        return false;
+    }
+
+    return decoder->decodePlanes(planes, 2);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SBWCWRAPPER_SW_H__
+#define __SBWCWRAPPER_SW_H__
+
+#include "sbwcdecoder_sw.h"
+
+bool decodeSW(void *decoderHandle, buffer_handle_t srcBH, buffer_handle_t dstBH,
+              unsigned int attr, unsigned int cropWidth, unsigned int cropHeight);
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "SwSbwcTestFrame.h"
+
+/* Args: thread count, bytes per sample */
+static void BM_DecodeFrame(benchmark::State &state, unsigned int width, unsigned int height)
+{
+    SwSbwcDecoder decoder(state.range(0));
+    SwSbwcTestFrame frame(width, height, state.range(1));
+    SwSbwcPlane planes[2];
+
+    frame.planes(planes);
+
+    for (auto _ : state) {
+        decoder.decodePlanes(planes, 2);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * frame.dst.size());
+    state.counters["fps"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_DecodeFrame, FHD, 1920, 1080)
+    ->ArgsProduct({ { 1, 2, 4 }, { 1, 2 } })
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeFrame, UHD, 3840, 2160)
+    ->ArgsProduct({ { 1, 2, 4 }, { 1, 2 } })
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
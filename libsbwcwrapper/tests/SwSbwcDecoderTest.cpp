@@ -0,0 +1,124 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "SwSbwcTestFrame.h"
+
+/* Sample by sample, and the padding of the destination lines stays untouched */
+static void expectCopied(SwSbwcTestFrame &frame)
+{
+    SwSbwcPlane planes[2];
+
+    frame.planes(planes);
+
+    for (const SwSbwcPlane &plane : planes) {
+        for (unsigned int l = 0; l < plane.lines; l++) {
+            for (size_t x = 0; x < plane.dstStride; x++) {
+                uint8_t expected = (x < plane.lineBytes) ? plane.src[l * plane.srcStride + x] : 0xEE;
+
+                ASSERT_EQ(expected, plane.dst[l * plane.dstStride + x]) << "at " << x << "," << l;
+            }
+        }
+    }
+}
+
+TEST(SwSbwcDecoderTest, ContentStride)
+{
+    EXPECT_EQ(1024u, SwSbwcDecoder::getContentStride(1000, 1));
+    EXPECT_EQ(1920u, SwSbwcDecoder::getContentStride(1920, 1));
+    EXPECT_EQ(3840u, SwSbwcDecoder::getContentStride(1920, 2));
+    EXPECT_EQ(64u, SwSbwcDecoder::getContentStride(1, 2));
+}
+
+TEST(SwSbwcDecoderTest, Reference)
+{
+    SwSbwcDecoder decoder(1);
+
+    for (unsigned int bps : { 1u, 2u }) {
+        SwSbwcTestFrame frame(1000, 563, bps, 24);
+        SwSbwcPlane planes[2];
+
+        frame.planes(planes);
+        ASSERT_TRUE(decoder.decodePlanes(planes, 2));
+        expectCopied(frame);
+    }
+}
+
+TEST(SwSbwcDecoderTest, ThreadedMatchesReference)
+{
+    SwSbwcDecoder reference(1);
+    SwSbwcTestFrame golden(3840, 2160, 2, 64);
+    SwSbwcPlane planes[2];
+
+    golden.planes(planes);
+    ASSERT_TRUE(reference.decodePlanes(planes, 2));
+
+    for (unsigned int threads : { 2u, 3u, 4u, 8u }) {
+        SwSbwcDecoder decoder(threads);
+        SwSbwcTestFrame frame(3840, 2160, 2, 64);
+
+        frame.planes(planes);
+        ASSERT_TRUE(decoder.decodePlanes(planes, 2));
+        EXPECT_EQ(golden.dst, frame.dst) << threads << " threads";
+    }
+}
+
+TEST(SwSbwcDecoderTest, FewerLinesThanThreads)
+{
+    SwSbwcDecoder decoder(8);
+
+    for (unsigned int height : { 1u, 3u, 65u, 130u }) {
+        SwSbwcTestFrame frame(33, height, 1);
+        SwSbwcPlane planes[2];
+
+        frame.planes(planes);
+        ASSERT_TRUE(decoder.decodePlanes(planes, 2));
+        expectCopied(frame);
+    }
+}
+
+TEST(SwSbwcDecoderTest, RepeatedFrames)
+{
+    SwSbwcDecoder decoder(4);
+    SwSbwcTestFrame frame(1920, 1080, 1);
+    SwSbwcPlane planes[2];
+
+    frame.planes(planes);
+    for (int i = 0; i < 50; i++)
+        ASSERT_TRUE(decoder.decodePlanes(planes, 2));
+    expectCopied(frame);
+}
+
+TEST(SwSbwcDecoderTest, RejectInvalidPlane)
+{
+    SwSbwcDecoder decoder(2);
+    SwSbwcTestFrame frame(64, 16, 1);
+    SwSbwcPlane planes[2];
+
+    frame.planes(planes);
+    planes[1].lineBytes = planes[1].dstStride + 1;
+    EXPECT_FALSE(decoder.decodePlanes(planes, 2));
+
+    frame.planes(planes);
+    planes[0].src = nullptr;
+    EXPECT_FALSE(decoder.decodePlanes(planes, 2));
+
+    frame.planes(planes);
+    planes[0].lines = 0;
+    EXPECT_FALSE(decoder.decodePlanes(planes, 2));
+}
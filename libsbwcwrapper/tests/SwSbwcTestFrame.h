@@ -0,0 +1,61 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SW_SBWC_TEST_FRAME_H__
+#define __SW_SBWC_TEST_FRAME_H__
+
+#include <vector>
+
+#include "../sbwcdecoder_sw.h"
+
+/*
+ * Semi-planar 4:2:0 frame as a producer without compression leaves it in
+ * an SBWC buffer, and a linear destination with its own stride.
+ */
+struct SwSbwcTestFrame {
+    unsigned int width;
+    unsigned int height;
+    unsigned int bytesPerSample;
+    size_t srcStride;
+    size_t dstStride;
+    std::vector<uint8_t> src;
+    std::vector<uint8_t> dst;
+
+    SwSbwcTestFrame(unsigned int w, unsigned int h, unsigned int bps, unsigned int dstPad = 0)
+        : width(w), height(h), bytesPerSample(bps)
+    {
+        srcStride = SwSbwcDecoder::getContentStride(w, bps);
+        dstStride = (((w + 1) & ~1u) + dstPad) * bps;
+        src.resize(srcStride * (h + chromaLines()));
+        dst.assign(dstStride * (h + chromaLines()), 0xEE);
+
+        for (size_t i = 0; i < src.size(); i++)
+            src[i] = static_cast<uint8_t>(i * 7 + i / srcStride);
+    }
+
+    unsigned int chromaLines() const { return (height + 1) / 2; }
+
+    void planes(SwSbwcPlane out[2])
+    {
+        out[0] = { src.data(), srcStride, dst.data(), dstStride,
+                   static_cast<size_t>(width) * bytesPerSample, height };
+        out[1] = { src.data() + srcStride * height, srcStride, dst.data() + dstStride * height, dstStride,
+                   static_cast<size_t>((width + 1) & ~1u) * bytesPerSample, chromaLines() };
+    }
+};
+
+#endif // __SW_SBWC_TEST_FRAME_H__
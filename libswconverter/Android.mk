@@ -5,7 +5,19 @@ include $(CLEAR_VARS)
 LOCAL_MODULE_TAGS := optional
 
 LOCAL_SRC_FILES := \
-	swconvertor.c
+	swconvertor.c \
+	swconverter_kernels.c
+
+LOCAL_SRC_FILES_arm64 := \
+	swconverter_neon64.c
+
+LOCAL_SRC_FILES_x86 := \
+	swconverter_sse41.c \
+	swconverter_avx2.c
+
+LOCAL_SRC_FILES_x86_64 := \
+	swconverter_sse41.c \
+	swconverter_avx2.c
 
 ifeq ($(TARGET_ARCH), arm)
 ifeq ($(ARCH_ARM_HAVE_NEON),true)
@@ -0,0 +1,381 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_avx2.c
+ *
+ * @brief   AVX2 kernels of the CSC functions
+ *   Same arithmetic as swconverter_sse41.c on twice the pixels.
+ *   Most AVX2 instructions work on two 128 bit lanes, the packs are
+ *   followed by a permute to put the pixels back in order.
+ *
+ * @version 1.0
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <string.h>
+#include <immintrin.h>
+#include "swconverter_kernels.h"
+
+#define AVX2 __attribute__((target("avx2")))
+
+/* [a0 b0 | a1 b1] to [a0 a1 b0 b1] in 64 bit units */
+#define IN_ORDER(x) _mm256_permute4x64_epi64((x), 0xD8)
+
+AVX2 static void csc_interleave_memcpy_avx2(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int   src_size)
+{
+    unsigned int i;
+
+    for (i = 0; i + 32 <= src_size; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src2 + i));
+        __m256i lo = _mm256_unpacklo_epi8(a, b);
+        __m256i hi = _mm256_unpackhi_epi8(a, b);
+
+        _mm256_storeu_si256((__m256i *)(dest + i * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dest + i * 2 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    for (; i < src_size; i++) {
+        dest[i * 2] = src1[i];
+        dest[i * 2 + 1] = src2[i];
+    }
+}
+
+AVX2 static void csc_deinterleave_memcpy_avx2(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int   src_size)
+{
+    const __m256i low = _mm256_set1_epi16(0x00FF);
+    unsigned int i;
+
+    for (i = 0; i + 32 <= src_size / 2; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i * 2));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + i * 2 + 32));
+
+        _mm256_storeu_si256((__m256i *)(dest1 + i),
+                            IN_ORDER(_mm256_packus_epi16(_mm256_and_si256(a, low), _mm256_and_si256(b, low))));
+        _mm256_storeu_si256((__m256i *)(dest2 + i),
+                            IN_ORDER(_mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8))));
+    }
+
+    for (; i < src_size / 2; i++) {
+        dest1[i] = src[i * 2];
+        dest2[i] = src[i * 2 + 1];
+    }
+}
+
+/* two horizontally adjacent tiles give 32 linear bytes per row */
+AVX2 static void tiled_to_linear_avx2(
+    unsigned char       *dst,
+    const unsigned char *src,
+    unsigned int         width,
+    unsigned int         height,
+    unsigned int         tile_rows)
+{
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int tile_size = 16 * tile_rows;
+    unsigned int i, j, k, rows;
+
+    for (i = 0; i < height; i += tile_rows) {
+        const unsigned char *s = src + tiled_width * i;
+        unsigned char *d = dst + width * i;
+
+        rows = (height - i < tile_rows) ? (height - i) : tile_rows;
+
+        for (j = 0; j + 32 <= width; j += 32) {
+            for (k = 0; k < rows; k++) {
+                __m128i left = _mm_loadu_si128((const __m128i *)(s + j * tile_rows + 16 * k));
+                __m128i right = _mm_loadu_si128((const __m128i *)(s + j * tile_rows + tile_size + 16 * k));
+
+                _mm256_storeu_si256((__m256i *)(d + width * k + j),
+                                    _mm256_inserti128_si256(_mm256_castsi128_si256(left), right, 1));
+            }
+        }
+
+        for (; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++)
+                _mm_storeu_si128((__m128i *)(d + width * k + j),
+                                 _mm_loadu_si128((const __m128i *)(s + j * tile_rows + 16 * k)));
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++)
+                memcpy(d + width * k + j, s + j * tile_rows + 16 * k, width - j);
+        }
+    }
+}
+
+AVX2 static void csc_tiled_to_linear_y_avx2(
+    unsigned char *y_dst,
+    unsigned char *y_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_avx2(y_dst, y_src, width, height, 16);
+}
+
+AVX2 static void csc_tiled_to_linear_uv_avx2(
+    unsigned char *uv_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_avx2(uv_dst, uv_src, width, height, 8);
+}
+
+AVX2 static void csc_tiled_to_linear_uv_deinterleave_avx2(
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                           0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int stride = width >> 1;
+    unsigned int i, j, k, n, rows;
+
+    for (i = 0; i < height; i += 8) {
+        const unsigned char *s = uv_src + tiled_width * i;
+        unsigned char *u = u_dst + stride * i;
+        unsigned char *v = v_dst + stride * i;
+
+        rows = (height - i < 8) ? (height - i) : 8;
+
+        for (j = 0; j + 32 <= width; j += 32) {
+            for (k = 0; k < rows; k++) {
+                __m128i left = _mm_loadu_si128((const __m128i *)(s + j * 8 + 16 * k));
+                __m128i right = _mm_loadu_si128((const __m128i *)(s + j * 8 + 128 + 16 * k));
+                __m256i t = _mm256_inserti128_si256(_mm256_castsi128_si256(left), right, 1);
+
+                /* [u v | u v] to [u u v v] */
+                t = IN_ORDER(_mm256_shuffle_epi8(t, split));
+                _mm_storeu_si128((__m128i *)(u + stride * k + (j >> 1)), _mm256_castsi256_si128(t));
+                _mm_storeu_si128((__m128i *)(v + stride * k + (j >> 1)), _mm256_extracti128_si256(t, 1));
+            }
+        }
+
+        for (; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++) {
+                __m128i t = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s + j * 8 + 16 * k)),
+                                             _mm256_castsi256_si128(split));
+
+                _mm_storel_epi64((__m128i *)(u + stride * k + (j >> 1)), t);
+                _mm_storel_epi64((__m128i *)(v + stride * k + (j >> 1)), _mm_unpackhi_epi64(t, t));
+            }
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++) {
+                for (n = 0; n < (width - j) / 2; n++) {
+                    u[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2];
+                    v[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2 + 1];
+                }
+            }
+        }
+    }
+}
+
+/* Y of 16 pixels, see swconverter_rgb32_to_yuv420sp_row() */
+AVX2 static inline __m256i rgb_to_y_avx2(
+    __m256i r,
+    __m256i g,
+    __m256i b)
+{
+    /* at most 56228, the 16 bit lanes do not overflow */
+    __m256i y = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(66)),
+                                 _mm256_mullo_epi16(g, _mm256_set1_epi16(129)));
+
+    y = _mm256_add_epi16(y, _mm256_mullo_epi16(b, _mm256_set1_epi16(25)));
+    y = _mm256_srli_epi16(_mm256_add_epi16(y, _mm256_set1_epi16(128)), 8);
+
+    return _mm256_add_epi16(y, _mm256_set1_epi16(16));
+}
+
+/* U or V of 16 pixels, the sums stay within -28560 .. 28688 */
+AVX2 static inline __m256i rgb_to_c_avx2(
+    __m256i r,
+    __m256i g,
+    __m256i b,
+    short   cr,
+    short   cg,
+    short   cb)
+{
+    __m256i c = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(cr)),
+                                 _mm256_mullo_epi16(g, _mm256_set1_epi16(cg)));
+
+    c = _mm256_add_epi16(c, _mm256_mullo_epi16(b, _mm256_set1_epi16(cb)));
+    c = _mm256_srai_epi16(_mm256_add_epi16(c, _mm256_set1_epi16(128)), 8);
+
+    return _mm256_add_epi16(c, _mm256_set1_epi16(128));
+}
+
+/* one channel of 16 pixels as 16 bit lanes */
+AVX2 static inline __m256i channel_avx2(
+    __m256i p0,
+    __m256i p1,
+    __m128i shift)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+
+    return IN_ORDER(_mm256_packus_epi32(_mm256_and_si256(_mm256_srl_epi32(p0, shift), mask),
+                                        _mm256_and_si256(_mm256_srl_epi32(p1, shift), mask)));
+}
+
+/* even lanes of two vectors of 16 */
+AVX2 static inline __m256i even_avx2(
+    __m256i lo,
+    __m256i hi)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+
+    return IN_ORDER(_mm256_packus_epi32(_mm256_and_si256(lo, mask), _mm256_and_si256(hi, mask)));
+}
+
+AVX2 static void rgb32_to_yuv420sp_avx2(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height,
+    unsigned int   r_shift,
+    unsigned int   b_shift)
+{
+    const __m128i rs = _mm_cvtsi32_si128(r_shift);
+    const __m128i gs = _mm_cvtsi32_si128(8);
+    const __m128i bs = _mm_cvtsi32_si128(b_shift);
+    unsigned int i, j;
+
+    for (j = 0; j < height; j++) {
+        const unsigned char *s = rgb_src + j * width * 4;
+        unsigned char *y = y_dst + j * width;
+        unsigned char *uv = ((j % 2) == 0) ? uv_dst + (j / 2) * ((width + 1) / 2) * 2 : NULL;
+
+        for (i = 0; i + 32 <= width; i += 32) {
+            __m256i p0 = _mm256_loadu_si256((const __m256i *)(s + i * 4));
+            __m256i p1 = _mm256_loadu_si256((const __m256i *)(s + i * 4 + 32));
+            __m256i p2 = _mm256_loadu_si256((const __m256i *)(s + i * 4 + 64));
+            __m256i p3 = _mm256_loadu_si256((const __m256i *)(s + i * 4 + 96));
+
+            __m256i r_lo = channel_avx2(p0, p1, rs), r_hi = channel_avx2(p2, p3, rs);
+            __m256i g_lo = channel_avx2(p0, p1, gs), g_hi = channel_avx2(p2, p3, gs);
+            __m256i b_lo = channel_avx2(p0, p1, bs), b_hi = channel_avx2(p2, p3, bs);
+
+            _mm256_storeu_si256((__m256i *)(y + i),
+                                IN_ORDER(_mm256_packus_epi16(rgb_to_y_avx2(r_lo, g_lo, b_lo),
+                                                             rgb_to_y_avx2(r_hi, g_hi, b_hi))));
+
+            if (uv != NULL) {
+                __m256i r = even_avx2(r_lo, r_hi);
+                __m256i g = even_avx2(g_lo, g_hi);
+                __m256i b = even_avx2(b_lo, b_hi);
+                /* [u0-7 v0-7 | u8-15 v8-15], interleaving each lane keeps the order */
+                __m256i t = _mm256_packus_epi16(rgb_to_c_avx2(r, g, b, -38, -74, 112),
+                                                rgb_to_c_avx2(r, g, b, 112, -94, -18));
+
+                _mm256_storeu_si256((__m256i *)(uv + i), _mm256_unpacklo_epi8(t, _mm256_srli_si256(t, 8)));
+            }
+        }
+
+        swconverter_rgb32_to_yuv420sp_row(y, uv, s, i, width, r_shift, b_shift);
+    }
+}
+
+AVX2 static void csc_BGRA8888_to_YUV420SP_avx2(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_avx2(y_dst, uv_dst, rgb_src, width, height, 16, 0);
+}
+
+AVX2 static void csc_RGBA8888_to_YUV420SP_avx2(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_avx2(y_dst, uv_dst, rgb_src, width, height, 0, 16);
+}
+
+AVX2 static void csc_P010_to_8bit_row_avx2(
+    unsigned char              *dst,
+    const unsigned short       *src,
+    unsigned int                count,
+    const SWCONVERTER_P010_MAP *map,
+    const unsigned char         dither[8],
+    unsigned int                swap)
+{
+    const __m128i swap_pairs = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m256i in_offset = _mm256_set1_epi16((short)map->in_offset);
+    const __m256i mul = _mm256_set1_epi32(map->mul);
+    /* out_offset and the dither of each lane are added in one go */
+    const __m256i add = _mm256_add_epi32(_mm256_set1_epi32(map->out_offset << 4),
+                                         _mm256_setr_epi32(dither[0], dither[1], dither[2], dither[3],
+                                                           dither[4], dither[5], dither[6], dither[7]));
+    unsigned int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        __m256i s = _mm256_sub_epi16(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + i)), 6),
+                                     in_offset);
+        __m256i lo = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(s)), mul), 12);
+        __m256i hi = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(s, 1)), mul), 12);
+        __m256i out;
+        __m128i bytes;
+
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, add), 4);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, add), 4);
+
+        /* packus clamps to 0 .. 255 like the C kernel */
+        out = IN_ORDER(_mm256_packs_epi32(lo, hi));
+        out = IN_ORDER(_mm256_packus_epi16(out, out));
+        bytes = _mm256_castsi256_si128(out);
+
+        if (swap)
+            bytes = _mm_shuffle_epi8(bytes, swap_pairs);
+
+        _mm_storeu_si128((__m128i *)(dst + i), bytes);
+    }
+
+    swconverter_p010_row(dst, src, i, count, map, dither, swap);
+}
+
+const SWCONVERTER_KERNELS swconverter_kernels_avx2 = {
+    .name = "avx2",
+    .interleave_memcpy = csc_interleave_memcpy_avx2,
+    .deinterleave_memcpy = csc_deinterleave_memcpy_avx2,
+    .tiled_to_linear_y = csc_tiled_to_linear_y_avx2,
+    .tiled_to_linear_uv = csc_tiled_to_linear_uv_avx2,
+    .tiled_to_linear_uv_deinterleave = csc_tiled_to_linear_uv_deinterleave_avx2,
+    .BGRA8888_to_YUV420SP = csc_BGRA8888_to_YUV420SP_avx2,
+    .RGBA8888_to_YUV420SP = csc_RGBA8888_to_YUV420SP_avx2,
+    .P010_to_8bit_row = csc_P010_to_8bit_row_avx2,
+};
+
+#endif /* __x86_64__ || __i386__ */
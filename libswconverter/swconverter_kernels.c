@@ -0,0 +1,205 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_kernels.c
+ *
+ * @brief   runtime selection of the CSC kernels and the conversions
+ *   built from several of them
+ *
+ * @version 1.0
+ */
+
+#include <pthread.h>
+#include "swconverter.h"
+#include "swconverter_kernels.h"
+
+const SWCONVERTER_P010_MAP swconverter_p010_maps[3][2] = {
+    /* CSC_P010_RANGE_KEEP: 1/4 */
+    { {   0, 16384,   0 }, {   0, 16384,   0 } },
+    /* CSC_P010_RANGE_NARROW_TO_FULL: 64..940 to 0..255, 64..960 to 0..255 around 128 */
+    { {  64, 19077,   0 }, { 512, 18651, 128 } },
+    /* CSC_P010_RANGE_FULL_TO_NARROW: 0..1023 to 16..235, 0..1023 to 16..240 around 128 */
+    { {   0, 14030,  16 }, { 512, 14350, 128 } },
+};
+
+const unsigned char swconverter_p010_dither[5][4] = {
+    /* 4x4 Bayer matrix */
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+    /* no dither, round to nearest */
+    {  8,  8,  8,  8 },
+};
+
+/* chroma is deinterleaved through this many bytes on the stack */
+#define P010_CHUNK 512
+
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+static const SWCONVERTER_KERNELS *selected_kernels = &swconverter_kernels_c;
+
+/* from the best to the worst */
+static const SWCONVERTER_ISA isa_order[] = {
+    SWCONVERTER_ISA_AVX2,
+    SWCONVERTER_ISA_SSE41,
+    SWCONVERTER_ISA_NEON64,
+    SWCONVERTER_ISA_C,
+};
+
+static void swconverter_select_kernels(void)
+{
+    const SWCONVERTER_KERNELS *found;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(isa_order) / sizeof(isa_order[0]); i++) {
+        found = swconverter_get_kernels_for(isa_order[i]);
+        if (found != NULL) {
+            selected_kernels = found;
+            break;
+        }
+    }
+}
+
+const SWCONVERTER_KERNELS *swconverter_get_kernels(void)
+{
+    pthread_once(&kernels_once, swconverter_select_kernels);
+
+    return selected_kernels;
+}
+
+const SWCONVERTER_KERNELS *swconverter_get_kernels_for(
+    SWCONVERTER_ISA isa)
+{
+    switch (isa) {
+    case SWCONVERTER_ISA_C:
+        return &swconverter_kernels_c;
+#if defined(__x86_64__) || defined(__i386__)
+    case SWCONVERTER_ISA_SSE41:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.1") ? &swconverter_kernels_sse41 : NULL;
+    case SWCONVERTER_ISA_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &swconverter_kernels_avx2 : NULL;
+#endif
+#if defined(__aarch64__)
+    case SWCONVERTER_ISA_NEON64:
+        /* Advanced SIMD is mandatory on AArch64 */
+        return &swconverter_kernels_neon64;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static const SWCONVERTER_P010_MAP *p010_maps(
+    unsigned int range)
+{
+    if (range > CSC_P010_RANGE_FULL_TO_NARROW)
+        range = CSC_P010_RANGE_KEEP;
+
+    return swconverter_p010_maps[range];
+}
+
+/* a chroma sample pair shares the threshold of its pixel */
+static void p010_pattern(
+    unsigned char  pattern[8],
+    unsigned int   dither,
+    unsigned int   row,
+    unsigned int   is_chroma)
+{
+    const unsigned char *thresholds = swconverter_p010_dither[dither ? (row & 3) : 4];
+    unsigned int i;
+
+    for (i = 0; i < 8; i++)
+        pattern[i] = thresholds[(is_chroma ? (i / 2) : i) & 3];
+}
+
+static void p010_luma(
+    const SWCONVERTER_KERNELS  *kernels,
+    unsigned char              *y_dst,
+    unsigned short             *y_src,
+    unsigned int                width,
+    unsigned int                height,
+    unsigned int                dither,
+    const SWCONVERTER_P010_MAP *map)
+{
+    unsigned char pattern[8];
+    unsigned int j;
+
+    for (j = 0; j < height; j++) {
+        p010_pattern(pattern, dither, j, 0);
+        kernels->P010_to_8bit_row(y_dst + j * width, y_src + j * width, width, map, pattern, 0);
+    }
+}
+
+void swconverter_P010_to_YUV420SP(
+    const SWCONVERTER_KERNELS *kernels,
+    unsigned char  *y_dst,
+    unsigned char  *uv_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    swap_uv,
+    unsigned int    dither,
+    unsigned int    range)
+{
+    const SWCONVERTER_P010_MAP *maps = p010_maps(range);
+    unsigned char pattern[8];
+    unsigned int j;
+
+    p010_luma(kernels, y_dst, y_src, width, height, dither, &maps[0]);
+
+    for (j = 0; j < height / 2; j++) {
+        p010_pattern(pattern, dither, j, 1);
+        kernels->P010_to_8bit_row(uv_dst + j * width, uv_src + j * width, width, &maps[1], pattern, swap_uv);
+    }
+}
+
+void swconverter_P010_to_YUV420P(
+    const SWCONVERTER_KERNELS *kernels,
+    unsigned char  *y_dst,
+    unsigned char  *u_dst,
+    unsigned char  *v_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    dither,
+    unsigned int    range)
+{
+    const SWCONVERTER_P010_MAP *maps = p010_maps(range);
+    unsigned char pattern[8];
+    unsigned char chunk[P010_CHUNK];
+    unsigned int i, j, count;
+
+    p010_luma(kernels, y_dst, y_src, width, height, dither, &maps[0]);
+
+    for (j = 0; j < height / 2; j++) {
+        p010_pattern(pattern, dither, j, 1);
+
+        /* chunks start on a multiple of 8 samples, the pattern stays in phase */
+        for (i = 0; i < width; i += P010_CHUNK) {
+            count = (width - i < P010_CHUNK) ? (width - i) : P010_CHUNK;
+            kernels->P010_to_8bit_row(chunk, uv_src + j * width + i, count, &maps[1], pattern, 0);
+            kernels->deinterleave_memcpy(u_dst + j * (width / 2) + i / 2,
+                                         v_dst + j * (width / 2) + i / 2,
+                                         chunk, count);
+        }
+    }
+}
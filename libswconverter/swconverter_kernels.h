@@ -0,0 +1,264 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_kernels.h
+ *
+ * @brief   machine dependent kernels of the CSC functions
+ *   The public csc_* functions call the kernels of the best instruction set
+ *   found at runtime. Every kernel gives the same output as the C kernel.
+ *   ARMv7 builds with NEON_SUPPORT keep using the hand written assembly.
+ *
+ * @version 1.0
+ */
+
+#ifndef SW_CONVERTER_KERNELS_H_
+#define SW_CONVERTER_KERNELS_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _SWCONVERTER_ISA {
+    SWCONVERTER_ISA_C = 0,
+    SWCONVERTER_ISA_SSE41,
+    SWCONVERTER_ISA_AVX2,
+    SWCONVERTER_ISA_NEON64,
+    SWCONVERTER_ISA_MAX,
+} SWCONVERTER_ISA;
+
+/*
+ * Linear map of a 10 bit sample to 8 bit with 4 fractional bits:
+ *   ((((s - in_offset) * mul) >> 12) + (out_offset << 4))
+ * mul is the scale in Q16, all terms fit in 32 bits.
+ */
+typedef struct _SWCONVERTER_P010_MAP {
+    int in_offset;
+    int mul;
+    int out_offset;
+} SWCONVERTER_P010_MAP;
+
+typedef struct _SWCONVERTER_KERNELS {
+    const char *name;
+
+    void (*interleave_memcpy)(
+        unsigned char *dest,
+        unsigned char *src1,
+        unsigned char *src2,
+        unsigned int   src_size);
+
+    void (*deinterleave_memcpy)(
+        unsigned char *dest1,
+        unsigned char *dest2,
+        unsigned char *src,
+        unsigned int   src_size);
+
+    /* 16x16 tiles(MFC 6.x) */
+    void (*tiled_to_linear_y)(
+        unsigned char *y_dst,
+        unsigned char *y_src,
+        unsigned int   width,
+        unsigned int   height);
+
+    void (*tiled_to_linear_uv)(
+        unsigned char *uv_dst,
+        unsigned char *uv_src,
+        unsigned int   width,
+        unsigned int   height);
+
+    void (*tiled_to_linear_uv_deinterleave)(
+        unsigned char *u_dst,
+        unsigned char *v_dst,
+        unsigned char *uv_src,
+        unsigned int   width,
+        unsigned int   height);
+
+    void (*BGRA8888_to_YUV420SP)(
+        unsigned char *y_dst,
+        unsigned char *uv_dst,
+        unsigned char *rgb_src,
+        unsigned int   width,
+        unsigned int   height);
+
+    void (*RGBA8888_to_YUV420SP)(
+        unsigned char *y_dst,
+        unsigned char *uv_dst,
+        unsigned char *rgb_src,
+        unsigned int   width,
+        unsigned int   height);
+
+    /*
+     * 10 bit samples of P010 to 8 bit, see swconverter_p010_sample().
+     * dither[i % 8] is added to sample i, swap exchanges the samples of
+     * each pair, as from CbCr to CrCb.
+     */
+    void (*P010_to_8bit_row)(
+        unsigned char              *dst,
+        const unsigned short       *src,
+        unsigned int                count,
+        const SWCONVERTER_P010_MAP *map,
+        const unsigned char         dither[8],
+        unsigned int                swap);
+} SWCONVERTER_KERNELS;
+
+/* [CSC_P010_RANGE_*][0: luma, 1: chroma] */
+extern const SWCONVERTER_P010_MAP swconverter_p010_maps[3][2];
+
+/*
+ * Thresholds added before dropping the fractional bits.
+ * Row 4 is used when dithering is off and rounds to nearest.
+ */
+extern const unsigned char swconverter_p010_dither[5][4];
+
+static inline unsigned char swconverter_p010_sample(
+    unsigned short              sample,
+    const SWCONVERTER_P010_MAP *map,
+    unsigned int                dither)
+{
+    int q = ((((int)(sample >> 6) - map->in_offset) * map->mul) >> 12) + (map->out_offset << 4);
+
+    q = (q + (int)dither) >> 4;
+
+    return (q < 0) ? 0 : ((q > 255) ? 255 : (unsigned char)q);
+}
+
+/* C version of P010_to_8bit_row, also used for the end of the rows */
+static inline void swconverter_p010_row(
+    unsigned char              *dst,
+    const unsigned short       *src,
+    unsigned int                start,
+    unsigned int                count,
+    const SWCONVERTER_P010_MAP *map,
+    const unsigned char         dither[8],
+    unsigned int                swap)
+{
+    unsigned int i;
+
+    for (i = start; i < count; i++)
+        dst[swap ? (i ^ 1) : i] = swconverter_p010_sample(src[i], map, dither[i % 8]);
+}
+
+/*
+ * P010 to YUV420SP or YUV420P with the given kernels,
+ * see csc_P010_to_YUV420SP() and csc_P010_to_YUV420P()
+ */
+void swconverter_P010_to_YUV420SP(
+    const SWCONVERTER_KERNELS *kernels,
+    unsigned char  *y_dst,
+    unsigned char  *uv_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    swap_uv,
+    unsigned int    dither,
+    unsigned int    range);
+
+void swconverter_P010_to_YUV420P(
+    const SWCONVERTER_KERNELS *kernels,
+    unsigned char  *y_dst,
+    unsigned char  *u_dst,
+    unsigned char  *v_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int    width,
+    unsigned int    height,
+    unsigned int    dither,
+    unsigned int    range);
+
+/*
+ * Kernels of the best instruction set supported by this CPU.
+ * The choice is made once, on the first call.
+ */
+const SWCONVERTER_KERNELS *swconverter_get_kernels(void);
+
+/*
+ * Kernels of the given instruction set.
+ *
+ * @return
+ *   NULL if the instruction set is not built in or not supported by this CPU
+ */
+const SWCONVERTER_KERNELS *swconverter_get_kernels_for(
+    SWCONVERTER_ISA isa);
+
+extern const SWCONVERTER_KERNELS swconverter_kernels_c;
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const SWCONVERTER_KERNELS swconverter_kernels_sse41;
+extern const SWCONVERTER_KERNELS swconverter_kernels_avx2;
+#endif
+
+#if defined(__aarch64__)
+extern const SWCONVERTER_KERNELS swconverter_kernels_neon64;
+#endif
+
+/*
+ * RGB to YUV of the C kernels, shared by the other kernels for the pixels
+ * left over at the end of a row.
+ * r_shift and b_shift select the R and B bytes of a little endian pixel.
+ */
+static inline void swconverter_rgb32_to_yuv420sp_row(
+    unsigned char       *y_row,
+    unsigned char       *uv_row,
+    const unsigned char *rgb_row,
+    unsigned int         start,
+    unsigned int         width,
+    unsigned int         r_shift,
+    unsigned int         b_shift)
+{
+    unsigned int i;
+    unsigned int tmp;
+    unsigned int R, G, B;
+    unsigned int Y, U, V;
+
+    for (i = start; i < width; i++) {
+        tmp = (unsigned int)rgb_row[i * 4] |
+              ((unsigned int)rgb_row[i * 4 + 1] << 8) |
+              ((unsigned int)rgb_row[i * 4 + 2] << 16) |
+              ((unsigned int)rgb_row[i * 4 + 3] << 24);
+
+        R = (tmp >> r_shift) & 0xFF;
+        G = (tmp >> 8) & 0xFF;
+        B = (tmp >> b_shift) & 0xFF;
+
+        Y = ((66 * R) + (129 * G) + (25 * B) + 128);
+        Y = Y >> 8;
+        Y += 16;
+
+        y_row[i] = (unsigned char)Y;
+
+        if ((uv_row != NULL) && ((i % 2) == 0)) {
+            U = ((-38 * R) - (74 * G) + (112 * B) + 128);
+            U = U >> 8;
+            U += 128;
+            V = ((112 * R) - (94 * G) - (18 * B) + 128);
+            V = V >> 8;
+            V += 128;
+
+            uv_row[i] = (unsigned char)U;
+            uv_row[i + 1] = (unsigned char)V;
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SW_CONVERTER_KERNELS_H_ */
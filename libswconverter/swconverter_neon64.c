@@ -0,0 +1,324 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_neon64.c
+ *
+ * @brief   AArch64 Advanced SIMD kernels of the CSC functions
+ *   The ARMv7 assembly in this directory does not build for AArch64,
+ *   these kernels give the same output as the C kernels.
+ *
+ * @version 1.0
+ */
+
+#if defined(__aarch64__)
+
+#include <string.h>
+#include <arm_neon.h>
+#include "swconverter_kernels.h"
+
+static void csc_interleave_memcpy_neon64(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int   src_size)
+{
+    unsigned int i;
+
+    for (i = 0; i + 16 <= src_size; i += 16) {
+        uint8x16x2_t uv;
+
+        uv.val[0] = vld1q_u8(src1 + i);
+        uv.val[1] = vld1q_u8(src2 + i);
+        vst2q_u8(dest + i * 2, uv);
+    }
+
+    for (; i < src_size; i++) {
+        dest[i * 2] = src1[i];
+        dest[i * 2 + 1] = src2[i];
+    }
+}
+
+static void csc_deinterleave_memcpy_neon64(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int   src_size)
+{
+    unsigned int i;
+
+    for (i = 0; i + 16 <= src_size / 2; i += 16) {
+        uint8x16x2_t uv = vld2q_u8(src + i * 2);
+
+        vst1q_u8(dest1 + i, uv.val[0]);
+        vst1q_u8(dest2 + i, uv.val[1]);
+    }
+
+    for (; i < src_size / 2; i++) {
+        dest1[i] = src[i * 2];
+        dest2[i] = src[i * 2 + 1];
+    }
+}
+
+/* tiles are 16 bytes wide and tile_rows high, stored one after the other */
+static void tiled_to_linear_neon64(
+    unsigned char       *dst,
+    const unsigned char *src,
+    unsigned int         width,
+    unsigned int         height,
+    unsigned int         tile_rows)
+{
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int i, j, k, rows;
+
+    for (i = 0; i < height; i += tile_rows) {
+        const unsigned char *s = src + tiled_width * i;
+        unsigned char *d = dst + width * i;
+
+        rows = (height - i < tile_rows) ? (height - i) : tile_rows;
+
+        for (j = 0; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++)
+                vst1q_u8(d + width * k + j, vld1q_u8(s + j * tile_rows + 16 * k));
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++)
+                memcpy(d + width * k + j, s + j * tile_rows + 16 * k, width - j);
+        }
+    }
+}
+
+static void csc_tiled_to_linear_y_neon64(
+    unsigned char *y_dst,
+    unsigned char *y_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_neon64(y_dst, y_src, width, height, 16);
+}
+
+static void csc_tiled_to_linear_uv_neon64(
+    unsigned char *uv_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_neon64(uv_dst, uv_src, width, height, 8);
+}
+
+static void csc_tiled_to_linear_uv_deinterleave_neon64(
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int stride = width >> 1;
+    unsigned int i, j, k, n, rows;
+
+    for (i = 0; i < height; i += 8) {
+        const unsigned char *s = uv_src + tiled_width * i;
+        unsigned char *u = u_dst + stride * i;
+        unsigned char *v = v_dst + stride * i;
+
+        rows = (height - i < 8) ? (height - i) : 8;
+
+        for (j = 0; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++) {
+                uint8x8x2_t uv = vld2_u8(s + j * 8 + 16 * k);
+
+                vst1_u8(u + stride * k + (j >> 1), uv.val[0]);
+                vst1_u8(v + stride * k + (j >> 1), uv.val[1]);
+            }
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++) {
+                for (n = 0; n < (width - j) / 2; n++) {
+                    u[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2];
+                    v[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2 + 1];
+                }
+            }
+        }
+    }
+}
+
+/* Y of 8 pixels, see swconverter_rgb32_to_yuv420sp_row() */
+static inline uint8x8_t rgb_to_y_neon64(
+    uint8x8_t r,
+    uint8x8_t g,
+    uint8x8_t b)
+{
+    /* at most 56228, the 16 bit lanes do not overflow */
+    uint16x8_t y = vmull_u8(r, vdup_n_u8(66));
+
+    y = vmlal_u8(y, g, vdup_n_u8(129));
+    y = vmlal_u8(y, b, vdup_n_u8(25));
+
+    return vadd_u8(vshrn_n_u16(vaddq_u16(y, vdupq_n_u16(128)), 8), vdup_n_u8(16));
+}
+
+/* U or V of 8 pixels, the sums stay within -28560 .. 28688 */
+static inline uint8x8_t rgb_to_c_neon64(
+    int16x8_t r,
+    int16x8_t g,
+    int16x8_t b,
+    int16_t   cr,
+    int16_t   cg,
+    int16_t   cb)
+{
+    int16x8_t c = vmulq_n_s16(r, cr);
+
+    c = vmlaq_n_s16(c, g, cg);
+    c = vmlaq_n_s16(c, b, cb);
+    c = vshrq_n_s16(vaddq_s16(c, vdupq_n_s16(128)), 8);
+
+    return vqmovun_s16(vaddq_s16(c, vdupq_n_s16(128)));
+}
+
+/* even pixels of 16 as signed 16 bit lanes */
+static inline int16x8_t even_neon64(
+    uint8x16_t c)
+{
+    return vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(vuzp1q_u8(c, c))));
+}
+
+static void rgb32_to_yuv420sp_neon64(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height,
+    unsigned int   r_shift,
+    unsigned int   b_shift)
+{
+    unsigned int ri = r_shift / 8;
+    unsigned int bi = b_shift / 8;
+    unsigned int i, j;
+
+    for (j = 0; j < height; j++) {
+        const unsigned char *s = rgb_src + j * width * 4;
+        unsigned char *y = y_dst + j * width;
+        unsigned char *uv = ((j % 2) == 0) ? uv_dst + (j / 2) * ((width + 1) / 2) * 2 : NULL;
+
+        for (i = 0; i + 16 <= width; i += 16) {
+            uint8x16x4_t p = vld4q_u8(s + i * 4);
+            uint8x16_t r = p.val[ri];
+            uint8x16_t g = p.val[1];
+            uint8x16_t b = p.val[bi];
+
+            vst1q_u8(y + i, vcombine_u8(rgb_to_y_neon64(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+                                        rgb_to_y_neon64(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b))));
+
+            if (uv != NULL) {
+                int16x8_t re = even_neon64(r);
+                int16x8_t ge = even_neon64(g);
+                int16x8_t be = even_neon64(b);
+                uint8x8x2_t c;
+
+                c.val[0] = rgb_to_c_neon64(re, ge, be, -38, -74, 112);
+                c.val[1] = rgb_to_c_neon64(re, ge, be, 112, -94, -18);
+                vst2_u8(uv + i, c);
+            }
+        }
+
+        swconverter_rgb32_to_yuv420sp_row(y, uv, s, i, width, r_shift, b_shift);
+    }
+}
+
+static void csc_BGRA8888_to_YUV420SP_neon64(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_neon64(y_dst, uv_dst, rgb_src, width, height, 16, 0);
+}
+
+static void csc_RGBA8888_to_YUV420SP_neon64(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_neon64(y_dst, uv_dst, rgb_src, width, height, 0, 16);
+}
+
+/* 8 samples of P010, see swconverter_p010_sample() */
+static inline int16x8_t p010_to_8bit_neon64(
+    const unsigned short *src,
+    int16x8_t             in_offset,
+    int32_t               mul,
+    int32x4_t             add_lo,
+    int32x4_t             add_hi)
+{
+    int16x8_t s = vsubq_s16(vreinterpretq_s16_u16(vshrq_n_u16(vld1q_u16(src), 6)), in_offset);
+    int32x4_t lo = vshrq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(s)), mul), 12);
+    int32x4_t hi = vshrq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(s)), mul), 12);
+
+    lo = vshrq_n_s32(vaddq_s32(lo, add_lo), 4);
+    hi = vshrq_n_s32(vaddq_s32(hi, add_hi), 4);
+
+    return vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+}
+
+static void csc_P010_to_8bit_row_neon64(
+    unsigned char              *dst,
+    const unsigned short       *src,
+    unsigned int                count,
+    const SWCONVERTER_P010_MAP *map,
+    const unsigned char         dither[8],
+    unsigned int                swap)
+{
+    const int16x8_t in_offset = vdupq_n_s16((int16_t)map->in_offset);
+    const int32_t lo_dither[4] = { dither[0], dither[1], dither[2], dither[3] };
+    const int32_t hi_dither[4] = { dither[4], dither[5], dither[6], dither[7] };
+    /* out_offset and the dither of each lane are added in one go */
+    const int32x4_t add_lo = vaddq_s32(vdupq_n_s32(map->out_offset << 4), vld1q_s32(lo_dither));
+    const int32x4_t add_hi = vaddq_s32(vdupq_n_s32(map->out_offset << 4), vld1q_s32(hi_dither));
+    unsigned int i;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        /* vqmovun clamps to 0 .. 255 like the C kernel */
+        uint8x8_t out = vqmovun_s16(p010_to_8bit_neon64(src + i, in_offset, map->mul, add_lo, add_hi));
+
+        if (swap)
+            out = vrev16_u8(out);
+
+        vst1_u8(dst + i, out);
+    }
+
+    swconverter_p010_row(dst, src, i, count, map, dither, swap);
+}
+
+const SWCONVERTER_KERNELS swconverter_kernels_neon64 = {
+    .name = "neon64",
+    .interleave_memcpy = csc_interleave_memcpy_neon64,
+    .deinterleave_memcpy = csc_deinterleave_memcpy_neon64,
+    .tiled_to_linear_y = csc_tiled_to_linear_y_neon64,
+    .tiled_to_linear_uv = csc_tiled_to_linear_uv_neon64,
+    .tiled_to_linear_uv_deinterleave = csc_tiled_to_linear_uv_deinterleave_neon64,
+    .BGRA8888_to_YUV420SP = csc_BGRA8888_to_YUV420SP_neon64,
+    .RGBA8888_to_YUV420SP = csc_RGBA8888_to_YUV420SP_neon64,
+    .P010_to_8bit_row = csc_P010_to_8bit_row_neon64,
+};
+
+#endif /* __aarch64__ */
@@ -0,0 +1,356 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_sse41.c
+ *
+ * @brief   SSE4.1 kernels of the CSC functions
+ *   Built with a function level target so that the library itself does not
+ *   need -msse4.1. They are only called when the CPU supports SSE4.1.
+ *
+ * @version 1.0
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <string.h>
+#include <immintrin.h>
+#include "swconverter_kernels.h"
+
+#define SSE41 __attribute__((target("sse4.1")))
+
+SSE41 static void csc_interleave_memcpy_sse41(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int   src_size)
+{
+    unsigned int i;
+
+    for (i = 0; i + 16 <= src_size; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src2 + i));
+
+        _mm_storeu_si128((__m128i *)(dest + i * 2), _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128((__m128i *)(dest + i * 2 + 16), _mm_unpackhi_epi8(a, b));
+    }
+
+    for (; i < src_size; i++) {
+        dest[i * 2] = src1[i];
+        dest[i * 2 + 1] = src2[i];
+    }
+}
+
+SSE41 static void csc_deinterleave_memcpy_sse41(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int   src_size)
+{
+    const __m128i low = _mm_set1_epi16(0x00FF);
+    unsigned int i;
+
+    for (i = 0; i + 16 <= src_size / 2; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i * 2));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i * 2 + 16));
+
+        _mm_storeu_si128((__m128i *)(dest1 + i),
+                         _mm_packus_epi16(_mm_and_si128(a, low), _mm_and_si128(b, low)));
+        _mm_storeu_si128((__m128i *)(dest2 + i),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+
+    for (; i < src_size / 2; i++) {
+        dest1[i] = src[i * 2];
+        dest2[i] = src[i * 2 + 1];
+    }
+}
+
+/* tiles are 16 bytes wide and tile_rows high, stored one after the other */
+SSE41 static void tiled_to_linear_sse41(
+    unsigned char       *dst,
+    const unsigned char *src,
+    unsigned int         width,
+    unsigned int         height,
+    unsigned int         tile_rows)
+{
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int i, j, k, rows;
+
+    for (i = 0; i < height; i += tile_rows) {
+        const unsigned char *s = src + tiled_width * i;
+        unsigned char *d = dst + width * i;
+
+        rows = (height - i < tile_rows) ? (height - i) : tile_rows;
+
+        for (j = 0; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++)
+                _mm_storeu_si128((__m128i *)(d + width * k + j),
+                                 _mm_loadu_si128((const __m128i *)(s + j * tile_rows + 16 * k)));
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++)
+                memcpy(d + width * k + j, s + j * tile_rows + 16 * k, width - j);
+        }
+    }
+}
+
+SSE41 static void csc_tiled_to_linear_y_sse41(
+    unsigned char *y_dst,
+    unsigned char *y_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_sse41(y_dst, y_src, width, height, 16);
+}
+
+SSE41 static void csc_tiled_to_linear_uv_sse41(
+    unsigned char *uv_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    tiled_to_linear_sse41(uv_dst, uv_src, width, height, 8);
+}
+
+SSE41 static void csc_tiled_to_linear_uv_deinterleave_sse41(
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *uv_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    unsigned int tiled_width = ((width + 15) >> 4) << 4;
+    unsigned int stride = width >> 1;
+    unsigned int i, j, k, n, rows;
+
+    for (i = 0; i < height; i += 8) {
+        const unsigned char *s = uv_src + tiled_width * i;
+        unsigned char *u = u_dst + stride * i;
+        unsigned char *v = v_dst + stride * i;
+
+        rows = (height - i < 8) ? (height - i) : 8;
+
+        for (j = 0; j + 16 <= width; j += 16) {
+            for (k = 0; k < rows; k++) {
+                __m128i t = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s + j * 8 + 16 * k)), split);
+
+                _mm_storel_epi64((__m128i *)(u + stride * k + (j >> 1)), t);
+                _mm_storel_epi64((__m128i *)(v + stride * k + (j >> 1)), _mm_unpackhi_epi64(t, t));
+            }
+        }
+
+        if (j < width) {
+            for (k = 0; k < rows; k++) {
+                for (n = 0; n < (width - j) / 2; n++) {
+                    u[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2];
+                    v[stride * k + (j >> 1) + n] = s[j * 8 + 16 * k + n * 2 + 1];
+                }
+            }
+        }
+    }
+}
+
+/* Y of 8 pixels, see swconverter_rgb32_to_yuv420sp_row() */
+SSE41 static inline __m128i rgb_to_y_sse41(
+    __m128i r,
+    __m128i g,
+    __m128i b)
+{
+    /* at most 56228, the 16 bit lanes do not overflow */
+    __m128i y = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)),
+                              _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+
+    return _mm_add_epi16(y, _mm_set1_epi16(16));
+}
+
+/* U or V of 8 pixels, the sums stay within -28560 .. 28688 */
+SSE41 static inline __m128i rgb_to_c_sse41(
+    __m128i r,
+    __m128i g,
+    __m128i b,
+    short   cr,
+    short   cg,
+    short   cb)
+{
+    __m128i c = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(cr)),
+                              _mm_mullo_epi16(g, _mm_set1_epi16(cg)));
+
+    c = _mm_add_epi16(c, _mm_mullo_epi16(b, _mm_set1_epi16(cb)));
+    c = _mm_srai_epi16(_mm_add_epi16(c, _mm_set1_epi16(128)), 8);
+
+    return _mm_add_epi16(c, _mm_set1_epi16(128));
+}
+
+/* one channel of 8 pixels as 16 bit lanes */
+SSE41 static inline __m128i channel_sse41(
+    __m128i p0,
+    __m128i p1,
+    __m128i shift)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+
+    return _mm_packus_epi32(_mm_and_si128(_mm_srl_epi32(p0, shift), mask),
+                            _mm_and_si128(_mm_srl_epi32(p1, shift), mask));
+}
+
+/* even lanes of two vectors of 8 */
+SSE41 static inline __m128i even_sse41(
+    __m128i lo,
+    __m128i hi)
+{
+    const __m128i mask = _mm_set1_epi32(0xFFFF);
+
+    return _mm_packus_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+}
+
+SSE41 static void rgb32_to_yuv420sp_sse41(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height,
+    unsigned int   r_shift,
+    unsigned int   b_shift)
+{
+    const __m128i rs = _mm_cvtsi32_si128(r_shift);
+    const __m128i gs = _mm_cvtsi32_si128(8);
+    const __m128i bs = _mm_cvtsi32_si128(b_shift);
+    unsigned int i, j;
+
+    for (j = 0; j < height; j++) {
+        const unsigned char *s = rgb_src + j * width * 4;
+        unsigned char *y = y_dst + j * width;
+        unsigned char *uv = ((j % 2) == 0) ? uv_dst + (j / 2) * ((width + 1) / 2) * 2 : NULL;
+
+        for (i = 0; i + 16 <= width; i += 16) {
+            __m128i p0 = _mm_loadu_si128((const __m128i *)(s + i * 4));
+            __m128i p1 = _mm_loadu_si128((const __m128i *)(s + i * 4 + 16));
+            __m128i p2 = _mm_loadu_si128((const __m128i *)(s + i * 4 + 32));
+            __m128i p3 = _mm_loadu_si128((const __m128i *)(s + i * 4 + 48));
+
+            __m128i r_lo = channel_sse41(p0, p1, rs), r_hi = channel_sse41(p2, p3, rs);
+            __m128i g_lo = channel_sse41(p0, p1, gs), g_hi = channel_sse41(p2, p3, gs);
+            __m128i b_lo = channel_sse41(p0, p1, bs), b_hi = channel_sse41(p2, p3, bs);
+
+            _mm_storeu_si128((__m128i *)(y + i),
+                             _mm_packus_epi16(rgb_to_y_sse41(r_lo, g_lo, b_lo),
+                                              rgb_to_y_sse41(r_hi, g_hi, b_hi)));
+
+            if (uv != NULL) {
+                __m128i r = even_sse41(r_lo, r_hi);
+                __m128i g = even_sse41(g_lo, g_hi);
+                __m128i b = even_sse41(b_lo, b_hi);
+                __m128i t = _mm_packus_epi16(rgb_to_c_sse41(r, g, b, -38, -74, 112),
+                                             rgb_to_c_sse41(r, g, b, 112, -94, -18));
+
+                _mm_storeu_si128((__m128i *)(uv + i), _mm_unpacklo_epi8(t, _mm_srli_si128(t, 8)));
+            }
+        }
+
+        swconverter_rgb32_to_yuv420sp_row(y, uv, s, i, width, r_shift, b_shift);
+    }
+}
+
+SSE41 static void csc_BGRA8888_to_YUV420SP_sse41(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_sse41(y_dst, uv_dst, rgb_src, width, height, 16, 0);
+}
+
+SSE41 static void csc_RGBA8888_to_YUV420SP_sse41(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int   width,
+    unsigned int   height)
+{
+    rgb32_to_yuv420sp_sse41(y_dst, uv_dst, rgb_src, width, height, 0, 16);
+}
+
+/* 8 samples of P010 as 16 bit lanes, see swconverter_p010_sample() */
+SSE41 static inline __m128i p010_to_8bit_sse41(
+    const unsigned short       *src,
+    __m128i                     in_offset,
+    __m128i                     mul,
+    __m128i                     add_lo,
+    __m128i                     add_hi)
+{
+    __m128i s = _mm_sub_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)src), 6), in_offset);
+    __m128i lo = _mm_srai_epi32(_mm_mullo_epi32(_mm_cvtepi16_epi32(s), mul), 12);
+    __m128i hi = _mm_srai_epi32(_mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_unpackhi_epi64(s, s)), mul), 12);
+
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, add_lo), 4);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, add_hi), 4);
+
+    return _mm_packs_epi32(lo, hi);
+}
+
+SSE41 static void csc_P010_to_8bit_row_sse41(
+    unsigned char              *dst,
+    const unsigned short       *src,
+    unsigned int                count,
+    const SWCONVERTER_P010_MAP *map,
+    const unsigned char         dither[8],
+    unsigned int                swap)
+{
+    const __m128i swap_pairs = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m128i in_offset = _mm_set1_epi16((short)map->in_offset);
+    const __m128i mul = _mm_set1_epi32(map->mul);
+    /* out_offset and the dither of each lane are added in one go */
+    const __m128i add_lo = _mm_add_epi32(_mm_set1_epi32(map->out_offset << 4),
+                                         _mm_setr_epi32(dither[0], dither[1], dither[2], dither[3]));
+    const __m128i add_hi = _mm_add_epi32(_mm_set1_epi32(map->out_offset << 4),
+                                         _mm_setr_epi32(dither[4], dither[5], dither[6], dither[7]));
+    unsigned int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        /* packus clamps to 0 .. 255 like the C kernel */
+        __m128i out = _mm_packus_epi16(p010_to_8bit_sse41(src + i, in_offset, mul, add_lo, add_hi),
+                                       p010_to_8bit_sse41(src + i + 8, in_offset, mul, add_lo, add_hi));
+
+        if (swap)
+            out = _mm_shuffle_epi8(out, swap_pairs);
+
+        _mm_storeu_si128((__m128i *)(dst + i), out);
+    }
+
+    swconverter_p010_row(dst, src, i, count, map, dither, swap);
+}
+
+const SWCONVERTER_KERNELS swconverter_kernels_sse41 = {
+    .name = "sse4.1",
+    .interleave_memcpy = csc_interleave_memcpy_sse41,
+    .deinterleave_memcpy = csc_deinterleave_memcpy_sse41,
+    .tiled_to_linear_y = csc_tiled_to_linear_y_sse41,
+    .tiled_to_linear_uv = csc_tiled_to_linear_uv_sse41,
+    .tiled_to_linear_uv_deinterleave = csc_tiled_to_linear_uv_deinterleave_sse41,
+    .BGRA8888_to_YUV420SP = csc_BGRA8888_to_YUV420SP_sse41,
+    .RGBA8888_to_YUV420SP = csc_RGBA8888_to_YUV420SP_sse41,
+    .P010_to_8bit_row = csc_P010_to_8bit_row_sse41,
+};
+
+#endif /* __x86_64__ || __i386__ */
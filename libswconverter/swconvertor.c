@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "swconverter.h"
+#include "swconverter_kernels.h"
 
 #ifdef NEON_SUPPORT
 #ifdef USE_NV12T_128X64
@@ -1316,104 +1317,41 @@ static void Tile2D_To_YUV420(unsigned char *Y_plane, unsigned char *Cb_plane, un
 #endif /* USE_NV12T_128X64 */
 
 /*
- * De-interleaves src to dest1, dest2
- *
- * @param dest1
- *   Address of de-interleaved data[out]
- *
- * @param dest2
- *   Address of de-interleaved data[out]
- *
- * @param src
- *   Address of interleaved data[in]
- *
- * @param src_size
- *   Size of interleaved data[in]
- */
-void csc_deinterleave_memcpy(
-    unsigned char *dest1,
-    unsigned char *dest2,
-    unsigned char *src,
-    unsigned int src_size)
-{
-    unsigned int i = 0;
-    for(i=0; i<src_size/2; i++) {
-        dest1[i] = src[i*2];
-        dest2[i] = src[i*2+1];
-    }
-}
-
-/*
- * Interleaves src1, src2 to dest
- *
- * @param dest
- *   Address of interleaved data[out]
- *
- * @param src1
- *   Address of de-interleaved data[in]
- *
- * @param src2
- *   Address of de-interleaved data[in]
- *
- * @param src_size
- *   Size of de-interleaved data[in]
+ * C kernels
+ * They are the reference of the other kernels in swconverter_kernels.h
  */
-void csc_interleave_memcpy(
+static void csc_interleave_memcpy_c(
     unsigned char *dest,
     unsigned char *src1,
     unsigned char *src2,
     unsigned int src_size)
 {
-#ifdef NEON_SUPPORT
-    csc_interleave_memcpy_neon(dest, src1, src2, src_size);
-#else
-/* not neon */
     unsigned int i = 0;
     for(i=0; i<src_size; i++) {
         dest[i*2] = src1[i];
         dest[i*2+1] = src2[i];
     }
-#endif /* NEON_SUPPORT */
 }
 
-/*
- * Converts tiled data to linear.
- * 1. y of nv12t to y of yuv420p
- * 2. y of nv12t to y of yuv420s
- *
- * @param dst
- *   y address of yuv420[out]
- *
- * @param src
- *   y address of nv12t[in]
- *
- * @param yuv420_width
- *   real width of yuv420[in]
- *   it should be even
- *
- * @param yuv420_height
- *   real height of yuv420[in]
- *   it should be even.
- *
- */
-void csc_tiled_to_linear_y(
+static void csc_deinterleave_memcpy_c(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int src_size)
+{
+    unsigned int i = 0;
+    for(i=0; i<src_size/2; i++) {
+        dest1[i] = src[i*2];
+        dest2[i] = src[i*2+1];
+    }
+}
+
+static void csc_tiled_to_linear_y_c(
     unsigned char *y_dst,
     unsigned char *y_src,
     unsigned int width,
     unsigned int height)
 {
-#ifdef NEON_SUPPORT
-#ifdef USE_NV12T_128X64
-    csc_tiled_to_linear_crop_neon(y_dst, y_src, width, height, 0, 0, 0, 0);
-#else
-    csc_tiled_to_linear_y_neon(y_dst, y_src, width, height);
-#endif /* USE_NV12T_128X64 */
-
-#else
-/* not neon */
-#ifdef USE_NV12T_128X64
-    csc_tiled_to_linear_crop(y_dst, y_src, width, height, 0, 0, 0, 0);
-#else
     unsigned int i, j, k;
     unsigned int aligned_width, aligned_height;
     unsigned int tiled_width;
@@ -1476,6 +1414,360 @@ void csc_tiled_to_linear_y(
             }
         }
     }
+}
+
+static void csc_tiled_to_linear_uv_c(
+    unsigned char *uv_dst,
+    unsigned char *uv_src,
+    unsigned int width,
+    unsigned int height)
+{
+    unsigned int i, j, k;
+    unsigned int aligned_width, aligned_height;
+    unsigned int tiled_width;
+    unsigned int src_offset, dst_offset;
+
+    aligned_height = height & (~0x7);
+    aligned_width = width & (~0xF);
+    tiled_width = ((width + 15) >> 4) << 4;
+
+    for (i = 0; i < aligned_height; i = i + 8) {
+        for (j = 0; j<aligned_width; j = j + 16) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = width * i + j;
+            for (k = 0; k < 4; k++) {
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width;
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width;
+            }
+        }
+        if (aligned_width != width) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = width * i + j;
+            for (k = 0; k < 4; k++) {
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width;
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width;
+            }
+        }
+    }
+
+    if (aligned_height != height) {
+        for (j = 0; j<aligned_width; j = j + 16) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = width * i + j;
+            for (k = 0; k < height - aligned_height; k = k + 1) {
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width;
+            }
+        }
+        if (aligned_width != width) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = width * i + j;
+            for (k = 0; k < height - aligned_height; k = k + 1) {
+                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width;
+            }
+        }
+    }
+}
+
+static void csc_tiled_to_linear_uv_deinterleave_c(
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *uv_src,
+    unsigned int width,
+    unsigned int height)
+{
+    unsigned int i, j, k;
+    unsigned int aligned_width, aligned_height;
+    unsigned int tiled_width;
+    unsigned int src_offset, dst_offset;
+
+    aligned_height = height & (~0x7);
+    aligned_width = width & (~0xF);
+    tiled_width = ((width + 15) >> 4) << 4;
+
+    for (i = 0; i < aligned_height; i = i + 8) {
+        for (j = 0; j<aligned_width; j = j + 16) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = (width >> 1) * i + (j >> 1);
+            for (k = 0; k < 4; k++) {
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width >> 1;
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width >> 1;
+            }
+        }
+        if (aligned_width != width) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = (width >> 1) * i + (j >> 1);
+            for (k = 0; k < 4; k++) {
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width >> 1;
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width >> 1;
+            }
+        }
+    }
+    if (aligned_height != height) {
+        for (j = 0; j<aligned_width; j = j + 16) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = (width >> 1) * i + (j >> 1);
+            for (k = 0; k < height - aligned_height; k = k + 1) {
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, 16);
+                src_offset += 16;
+                dst_offset += width >> 1;
+            }
+        }
+        if (aligned_width != width) {
+            src_offset = (tiled_width * i) + (j << 3);
+            dst_offset = (width >> 1) * i + (j >> 1);
+            for (k = 0; k < height - aligned_height; k = k + 1) {
+                csc_deinterleave_memcpy_c(u_dst + dst_offset, v_dst + dst_offset,
+                                          uv_src + src_offset, width - j);
+                src_offset += 16;
+                dst_offset += width >> 1;
+            }
+        }
+    }
+}
+
+static void csc_BGRA8888_to_YUV420SP_c(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    unsigned int i, j;
+    unsigned int tmp;
+
+    unsigned int R, G, B;
+    unsigned int Y, U, V;
+
+    unsigned int offset = width * height;
+
+    unsigned int *pSrc = (unsigned int *)rgb_src;
+
+    unsigned char *pDstY = (unsigned char *)y_dst;
+    unsigned char *pDstUV = (unsigned char *)uv_dst;
+
+    unsigned int yIndex = 0;
+    unsigned int uvIndex = 0;
+
+    for (j = 0; j < height; j++) {
+        for (i = 0; i < width; i++) {
+            tmp = pSrc[j * width + i];
+
+            R = (tmp & 0x00FF0000) >> 16;
+            G = (tmp & 0x0000FF00) >> 8;
+            B = (tmp & 0x000000FF);
+
+            Y = ((66 * R) + (129 * G) + (25 * B) + 128);
+            Y = Y >> 8;
+            Y += 16;
+
+            pDstY[yIndex++] = (unsigned char)Y;
+
+            if ((j % 2) == 0 && (i % 2) == 0) {
+                U = ((-38 * R) - (74 * G) + (112 * B) + 128);
+                U = U >> 8;
+                U += 128;
+                V = ((112 * R) - (94 * G) - (18 * B) + 128);
+                V = V >> 8;
+                V += 128;
+
+                pDstUV[uvIndex++] = (unsigned char)U;
+                pDstUV[uvIndex++] = (unsigned char)V;
+            }
+        }
+    }
+}
+
+static void csc_RGBA8888_to_YUV420SP_c(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    unsigned int i, j;
+    unsigned int tmp;
+
+    unsigned int R, G, B;
+    unsigned int Y, U, V;
+
+    unsigned int offset = width * height;
+
+    unsigned int *pSrc = (unsigned int *)rgb_src;
+
+    unsigned char *pDstY = (unsigned char *)y_dst;
+    unsigned char *pDstUV = (unsigned char *)uv_dst;
+
+    unsigned int yIndex = 0;
+    unsigned int uvIndex = 0;
+
+    for (j = 0; j < height; j++) {
+        for (i = 0; i < width; i++) {
+            tmp = pSrc[j * width + i];
+
+            B = (tmp & 0x00FF0000) >> 16;
+            G = (tmp & 0x0000FF00) >> 8;
+            R = (tmp & 0x000000FF);
+
+            Y = ((66 * R) + (129 * G) + (25 * B) + 128);
+            Y = Y >> 8;
+            Y += 16;
+
+            pDstY[yIndex++] = (unsigned char)Y;
+
+            if ((j % 2) == 0 && (i % 2) == 0) {
+                U = ((-38 * R) - (74 * G) + (112 * B) + 128);
+                U = U >> 8;
+                U += 128;
+                V = ((112 * R) - (94 * G) - (18 * B) + 128);
+                V = V >> 8;
+                V += 128;
+
+                pDstUV[uvIndex++] = (unsigned char)U;
+                pDstUV[uvIndex++] = (unsigned char)V;
+            }
+        }
+    }
+}
+
+static void csc_P010_to_8bit_row_c(
+    unsigned char *dst,
+    const unsigned short *src,
+    unsigned int count,
+    const SWCONVERTER_P010_MAP *map,
+    const unsigned char dither[8],
+    unsigned int swap)
+{
+    swconverter_p010_row(dst, src, 0, count, map, dither, swap);
+}
+
+const SWCONVERTER_KERNELS swconverter_kernels_c = {
+    .name = "c",
+    .interleave_memcpy = csc_interleave_memcpy_c,
+    .deinterleave_memcpy = csc_deinterleave_memcpy_c,
+    .tiled_to_linear_y = csc_tiled_to_linear_y_c,
+    .tiled_to_linear_uv = csc_tiled_to_linear_uv_c,
+    .tiled_to_linear_uv_deinterleave = csc_tiled_to_linear_uv_deinterleave_c,
+    .BGRA8888_to_YUV420SP = csc_BGRA8888_to_YUV420SP_c,
+    .RGBA8888_to_YUV420SP = csc_RGBA8888_to_YUV420SP_c,
+    .P010_to_8bit_row = csc_P010_to_8bit_row_c,
+};
+
+/*
+ * De-interleaves src to dest1, dest2
+ *
+ * @param dest1
+ *   Address of de-interleaved data[out]
+ *
+ * @param dest2
+ *   Address of de-interleaved data[out]
+ *
+ * @param src
+ *   Address of interleaved data[in]
+ *
+ * @param src_size
+ *   Size of interleaved data[in]
+ */
+void csc_deinterleave_memcpy(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int src_size)
+{
+    swconverter_get_kernels()->deinterleave_memcpy(dest1, dest2, src, src_size);
+}
+
+/*
+ * Interleaves src1, src2 to dest
+ *
+ * @param dest
+ *   Address of interleaved data[out]
+ *
+ * @param src1
+ *   Address of de-interleaved data[in]
+ *
+ * @param src2
+ *   Address of de-interleaved data[in]
+ *
+ * @param src_size
+ *   Size of de-interleaved data[in]
+ */
+void csc_interleave_memcpy(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int src_size)
+{
+#ifdef NEON_SUPPORT
+    csc_interleave_memcpy_neon(dest, src1, src2, src_size);
+#else
+    swconverter_get_kernels()->interleave_memcpy(dest, src1, src2, src_size);
+#endif /* NEON_SUPPORT */
+}
+
+/*
+ * Converts tiled data to linear.
+ * 1. y of nv12t to y of yuv420p
+ * 2. y of nv12t to y of yuv420s
+ *
+ * @param dst
+ *   y address of yuv420[out]
+ *
+ * @param src
+ *   y address of nv12t[in]
+ *
+ * @param yuv420_width
+ *   real width of yuv420[in]
+ *   it should be even
+ *
+ * @param yuv420_height
+ *   real height of yuv420[in]
+ *   it should be even.
+ *
+ */
+void csc_tiled_to_linear_y(
+    unsigned char *y_dst,
+    unsigned char *y_src,
+    unsigned int width,
+    unsigned int height)
+{
+#ifdef NEON_SUPPORT
+#ifdef USE_NV12T_128X64
+    csc_tiled_to_linear_crop_neon(y_dst, y_src, width, height, 0, 0, 0, 0);
+#else
+    csc_tiled_to_linear_y_neon(y_dst, y_src, width, height);
+#endif /* USE_NV12T_128X64 */
+
+#else
+/* not neon */
+#ifdef USE_NV12T_128X64
+    csc_tiled_to_linear_crop(y_dst, y_src, width, height, 0, 0, 0, 0);
+#else
+    swconverter_get_kernels()->tiled_to_linear_y(y_dst, y_src, width, height);
 #endif /* USE_NV12T_128X64 */
 #endif /* NEON_SUPPORT */
 }
@@ -1515,62 +1807,7 @@ void csc_tiled_to_linear_uv(
 #ifdef USE_NV12T_128X64
     csc_tiled_to_linear_crop(uv_dst, uv_src, width, height, 0, 0, 0, 0);
 #else
-    unsigned int i, j, k;
-    unsigned int aligned_width, aligned_height;
-    unsigned int tiled_width;
-    unsigned int src_offset, dst_offset;
-
-    aligned_height = height & (~0x7);
-    aligned_width = width & (~0xF);
-    tiled_width = ((width + 15) >> 4) << 4;
-
-    for (i = 0; i < aligned_height; i = i + 8) {
-        for (j = 0; j<aligned_width; j = j + 16) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = width * i + j;
-            for (k = 0; k < 4; k++) {
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width;
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width;
-            }
-        }
-        if (aligned_width != width) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = width * i + j;
-            for (k = 0; k < 4; k++) {
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width;
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width;
-            }
-        }
-    }
-
-    if (aligned_height != height) {
-        for (j = 0; j<aligned_width; j = j + 16) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = width * i + j;
-            for (k = 0; k < height - aligned_height; k = k + 1) {
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width;
-            }
-        }
-        if (aligned_width != width) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = width * i + j;
-            for (k = 0; k < height - aligned_height; k = k + 1) {
-                memcpy(uv_dst + dst_offset, uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width;
-            }
-        }
-    }
+    swconverter_get_kernels()->tiled_to_linear_uv(uv_dst, uv_src, width, height);
 #endif /* USE_NV12T_128X64 */
 #endif /* NEON_SUPPORT */
 }
@@ -1614,67 +1851,7 @@ void csc_tiled_to_linear_uv_deinterleave(
     csc_tiled_to_linear_deinterleave_crop(u_dst, v_dst, uv_src, width, height,
                                           0, 0, 0, 0);
 #else
-    unsigned int i, j, k;
-    unsigned int aligned_width, aligned_height;
-    unsigned int tiled_width;
-    unsigned int src_offset, dst_offset;
-
-    aligned_height = height & (~0x7);
-    aligned_width = width & (~0xF);
-    tiled_width = ((width + 15) >> 4) << 4;
-
-    for (i = 0; i < aligned_height; i = i + 8) {
-        for (j = 0; j<aligned_width; j = j + 16) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = (width >> 1) * i + (j >> 1);
-            for (k = 0; k < 4; k++) {
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width >> 1;
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width >> 1;
-            }
-        }
-        if (aligned_width != width) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = (width >> 1) * i + (j >> 1);
-            for (k = 0; k < 4; k++) {
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width >> 1;
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width >> 1;
-            }
-        }
-    }
-    if (aligned_height != height) {
-        for (j = 0; j<aligned_width; j = j + 16) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = (width >> 1) * i + (j >> 1);
-            for (k = 0; k < height - aligned_height; k = k + 1) {
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, 16);
-                src_offset += 16;
-                dst_offset += width >> 1;
-            }
-        }
-        if (aligned_width != width) {
-            src_offset = (tiled_width * i) + (j << 3);
-            dst_offset = (width >> 1) * i + (j >> 1);
-            for (k = 0; k < height - aligned_height; k = k + 1) {
-                csc_deinterleave_memcpy(u_dst + dst_offset, v_dst + dst_offset,
-                                        uv_src + src_offset, width - j);
-                src_offset += 16;
-                dst_offset += width >> 1;
-            }
-        }
-    }
+    swconverter_get_kernels()->tiled_to_linear_uv_deinterleave(u_dst, v_dst, uv_src, width, height);
 #endif /* USE_NV12T_128X64 */
 #endif /* NEON_SUPPORT */
 }
@@ -2093,49 +2270,7 @@ void csc_BGRA8888_to_YUV420SP(
 #ifdef NEON_SUPPORT
     csc_BGRA8888_to_YUV420SP_NEON(y_dst, uv_dst, rgb_src, width, height);
 #else
-    unsigned int i, j;
-    unsigned int tmp;
-
-    unsigned int R, G, B;
-    unsigned int Y, U, V;
-
-    unsigned int offset = width * height;
-
-    unsigned int *pSrc = (unsigned int *)rgb_src;
-
-    unsigned char *pDstY = (unsigned char *)y_dst;
-    unsigned char *pDstUV = (unsigned char *)uv_dst;
-
-    unsigned int yIndex = 0;
-    unsigned int uvIndex = 0;
-
-    for (j = 0; j < height; j++) {
-        for (i = 0; i < width; i++) {
-            tmp = pSrc[j * width + i];
-
-            R = (tmp & 0x00FF0000) >> 16;
-            G = (tmp & 0x0000FF00) >> 8;
-            B = (tmp & 0x000000FF);
-
-            Y = ((66 * R) + (129 * G) + (25 * B) + 128);
-            Y = Y >> 8;
-            Y += 16;
-
-            pDstY[yIndex++] = (unsigned char)Y;
-
-            if ((j % 2) == 0 && (i % 2) == 0) {
-                U = ((-38 * R) - (74 * G) + (112 * B) + 128);
-                U = U >> 8;
-                U += 128;
-                V = ((112 * R) - (94 * G) - (18 * B) + 128);
-                V = V >> 8;
-                V += 128;
-
-                pDstUV[uvIndex++] = (unsigned char)U;
-                pDstUV[uvIndex++] = (unsigned char)V;
-            }
-        }
-    }
+    swconverter_get_kernels()->BGRA8888_to_YUV420SP(y_dst, uv_dst, rgb_src, width, height);
 #endif /* NEON_SUPPORT */
 }
 
@@ -2167,48 +2302,96 @@ void csc_RGBA8888_to_YUV420SP(
 #ifdef NEON_SUPPORT
     csc_RGBA8888_to_YUV420SP_NEON(y_dst, uv_dst, rgb_src, width, height);
 #else
-    unsigned int i, j;
-    unsigned int tmp;
-
-    unsigned int R, G, B;
-    unsigned int Y, U, V;
-
-    unsigned int offset = width * height;
-
-    unsigned int *pSrc = (unsigned int *)rgb_src;
-
-    unsigned char *pDstY = (unsigned char *)y_dst;
-    unsigned char *pDstUV = (unsigned char *)uv_dst;
-
-    unsigned int yIndex = 0;
-    unsigned int uvIndex = 0;
-
-    for (j = 0; j < height; j++) {
-        for (i = 0; i < width; i++) {
-            tmp = pSrc[j * width + i];
-
-            B = (tmp & 0x00FF0000) >> 16;
-            G = (tmp & 0x0000FF00) >> 8;
-            R = (tmp & 0x000000FF);
-
-            Y = ((66 * R) + (129 * G) + (25 * B) + 128);
-            Y = Y >> 8;
-            Y += 16;
-
-            pDstY[yIndex++] = (unsigned char)Y;
+    swconverter_get_kernels()->RGBA8888_to_YUV420SP(y_dst, uv_dst, rgb_src, width, height);
+#endif /* NEON_SUPPORT */
+}
 
-            if ((j % 2) == 0 && (i % 2) == 0) {
-                U = ((-38 * R) - (74 * G) + (112 * B) + 128);
-                U = U >> 8;
-                U += 128;
-                V = ((112 * R) - (94 * G) - (18 * B) + 128);
-                V = V >> 8;
-                V += 128;
+/*
+ * Converts P010 to YUV420SP
+ *
+ * @param y_dst
+ *   Y plane address of YUV420SP[out]
+ *
+ * @param uv_dst
+ *   UV plane address of YUV420SP[out]
+ *
+ * @param y_src
+ *   Y plane address of P010[in]
+ *
+ * @param uv_src
+ *   UV plane address of P010[in]
+ *
+ * @param width
+ *   Width of P010[in]
+ *
+ * @param height
+ *   Height of P010[in]
+ *
+ * @param swap_uv
+ *   Writes CrCb[in]
+ *
+ * @param dither
+ *   Ordered dither[in]
+ *
+ * @param range
+ *   CSC_P010_RANGE_*[in]
+ */
+void csc_P010_to_YUV420SP(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int width,
+    unsigned int height,
+    unsigned int swap_uv,
+    unsigned int dither,
+    unsigned int range)
+{
+    swconverter_P010_to_YUV420SP(swconverter_get_kernels(), y_dst, uv_dst, y_src, uv_src,
+                                 width, height, swap_uv, dither, range);
+}
 
-                pDstUV[uvIndex++] = (unsigned char)U;
-                pDstUV[uvIndex++] = (unsigned char)V;
-            }
-        }
-    }
-#endif /* NEON_SUPPORT */
+/*
+ * Converts P010 to YUV420P
+ *
+ * @param y_dst
+ *   Y plane address of YUV420P[out]
+ *
+ * @param u_dst
+ *   U plane address of YUV420P[out]
+ *
+ * @param v_dst
+ *   V plane address of YUV420P[out]
+ *
+ * @param y_src
+ *   Y plane address of P010[in]
+ *
+ * @param uv_src
+ *   UV plane address of P010[in]
+ *
+ * @param width
+ *   Width of P010[in]
+ *
+ * @param height
+ *   Height of P010[in]
+ *
+ * @param dither
+ *   Ordered dither[in]
+ *
+ * @param range
+ *   CSC_P010_RANGE_*[in]
+ */
+void csc_P010_to_YUV420P(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned short *y_src,
+    unsigned short *uv_src,
+    unsigned int width,
+    unsigned int height,
+    unsigned int dither,
+    unsigned int range)
+{
+    swconverter_P010_to_YUV420P(swconverter_get_kernels(), y_dst, u_dst, v_dst, y_src, uv_src,
+                                width, height, dither, range);
 }
@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "swconverter_kernels.h"
+
+static const unsigned int kWidth = 1920;
+static const unsigned int kHeight = 1080;
+
+/* Arg: SWCONVERTER_ISA */
+static const SWCONVERTER_KERNELS *kernelsOrSkip(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels =
+        swconverter_get_kernels_for(static_cast<SWCONVERTER_ISA>(state.range(0)));
+
+    if (kernels == nullptr)
+        state.SkipWithError("not supported on this CPU");
+    else
+        state.SetLabel(kernels->name);
+
+    return kernels;
+}
+
+static void BM_RGBA8888ToYUV420SP(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned char> rgb(kWidth * kHeight * 4, 0x80);
+    std::vector<unsigned char> y(kWidth * kHeight), uv(kWidth * kHeight / 2);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        kernels->RGBA8888_to_YUV420SP(y.data(), uv.data(), rgb.data(), kWidth, kHeight);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * rgb.size());
+}
+
+static void BM_TiledToLinearNV12(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned char> src(kWidth * (kHeight + 8) * 3 / 2, 0x80);
+    std::vector<unsigned char> y(kWidth * kHeight), uv(kWidth * kHeight / 2);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        kernels->tiled_to_linear_y(y.data(), src.data(), kWidth, kHeight);
+        kernels->tiled_to_linear_uv(uv.data(), src.data(), kWidth, kHeight / 2);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * (y.size() + uv.size()));
+}
+
+static void BM_TiledToLinearI420(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned char> src(kWidth * (kHeight + 8) * 3 / 2, 0x80);
+    std::vector<unsigned char> y(kWidth * kHeight), u(kWidth * kHeight / 4), v(kWidth * kHeight / 4);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        kernels->tiled_to_linear_y(y.data(), src.data(), kWidth, kHeight);
+        kernels->tiled_to_linear_uv_deinterleave(u.data(), v.data(), src.data(), kWidth, kHeight / 2);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * (y.size() + u.size() + v.size()));
+}
+
+static void BM_InterleaveMemcpy(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned char> u(kWidth * kHeight / 4, 1), v(kWidth * kHeight / 4, 2);
+    std::vector<unsigned char> uv(kWidth * kHeight / 2);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        kernels->interleave_memcpy(uv.data(), u.data(), v.data(), u.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * uv.size());
+}
+
+/* Args: SWCONVERTER_ISA, dither */
+static void BM_P010ToNV12(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned short> ySrc(kWidth * kHeight, 0x8000), uvSrc(kWidth * kHeight / 2, 0x8000);
+    std::vector<unsigned char> y(kWidth * kHeight), uv(kWidth * kHeight / 2);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        swconverter_P010_to_YUV420SP(kernels, y.data(), uv.data(), ySrc.data(), uvSrc.data(),
+                                     kWidth, kHeight, 0, state.range(1), 0);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["Mpixels/s"] = benchmark::Counter(state.iterations() * kWidth * kHeight / 1e6,
+                                                     benchmark::Counter::kIsRate);
+}
+
+static void BM_P010ToI420(benchmark::State &state)
+{
+    const SWCONVERTER_KERNELS *kernels = kernelsOrSkip(state);
+    std::vector<unsigned short> ySrc(kWidth * kHeight, 0x8000), uvSrc(kWidth * kHeight / 2, 0x8000);
+    std::vector<unsigned char> y(kWidth * kHeight), u(kWidth * kHeight / 4), v(kWidth * kHeight / 4);
+
+    if (kernels == nullptr)
+        return;
+
+    for (auto _ : state) {
+        swconverter_P010_to_YUV420P(kernels, y.data(), u.data(), v.data(), ySrc.data(), uvSrc.data(),
+                                    kWidth, kHeight, state.range(1), 0);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["Mpixels/s"] = benchmark::Counter(state.iterations() * kWidth * kHeight / 1e6,
+                                                     benchmark::Counter::kIsRate);
+}
+
+static void isaArgs(benchmark::internal::Benchmark *b)
+{
+    for (int isa = SWCONVERTER_ISA_C; isa < SWCONVERTER_ISA_MAX; isa++)
+        b->Arg(isa);
+}
+
+static void isaDitherArgs(benchmark::internal::Benchmark *b)
+{
+    for (int isa = SWCONVERTER_ISA_C; isa < SWCONVERTER_ISA_MAX; isa++) {
+        b->Args({ isa, 0 });
+        b->Args({ isa, 1 });
+    }
+}
+
+BENCHMARK(BM_RGBA8888ToYUV420SP)->Apply(isaArgs);
+BENCHMARK(BM_TiledToLinearNV12)->Apply(isaArgs);
+BENCHMARK(BM_TiledToLinearI420)->Apply(isaArgs);
+BENCHMARK(BM_InterleaveMemcpy)->Apply(isaArgs);
+BENCHMARK(BM_P010ToNV12)->Apply(isaDitherArgs);
+BENCHMARK(BM_P010ToI420)->Apply(isaDitherArgs);
+
+BENCHMARK_MAIN();
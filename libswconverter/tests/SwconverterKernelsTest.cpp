@@ -0,0 +1,345 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "swconverter.h"
+}
+#include "swconverter_kernels.h"
+
+/* Bytes written past the end of a plane would change these */
+static const size_t kGuard = 64;
+static const unsigned char kGuardByte = 0xA5;
+
+static std::vector<unsigned char> randomBytes(size_t size, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<unsigned char> data(size);
+
+    for (auto &b : data)
+        b = static_cast<unsigned char>(rng());
+
+    return data;
+}
+
+/* 10 bit samples in the high bits of each word, the low bits are garbage */
+static std::vector<unsigned short> randomP010(size_t size, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<unsigned short> data(size);
+
+    for (auto &s : data)
+        s = static_cast<unsigned short>(rng());
+
+    return data;
+}
+
+static std::vector<unsigned char> guarded(size_t size)
+{
+    return std::vector<unsigned char>(size + kGuard, kGuardByte);
+}
+
+class SwconverterKernelsTest : public ::testing::TestWithParam<SWCONVERTER_ISA>
+{
+protected:
+    void SetUp() override
+    {
+        ref = swconverter_get_kernels_for(SWCONVERTER_ISA_C);
+        simd = swconverter_get_kernels_for(GetParam());
+        if (simd == nullptr)
+            GTEST_SKIP() << "not supported on this CPU";
+    }
+
+    const SWCONVERTER_KERNELS *ref = nullptr;
+    const SWCONVERTER_KERNELS *simd = nullptr;
+};
+
+/* Widths hit the vector body, the scalar tail and both */
+static const unsigned int kWidths[] = { 2, 14, 16, 30, 32, 48, 66, 176, 720, 1918, 1920 };
+static const unsigned int kHeights[] = { 2, 8, 18, 30, 64, 98 };
+
+TEST_P(SwconverterKernelsTest, InterleaveMemcpy)
+{
+    for (unsigned int size : { 0u, 1u, 15u, 16u, 31u, 33u, 100u, 4096u, 4099u }) {
+        auto a = randomBytes(size, size);
+        auto b = randomBytes(size, size + 1);
+        auto expected = guarded(size * 2);
+        auto actual = guarded(size * 2);
+
+        ref->interleave_memcpy(expected.data(), a.data(), b.data(), size);
+        simd->interleave_memcpy(actual.data(), a.data(), b.data(), size);
+        ASSERT_EQ(expected, actual) << "size " << size;
+    }
+}
+
+TEST_P(SwconverterKernelsTest, DeinterleaveMemcpy)
+{
+    for (unsigned int size : { 0u, 2u, 30u, 32u, 62u, 66u, 200u, 8192u, 8198u }) {
+        auto src = randomBytes(size, size);
+        auto expected1 = guarded(size / 2), expected2 = guarded(size / 2);
+        auto actual1 = guarded(size / 2), actual2 = guarded(size / 2);
+
+        ref->deinterleave_memcpy(expected1.data(), expected2.data(), src.data(), size);
+        simd->deinterleave_memcpy(actual1.data(), actual2.data(), src.data(), size);
+        ASSERT_EQ(expected1, actual1) << "size " << size;
+        ASSERT_EQ(expected2, actual2) << "size " << size;
+    }
+}
+
+TEST_P(SwconverterKernelsTest, TiledToLinear)
+{
+    for (unsigned int width : kWidths) {
+        for (unsigned int height : kHeights) {
+            size_t tiled = ((width + 15) & ~15u) * ((height + 15) & ~15u);
+            auto src = randomBytes(tiled, width * height);
+            auto expected = guarded(width * height);
+            auto actual = guarded(width * height);
+
+            ref->tiled_to_linear_y(expected.data(), src.data(), width, height);
+            simd->tiled_to_linear_y(actual.data(), src.data(), width, height);
+            ASSERT_EQ(expected, actual) << "y " << width << "x" << height;
+
+            expected = guarded(width * height / 2);
+            actual = guarded(width * height / 2);
+            ref->tiled_to_linear_uv(expected.data(), src.data(), width, height / 2);
+            simd->tiled_to_linear_uv(actual.data(), src.data(), width, height / 2);
+            ASSERT_EQ(expected, actual) << "uv " << width << "x" << height;
+        }
+    }
+}
+
+TEST_P(SwconverterKernelsTest, TiledToLinearDeinterleave)
+{
+    for (unsigned int width : kWidths) {
+        for (unsigned int height : kHeights) {
+            size_t tiled = ((width + 15) & ~15u) * ((height / 2 + 7) & ~7u);
+            size_t plane = (width / 2) * (height / 2);
+            auto src = randomBytes(tiled, width + height);
+            auto expectedU = guarded(plane), expectedV = guarded(plane);
+            auto actualU = guarded(plane), actualV = guarded(plane);
+
+            ref->tiled_to_linear_uv_deinterleave(expectedU.data(), expectedV.data(), src.data(), width, height / 2);
+            simd->tiled_to_linear_uv_deinterleave(actualU.data(), actualV.data(), src.data(), width, height / 2);
+            ASSERT_EQ(expectedU, actualU) << width << "x" << height;
+            ASSERT_EQ(expectedV, actualV) << width << "x" << height;
+        }
+    }
+}
+
+TEST_P(SwconverterKernelsTest, RGB32ToYUV420SP)
+{
+    for (unsigned int width : kWidths) {
+        for (unsigned int height : { 1u, 2u, 7u, 30u }) {
+            size_t uvSize = ((width + 1) / 2) * 2 * ((height + 1) / 2);
+            auto src = randomBytes(width * height * 4, width * 31 + height);
+
+            for (bool bgra : { true, false }) {
+                auto expectedY = guarded(width * height), expectedUV = guarded(uvSize);
+                auto actualY = guarded(width * height), actualUV = guarded(uvSize);
+
+                if (bgra) {
+                    ref->BGRA8888_to_YUV420SP(expectedY.data(), expectedUV.data(), src.data(), width, height);
+                    simd->BGRA8888_to_YUV420SP(actualY.data(), actualUV.data(), src.data(), width, height);
+                } else {
+                    ref->RGBA8888_to_YUV420SP(expectedY.data(), expectedUV.data(), src.data(), width, height);
+                    simd->RGBA8888_to_YUV420SP(actualY.data(), actualUV.data(), src.data(), width, height);
+                }
+
+                ASSERT_EQ(expectedY, actualY) << (bgra ? "BGRA " : "RGBA ") << width << "x" << height;
+                ASSERT_EQ(expectedUV, actualUV) << (bgra ? "BGRA " : "RGBA ") << width << "x" << height;
+            }
+        }
+    }
+}
+
+TEST_P(SwconverterKernelsTest, RGB32ToYUV420SPExtremes)
+{
+    /* saturated channels give the largest sums of the coefficients */
+    const unsigned int width = 64, height = 2;
+    std::vector<unsigned char> src(width * height * 4);
+
+    for (unsigned int i = 0; i < width * height; i++) {
+        for (unsigned int c = 0; c < 4; c++)
+            src[i * 4 + c] = ((i >> c) & 1) ? 0xFF : 0x00;
+    }
+
+    auto expectedY = guarded(width * height), expectedUV = guarded(width);
+    auto actualY = guarded(width * height), actualUV = guarded(width);
+
+    ref->BGRA8888_to_YUV420SP(expectedY.data(), expectedUV.data(), src.data(), width, height);
+    simd->BGRA8888_to_YUV420SP(actualY.data(), actualUV.data(), src.data(), width, height);
+    ASSERT_EQ(expectedY, actualY);
+    ASSERT_EQ(expectedUV, actualUV);
+}
+
+TEST_P(SwconverterKernelsTest, P010To8bitRow)
+{
+    const unsigned char pattern[8] = { 0, 8, 2, 10, 12, 4, 14, 6 };
+
+    for (unsigned int count : { 0u, 2u, 7u, 8u, 14u, 16u, 30u, 32u, 34u, 1918u, 1920u }) {
+        auto src = randomP010(count, count);
+
+        for (unsigned int range = CSC_P010_RANGE_KEEP; range <= CSC_P010_RANGE_FULL_TO_NARROW; range++) {
+            for (const SWCONVERTER_P010_MAP &map : swconverter_p010_maps[range]) {
+                for (unsigned int swap : { 0u, 1u }) {
+                    auto expected = guarded(count), actual = guarded(count);
+
+                    ref->P010_to_8bit_row(expected.data(), src.data(), count, &map, pattern, swap);
+                    simd->P010_to_8bit_row(actual.data(), src.data(), count, &map, pattern, swap);
+                    ASSERT_EQ(expected, actual) << "count " << count << " range " << range << " swap " << swap;
+                }
+            }
+        }
+    }
+}
+
+TEST_P(SwconverterKernelsTest, P010ToYUV420)
+{
+    for (unsigned int width : kWidths) {
+        for (unsigned int height : { 2u, 6u, 30u }) {
+            auto y = randomP010(width * height, width * height);
+            auto uv = randomP010(width * height / 2, width + height);
+
+            for (unsigned int dither : { 0u, 1u }) {
+                for (unsigned int range = CSC_P010_RANGE_KEEP; range <= CSC_P010_RANGE_FULL_TO_NARROW; range++) {
+                    auto expectedY = guarded(width * height), expectedUV = guarded(width * height / 2);
+                    auto actualY = guarded(width * height), actualUV = guarded(width * height / 2);
+
+                    swconverter_P010_to_YUV420SP(ref, expectedY.data(), expectedUV.data(), y.data(), uv.data(),
+                                                 width, height, 1, dither, range);
+                    swconverter_P010_to_YUV420SP(simd, actualY.data(), actualUV.data(), y.data(), uv.data(),
+                                                 width, height, 1, dither, range);
+                    ASSERT_EQ(expectedY, actualY) << "SP " << width << "x" << height;
+                    ASSERT_EQ(expectedUV, actualUV) << "SP " << width << "x" << height;
+
+                    size_t plane = (width / 2) * (height / 2);
+                    auto expectedU = guarded(plane), expectedV = guarded(plane);
+                    auto actualU = guarded(plane), actualV = guarded(plane);
+
+                    swconverter_P010_to_YUV420P(ref, expectedY.data(), expectedU.data(), expectedV.data(),
+                                                y.data(), uv.data(), width, height, dither, range);
+                    swconverter_P010_to_YUV420P(simd, actualY.data(), actualU.data(), actualV.data(),
+                                                y.data(), uv.data(), width, height, dither, range);
+                    ASSERT_EQ(expectedY, actualY) << "P " << width << "x" << height;
+                    ASSERT_EQ(expectedU, actualU) << "P " << width << "x" << height;
+                    ASSERT_EQ(expectedV, actualV) << "P " << width << "x" << height;
+                }
+            }
+        }
+    }
+}
+
+static unsigned short p010(unsigned int sample)
+{
+    return static_cast<unsigned short>(sample << 6);
+}
+
+TEST(SwconverterP010Test, RangeMapping)
+{
+    const SWCONVERTER_P010_MAP *keep = swconverter_p010_maps[CSC_P010_RANGE_KEEP];
+    const SWCONVERTER_P010_MAP *toFull = swconverter_p010_maps[CSC_P010_RANGE_NARROW_TO_FULL];
+    const SWCONVERTER_P010_MAP *toNarrow = swconverter_p010_maps[CSC_P010_RANGE_FULL_TO_NARROW];
+
+    for (unsigned int v = 0; v < 1024; v++)
+        ASSERT_EQ(std::min((v + 2) >> 2, 255u), swconverter_p010_sample(p010(v), &keep[0], 8)) << v;
+
+    EXPECT_EQ(0, swconverter_p010_sample(p010(64), &toFull[0], 8));
+    EXPECT_EQ(255, swconverter_p010_sample(p010(940), &toFull[0], 8));
+    EXPECT_EQ(0, swconverter_p010_sample(p010(4), &toFull[0], 8));
+    EXPECT_EQ(255, swconverter_p010_sample(p010(1019), &toFull[0], 8));
+    /* 64 .. 960 is 128 +- 127.5, the lower end rounds up */
+    EXPECT_EQ(1, swconverter_p010_sample(p010(64), &toFull[1], 8));
+    EXPECT_EQ(128, swconverter_p010_sample(p010(512), &toFull[1], 8));
+    EXPECT_EQ(255, swconverter_p010_sample(p010(960), &toFull[1], 8));
+
+    EXPECT_EQ(16, swconverter_p010_sample(p010(0), &toNarrow[0], 8));
+    EXPECT_EQ(235, swconverter_p010_sample(p010(1023), &toNarrow[0], 8));
+    EXPECT_EQ(16, swconverter_p010_sample(p010(0), &toNarrow[1], 8));
+    EXPECT_EQ(128, swconverter_p010_sample(p010(512), &toNarrow[1], 8));
+    EXPECT_EQ(240, swconverter_p010_sample(p010(1023), &toNarrow[1], 8));
+}
+
+TEST(SwconverterP010Test, DitherKeepsTheMean)
+{
+    /* a flat 10 bit level between two 8 bit levels */
+    const unsigned int width = 64, height = 16;
+
+    for (unsigned int level : { 129u, 130u, 131u, 601u }) {
+        std::vector<unsigned short> y(width * height, p010(level)), uv(width * height / 2, p010(level));
+        std::vector<unsigned char> y8(width * height), uv8(width * height / 2);
+        double sum = 0;
+
+        csc_P010_to_YUV420SP(y8.data(), uv8.data(), y.data(), uv.data(), width, height, 0, 1,
+                             CSC_P010_RANGE_KEEP);
+
+        for (unsigned char v : y8) {
+            ASSERT_GE(v, level / 4);
+            ASSERT_LE(v, level / 4 + 1);
+            sum += v;
+        }
+
+        EXPECT_NEAR(level / 4.0, sum / y8.size(), 1.0 / 32) << level;
+    }
+}
+
+TEST(SwconverterP010Test, SwapUV)
+{
+    const unsigned int width = 32, height = 4;
+    std::vector<unsigned short> y(width * height, p010(400)), uv(width * height / 2);
+    std::vector<unsigned char> y8(width * height), uv8(width * height / 2);
+    std::vector<unsigned char> u(width * height / 4), v(width * height / 4);
+
+    for (unsigned int i = 0; i < uv.size(); i++)
+        uv[i] = p010((i % 2) ? 800 : 200);
+
+    csc_P010_to_YUV420SP(y8.data(), uv8.data(), y.data(), uv.data(), width, height, 1, 0,
+                         CSC_P010_RANGE_KEEP);
+    for (unsigned int i = 0; i < uv8.size(); i++)
+        ASSERT_EQ((i % 2) ? 50 : 200, uv8[i]) << i;
+
+    csc_P010_to_YUV420P(y8.data(), u.data(), v.data(), y.data(), uv.data(), width, height, 0,
+                        CSC_P010_RANGE_KEEP);
+    EXPECT_EQ(std::vector<unsigned char>(u.size(), 50), u);
+    EXPECT_EQ(std::vector<unsigned char>(v.size(), 200), v);
+    EXPECT_EQ(std::vector<unsigned char>(y8.size(), 100), y8);
+}
+
+TEST(SwconverterKernelsSelectTest, BestIsSupported)
+{
+    const SWCONVERTER_KERNELS *best = swconverter_get_kernels();
+
+    ASSERT_NE(nullptr, best);
+    EXPECT_EQ(best, swconverter_get_kernels());
+    EXPECT_EQ(&swconverter_kernels_c, swconverter_get_kernels_for(SWCONVERTER_ISA_C));
+    EXPECT_EQ(nullptr, swconverter_get_kernels_for(SWCONVERTER_ISA_MAX));
+}
+
+INSTANTIATE_TEST_SUITE_P(Isa, SwconverterKernelsTest,
+                         ::testing::Values(SWCONVERTER_ISA_SSE41, SWCONVERTER_ISA_AVX2, SWCONVERTER_ISA_NEON64),
+                         [](const ::testing::TestParamInfo<SWCONVERTER_ISA> &info) {
+                             switch (info.param) {
+                             case SWCONVERTER_ISA_SSE41: return std::string("sse41");
+                             case SWCONVERTER_ISA_AVX2: return std::string("avx2");
+                             case SWCONVERTER_ISA_NEON64: return std::string("neon64");
+                             default: return std::string("c");
+                             }
+                         });
@@ -52,6 +52,8 @@ LOCAL_SRC_FILES:= \
 	./system/ExynosVisionResManager.cpp \
 	./system/ExynosVisionMemoryAllocator.cpp \
 	./system/ExynosVisionSubgraph.cpp \
+	./system/ExynosVisionGraphCache.cpp \
+	./system/ExynosVisionTraceRecorder.cpp \
 	./common/ExynosVisionContext.cpp \
 	./common/ExynosVisionGraph.cpp \
 	./common/ExynosVisionTarget.cpp \
@@ -91,3 +93,5 @@ $(warning ##############################################)
 include $(LOCAL_ROOT_PATH)/kernel/vpu/Android.mk
 include $(LOCAL_ROOT_PATH)/kernel/score/Android.mk
 #include $(LOCAL_ROOT_PATH)/kernel/opencl/Android.mk
+include $(LOCAL_ROOT_PATH)/unittest/Android.mk
+include $(LOCAL_ROOT_PATH)/tools/Android.mk
@@ -119,6 +119,31 @@ EXIT:
     return status;
 }
 
+VX_API_ENTRY vx_status VX_API_CALL vxExportContextTrace(vx_context context, vx_enum format, const vx_char *path)
+{
+    EXYNOS_VISION_API_IN();
+    if (ExynosVisionContext::isValidContext((ExynosVisionContext*)context) == vx_false_e) {
+        VXLOGE("wrong pointer(%p)", context);
+        return VX_ERROR_INVALID_REFERENCE;
+    }
+
+    vx_status status = VX_SUCCESS;
+
+    ExynosVisionContext *cContext = (ExynosVisionContext*)context;
+
+    if (path == NULL) {
+        status = VX_ERROR_INVALID_PARAMETERS;
+        goto EXIT;
+    }
+
+    status = cContext->getTraceRecorder()->exportTrace(format, path);
+
+EXIT:
+    EXYNOS_VISION_API_OUT();
+
+    return status;
+}
+
 VX_API_ENTRY vx_node VX_API_CALL vxCreateNodeByStructure(vx_graph graph,
                                 vx_enum kernel_enum,
                                 vx_reference params[],
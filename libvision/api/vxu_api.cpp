@@ -19,46 +19,113 @@
 
 #include <VX/vx.h>
 #include <VX/vxu.h>
+#include <VX/vx_internal.h>
+#include <VX/vx_api_ext.h>
 
-VX_API_ENTRY vx_status VX_API_CALL vxuColorConvert(vx_context context, vx_image src, vx_image dst)
+#include "ExynosVisionContext.h"
+#include "ExynosVisionGraph.h"
+#include "ExynosVisionNode.h"
+#include "ExynosVisionGraphCache.h"
+
+using namespace android;
+
+/*
+ * Every immediate function runs a single node graph. The verified graph is kept in the graph cache
+ * of the context, and the next call with the same kernel, formats, dimensions and scalar values
+ * only rebinds the data references of the node instead of creating and verifying a new graph.
+ * Between the calls the node is bound to placeholders of the cache entry.
+ */
+static vx_status vxuProcessNode(vx_context context, vx_enum kernel_enum, vx_reference params[], vx_uint32 num, vx_bool immediate_border)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxColorConvertNode(graph, src, dst);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
+    if (ExynosVisionContext::isValidContext((ExynosVisionContext*)context) == vx_false_e) {
+        VXLOGE("wrong context(%p)", context);
+        return VX_ERROR_INVALID_REFERENCE;
+    }
+
+    ExynosVisionContext *cContext = (ExynosVisionContext*)context;
+    ExynosVisionGraphCache *graph_cache = cContext->getGraphCache();
+
+    vx_status status = VX_SUCCESS;
+    vx_border_mode_t border;
+    border.mode = VX_BORDER_MODE_UNDEFINED;
+    border.constant_value = 0;
+    if (immediate_border == vx_true_e) {
+        status = vxQueryContext(context, VX_CONTEXT_ATTRIBUTE_IMMEDIATE_BORDER_MODE, &border, sizeof(border));
+        if (status != VX_SUCCESS)
+            return status;
+    }
+
+    graph_cache_key_t key;
+    vx_bool cacheable = vx_false_e;
+    if (graph_cache->makeKey(kernel_enum, &border, params, num, &key) == VX_SUCCESS)
+        cacheable = vx_true_e;
+
+    graph_cache_entry_t entry;
+    memset(&entry, 0x0, sizeof(entry));
+
+    if ((cacheable == vx_true_e) && (graph_cache->takeGraph(&key, &entry) == vx_true_e)) {
+        for (vx_uint32 i = 0; i < num; i++) {
+            if ((params[i] == NULL) || ((ExynosVisionDataReference*)params[i] == entry.node->getDataRefByIndex(i)))
+                continue;
+
+            status = vxSetParameterByIndex((vx_node)entry.node, i, params[i]);
+            if (status != VX_SUCCESS) {
+                VXLOGE("rebinding parameter %d of cached %s fails, err:%d", i, entry.node->getName(), status);
+                break;
             }
+        }
+    } else {
+        vx_graph graph = vxCreateGraph(context);
+        status = vxGetStatus((vx_reference)graph);
+        if (status != VX_SUCCESS)
+            return status;
+
+        vx_node node = vxCreateNodeByStructure(graph, kernel_enum, params, num);
+        if (node) {
+            if (immediate_border == vx_true_e)
+                status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border));
+            if (status == VX_SUCCESS)
+                status = vxVerifyGraph(graph);
+            /* the graph holds the node */
+            entry.node = (ExynosVisionNode*)node;
             vxReleaseNode(&node);
+        } else {
+            status = VX_FAILURE;
         }
-        vxReleaseGraph(&graph);
+
+        entry.graph = (ExynosVisionGraph*)graph;
     }
+
+    if (status == VX_SUCCESS)
+        status = vxProcessGraph((vx_graph)entry.graph);
+
+    if ((cacheable == vx_true_e) && (status == VX_SUCCESS))
+        graph_cache->putGraph(&key, &entry);
+    else
+        graph_cache->releaseEntry(&entry);
+
     return status;
 }
 
+VX_API_ENTRY vx_status VX_API_CALL vxuColorConvert(vx_context context, vx_image src, vx_image dst)
+{
+    vx_reference params[] = {
+        (vx_reference)src,
+        (vx_reference)dst,
+    };
+    return vxuProcessNode(context, VX_KERNEL_COLOR_CONVERT, params, dimof(params), vx_false_e);
+}
+
 VX_API_ENTRY vx_status VX_API_CALL vxuChannelExtract(vx_context context, vx_image src, vx_enum channel, vx_image dst)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxChannelExtractNode(graph, src, channel, dst);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar schannel = vxCreateScalar(context, VX_TYPE_ENUM, &channel);
+    vx_reference params[] = {
+        (vx_reference)src,
+        (vx_reference)schannel,
+        (vx_reference)dst,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_CHANNEL_EXTRACT, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&schannel);
     return status;
 }
 
@@ -69,497 +136,226 @@ VX_API_ENTRY vx_status VX_API_CALL vxuChannelCombine(vx_context context,
                             vx_image plane3,
                             vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxChannelCombineNode(graph, plane0, plane1, plane2, plane3, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
-}
-
-static vx_status vx_useImmediateBorderMode(vx_context context, vx_node node)
-{
-    vx_border_mode_t border;
-    vx_status status = vxQueryContext(context, VX_CONTEXT_ATTRIBUTE_IMMEDIATE_BORDER_MODE, &border, sizeof(border));
-    if (status == VX_SUCCESS)
-        status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border));
-    return status;
+    vx_reference params[] = {
+        (vx_reference)plane0,
+        (vx_reference)plane1,
+        (vx_reference)plane2,
+        (vx_reference)plane3,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_CHANNEL_COMBINE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuSobel3x3(vx_context context, vx_image src, vx_image output_x, vx_image output_y)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxSobel3x3Node(graph, src, output_x, output_y);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)src,
+        (vx_reference)output_x,
+        (vx_reference)output_y,
+    };
+    return vxuProcessNode(context, VX_KERNEL_SOBEL_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuMagnitude(vx_context context, vx_image grad_x, vx_image grad_y, vx_image dst)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxMagnitudeNode(graph, grad_x, grad_y, dst);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)grad_x,
+        (vx_reference)grad_y,
+        (vx_reference)dst,
+    };
+    return vxuProcessNode(context, VX_KERNEL_MAGNITUDE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuPhase(vx_context context, vx_image grad_x, vx_image grad_y, vx_image dst)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxPhaseNode(graph, grad_x, grad_y, dst);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)grad_x,
+        (vx_reference)grad_y,
+        (vx_reference)dst,
+    };
+    return vxuProcessNode(context, VX_KERNEL_PHASE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuScaleImage(vx_context context, vx_image src, vx_image dst, vx_enum type)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxScaleImageNode(graph, src, dst, type);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar stype = vxCreateScalar(context, VX_TYPE_ENUM, &type);
+    vx_reference params[] = {
+        (vx_reference)src,
+        (vx_reference)dst,
+        (vx_reference)stype,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_SCALE_IMAGE, params, dimof(params), vx_true_e);
+    vxReleaseScalar(&stype);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuTableLookup(vx_context context, vx_image input, vx_lut lut, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxTableLookupNode(graph, input, lut, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)lut,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_TABLE_LOOKUP, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuHistogram(vx_context context, vx_image input, vx_distribution distribution)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxHistogramNode(graph, input, distribution);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)distribution,
+    };
+    return vxuProcessNode(context, VX_KERNEL_HISTOGRAM, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuEqualizeHist(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxEqualizeHistNode(graph, input, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_EQUALIZE_HISTOGRAM, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAbsDiff(vx_context context, vx_image in1, vx_image in2, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAbsDiffNode(graph, in1, in2, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)out,
+    };
+    return vxuProcessNode(context, VX_KERNEL_ABSDIFF, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuMeanStdDev(vx_context context, vx_image input, vx_float32 *mean, vx_float32 *stddev)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_scalar s_mean = vxCreateScalar(context, VX_TYPE_FLOAT32, NULL);
-        vx_scalar s_stddev = vxCreateScalar(context, VX_TYPE_FLOAT32, NULL);
-        vx_node node = vxMeanStdDevNode(graph, input, s_mean, s_stddev);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-                vxReadScalarValue(s_mean, mean);
-                vxReadScalarValue(s_stddev, stddev);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseScalar(&s_mean);
-        vxReleaseScalar(&s_stddev);
-        vxReleaseGraph(&graph);
+    vx_scalar s_mean = vxCreateScalar(context, VX_TYPE_FLOAT32, NULL);
+    vx_scalar s_stddev = vxCreateScalar(context, VX_TYPE_FLOAT32, NULL);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)s_mean,
+        (vx_reference)s_stddev,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_MEAN_STDDEV, params, dimof(params), vx_false_e);
+    if (status == VX_SUCCESS) {
+        vxReadScalarValue(s_mean, mean);
+        vxReadScalarValue(s_stddev, stddev);
     }
+    vxReleaseScalar(&s_mean);
+    vxReleaseScalar(&s_stddev);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuThreshold(vx_context context, vx_image input, vx_threshold thresh, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxThresholdNode(graph, input, thresh, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)thresh,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_THRESHOLD, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuIntegralImage(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxIntegralImageNode(graph, input, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_INTEGRAL_IMAGE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuErode3x3(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxErode3x3Node(graph, input, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_ERODE_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuDilate3x3(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxDilate3x3Node(graph, input, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_DILATE_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuMedian3x3(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxMedian3x3Node(graph, input, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_MEDIAN_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuBox3x3(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxBox3x3Node(graph, input, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_BOX_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuGaussian3x3(vx_context context, vx_image input, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxGaussian3x3Node(graph, input, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_GAUSSIAN_3x3, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuConvolve(vx_context context, vx_image input, vx_convolution conv, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxConvolveNode(graph, input, conv, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)conv,
+        (vx_reference)output,
+    };
+    return vxuProcessNode(context, VX_KERNEL_CUSTOM_CONVOLUTION, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuGaussianPyramid(vx_context context, vx_image input, vx_pyramid gaussian)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxGaussianPyramidNode(graph, input, gaussian);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)gaussian,
+    };
+    return vxuProcessNode(context, VX_KERNEL_GAUSSIAN_PYRAMID, params, dimof(params), vx_true_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAccumulateImage(vx_context context, vx_image input, vx_image accum)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAccumulateImageNode(graph, input, accum);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)accum,
+    };
+    return vxuProcessNode(context, VX_KERNEL_ACCUMULATE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAccumulateWeightedImage(vx_context context, vx_image input, vx_scalar scale, vx_image accum)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAccumulateWeightedImageNode(graph, input, scale, accum);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)scale,
+        (vx_reference)accum,
+    };
+    return vxuProcessNode(context, VX_KERNEL_ACCUMULATE_WEIGHTED, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAccumulateSquareImage(vx_context context, vx_image input, vx_scalar scale, vx_image accum)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAccumulateSquareImageNode(graph, input, scale, accum);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)scale,
+        (vx_reference)accum,
+    };
+    return vxuProcessNode(context, VX_KERNEL_ACCUMULATE_SQUARE, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuMinMaxLoc(vx_context context, vx_image input,
@@ -567,45 +363,30 @@ VX_API_ENTRY vx_status VX_API_CALL vxuMinMaxLoc(vx_context context, vx_image inp
                         vx_array minLoc, vx_array maxLoc,
                         vx_scalar minCount, vx_scalar maxCount)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxMinMaxLocNode(graph, input, minVal, maxVal, minLoc, maxLoc, minCount, maxCount);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)minVal,
+        (vx_reference)maxVal,
+        (vx_reference)minLoc,
+        (vx_reference)maxLoc,
+        (vx_reference)minCount,
+        (vx_reference)maxCount,
+    };
+    return vxuProcessNode(context, VX_KERNEL_MINMAXLOC, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuConvertDepth(vx_context context, vx_image input, vx_image output, vx_enum policy, vx_int32 shift)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
+    vx_scalar spolicy = vxCreateScalar(context, VX_TYPE_ENUM, &policy);
     vx_scalar sshift = vxCreateScalar(context, VX_TYPE_INT32, &shift);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxConvertDepthNode(graph, input, output, policy, sshift);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+        (vx_reference)spolicy,
+        (vx_reference)sshift,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_CONVERTDEPTH, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&spolicy);
     vxReleaseScalar(&sshift);
     return status;
 }
@@ -614,240 +395,146 @@ VX_API_ENTRY vx_status VX_API_CALL vxuCannyEdgeDetector(vx_context context, vx_i
                                vx_int32 gradient_size, vx_enum norm_type,
                                vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxCannyEdgeDetectorNode(graph, input, hyst, gradient_size, norm_type, output);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar sgradient_size = vxCreateScalar(context, VX_TYPE_INT32, &gradient_size);
+    vx_scalar snorm_type = vxCreateScalar(context, VX_TYPE_ENUM, &norm_type);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)hyst,
+        (vx_reference)sgradient_size,
+        (vx_reference)snorm_type,
+        (vx_reference)output,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_CANNY_EDGE_DETECTOR, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&sgradient_size);
+    vxReleaseScalar(&snorm_type);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuHalfScaleGaussian(vx_context context, vx_image input, vx_image output, vx_int32 kernel_size)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxHalfScaleGaussianNode(graph, input, output, kernel_size);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar skernel_size = vxCreateScalar(context, VX_TYPE_INT32, &kernel_size);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)output,
+        (vx_reference)skernel_size,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_HALFSCALE_GAUSSIAN, params, dimof(params), vx_true_e);
+    vxReleaseScalar(&skernel_size);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAnd(vx_context context, vx_image in1, vx_image in2, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAndNode(graph, in1, in2, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)out,
+    };
+    return vxuProcessNode(context, VX_KERNEL_AND, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuOr(vx_context context, vx_image in1, vx_image in2, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxOrNode(graph, in1, in2, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)out,
+    };
+    return vxuProcessNode(context, VX_KERNEL_OR, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuXor(vx_context context, vx_image in1, vx_image in2, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxXorNode(graph, in1, in2, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)out,
+    };
+    return vxuProcessNode(context, VX_KERNEL_XOR, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuNot(vx_context context, vx_image input, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxNotNode(graph, input, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
-    return status;
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)out,
+    };
+    return vxuProcessNode(context, VX_KERNEL_NOT, params, dimof(params), vx_false_e);
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuMultiply(vx_context context, vx_image in1, vx_image in2, vx_float32 scale, vx_enum overflow_policy, vx_enum rounding_policy, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
     vx_scalar sscale = vxCreateScalar(context, VX_TYPE_FLOAT32, &scale);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxMultiplyNode(graph, in1, in2, sscale, overflow_policy, rounding_policy, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar soverflow_policy = vxCreateScalar(context, VX_TYPE_ENUM, &overflow_policy);
+    vx_scalar srounding_policy = vxCreateScalar(context, VX_TYPE_ENUM, &rounding_policy);
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)sscale,
+        (vx_reference)soverflow_policy,
+        (vx_reference)srounding_policy,
+        (vx_reference)out,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_MULTIPLY, params, dimof(params), vx_false_e);
     vxReleaseScalar(&sscale);
+    vxReleaseScalar(&soverflow_policy);
+    vxReleaseScalar(&srounding_policy);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuAdd(vx_context context, vx_image in1, vx_image in2, vx_enum policy, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxAddNode(graph, in1, in2, policy, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar spolicy = vxCreateScalar(context, VX_TYPE_ENUM, &policy);
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)spolicy,
+        (vx_reference)out,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_ADD, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&spolicy);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuSubtract(vx_context context, vx_image in1, vx_image in2, vx_enum policy, vx_image out)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxSubtractNode(graph, in1, in2, policy, out);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar spolicy = vxCreateScalar(context, VX_TYPE_ENUM, &policy);
+    vx_reference params[] = {
+        (vx_reference)in1,
+        (vx_reference)in2,
+        (vx_reference)spolicy,
+        (vx_reference)out,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_SUBTRACT, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&spolicy);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuWarpAffine(vx_context context, vx_image input, vx_matrix matrix, vx_enum type, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxWarpAffineNode(graph, input, matrix, type, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar stype = vxCreateScalar(context, VX_TYPE_ENUM, &type);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)matrix,
+        (vx_reference)stype,
+        (vx_reference)output,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_WARP_AFFINE, params, dimof(params), vx_true_e);
+    vxReleaseScalar(&stype);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuWarpPerspective(vx_context context, vx_image input, vx_matrix matrix, vx_enum type, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxWarpPerspectiveNode(graph, input, matrix, type, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar stype = vxCreateScalar(context, VX_TYPE_ENUM, &type);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)matrix,
+        (vx_reference)stype,
+        (vx_reference)output,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_WARP_PERSPECTIVE, params, dimof(params), vx_true_e);
+    vxReleaseScalar(&stype);
     return status;
 }
 
@@ -860,43 +547,36 @@ VX_API_ENTRY vx_status VX_API_CALL vxuHarrisCorners(vx_context context, vx_image
         vx_array corners,
         vx_scalar num_corners)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxHarrisCornersNode(graph, input, strength_thresh, min_distance, sensitivity, gradient_size, block_size, corners, num_corners);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar sgradient_size = vxCreateScalar(context, VX_TYPE_INT32, &gradient_size);
+    vx_scalar sblock_size = vxCreateScalar(context, VX_TYPE_INT32, &block_size);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)strength_thresh,
+        (vx_reference)min_distance,
+        (vx_reference)sensitivity,
+        (vx_reference)sgradient_size,
+        (vx_reference)sblock_size,
+        (vx_reference)corners,
+        (vx_reference)num_corners,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_HARRIS_CORNERS, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&sgradient_size);
+    vxReleaseScalar(&sblock_size);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuFastCorners(vx_context context, vx_image input, vx_scalar sens, vx_bool nonmax, vx_array corners, vx_scalar num_corners)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxFastCornersNode(graph, input, sens, nonmax, corners, num_corners);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar snonmax = vxCreateScalar(context, VX_TYPE_BOOL, &nonmax);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)sens,
+        (vx_reference)snonmax,
+        (vx_reference)corners,
+        (vx_reference)num_corners,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_FAST_CORNERS, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&snonmax);
     return status;
 }
 
@@ -911,46 +591,36 @@ VX_API_ENTRY vx_status VX_API_CALL vxuOpticalFlowPyrLK(vx_context context, vx_py
                               vx_scalar use_initial_estimate,
                               vx_size window_dimension)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxOpticalFlowPyrLKNode(graph, old_images, new_images, old_points,new_points_estimates, new_points,
-                termination,epsilon,num_iterations,use_initial_estimate,window_dimension);
-        if (node)
-        {
-            status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar stermination = vxCreateScalar(context, VX_TYPE_ENUM, &termination);
+    vx_scalar swindow_dimension = vxCreateScalar(context, VX_TYPE_SIZE, &window_dimension);
+    vx_reference params[] = {
+        (vx_reference)old_images,
+        (vx_reference)new_images,
+        (vx_reference)old_points,
+        (vx_reference)new_points_estimates,
+        (vx_reference)new_points,
+        (vx_reference)stermination,
+        (vx_reference)epsilon,
+        (vx_reference)num_iterations,
+        (vx_reference)use_initial_estimate,
+        (vx_reference)swindow_dimension,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_OPTICAL_FLOW_PYR_LK, params, dimof(params), vx_false_e);
+    vxReleaseScalar(&stermination);
+    vxReleaseScalar(&swindow_dimension);
     return status;
 }
 
 VX_API_ENTRY vx_status VX_API_CALL vxuRemap(vx_context context, vx_image input, vx_remap table, vx_enum policy, vx_image output)
 {
-    vx_status status = VX_FAILURE;
-    vx_graph graph = vxCreateGraph(context);
-    if (vxGetStatus((vx_reference)graph) == VX_SUCCESS)
-    {
-        vx_node node = vxRemapNode(graph, input, table, policy, output);
-        if (node)
-        {
-            status = vx_useImmediateBorderMode(context, node);
-            if (status == VX_SUCCESS)
-                status = vxVerifyGraph(graph);
-            if (status == VX_SUCCESS)
-            {
-                status = vxProcessGraph(graph);
-            }
-            vxReleaseNode(&node);
-        }
-        vxReleaseGraph(&graph);
-    }
+    vx_scalar spolicy = vxCreateScalar(context, VX_TYPE_ENUM, &policy);
+    vx_reference params[] = {
+        (vx_reference)input,
+        (vx_reference)table,
+        (vx_reference)spolicy,
+        (vx_reference)output,
+    };
+    vx_status status = vxuProcessNode(context, VX_KERNEL_REMAP, params, dimof(params), vx_true_e);
+    vxReleaseScalar(&spolicy);
     return status;
 }
-
@@ -113,6 +113,8 @@ ExynosVisionContext::ExynosVisionContext(void) : ExynosVisionReference(this, VX_
     m_immediate_target = NULL;
 
     m_performance_monitor = NULL;
+    m_graph_cache = NULL;
+    m_trace_recorder = NULL;
 
     EXYNOS_VISION_SYSTEM_OUT();
 }
@@ -167,6 +169,10 @@ ExynosVisionContext::init(void)
         return VX_FAILURE;
     }
 
+    m_graph_cache = new ExynosVisionGraphCache(this);
+
+    m_trace_recorder = new ExynosVisionTraceRecorder();
+
     EXYNOS_VISION_SYSTEM_OUT();
 
     return VX_SUCCESS;
@@ -178,6 +184,13 @@ ExynosVisionContext::destroy(void)
     vx_status status = VX_SUCCESS;
     registerLogCallback(NULL, vx_false_e);
 
+    /* cached graphs refer to kernels of targets */
+    if (m_graph_cache) {
+        m_graph_cache->flush();
+        delete m_graph_cache;
+        m_graph_cache = NULL;
+    }
+
     List<ExynosVisionTarget*>::iterator target_iter;
     for (target_iter=m_target_list.begin(); target_iter!=m_target_list.end(); target_iter++) {
         status = (*target_iter)->destroy();
@@ -250,6 +263,11 @@ ExynosVisionContext::destroy(void)
     if (m_performance_monitor)
         delete m_performance_monitor;
 
+    if (m_trace_recorder) {
+        delete m_trace_recorder;
+        m_trace_recorder = NULL;
+    }
+
     return status;
 }
 
@@ -638,6 +656,24 @@ ExynosVisionContext::queryContext(vx_enum attribute, void *ptr, vx_size size)
             else
                 status = VX_ERROR_INVALID_PARAMETERS;
             break;
+        case VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE:
+            if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3) && (m_graph_cache))
+                *(vx_uint32 *)ptr = m_graph_cache->getMaxEntryNum();
+            else
+                status = VX_ERROR_INVALID_PARAMETERS;
+            break;
+        case VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE:
+            if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3) && (m_trace_recorder))
+                *(vx_bool *)ptr = m_trace_recorder->isEnabled();
+            else
+                status = VX_ERROR_INVALID_PARAMETERS;
+            break;
+        case VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY:
+            if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3) && (m_trace_recorder))
+                *(vx_uint32 *)ptr = m_trace_recorder->getCapacity();
+            else
+                status = VX_ERROR_INVALID_PARAMETERS;
+            break;
         case VX_CONTEXT_ATTRIBUTE_UNIQUE_KERNELS:
             if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
                 *(vx_uint32 *)ptr = getUniqueKernelsNum();
@@ -677,6 +713,24 @@ ExynosVisionContext::setContextAttribute(vx_enum attribute, const void *ptr, vx_
             status = VX_ERROR_INVALID_PARAMETERS;
         }
         break;
+    case VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3) && (m_graph_cache))
+            status = m_graph_cache->setMaxEntryNum(*(vx_uint32 *)ptr);
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE:
+        if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3) && (m_trace_recorder))
+            status = m_trace_recorder->setEnable(*(vx_bool *)ptr);
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3) && (m_trace_recorder))
+            status = m_trace_recorder->setCapacity(*(vx_uint32 *)ptr);
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
     default:
         status = VX_ERROR_NOT_SUPPORTED;
         break;
@@ -29,6 +29,8 @@
 
 #include "ExynosVisionMemoryAllocator.h"
 #include "ExynosVisionPerfMonitor.h"
+#include "ExynosVisionGraphCache.h"
+#include "ExynosVisionTraceRecorder.h"
 
 namespace android {
 
@@ -74,6 +76,12 @@ private:
     ExynosVisionPerfMonitor<ExynosVisionGraph*> *m_performance_monitor;
 
     ExynosVisionTarget* m_immediate_target;
+
+    /*! \brief The verified graphs of immediate mode */
+    ExynosVisionGraphCache *m_graph_cache;
+
+    /*! \brief The timing records of graphs, subgraphs and nodes */
+    ExynosVisionTraceRecorder *m_trace_recorder;
 public:
 
 private:
@@ -132,6 +140,14 @@ public:
     {
         return m_performance_monitor;
     }
+    ExynosVisionGraphCache* getGraphCache()
+    {
+        return m_graph_cache;
+    }
+    ExynosVisionTraceRecorder* getTraceRecorder()
+    {
+        return m_trace_recorder;
+    }
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
 };
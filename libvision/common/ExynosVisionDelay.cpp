@@ -22,6 +22,7 @@
 #include "ExynosVisionDelay.h"
 
 #include "ExynosVisionContext.h"
+#include "ExynosVisionGraph.h"
 #include "ExynosVisionNode.h"
 
 #include "ExynosVisionImage.h"
@@ -285,7 +286,10 @@ ExynosVisionDelay::ageDelay(void)
 
     vx_status status = VX_SUCCESS;
 
-    m_base_index = (m_base_index + 1) % (vx_uint32)m_count;
+    /* the element of delay[0] becomes delay[-1] */
+    m_frame_mutex.lock();
+    m_base_index = (m_base_index + (vx_uint32)m_count - 1) % (vx_uint32)m_count;
+    m_frame_mutex.unlock();
 
     VXLOGD2("delay has shifted by 1, base index is now %d, count: %d", m_base_index, m_count);
 
@@ -294,17 +298,24 @@ ExynosVisionDelay::ageDelay(void)
     List<struct vx_delay_node_info> *delay_node_list;
     struct vx_delay_node_info *delay_node;
 
+    m_frame_mutex.lock();
     backup_set_vector = m_set_vector;
+    m_frame_mutex.unlock();
 
     vx_uint32 cur_phy_index, target_phy_index;
 
     Vector<List<struct vx_delay_node_info>>::iterator vector_iter;
     for (vector_iter=backup_set_vector.begin(), cur_phy_index=0; vector_iter!=backup_set_vector.end(); vector_iter++, cur_phy_index++) {
         delay_node_list = &(*vector_iter);
-        target_phy_index = (cur_phy_index+1) % (vx_int32)m_count;
+        target_phy_index = (cur_phy_index + (vx_uint32)m_count - 1) % (vx_uint32)m_count;
         for (list_iter=delay_node_list->begin(); list_iter!=delay_node_list->end(); list_iter++) {
             delay_node = &(*list_iter);
 
+            /* frames of pipelined graph find their element by the base index, the topology is kept */
+            ExynosVisionGraph *graph = delay_node->node->getParentGraph();
+            if ((graph->getExecMode() == GRAPH_EXEC_PIPELINE) && (graph->isGraphVerified() == vx_true_e))
+                continue;
+
             VXLOGD2("%s, move from index[%d] to index[%d]", delay_node->node->getName(), cur_phy_index, target_phy_index);
 
             status = delay_node->node->nodeSetParameter(delay_node->index, m_ref_vector[target_phy_index]);
@@ -324,9 +335,12 @@ ExynosVisionDelay::addAssociationToDelay(ExynosVisionDataReference *ref, ExynosV
     /* logical index means distance from base index */
     vx_int32 phy_index = ref->getDelaySlotIndex();
 
+    Mutex::Autolock lock(m_frame_mutex);
+
     struct vx_delay_node_info delay_node;
     delay_node.node = node;
     delay_node.index = node_index;
+    delay_node.logical_index = (phy_index + m_count - m_base_index) % m_count;
 
     List<struct vx_delay_node_info> *delay_node_list;
     delay_node_list = &m_set_vector.editItemAt(phy_index);
@@ -347,6 +361,8 @@ ExynosVisionDelay::removeAssociationToDelay(ExynosVisionDataReference *ref, Exyn
         return vx_false_e;
     }
 
+    Mutex::Autolock lock(m_frame_mutex);
+
     List<struct vx_delay_node_info> *delay_node_list;
     delay_node_list = &m_set_vector.editItemAt(phy_index);
 
@@ -368,6 +384,121 @@ ExynosVisionDelay::removeAssociationToDelay(ExynosVisionDataReference *ref, Exyn
     return ret;
 }
 
+struct vx_delay_node_info*
+ExynosVisionDelay::findAssociation(ExynosVisionNode *node, vx_uint32 node_index)
+{
+    Vector<List<struct vx_delay_node_info>>::iterator vector_iter;
+    List<struct vx_delay_node_info>::iterator list_iter;
+
+    for (vector_iter=m_set_vector.begin(); vector_iter!=m_set_vector.end(); vector_iter++) {
+        for (list_iter=(*vector_iter).begin(); list_iter!=(*vector_iter).end(); list_iter++) {
+            if (((*list_iter).node == node) && ((*list_iter).index == node_index))
+                return &(*list_iter);
+        }
+    }
+
+    VXLOGE("%s, %s(index:%d) is not associated", getName(), node->getName(), node_index);
+
+    return NULL;
+}
+
+ExynosVisionDataReference*
+ExynosVisionDelay::getAssociatedReference(ExynosVisionNode *node, vx_uint32 index)
+{
+    Mutex::Autolock lock(m_frame_mutex);
+
+    struct vx_delay_node_info *delay_node = findAssociation(node, index);
+    if (delay_node == NULL)
+        return NULL;
+
+    return m_ref_vector[(m_base_index + delay_node->logical_index) % m_count];
+}
+
+vx_status
+ExynosVisionDelay::registerFrameAccess(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt)
+{
+    Mutex::Autolock lock(m_frame_mutex);
+
+    struct vx_delay_node_info *delay_node = findAssociation(node, index);
+    if (delay_node == NULL)
+        return VX_ERROR_INVALID_REFERENCE;
+
+    /* the first parameter of the frame takes the base index, the later aging doesn't affect the frame */
+    delay_frame_key_t frame_key(node->getParentGraph(), frame_cnt);
+    if (m_frame_base_map.find(frame_key) == m_frame_base_map.end())
+        m_frame_base_map[frame_key] = m_base_index;
+
+    vx_uint32 phy_index = (m_frame_base_map[frame_key] + delay_node->logical_index) % m_count;
+    m_frame_access_map[phy_index][frame_key]++;
+
+    return VX_SUCCESS;
+}
+
+ExynosVisionDataReference*
+ExynosVisionDelay::acquireFrameElement(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt)
+{
+    Mutex::Autolock lock(m_frame_mutex);
+
+    delay_frame_key_t frame_key(node->getParentGraph(), frame_cnt);
+    struct vx_delay_node_info *delay_node = findAssociation(node, index);
+    if ((delay_node == NULL) || (m_frame_base_map.find(frame_key) == m_frame_base_map.end())) {
+        VXLOGE("%s, frame_%d is not registered", getName(), frame_cnt);
+        return NULL;
+    }
+
+    vx_uint32 phy_index = (m_frame_base_map[frame_key] + delay_node->logical_index) % m_count;
+
+    /* the previous frames of the graph should finish the element first. Frames are processed in order,
+        so the oldest frame never waits here. */
+    map<delay_frame_key_t, vx_uint32> *access_map = &m_frame_access_map[phy_index];
+    while (1) {
+        map<delay_frame_key_t, vx_uint32>::iterator access_iter = access_map->lower_bound(delay_frame_key_t(frame_key.first, 0));
+        if ((access_iter == access_map->end()) || (access_iter->first >= frame_key))
+            break;
+
+        if (m_frame_condition.waitRelative(m_frame_mutex, COMPLETE_WAIT_TIME) != NO_ERROR) {
+            VXLOGE("%s, frame_%d can't access element[%d], frame_%d is using", getName(), frame_cnt, phy_index, access_iter->first.second);
+            return NULL;
+        }
+    }
+
+    return m_ref_vector[phy_index];
+}
+
+void
+ExynosVisionDelay::releaseFrameElement(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt)
+{
+    Mutex::Autolock lock(m_frame_mutex);
+
+    delay_frame_key_t frame_key(node->getParentGraph(), frame_cnt);
+    struct vx_delay_node_info *delay_node = findAssociation(node, index);
+    if ((delay_node == NULL) || (m_frame_base_map.find(frame_key) == m_frame_base_map.end()))
+        return;
+
+    vx_uint32 phy_index = (m_frame_base_map[frame_key] + delay_node->logical_index) % m_count;
+    map<delay_frame_key_t, vx_uint32> *access_map = &m_frame_access_map[phy_index];
+    if ((access_map->find(frame_key) != access_map->end()) && (--(*access_map)[frame_key] == 0))
+        access_map->erase(frame_key);
+
+    m_frame_condition.broadcast();
+}
+
+void
+ExynosVisionDelay::releaseFrame(ExynosVisionGraph *graph, vx_uint32 frame_cnt)
+{
+    Mutex::Autolock lock(m_frame_mutex);
+
+    delay_frame_key_t frame_key(graph, frame_cnt);
+    m_frame_base_map.erase(frame_key);
+
+    /* accesses of a frame that is given up */
+    map<vx_uint32, map<delay_frame_key_t, vx_uint32>>::iterator phy_iter;
+    for (phy_iter=m_frame_access_map.begin(); phy_iter!=m_frame_access_map.end(); phy_iter++)
+        phy_iter->second.erase(frame_key);
+
+    m_frame_condition.broadcast();
+}
+
 vx_status
 ExynosVisionDelay::allocateMemory(vx_enum res_type, struct resource_param *param)
 {
@@ -17,6 +17,8 @@
 #ifndef EXYNOS_VISION_DELAY_H
 #define EXYNOS_VISION_DELAY_H
 
+#include <utils/threads.h>
+
 #include "ExynosVisionReference.h"
 
 namespace android {
@@ -24,8 +26,13 @@ namespace android {
 struct vx_delay_node_info {
     ExynosVisionNode *node;
     vx_uint32 index;
+    /* distance from the base index, it doesn't change while the node is rebound by aging */
+    vx_uint32 logical_index;
 } ;
 
+/* a frame of a pipelined graph */
+typedef pair<ExynosVisionGraph*, vx_uint32> delay_frame_key_t;
+
 class ExynosVisionDelay : public ExynosVisionDataReference {
 private:
     /*! \brief The number of objects in the delay. */
@@ -39,9 +46,18 @@ private:
     /*! \brief The set of objects in the delay. */
     Vector<ExynosVisionDataReference*> m_ref_vector;
 
+    /* nodes of a verified pipelined graph keep their elements, the element of a frame is looked up
+        with the base index when the frame was issued. */
+    Mutex m_frame_mutex;
+    Condition m_frame_condition;
+    map<delay_frame_key_t, vx_uint32> m_frame_base_map;
+    /* accesses that are not finished yet, physical index -> frame -> number of parameters */
+    map<vx_uint32, map<delay_frame_key_t, vx_uint32>> m_frame_access_map;
+
 public:
 
 private:
+    struct vx_delay_node_info* findAssociation(ExynosVisionNode *node, vx_uint32 node_index);
 
 public:
     static vx_status checkValidCreateDelay(ExynosVisionContext *context, ExynosVisionDataReference *reference);
@@ -61,6 +77,13 @@ public:
 
     vx_bool addAssociationToDelay(ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 index);
     vx_bool removeAssociationToDelay(ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 index);
+    ExynosVisionDataReference* getAssociatedReference(ExynosVisionNode *node, vx_uint32 index);
+
+    /* per-frame element access of pipelined graph */
+    vx_status registerFrameAccess(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt);
+    ExynosVisionDataReference* acquireFrameElement(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt);
+    void releaseFrameElement(ExynosVisionNode *node, vx_uint32 index, vx_uint32 frame_cnt);
+    void releaseFrame(ExynosVisionGraph *graph, vx_uint32 frame_cnt);
 
     /* resource management function */
     vx_status allocateMemory(vx_enum buf_type, struct resource_param *param);
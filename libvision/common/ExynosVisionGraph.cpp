@@ -21,6 +21,7 @@
 
 #include "ExynosVisionGraph.h"
 #include "ExynosVisionSubgraph.h"
+#include "ExynosVisionDelay.h"
 
 #define GRAPHDBG    /* VXLOGD */
 
@@ -42,6 +43,9 @@ ExynosVisionGraph::ExynosVisionGraph(ExynosVisionContext *context)
 
     m_performance_monitor = NULL;
     m_is_replaced_flag = vx_false_e;
+    m_node_fusion = vx_true_e;
+    m_pipeline_depth = 1;
+    m_trace_id = 0;
 
     m_error_queue = NULL;
     m_schedule_queue = NULL;
@@ -63,7 +67,8 @@ ExynosVisionGraph::init(void)
     if (m_performance_monitor == NULL)
         VXLOGE("performance monitor can't create");
 
-    m_error_queue = new ExynosVisionQueue<graph_error_message_t>(0);
+    /* subgraph threads and callers of the graph never wait for the error and schedule threads */
+    m_error_queue = new ExynosVisionQueue<graph_error_message_t>(0, QUEUE_DEFAULT_CAPACITY, QUEUE_FULL_POLICY_OVERFLOW);
     m_error_thread = new ExynosVisionThread<ExynosVisionGraph>(this, &ExynosVisionGraph::errorThreadFunc, "graph_err", PRIORITY_DEFAULT);
     if (m_error_thread.get() != NULL) {
         m_error_thread->run();
@@ -71,7 +76,7 @@ ExynosVisionGraph::init(void)
         status = VX_FAILURE;
     }
 
-    m_schedule_queue = new ExynosVisionQueue<graph_schedule_message_t>(0);
+    m_schedule_queue = new ExynosVisionQueue<graph_schedule_message_t>(0, QUEUE_DEFAULT_CAPACITY, QUEUE_FULL_POLICY_OVERFLOW);
     m_schedule_thread = new ExynosVisionThread<ExynosVisionGraph>(this, &ExynosVisionGraph::scheduleThreadFunc, "graph_shd", PRIORITY_DEFAULT);
     if (m_schedule_thread.get() != NULL) {
         m_schedule_thread->run();
@@ -479,6 +484,14 @@ ExynosVisionGraph::verifyGraph(void)
     /* reset the frame count */
     m_frame_cnt_map.clear();
 
+    if (getExecMode() == GRAPH_EXEC_PIPELINE) {
+        status = synchronizeDelayParams();
+        if (status != VX_SUCCESS) {
+            VXLOGE("synchronizing delay parameters fail in verify(%d)", status);
+            goto Exit;
+        }
+    }
+
     VXLOGD3("Topological Sort phase - first");
     status = topologicalSort();
     if (status != VX_SUCCESS) {
@@ -746,6 +759,72 @@ ExynosVisionGraph::initializeKernel(void)
     return status;
 }
 
+vx_bool
+ExynosVisionGraph::isFusibleDataRef(ExynosVisionDataReference *data_ref, ExynosVisionNode *consumer_node)
+{
+    /* only a virtual image between a single writer and the consumer can be elided */
+    if ((data_ref->getType() != VX_TYPE_IMAGE) ||
+        (data_ref->isVirtual() != vx_true_e) ||
+        (data_ref->isDelayElement() == vx_true_e) ||
+        (data_ref->getDirectInputNodeNum(this) != 1) ||
+        (data_ref->getIndirectInputNodeNum(this) != 1) ||
+        (data_ref->getDirectOutputNodeNum(this) != data_ref->getIndirectOutputNodeNum(this)))
+        return vx_false_e;
+
+    /* memory of previous verification is kept, it should have a single buffer */
+    if ((data_ref->isAllocated() == vx_true_e) && (data_ref->getResourceType() != RESOURCE_MNGR_SOLID))
+        return vx_false_e;
+
+    for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(this); i++) {
+        if (data_ref->getDirectOutputNode(this, i) != consumer_node)
+            return vx_false_e;
+    }
+
+    return vx_true_e;
+}
+
+ExynosVisionSubgraph*
+ExynosVisionGraph::findFusibleSubgraph(ExynosVisionNode *node)
+{
+    ExynosVisionNode *pre_node = NULL;
+    vx_uint32 connection_num = 0;
+
+    if ((m_node_fusion != vx_true_e) || node->isHeader())
+        return NULL;
+
+    for (vx_uint32 i = 0; i < node->getInputDataRefNum(); i++) {
+        ExynosVisionDataReference *data_ref = node->getInputDataRefByIndex(i);
+        if ((data_ref == NULL) || (data_ref->getIndirectInputNodeNum(this) == 0))
+            continue;
+
+        if (isFusibleDataRef(data_ref, node) != vx_true_e)
+            return NULL;
+
+        ExynosVisionNode *producer_node = data_ref->getDirectInputNode(this, 0);
+        if ((pre_node != NULL) && (pre_node != producer_node))
+            return NULL;
+
+        pre_node = producer_node;
+        connection_num++;
+    }
+
+    /* all outputs of the previous node should go to this node only */
+    if ((pre_node == NULL) || (pre_node->getPostNodeNum() != connection_num))
+        return NULL;
+
+    if (pre_node->getKernelHandle()->isSameTarget(node->getKernelHandle()) != vx_true_e)
+        return NULL;
+
+    ExynosVisionSubgraph *subgraph = pre_node->getSubgraph();
+    if ((subgraph == NULL) || (subgraph->getTailNode() != pre_node))
+        return NULL;
+
+    if ((subgraph->getInputDataRefNum() + node->getInputDataRefNum()) > MAX_SUBGRAPH_INPUT_PORT_NUM)
+        return NULL;
+
+    return subgraph;
+}
+
 vx_status
 ExynosVisionGraph::groupingSubgraph(void)
 {
@@ -754,7 +833,22 @@ ExynosVisionGraph::groupingSubgraph(void)
 
     for (List<ExynosVisionNode*>::iterator node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++ ) {
         ExynosVisionNode *cur_node = *node_iter;
-        ExynosVisionSubgraph *cur_subgraph = new ExynosVisionSubgraph(this);
+        ExynosVisionSubgraph *cur_subgraph = findFusibleSubgraph(cur_node);
+
+        if (cur_subgraph != NULL) {
+            VXLOGD3("%s is fused into %s", cur_node->getName(), cur_subgraph->getSgName());
+            status = cur_subgraph->addNode(cur_node);
+            cur_node->setSubgraph(cur_subgraph);
+
+            if (status != VX_SUCCESS) {
+                VXLOGE("node can't be fused, err:%d", status);
+                break;
+            }
+
+            continue;
+        }
+
+        cur_subgraph = new ExynosVisionSubgraph(this);
 
         status = cur_subgraph->init(cur_node);
         cur_node->setSubgraph(cur_subgraph);
@@ -826,6 +920,30 @@ ExynosVisionGraph::checkExecutionModePropriety(void)
                 }
             }
         }
+    } else if (getExecMode() == GRAPH_EXEC_PIPELINE) {
+        /* the frame number of child graph follows the parent graph */
+        if (m_parent_node != NULL) {
+            VXLOGE("%s, child graph can't be pipelined", getName());
+            status = VX_FAILURE;
+            goto EXIT;
+        }
+
+        for (List<ExynosVisionNode*>::iterator iter_node = m_sorted_node_list.begin(); iter_node != m_sorted_node_list.end(); iter_node++ ) {
+            for (vx_uint32 p = 0; p < (*iter_node)->getKernelHandle()->getNumParams(); p++) {
+                ExynosVisionDataReference *data_ref =  (*iter_node)->getDataRefByIndex(p);
+                if (data_ref == NULL)
+                    continue;
+
+                /* same as stream mode except delay object, the delay element of each frame is found by its issue. */
+                if ((data_ref->getDirectInputNodeNum(this) != data_ref->getIndirectInputNodeNum(this)) ||
+                    (data_ref->getDirectOutputNodeNum(this) != data_ref->getIndirectOutputNodeNum(this)) ||
+                    (data_ref->getResourceType() == RESOURCE_MNGR_NULL)) {
+                    VXLOGE("%s can't support pipeline mode", data_ref->getName());
+                    status = VX_FAILURE;
+                    goto EXIT;
+                }
+            }
+        }
     }
 
     EXYNOS_VISION_SYSTEM_OUT();
@@ -848,6 +966,14 @@ ExynosVisionGraph::processGraph(void)
     EXYNOS_VISION_SYSTEM_IN();
     vx_status status = VX_FAILURE;
 
+    if (getExecMode() == GRAPH_EXEC_PIPELINE) {
+        status = issuePipelineFrame();
+        if (status == VX_SUCCESS)
+            status = waitPipelineFrames();
+
+        return status;
+    }
+
     if (getExecMode() != GRAPH_EXEC_NORMAL) {
         VXLOGE("processing graph could be executed only on normal mode");
         return VX_FAILURE;
@@ -917,6 +1043,7 @@ ExynosVisionGraph::processGraph(void)
 
     TIMESTAMP_END(time_pair, TIMEPAIR_PROCESS);
     if (time_pair) {
+        traceFrame(frame_cnt, time_pair);
         getContext()->getPerfMonitor()->releaseTimePairStr(this, frame_cnt, time_pair);
     }
 
@@ -925,6 +1052,220 @@ ExynosVisionGraph::processGraph(void)
     return m_error_status;
 }
 
+vx_status
+ExynosVisionGraph::synchronizeDelayParams(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    /* aging keeps the delay parameters of verified pipelined graph, they're rebound before the topology is made */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        for (vx_uint32 p = 0; p < (*node_iter)->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = (*node_iter)->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (data_ref->isDelayElement() != vx_true_e))
+                continue;
+
+            ExynosVisionDataReference *cur_ref = data_ref->getDelay()->getAssociatedReference(*node_iter, p);
+            if (cur_ref == NULL) {
+                status = VX_ERROR_INVALID_REFERENCE;
+                break;
+            }
+
+            if (cur_ref != data_ref) {
+                status = (*node_iter)->nodeSetParameter(p, cur_ref);
+                if (status != VX_SUCCESS) {
+                    VXLOGE("rebinding %s to %s fails, err:%d", cur_ref->getName(), (*node_iter)->getName(), status);
+                    break;
+                }
+            }
+        }
+
+        if (status != VX_SUCCESS)
+            break;
+    }
+
+    return status;
+}
+
+vx_status
+ExynosVisionGraph::issuePipelineFrame(void)
+{
+    EXYNOS_VISION_SYSTEM_IN();
+    vx_status status = VX_SUCCESS;
+
+    if (m_verified == vx_false_e) {
+        status = verifyGraph();
+        if (status != VX_SUCCESS) {
+            VXLOGE("verifying graph fail, err:%d", status);
+            return status;
+        }
+    }
+
+    Mutex::Autolock lock(m_external_lock);
+
+    m_pipeline_mutex.lock();
+
+    if (m_pipeline_frame_list.empty()) {
+        if (m_graph_state.getState() != GRAPH_STATE_VERIFIED) {
+            VXLOGE("%s is not verified", getName());
+            m_pipeline_mutex.unlock();
+            return VX_FAILURE;
+        }
+
+        m_error_status = VX_SUCCESS;
+        m_graph_state.setState(GRAPH_STATE_PROCESSING);
+    }
+
+    /* the oldest frame should be completed before a new frame is issued */
+    while (m_pipeline_frame_list.size() >= m_pipeline_depth) {
+        if (m_pipeline_condition.waitRelative(m_pipeline_mutex, m_sg_list.size() * COMPLETE_WAIT_TIME) != NO_ERROR) {
+            VXLOGE("%s, frame_%d is not completed", getName(), *m_pipeline_frame_list.begin());
+            m_pipeline_mutex.unlock();
+            return VX_ERROR_NO_RESOURCES;
+        }
+    }
+
+    vx_uint32 frame_cnt = requestNewFrameCnt(this);
+
+    time_pair_t *time_pair = getContext()->getPerfMonitor()->requestTimePairStr(this, frame_cnt);
+    TIMESTAMP_START(time_pair, TIMEPAIR_PROCESS);
+
+    m_pipeline_frame_list.push_back(frame_cnt);
+    m_pipeline_footer_cnt_map[frame_cnt] = 0;
+    m_pipeline_time_pair_map[frame_cnt] = time_pair;
+
+    /* the current delay slots belong to this frame, the next aging applies to the next frame */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_sorted_node_list.begin(); node_iter!=m_sorted_node_list.end(); node_iter++) {
+        for (vx_uint32 p = 0; p < (*node_iter)->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = (*node_iter)->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (data_ref->isDelayElement() != vx_true_e))
+                continue;
+
+            status = data_ref->getDelay()->registerFrameAccess(*node_iter, p, frame_cnt);
+            if (status != VX_SUCCESS) {
+                VXLOGE("registering frame_%d to %s fails, err:%d", frame_cnt, data_ref->getDelay()->getName(), status);
+                releasePipelineFrame(frame_cnt);
+                if (m_pipeline_frame_list.empty())
+                    m_graph_state.setState(GRAPH_STATE_VERIFIED);
+                m_pipeline_mutex.unlock();
+                return status;
+            }
+        }
+    }
+
+    m_pipeline_mutex.unlock();
+
+    List<ExynosVisionSubgraph*>::iterator sg_iter;
+    for (sg_iter=m_sg_header_list.begin(); sg_iter!=m_sg_header_list.end(); sg_iter++) {
+        VXLOGD2("trigger to %s to start, frame_%d", (*sg_iter)->getSgName(), frame_cnt);
+        status = (*sg_iter)->pushTrigger(frame_cnt);
+        if (status != VX_SUCCESS) {
+            VXLOGE("pushing done event fails, err:%d", status);
+        }
+    }
+
+    EXYNOS_VISION_SYSTEM_OUT();
+
+    return status;
+}
+
+vx_status
+ExynosVisionGraph::waitPipelineFrames(void)
+{
+    Mutex::Autolock lock(m_pipeline_mutex);
+
+    while (!m_pipeline_frame_list.empty()) {
+        if (m_pipeline_condition.waitRelative(m_pipeline_mutex, m_sg_list.size() * COMPLETE_WAIT_TIME) != NO_ERROR) {
+            VXLOGE("%s, frame_%d is not completed", getName(), *m_pipeline_frame_list.begin());
+            if (m_error_status == VX_SUCCESS)
+                m_error_status = VX_FAILURE;
+            return m_error_status;
+        }
+    }
+
+    return m_error_status;
+}
+
+void
+ExynosVisionGraph::releasePipelineFrame(vx_uint32 frame_cnt)
+{
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_sorted_node_list.begin(); node_iter!=m_sorted_node_list.end(); node_iter++) {
+        for (vx_uint32 p = 0; p < (*node_iter)->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = (*node_iter)->getDataRefByIndex(p);
+            if ((data_ref != NULL) && (data_ref->isDelayElement() == vx_true_e))
+                data_ref->getDelay()->releaseFrame(this, frame_cnt);
+        }
+    }
+
+    map<vx_uint32, time_pair_t*>::iterator time_iter = m_pipeline_time_pair_map.find(frame_cnt);
+    if (time_iter != m_pipeline_time_pair_map.end()) {
+        time_pair_t *time_pair = time_iter->second;
+        TIMESTAMP_END(time_pair, TIMEPAIR_PROCESS);
+        if (time_pair) {
+            traceFrame(frame_cnt, time_pair);
+            getContext()->getPerfMonitor()->releaseTimePairStr(this, frame_cnt, time_pair);
+        }
+        m_pipeline_time_pair_map.erase(time_iter);
+    }
+
+    m_pipeline_footer_cnt_map.erase(frame_cnt);
+
+    List<vx_uint32>::iterator frame_iter;
+    for (frame_iter=m_pipeline_frame_list.begin(); frame_iter!=m_pipeline_frame_list.end(); frame_iter++) {
+        if (*frame_iter == frame_cnt) {
+            m_pipeline_frame_list.erase(frame_iter);
+            break;
+        }
+    }
+}
+
+void
+ExynosVisionGraph::traceFrame(vx_uint32 frame_cnt, time_pair_t *time_pair)
+{
+    ExynosVisionTraceRecorder *trace_recorder = getContext()->getTraceRecorder();
+
+    if (trace_recorder->isEnabled() == vx_true_e) {
+        trace_recorder->record(TRACE_EVENT_GRAPH_FRAME, getTraceId(), frame_cnt,
+                                        time_pair[TIMEPAIR_PROCESS].start, time_pair[TIMEPAIR_PROCESS].end);
+    }
+}
+
+vx_uint32
+ExynosVisionGraph::getTraceId(void)
+{
+    return getContext()->getTraceRecorder()->getObjectId(&m_trace_id, TRACE_OBJECT_GRAPH, getName(), 0);
+}
+
+void
+ExynosVisionGraph::completePipelineFrame(vx_uint32 frame_cnt, vx_bool data_valid)
+{
+    Mutex::Autolock lock(m_pipeline_mutex);
+
+    map<vx_uint32, vx_uint32>::iterator cnt_iter = m_pipeline_footer_cnt_map.find(frame_cnt);
+    if (cnt_iter == m_pipeline_footer_cnt_map.end()) {
+        VXLOGE("%s, frame_%d is already given up", getName(), frame_cnt);
+        return;
+    }
+
+    /* a bad frame doesn't stop the pipeline, it's reported at waiting */
+    if (data_valid != vx_true_e)
+        m_error_status = VX_FAILURE;
+
+    cnt_iter->second++;
+    if (cnt_iter->second < m_sg_footer_list.size())
+        return;
+
+    VXLOGD2("%s, frame_%d is completed", getName(), frame_cnt);
+    releasePipelineFrame(frame_cnt);
+
+    if (m_pipeline_frame_list.empty())
+        m_graph_state.setState(GRAPH_STATE_VERIFIED);
+
+    m_pipeline_condition.broadcast();
+}
+
 vx_status
 ExynosVisionGraph::stopProcessGraph(void)
 {
@@ -950,6 +1291,11 @@ vx_status
 ExynosVisionGraph::scheduleGraph(void)
 {
     vx_status status;
+
+    /* a frame is issued to the header directly, it waits only when the pipeline is full */
+    if (getExecMode() == GRAPH_EXEC_PIPELINE)
+        return issuePipelineFrame();
+
     m_schedule_complete_event->clearEvent();
     status = pushScheduleEvent();
     if (status != VX_SUCCESS) {
@@ -966,6 +1312,9 @@ ExynosVisionGraph::waitGraph(void)
 
     event_exception_t exception_state;
 
+    if (getExecMode() == GRAPH_EXEC_PIPELINE)
+        return waitPipelineFrames();
+
     VXLOGD2("Start waiting %s complete", getName());
     exception_state = m_schedule_complete_event->waitEvent();
     VXLOGD2("End waiting %s complete, exception:%d", getName(), exception_state);
@@ -1014,6 +1363,18 @@ ExynosVisionGraph::queryGraph(vx_enum attribute, void *ptr, vx_size size)
             status = VX_ERROR_INVALID_PARAMETERS;
         }
         break;
+    case VX_GRAPH_ATTRIBUTE_NODE_FUSION:
+        if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3))
+            *(vx_bool *)ptr = m_node_fusion;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+            *(vx_uint32 *)ptr = m_pipeline_depth;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
     default:
         status = VX_ERROR_NOT_SUPPORTED;
         break;
@@ -1025,9 +1386,46 @@ ExynosVisionGraph::queryGraph(vx_enum attribute, void *ptr, vx_size size)
 vx_status
 ExynosVisionGraph::setGraphAttribute(vx_enum attribute, const void *ptr, vx_size size)
 {
-    vx_status status = VX_ERROR_NOT_SUPPORTED;
+    vx_status status = VX_SUCCESS;
 
-    VXLOGE("there are no settable attributes, attribute:0x%x, ptr:%p, size:%d", attribute, ptr, size);
+    switch (attribute) {
+    case VX_GRAPH_ATTRIBUTE_NODE_FUSION:
+        if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3)) {
+            if (m_verified == vx_true_e) {
+                VXLOGE("%s, node fusion can't be changed after verification", getName());
+                status = VX_ERROR_NOT_SUPPORTED;
+            } else {
+                m_node_fusion = *(vx_bool *)ptr;
+            }
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        break;
+    case VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3)) {
+            vx_uint32 depth = *(vx_uint32 *)ptr;
+            if (m_verified == vx_true_e) {
+                VXLOGE("%s, pipeline depth can't be changed after verification", getName());
+                status = VX_ERROR_NOT_SUPPORTED;
+            } else if (getExecMode() == GRAPH_EXEC_STREAM) {
+                VXLOGE("%s, stream graph can't be pipelined", getName());
+                status = VX_ERROR_NOT_SUPPORTED;
+            } else if ((depth == 0) || (depth > MAX_PIPELINE_DEPTH)) {
+                VXLOGE("%s, pipeline depth(%d) is out of range", getName(), depth);
+                status = VX_ERROR_INVALID_VALUE;
+            } else {
+                m_pipeline_depth = depth;
+                setExecMode((depth > 1) ? GRAPH_EXEC_PIPELINE : GRAPH_EXEC_NORMAL);
+            }
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        break;
+    default:
+        VXLOGE("not settable attribute, attribute:0x%x, ptr:%p, size:%d", attribute, ptr, size);
+        status = VX_ERROR_NOT_SUPPORTED;
+        break;
+    }
 
     return status;
 }
@@ -1118,6 +1516,15 @@ ExynosVisionGraph::errorThreadFunc(void)
             VXLOGE("pop error event, %s, error:%d", error_message.subgraph->getSgName(), error_message.error);
             m_error_status |= error_message.error;
             stopGraph();
+
+            /* frames in flight can't be completed, waiters get the error */
+            if (getExecMode() == GRAPH_EXEC_PIPELINE) {
+                Mutex::Autolock lock(m_pipeline_mutex);
+                while (!m_pipeline_frame_list.empty())
+                    releasePipelineFrame(*m_pipeline_frame_list.begin());
+                m_graph_state.setState(GRAPH_STATE_VERIFIED);
+                m_pipeline_condition.broadcast();
+            }
         } else {
             VXLOGE("error report is corrupted");
         }
@@ -41,7 +41,8 @@ enum graph_state {
 
 typedef enum _graph_exec_mode_t {
     GRAPH_EXEC_NORMAL,
-    GRAPH_EXEC_STREAM
+    GRAPH_EXEC_STREAM,
+    GRAPH_EXEC_PIPELINE
 } graph_exec_mode_t;
 
 typedef struct _graph_error_message_t {
@@ -59,6 +60,7 @@ struct graph_param_info {
 };
 
 #define COMPLETE_WAIT_TIME ((vx_uint64)5 * 1000 * 1000 * 1000)     // 5 sec
+#define MAX_PIPELINE_DEPTH 16
 
 class ExynosVisionGraph : public ExynosVisionReference {
 
@@ -110,6 +112,20 @@ private:
     /* This indicates that whether child graph is merged or not */
     vx_bool m_is_replaced_flag;
 
+    /* This indicates that whether adjacent nodes of the same target share a subgraph */
+    vx_bool m_node_fusion;
+
+    /* pipeline mode : frames in flight are at most m_pipeline_depth, in issue order */
+    vx_uint32 m_pipeline_depth;
+    Mutex m_pipeline_mutex;
+    Condition m_pipeline_condition;
+    List<vx_uint32> m_pipeline_frame_list;
+    map<vx_uint32, vx_uint32> m_pipeline_footer_cnt_map;
+    map<vx_uint32, time_pair_t*> m_pipeline_time_pair_map;
+
+    /* id in the trace recorder of the context, given at the first record */
+    std::atomic<vx_uint32> m_trace_id;
+
     uint64_t m_verify_time;
 
 public:
@@ -127,12 +143,20 @@ private:
     /* 1. check data reference if multiple writer is exist, 2. find header/footer data reference */
     vx_status checkDataReference(void);
     vx_status initializeKernel(void);
+    vx_bool isFusibleDataRef(ExynosVisionDataReference *data_ref, ExynosVisionNode *consumer_node);
+    ExynosVisionSubgraph* findFusibleSubgraph(ExynosVisionNode *node);
     vx_status groupingSubgraph(void);
     vx_status fixAllSubgraph(void);
     vx_status checkExecutionModePropriety(void);
 
     vx_status stopProcessGraph(void);
 
+    vx_status synchronizeDelayParams(void);
+    vx_status issuePipelineFrame(void);
+    vx_status waitPipelineFrames(void);
+    void releasePipelineFrame(vx_uint32 frame_cnt);
+    void traceFrame(vx_uint32 frame_cnt, time_pair_t *time_pair);
+
 public:
     /* Constructor */
     ExynosVisionGraph(ExynosVisionContext *context);
@@ -192,6 +216,7 @@ public:
 
     vx_status stopGraph();
     vx_status pushErrorEvent(ExynosVisionSubgraph *subgraph, vx_status error);
+    void completePipelineFrame(vx_uint32 frame_cnt, vx_bool data_valid);
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
     virtual void displayPerf(vx_uint32 tab_num, vx_bool detail_info);
@@ -210,8 +235,13 @@ public:
     {
         return m_exec_mode;
     }
+    vx_uint32 getPipelineDepth(void)
+    {
+        return m_pipeline_depth;
+    }
 
     vx_uint32 requestNewFrameCnt(ExynosVisionReference *ref);
+    vx_uint32 getTraceId(void);
 
     void invalidateGraph(void)
     {
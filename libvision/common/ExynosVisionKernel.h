@@ -124,6 +124,23 @@ public:
 
         return function_first_char;
     }
+    /* the target name is the kernel name without the function name */
+    vx_bool isSameTarget(const ExynosVisionKernel *kernel) const
+    {
+        const vx_char *last_char = strrchr(m_kernel_name, '.');
+        const vx_char *other_last_char = strrchr(kernel->m_kernel_name, '.');
+
+        if ((last_char == NULL) || (other_last_char == NULL))
+            return vx_false_e;
+
+        if ((last_char - m_kernel_name) != (other_last_char - kernel->m_kernel_name))
+            return vx_false_e;
+
+        if (strncmp(m_kernel_name, kernel->m_kernel_name, last_char - m_kernel_name) != 0)
+            return vx_false_e;
+
+        return vx_true_e;
+    }
     vx_uint32 getNumParams(void) const
     {
         return m_signature.num_parameters;
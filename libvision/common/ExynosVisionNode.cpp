@@ -41,6 +41,7 @@ ExynosVisionNode::ExynosVisionNode(ExynosVisionContext *context, ExynosVisionGra
 
     m_cur_frame_cnt = 0;
     m_time_pair = NULL;
+    m_trace_id = 0;
 
     /* JUN_TBD, this will be changed to vx_true_e after vpu is stable */
     m_share_resource = vx_false_e;
@@ -415,6 +416,8 @@ ExynosVisionNode::nodeSetParameter(vx_uint32 index, ExynosVisionDataReference *d
     }
 
     ExynosVisionDataReference *old_data_ref = getDataRefByIndex(index);
+    /* the subgraph looks the old reference up by address after it's released */
+    ExynosVisionDataReference *replaced_data_ref = old_data_ref;
 
     if (old_data_ref) {
         VXLOGD2("release already assigned %s", old_data_ref->getName());
@@ -459,7 +462,7 @@ ExynosVisionNode::nodeSetParameter(vx_uint32 index, ExynosVisionDataReference *d
     }
 
     if (m_subgraph) {
-        if (m_subgraph->replaceDataRef(old_data_ref, data_ref, index, m_kernel->getParamDirection(index)) != VX_SUCCESS)
+        if (m_subgraph->replaceDataRef(replaced_data_ref, data_ref, this, index, m_kernel->getParamDirection(index)) != VX_SUCCESS)
             VXLOGE("%s cannot replace old reference", m_subgraph->getSgName());
     }
 
@@ -985,10 +988,42 @@ ExynosVisionNode::informKernelEnd(vx_uint32 frame_cnt, vx_status status)
 
     TIMESTAMP_END(m_time_pair, TIMEPAIR_FRAMEWORK);
 
+    if (getContext()->getTraceRecorder()->isEnabled() == vx_true_e)
+        traceTimePair(frame_cnt);
+
     m_parent_graph->getPerfMonitor()->releaseTimePairStr(this, frame_cnt, m_time_pair);
     m_time_pair = NULL;
 }
 
+void
+ExynosVisionNode::traceTimePair(vx_uint32 frame_cnt)
+{
+    ExynosVisionTraceRecorder *trace_recorder = getContext()->getTraceRecorder();
+    time_pair_t *framework = &m_time_pair[TIMEPAIR_FRAMEWORK];
+    vx_uint32 trace_id = getTraceId();
+
+    trace_recorder->record(TRACE_EVENT_NODE_FRAMEWORK, trace_id, frame_cnt, framework->start, framework->end);
+
+    /* only some kernels stamp these pairs, a pair older than this frame is left from a previous frame */
+    if ((m_time_pair[TIMEPAIR_KERNEL].start >= framework->start) && (m_time_pair[TIMEPAIR_KERNEL].end > m_time_pair[TIMEPAIR_KERNEL].start))
+        trace_recorder->record(TRACE_EVENT_NODE_KERNEL, trace_id, frame_cnt, m_time_pair[TIMEPAIR_KERNEL].start, m_time_pair[TIMEPAIR_KERNEL].end);
+    if ((m_time_pair[TIMEPAIR_FIRMWARE].start >= framework->start) && (m_time_pair[TIMEPAIR_FIRMWARE].end > m_time_pair[TIMEPAIR_FIRMWARE].start))
+        trace_recorder->record(TRACE_EVENT_NODE_FIRMWARE, trace_id, frame_cnt, m_time_pair[TIMEPAIR_FIRMWARE].start, m_time_pair[TIMEPAIR_FIRMWARE].end);
+}
+
+vx_uint32
+ExynosVisionNode::getTraceId(void)
+{
+    vx_uint32 trace_id = m_trace_id.load(std::memory_order_acquire);
+    if (trace_id)
+        return trace_id;
+
+    vx_char name[TRACE_OBJECT_NAME_SIZE];
+    snprintf(name, sizeof(name), "%s(%s)", getName(), getKernelName());
+
+    return getContext()->getTraceRecorder()->getObjectId(&m_trace_id, TRACE_OBJECT_NODE, name, m_subgraph ? m_subgraph->getTraceId() : 0);
+}
+
 void
 ExynosVisionNode::displayInfo(vx_uint32 tab_num, vx_bool detail_info)
 {
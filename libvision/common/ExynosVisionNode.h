@@ -50,6 +50,9 @@ private:
     /* request and release time stamp structure during run-time */
     time_pair_t *m_time_pair;
 
+    /* id in the trace recorder of the context, given at the first record */
+    std::atomic<vx_uint32> m_trace_id;
+
     vx_bool m_share_resource;
 
     vx_uint32 m_pre_node_num;
@@ -66,6 +69,7 @@ private:
     vx_status setDataReferenceByIndex(vx_uint32 index, ExynosVisionDataReference *data_ref);
     vx_int32 getSubIndexFromIndex(vx_enum dir, vx_int32 index);
     vx_int32 getIndexFromSubIndex(vx_enum dir, vx_int32 sub_index);
+    void traceTimePair(vx_uint32 frame_cnt);
 
 public:
     /* Constructor */
@@ -144,6 +148,7 @@ public:
 
     void informKernelStart(vx_uint32 frame_cnt);
     void informKernelEnd(vx_uint32 frame_cnt, vx_status status);
+    vx_uint32 getTraceId(void);
 
     vx_uint32 getCurFrameCnt(void)
     {
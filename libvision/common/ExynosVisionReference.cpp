@@ -799,6 +799,28 @@ ExynosVisionDataReference::getDirectOutputNode(ExynosVisionGraph *graph, vx_uint
     return node;
 }
 
+ExynosVisionNode*
+ExynosVisionDataReference::getDirectInputNode(ExynosVisionGraph *graph, vx_uint32 node_idx)
+{
+    EXYNOS_VISION_REF_IN();
+    Mutex::Autolock lock(m_internal_lock);
+
+    List<node_connect_info_t> *node_list = &m_input_node_list[graph];
+
+    if (node_list->size() < (node_idx+1)) {
+        VXLOGE("out of bound node index:%d", node_idx);
+        return NULL;
+    }
+
+    List<node_connect_info_t>::iterator iter_pos = node_list->begin();
+    for (vx_uint32 i = 0; i<node_idx; i++, iter_pos++);
+
+    ExynosVisionNode *node = (*iter_pos).node;
+    EXYNOS_VISION_REF_OUT();
+
+    return node;
+}
+
 ExynosVisionNode*
 ExynosVisionDataReference::getIndirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx)
 {
@@ -845,6 +867,10 @@ ExynosVisionDataReference::allocateMemory(void)
         if (((ExynosVisionGraph*)scope)->getExecMode() == GRAPH_EXEC_STREAM) {
             res_type = RESOURCE_MNGR_SLOT;
             res_param.param.slot_param.slot_num = DEFAULT_SLOT_NUM;
+        } else if (((ExynosVisionGraph*)scope)->getExecMode() == GRAPH_EXEC_PIPELINE) {
+            /* every frame in flight could hold its own buffer */
+            res_type = RESOURCE_MNGR_SLOT;
+            res_param.param.slot_param.slot_num = ((ExynosVisionGraph*)scope)->getPipelineDepth();
         } else {
             res_type = RESOURCE_MNGR_SOLID;
         }
@@ -906,7 +932,7 @@ ExynosVisionDataReference::triggerDoneEventDirect(ExynosVisionGraph *graph, vx_u
             status = VX_FAILURE;
             break;
         } else {
-            subgraph->pushDoneEvent(frame_cnt, this, (*node_iter).node_index);
+            subgraph->pushDoneEvent(frame_cnt, this, (*node_iter).node, (*node_iter).node_index);
         }
     }
 
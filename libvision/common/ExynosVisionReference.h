@@ -263,6 +263,7 @@ public:
     vx_uint32 getIndirectInputNodeNum(ExynosVisionGraph *graph);
     vx_uint32 getIndirectOutputNodeNum(ExynosVisionGraph *graph);
 
+    ExynosVisionNode* getDirectInputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getDirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getIndirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
 
@@ -270,6 +271,10 @@ public:
     {
         return m_is_virtual;
     }
+    vx_uint32 getAllianceNum(void)
+    {
+        return m_alliance_ref_list.size();
+    }
     vx_bool isAllocated(void)
     {
         return m_is_allocated;
@@ -38,6 +38,12 @@ VX_API_ENTRY vx_size VX_API_CALL vxSizeOfType(vx_enum type);
  =============================================================================*/
 VX_API_ENTRY vx_context VX_API_CALL vxCreateContextLite(void);
 VX_API_ENTRY vx_status VX_API_CALL vxSetImmediateModeTarget(vx_context context, vx_enum target_enum, const vx_char *target_string);
+/*! \brief Writes the timing records of the context to a file.
+ * \param [in] context The context whose <tt>\ref VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE</tt> is set.
+ * \param [in] format <tt>\ref VX_TRACE_FORMAT_CHROME_JSON</tt> or <tt>\ref VX_TRACE_FORMAT_BINARY</tt>.
+ * \param [in] path The file to write.
+ */
+VX_API_ENTRY vx_status VX_API_CALL vxExportContextTrace(vx_context context, vx_enum format, const vx_char *path);
 
 /*==============================================================================
  IMAGE
@@ -17,6 +17,21 @@
 #ifndef _OPENVX_TYPES_EXT_H_
 #define _OPENVX_TYPES_EXT_H_
 
+enum vx_context_attribute_ext_e {
+    /*! \brief Queries or sets the maximum number of verified graphs that immediate mode keeps for reuse.
+     * Zero disables the cache. Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_CONTEXT) + 0x0,
+    /*! \brief Queries or sets whether graphs, subgraphs and nodes record their timings for <tt>\ref vxExportContextTrace</tt>.
+     * Use a <tt>\ref vx_bool</tt> parameter.
+     */
+    VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_CONTEXT) + 0x1,
+    /*! \brief Queries or sets how many timing records are kept, the oldest ones are overwritten.
+     * It can be set only before tracing is enabled at first. Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_CONTEXT) + 0x2,
+};
+
 enum vx_node_attribute_ext_e {
     /*! \brief Queries the current processing frame number
      * Use a vx_uint32 parameter.
@@ -32,6 +47,19 @@ enum vx_node_attribute_ext_e {
     VX_NODE_ATTRIBUTE_SHARE_RESOURCE =  VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_NODE) + 0x4,
 };
 
+enum vx_graph_attribute_ext_e {
+    /*! \brief Queries or sets whether adjacent nodes of the same target are fused into one subgraph.
+     * It can be set only before the graph is verified. Use a <tt>\ref vx_bool</tt> parameter.
+     */
+    VX_GRAPH_ATTRIBUTE_NODE_FUSION = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x0,
+    /*! \brief Queries or sets how many frames a graph may have in flight. A depth greater than 1
+     * makes <tt>\ref vxScheduleGraph</tt> return once the frame is issued, and each <tt>\ref vxAgeDelay</tt>
+     * applies to the frames issued after it. It can be set only before the graph is verified.
+     * Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x1,
+};
+
 enum vx_target_ext_e {
     VX_TARGET_VPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x0,
     VX_TARGET_CPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x1,
@@ -76,6 +104,18 @@ enum vx_directive_ext_e {
     VX_DIRECTIVE_IMAGE_CONTINUOUS = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_DIRECTIVE) + 0x0,
 };
 
+enum vx_enum_ext_e {
+    VX_ENUM_TRACE_FORMAT = 0x14, /*!< \brief Trace export formats. */
+};
+
+/*! \brief The file formats of <tt>\ref vxExportContextTrace</tt>. */
+enum vx_trace_format_ext_e {
+    /*! \brief Chrome trace-event JSON, it can be opened by chrome://tracing and Perfetto. */
+    VX_TRACE_FORMAT_CHROME_JSON = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TRACE_FORMAT) + 0x0,
+    /*! \brief The compact binary dump read by vision_trace_summary. */
+    VX_TRACE_FORMAT_BINARY = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TRACE_FORMAT) + 0x1,
+};
+
 /*! \brief An enumeration of memory import types.
  * \ingroup group_context
  */
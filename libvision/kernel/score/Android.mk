@@ -40,6 +40,8 @@ LOCAL_SRC_FILES:= \
 	./core/score_command.cpp \
 	./core/score_core.cpp \
 	./core/score_device_real.cpp \
+	./core/score_device_emulator.cpp \
+	./core/score_emulator_kernel.cpp \
 	./core/score_send_packet.cpp \
 	./memory/score_ion_memory_manager.cpp \
 	./memory/score_memory.cpp \
@@ -65,6 +67,11 @@ LOCAL_SRC_FILES:= \
 	./score_kernel_convolution.cpp \
 	./ExynosScoreKernelConvolution.cpp \
 
+# Run the SCore kernels on CPU threads instead of the SCore device
+ifeq ($(BOARD_USE_SCORE_EMULATOR), true)
+LOCAL_CFLAGS += -DEMULATOR
+endif
+
 $(foreach file,$(LOCAL_SRC_FILES),$(shell touch '$(LOCAL_PATH)/$(file)'))
 
 LOCAL_MODULE_TAGS := optional
@@ -23,19 +23,28 @@
 #include "score_core.h"
 #include "score_command.h"
 #include "score_device.h"
+#ifdef EMULATOR
+#include "score_device_emulator.h"
+#else
 #include "score_device_real.h"
+#endif
 
 namespace score {
 
 ScoreCore::ScoreCore()
     : device_(NULL) {
+#ifdef EMULATOR
+  device_ = new ScoreDeviceEmulator();
+#else
   device_ = new ScoreDeviceReal();
+#endif
   device_->OpenDevice();
 }
 
 ScoreCore::~ScoreCore() {
   if (device_ != NULL) {
     device_->CloseDevice();
+    delete device_;
   }
 }
 
@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+/// @file  score_device_emulator.cc
+/// @ingroup  core
+///
+/// @brief  Implementations of ScoreDeviceEmulator class
+///
+/// @section copyright_section Copyright
+/// &copy; 2016, Samsung Electronics Co., Ltd.
+///
+/// @section license_section License
+//------------------------------------------------------------------------------
+
+#include <time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "score_device_emulator.h"
+#include "score_emulator_kernel.h"
+#include "score_command.h"
+#include "logging.h"
+
+namespace score {
+
+/// @brief  A packet waiting for a worker
+typedef struct _ScoreEmulatorJob {
+  std::vector<BYTE> packet;  ///< Copy of the packet
+  sc_status_t status;        ///< Result of the kernel
+  bool done;                 ///< Whether a worker finished the packet
+} ScoreEmulatorJob;
+
+/// @brief  Worker threads shared by every ScoreDeviceEmulator
+class ScoreEmulatorEngine {
+ public:
+  static ScoreEmulatorEngine *Instance() {
+    static ScoreEmulatorEngine instance;
+    return &instance;
+  }
+
+  ~ScoreEmulatorEngine() {
+    std::lock_guard<std::mutex> config_lock(config_lock_);
+    StopWorkers();
+  }
+
+  /// @brief  Start the workers if they are not running
+  void Start() {
+    std::lock_guard<std::mutex> config_lock(config_lock_);
+    if (workers_.empty())
+      StartWorkers();
+  }
+
+  /// @brief  Queue a packet and wait until a worker runs it
+  sc_status_t Run(const ScoreIpcPacket *packet) {
+    size_t packet_size = sizeof(ScoreIpcPacket) +
+                         sizeof(ScorePacketGroup) * packet->size.group_count;
+    const BYTE *packet_data = reinterpret_cast<const BYTE *>(packet);
+
+    ScoreEmulatorJob job;
+    job.packet.assign(packet_data, packet_data + packet_size);
+    job.status = STS_FAILURE;
+    job.done = false;
+
+    std::unique_lock<std::mutex> lock(lock_);
+    queue_.push_back(&job);
+    queue_cond_.notify_one();
+    done_cond_.wait(lock, [&job] { return job.done; });
+
+    return job.status;
+  }
+
+  int SetWorkerNum(unsigned int worker_num) {
+    if (worker_num == 0)
+      return -1;
+
+    std::lock_guard<std::mutex> config_lock(config_lock_);
+    bool running = !workers_.empty();
+    if (running)
+      StopWorkers();
+    worker_num_ = worker_num;
+    if (running)
+      StartWorkers();
+
+    return 0;
+  }
+
+  unsigned int GetWorkerNum() {
+    std::lock_guard<std::mutex> config_lock(config_lock_);
+    return worker_num_;
+  }
+
+  std::atomic<unsigned int> latency_us_;
+  std::atomic<unsigned long> packet_count_;
+
+ private:
+  ScoreEmulatorEngine()
+      : latency_us_(0), packet_count_(0),
+        worker_num_(SCORE_EMULATOR_DEFAULT_WORKER_NUM), stop_(false) {}
+
+  /// @brief  Called with config_lock_
+  void StartWorkers() {
+    stop_ = false;
+    for (unsigned int i = 0; i < worker_num_; i++)
+      workers_.push_back(std::thread(&ScoreEmulatorEngine::WorkerLoop, this));
+  }
+
+  /// @brief  Called with config_lock_, the queued packets are run first
+  void StopWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+      queue_cond_.notify_all();
+    }
+    for (size_t i = 0; i < workers_.size(); i++)
+      workers_[i].join();
+    workers_.clear();
+  }
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(lock_);
+
+    while (true) {
+      queue_cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty())
+        break;
+
+      ScoreEmulatorJob *job = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+
+      sc_status_t status = Execute(
+          reinterpret_cast<const ScoreIpcPacket *>(&job->packet[0]));
+      packet_count_++;
+
+      lock.lock();
+      job->status = status;
+      job->done = true;
+      done_cond_.notify_all();
+    }
+  }
+
+  sc_status_t Execute(const ScoreIpcPacket *packet) {
+    unsigned int latency_us = latency_us_;
+    if (latency_us) {
+      struct timespec delay;
+      delay.tv_sec = latency_us / 1000000;
+      delay.tv_nsec = (latency_us % 1000000) * 1000;
+      nanosleep(&delay, NULL);
+    }
+
+    ScoreEmulatorKernel kernel = GetScoreEmulatorKernel(packet->header.kernel_name);
+    if (kernel == NULL) {
+      sc_error("kernel %d is not supported by the emulator\n",
+               packet->header.kernel_name);
+      return STS_FAILURE;
+    }
+
+    ScoreEmulatorParams params(packet);
+    sc_status_t status = kernel(params);
+    if (status != STS_SUCCESS)
+      sc_error("kernel %d fails: %d\n", packet->header.kernel_name, status);
+
+    return status;
+  }
+
+  /// @brief  Serializes starting and stopping the workers
+  std::mutex config_lock_;
+  /// @brief  Protects queue_, stop_ and the jobs
+  std::mutex lock_;
+  std::condition_variable queue_cond_;
+  std::condition_variable done_cond_;
+  std::deque<ScoreEmulatorJob *> queue_;
+  std::vector<std::thread> workers_;
+  unsigned int worker_num_;
+  bool stop_;
+};
+
+ScoreDeviceEmulator::ScoreDeviceEmulator() : opened_(false) {}
+
+ScoreDeviceEmulator::~ScoreDeviceEmulator() {}
+
+int ScoreDeviceEmulator::OpenDevice() {
+  ScoreEmulatorEngine::Instance()->Start();
+  opened_ = true;
+
+  return 0;
+}
+
+void ScoreDeviceEmulator::CloseDevice() {
+  opened_ = false;
+}
+
+int ScoreDeviceEmulator::Write(void *buf, size_t size) {
+  if (!opened_) {
+    return -1;
+  }
+  return size;
+}
+
+int ScoreDeviceEmulator::Read(void *buf, size_t size) {
+  if (!opened_) {
+    return -1;
+  }
+  return size;
+}
+
+int ScoreDeviceEmulator::SendPacket(const ScoreIpcPacket *const packet) {
+  if (!opened_ || packet == NULL) {
+    return -1;
+  }
+
+  if (ScoreEmulatorEngine::Instance()->Run(packet) != STS_SUCCESS)
+    return -1;
+
+  return 0;
+}
+
+void ScoreDeviceEmulator::SetLatency(unsigned int latency_us) {
+  ScoreEmulatorEngine::Instance()->latency_us_ = latency_us;
+}
+
+unsigned int ScoreDeviceEmulator::GetLatency(void) {
+  return ScoreEmulatorEngine::Instance()->latency_us_;
+}
+
+int ScoreDeviceEmulator::SetWorkerNum(unsigned int worker_num) {
+  return ScoreEmulatorEngine::Instance()->SetWorkerNum(worker_num);
+}
+
+unsigned int ScoreDeviceEmulator::GetWorkerNum(void) {
+  return ScoreEmulatorEngine::Instance()->GetWorkerNum();
+}
+
+unsigned long ScoreDeviceEmulator::GetPacketCount(void) {
+  return ScoreEmulatorEngine::Instance()->packet_count_;
+}
+
+} //namespace score
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/// @file  score_device_emulator.h
+/// @ingroup  core
+///
+/// @brief  Declarations of ScoreDeviceEmulator class
+///
+/// ScoreDeviceEmulator runs SCore kernels on CPU threads of the host instead
+/// of sending packets to the SCore device driver. It is built in place of
+/// ScoreDeviceReal when EMULATOR is defined.
+///
+/// @section copyright_section Copyright
+/// &copy; 2016, Samsung Electronics Co., Ltd.
+///
+/// @section license_section License
+//------------------------------------------------------------------------------
+
+#ifndef COMMON_SCORE_DEVICE_EMULATOR_H_
+#define COMMON_SCORE_DEVICE_EMULATOR_H_
+
+#include <stddef.h>
+
+#include "score_device.h"
+
+namespace score {
+
+/// @brief  Default number of the emulator threads, SCore has a single core
+#define SCORE_EMULATOR_DEFAULT_WORKER_NUM  (1)
+
+/// @brief  Class for an in-process SCore device
+///
+/// ScoreCore is created on every DoOnScore(), so the worker threads and the
+/// settings are shared by all instances. A packet is copied like the device
+/// driver does, queued to the workers and waited for. A worker sleeps for the
+/// configured latency before it decodes the packet and runs the kernel.
+class ScoreDeviceEmulator : public ScoreDevice {
+ public:
+  /// @brief  Constructor of ScoreDeviceEmulator class
+  explicit ScoreDeviceEmulator();
+  /// @brief  Destructor of ScoreDeviceEmulator class
+  ///
+  /// This is empty. The worker threads live until the process exits.
+  virtual ~ScoreDeviceEmulator();
+
+  /// @{
+  /// Interface for accessing SCore device. Please refer to class ScoreDevice.
+  int OpenDevice();
+  void CloseDevice();
+  int Write(void *buf, size_t size);
+  int Read(void *buf, size_t size);
+  int SendPacket(const ScoreIpcPacket *const packet);
+  /// @}
+
+  /// @brief  Set the artificial latency of every packet
+  /// @param  latency_us  Time in microseconds a worker waits before the kernel
+  static void SetLatency(unsigned int latency_us);
+  /// @brief  Get the artificial latency of every packet in microseconds
+  static unsigned int GetLatency(void);
+
+  /// @brief  Set the number of worker threads
+  /// @param  worker_num  Number of packets that can run at the same time
+  /// @retval 0 if function succeeds, otherwise error
+  ///
+  /// The running workers finish the queued packets before they are replaced.
+  static int SetWorkerNum(unsigned int worker_num);
+  /// @brief  Get the number of worker threads
+  static unsigned int GetWorkerNum(void);
+
+  /// @brief  Get the number of packets the emulator has processed
+  static unsigned long GetPacketCount(void);
+
+ private:
+  /// @brief  Whether OpenDevice() succeeded
+  bool opened_;
+};
+
+} //namespace score
+#endif
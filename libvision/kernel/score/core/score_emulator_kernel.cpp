@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------
+/// @file  score_emulator_kernel.cc
+/// @ingroup  core
+///
+/// @brief  Implementations of the reference kernels of ScoreDeviceEmulator
+///
+/// The kernels follow the OpenVX definition of the functions. Images are
+/// dense, the stride of a row is its width.
+///
+/// @section copyright_section Copyright
+/// &copy; 2016, Samsung Electronics Co., Ltd.
+///
+/// @section license_section License
+//------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <math.h>
+#include <sys/mman.h>
+
+#include "score_emulator_kernel.h"
+#include "memory/score_ion_memory_manager.h"
+#include "logging.h"
+#include "vs4l.h"
+
+namespace score {
+
+ScoreEmulatorParams::ScoreEmulatorParams(const ScoreIpcPacket *packet)
+    : pos_(0) {
+  for (unsigned int i = 0; i < packet->size.group_count; i++) {
+    const ScorePacketGroup *group = &packet->group[i];
+    words_.insert(words_.end(), group->data.params,
+                  group->data.params + group->header.valid_size);
+  }
+}
+
+/// @brief  Host mapping of the memory of ScBuffer
+///
+/// Buffers allocated by CreateScBuffer are already mapped by
+/// ScoreIonMemoryManager. The other dma-buf fds, like the ones of vx objects,
+/// are mapped while the kernel runs.
+class ScoreEmulatorBuffer {
+ public:
+  ScoreEmulatorBuffer() : addr_(NULL), size_(0), mapped_(false) {
+    memset(&buffer_, 0x0, sizeof(buffer_));
+  }
+
+  ~ScoreEmulatorBuffer() {
+    if (mapped_)
+      munmap(addr_, size_);
+  }
+
+  /// @brief  Read ScBuffer from the packet and map its memory
+  /// @retval true if the memory is accessible, otherwise false
+  bool Map(ScoreEmulatorParams &params) {
+    if (!params.Get(&buffer_))
+      return false;
+
+    data_buf_type type = buffer_.buf.type;
+    size_ = ((size_t)buffer_.buf.width * buffer_.buf.height *
+             (SUM_OF_PLANE(type)) + 7) / 8;
+    if (size_ == 0)
+      return false;
+
+    if (buffer_.host_buf.memory_type == VS4L_MEMORY_DMABUF) {
+      unsigned long addr = ScoreIonMemoryManager::Instance()->
+                           GetVaddrFromFd(buffer_.host_buf.fd);
+      if (addr != (unsigned long)STS_FAILURE && addr != 0) {
+        addr_ = reinterpret_cast<void *>(addr);
+      } else {
+        addr_ = mmap(NULL, size_, PROT_READ|PROT_WRITE, MAP_SHARED,
+                     buffer_.host_buf.fd, 0);
+        if (addr_ == MAP_FAILED) {
+          sc_error("mapping fd %d fails\n", buffer_.host_buf.fd);
+          addr_ = NULL;
+          return false;
+        }
+        mapped_ = true;
+      }
+    } else if (buffer_.host_buf.memory_type == VS4L_MEMORY_USERPTR) {
+      unsigned long addr = buffer_.host_buf.addr64 ?
+                           (unsigned long)buffer_.host_buf.addr64 :
+                           (unsigned long)buffer_.host_buf.addr32;
+      addr_ = reinterpret_cast<void *>(addr);
+    }
+
+    return addr_ != NULL;
+  }
+
+  template<typename T> T *Data() {
+    return reinterpret_cast<T *>(addr_);
+  }
+
+  sc_u32 Width() { return buffer_.buf.width; }
+  sc_u32 Height() { return buffer_.buf.height; }
+  sc_u32 Type() { return buffer_.buf.type.sc_type; }
+
+ private:
+  ScBuffer buffer_;
+  void *addr_;
+  size_t size_;
+  bool mapped_;
+};
+
+static bool IsSameSize(ScoreEmulatorBuffer &a, ScoreEmulatorBuffer &b) {
+  return a.Width() == b.Width() && a.Height() == b.Height();
+}
+
+static sc_status_t EmulateAnd(ScoreEmulatorParams &params) {
+  ScoreEmulatorBuffer in1, in2, out;
+
+  if (!in1.Map(params) || !in2.Map(params) || !out.Map(params))
+    return STS_NULL_PTR;
+  if (!IsSameSize(in1, in2) || !IsSameSize(in1, out))
+    return STS_INVALID_VALUE;
+
+  size_t size = (size_t)in1.Width() * in1.Height();
+  const sc_u8 *src1 = in1.Data<sc_u8>();
+  const sc_u8 *src2 = in2.Data<sc_u8>();
+  sc_u8 *dst = out.Data<sc_u8>();
+  for (size_t i = 0; i < size; i++)
+    dst[i] = src1[i] & src2[i];
+
+  return STS_SUCCESS;
+}
+
+static sc_status_t EmulateHistogram(ScoreEmulatorParams &params) {
+  ScoreEmulatorBuffer in, out;
+
+  if (!in.Map(params) || !out.Map(params))
+    return STS_NULL_PTR;
+
+  // the distribution of the host has out.Width() bins over [0, 256)
+  sc_u32 bins = out.Width();
+  sc_u32 *hist = out.Data<sc_u32>();
+  memset(hist, 0x0, bins * sizeof(sc_u32));
+
+  size_t size = (size_t)in.Width() * in.Height();
+  const sc_u8 *src = in.Data<sc_u8>();
+  for (size_t i = 0; i < size; i++)
+    hist[(src[i] * bins) >> 8]++;
+
+  return STS_SUCCESS;
+}
+
+static sc_status_t EmulateTableLookup(ScoreEmulatorParams &params) {
+  ScoreEmulatorBuffer in, lut, out;
+
+  if (!in.Map(params) || !lut.Map(params) || !out.Map(params))
+    return STS_NULL_PTR;
+  if (!IsSameSize(in, out))
+    return STS_INVALID_VALUE;
+
+  size_t size = (size_t)in.Width() * in.Height();
+  sc_u32 lut_size = lut.Width();
+  const sc_u8 *src = in.Data<sc_u8>();
+  const sc_u8 *table = lut.Data<sc_u8>();
+  sc_u8 *dst = out.Data<sc_u8>();
+  for (size_t i = 0; i < size; i++)
+    dst[i] = (src[i] < lut_size) ? table[src[i]] : src[i];
+
+  return STS_SUCCESS;
+}
+
+static sc_status_t EmulateConvolution(ScoreEmulatorParams &params) {
+  ScoreEmulatorBuffer in, coef, out;
+  sc_u32 kernel_size;
+  sc_s32 norm;
+
+  if (!in.Map(params) || !coef.Map(params) || !out.Map(params))
+    return STS_NULL_PTR;
+  if (!params.Get(&kernel_size) || !params.Get(&norm))
+    return STS_INVALID_VALUE;
+  if (!IsSameSize(in, out) || (kernel_size & 1) == 0 || norm == 0)
+    return STS_INVALID_VALUE;
+
+  bool out_s16 = (out.Type() == SC_TYPE_S16.sc_type);
+  sc_s32 width = in.Width();
+  sc_s32 height = in.Height();
+  sc_s32 radius = kernel_size / 2;
+  const sc_u8 *src = in.Data<sc_u8>();
+  const sc_s16 *matrix = coef.Data<sc_s16>();
+
+  for (sc_s32 y = 0; y < height; y++) {
+    for (sc_s32 x = 0; x < width; x++) {
+      sc_s32 value = 0;
+
+      // undefined border, the pixels the kernel doesn't cover are zero
+      if (y >= radius && y < height - radius &&
+          x >= radius && x < width - radius) {
+        sc_s32 sum = 0;
+        for (sc_s32 i = -radius; i <= radius; i++) {
+          for (sc_s32 j = -radius; j <= radius; j++) {
+            sc_s32 c = (radius - i) * kernel_size + (radius - j);
+            sum += src[(y + i) * width + (x + j)] * matrix[c];
+          }
+        }
+        value = sum / norm;
+      }
+
+      if (out_s16) {
+        value = value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+        out.Data<sc_s16>()[y * width + x] = (sc_s16)value;
+      } else {
+        value = value < 0 ? 0 : (value > 255 ? 255 : value);
+        out.Data<sc_u8>()[y * width + x] = (sc_u8)value;
+      }
+    }
+  }
+
+  return STS_SUCCESS;
+}
+
+/// @brief  Offsets of the Bresenham circle of radius 3
+static const sc_s32 kFastCircle[16][2] = {
+  {0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0}, {3, 1}, {2, 2}, {1, 3},
+  {0, 3}, {-1, 3}, {-2, 2}, {-3, 1}, {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3},
+};
+
+/// @brief  Whether 9 contiguous circle pixels are all brighter or all darker
+static bool IsFastCorner(const sc_u8 *center, sc_s32 width, sc_s32 threshold) {
+  sc_s32 p = center[0];
+  sc_s32 bright = 0, dark = 0;
+
+  for (sc_s32 i = 0; i < 16 + 9; i++) {
+    const sc_s32 *offset = kFastCircle[i % 16];
+    sc_s32 v = center[offset[1] * width + offset[0]];
+
+    bright = (v > p + threshold) ? bright + 1 : 0;
+    dark = (v < p - threshold) ? dark + 1 : 0;
+    if (bright >= 9 || dark >= 9)
+      return true;
+  }
+
+  return false;
+}
+
+static sc_status_t EmulateFastCorners(ScoreEmulatorParams &params, bool nms) {
+  ScoreEmulatorBuffer in, tmp, out;
+  sc_s32 threshold;
+  sc_enum_e corner_policy, nms_policy;
+
+  if (!in.Map(params) || (nms && !tmp.Map(params)) || !out.Map(params))
+    return STS_NULL_PTR;
+  if (!params.Get(&threshold) || !params.Get(&corner_policy) ||
+      !params.Get(&nms_policy))
+    return STS_INVALID_VALUE;
+  if (!IsSameSize(in, out) || (nms && !IsSameSize(in, tmp)))
+    return STS_INVALID_VALUE;
+
+  sc_s32 width = in.Width();
+  sc_s32 height = in.Height();
+  const sc_u8 *src = in.Data<sc_u8>();
+  sc_u16 *strength = nms ? tmp.Data<sc_u16>() : out.Data<sc_u16>();
+  memset(strength, 0x0, (size_t)width * height * sizeof(sc_u16));
+
+  for (sc_s32 y = 3; y < height - 3; y++) {
+    for (sc_s32 x = 3; x < width - 3; x++) {
+      const sc_u8 *center = &src[y * width + x];
+      if (!IsFastCorner(center, width, threshold))
+        continue;
+
+      // the strength is the largest threshold it is still a corner at
+      sc_s32 low = threshold, high = 255;
+      while (low < high) {
+        sc_s32 mid = (low + high + 1) / 2;
+        if (IsFastCorner(center, width, mid))
+          low = mid;
+        else
+          high = mid - 1;
+      }
+      strength[y * width + x] = (sc_u16)(low > 0 ? low : 1);
+    }
+  }
+
+  if (!nms)
+    return STS_SUCCESS;
+
+  sc_u16 *dst = out.Data<sc_u16>();
+  memset(dst, 0x0, (size_t)width * height * sizeof(sc_u16));
+  for (sc_s32 y = 1; y < height - 1; y++) {
+    for (sc_s32 x = 1; x < width - 1; x++) {
+      sc_u16 s = strength[y * width + x];
+      bool is_max = (s != 0);
+
+      // ties are resolved toward the earlier pixel in raster order
+      for (sc_s32 i = -1; i <= 1 && is_max; i++) {
+        for (sc_s32 j = -1; j <= 1 && is_max; j++) {
+          sc_u16 n = strength[(y + i) * width + (x + j)];
+          if ((i < 0 || (i == 0 && j < 0)) ? (n >= s) : (n > s))
+            is_max = false;
+        }
+      }
+      if (is_max)
+        dst[y * width + x] = s;
+    }
+  }
+
+  return STS_SUCCESS;
+}
+
+static sc_status_t EmulateFastCornersNms(ScoreEmulatorParams &params) {
+  return EmulateFastCorners(params, true);
+}
+
+static sc_status_t EmulateFastCornersNoNms(ScoreEmulatorParams &params) {
+  return EmulateFastCorners(params, false);
+}
+
+static sc_status_t EmulateCannyEdgeDetector(ScoreEmulatorParams &params) {
+  ScoreEmulatorBuffer in, out;
+  sc_enum_e norm;
+  sc_s32 th_low, th_high;
+
+  if (!in.Map(params) || !out.Map(params))
+    return STS_NULL_PTR;
+  if (!params.Get(&norm) || !params.Get(&th_low) || !params.Get(&th_high))
+    return STS_INVALID_VALUE;
+  if (!IsSameSize(in, out))
+    return STS_INVALID_VALUE;
+  // the intermediate buffers of the packet are not needed on the host
+
+  sc_s32 width = in.Width();
+  sc_s32 height = in.Height();
+  size_t size = (size_t)width * height;
+  const sc_u8 *src = in.Data<sc_u8>();
+  sc_u8 *dst = out.Data<sc_u8>();
+
+  std::vector<sc_s32> mag(size, 0);
+  std::vector<sc_u8> dir(size, 0);
+  for (sc_s32 y = 1; y < height - 1; y++) {
+    for (sc_s32 x = 1; x < width - 1; x++) {
+      const sc_u8 *p = &src[y * width + x];
+      sc_s32 gx = (p[-width + 1] + 2 * p[1] + p[width + 1]) -
+                  (p[-width - 1] + 2 * p[-1] + p[width - 1]);
+      sc_s32 gy = (p[width - 1] + 2 * p[width] + p[width + 1]) -
+                  (p[-width - 1] + 2 * p[-width] + p[-width + 1]);
+
+      if (norm == SC_POLICY_NORM_L2)
+        mag[y * width + x] = (sc_s32)(sqrtf((float)(gx * gx + gy * gy)) + 0.5f);
+      else
+        mag[y * width + x] = abs(gx) + abs(gy);
+
+      // 0: horizontal, 1: 45, 2: vertical, 3: 135 degree
+      float angle = atan2f((float)gy, (float)gx) * 180.0f / (float)M_PI;
+      if (angle < 0)
+        angle += 180.0f;
+      dir[y * width + x] = (sc_u8)((sc_s32)((angle + 22.5f) / 45.0f) % 4);
+    }
+  }
+
+  static const sc_s32 kNeighbor[4][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}};
+  std::vector<sc_u8> edge(size, 0);
+  std::vector<sc_s32> stack;
+  for (sc_s32 y = 2; y < height - 2; y++) {
+    for (sc_s32 x = 2; x < width - 2; x++) {
+      sc_s32 idx = y * width + x;
+      sc_s32 m = mag[idx];
+      const sc_s32 *n = kNeighbor[dir[idx]];
+      sc_s32 offset = n[1] * width + n[0];
+
+      if (m <= th_low || m < mag[idx + offset] || m < mag[idx - offset])
+        continue;
+
+      if (m > th_high) {
+        edge[idx] = 2;
+        stack.push_back(idx);
+      } else {
+        edge[idx] = 1;
+      }
+    }
+  }
+
+  // hysteresis, weak edges connected to a strong one become strong
+  while (!stack.empty()) {
+    sc_s32 idx = stack.back();
+    stack.pop_back();
+
+    for (sc_s32 i = -1; i <= 1; i++) {
+      for (sc_s32 j = -1; j <= 1; j++) {
+        sc_s32 n = idx + i * width + j;
+        if (edge[n] == 1) {
+          edge[n] = 2;
+          stack.push_back(n);
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < size; i++)
+    dst[i] = (edge[i] == 2) ? 255 : 0;
+
+  return STS_SUCCESS;
+}
+
+/// @brief  Kernels the emulator implements
+static const struct {
+  sc_kernel_name_e kernel;
+  ScoreEmulatorKernel func;
+} kEmulatorKernels[] = {
+  {SCV_AND, EmulateAnd},
+  {SCV_HISTOGRAM, EmulateHistogram},
+  {SCV_TABLELOOKUP, EmulateTableLookup},
+  {SCV_CONVOLUTION, EmulateConvolution},
+  {SCV_FASTCORNERS_NMS_USE, EmulateFastCornersNms},
+  {SCV_FASTCORNERS_NMS_NO_USE, EmulateFastCornersNoNms},
+  {SCV_CANNYEDGEDETECTOR, EmulateCannyEdgeDetector},
+};
+
+ScoreEmulatorKernel GetScoreEmulatorKernel(unsigned int kernel) {
+  for (size_t i = 0; i < sizeof(kEmulatorKernels) / sizeof(kEmulatorKernels[0]); i++) {
+    if (kEmulatorKernels[i].kernel == kernel)
+      return kEmulatorKernels[i].func;
+  }
+
+  return NULL;
+}
+
+} //namespace score
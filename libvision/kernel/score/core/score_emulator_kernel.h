@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/// @file  score_emulator_kernel.h
+/// @ingroup  core
+///
+/// @brief  Declarations of the reference kernels of ScoreDeviceEmulator
+///
+/// The emulator decodes an IPC packet into its parameter words and runs a CPU
+/// implementation of the kernel named in the packet header.
+///
+/// @section copyright_section Copyright
+/// &copy; 2016, Samsung Electronics Co., Ltd.
+///
+/// @section license_section License
+//------------------------------------------------------------------------------
+
+#ifndef COMMON_SCORE_EMULATOR_KERNEL_H_
+#define COMMON_SCORE_EMULATOR_KERNEL_H_
+
+#include <string.h>
+#include <vector>
+
+#include "score_command.h"
+#include "sc_data_type.h"
+
+namespace score {
+
+/// @brief  Parameter words of a packet, read in the order they were put
+///
+/// ScoreCommand::BuildPacket never splits a parameter across groups, so the
+/// valid words of all groups concatenated are the payload in Put() order.
+class ScoreEmulatorParams {
+ public:
+  /// @brief  Constructor of ScoreEmulatorParams class
+  /// @param  packet  Packet copied from the host
+  explicit ScoreEmulatorParams(const ScoreIpcPacket *packet);
+
+  /// @brief  Read the next parameter
+  /// @param  value  Pointer to the value to be read
+  /// @retval true if the packet holds enough words, otherwise false
+  template<typename T> bool Get(T *value) {
+    size_t word_num = (sizeof(*value) + sizeof(WORD) - 1) / sizeof(WORD);
+    if (pos_ + word_num > words_.size())
+      return false;
+
+    memcpy(value, &words_[pos_], sizeof(*value));
+    pos_ += word_num;
+    return true;
+  }
+
+ private:
+  /// @brief  Valid words of all groups
+  std::vector<WORD> words_;
+  /// @brief  Index of the next word to be read
+  size_t pos_;
+};
+
+/// @brief  CPU implementation of a SCore kernel
+/// @param  params  Parameters decoded from the packet
+/// @retval STS_SUCCESS if the kernel succeeds, otherwise error
+typedef sc_status_t (*ScoreEmulatorKernel)(ScoreEmulatorParams &params);
+
+/// @brief  Find the reference implementation of a kernel
+/// @param  kernel  kernel_name of the packet header
+/// @retval Kernel function, or NULL if the emulator doesn't support it
+ScoreEmulatorKernel GetScoreEmulatorKernel(unsigned int kernel);
+
+} //namespace score
+#endif
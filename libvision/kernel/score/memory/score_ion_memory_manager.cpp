@@ -21,6 +21,10 @@
 #include <stdlib.h>
 #include <map>
 #include <sys/mman.h>
+#ifdef EMULATOR
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include <ExynosVisionCommonConfig.h>
 
 #include "score_ion_memory_manager.h"
@@ -35,19 +39,48 @@ namespace score {
 //TODO:It is temporary value for zynq board
 #define ION_HEAP_SCORE_MASK  (1<<6)
 
+#ifdef EMULATOR
+/// @brief  Allocate memory backed by memfd for the emulator
+/// @param  size     Size of memory to be allocated
+/// @param  fd       Fd of the allocated memory
+/// @retval 0 if function succeeds, otherwise negative errno
+static int AllocEmulatorMemory(size_t size, int *fd) {
+  // The syscall, glibc of host toolchains has no memfd_create()
+  int memfd = syscall(__NR_memfd_create, "score", 0);
+  if (memfd < 0)
+    return -errno;
+
+  if (ftruncate(memfd, size) < 0) {
+    int ret = -errno;
+    close(memfd);
+    return ret;
+  }
+
+  *fd = memfd;
+  return 0;
+}
+#endif
+
 ScoreIonMemoryManager::ScoreIonMemoryManager()
     : ion_dev_(-1) {
+#ifdef EMULATOR
+  // No driver to open, memfd is always available
+  ion_dev_ = 0;
+#else
   // Open ion driver
   ion_dev_ = ion_open();
+#endif
   ion_alloc_cnt = 0;
   ion_free_cnt = 0;
 }
 
 ScoreIonMemoryManager::~ScoreIonMemoryManager() {
+#ifndef EMULATOR
   if (ion_dev_ != -1) {
     // Close ion drever
     ion_close(ion_dev_);
   }
+#endif
   VXLOGD("Ion alloc cnt = %d, free cnt = %d", ion_alloc_cnt, ion_free_cnt);
 }
 
@@ -67,7 +100,11 @@ int ScoreIonMemoryManager::AllocScoreMemory(size_t size) {
     return -ENOMEM;
   }
 
+#ifdef EMULATOR
+  ret = AllocEmulatorMemory(size, &buffer->fd);
+#else
   ret = ion_alloc_fd(ion_dev_, size, 0, ION_HEAP_SYSTEM_MASK, 0, &buffer->fd);
+#endif
   if (ret) {
     sc_error("ion_alloc fail : %d\n", ret);
     goto err_buf_free;
@@ -88,6 +125,9 @@ int ScoreIonMemoryManager::AllocScoreMemory(size_t size) {
 err_ion_close:
   //TODO:needs to analyze ion driver
   //ion_close(buffer->fd);
+#ifdef EMULATOR
+  close(buffer->fd);
+#endif
 err_buf_free:
   delete buffer;
 
@@ -119,6 +159,9 @@ void ScoreIonMemoryManager::FreeScoreMemory(int fd) {
     munmap(buffer->virt.paddr, buffer->size);
     //TODO:needs to analyze ion driver
     //ion_close(buffer->fd);
+#ifdef EMULATOR
+    close(buffer->fd);
+#endif
     buffer_map_.erase(iter);
     delete buffer;
     ion_free_cnt++;
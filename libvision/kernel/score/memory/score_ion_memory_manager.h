@@ -7,6 +7,8 @@
 /// Ion memory manager is used to get continuous physical memory. Ion heap
 /// information for SCore must be registered at ion driver in order to use these
 /// functions.
+/// With EMULATOR, memory comes from memfd instead, so the emulator runs on a
+/// host without ion.
 ///
 /// @author  Rakie Kim<rakie.kim@samsung.com>
 ///
@@ -24,7 +26,9 @@
 #define MEMORY_SCORE_ION_MEMORY_MANAGER_H_
 
 #include <map>
+#ifndef EMULATOR
 #include "ion/ion.h"
+#endif
 
 namespace score
 {
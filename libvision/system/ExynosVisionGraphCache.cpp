@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosVisionGraphCache"
+#include <cutils/log.h>
+
+#include "ExynosVisionGraphCache.h"
+
+#include "ExynosVisionContext.h"
+#include "ExynosVisionGraph.h"
+#include "ExynosVisionNode.h"
+#include "ExynosVisionImage.h"
+#include "ExynosVisionScalar.h"
+
+namespace android {
+
+ExynosVisionGraphCache::ExynosVisionGraphCache(ExynosVisionContext *context)
+{
+    m_context = context;
+    m_max_entry_num = DEFAULT_GRAPH_CACHE_ENTRY_NUM;
+}
+
+ExynosVisionGraphCache::~ExynosVisionGraphCache(void)
+{
+    if (m_entry_list.size())
+        VXLOGE("%d cached graphs are not flushed", m_entry_list.size());
+}
+
+vx_reference
+ExynosVisionGraphCache::createPlaceholder(const graph_cache_param_t *param)
+{
+    vx_reference placeholder = NULL;
+
+    switch (param->type) {
+    case VX_TYPE_IMAGE:
+        /* only the format has to match, the node isn't processed while it's bound */
+        placeholder = (vx_reference)vxCreateImage((vx_context)m_context, GRAPH_CACHE_PLACEHOLDER_SIZE,
+                                                            GRAPH_CACHE_PLACEHOLDER_SIZE, param->format);
+        break;
+    case VX_TYPE_SCALAR:
+        placeholder = (vx_reference)vxCreateScalar((vx_context)m_context, param->format, &param->value);
+        break;
+    default:
+        break;
+    }
+
+    if ((placeholder != NULL) && (vxGetStatus(placeholder) != VX_SUCCESS))
+        placeholder = NULL;
+
+    return placeholder;
+}
+
+vx_status
+ExynosVisionGraphCache::unbindParams(graph_cache_entry_t *entry)
+{
+    vx_status status = VX_SUCCESS;
+
+    for (vx_uint32 i = 0; i < entry->key.param_num; i++) {
+        if (entry->key.params[i].type == VX_TYPE_INVALID)
+            continue;
+
+        /* made once per entry, the next put rebinds the same ones */
+        if (entry->placeholder[i] == NULL) {
+            entry->placeholder[i] = createPlaceholder(&entry->key.params[i]);
+            if (entry->placeholder[i] == NULL) {
+                VXLOGE("making a placeholder of parameter %d fails", i);
+                return VX_ERROR_NO_RESOURCES;
+            }
+        }
+
+        status = entry->node->setParameterByIndex(i, (ExynosVisionDataReference*)entry->placeholder[i]);
+        if (status != VX_SUCCESS) {
+            VXLOGE("unbinding parameter %d of %s fails, err:%d", i, entry->node->getName(), status);
+            break;
+        }
+    }
+
+    return status;
+}
+
+void
+ExynosVisionGraphCache::releaseEntry(graph_cache_entry_t *entry)
+{
+    vx_status status;
+    ExynosVisionGraph *graph = entry->graph;
+
+    /* the placeholders outlive the node that is bound to them */
+    if (graph) {
+        VXLOGD2("releasing cached %s", graph->getName());
+        status = ExynosVisionReference::releaseReferenceInt((ExynosVisionReference**)&graph, VX_REF_EXTERNAL);
+        if (status != VX_SUCCESS)
+            VXLOGE("releasing cached graph fails, err:%d", status);
+    }
+
+    for (vx_uint32 i = 0; i < VX_INT_MAX_PARAMS; i++) {
+        if (entry->placeholder[i] == NULL)
+            continue;
+
+        status = ExynosVisionReference::releaseReferenceInt((ExynosVisionReference**)&entry->placeholder[i], VX_REF_EXTERNAL);
+        if (status != VX_SUCCESS)
+            VXLOGE("releasing placeholder fails, err:%d", status);
+        entry->placeholder[i] = NULL;
+    }
+
+    entry->graph = NULL;
+    entry->node = NULL;
+}
+
+void
+ExynosVisionGraphCache::releaseEntryList(List<graph_cache_entry_t> *entry_list)
+{
+    List<graph_cache_entry_t>::iterator entry_iter;
+    for (entry_iter=entry_list->begin(); entry_iter!=entry_list->end(); entry_iter++)
+        releaseEntry(&(*entry_iter));
+
+    entry_list->clear();
+}
+
+vx_status
+ExynosVisionGraphCache::makeKey(vx_enum kernel_enum, const vx_border_mode_t *border,
+                                                        const vx_reference *parameters, vx_uint32 num, graph_cache_key_t *key)
+{
+    vx_status status = VX_SUCCESS;
+
+    memset(key, 0x0, sizeof(*key));
+
+    if ((m_max_entry_num == 0) || (num > VX_INT_MAX_PARAMS))
+        return VX_ERROR_NOT_SUPPORTED;
+
+    /* the kernel depends on the immediate target of the context */
+    key->kernel = m_context->getKernelByEnum(kernel_enum);
+    if ((key->kernel == NULL) || (key->kernel->getNumParams() != num))
+        return VX_ERROR_NOT_SUPPORTED;
+
+    key->border = *border;
+    key->param_num = num;
+
+    for (vx_uint32 i = 0; i < num; i++) {
+        ExynosVisionDataReference *data_ref = (ExynosVisionDataReference*)parameters[i];
+        graph_cache_param_t *param = &key->params[i];
+
+        if (data_ref == NULL) {
+            param->type = VX_TYPE_INVALID;
+            continue;
+        }
+
+        if ((ExynosVisionDataReference::isValidDataReference(data_ref) == vx_false_e) ||
+            (data_ref->isVirtual() == vx_true_e) ||
+            (data_ref->isDelayElement() == vx_true_e) ||
+            (data_ref->getAllianceNum() != 0))
+            return VX_ERROR_NOT_SUPPORTED;
+
+        param->type = data_ref->getType();
+
+        switch (param->type) {
+        case VX_TYPE_IMAGE:
+            status = ((ExynosVisionImage*)data_ref)->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &param->format, sizeof(param->format));
+            if (status == VX_SUCCESS)
+                status = ((ExynosVisionImage*)data_ref)->getDimension(&param->width, &param->height);
+            break;
+        case VX_TYPE_SCALAR:
+            status = ((ExynosVisionScalar*)data_ref)->queryScalar(VX_SCALAR_ATTRIBUTE_TYPE, &param->format, sizeof(param->format));
+            if ((status == VX_SUCCESS) && (key->kernel->getParamDirection(i) == VX_INPUT))
+                status = ((ExynosVisionScalar*)data_ref)->readScalarValue(&param->value);
+            break;
+        default:
+            /* the contents of the other objects are not a part of the key */
+            status = VX_ERROR_NOT_SUPPORTED;
+            break;
+        }
+
+        if (status != VX_SUCCESS)
+            return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    return status;
+}
+
+vx_bool
+ExynosVisionGraphCache::takeGraph(const graph_cache_key_t *key, graph_cache_entry_t *entry)
+{
+    Mutex::Autolock lock(m_cache_mutex);
+
+    List<graph_cache_entry_t>::iterator entry_iter;
+    for (entry_iter=m_entry_list.begin(); entry_iter!=m_entry_list.end(); entry_iter++) {
+        if (memcmp(&(*entry_iter).key, key, sizeof(*key)) == 0) {
+            *entry = *entry_iter;
+            m_entry_list.erase(entry_iter);
+
+            return vx_true_e;
+        }
+    }
+
+    return vx_false_e;
+}
+
+void
+ExynosVisionGraphCache::putGraph(const graph_cache_key_t *key, graph_cache_entry_t *entry)
+{
+    List<graph_cache_entry_t> evicted_list;
+
+    entry->key = *key;
+
+    /* the graph is still checked out, so nobody else rebinds the node */
+    if (unbindParams(entry) != VX_SUCCESS) {
+        releaseEntry(entry);
+        return;
+    }
+
+    m_cache_mutex.lock();
+
+    /* the same key could be put by a concurrent caller, the older one is dropped */
+    List<graph_cache_entry_t>::iterator entry_iter;
+    for (entry_iter=m_entry_list.begin(); entry_iter!=m_entry_list.end(); entry_iter++) {
+        if (memcmp(&(*entry_iter).key, key, sizeof(*key)) == 0) {
+            evicted_list.push_back(*entry_iter);
+            m_entry_list.erase(entry_iter);
+            break;
+        }
+    }
+
+    m_entry_list.push_front(*entry);
+
+    while (m_entry_list.size() > m_max_entry_num) {
+        entry_iter = m_entry_list.end();
+        entry_iter--;
+        evicted_list.push_back(*entry_iter);
+        m_entry_list.erase(entry_iter);
+    }
+
+    m_cache_mutex.unlock();
+
+    /* releasing a graph joins its subgraph threads, it's done out of the lock */
+    releaseEntryList(&evicted_list);
+}
+
+vx_status
+ExynosVisionGraphCache::setMaxEntryNum(vx_uint32 max_entry_num)
+{
+    List<graph_cache_entry_t> evicted_list;
+
+    m_cache_mutex.lock();
+
+    m_max_entry_num = max_entry_num;
+    while (m_entry_list.size() > m_max_entry_num) {
+        List<graph_cache_entry_t>::iterator entry_iter = m_entry_list.end();
+        entry_iter--;
+        evicted_list.push_back(*entry_iter);
+        m_entry_list.erase(entry_iter);
+    }
+
+    m_cache_mutex.unlock();
+
+    releaseEntryList(&evicted_list);
+
+    return VX_SUCCESS;
+}
+
+void
+ExynosVisionGraphCache::flush(void)
+{
+    List<graph_cache_entry_t> evicted_list;
+
+    m_cache_mutex.lock();
+    evicted_list = m_entry_list;
+    m_entry_list.clear();
+    m_cache_mutex.unlock();
+
+    releaseEntryList(&evicted_list);
+}
+
+}; // namespace android
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_GRAPH_CACHE_H
+#define EXYNOS_VISION_GRAPH_CACHE_H
+
+#include <utils/Mutex.h>
+#include <utils/List.h>
+
+#include <VX/vx.h>
+#include <VX/vx_internal.h>
+
+#define DEFAULT_GRAPH_CACHE_ENTRY_NUM   8
+/* dimension of the images that stand in for the caller images while a graph is cached */
+#define GRAPH_CACHE_PLACEHOLDER_SIZE    16
+
+namespace android {
+
+class ExynosVisionContext;
+class ExynosVisionKernel;
+class ExynosVisionGraph;
+class ExynosVisionNode;
+
+typedef struct _graph_cache_param_t {
+    vx_enum type;
+    /* image format or scalar data type */
+    vx_uint32 format;
+    vx_uint32 width;
+    vx_uint32 height;
+    /* value of input scalar, it could be baked into the kernel at initialization */
+    vx_uint64 value;
+} graph_cache_param_t;
+
+typedef struct _graph_cache_key_t {
+    ExynosVisionKernel *kernel;
+    vx_border_mode_t border;
+    vx_uint32 param_num;
+    graph_cache_param_t params[VX_INT_MAX_PARAMS];
+} graph_cache_key_t;
+
+typedef struct _graph_cache_entry_t {
+    graph_cache_key_t key;
+    ExynosVisionGraph *graph;
+    ExynosVisionNode *node;
+    /* bound to the node while the graph is cached, so it doesn't keep the caller references */
+    vx_reference placeholder[VX_INT_MAX_PARAMS];
+} graph_cache_entry_t;
+
+/* verified single node graphs of immediate mode, the most recently used one is at the front */
+class ExynosVisionGraphCache {
+private:
+    ExynosVisionContext *m_context;
+
+    Mutex m_cache_mutex;
+    List<graph_cache_entry_t> m_entry_list;
+    vx_uint32 m_max_entry_num;
+
+private:
+    vx_reference createPlaceholder(const graph_cache_param_t *param);
+    vx_status unbindParams(graph_cache_entry_t *entry);
+    void releaseEntryList(List<graph_cache_entry_t> *entry_list);
+
+public:
+    /* Constructor */
+    ExynosVisionGraphCache(ExynosVisionContext *context);
+
+    /* Destructor */
+    virtual ~ExynosVisionGraphCache(void);
+
+    /* VX_ERROR_NOT_SUPPORTED if any parameter can't be rebound to a verified graph */
+    vx_status makeKey(vx_enum kernel_enum, const vx_border_mode_t *border,
+                            const vx_reference *parameters, vx_uint32 num, graph_cache_key_t *key);
+
+    /* the graph is taken out of the cache while it is used, and put back after processing */
+    vx_bool takeGraph(const graph_cache_key_t *key, graph_cache_entry_t *entry);
+    void putGraph(const graph_cache_key_t *key, graph_cache_entry_t *entry);
+    /* for a graph that isn't put back */
+    void releaseEntry(graph_cache_entry_t *entry);
+
+    vx_status setMaxEntryNum(vx_uint32 max_entry_num);
+    vx_uint32 getMaxEntryNum(void)
+    {
+        return m_max_entry_num;
+    }
+
+    void flush(void);
+};
+
+}; // namespace android
+#endif
@@ -21,9 +21,15 @@
 #include <utils/Mutex.h>
 #include <utils/List.h>
 
+#include <sched.h>
+#include <atomic>
+
 #include <VX/vx.h>
 
+#include "ExynosVisionRing.h"
+
 #define POOL_WAIT_TIME (150 * 1000000)
+#define POOL_DEFAULT_CAPACITY   32
 
 namespace android {
 
@@ -34,26 +40,28 @@ typedef enum _pool_exception_t {
     POOL_EXCEPTION_UNKNOWN
 } pool_exception_t;
 
+/* Free resources are kept in a lock-free ring, a getter takes the mutex only when the pool is empty */
 template<typename T>
 class ExynosVisionPool {
 private:
-    List<T>             m_pool_list;
+    ExynosVisionRing<T> m_pool_ring;
     Mutex               m_pool_mutex;
     mutable Condition   m_pool_cond;
-    vx_uint32                m_waiting_object_num;
+    std::atomic<vx_uint32> m_waiting_object_num;
     uint64_t            m_waitTime;
 
     bool                m_wake_up_flag;
+    /* increased by release(), a waiter that sees it changed gives up */
+    vx_uint32           m_release_count;
 
 public:
-    typedef List<T> listType;
-    typedef typename listType::iterator iterator;
-
-    ExynosVisionPool()
+    ExynosVisionPool(vx_uint32 capacity = POOL_DEFAULT_CAPACITY)
+        : m_pool_ring(capacity)
     {
         m_waiting_object_num = 0;
         m_waitTime = POOL_WAIT_TIME;
         m_wake_up_flag = false;
+        m_release_count = 0;
     }
 
     ~ExynosVisionPool()
@@ -65,20 +73,33 @@ public:
     {
         Mutex::Autolock lock(m_pool_mutex);
 
+        m_release_count++;
         if (m_waiting_object_num)
             m_pool_cond.broadcast();
     };
 
     void flush(void)
     {
-        m_pool_list.clear();
+        T resource;
+
+        while (m_pool_ring.pop(&resource));
     }
 
     void putResource(T resource)
     {
-        Mutex::Autolock lock(m_pool_mutex);
-        m_pool_list.push_back(resource);
+        /* a getter that is still copying out of the cell makes the ring look full for a moment */
+        while (!m_pool_ring.push(resource)) {
+            if (m_pool_ring.size() >= m_pool_ring.getCapacity()) {
+                ALOGE("ERR(%s):pool is full, capacity:%d", __FUNCTION__, (vx_uint32)m_pool_ring.getCapacity());
+                return;
+            }
+            sched_yield();
+        }
+
+        /* pairs with the fence of a getter that is about to wait */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         if (m_waiting_object_num) {
+            Mutex::Autolock lock(m_pool_mutex);
             ALOGD("[%s]send wake-up signal", __FUNCTION__);
             m_pool_cond.signal();
         }
@@ -88,9 +109,19 @@ public:
     {
         status_t ret;
 
+        if (m_pool_ring.pop(ret_resource))
+            return POOL_EXCEPTION_NONE;
+
         m_pool_mutex.lock();
-        if (m_pool_list.empty()) {
+        vx_uint32 release_count = m_release_count;
+        while (1) {
             m_waiting_object_num++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_pool_ring.pop(ret_resource)) {
+                m_waiting_object_num--;
+                break;
+            }
+
             ret = m_pool_cond.wait(m_pool_mutex);
             m_waiting_object_num--;
 
@@ -107,19 +138,14 @@ public:
                 m_pool_mutex.unlock();
                 return POOL_EXCEPTION_WAKE_UP;
             }
-        }
 
-        if (m_pool_list.empty()) {
-            ALOGE("ERR(%s[%d]): pool is empty, invalid state", __FUNCTION__, __LINE__);
+            if ((release_count != m_release_count) && (m_pool_ring.size() == 0)) {
+                ALOGE("ERR(%s[%d]): pool is empty, invalid state", __FUNCTION__, __LINE__);
 
-            m_pool_mutex.unlock();
-            return POOL_EXCEPTION_UNKNOWN;
+                m_pool_mutex.unlock();
+                return POOL_EXCEPTION_UNKNOWN;
+            }
         }
-
-        iterator iter = m_pool_list.begin();
-        *ret_resource = *iter;
-        m_pool_list.erase(iter);
-
         m_pool_mutex.unlock();
 
         return POOL_EXCEPTION_NONE;
@@ -127,14 +153,12 @@ public:
 
     vx_uint32 getFreeNum(void)
     {
-        Mutex::Autolock lock(m_pool_mutex);
-        return m_pool_list.size();
+        return m_pool_ring.size();
     }
 
     void displayInfo(void)
     {
-        Mutex::Autolock lock(m_pool_mutex);
-        ALOGD("[%s]waiting_num:%d, pool num:%d", __FUNCTION__, m_waiting_object_num, m_pool_list.size());
+        ALOGD("[%s]waiting_num:%d, pool num:%d", __FUNCTION__, (vx_uint32)m_waiting_object_num, (vx_uint32)m_pool_ring.size());
     }
 };
 
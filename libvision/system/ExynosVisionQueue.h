@@ -21,6 +21,12 @@
 #include <utils/Mutex.h>
 #include <utils/List.h>
 
+#include <atomic>
+
+#include <VX/vx.h>
+
+#include "ExynosVisionRing.h"
+
 #define DEBUGQ
 //#define DEBUGQ  ALOGD
 
@@ -34,31 +40,90 @@ typedef enum _queue_exception_t {
     QUEUE_EXCEPTION_UNKNOWN
 } queue_exception_t;
 
+typedef enum _queue_full_policy_t {
+    /* the producer waits for a free cell */
+    QUEUE_FULL_POLICY_BLOCK = 1,
+    /* the message goes to an unbounded list, for producers that must not wait on their consumer */
+    QUEUE_FULL_POLICY_OVERFLOW
+} queue_full_policy_t;
+
+#define QUEUE_DEFAULT_CAPACITY  256
+
+/* The messages go through a lock-free ring. The mutex and the conditions are taken
+    only when a consumer has to wait for a message or a producer for a free cell,
+    or when the ring of an overflow queue is full. */
 template<typename T>
 class ExynosVisionQueue {
 private:
-    List<T>             m_processQ;
+    ExynosVisionRing<T> m_processQ;
     Mutex               m_processQMutex;
     mutable Condition   m_processQCondition;
-    bool                m_waitProcessQ;
+    mutable Condition   m_notFullCondition;
+    std::atomic<vx_uint32> m_waitProcessQ;
+    std::atomic<vx_uint32> m_waitNotFull;
     uint64_t            m_waitTime;
 
-    bool                m_queue_enable;
+    queue_full_policy_t m_fullPolicy;
+    /* messages after a full ring, they are newer than the ones in the ring and guarded by m_processQMutex */
+    List<T>             m_overflowQ;
+    std::atomic<vx_uint32> m_overflowNum;
+
+    std::atomic<bool>   m_queue_enable;
     bool                m_wake_up_flag;
 
 public:
 
 private:
+    /* The waiter announces itself before its last look at the ring and the other side
+        looks for a waiter after touching the ring, so one of them always sees the other. */
+    void signalWaiter(std::atomic<vx_uint32> *wait_num, Condition *condition)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (wait_num->load(std::memory_order_relaxed)) {
+            Mutex::Autolock lock(m_processQMutex);
+            condition->signal();
+        }
+    }
 
-public:
-    typedef List<T> listType;
-    typedef typename listType::iterator iterator;
+    bool popOverflowLocked(T *buf)
+    {
+        if (m_overflowQ.empty())
+            return false;
+
+        *buf = *m_overflowQ.begin();
+        m_overflowQ.erase(m_overflowQ.begin());
+        m_overflowNum--;
+
+        return true;
+    }
 
-    ExynosVisionQueue(uint64_t wait_time)
+    bool popMessage(T *buf, bool locked)
     {
-        m_waitProcessQ = false;
+        if (m_processQ.pop(buf))
+            return true;
+
+        if (m_overflowNum.load(std::memory_order_acquire) == 0)
+            return false;
+
+        if (locked)
+            return popOverflowLocked(buf);
+
+        Mutex::Autolock lock(m_processQMutex);
+        return popOverflowLocked(buf);
+    }
+
+public:
+    ExynosVisionQueue(uint64_t wait_time, vx_uint32 capacity = QUEUE_DEFAULT_CAPACITY,
+                            queue_full_policy_t full_policy = QUEUE_FULL_POLICY_BLOCK)
+        : m_processQ(capacity)
+    {
+        m_waitProcessQ = 0;
+        m_waitNotFull = 0;
         m_waitTime = wait_time;
 
+        m_fullPolicy = full_policy;
+        m_overflowNum = 0;
+
         m_queue_enable = true;
         m_wake_up_flag = false;
     }
@@ -89,6 +154,7 @@ public:
             m_wake_up_flag = true;
             m_processQCondition.signal();
         }
+        m_notFullCondition.broadcast();
 
         m_processQMutex.unlock();
     }
@@ -96,28 +162,56 @@ public:
     /* Process Queue */
     void pushProcessQ(T *buf)
     {
-        Mutex::Autolock lock(m_processQMutex);
         DEBUGQ("[Q][%s]", __FUNCTION__);
 
-        m_processQ.push_back(*buf);
+        if (m_fullPolicy == QUEUE_FULL_POLICY_OVERFLOW) {
+            /* once a message overflows, the next ones follow it until the list is drained */
+            if ((m_overflowNum.load(std::memory_order_relaxed) != 0) || !m_processQ.push(*buf)) {
+                m_processQMutex.lock();
+                if (m_queue_enable == false) {
+                    ALOGE("ERR(%s):queue is disabled, drop the message", __FUNCTION__);
+                    m_processQMutex.unlock();
+                    return;
+                }
 
-        if (m_waitProcessQ)
-            m_processQCondition.signal();
+                if (m_overflowQ.empty())
+                    ALOGW("WARN(%s):queue is full, messages wait in the overflow list", __FUNCTION__);
+                m_overflowQ.push_back(*buf);
+                m_overflowNum++;
+                m_processQMutex.unlock();
+            }
+        } else if (!m_processQ.push(*buf)) {
+            m_processQMutex.lock();
+            while (1) {
+                if (m_queue_enable == false) {
+                    ALOGE("ERR(%s):queue is full and disabled, drop the message", __FUNCTION__);
+                    m_processQMutex.unlock();
+                    return;
+                }
+
+                m_waitNotFull++;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_processQ.push(*buf)) {
+                    m_waitNotFull--;
+                    break;
+                }
+                m_notFullCondition.wait(m_processQMutex);
+                m_waitNotFull--;
+            }
+            m_processQMutex.unlock();
+        }
+
+        signalWaiter(&m_waitProcessQ, &m_processQCondition);
     };
 
     status_t popProcessQ(T *buf)
     {
-        iterator r;
-
-        Mutex::Autolock lock(m_processQMutex);
         DEBUGQ("[Q][%s]", __FUNCTION__);
 
-        if (m_processQ.empty())
+        if (!popMessage(buf, false))
             return TIMED_OUT;
 
-        r = m_processQ.begin()++;
-        *buf = *r;
-        m_processQ.erase(r);
+        signalWaiter(&m_waitNotFull, &m_notFullCondition);
 
         return OK;
     };
@@ -126,22 +220,35 @@ public:
     {
         status_t ret;
 
-        m_processQMutex.lock();
         DEBUGQ("[Q][%s]", __FUNCTION__);
 
-        if (m_queue_enable == false) {
-            m_processQMutex.unlock();
+        if (m_queue_enable == false)
             return QUEUE_EXCEPTION_DISABLE;
+
+        if (popMessage(buf, false)) {
+            signalWaiter(&m_waitNotFull, &m_notFullCondition);
+            return QUEUE_EXCEPTION_NONE;
         }
 
-        if (m_processQ.empty()) {
-            m_waitProcessQ = true;
+        m_processQMutex.lock();
+        while (1) {
+            if (m_queue_enable == false) {
+                m_processQMutex.unlock();
+                return QUEUE_EXCEPTION_DISABLE;
+            }
+
+            m_waitProcessQ++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (popMessage(buf, true)) {
+                m_waitProcessQ--;
+                break;
+            }
 
             if (m_waitTime)
                 ret = m_processQCondition.waitRelative(m_processQMutex, m_waitTime);
             else
                 ret = m_processQCondition.wait(m_processQMutex);
-            m_waitProcessQ = false;
+            m_waitProcessQ--;
 
             if (ret < 0) {
                 if (ret == TIMED_OUT) {
@@ -166,32 +273,26 @@ public:
                     return QUEUE_EXCEPTION_WAKE_UP;
                 }
             }
-        }
 
-        if (m_processQ.empty()) {
-            ALOGE("ERR(%s[%d]): processQ is empty, invalid state", __FUNCTION__, __LINE__);
-            m_processQMutex.unlock();
-            return QUEUE_EXCEPTION_UNKNOWN;
+            /* another consumer could take the message on its fast path, wait again */
         }
+        m_processQMutex.unlock();
 
-        iterator r;
-        r = m_processQ.begin();
-        *buf = *r;
-        m_processQ.erase(r);
+        signalWaiter(&m_waitNotFull, &m_notFullCondition);
 
-        m_processQMutex.unlock();
         return QUEUE_EXCEPTION_NONE;
     };
 
     uint32_t getRemainedMsgNum(void)
     {
-        Mutex::Autolock lock(m_processQMutex);
-        return m_processQ.size();
+        return m_processQ.size() + m_overflowNum.load(std::memory_order_relaxed);
     }
 
     /* release both Queue */
     void release(void)
     {
+        T buf;
+
         m_processQMutex.lock();
 
         DEBUGQ("[Q][%s]", __FUNCTION__);
@@ -200,8 +301,11 @@ public:
 
         if (m_waitProcessQ)
             m_processQCondition.signal();
+        m_notFullCondition.broadcast();
 
-        m_processQ.clear();
+        while (m_processQ.pop(&buf));
+        m_overflowQ.clear();
+        m_overflowNum = 0;
         m_processQMutex.unlock();
     };
 };
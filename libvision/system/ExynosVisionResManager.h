@@ -325,6 +325,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResSlotType(vx_uint32 slot_num = 1)
+        : m_free_res_element_pool(slot_num)
     {
         ExynosVisionResManager<T>::m_res_class_type = RESOURCE_CLASS_SLOT;
         m_slot_num = slot_num;
@@ -550,6 +551,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResQueueType(void)
+        : m_done_res_element_pool(MAX_QUEUE_RES_NUM)
     {
         for (vx_uint32 i=0; i<MAX_QUEUE_RES_NUM; i++) {
             ExynosVisionResElement<T> *res_element = new ExynosVisionResElement<T>();
@@ -739,6 +741,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResOutputQueueType(void)
+        : m_free_res_element_pool(MAX_QUEUE_RES_NUM)
     {
         ExynosVisionResManager<T>::m_res_class_type = RESOURCE_CLASS_OUTPUT_QUEUE;
     }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_RING_H
+#define EXYNOS_VISION_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+namespace android {
+
+#define RING_CACHE_LINE_SIZE    64
+
+/* Bounded multi-producer multi-consumer ring, the cells are allocated once.
+    Each cell has a sequence number, a producer owns the cell when the sequence is its position
+    and a consumer owns the cell when the sequence is the position + 1. Neither side takes a lock,
+    they only race for the position with a compare-and-swap. */
+template<typename T>
+class ExynosVisionRing {
+private:
+    typedef struct _ring_cell_t {
+        std::atomic<size_t> sequence;
+        T data;
+    } ring_cell_t;
+
+    ring_cell_t *m_cell;
+    size_t m_mask;
+
+    /* producers and consumers don't share the cache line of their position */
+    char m_pad0[RING_CACHE_LINE_SIZE];
+    std::atomic<size_t> m_enqueue_pos;
+    char m_pad1[RING_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_dequeue_pos;
+    char m_pad2[RING_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+public:
+    /* capacity is rounded up to a power of two */
+    ExynosVisionRing(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        m_cell = new ring_cell_t[size];
+        m_mask = size - 1;
+
+        for (size_t i = 0; i < size; i++)
+            m_cell[i].sequence.store(i, std::memory_order_relaxed);
+
+        m_enqueue_pos.store(0, std::memory_order_relaxed);
+        m_dequeue_pos.store(0, std::memory_order_relaxed);
+    }
+
+    ~ExynosVisionRing()
+    {
+        delete[] m_cell;
+    }
+
+    /* false if the ring is full */
+    bool push(const T &data)
+    {
+        ring_cell_t *cell;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+
+        while (1) {
+            cell = &m_cell[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = data;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* false if the ring is empty, a push that is not finished is not seen yet */
+    bool pop(T *data)
+    {
+        ring_cell_t *cell;
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+        while (1) {
+            cell = &m_cell[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *data = cell->data;
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* it could be stale while other threads are working */
+    size_t size(void)
+    {
+        size_t enqueue_pos = m_enqueue_pos.load(std::memory_order_acquire);
+        size_t dequeue_pos = m_dequeue_pos.load(std::memory_order_acquire);
+
+        return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+    }
+
+    size_t getCapacity(void)
+    {
+        return m_mask + 1;
+    }
+};
+
+}; // namespace android
+#endif
@@ -22,6 +22,7 @@
 #include "ExynosVisionSubgraph.h"
 
 #include "ExynosVisionGraph.h"
+#include "ExynosVisionDelay.h"
 #include "ExynosVisionBufObject.h"
 
 #define BIT_FLAG(i) ((1<<i))
@@ -46,18 +47,22 @@ ExynosVisionSubgraph::ExynosVisionSubgraph(ExynosVisionGraph *graph)
     m_graph = graph;
 
     m_represent_node = NULL;
+    m_tail_node = NULL;
 
-    m_params = NULL;
     m_message_queue = NULL;
 
     m_thread_state.setState(THREAD_STATE_NOT_START);
 
     m_target_done_bitmask = 0;
-    m_param_num = 0;
 
     m_complete_event = NULL;
 
     m_last_process_frame = 0;
+
+    m_trace_id = 0;
+    m_ready_push_time = 0;
+    m_ready_pop_time = 0;
+    m_ready_cause_id = 0;
 }
 
 ExynosVisionSubgraph::~ExynosVisionSubgraph(void)
@@ -74,12 +79,41 @@ ExynosVisionSubgraph::init(ExynosVisionNode *node)
     sprintf(m_sg_name, "SG_%d-%s", m_id, m_represent_node->getKernelHandle()->getKernelFuncName());
 
     m_node_list.push_back(node);
+    m_tail_node = node;
 
     m_complete_event = new ExynosVisionEvent(COMPLETE_WAIT_TIME);
 
     return VX_SUCCESS;
 }
 
+vx_status
+ExynosVisionSubgraph::addNode(ExynosVisionNode *node)
+{
+    if (m_represent_node == NULL) {
+        VXLOGE("subgraph is not initialized");
+        return VX_FAILURE;
+    }
+
+    vx_size name_len = strlen(m_sg_name);
+    snprintf(m_sg_name + name_len, sizeof(m_sg_name) - name_len, "+%s", node->getKernelHandle()->getKernelFuncName());
+
+    m_node_list.push_back(node);
+    m_tail_node = node;
+
+    return VX_SUCCESS;
+}
+
+vx_uint32
+ExynosVisionSubgraph::getInputDataRefNum(void)
+{
+    vx_uint32 input_num = 0;
+
+    for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+        input_num += (*node_iter)->getInputDataRefNum();
+
+    return input_num;
+}
+
 vx_status
 ExynosVisionSubgraph::destroy(void)
 {
@@ -95,17 +129,42 @@ ExynosVisionSubgraph::destroy(void)
         delete m_message_queue;
     }
 
-    if (m_params)
-        delete m_params;
-
     if (m_complete_event) {
         delete m_complete_event;
         m_complete_event = NULL;
     }
 
+    for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        if ((*node_iter)->getSubgraph() == this)
+            (*node_iter)->setSubgraph(NULL);
+    }
+
     return status;
 }
 
+vx_bool
+ExynosVisionSubgraph::isInternalDataRef(ExynosVisionDataReference *data_ref)
+{
+    if ((data_ref->isVirtual() != vx_true_e) ||
+        (data_ref->getDirectInputNodeNum(m_graph) != 1) ||
+        (data_ref->getIndirectInputNodeNum(m_graph) != 1) ||
+        (data_ref->getDirectOutputNodeNum(m_graph) == 0) ||
+        (data_ref->getDirectOutputNodeNum(m_graph) != data_ref->getIndirectOutputNodeNum(m_graph)))
+        return vx_false_e;
+
+    ExynosVisionNode *producer_node = data_ref->getDirectInputNode(m_graph, 0);
+    if ((producer_node == NULL) || (producer_node->getSubgraph() != this))
+        return vx_false_e;
+
+    for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(m_graph); i++) {
+        ExynosVisionNode *consumer_node = data_ref->getDirectOutputNode(m_graph, i);
+        if ((consumer_node == NULL) || (consumer_node == producer_node) || (consumer_node->getSubgraph() != this))
+            return vx_false_e;
+    }
+
+    return vx_true_e;
+}
+
 vx_status
 ExynosVisionSubgraph::makeInputOutputPort(void)
 {
@@ -117,40 +176,52 @@ ExynosVisionSubgraph::makeInputOutputPort(void)
 
     m_input_data_ref_list.clear();
     m_output_data_ref_list.clear();
+    m_internal_data_ref_list.clear();
 
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if ((data_ref == NULL) && m_represent_node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
-            VXLOGE("%s(%s) does not have necessary parameter[%d]", m_represent_node->getName(), m_represent_node->getKernelName(), p);
-        }
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
 
-        ref_connect_info_t connect_info;
-        connect_info.ref = data_ref;
-        connect_info.node_index = p;
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) && node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
+                VXLOGE("%s(%s) does not have necessary parameter[%d]", node->getName(), node->getKernelName(), p);
+            }
 
-        if (m_represent_node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
-            m_input_data_ref_list.push_back(connect_info);
+            ref_connect_info_t connect_info;
+            connect_info.ref = data_ref;
+            connect_info.node = node;
+            connect_info.node_index = p;
+
+            if ((data_ref != NULL) && (isInternalDataRef(data_ref) == vx_true_e)) {
+                /* produced and consumed inside, it needs neither port nor done event */
+                m_internal_data_ref_list.push_back(connect_info);
+            } else if (node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
+                /* exclusive object doesn't need to receive doen event */
+                if ((data_ref != NULL) &&
+                    ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
+                    m_target_done_bitmask |= BIT_FLAG(m_input_data_ref_list.size());
+                }
 
-            /* exclusive object doesn't need to receive doen event */
-            if ((data_ref != NULL) &&
-                ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
-                m_target_done_bitmask |= BIT_FLAG(p);
+                m_input_data_ref_list.push_back(connect_info);
+            } else {
+                m_output_data_ref_list.push_back(connect_info);
             }
-        } else {
-            m_output_data_ref_list.push_back(connect_info);
         }
     }
 
-    m_param_num = m_input_data_ref_list.size() + m_output_data_ref_list.size();
-    m_params = new ExynosVisionDataReference*[m_param_num];
+    if (m_input_data_ref_list.size() > MAX_SUBGRAPH_INPUT_PORT_NUM) {
+        VXLOGE("%s has too many input ports(%d)", getSgName(), m_input_data_ref_list.size());
+        status = VX_ERROR_NO_RESOURCES;
+    }
 
     EXYNOS_VISION_SYSTEM_OUT();
 
-    return VX_SUCCESS;
+    return status;
 }
 
 vx_status
-ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir)
+ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir)
 {
     EXYNOS_VISION_SYSTEM_IN();
 
@@ -177,16 +248,24 @@ ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosV
         goto EXIT;
     }
 
+    for (ref_iter=m_internal_data_ref_list.begin(); ref_iter!=m_internal_data_ref_list.end(); ref_iter++) {
+        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)) {
+            VXLOGE("%s is internal reference of %s, graph should be verified again", old_ref->getName(), getSgName());
+            status = VX_FAILURE;
+            goto EXIT;
+        }
+    }
+
     if (dir == VX_INPUT)
         data_ref_list = &m_input_data_ref_list;
     else
         data_ref_list = &m_output_data_ref_list;
 
     for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
-        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node_index == node_index)){
+        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)){
             ref_iter = data_ref_list->erase(ref_iter);
 
-            ref_connect_info_t connect_info = { new_ref, node_index};
+            ref_connect_info_t connect_info = { new_ref, node, node_index};
             data_ref_list->insert(ref_iter, connect_info);
             result = vx_true_e;
             break;
@@ -197,13 +276,21 @@ ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosV
         VXLOGE("can't replace %s to %s at %s", old_ref->getName(), new_ref->getName(), this->getSgName());
 
         for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
-            VXLOGD("ref:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node_index);
+            VXLOGD("ref:%s, node:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node->getName(), (*ref_iter).node_index);
         }
-        m_represent_node->displayInfo(0, vx_true_e);
+        node->displayInfo(0, vx_true_e);
 
         status = VX_FAILURE;
     } else {
         status = VX_SUCCESS;
+
+        /* the subgraph is already fixed, so the new reference missed allocateDataRefMemory() */
+        if (new_ref->isAllocated() == vx_false_e) {
+            VXLOGD2("%s, allocating memory", new_ref->getName());
+            status = new_ref->allocateMemory();
+            if (status != VX_SUCCESS)
+                VXLOGE("data_ref(%s) allocation memory fail, error:%d", new_ref->getName(), status);
+        }
     }
 
 EXIT:
@@ -218,20 +305,39 @@ ExynosVisionSubgraph::allocateDataRefMemory(void)
     EXYNOS_VISION_SYSTEM_IN();
 
     vx_status status = VX_SUCCESS;
+    List<ref_connect_info_t>::iterator ref_iter;
 
-    /* allocation reference object memory */
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if (data_ref == NULL)
+    /* internal reference is written and read in turn by this thread, a single buffer is enough in any mode */
+    for (ref_iter=m_internal_data_ref_list.begin(); ref_iter!=m_internal_data_ref_list.end(); ref_iter++) {
+        ExynosVisionDataReference *data_ref = (*ref_iter).ref;
+        if (data_ref->isAllocated() == vx_true_e)
             continue;
 
-        if (data_ref->isAllocated() == vx_false_e) {
-            VXLOGD2("%s, allocating memory", data_ref->getName());
-            status = data_ref->allocateMemory();
-            if (status != VX_SUCCESS)
-                VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
-        } else {
-            VXLOGD2("%s, memory is already allocated", data_ref->getName());
+        struct resource_param res_param;
+        VXLOGD2("%s, allocating internal memory", data_ref->getName());
+        status = data_ref->allocateMemory(RESOURCE_MNGR_SOLID, &res_param);
+        if (status != VX_SUCCESS)
+            VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
+    }
+
+    /* allocation reference object memory */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if (data_ref == NULL)
+                continue;
+
+            if (data_ref->isAllocated() == vx_false_e) {
+                VXLOGD2("%s, allocating memory", data_ref->getName());
+                status = data_ref->allocateMemory();
+                if (status != VX_SUCCESS)
+                    VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
+            } else {
+                VXLOGD2("%s, memory is already allocated", data_ref->getName());
+            }
         }
     }
 
@@ -258,7 +364,8 @@ ExynosVisionSubgraph::fixSubgraph(void)
     }
 
     if (m_graph->getPerfMonitor() != NULL) {
-        m_graph->getPerfMonitor()->registerObjectForTrace(m_represent_node, NODE_TIMEPAIR_NUMBER);
+        for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            m_graph->getPerfMonitor()->registerObjectForTrace(*node_iter, NODE_TIMEPAIR_NUMBER);
     } else {
         VXLOGE("performance monitor is not assigned");
     }
@@ -275,14 +382,15 @@ ExynosVisionSubgraph::fixSubgraph(void)
 }
 
 vx_bool
-ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index)
+ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index)
 {
     vx_uint32 i;
     vx_bool result = vx_false_e;
 
     List<ref_connect_info_t>::iterator ref_iter;
     for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++) {
-        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node_index == node_index)) {
+        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)) {
+            *ret_port_index = i;
             result = vx_true_e;
             break;
         }
@@ -290,7 +398,7 @@ ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_u
 
     if (result != vx_true_e) {
         VXLOGE("[%s] data reference is not found", getSgName());
-        VXLOGD("ref:%s, node_index:%d", data_ref->getName(), node_index);
+        VXLOGD("ref:%s, node:%s, node_index:%d", data_ref->getName(), node->getName(), node_index);
         m_represent_node->displayInfo(0, vx_true_e);
 
         for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++)
@@ -301,13 +409,15 @@ ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_u
 }
 
 vx_status
-ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index)
+ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index)
 {
     subgraph_message_t sg_msg;
     sg_msg.type = SG_MESSAGE_DONE_EVENT;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = ref;
+    sg_msg.done_node = node;
     sg_msg.node_index = node_index;
+    sg_msg.push_time = (m_graph->getContext()->getTraceRecorder()->isEnabled() == vx_true_e) ? ExynosVisionDurationTimer::getTimeUs() : 0;
 
     VXLOGTD("push done event: %s, frame(%d)", ref->getName(), frame_cnt);
 
@@ -323,7 +433,9 @@ ExynosVisionSubgraph::pushTrigger(vx_uint32 frame_cnt)
     sg_msg.type = SG_MESSAGE_TRIGGER;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = NULL;
+    sg_msg.done_node = NULL;
     sg_msg.node_index = 0;
+    sg_msg.push_time = (m_graph->getContext()->getTraceRecorder()->isEnabled() == vx_true_e) ? ExynosVisionDurationTimer::getTimeUs() : 0;
 
     VXLOGTD("push trigger:frame_%d", frame_cnt);
 
@@ -361,20 +473,25 @@ ExynosVisionSubgraph::popDoneEvent(vx_uint32 *ret_frame_cnt)
         }
 
         ready_frame_cnt = sg_msg.frame_cnt;
+        if (sg_msg.push_time)
+            traceReadyMessage(&sg_msg);
     } else {
         while(1) {
-            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.node_index) != vx_true_e) {
+            vx_uint32 port_index;
+            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.done_node, sg_msg.node_index, &port_index) != vx_true_e) {
                 VXLOGE("poped event doesn't match input reference information");
                 break;
             }
 
-            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(sg_msg.node_index);
+            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(port_index);
             VXLOGTD("pop done: %s, frame(%d), ready_bitmask:%p, target_bitmask:%p", sg_msg.done_reference->getName(), sg_msg.frame_cnt,
                                                                                                                                m_ready_bitmask_map[sg_msg.frame_cnt], m_target_done_bitmask);
 
             if (m_ready_bitmask_map[sg_msg.frame_cnt] == m_target_done_bitmask) {
                 ready_frame_cnt = sg_msg.frame_cnt;
                 m_ready_bitmask_map.erase(ready_frame_cnt);
+                if (sg_msg.push_time)
+                    traceReadyMessage(&sg_msg);
                 break;
             }
 
@@ -395,6 +512,29 @@ EXIT:
     return exception;
 }
 
+void
+ExynosVisionSubgraph::traceReadyMessage(subgraph_message_t *sg_msg)
+{
+    m_ready_push_time = sg_msg->push_time;
+    m_ready_pop_time = ExynosVisionDurationTimer::getTimeUs();
+
+    /* the subgraph that wrote the last input is the one this frame waited for */
+    m_ready_cause_id = 0;
+    if (sg_msg->type == SG_MESSAGE_TRIGGER) {
+        m_ready_cause_id = m_graph->getTraceId();
+    } else if (sg_msg->done_reference->getDirectInputNodeNum(m_graph)) {
+        ExynosVisionNode *writer = sg_msg->done_reference->getDirectInputNode(m_graph, 0);
+        if ((writer) && (writer->getSubgraph()))
+            m_ready_cause_id = writer->getSubgraph()->getTraceId();
+    }
+}
+
+vx_uint32
+ExynosVisionSubgraph::getTraceId(void)
+{
+    return m_graph->getContext()->getTraceRecorder()->getObjectId(&m_trace_id, TRACE_OBJECT_SUBGRAPH, m_sg_name, m_graph->getTraceId());
+}
+
 vx_status
 ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid)
 {
@@ -414,29 +554,32 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_input_data_ref_list.push_back(connect_info);
             continue;
         }
 
+        /* the connection is decided by the bound reference, the resource comes from the element of the frame */
+        ExynosVisionDataReference* ref_frame = getFrameDataRef(ref_represent, (*ref_iter).node, (*ref_iter).node_index);
+
         if ((exec_mode == GRAPH_EXEC_NORMAL) || (ref_represent->getDirectInputNodeNum(m_graph) == 0)) {
-            VXLOGTD("trying to get exclusive from %s, frame_%d", ref_represent->getName(), frame_cnt);
-            ref_clone = ref_represent->getInputExclusiveRef(frame_cnt, ret_data_valid);
+            VXLOGTD("trying to get exclusive from %s, frame_%d", ref_frame->getName(), frame_cnt);
+            ref_clone = ref_frame->getInputExclusiveRef(frame_cnt, ret_data_valid);
             if (ref_clone == NULL) {
-                VXLOGE("cann't get data reference from %s", ref_represent->getName());
+                VXLOGE("cann't get data reference from %s", ref_frame->getName());
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         } else {
-            VXLOGTD("trying to get share from %s, frame_%d", ref_represent->getName(), frame_cnt);
-            if (ref_clone_map[ref_represent] == NULL) {
-                ref_clone = ref_represent->getInputShareRef(frame_cnt, ret_data_valid);
-                ref_clone_map[ref_represent] = ref_clone;
+            VXLOGTD("trying to get share from %s, frame_%d", ref_frame->getName(), frame_cnt);
+            if (ref_clone_map[ref_frame] == NULL) {
+                ref_clone = ref_frame->getInputShareRef(frame_cnt, ret_data_valid);
+                ref_clone_map[ref_frame] = ref_clone;
             } else {
-                ref_clone = ref_clone_map[ref_represent];
+                ref_clone = ref_clone_map[ref_frame];
             }
 
             if (ref_clone == NULL) {
@@ -444,7 +587,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         }
@@ -470,68 +613,103 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_output_data_ref_list.push_back(connect_info);
             continue;
         }
 
+        ExynosVisionDataReference* ref_frame = getFrameDataRef(ref_represent, (*ref_iter).node, (*ref_iter).node_index);
+
         if ((exec_mode == GRAPH_EXEC_NORMAL) || (ref_represent->getDirectOutputNodeNum(m_graph) == 0)) {
-            VXLOGTD("trying to get exclusive from %s, frame_%d", ref_represent->getName(), frame_cnt);
-            ref_clone = ref_represent->getOutputExclusiveRef(frame_cnt);
+            VXLOGTD("trying to get exclusive from %s, frame_%d", ref_frame->getName(), frame_cnt);
+            ref_clone = ref_frame->getOutputExclusiveRef(frame_cnt);
             if (ref_clone == NULL) {
-                VXLOGE("cann't get data reference from %s", ref_represent->getName());
+                VXLOGE("cann't get data reference from %s", ref_frame->getName());
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         } else {
-            VXLOGTD("trying to get share from %s, frame_%d", ref_represent->getName(), frame_cnt);
-            if (ref_clone_map[ref_represent] == NULL) {
-                ref_clone = ref_represent->getOutputShareRef(frame_cnt);
-                ref_clone_map[ref_represent] = ref_clone;
+            VXLOGTD("trying to get share from %s, frame_%d", ref_frame->getName(), frame_cnt);
+            if (ref_clone_map[ref_frame] == NULL) {
+                ref_clone = ref_frame->getOutputShareRef(frame_cnt);
+                ref_clone_map[ref_frame] = ref_clone;
             } else {
-                ref_clone = ref_clone_map[ref_represent];
+                ref_clone = ref_clone_map[ref_frame];
             }
 
             if (ref_clone == NULL) {
-                VXLOGE("cann't get data reference from %s", ref_represent->getName());
+                VXLOGE("cann't get data reference from %s", ref_frame->getName());
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         }
     }
 
+    /* internal reference is held exclusively whatever the execution mode, there is no other user */
+    for (ref_iter=m_internal_data_ref_list.begin(); ref_iter!=m_internal_data_ref_list.end(); ref_iter++) {
+        ExynosVisionDataReference* ref_internal = (*ref_iter).ref;
+        if ((*ref_iter).node->getKernelHandle()->getParamDirection((*ref_iter).node_index) == VX_INPUT)
+            continue;
+
+        if (ref_internal->getOutputExclusiveRef(frame_cnt) == NULL) {
+            VXLOGE("cann't get data reference from %s", ref_internal->getName());
+            status = VX_ERROR_INVALID_REFERENCE;
+        } else {
+            ref_internal->increaseKernelCount();
+        }
+    }
+
     return status;
 }
 
+void
+ExynosVisionSubgraph::setKernelParams(ExynosVisionNode *node, List<ref_connect_info_t> *data_ref_list, const ExynosVisionDataReference **params)
+{
+    List<ref_connect_info_t>::iterator ref_iter;
+    for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
+        if ((*ref_iter).node == node)
+            params[(*ref_iter).node_index] = (*ref_iter).ref;
+    }
+}
+
 vx_status
 ExynosVisionSubgraph::kernelProcess(vx_uint32 frame_cnt)
 {
     vx_status status = VX_FAILURE;
+    const ExynosVisionDataReference *params[VX_INT_MAX_PARAMS];
+    ExynosVisionTraceRecorder *trace_recorder = m_graph->getContext()->getTraceRecorder();
 
     if (frame_cnt == 0) {
         VXLOGW("frame count is zero");
     }
 
-    List<ref_connect_info_t>::iterator ref_iter;
-    for (ref_iter=m_cur_input_data_ref_list.begin(); ref_iter!=m_cur_input_data_ref_list.end(); ref_iter++) {
-        m_params[(*ref_iter).node_index] = (*ref_iter).ref;
-    }
-
-    for (ref_iter=m_cur_output_data_ref_list.begin(); ref_iter!=m_cur_output_data_ref_list.end(); ref_iter++) {
-        m_params[(*ref_iter).node_index] = (*ref_iter).ref;
+    /* fused nodes run back to back, each one reads what the previous one wrote */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        memset(params, 0x0, sizeof(params));
+        setKernelParams(node, &m_cur_input_data_ref_list, params);
+        setKernelParams(node, &m_cur_output_data_ref_list, params);
+        setKernelParams(node, &m_internal_data_ref_list, params);
+
+        const ExynosVisionKernel *kernel = node->getKernelHandle();
+        vx_uint64 start_time = trace_recorder->isEnabled() ? ExynosVisionDurationTimer::getTimeUs() : 0;
+        status = kernel->kernelFunction(node, params, node->getDataRefNum());
+        if (start_time)
+            trace_recorder->record(TRACE_EVENT_NODE_EXECUTE, node->getTraceId(), frame_cnt, start_time, ExynosVisionDurationTimer::getTimeUs());
+        if (status != VX_SUCCESS) {
+            VXLOGE("%s, kernel of %s fails, err:%d", m_sg_name, node->getName(), status);
+            break;
+        }
     }
 
-    const ExynosVisionKernel *kernel = m_represent_node->getKernelHandle();
-    status = kernel->kernelFunction(m_represent_node, (const ExynosVisionDataReference **)m_params, m_param_num);
-
-EXIT:
-
     return status;
 }
 
@@ -560,22 +738,24 @@ ExynosVisionSubgraph::putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         if (ref_represent == NULL)
             continue;
 
+        ExynosVisionDataReference* ref_frame = getFrameDataRef(ref_represent, (*ref_iter).node, (*ref_iter).node_index);
+
         if ((exec_mode == GRAPH_EXEC_NORMAL) || (ref_represent->getDirectInputNodeNum(m_graph) == 0)) {
-            if (ref_represent->putInputExclusiveRef(frame_cnt) != VX_SUCCESS) {
+            if (ref_frame->putInputExclusiveRef(frame_cnt) != VX_SUCCESS) {
                 VXLOGE("put exclusive ref fails");
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
-                VXLOGTD("put exclusive to %s, frame_%d", ref_represent->getName(), frame_cnt);
+                VXLOGTD("put exclusive to %s, frame_%d", ref_frame->getName(), frame_cnt);
             }
         } else {
-            if (ref_put_map[ref_represent] != vx_true_e) {
-                if (ref_represent->putInputShareRef(frame_cnt) != VX_SUCCESS) {
+            if (ref_put_map[ref_frame] != vx_true_e) {
+                if (ref_frame->putInputShareRef(frame_cnt) != VX_SUCCESS) {
                     VXLOGE("put share ref fails");
                     status = VX_ERROR_INVALID_REFERENCE;
                 } else {
-                    VXLOGTD("put share to %s, frame_%d", ref_represent->getName(), frame_cnt);
+                    VXLOGTD("put share to %s, frame_%d", ref_frame->getName(), frame_cnt);
                 }
-                ref_put_map[ref_represent] = vx_true_e;
+                ref_put_map[ref_frame] = vx_true_e;
             }
         }
     }
@@ -602,6 +782,18 @@ ExynosVisionSubgraph::putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
             ref_clone ->decreaseKernelCount();
     }
 
+    for (ref_iter=m_internal_data_ref_list.begin(); ref_iter!=m_internal_data_ref_list.end(); ref_iter++) {
+        ExynosVisionDataReference* ref_internal = (*ref_iter).ref;
+        if ((*ref_iter).node->getKernelHandle()->getParamDirection((*ref_iter).node_index) == VX_INPUT)
+            continue;
+
+        ref_internal->decreaseKernelCount();
+        if (ref_internal->putOutputExclusiveRef(frame_cnt, data_valid) != VX_SUCCESS) {
+            VXLOGE("put exclusive ref fails");
+            status = VX_ERROR_INVALID_REFERENCE;
+        }
+    }
+
     for (ref_iter=m_output_data_ref_list.begin(); ref_iter!=m_output_data_ref_list.end(); ref_iter++) {
         ExynosVisionDataReference* ref_represent = (*ref_iter).ref;
 
@@ -609,22 +801,24 @@ ExynosVisionSubgraph::putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         if (ref_represent == NULL)
             continue;
 
+        ExynosVisionDataReference* ref_frame = getFrameDataRef(ref_represent, (*ref_iter).node, (*ref_iter).node_index);
+
         if ((exec_mode == GRAPH_EXEC_NORMAL) || (ref_represent->getDirectOutputNodeNum(m_graph) == 0)) {
-            if (ref_represent->putOutputExclusiveRef(frame_cnt, data_valid) != VX_SUCCESS) {
+            if (ref_frame->putOutputExclusiveRef(frame_cnt, data_valid) != VX_SUCCESS) {
                 VXLOGE("put exclusive ref fails");
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
-                VXLOGTD("put exclusive to %s, frame_%d", ref_represent->getName(), frame_cnt);
+                VXLOGTD("put exclusive to %s, frame_%d", ref_frame->getName(), frame_cnt);
             }
         } else {
-            if (ref_put_map[ref_represent] != vx_true_e) {
-                if (ref_represent->putOutputShareRef(frame_cnt, ref_represent->getDirectOutputNodeNum(m_graph), data_valid) != VX_SUCCESS) {
+            if (ref_put_map[ref_frame] != vx_true_e) {
+                if (ref_frame->putOutputShareRef(frame_cnt, ref_represent->getDirectOutputNodeNum(m_graph), data_valid) != VX_SUCCESS) {
                     VXLOGE("put share ref fails");
                     status = VX_ERROR_INVALID_REFERENCE;
                 } else {
-                    VXLOGTD("put share to %s, frame_%d", ref_represent->getName(), frame_cnt);
+                    VXLOGTD("put share to %s, frame_%d", ref_frame->getName(), frame_cnt);
                 }
-                ref_put_map[ref_represent] = vx_true_e;
+                ref_put_map[ref_frame] = vx_true_e;
             }
         }
     }
@@ -635,12 +829,15 @@ ExynosVisionSubgraph::putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
 }
 
 vx_status
-ExynosVisionSubgraph::sendDoneToPost(vx_uint32 frame_cnt)
+ExynosVisionSubgraph::sendDoneToPost(vx_uint32 frame_cnt, vx_bool data_valid)
 {
     VXLOGD2("send done, frame_%d", frame_cnt);
 
     if (isFooter()) {
-        m_complete_event->setEvent();
+        if (m_graph->getExecMode() == GRAPH_EXEC_PIPELINE)
+            m_graph->completePipelineFrame(frame_cnt, data_valid);
+        else
+            m_complete_event->setEvent();
     } else {
         List<ref_connect_info_t>::iterator ref_iter;
         for (ref_iter=m_output_data_ref_list.begin(); ref_iter!=m_output_data_ref_list.end(); ref_iter++) {
@@ -652,6 +849,62 @@ ExynosVisionSubgraph::sendDoneToPost(vx_uint32 frame_cnt)
     return VX_SUCCESS;
 }
 
+vx_status
+ExynosVisionSubgraph::acquireDelayRef(vx_uint32 frame_cnt)
+{
+    vx_status status = VX_SUCCESS;
+
+    m_cur_delay_data_ref_list.clear();
+
+    if (m_graph->getExecMode() != GRAPH_EXEC_PIPELINE)
+        return status;
+
+    /* the nodes keep the elements bound at verification, the elements of this frame are looked up */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (data_ref->isDelayElement() != vx_true_e))
+                continue;
+
+            ExynosVisionDataReference *frame_ref = data_ref->getDelay()->acquireFrameElement(node, p, frame_cnt);
+            if (frame_ref == NULL) {
+                VXLOGE("%s, cann't get element of %s, frame_%d", getSgName(), data_ref->getDelay()->getName(), frame_cnt);
+                return VX_ERROR_INVALID_REFERENCE;
+            }
+
+            ref_connect_info_t connect_info = {frame_ref, node, p};
+            m_cur_delay_data_ref_list.push_back(connect_info);
+        }
+    }
+
+    return status;
+}
+
+void
+ExynosVisionSubgraph::releaseDelayRef(vx_uint32 frame_cnt)
+{
+    List<ref_connect_info_t>::iterator ref_iter;
+    for (ref_iter=m_cur_delay_data_ref_list.begin(); ref_iter!=m_cur_delay_data_ref_list.end(); ref_iter++)
+        (*ref_iter).ref->getDelay()->releaseFrameElement((*ref_iter).node, (*ref_iter).node_index, frame_cnt);
+
+    m_cur_delay_data_ref_list.clear();
+}
+
+ExynosVisionDataReference*
+ExynosVisionSubgraph::getFrameDataRef(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index)
+{
+    List<ref_connect_info_t>::iterator ref_iter;
+    for (ref_iter=m_cur_delay_data_ref_list.begin(); ref_iter!=m_cur_delay_data_ref_list.end(); ref_iter++) {
+        if (((*ref_iter).node == node) && ((*ref_iter).node_index == node_index))
+            return (*ref_iter).ref;
+    }
+
+    return data_ref;
+}
+
 vx_status
 ExynosVisionSubgraph::flushWaitEvent()
 {
@@ -717,6 +970,8 @@ ExynosVisionSubgraph::mainThreadFunc(void)
     vx_status status = VX_FAILURE;
     vx_uint32 frame_cnt;
     graph_exec_mode_t exec_mode = m_graph->getExecMode();
+    ExynosVisionTraceRecorder *trace_recorder = m_graph->getContext()->getTraceRecorder();
+    vx_uint64 trace_start_time = 0;
 
     m_thread_state.setState(THREAD_STATE_WAIT_DONE);
     VXLOGTD("waiting message");
@@ -734,7 +989,16 @@ ExynosVisionSubgraph::mainThreadFunc(void)
 
     if (frame_cnt && status == VX_SUCCESS) {
         VXLOGTD("%s, start frame_%d", getSgName(), frame_cnt);
-        m_represent_node->informKernelStart(frame_cnt);
+        if (trace_recorder->isEnabled() == vx_true_e) {
+            trace_start_time = ExynosVisionDurationTimer::getTimeUs();
+            if (m_ready_push_time)
+                trace_recorder->record(TRACE_EVENT_SUBGRAPH_QUEUE_WAIT, getTraceId(), frame_cnt, m_ready_push_time, m_ready_pop_time);
+        }
+        m_ready_push_time = 0;
+
+        List<ExynosVisionNode*>::iterator node_iter;
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            (*node_iter)->informKernelStart(frame_cnt);
 
 #if (DISPLAY_PROCESS_GRAPH_TIME==1)
         uint64_t start_time, end_time;
@@ -743,8 +1007,15 @@ ExynosVisionSubgraph::mainThreadFunc(void)
 
         /* just handover frame count and error to next subgraph if the execution of previous subgraph fails */
         m_thread_state.setState(THREAD_STATE_GET_INPUT);
-        VXLOGTD("getSrcRef");
+        VXLOGTD("acquireDelayRef");
         vx_bool input_data_valid, output_data_valid;
+        status = acquireDelayRef(frame_cnt);
+        if (status != VX_SUCCESS) {
+            VXLOGE("%s failed to getting delay element", m_sg_name);
+            goto EXIT;
+        }
+
+        VXLOGTD("getSrcRef");
         status = getSrcRef(frame_cnt, exec_mode, &input_data_valid);
         if (status != VX_SUCCESS) {
             VXLOGE("%s failed to getting src ref", m_sg_name);
@@ -759,6 +1030,9 @@ ExynosVisionSubgraph::mainThreadFunc(void)
             goto EXIT;
         }
 
+        if (trace_start_time)
+            trace_recorder->record(TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT, getTraceId(), frame_cnt, trace_start_time, ExynosVisionDurationTimer::getTimeUs());
+
         if (input_data_valid == vx_true_e) {
             m_thread_state.setState(THREAD_STATE_EXE_KERNEL);
             VXLOGTD("kernelProcess start");
@@ -778,13 +1052,16 @@ ExynosVisionSubgraph::mainThreadFunc(void)
             VXLOGTD("kernelProcess end");
 
             /* node call back check */
-            if (m_represent_node->m_callback) {
-                vx_action action;
-                action = m_represent_node->m_callback((vx_node)m_represent_node);
-                if (action == VX_ACTION_ABANDON) {
-                    VXLOGE("abandon graph due to callback from %s", m_represent_node->getName());
-                    status = VX_ERROR_GRAPH_ABANDONED;
-                    goto EXIT;
+            for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+                ExynosVisionNode *node = *node_iter;
+                if (node->m_callback) {
+                    vx_action action;
+                    action = node->m_callback((vx_node)node);
+                    if (action == VX_ACTION_ABANDON) {
+                        VXLOGE("abandon graph due to callback from %s", node->getName());
+                        status = VX_ERROR_GRAPH_ABANDONED;
+                        goto EXIT;
+                    }
                 }
             }
         } else {
@@ -808,9 +1085,12 @@ ExynosVisionSubgraph::mainThreadFunc(void)
             goto EXIT;
         }
 
+        /* the frame is completed after all of its delay elements are given back */
+        releaseDelayRef(frame_cnt);
+
         m_thread_state.setState(THREAD_STATE_SEND_DONE);
         VXLOGTD("sendDoneToPost");
-        status = sendDoneToPost(frame_cnt);
+        status = sendDoneToPost(frame_cnt, output_data_valid);
         if (status != VX_SUCCESS) {
             VXLOGE("%s failed to send done event", m_sg_name);
             goto EXIT;
@@ -823,10 +1103,15 @@ ExynosVisionSubgraph::mainThreadFunc(void)
         VXLOGI("[SG] %llu us", end_time - start_time);
 #endif
 
-        m_represent_node->informKernelEnd(frame_cnt, status);
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            (*node_iter)->informKernelEnd(frame_cnt, status);
+
+        if (trace_start_time)
+            trace_recorder->record(TRACE_EVENT_SUBGRAPH_FRAME, getTraceId(), frame_cnt, trace_start_time, ExynosVisionDurationTimer::getTimeUs(), m_ready_cause_id);
     }
 
 EXIT:
+    releaseDelayRef(frame_cnt);
     m_exec_mutex.unlock();
 
     if (status == VX_SUCCESS) {
@@ -880,12 +1165,17 @@ ExynosVisionSubgraph::displayPerf(vx_uint32 tab_num, vx_bool detail_info)
     VXLOGI("%s[Subgrap][%d] represent node(%s, %s)", MAKE_TAB(tap, tab_num), detail_info,
         getSgName(), m_represent_node->getName(), m_represent_node->getKernelName());
 
-    vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(m_represent_node);
-    for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
-        VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
-        VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
-        VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
-        VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+    for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        if (*node_iter != m_represent_node)
+            VXLOGI("%s[Subgrap] fused node(%s, %s)", MAKE_TAB(tap, tab_num), (*node_iter)->getName(), (*node_iter)->getKernelName());
+
+        vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(*node_iter);
+        for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
+            VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
+            VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
+            VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
+            VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+        }
     }
 }
 
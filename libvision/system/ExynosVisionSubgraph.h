@@ -58,15 +58,23 @@ typedef struct _subgraph_message_t {
     vx_int32		frame_cnt;
 
     ExynosVisionDataReference   *done_reference;
+    ExynosVisionNode    *done_node;
     vx_uint32 node_index;
+
+    /* stamped only while tracing */
+    vx_uint64 push_time;
 } subgraph_message_t;
 
 typedef ExynosVisionQueue<subgraph_message_t> sg_msg_queue_t;
 
+/* done events of input ports are gathered in a 32-bit mask */
+#define MAX_SUBGRAPH_INPUT_PORT_NUM 32
+
 class ExynosVisionSubgraph {
 
 typedef struct _ref_connect_info_t {
     ExynosVisionDataReference *ref;
+    ExynosVisionNode *node;
     vx_uint32 node_index;
 } ref_connect_info_t;
 
@@ -78,8 +86,9 @@ private:
 
     /* represented node, it will be generated from dynamic kernel */
     ExynosVisionNode* m_represent_node;
-    /* list of all nodes including subgraph */
+    /* list of all nodes including subgraph, in execution order */
     List<ExynosVisionNode*> m_node_list;
+    ExynosVisionNode* m_tail_node;
 
     sg_msg_queue_t *m_message_queue;
     Mutex m_exec_mutex;
@@ -94,30 +103,46 @@ private:
     List<ref_connect_info_t> m_input_data_ref_list;
     List<ref_connect_info_t> m_output_data_ref_list;
 
+    /* references written and read only by the nodes of this subgraph */
+    List<ref_connect_info_t> m_internal_data_ref_list;
+
     /* instance data reference list for single frame */
     List<ref_connect_info_t> m_cur_input_data_ref_list;
     List<ref_connect_info_t> m_cur_output_data_ref_list;
-
-    ExynosVisionDataReference **m_params;
-    vx_uint32 m_param_num;
+    /* delay elements of the frame in pipeline mode, in place of the bound elements */
+    List<ref_connect_info_t> m_cur_delay_data_ref_list;
 
     ExynosVisionEvent *m_complete_event;
 
     vx_uint32 m_last_process_frame;
 
+    /* id in the trace recorder of the context, given at the first record */
+    std::atomic<vx_uint32> m_trace_id;
+    /* the message that made the frame ready, while tracing */
+    vx_uint64 m_ready_push_time;
+    vx_uint64 m_ready_pop_time;
+    vx_uint32 m_ready_cause_id;
+
 public:
 
 private:
     bool mainThreadFunc(void);
     queue_exception_t popDoneEvent(vx_uint32 *ret_frame_cnt);
+    void traceReadyMessage(subgraph_message_t *sg_msg);
 
     vx_status getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid);
     vx_status getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
     vx_status kernelProcess(vx_uint32 frame_cnt);
+    void setKernelParams(ExynosVisionNode *node, List<ref_connect_info_t> *data_ref_list, const ExynosVisionDataReference **params);
     vx_status putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
     vx_status putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid);
-    vx_status sendDoneToPost(vx_uint32 frame_cnt);
+    vx_status sendDoneToPost(vx_uint32 frame_cnt, vx_bool data_valid);
 
+    vx_status acquireDelayRef(vx_uint32 frame_cnt);
+    void releaseDelayRef(vx_uint32 frame_cnt);
+    ExynosVisionDataReference* getFrameDataRef(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index);
+
+    vx_bool isInternalDataRef(ExynosVisionDataReference *data_ref);
     vx_status makeInputOutputPort(void);
     vx_status allocateDataRefMemory(void);
 
@@ -130,11 +155,13 @@ public:
     virtual ~ExynosVisionSubgraph();
 
     vx_status init(ExynosVisionNode *node);
+    /* fuse the node that consumes outputs of the tail node */
+    vx_status addNode(ExynosVisionNode *node);
     vx_status destroy(void);
 
     vx_status fixSubgraph(void);
 
-    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index);
+    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index);
 
     vx_bool isHeader(void)
     {
@@ -142,8 +169,17 @@ public:
     }
     vx_bool isFooter(void)
     {
-        return m_represent_node->isFooter();
+        return m_tail_node->isFooter();
+    }
+    ExynosVisionNode* getTailNode(void)
+    {
+        return m_tail_node;
+    }
+    vx_uint32 getNodeNum(void)
+    {
+        return m_node_list.size();
     }
+    vx_uint32 getInputDataRefNum(void);
     vx_uint32 getId()
     {
         return m_id;
@@ -152,11 +188,12 @@ public:
     {
         return m_sg_name;
     }
+    vx_uint32 getTraceId(void);
 
     /* push start signal to subgraph, all input data reference should be exclusive */
     vx_status pushTrigger(vx_uint32 frame_cnt);
     /* push doen event to subgraph, each input data reference send done event individually */
-    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index);
+    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index);
 
     vx_status clearSubgraphComplete(void);
     vx_status waitSubgraphComplete(vx_uint64 wait_time);
@@ -164,7 +201,7 @@ public:
     vx_status flushWaitEvent();
     vx_status exitThread();
 
-    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir);
+    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir);
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
     virtual void displayPerf(vx_uint32 tab_num, vx_bool detail_info);
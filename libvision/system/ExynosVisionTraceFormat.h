@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_TRACE_FORMAT_H
+#define EXYNOS_VISION_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+/*
+ * Binary trace dump, it's read by the host tool as well.
+ * header, object_num x trace_object_t, record_num x trace_record_t, all little endian.
+ */
+
+#define TRACE_FILE_MAGIC        0x52545645  /* "EVTR" */
+#define TRACE_FILE_VERSION      1
+
+#define TRACE_OBJECT_NAME_SIZE  64
+
+enum trace_object_kind {
+    TRACE_OBJECT_GRAPH = 1,
+    TRACE_OBJECT_SUBGRAPH = 2,
+    TRACE_OBJECT_NODE = 3
+};
+
+enum trace_event_type {
+    /* the graph from issuing a frame to its completion */
+    TRACE_EVENT_GRAPH_FRAME = 1,
+    /* the subgraph from the frame being ready to the done event to the next subgraphs */
+    TRACE_EVENT_SUBGRAPH_FRAME = 2,
+    /* the message that made the frame ready, from pushed to popped */
+    TRACE_EVENT_SUBGRAPH_QUEUE_WAIT = 3,
+    /* getting the delay, input and output references of the frame */
+    TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT = 4,
+    /* the kernel function of the node, fused nodes of a subgraph run one after another */
+    TRACE_EVENT_NODE_EXECUTE = 5,
+    /* the time pairs of the node */
+    TRACE_EVENT_NODE_FRAMEWORK = 6,
+    TRACE_EVENT_NODE_KERNEL = 7,
+    TRACE_EVENT_NODE_FIRMWARE = 8
+};
+
+typedef struct _trace_file_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t object_num;
+    uint32_t record_num;
+    /* records lost because the ring wrapped */
+    uint64_t dropped_num;
+} trace_file_header_t;
+
+typedef struct _trace_object_t {
+    uint32_t id;
+    uint32_t kind;
+    /* the graph of a subgraph, the subgraph of a node */
+    uint32_t parent_id;
+    uint32_t reserved;
+    char name[TRACE_OBJECT_NAME_SIZE];
+} trace_object_t;
+
+typedef struct _trace_record_t {
+    uint32_t type;
+    uint32_t object_id;
+    uint32_t frame;
+    /* subgraph frame: the subgraph whose output made the frame ready, or the graph for a trigger */
+    uint32_t cause_id;
+    uint64_t start_us;
+    uint64_t end_us;
+} trace_record_t;
+
+#endif
@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosVisionTraceRecorder"
+#include <cutils/log.h>
+
+#include "ExynosVisionCommonConfig.h"
+#include "ExynosVisionTraceRecorder.h"
+
+namespace android {
+
+static const char *getEventName(vx_uint32 type)
+{
+    switch (type) {
+    case TRACE_EVENT_SUBGRAPH_QUEUE_WAIT:
+        return "queue wait";
+    case TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT:
+        return "resource wait";
+    default:
+        return NULL;
+    }
+}
+
+static const char *getEventCategory(vx_uint32 type)
+{
+    switch (type) {
+    case TRACE_EVENT_GRAPH_FRAME:
+        return "graph";
+    case TRACE_EVENT_SUBGRAPH_FRAME:
+        return "subgraph";
+    case TRACE_EVENT_SUBGRAPH_QUEUE_WAIT:
+    case TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT:
+        return "wait";
+    case TRACE_EVENT_NODE_EXECUTE:
+        return "node";
+    case TRACE_EVENT_NODE_FRAMEWORK:
+        return "node.framework";
+    case TRACE_EVENT_NODE_KERNEL:
+        return "node.kernel";
+    case TRACE_EVENT_NODE_FIRMWARE:
+        return "node.firmware";
+    default:
+        return "unknown";
+    }
+}
+
+/* names are written in JSON strings */
+static void writeJsonString(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (; *str; str++) {
+        if ((*str == '"') || (*str == '\\'))
+            fputc('\\', fp);
+        if ((unsigned char)*str >= 0x20)
+            fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+ExynosVisionTraceRecorder::ExynosVisionTraceRecorder(void)
+{
+    m_enabled = false;
+    m_slot = NULL;
+    m_capacity = DEFAULT_TRACE_RECORD_NUM;
+    m_write_pos = 0;
+}
+
+ExynosVisionTraceRecorder::~ExynosVisionTraceRecorder(void)
+{
+    if (m_slot)
+        delete[] m_slot;
+}
+
+vx_status
+ExynosVisionTraceRecorder::setEnable(vx_bool enable)
+{
+    Mutex::Autolock lock(m_object_mutex);
+
+    if ((enable == vx_true_e) && (m_slot == NULL)) {
+        m_slot = new trace_slot_t[m_capacity];
+        for (vx_uint32 i = 0; i < m_capacity; i++)
+            m_slot[i].sequence.store(0, std::memory_order_relaxed);
+    }
+
+    m_enabled.store(enable == vx_true_e, std::memory_order_release);
+
+    return VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionTraceRecorder::setCapacity(vx_uint32 record_num)
+{
+    Mutex::Autolock lock(m_object_mutex);
+
+    /* a record could be being written into the ring */
+    if (m_slot != NULL) {
+        VXLOGE("the record number can't be changed after tracing is enabled");
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    if (record_num == 0)
+        return VX_ERROR_INVALID_VALUE;
+
+    m_capacity = 1;
+    while (m_capacity < record_num)
+        m_capacity <<= 1;
+
+    return VX_SUCCESS;
+}
+
+vx_uint32
+ExynosVisionTraceRecorder::getObjectId(std::atomic<vx_uint32> *id, enum trace_object_kind kind, const vx_char *name, vx_uint32 parent_id)
+{
+    vx_uint32 object_id = id->load(std::memory_order_acquire);
+    if (object_id)
+        return object_id;
+
+    Mutex::Autolock lock(m_object_mutex);
+
+    object_id = id->load(std::memory_order_relaxed);
+    if (object_id)
+        return object_id;
+
+    if (m_object_vector.size() >= MAX_TRACE_OBJECT_NUM)
+        return 0;
+
+    trace_object_t object;
+    memset(&object, 0x0, sizeof(object));
+    object.id = m_object_vector.size() + 1;
+    object.kind = kind;
+    object.parent_id = parent_id;
+    strncpy(object.name, name, TRACE_OBJECT_NAME_SIZE - 1);
+    m_object_vector.push_back(object);
+
+    id->store(object.id, std::memory_order_release);
+
+    return object.id;
+}
+
+void
+ExynosVisionTraceRecorder::record(enum trace_event_type type, vx_uint32 object_id, vx_uint32 frame, vx_uint64 start_us, vx_uint64 end_us, vx_uint32 cause_id)
+{
+    if (!m_enabled.load(std::memory_order_acquire))
+        return;
+
+    vx_uint64 pos = m_write_pos.fetch_add(1, std::memory_order_relaxed);
+    trace_slot_t *slot = &m_slot[pos & (m_capacity - 1)];
+
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->record.type = type;
+    slot->record.object_id = object_id;
+    slot->record.frame = frame;
+    slot->record.cause_id = cause_id;
+    slot->record.start_us = start_us;
+    slot->record.end_us = end_us;
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+vx_uint32
+ExynosVisionTraceRecorder::snapshot(Vector<trace_record_t> *record_vector, vx_uint64 *ret_dropped_num)
+{
+    vx_uint64 write_pos = m_write_pos.load(std::memory_order_acquire);
+    vx_uint64 begin_pos = (write_pos > m_capacity) ? (write_pos - m_capacity) : 0;
+
+    *ret_dropped_num = begin_pos;
+    if (m_slot == NULL)
+        return 0;
+
+    record_vector->setCapacity(write_pos - begin_pos);
+
+    /* a record that is overwritten while it's copied is skipped */
+    for (vx_uint64 pos = begin_pos; pos < write_pos; pos++) {
+        trace_slot_t *slot = &m_slot[pos & (m_capacity - 1)];
+
+        if (slot->sequence.load(std::memory_order_acquire) != pos + 1)
+            continue;
+
+        trace_record_t record = slot->record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot->sequence.load(std::memory_order_relaxed) != pos + 1)
+            continue;
+
+        record_vector->push_back(record);
+    }
+
+    return record_vector->size();
+}
+
+vx_status
+ExynosVisionTraceRecorder::exportChromeJson(FILE *fp, Vector<trace_record_t> *record_vector)
+{
+    vx_bool first = vx_true_e;
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    /* a graph is a process and its subgraphs are threads, graph frames are on the thread of the graph id */
+    for (vx_uint32 i = 0; i < m_object_vector.size(); i++) {
+        const trace_object_t &object = m_object_vector[i];
+
+        if (object.kind == TRACE_OBJECT_NODE)
+            continue;
+
+        if (first == vx_false_e)
+            fprintf(fp, ",\n");
+        first = vx_false_e;
+
+        if (object.kind == TRACE_OBJECT_GRAPH) {
+            fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":", object.id);
+            writeJsonString(fp, object.name);
+            fprintf(fp, "}},\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"frames\"}}",
+                        object.id, object.id);
+        } else {
+            fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":", object.parent_id, object.id);
+            writeJsonString(fp, object.name);
+            fprintf(fp, "}}");
+        }
+    }
+
+    for (vx_uint32 i = 0; i < record_vector->size(); i++) {
+        const trace_record_t &record = record_vector->itemAt(i);
+
+        if ((record.object_id == 0) || (record.object_id > m_object_vector.size()))
+            continue;
+
+        const trace_object_t &object = m_object_vector[record.object_id - 1];
+        vx_uint32 tid = object.id;
+        vx_uint32 pid = object.parent_id;
+
+        if (object.kind == TRACE_OBJECT_GRAPH) {
+            pid = object.id;
+        } else if ((object.kind == TRACE_OBJECT_NODE) && (object.parent_id) && (object.parent_id <= m_object_vector.size())) {
+            tid = object.parent_id;
+            pid = m_object_vector[object.parent_id - 1].parent_id;
+        }
+
+        const char *name = getEventName(record.type);
+
+        if (first == vx_false_e)
+            fprintf(fp, ",\n");
+        first = vx_false_e;
+
+        fprintf(fp, "{\"name\":");
+        writeJsonString(fp, name ? name : object.name);
+        fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%u,\"tid\":%u,\"args\":{\"frame\":%u",
+                    getEventCategory(record.type), (unsigned long long)record.start_us,
+                    (unsigned long long)((record.end_us > record.start_us) ? (record.end_us - record.start_us) : 0),
+                    pid, tid, record.frame);
+        if ((record.cause_id) && (record.cause_id <= m_object_vector.size())) {
+            fprintf(fp, ",\"cause\":");
+            writeJsonString(fp, m_object_vector[record.cause_id - 1].name);
+        }
+        fprintf(fp, "}}");
+    }
+
+    fprintf(fp, "\n]}\n");
+
+    return ferror(fp) ? VX_FAILURE : VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionTraceRecorder::exportBinary(FILE *fp, Vector<trace_record_t> *record_vector, vx_uint64 dropped_num)
+{
+    trace_file_header_t header;
+    header.magic = TRACE_FILE_MAGIC;
+    header.version = TRACE_FILE_VERSION;
+    header.object_num = m_object_vector.size();
+    header.record_num = record_vector->size();
+    header.dropped_num = dropped_num;
+
+    if (fwrite(&header, sizeof(header), 1, fp) != 1)
+        return VX_FAILURE;
+
+    if ((header.object_num) && (fwrite(m_object_vector.array(), sizeof(trace_object_t), header.object_num, fp) != header.object_num))
+        return VX_FAILURE;
+
+    if ((header.record_num) && (fwrite(record_vector->array(), sizeof(trace_record_t), header.record_num, fp) != header.record_num))
+        return VX_FAILURE;
+
+    return VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionTraceRecorder::exportTrace(vx_enum format, const vx_char *path)
+{
+    vx_status status = VX_SUCCESS;
+
+    if ((format != VX_TRACE_FORMAT_CHROME_JSON) && (format != VX_TRACE_FORMAT_BINARY)) {
+        VXLOGE("unknown trace format:0x%x", format);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    FILE *fp = fopen(path, (format == VX_TRACE_FORMAT_BINARY) ? "wb" : "w");
+    if (fp == NULL) {
+        VXLOGE("can't open %s", path);
+        return VX_FAILURE;
+    }
+
+    /* recording goes on while the ring is copied, objects are registered under the lock */
+    Vector<trace_record_t> record_vector;
+    vx_uint64 dropped_num;
+
+    Mutex::Autolock lock(m_object_mutex);
+
+    snapshot(&record_vector, &dropped_num);
+    if (dropped_num)
+        VXLOGD("%llu trace records are overwritten", dropped_num);
+
+    if (format == VX_TRACE_FORMAT_BINARY)
+        status = exportBinary(fp, &record_vector, dropped_num);
+    else
+        status = exportChromeJson(fp, &record_vector);
+
+    if (status != VX_SUCCESS)
+        VXLOGE("writing trace to %s fails", path);
+
+    fclose(fp);
+
+    return status;
+}
+
+}; // namespace android
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_TRACE_RECORDER_H
+#define EXYNOS_VISION_TRACE_RECORDER_H
+
+#include <stdio.h>
+#include <atomic>
+
+#include <utils/Mutex.h>
+#include <utils/Vector.h>
+
+#include <VX/vx.h>
+
+#include "ExynosVisionTraceFormat.h"
+
+#define DEFAULT_TRACE_RECORD_NUM    16384
+#define MAX_TRACE_OBJECT_NUM        4096
+
+namespace android {
+
+/*
+ * Timing records of graphs, subgraphs and nodes in a preallocated ring, exported as a
+ * Chrome trace-event JSON or as the binary dump of ExynosVisionTraceFormat.h.
+ * Recording is skipped with a single relaxed load while tracing is disabled.
+ */
+class ExynosVisionTraceRecorder {
+private:
+    typedef struct _trace_slot_t {
+        /* position + 1 after the record is written, 0 while it's being written */
+        std::atomic<vx_uint64> sequence;
+        trace_record_t record;
+    } trace_slot_t;
+
+    std::atomic<bool> m_enabled;
+
+    /* the ring is allocated at the first enabling and kept until the recorder is destroyed */
+    trace_slot_t *m_slot;
+    vx_uint32 m_capacity;
+    std::atomic<vx_uint64> m_write_pos;
+
+    /* id of an object is its index + 1 */
+    Mutex m_object_mutex;
+    Vector<trace_object_t> m_object_vector;
+
+private:
+    vx_uint32 snapshot(Vector<trace_record_t> *record_vector, vx_uint64 *ret_dropped_num);
+    vx_status exportChromeJson(FILE *fp, Vector<trace_record_t> *record_vector);
+    vx_status exportBinary(FILE *fp, Vector<trace_record_t> *record_vector, vx_uint64 dropped_num);
+
+public:
+    /* Constructor */
+    ExynosVisionTraceRecorder(void);
+
+    /* Destructor */
+    virtual ~ExynosVisionTraceRecorder(void);
+
+    vx_status setEnable(vx_bool enable);
+    vx_bool isEnabled(void)
+    {
+        return m_enabled.load(std::memory_order_relaxed) ? vx_true_e : vx_false_e;
+    }
+
+    /* the record number can be changed only before tracing is enabled at first, it's rounded up to a power of two */
+    vx_status setCapacity(vx_uint32 record_num);
+    vx_uint32 getCapacity(void)
+    {
+        return m_capacity;
+    }
+
+    /* registers the object at its first record, 0 if too many objects are registered */
+    vx_uint32 getObjectId(std::atomic<vx_uint32> *id, enum trace_object_kind kind, const vx_char *name, vx_uint32 parent_id);
+
+    void record(enum trace_event_type type, vx_uint32 object_id, vx_uint32 frame, vx_uint64 start_us, vx_uint64 end_us, vx_uint32 cause_id = 0);
+
+    vx_status exportTrace(vx_enum format, const vx_char *path);
+};
+
+}; // namespace android
+#endif
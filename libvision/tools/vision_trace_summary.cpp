@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * vision_trace_summary
+ *
+ * Summarizes a binary trace of vxExportContextTrace(VX_TRACE_FORMAT_BINARY).
+ * For each graph it prints the frame latency, the critical paths of the frames
+ * and how much of the frame latency each subgraph and node takes.
+ *
+ * The critical path of a frame starts at the output subgraph that finished last
+ * and follows, subgraph by subgraph, the one whose output made the frame ready.
+ *
+ * vision_trace_summary <trace file> [--paths N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ExynosVisionTraceFormat.h"
+
+using namespace std;
+
+struct duration_stat {
+    vector<uint64_t> values;
+    uint64_t sum;
+
+    duration_stat() : sum(0) {}
+
+    void add(uint64_t value)
+    {
+        values.push_back(value);
+        sum += value;
+    }
+
+    double avgMs(void) const
+    {
+        return values.empty() ? 0.0 : (double)sum / values.size() / 1000.0;
+    }
+
+    /* nearest rank */
+    double percentileMs(double percent)
+    {
+        if (values.empty())
+            return 0.0;
+
+        sort(values.begin(), values.end());
+        size_t rank = (size_t)(percent / 100.0 * values.size() + 0.5);
+        rank = (rank == 0) ? 0 : min(rank - 1, values.size() - 1);
+
+        return values[rank] / 1000.0;
+    }
+};
+
+struct trace_dump {
+    trace_file_header_t header;
+    map<uint32_t, trace_object_t> objects;
+    vector<trace_record_t> records;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s <trace file> [--paths N]\n"
+            "  <trace file>  written by vxExportContextTrace with VX_TRACE_FORMAT_BINARY\n"
+            "  --paths       number of the most frequent critical paths to print, 3 by default\n",
+            prog);
+}
+
+static bool readDump(const char *path, trace_dump *dump)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    bool ret = false;
+    trace_object_t object;
+
+    if (fread(&dump->header, sizeof(dump->header), 1, fp) != 1) {
+        fprintf(stderr, "%s is too short\n", path);
+        goto EXIT;
+    }
+
+    if ((dump->header.magic != TRACE_FILE_MAGIC) || (dump->header.version != TRACE_FILE_VERSION)) {
+        fprintf(stderr, "%s isn't a trace of version %d\n", path, TRACE_FILE_VERSION);
+        goto EXIT;
+    }
+
+    for (uint32_t i = 0; i < dump->header.object_num; i++) {
+        if (fread(&object, sizeof(object), 1, fp) != 1) {
+            fprintf(stderr, "object %u of %s is truncated\n", i, path);
+            goto EXIT;
+        }
+        object.name[TRACE_OBJECT_NAME_SIZE - 1] = '\0';
+        dump->objects[object.id] = object;
+    }
+
+    dump->records.resize(dump->header.record_num);
+    if ((dump->header.record_num) &&
+        (fread(&dump->records[0], sizeof(trace_record_t), dump->header.record_num, fp) != dump->header.record_num)) {
+        fprintf(stderr, "records of %s are truncated\n", path);
+        goto EXIT;
+    }
+
+    ret = true;
+
+EXIT:
+    fclose(fp);
+    return ret;
+}
+
+static const char *getName(trace_dump *dump, uint32_t id)
+{
+    map<uint32_t, trace_object_t>::iterator iter = dump->objects.find(id);
+
+    return (iter != dump->objects.end()) ? iter->second.name : "unknown";
+}
+
+/* the graph of a subgraph or a node, 0 if it's unknown */
+static uint32_t getGraphId(trace_dump *dump, uint32_t id)
+{
+    for (int depth = 0; depth < 3; depth++) {
+        map<uint32_t, trace_object_t>::iterator iter = dump->objects.find(id);
+        if (iter == dump->objects.end())
+            return 0;
+        if (iter->second.kind == TRACE_OBJECT_GRAPH)
+            return id;
+        id = iter->second.parent_id;
+    }
+
+    return 0;
+}
+
+static void summarizeGraph(trace_dump *dump, uint32_t graph_id, uint32_t path_num)
+{
+    duration_stat frame_stat;
+    /* subgraph frame events of each frame */
+    map<uint32_t, map<uint32_t, const trace_record_t*> > sg_frame_map;
+    map<uint32_t, duration_stat> sg_stat, queue_stat, resource_stat, node_stat;
+    map<uint32_t, uint32_t> sg_critical_cnt;
+    map<string, uint32_t> path_cnt;
+
+    for (size_t i = 0; i < dump->records.size(); i++) {
+        const trace_record_t *record = &dump->records[i];
+        uint64_t duration = (record->end_us > record->start_us) ? (record->end_us - record->start_us) : 0;
+
+        if (getGraphId(dump, record->object_id) != graph_id)
+            continue;
+
+        switch (record->type) {
+        case TRACE_EVENT_GRAPH_FRAME:
+            frame_stat.add(duration);
+            break;
+        case TRACE_EVENT_SUBGRAPH_FRAME:
+            sg_stat[record->object_id].add(duration);
+            sg_frame_map[record->frame][record->object_id] = record;
+            break;
+        case TRACE_EVENT_SUBGRAPH_QUEUE_WAIT:
+            queue_stat[record->object_id].add(duration);
+            break;
+        case TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT:
+            resource_stat[record->object_id].add(duration);
+            break;
+        case TRACE_EVENT_NODE_EXECUTE:
+            node_stat[record->object_id].add(duration);
+            break;
+        default:
+            break;
+        }
+    }
+
+    map<uint32_t, map<uint32_t, const trace_record_t*> >::iterator frame_iter;
+    for (frame_iter = sg_frame_map.begin(); frame_iter != sg_frame_map.end(); frame_iter++) {
+        map<uint32_t, const trace_record_t*> &sg_record = frame_iter->second;
+        const trace_record_t *last = NULL;
+        map<uint32_t, bool> is_cause;
+
+        map<uint32_t, const trace_record_t*>::iterator sg_iter;
+        for (sg_iter = sg_record.begin(); sg_iter != sg_record.end(); sg_iter++)
+            is_cause[sg_iter->second->cause_id] = true;
+
+        /* an upstream subgraph can finish its done event after the outputs, so only the outputs are compared */
+        for (sg_iter = sg_record.begin(); sg_iter != sg_record.end(); sg_iter++) {
+            if (is_cause.count(sg_iter->first))
+                continue;
+            if ((last == NULL) || (sg_iter->second->end_us > last->end_us))
+                last = sg_iter->second;
+        }
+
+        /* walk back from the last subgraph, a subgraph can appear only once */
+        vector<uint32_t> path;
+        while ((last != NULL) && (path.size() <= sg_record.size())) {
+            path.push_back(last->object_id);
+            sg_iter = sg_record.find(last->cause_id);
+            last = (sg_iter != sg_record.end()) ? sg_iter->second : NULL;
+        }
+
+        string path_name;
+        for (size_t i = path.size(); i > 0; i--) {
+            sg_critical_cnt[path[i - 1]]++;
+            path_name += getName(dump, path[i - 1]);
+            if (i > 1)
+                path_name += " -> ";
+        }
+        path_cnt[path_name]++;
+    }
+
+    printf("graph %s\n", getName(dump, graph_id));
+    printf("  frames: %zu, latency avg %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           frame_stat.values.size(), frame_stat.avgMs(), frame_stat.percentileMs(50),
+           frame_stat.percentileMs(90), frame_stat.percentileMs(99), frame_stat.percentileMs(100));
+
+    double frame_avg = frame_stat.avgMs();
+
+    vector<pair<uint32_t, string> > sorted_path;
+    map<string, uint32_t>::iterator path_iter;
+    for (path_iter = path_cnt.begin(); path_iter != path_cnt.end(); path_iter++)
+        sorted_path.push_back(make_pair(path_iter->second, path_iter->first));
+    sort(sorted_path.rbegin(), sorted_path.rend());
+
+    printf("  critical paths of %zu frames:\n", sg_frame_map.size());
+    for (size_t i = 0; (i < sorted_path.size()) && (i < path_num); i++)
+        printf("    %5u  %s\n", sorted_path[i].first, sorted_path[i].second.c_str());
+
+    printf("  %-32s %10s %7s %10s %10s %9s\n", "subgraph", "avg ms", "share", "queue ms", "wait ms", "critical");
+    map<uint32_t, duration_stat>::iterator stat_iter;
+    for (stat_iter = sg_stat.begin(); stat_iter != sg_stat.end(); stat_iter++) {
+        uint32_t id = stat_iter->first;
+        double avg = stat_iter->second.avgMs();
+
+        printf("  %-32s %10.3f %6.1f%% %10.3f %10.3f %8.1f%%\n", getName(dump, id), avg,
+               frame_avg ? (avg / frame_avg * 100.0) : 0.0, queue_stat[id].avgMs(), resource_stat[id].avgMs(),
+               sg_frame_map.empty() ? 0.0 : (sg_critical_cnt[id] * 100.0 / sg_frame_map.size()));
+    }
+
+    printf("  %-32s %10s %7s %9s\n", "node", "avg ms", "share", "runs");
+    for (stat_iter = node_stat.begin(); stat_iter != node_stat.end(); stat_iter++) {
+        double avg = stat_iter->second.avgMs();
+
+        printf("  %-32s %10.3f %6.1f%% %9zu\n", getName(dump, stat_iter->first), avg,
+               frame_avg ? (avg / frame_avg * 100.0) : 0.0, stat_iter->second.values.size());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    uint32_t path_num = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--paths") == 0) && (i + 1 < argc)) {
+            path_num = atoi(argv[++i]);
+        } else if ((argv[i][0] != '-') && (path == NULL)) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (path == NULL) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    trace_dump dump;
+    if (!readDump(path, &dump))
+        return 1;
+
+    printf("%u records, %llu dropped\n", dump.header.record_num, (unsigned long long)dump.header.dropped_num);
+
+    map<uint32_t, trace_object_t>::iterator iter;
+    for (iter = dump.objects.begin(); iter != dump.objects.end(); iter++) {
+        if (iter->second.kind == TRACE_OBJECT_GRAPH)
+            summarizeGraph(&dump, iter->first, path_num);
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../include \
+	$(LOCAL_PATH)/../system \
+	$(LOCAL_PATH)/
+
+LOCAL_SRC_FILES:= \
+	./SoftwareKernels.cpp \
+	./GraphFusionTest.cpp \
+	./ImmediateGraphCacheTest.cpp \
+	./PipelineGraphTest.cpp \
+	./QueuePoolTest.cpp \
+	./TraceExportTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynosvision_unittest
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../include \
+	$(LOCAL_PATH)/../system \
+	$(LOCAL_PATH)/
+
+LOCAL_SRC_FILES:= \
+	./SoftwareKernels.cpp \
+	./GraphFusionBenchmark.cpp \
+	./ImmediateGraphCacheBenchmark.cpp \
+	./PipelineGraphBenchmark.cpp \
+	./QueuePoolBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynosvision_benchmark
+
+include $(BUILD_NATIVE_BENCHMARK)
+
+# SCore kernels on the in-process device emulator, host targets.
+# EMULATOR takes the memory from memfd, so libion is not needed.
+SCORE_EMULATOR_PATH := ../kernel/score
+
+SCORE_EMULATOR_SRC_FILES := \
+	$(SCORE_EMULATOR_PATH)/core/score.cpp \
+	$(SCORE_EMULATOR_PATH)/core/score_command.cpp \
+	$(SCORE_EMULATOR_PATH)/core/score_core.cpp \
+	$(SCORE_EMULATOR_PATH)/core/score_device_emulator.cpp \
+	$(SCORE_EMULATOR_PATH)/core/score_emulator_kernel.cpp \
+	$(SCORE_EMULATOR_PATH)/core/score_send_packet.cpp \
+	$(SCORE_EMULATOR_PATH)/memory/score_ion_memory_manager.cpp \
+	$(SCORE_EMULATOR_PATH)/memory/score_memory.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_And.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_FastCorners.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_CannyEdgeDetector.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_TableLookup.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_Histogram.cpp \
+	$(SCORE_EMULATOR_PATH)/scv/scv_Convolution.cpp
+
+SCORE_EMULATOR_C_INCLUDES := \
+	$(LOCAL_PATH)/../include \
+	$(LOCAL_PATH)/../common \
+	$(LOCAL_PATH)/../system \
+	$(LOCAL_PATH)/../utils \
+	$(LOCAL_PATH)/$(SCORE_EMULATOR_PATH) \
+	$(LOCAL_PATH)/$(SCORE_EMULATOR_PATH)/api \
+	$(LOCAL_PATH)/$(SCORE_EMULATOR_PATH)/include
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_CFLAGS += -DEMULATOR
+
+LOCAL_C_INCLUDES += $(SCORE_EMULATOR_C_INCLUDES)
+
+LOCAL_SRC_FILES:= \
+	$(SCORE_EMULATOR_SRC_FILES) \
+	./ScoreEmulatorTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynosscorekernel_emulator_unittest
+
+include $(BUILD_HOST_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_CFLAGS += -DEMULATOR
+
+LOCAL_C_INCLUDES += $(SCORE_EMULATOR_C_INCLUDES)
+
+LOCAL_SRC_FILES:= \
+	$(SCORE_EMULATOR_SRC_FILES) \
+	./ScoreEmulatorBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynosscorekernel_emulator_benchmark
+
+include $(BUILD_HOST_NATIVE_BENCHMARK)
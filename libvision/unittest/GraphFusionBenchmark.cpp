@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Per-frame latency of a chain of software nodes connected by virtual
+ * images, with node fusion off (fusion:0) and on (fusion:1).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <VX/vx.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+static void BM_ProcessChain(benchmark::State &state)
+{
+    const vx_uint32 width = state.range(0);
+    const vx_uint32 height = state.range(1);
+    const vx_uint32 chain_len = state.range(2);
+    vx_bool fusion = state.range(3) ? vx_true_e : vx_false_e;
+
+    vx_context context = vxCreateContext();
+    vx_kernel kernel = addSwAddOneKernel(context, SW_TARGET_NAME);
+    vx_graph graph = vxCreateGraph(context);
+    vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_NODE_FUSION, &fusion, sizeof(fusion));
+
+    vx_image input = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_image output = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    std::vector<vx_image> images;
+    std::vector<vx_node> nodes;
+    vx_image prev = input;
+
+    for (vx_uint32 i = 0; i < chain_len; i++) {
+        vx_image next = output;
+        if (i + 1 < chain_len) {
+            next = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
+            images.push_back(next);
+        }
+
+        vx_node node = vxCreateGenericNode(graph, kernel);
+        vxSetParameterByIndex(node, 0, (vx_reference)prev);
+        vxSetParameterByIndex(node, 1, (vx_reference)next);
+        nodes.push_back(node);
+        prev = next;
+    }
+
+    if (vxVerifyGraph(graph) != VX_SUCCESS) {
+        state.SkipWithError("vxVerifyGraph failed");
+    } else {
+        std::vector<double> samples;
+        fillImage(input, 0);
+
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+            vx_status status = vxProcessGraph(graph);
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (status != VX_SUCCESS) {
+                state.SkipWithError("vxProcessGraph failed");
+                break;
+            }
+            samples.push_back(elapsed.count());
+            state.SetIterationTime(elapsed.count() / 1e9);
+        }
+
+        if (!samples.empty()) {
+            std::sort(samples.begin(), samples.end());
+            state.counters["p50_ns"] = samples[samples.size() / 2];
+            state.counters["p99_ns"] = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        }
+        state.SetBytesProcessed(state.iterations() * width * height * chain_len);
+    }
+
+    for (vx_uint32 i = 0; i < nodes.size(); i++)
+        vxReleaseNode(&nodes[i]);
+    for (vx_uint32 i = 0; i < images.size(); i++)
+        vxReleaseImage(&images[i]);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+    vxReleaseGraph(&graph);
+    vxReleaseKernel(&kernel);
+    vxReleaseContext(&context);
+}
+BENCHMARK(BM_ProcessChain)
+    ->ArgNames({"width", "height", "nodes", "fusion"})
+    ->ArgsProduct({{64}, {48}, {2, 4, 8}, {0, 1}})
+    ->ArgsProduct({{640}, {480}, {2, 4, 8}, {0, 1}})
+    ->ArgsProduct({{1920}, {1080}, {4}, {0, 1}})
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Subgraph grouping with node fusion. Every subgraph runs its nodes on its
+ * own thread, so nodes that recorded the same thread were fused.
+ */
+
+#include <gtest/gtest.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+#define IMAGE_WIDTH     64
+#define IMAGE_HEIGHT    48
+
+class GraphFusionTest : public ::testing::Test {
+protected:
+    vx_context m_context;
+    vx_graph m_graph;
+    vx_kernel m_kernel;
+    vx_kernel m_alt_kernel;
+
+    virtual void SetUp()
+    {
+        m_context = vxCreateContext();
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_context));
+
+        m_kernel = addSwAddOneKernel(m_context, SW_TARGET_NAME);
+        ASSERT_TRUE(m_kernel != NULL);
+        m_alt_kernel = addSwAddOneKernel(m_context, SW_ALT_TARGET_NAME);
+        ASSERT_TRUE(m_alt_kernel != NULL);
+
+        m_graph = vxCreateGraph(m_context);
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_graph));
+
+        clearSwNodeThreads();
+    }
+
+    virtual void TearDown()
+    {
+        vxReleaseGraph(&m_graph);
+        vxReleaseKernel(&m_kernel);
+        vxReleaseKernel(&m_alt_kernel);
+        vxReleaseContext(&m_context);
+    }
+
+    void setFusion(vx_bool fusion)
+    {
+        ASSERT_EQ(VX_SUCCESS, vxSetGraphAttribute(m_graph, VX_GRAPH_ATTRIBUTE_NODE_FUSION, &fusion, sizeof(fusion)));
+    }
+
+    vx_node addNode(vx_kernel kernel, vx_image input, vx_image output)
+    {
+        vx_node node = vxCreateGenericNode(m_graph, kernel);
+
+        EXPECT_EQ(VX_SUCCESS, vxSetParameterByIndex(node, 0, (vx_reference)input));
+        EXPECT_EQ(VX_SUCCESS, vxSetParameterByIndex(node, 1, (vx_reference)output));
+
+        return node;
+    }
+
+    vx_image createVirtualImage(void)
+    {
+        return vxCreateVirtualImage(m_graph, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    }
+
+    vx_image createImage(void)
+    {
+        return vxCreateImage(m_context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    }
+};
+
+TEST_F(GraphFusionTest, FusionIsOnByDefault)
+{
+    vx_bool fusion = vx_false_e;
+
+    EXPECT_EQ(VX_SUCCESS, vxQueryGraph(m_graph, VX_GRAPH_ATTRIBUTE_NODE_FUSION, &fusion, sizeof(fusion)));
+    EXPECT_EQ(vx_true_e, fusion);
+}
+
+TEST_F(GraphFusionTest, SameTargetChainRunsInOneSubgraph)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_image virt0 = createVirtualImage();
+    vx_image virt1 = createVirtualImage();
+
+    vx_node node0 = addNode(m_kernel, input, virt0);
+    vx_node node1 = addNode(m_kernel, virt0, virt1);
+    vx_node node2 = addNode(m_kernel, virt1, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    for (vx_uint8 frame = 0; frame < 3; frame++) {
+        fillImage(input, frame * 10);
+        ASSERT_EQ(VX_SUCCESS, vxProcessGraph(m_graph));
+        EXPECT_EQ(frame * 10 + 3, readImagePixel(output, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1));
+    }
+
+    EXPECT_NE((pthread_t)0, getSwNodeThread(node0));
+    EXPECT_EQ(getSwNodeThread(node0), getSwNodeThread(node1));
+    EXPECT_EQ(getSwNodeThread(node1), getSwNodeThread(node2));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseNode(&node2);
+    vxReleaseImage(&virt0);
+    vxReleaseImage(&virt1);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(GraphFusionTest, FusionOffKeepsOneSubgraphPerNode)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_image virt0 = createVirtualImage();
+    vx_image virt1 = createVirtualImage();
+
+    setFusion(vx_false_e);
+
+    vx_node node0 = addNode(m_kernel, input, virt0);
+    vx_node node1 = addNode(m_kernel, virt0, virt1);
+    vx_node node2 = addNode(m_kernel, virt1, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    fillImage(input, 100);
+    ASSERT_EQ(VX_SUCCESS, vxProcessGraph(m_graph));
+    EXPECT_EQ(103, readImagePixel(output, 0, 0));
+
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node1));
+    EXPECT_NE(getSwNodeThread(node1), getSwNodeThread(node2));
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node2));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseNode(&node2);
+    vxReleaseImage(&virt0);
+    vxReleaseImage(&virt1);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(GraphFusionTest, TargetChangeSplitsChain)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_image virt0 = createVirtualImage();
+    vx_image virt1 = createVirtualImage();
+
+    vx_node node0 = addNode(m_kernel, input, virt0);
+    vx_node node1 = addNode(m_alt_kernel, virt0, virt1);
+    vx_node node2 = addNode(m_kernel, virt1, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    fillImage(input, 7);
+    ASSERT_EQ(VX_SUCCESS, vxProcessGraph(m_graph));
+    EXPECT_EQ(10, readImagePixel(output, 0, 0));
+
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node1));
+    EXPECT_NE(getSwNodeThread(node1), getSwNodeThread(node2));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseNode(&node2);
+    vxReleaseImage(&virt0);
+    vxReleaseImage(&virt1);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(GraphFusionTest, NonVirtualImageIsNotElided)
+{
+    vx_image input = createImage();
+    vx_image middle = createImage();
+    vx_image output = createImage();
+
+    vx_node node0 = addNode(m_kernel, input, middle);
+    vx_node node1 = addNode(m_kernel, middle, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    fillImage(input, 20);
+    ASSERT_EQ(VX_SUCCESS, vxProcessGraph(m_graph));
+    EXPECT_EQ(21, readImagePixel(middle, 0, 0));
+    EXPECT_EQ(22, readImagePixel(output, 0, 0));
+
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node1));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseImage(&input);
+    vxReleaseImage(&middle);
+    vxReleaseImage(&output);
+}
+
+TEST_F(GraphFusionTest, FanOutIsNotFused)
+{
+    vx_image input = createImage();
+    vx_image output0 = createImage();
+    vx_image output1 = createImage();
+    vx_image virt = createVirtualImage();
+
+    vx_node node0 = addNode(m_kernel, input, virt);
+    vx_node node1 = addNode(m_kernel, virt, output0);
+    vx_node node2 = addNode(m_kernel, virt, output1);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    fillImage(input, 50);
+    ASSERT_EQ(VX_SUCCESS, vxProcessGraph(m_graph));
+    EXPECT_EQ(52, readImagePixel(output0, 0, 0));
+    EXPECT_EQ(52, readImagePixel(output1, 0, 0));
+
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node1));
+    EXPECT_NE(getSwNodeThread(node0), getSwNodeThread(node2));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseNode(&node2);
+    vxReleaseImage(&virt);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output0);
+    vxReleaseImage(&output1);
+}
+
+TEST_F(GraphFusionTest, FusionIsFixedAfterVerification)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_bool fusion = vx_false_e;
+
+    vx_node node = addNode(m_kernel, input, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+    EXPECT_EQ(VX_ERROR_NOT_SUPPORTED, vxSetGraphAttribute(m_graph, VX_GRAPH_ATTRIBUTE_NODE_FUSION, &fusion, sizeof(fusion)));
+    EXPECT_EQ(VX_SUCCESS, vxQueryGraph(m_graph, VX_GRAPH_ATTRIBUTE_NODE_FUSION, &fusion, sizeof(fusion)));
+    EXPECT_EQ(vx_true_e, fusion);
+
+    vxReleaseNode(&node);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(GraphFusionTest, StreamChainRunsInOneSubgraph)
+{
+    static vx_uint8 input_buf[4][IMAGE_WIDTH * IMAGE_HEIGHT];
+    static vx_uint8 output_buf[4][IMAGE_WIDTH * IMAGE_HEIGHT];
+
+    ASSERT_EQ(VX_SUCCESS, vxHint((vx_reference)m_graph, VX_HINT_STREAM));
+
+    vx_image input = vxCreateImageFromQueue(m_graph, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    vx_image output = vxCreateImageFromQueue(m_graph, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    vx_image virt0 = createVirtualImage();
+    vx_image virt1 = createVirtualImage();
+
+    vx_node node0 = addNode(m_kernel, input, virt0);
+    vx_node node1 = addNode(m_kernel, virt0, virt1);
+    vx_node node2 = addNode(m_kernel, virt1, output);
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(m_graph));
+
+    for (vx_uint32 i = 0; i < 4; i++) {
+        void *output_ptr = output_buf[i];
+        void *input_ptr = input_buf[i];
+
+        ASSERT_EQ(VX_SUCCESS, vxPushImagePatch(output, i, &output_ptr, 1));
+        ASSERT_EQ(VX_SUCCESS, vxPushImagePatch(input, i, &input_ptr, 1));
+    }
+
+    for (vx_uint32 i = 0; i < 4; i++) {
+        vx_uint32 index;
+        vx_bool data_valid;
+
+        ASSERT_EQ(VX_SUCCESS, vxPopImage(output, &index, &data_valid));
+        EXPECT_EQ(i, index);
+        EXPECT_EQ(vx_true_e, data_valid);
+    }
+
+    EXPECT_EQ(getSwNodeThread(node0), getSwNodeThread(node1));
+    EXPECT_EQ(getSwNodeThread(node1), getSwNodeThread(node2));
+
+    vxReleaseNode(&node0);
+    vxReleaseNode(&node1);
+    vxReleaseNode(&node2);
+    vxReleaseImage(&virt0);
+    vxReleaseImage(&virt1);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Per-call latency of an immediate function, with the graph cache of the
+ * context disabled (cache:0) and enabled (cache:1). The calls alternate
+ * between two sets of images, so the cached graph is rebound every time.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <VX/vx.h>
+#include <VX/vxu.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+static void BM_ImmediateAdd(benchmark::State &state)
+{
+    const vx_uint32 width = state.range(0);
+    const vx_uint32 height = state.range(1);
+    vx_bool cache = state.range(2) ? vx_true_e : vx_false_e;
+
+    vx_context context = vxCreateContext();
+    vx_kernel kernel = addSwAddKernel(context);
+    if (cache == vx_false_e) {
+        vx_uint32 cache_size = 0;
+        vxSetContextAttribute(context, VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE, &cache_size, sizeof(cache_size));
+    }
+
+    vx_image inputs[2], outputs[2];
+    for (vx_uint32 i = 0; i < 2; i++) {
+        inputs[i] = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+        outputs[i] = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+        fillImage(inputs[i], i);
+    }
+
+    std::vector<double> samples;
+    vx_uint32 index = 0;
+
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        vx_status status = vxuAdd(context, inputs[index], inputs[index], VX_CONVERT_POLICY_WRAP, outputs[index]);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (status != VX_SUCCESS) {
+            state.SkipWithError("vxuAdd failed");
+            break;
+        }
+        samples.push_back(elapsed.count());
+        state.SetIterationTime(elapsed.count() / 1e9);
+        index ^= 1;
+    }
+
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        state.counters["p50_ns"] = samples[samples.size() / 2];
+        state.counters["p99_ns"] = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    }
+    state.counters["verifications"] = getSwInitCount();
+    clearSwInitCount();
+
+    for (vx_uint32 i = 0; i < 2; i++) {
+        vxReleaseImage(&inputs[i]);
+        vxReleaseImage(&outputs[i]);
+    }
+    vxReleaseKernel(&kernel);
+    vxReleaseContext(&context);
+}
+BENCHMARK(BM_ImmediateAdd)
+    ->ArgNames({"width", "height", "cache"})
+    ->ArgsProduct({{64}, {48}, {0, 1}})
+    ->ArgsProduct({{640}, {480}, {0, 1}})
+    ->ArgsProduct({{1920}, {1080}, {0, 1}})
+    ->UseManualTime();
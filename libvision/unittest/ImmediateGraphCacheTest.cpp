@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Graph cache of the immediate mode. The software add kernel counts its
+ * initializations, a cached graph is reused without a new verification.
+ */
+
+#include <gtest/gtest.h>
+
+#include <VX/vx.h>
+#include <VX/vxu.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+#define IMAGE_WIDTH     64
+#define IMAGE_HEIGHT    48
+
+class ImmediateGraphCacheTest : public ::testing::Test {
+protected:
+    vx_context m_context;
+    vx_kernel m_kernel;
+
+    virtual void SetUp()
+    {
+        m_context = vxCreateContext();
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_context));
+
+        m_kernel = addSwAddKernel(m_context);
+        ASSERT_TRUE(m_kernel != NULL);
+
+        clearSwInitCount();
+    }
+
+    virtual void TearDown()
+    {
+        vxReleaseKernel(&m_kernel);
+        vxReleaseContext(&m_context);
+    }
+
+    void setCacheSize(vx_uint32 size)
+    {
+        ASSERT_EQ(VX_SUCCESS, vxSetContextAttribute(m_context, VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE, &size, sizeof(size)));
+    }
+
+    vx_image createImage(vx_uint32 width, vx_uint32 height, vx_uint8 value)
+    {
+        vx_image image = vxCreateImage(m_context, width, height, VX_DF_IMAGE_U8);
+        fillImage(image, value);
+
+        return image;
+    }
+
+    vx_uint32 getRefNum(void)
+    {
+        vx_uint32 ref_num = 0;
+        vxQueryContext(m_context, VX_CONTEXT_ATTRIBUTE_REFERENCES, &ref_num, sizeof(ref_num));
+
+        return ref_num;
+    }
+};
+
+TEST_F(ImmediateGraphCacheTest, DefaultCacheSize)
+{
+    vx_uint32 size = 0;
+
+    ASSERT_EQ(VX_SUCCESS, vxQueryContext(m_context, VX_CONTEXT_ATTRIBUTE_IMMEDIATE_GRAPH_CACHE_SIZE, &size, sizeof(size)));
+    EXPECT_NE(0u, size);
+}
+
+TEST_F(ImmediateGraphCacheTest, RepeatedCallIsVerifiedOnce)
+{
+    vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 10);
+    vx_image in2 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 20);
+    vx_image out = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+
+    for (vx_uint32 i = 0; i < 5; i++)
+        ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_WRAP, out));
+
+    EXPECT_EQ(1u, getSwInitCount());
+    EXPECT_EQ(30, readImagePixel(out, 0, 0));
+
+    vxReleaseImage(&in1);
+    vxReleaseImage(&in2);
+    vxReleaseImage(&out);
+}
+
+TEST_F(ImmediateGraphCacheTest, CachedGraphIsRebound)
+{
+    vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    vx_image in2 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 2);
+    vx_image in3 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 100);
+    vx_image out1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+    vx_image out2 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_WRAP, out1));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in3, in1, VX_CONVERT_POLICY_WRAP, out2));
+
+    EXPECT_EQ(1u, getSwInitCount());
+    EXPECT_EQ(3, readImagePixel(out1, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1));
+    EXPECT_EQ(101, readImagePixel(out2, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1));
+
+    vxReleaseImage(&in1);
+    vxReleaseImage(&in2);
+    vxReleaseImage(&in3);
+    vxReleaseImage(&out1);
+    vxReleaseImage(&out2);
+}
+
+TEST_F(ImmediateGraphCacheTest, ShapeAndScalarAreKeyed)
+{
+    vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 200);
+    vx_image in2 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 100);
+    vx_image out = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+    vx_image small_in = createImage(IMAGE_WIDTH / 2, IMAGE_HEIGHT / 2, 1);
+    vx_image small_out = createImage(IMAGE_WIDTH / 2, IMAGE_HEIGHT / 2, 0);
+
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_WRAP, out));
+    EXPECT_EQ(44, readImagePixel(out, 0, 0));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_SATURATE, out));
+    EXPECT_EQ(255, readImagePixel(out, 0, 0));
+    EXPECT_EQ(2u, getSwInitCount());
+
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, small_in, small_in, VX_CONVERT_POLICY_WRAP, small_out));
+    EXPECT_EQ(2, readImagePixel(small_out, 0, 0));
+    EXPECT_EQ(3u, getSwInitCount());
+
+    /* all of them are still cached */
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_WRAP, out));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_SATURATE, out));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, small_in, small_in, VX_CONVERT_POLICY_WRAP, small_out));
+    EXPECT_EQ(3u, getSwInitCount());
+
+    vxReleaseImage(&in1);
+    vxReleaseImage(&in2);
+    vxReleaseImage(&out);
+    vxReleaseImage(&small_in);
+    vxReleaseImage(&small_out);
+}
+
+TEST_F(ImmediateGraphCacheTest, CachedGraphDoesNotHoldImages)
+{
+    /* the first call puts a new graph into the cache, the second one takes it out */
+    for (vx_uint32 i = 0; i < 2; i++) {
+        vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 5);
+        vx_image in2 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 6);
+        vx_image out = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+
+        ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in2, VX_CONVERT_POLICY_WRAP, out));
+        EXPECT_EQ(11, readImagePixel(out, 0, 0));
+
+        /* the images are destroyed as soon as the caller releases them */
+        vx_uint32 ref_num = getRefNum();
+        vxReleaseImage(&in1);
+        vxReleaseImage(&in2);
+        vxReleaseImage(&out);
+        EXPECT_EQ(ref_num - 3, getRefNum());
+    }
+
+    EXPECT_EQ(1u, getSwInitCount());
+}
+
+TEST_F(ImmediateGraphCacheTest, LeastRecentlyUsedIsEvicted)
+{
+    vx_image in[3], out[3];
+
+    setCacheSize(2);
+    for (vx_uint32 i = 0; i < 3; i++) {
+        in[i] = createImage(IMAGE_WIDTH * (i + 1), IMAGE_HEIGHT, 1);
+        out[i] = createImage(IMAGE_WIDTH * (i + 1), IMAGE_HEIGHT, 0);
+    }
+
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[0], in[0], VX_CONVERT_POLICY_WRAP, out[0]));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[1], in[1], VX_CONVERT_POLICY_WRAP, out[1]));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[0], in[0], VX_CONVERT_POLICY_WRAP, out[0]));
+    EXPECT_EQ(2u, getSwInitCount());
+
+    /* the third shape evicts the second one, the first one was used more recently */
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[2], in[2], VX_CONVERT_POLICY_WRAP, out[2]));
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[0], in[0], VX_CONVERT_POLICY_WRAP, out[0]));
+    EXPECT_EQ(3u, getSwInitCount());
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in[1], in[1], VX_CONVERT_POLICY_WRAP, out[1]));
+    EXPECT_EQ(4u, getSwInitCount());
+
+    for (vx_uint32 i = 0; i < 3; i++) {
+        vxReleaseImage(&in[i]);
+        vxReleaseImage(&out[i]);
+    }
+}
+
+TEST_F(ImmediateGraphCacheTest, ZeroSizeDisablesCache)
+{
+    vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    vx_image out = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+
+    setCacheSize(0);
+    for (vx_uint32 i = 0; i < 3; i++)
+        ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in1, VX_CONVERT_POLICY_WRAP, out));
+
+    EXPECT_EQ(3u, getSwInitCount());
+    EXPECT_EQ(6, readImagePixel(out, 0, 0));
+
+    vxReleaseImage(&in1);
+    vxReleaseImage(&out);
+}
+
+TEST_F(ImmediateGraphCacheTest, ShrinkingFlushesEntries)
+{
+    vx_image in1 = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    vx_image out = createImage(IMAGE_WIDTH, IMAGE_HEIGHT, 0);
+
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in1, VX_CONVERT_POLICY_WRAP, out));
+    setCacheSize(0);
+    setCacheSize(4);
+    ASSERT_EQ(VX_SUCCESS, vxuAdd(m_context, in1, in1, VX_CONVERT_POLICY_WRAP, out));
+
+    EXPECT_EQ(2u, getSwInitCount());
+
+    vxReleaseImage(&in1);
+    vxReleaseImage(&out);
+}
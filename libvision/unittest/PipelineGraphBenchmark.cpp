@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Frame throughput of a chain of software nodes on alternating targets, one
+ * subgraph per node, by pipeline depth. Each node sleeps latency_us, so depth 1
+ * is bounded by the sum of the stages and deeper pipelines by the slowest one.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <VX/vx.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+static void BM_PipelineChain(benchmark::State &state)
+{
+    const vx_uint32 width = 640;
+    const vx_uint32 height = 480;
+    const vx_uint32 chain_len = state.range(0);
+    vx_uint32 depth = state.range(1);
+
+    setSwKernelLatency(state.range(2));
+
+    vx_context context = vxCreateContext();
+    vx_kernel kernels[2] = {addSwAddOneKernel(context, SW_TARGET_NAME), addSwAddOneKernel(context, SW_ALT_TARGET_NAME)};
+    vx_graph graph = vxCreateGraph(context);
+    vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth));
+
+    vx_image input = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_image output = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    std::vector<vx_image> images;
+    std::vector<vx_node> nodes;
+    vx_image prev = input;
+
+    for (vx_uint32 i = 0; i < chain_len; i++) {
+        vx_image next = output;
+        if (i + 1 < chain_len) {
+            next = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
+            images.push_back(next);
+        }
+
+        vx_node node = vxCreateGenericNode(graph, kernels[i % 2]);
+        vxSetParameterByIndex(node, 0, (vx_reference)prev);
+        vxSetParameterByIndex(node, 1, (vx_reference)next);
+        nodes.push_back(node);
+        prev = next;
+    }
+
+    if (vxVerifyGraph(graph) != VX_SUCCESS) {
+        state.SkipWithError("vxVerifyGraph failed");
+    } else {
+        fillImage(input, 0);
+
+        /* a normal graph completes each frame before the next one, a pipelined graph waits for a free slot */
+        for (auto _ : state) {
+            vx_status status = (depth > 1) ? vxScheduleGraph(graph) : vxProcessGraph(graph);
+            if (status != VX_SUCCESS) {
+                state.SkipWithError("issuing frame failed");
+                break;
+            }
+        }
+
+        if ((depth > 1) && (vxWaitGraph(graph) != VX_SUCCESS))
+            state.SkipWithError("vxWaitGraph failed");
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    for (vx_uint32 i = 0; i < nodes.size(); i++)
+        vxReleaseNode(&nodes[i]);
+    for (vx_uint32 i = 0; i < images.size(); i++)
+        vxReleaseImage(&images[i]);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+    vxReleaseGraph(&graph);
+    vxReleaseKernel(&kernels[0]);
+    vxReleaseKernel(&kernels[1]);
+    vxReleaseContext(&context);
+
+    setSwKernelLatency(0);
+}
+BENCHMARK(BM_PipelineChain)
+    ->ArgNames({"nodes", "depth", "latency_us"})
+    ->ArgsProduct({{2, 4}, {1, 2, 4}, {0, 1000}})
+    ->UseRealTime();
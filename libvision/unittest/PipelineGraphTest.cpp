@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Pipelined graph execution. Adjacent nodes alternate the software targets so
+ * every node gets its own subgraph thread and the frames can overlap.
+ */
+
+#include <sys/time.h>
+
+#include <gtest/gtest.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+#include <VX/vx_types_ext.h>
+
+#include "SoftwareKernels.h"
+
+#define IMAGE_WIDTH     64
+#define IMAGE_HEIGHT    48
+
+static vx_uint64 getTimeUs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    return (vx_uint64)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+class PipelineGraphTest : public ::testing::Test {
+protected:
+    vx_context m_context;
+    vx_kernel m_kernel;
+    vx_kernel m_alt_kernel;
+
+    virtual void SetUp()
+    {
+        m_context = vxCreateContext();
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_context));
+
+        m_kernel = addSwAddOneKernel(m_context, SW_TARGET_NAME);
+        ASSERT_TRUE(m_kernel != NULL);
+        m_alt_kernel = addSwAddOneKernel(m_context, SW_ALT_TARGET_NAME);
+        ASSERT_TRUE(m_alt_kernel != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        setSwKernelLatency(0);
+
+        vxReleaseKernel(&m_kernel);
+        vxReleaseKernel(&m_alt_kernel);
+        vxReleaseContext(&m_context);
+    }
+
+    vx_graph createGraph(vx_uint32 depth)
+    {
+        vx_graph graph = vxCreateGraph(m_context);
+        EXPECT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)graph));
+        EXPECT_EQ(VX_SUCCESS, vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+
+        return graph;
+    }
+
+    vx_node addNode(vx_graph graph, vx_kernel kernel, vx_image input, vx_image output)
+    {
+        vx_node node = vxCreateGenericNode(graph, kernel);
+
+        EXPECT_EQ(VX_SUCCESS, vxSetParameterByIndex(node, 0, (vx_reference)input));
+        EXPECT_EQ(VX_SUCCESS, vxSetParameterByIndex(node, 1, (vx_reference)output));
+
+        return node;
+    }
+
+    vx_image createImage(void)
+    {
+        return vxCreateImage(m_context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    }
+
+    /* input -> sw -> swalt -> ... -> output, stage_num subgraphs */
+    vx_graph createChainGraph(vx_uint32 depth, vx_uint32 stage_num, vx_image input, vx_image output)
+    {
+        vx_graph graph = createGraph(depth);
+        vx_image src = input;
+
+        for (vx_uint32 i = 0; i < stage_num; i++) {
+            vx_image dst = (i == stage_num - 1) ? output : vxCreateVirtualImage(graph, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+            vx_node node = addNode(graph, (i % 2) ? m_alt_kernel : m_kernel, src, dst);
+            vxReleaseNode(&node);
+            if (src != input)
+                vxReleaseImage(&src);
+            src = dst;
+        }
+
+        return graph;
+    }
+
+    vx_uint8 readDelayPixel(vx_delay delay, vx_int32 index)
+    {
+        return readImagePixel((vx_image)vxGetReferenceFromDelay(delay, index), 0, 0);
+    }
+
+    /*
+     * delay[-(count-1)] -> sw -> delay[0] -> swalt -> output. Frame k writes the value of
+     * frame k-(count-1) plus one into delay[0], so a wrong slot shows up in the values.
+     */
+    void runDelayGraph(vx_uint32 depth, vx_size count, vx_uint32 frame_num, vx_image output, vx_delay delay)
+    {
+        vx_graph graph = createGraph(depth);
+
+        for (vx_size i = 0; i < count; i++)
+            fillImage((vx_image)vxGetReferenceFromDelay(delay, -(vx_int32)i), 0);
+
+        vx_node node0 = addNode(graph, m_kernel, (vx_image)vxGetReferenceFromDelay(delay, -(vx_int32)(count - 1)),
+                                                    (vx_image)vxGetReferenceFromDelay(delay, 0));
+        vx_node node1 = addNode(graph, m_alt_kernel, (vx_image)vxGetReferenceFromDelay(delay, 0), output);
+
+        ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(graph));
+
+        for (vx_uint32 frame = 0; frame < frame_num; frame++) {
+            if (depth > 1)
+                ASSERT_EQ(VX_SUCCESS, vxScheduleGraph(graph));
+            else
+                ASSERT_EQ(VX_SUCCESS, vxProcessGraph(graph));
+            ASSERT_EQ(VX_SUCCESS, vxAgeDelay(delay));
+        }
+        if (depth > 1)
+            EXPECT_EQ(VX_SUCCESS, vxWaitGraph(graph));
+
+        vxReleaseNode(&node0);
+        vxReleaseNode(&node1);
+        vxReleaseGraph(&graph);
+    }
+};
+
+TEST_F(PipelineGraphTest, DepthIsOneByDefault)
+{
+    vx_graph graph = vxCreateGraph(m_context);
+    vx_uint32 depth = 0;
+
+    EXPECT_EQ(VX_SUCCESS, vxQueryGraph(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+    EXPECT_EQ(1u, depth);
+
+    vxReleaseGraph(&graph);
+}
+
+TEST_F(PipelineGraphTest, DepthCanBeSetOnlyBeforeVerification)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_graph graph = createChainGraph(3, 1, input, output);
+    vx_uint32 depth = 0;
+
+    EXPECT_EQ(VX_ERROR_INVALID_VALUE, vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(graph));
+
+    depth = 2;
+    EXPECT_EQ(VX_ERROR_NOT_SUPPORTED, vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+    EXPECT_EQ(VX_SUCCESS, vxQueryGraph(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+    EXPECT_EQ(3u, depth);
+
+    vxReleaseGraph(&graph);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(PipelineGraphTest, PipelinedChainGivesSameResult)
+{
+    vx_image input = createImage();
+    vx_image output = createImage();
+    vx_graph graph = createChainGraph(3, 3, input, output);
+
+    fillImage(input, 10);
+    ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(graph));
+
+    for (vx_uint32 frame = 0; frame < 8; frame++)
+        ASSERT_EQ(VX_SUCCESS, vxScheduleGraph(graph));
+    EXPECT_EQ(VX_SUCCESS, vxWaitGraph(graph));
+    EXPECT_EQ(13, readImagePixel(output, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1));
+
+    /* processing a frame drains the pipeline */
+    fillImage(input, 20);
+    EXPECT_EQ(VX_SUCCESS, vxProcessGraph(graph));
+    EXPECT_EQ(23, readImagePixel(output, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1));
+
+    vxReleaseGraph(&graph);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+}
+
+TEST_F(PipelineGraphTest, PipelinedChainOverlapsFrames)
+{
+    const vx_uint32 stage_num = 3;
+    const vx_uint32 frame_num = 8;
+    vx_uint64 elapsed[2];
+    vx_uint32 depth[2] = {1, stage_num};
+
+    setSwKernelLatency(20 * 1000);
+
+    for (vx_uint32 i = 0; i < 2; i++) {
+        vx_image input = createImage();
+        vx_image output = createImage();
+        vx_graph graph = createChainGraph(depth[i], stage_num, input, output);
+
+        fillImage(input, 0);
+        ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(graph));
+
+        vx_uint64 start = getTimeUs();
+        for (vx_uint32 frame = 0; frame < frame_num; frame++)
+            ASSERT_EQ(VX_SUCCESS, vxScheduleGraph(graph));
+        ASSERT_EQ(VX_SUCCESS, vxWaitGraph(graph));
+        elapsed[i] = getTimeUs() - start;
+
+        EXPECT_EQ(stage_num, readImagePixel(output, 0, 0));
+
+        vxReleaseGraph(&graph);
+        vxReleaseImage(&input);
+        vxReleaseImage(&output);
+    }
+
+    /* 24 kernel latencies in a row against 10 when the stages overlap */
+    EXPECT_LT(elapsed[1] * 3, elapsed[0] * 2) << "sequential " << elapsed[0] << "us, pipelined " << elapsed[1] << "us";
+}
+
+TEST_F(PipelineGraphTest, DelayOfTwoIsAgedPerFrame)
+{
+    vx_image exemplar = createImage();
+    vx_image output = createImage();
+    vx_delay delay = vxCreateDelay(m_context, (vx_reference)exemplar, 2);
+
+    runDelayGraph(3, 2, 6, output, delay);
+
+    /* 1, 2, ..., 6 */
+    EXPECT_EQ(6, readDelayPixel(delay, -1));
+    EXPECT_EQ(5, readDelayPixel(delay, 0));
+    EXPECT_EQ(7, readImagePixel(output, 0, 0));
+
+    vxReleaseDelay(&delay);
+    vxReleaseImage(&exemplar);
+    vxReleaseImage(&output);
+}
+
+TEST_F(PipelineGraphTest, DelayOfThreeIsAgedPerFrame)
+{
+    vx_uint32 depth[2] = {1, 3};
+
+    for (vx_uint32 i = 0; i < 2; i++) {
+        vx_image exemplar = createImage();
+        vx_image output = createImage();
+        vx_delay delay = vxCreateDelay(m_context, (vx_reference)exemplar, 3);
+
+        runDelayGraph(depth[i], 3, 6, output, delay);
+
+        /* 1, 1, 2, 2, 3, 3 */
+        EXPECT_EQ(3, readDelayPixel(delay, -1)) << "depth " << depth[i];
+        EXPECT_EQ(3, readDelayPixel(delay, -2)) << "depth " << depth[i];
+        EXPECT_EQ(2, readDelayPixel(delay, 0)) << "depth " << depth[i];
+        EXPECT_EQ(4, readImagePixel(output, 0, 0)) << "depth " << depth[i];
+
+        vxReleaseDelay(&delay);
+        vxReleaseImage(&exemplar);
+        vxReleaseImage(&output);
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Contention on one queue and one pool shared by every benchmark thread. Each
+ * thread pushes a message and pops one, or takes a resource and puts it back.
+ * The locked list is the List, Mutex and Condition the queue used before, as a
+ * reference.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <utils/Log.h>
+
+#include "ExynosVisionQueue.h"
+#include "ExynosVisionPool.h"
+
+using namespace android;
+
+class LockedListQueue {
+private:
+    List<int> m_list;
+    Mutex m_mutex;
+    Condition m_condition;
+
+public:
+    void push(int value)
+    {
+        Mutex::Autolock lock(m_mutex);
+        m_list.push_back(value);
+        m_condition.signal();
+    }
+
+    int waitAndPop(void)
+    {
+        Mutex::Autolock lock(m_mutex);
+        while (m_list.empty())
+            m_condition.wait(m_mutex);
+
+        int value = *m_list.begin();
+        m_list.erase(m_list.begin());
+
+        return value;
+    }
+};
+
+static void BM_LockedListQueue(benchmark::State &state)
+{
+    static LockedListQueue queue;
+    int value = state.thread_index();
+
+    for (auto _ : state) {
+        queue.push(value);
+        benchmark::DoNotOptimize(value = queue.waitAndPop());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedListQueue)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_QueuePushPop(benchmark::State &state)
+{
+    static ExynosVisionQueue<int> queue(0);
+    int value = state.thread_index();
+
+    for (auto _ : state) {
+        queue.pushProcessQ(&value);
+        if (queue.waitAndPopProcessQ(&value) != QUEUE_EXCEPTION_NONE) {
+            state.SkipWithError("waitAndPopProcessQ failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueuePushPop)->ThreadRange(1, 8)->UseRealTime();
+
+/* fewer resources than threads at 4 and 8 threads, so getters also wait */
+class TwoResourcePool : public ExynosVisionPool<int> {
+public:
+    TwoResourcePool(void) : ExynosVisionPool<int>(2)
+    {
+        putResource(0);
+        putResource(1);
+    }
+};
+
+static void BM_PoolGetPut(benchmark::State &state)
+{
+    static TwoResourcePool pool;
+    int resource;
+
+    for (auto _ : state) {
+        if (pool.getResource(&resource) != POOL_EXCEPTION_NONE) {
+            state.SkipWithError("getResource failed");
+            break;
+        }
+        pool.putResource(resource);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoolGetPut)->ThreadRange(1, 8)->UseRealTime();
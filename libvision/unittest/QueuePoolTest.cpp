@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ExynosVisionQueue and ExynosVisionPool on the lock-free ring, single threaded
+ * order and several producers and consumers racing on a small ring.
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/Log.h>
+
+#include "ExynosVisionRing.h"
+#include "ExynosVisionQueue.h"
+#include "ExynosVisionPool.h"
+
+using namespace android;
+
+TEST(QueuePoolTest, RingCapacityIsPowerOfTwo)
+{
+    ExynosVisionRing<int> ring(10);
+    int value;
+
+    EXPECT_EQ(16u, ring.getCapacity());
+
+    for (int i = 0; i < 16; i++)
+        EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(16));
+    EXPECT_EQ(16u, ring.size());
+
+    for (int i = 0; i < 16; i++) {
+        ASSERT_TRUE(ring.pop(&value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ring.pop(&value));
+}
+
+TEST(QueuePoolTest, QueueKeepsOrder)
+{
+    ExynosVisionQueue<int> queue(0, 4);
+    int value;
+
+    EXPECT_EQ(TIMED_OUT, queue.popProcessQ(&value));
+
+    /* wraps the ring several times */
+    for (int i = 0; i < 20; i++) {
+        queue.pushProcessQ(&i);
+        EXPECT_EQ(1u, queue.getRemainedMsgNum());
+        ASSERT_EQ(QUEUE_EXCEPTION_NONE, queue.waitAndPopProcessQ(&value));
+        EXPECT_EQ(i, value);
+    }
+
+    for (int i = 0; i < 4; i++)
+        queue.pushProcessQ(&i);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(OK, queue.popProcessQ(&value));
+        EXPECT_EQ(i, value);
+    }
+}
+
+TEST(QueuePoolTest, QueueMultiProducerMultiConsumer)
+{
+    const int producer_num = 4;
+    const int consumer_num = 4;
+    const int message_num = 20000;
+    ExynosVisionQueue<int> queue(0, 8);
+    std::atomic<long> sum(0);
+    std::atomic<int> count(0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < consumer_num; i++) {
+        threads.push_back(std::thread([&] {
+            int value;
+            while (queue.waitAndPopProcessQ(&value) == QUEUE_EXCEPTION_NONE) {
+                sum += value;
+                count++;
+            }
+        }));
+    }
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < producer_num; i++) {
+        producers.push_back(std::thread([&, i] {
+            for (int value = i * message_num + 1; value <= (i + 1) * message_num; value++)
+                queue.pushProcessQ(&value);
+        }));
+    }
+    for (int i = 0; i < producer_num; i++)
+        producers[i].join();
+
+    while (count < producer_num * message_num)
+        usleep(1000);
+
+    for (int i = 0; i < consumer_num; i++)
+        queue.wakeupPendingThreadAndQDisable();
+    for (int i = 0; i < consumer_num; i++)
+        threads[i].join();
+
+    long total = (long)producer_num * message_num;
+    EXPECT_EQ(total * (total + 1) / 2, sum);
+    EXPECT_EQ(0u, queue.getRemainedMsgNum());
+}
+
+TEST(QueuePoolTest, QueueWakeupAndDisable)
+{
+    ExynosVisionQueue<int> queue(0);
+    queue_exception_t exception = QUEUE_EXCEPTION_NONE;
+    int value;
+
+    std::thread waiter([&] { exception = queue.waitAndPopProcessQ(&value); });
+    while (exception == QUEUE_EXCEPTION_NONE) {
+        queue.wakeupPendingThread();
+        usleep(1000);
+    }
+    waiter.join();
+    EXPECT_EQ(QUEUE_EXCEPTION_WAKE_UP, exception);
+
+    exception = QUEUE_EXCEPTION_NONE;
+    waiter = std::thread([&] { exception = queue.waitAndPopProcessQ(&value); });
+    usleep(10 * 1000);
+    queue.wakeupPendingThreadAndQDisable();
+    waiter.join();
+    EXPECT_EQ(QUEUE_EXCEPTION_DISABLE, exception);
+    EXPECT_EQ(QUEUE_EXCEPTION_DISABLE, queue.waitAndPopProcessQ(&value));
+}
+
+TEST(QueuePoolTest, FullQueueBlocksProducer)
+{
+    ExynosVisionQueue<int> queue(0, 2);
+    std::atomic<bool> pushed(false);
+    int value = 0;
+
+    queue.pushProcessQ(&value);
+    queue.pushProcessQ(&value);
+
+    std::thread producer([&] {
+        int last = 2;
+        queue.pushProcessQ(&last);
+        pushed = true;
+    });
+
+    usleep(10 * 1000);
+    EXPECT_FALSE(pushed);
+
+    ASSERT_EQ(QUEUE_EXCEPTION_NONE, queue.waitAndPopProcessQ(&value));
+    producer.join();
+    EXPECT_TRUE(pushed);
+    EXPECT_EQ(2u, queue.getRemainedMsgNum());
+}
+
+TEST(QueuePoolTest, FullOverflowQueueKeepsOrder)
+{
+    ExynosVisionQueue<int> queue(0, 4, QUEUE_FULL_POLICY_OVERFLOW);
+    int value;
+
+    /* nobody pops, the producer doesn't wait */
+    for (int i = 0; i < 10; i++)
+        queue.pushProcessQ(&i);
+    EXPECT_EQ(10u, queue.getRemainedMsgNum());
+
+    /* a message after the overflow doesn't pass the ones in the list */
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(QUEUE_EXCEPTION_NONE, queue.waitAndPopProcessQ(&value));
+        EXPECT_EQ(i, value);
+    }
+    value = 10;
+    queue.pushProcessQ(&value);
+
+    for (int i = 3; i <= 10; i++) {
+        ASSERT_EQ(OK, queue.popProcessQ(&value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_EQ(TIMED_OUT, queue.popProcessQ(&value));
+    EXPECT_EQ(0u, queue.getRemainedMsgNum());
+}
+
+TEST(QueuePoolTest, OverflowWakesConsumer)
+{
+    const int msgNum = 1000;
+    ExynosVisionQueue<int> queue(0, 2, QUEUE_FULL_POLICY_OVERFLOW);
+    std::vector<int> received;
+
+    std::thread consumer([&] {
+        int value;
+        while ((int)received.size() < msgNum && queue.waitAndPopProcessQ(&value) == QUEUE_EXCEPTION_NONE)
+            received.push_back(value);
+    });
+
+    for (int i = 0; i < msgNum; i++)
+        queue.pushProcessQ(&i);
+    consumer.join();
+
+    ASSERT_EQ((size_t)msgNum, received.size());
+    for (int i = 0; i < msgNum; i++)
+        EXPECT_EQ(i, received[i]);
+}
+
+TEST(QueuePoolTest, PoolGetWaitsForPut)
+{
+    ExynosVisionPool<int> pool(2);
+    std::atomic<bool> got(false);
+    int resource = 0;
+
+    pool.putResource(7);
+    EXPECT_EQ(1u, pool.getFreeNum());
+    ASSERT_EQ(POOL_EXCEPTION_NONE, pool.getResource(&resource));
+    EXPECT_EQ(7, resource);
+
+    std::thread getter([&] {
+        EXPECT_EQ(POOL_EXCEPTION_NONE, pool.getResource(&resource));
+        got = true;
+    });
+
+    usleep(10 * 1000);
+    EXPECT_FALSE(got);
+
+    pool.putResource(9);
+    getter.join();
+    EXPECT_EQ(9, resource);
+    EXPECT_EQ(0u, pool.getFreeNum());
+}
+
+TEST(QueuePoolTest, PoolReleaseWakesWaiter)
+{
+    ExynosVisionPool<int> pool(2);
+    std::atomic<bool> waiting(false);
+    pool_exception_t exception = POOL_EXCEPTION_NONE;
+    int resource;
+
+    std::thread getter([&] {
+        waiting = true;
+        exception = pool.getResource(&resource);
+    });
+
+    while (!waiting)
+        usleep(1000);
+    usleep(10 * 1000);
+    pool.release();
+    getter.join();
+    EXPECT_EQ(POOL_EXCEPTION_UNKNOWN, exception);
+
+    pool.putResource(1);
+    pool.putResource(2);
+    pool.flush();
+    EXPECT_EQ(0u, pool.getFreeNum());
+}
+
+TEST(QueuePoolTest, PoolMultiThreaded)
+{
+    const int thread_num = 4;
+    const int loop_num = 20000;
+    ExynosVisionPool<int> pool(2);
+    std::vector<std::thread> threads;
+
+    pool.putResource(1);
+    pool.putResource(2);
+
+    for (int i = 0; i < thread_num; i++) {
+        threads.push_back(std::thread([&] {
+            int resource;
+            for (int j = 0; j < loop_num; j++) {
+                ASSERT_EQ(POOL_EXCEPTION_NONE, pool.getResource(&resource));
+                pool.putResource(resource);
+            }
+        }));
+    }
+    for (int i = 0; i < thread_num; i++)
+        threads[i].join();
+
+    int first, second;
+    EXPECT_EQ(2u, pool.getFreeNum());
+    ASSERT_EQ(POOL_EXCEPTION_NONE, pool.getResource(&first));
+    ASSERT_EQ(POOL_EXCEPTION_NONE, pool.getResource(&second));
+    EXPECT_EQ(3, first + second);
+}
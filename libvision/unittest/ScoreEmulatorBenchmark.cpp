@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of an scv call on the emulated SCore device with an artificial device
+ * latency (latency_us). overhead_ns is the median call time beyond that
+ * latency: packet marshalling, dispatch to a worker and the reference kernel.
+ * The threads variants share the emulator workers (workers) to show queueing.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "score.h"
+#include "scv.h"
+#include "core/score_device_emulator.h"
+
+using namespace score;
+
+static void BM_ScoreAnd(benchmark::State &state)
+{
+    const int width = state.range(0);
+    const int height = state.range(1);
+    const unsigned int latency_us = state.range(2);
+
+    ScoreDeviceEmulator::SetLatency(latency_us);
+
+    std::vector<sc_u8> src(width * height, 0x5a);
+    ScBuffer *in = CreateScBuffer(width, height, SC_TYPE_U8, &src[0]);
+    ScBuffer *out = CreateScBuffer(width, height, SC_TYPE_U8);
+
+    std::vector<double> samples;
+
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        sc_status_t status = scvAnd(in, in, out);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (status != STS_SUCCESS) {
+            state.SkipWithError("scvAnd failed");
+            break;
+        }
+        samples.push_back(elapsed.count());
+        state.SetIterationTime(elapsed.count() / 1e9);
+    }
+
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        state.counters["p50_ns"] = samples[samples.size() / 2];
+        state.counters["p99_ns"] = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        state.counters["overhead_ns"] = samples[samples.size() / 2] - latency_us * 1000.0;
+    }
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(out);
+    ScoreDeviceEmulator::SetLatency(0);
+}
+BENCHMARK(BM_ScoreAnd)
+    ->ArgNames({"width", "height", "latency_us"})
+    ->ArgsProduct({{64}, {48}, {0, 50}})
+    ->ArgsProduct({{640}, {480}, {0, 50}})
+    ->ArgsProduct({{1920}, {1080}, {0, 50}})
+    ->UseManualTime();
+
+static void BM_ScoreAndThreads(benchmark::State &state)
+{
+    const int width = 640;
+    const int height = 480;
+
+    if (state.thread_index() == 0) {
+        ScoreDeviceEmulator::SetWorkerNum(state.range(0));
+        ScoreDeviceEmulator::SetLatency(100);
+    }
+
+    ScBuffer *in = CreateScBuffer(width, height, SC_TYPE_U8);
+    ScBuffer *out = CreateScBuffer(width, height, SC_TYPE_U8);
+
+    for (auto _ : state) {
+        if (scvAnd(in, in, out) != STS_SUCCESS) {
+            state.SkipWithError("scvAnd failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(out);
+
+    if (state.thread_index() == 0) {
+        ScoreDeviceEmulator::SetLatency(0);
+        ScoreDeviceEmulator::SetWorkerNum(SCORE_EMULATOR_DEFAULT_WORKER_NUM);
+    }
+}
+BENCHMARK(BM_ScoreAndThreads)
+    ->ArgNames({"workers"})
+    ->Arg(1)->Arg(4)
+    ->Threads(1)->Threads(4)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
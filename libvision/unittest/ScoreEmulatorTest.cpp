@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * SCore kernels on the emulated device. The scv functions marshal their
+ * parameters into packets exactly like on the target, the emulator decodes
+ * them and runs the reference kernels.
+ */
+
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "score.h"
+#include "score_command.h"
+#include "scv.h"
+#include "core/score_device_emulator.h"
+
+using namespace score;
+
+#define IMAGE_WIDTH     32
+#define IMAGE_HEIGHT    24
+
+class ScoreEmulatorTest : public ::testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ScoreDeviceEmulator::SetLatency(0);
+        ASSERT_EQ(0, ScoreDeviceEmulator::SetWorkerNum(SCORE_EMULATOR_DEFAULT_WORKER_NUM));
+    }
+
+    virtual void TearDown()
+    {
+        ScoreDeviceEmulator::SetLatency(0);
+        ScoreDeviceEmulator::SetWorkerNum(SCORE_EMULATOR_DEFAULT_WORKER_NUM);
+    }
+
+    template<typename T> T *data(ScBuffer *buffer)
+    {
+        return reinterpret_cast<T *>(GetScBufferAddr(buffer));
+    }
+};
+
+static long long getTimeUs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+TEST_F(ScoreEmulatorTest, And)
+{
+    std::vector<sc_u8> src1(IMAGE_WIDTH * IMAGE_HEIGHT), src2(IMAGE_WIDTH * IMAGE_HEIGHT);
+    for (size_t i = 0; i < src1.size(); i++) {
+        src1[i] = (sc_u8)i;
+        src2[i] = (sc_u8)(i * 7 + 3);
+    }
+
+    ScBuffer *in1 = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src1[0]);
+    ScBuffer *in2 = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src2[0]);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ASSERT_TRUE(in1 != NULL && in2 != NULL && out != NULL);
+
+    unsigned long count = ScoreDeviceEmulator::GetPacketCount();
+    EXPECT_EQ(STS_SUCCESS, scvAnd(in1, in2, out));
+    EXPECT_EQ(count + 1, ScoreDeviceEmulator::GetPacketCount());
+
+    sc_u8 *dst = data<sc_u8>(out);
+    for (size_t i = 0; i < src1.size(); i++)
+        ASSERT_EQ(src1[i] & src2[i], dst[i]) << "pixel " << i;
+
+    ReleaseScBuffer(in1);
+    ReleaseScBuffer(in2);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, Histogram)
+{
+    std::vector<sc_u8> src(IMAGE_WIDTH * IMAGE_HEIGHT);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = (sc_u8)(i % 256);
+
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src[0]);
+    ScBuffer *out = CreateScBuffer(16, 1, SC_TYPE_U32);
+    ASSERT_TRUE(in != NULL && out != NULL);
+
+    EXPECT_EQ(STS_SUCCESS, scvHistogram(in, out));
+
+    // 768 pixels cover every value three times, 16 values per bin
+    sc_u32 *hist = data<sc_u32>(out);
+    for (int i = 0; i < 16; i++)
+        EXPECT_EQ(48u, hist[i]) << "bin " << i;
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, TableLookup)
+{
+    std::vector<sc_u8> src(IMAGE_WIDTH * IMAGE_HEIGHT), table(256);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = (sc_u8)(i * 13);
+    for (size_t i = 0; i < table.size(); i++)
+        table[i] = (sc_u8)(255 - i);
+
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src[0]);
+    ScBuffer *lut = CreateScBuffer(256, 1, SC_TYPE_U8, &table[0]);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ASSERT_TRUE(in != NULL && lut != NULL && out != NULL);
+
+    EXPECT_EQ(STS_SUCCESS, scvTableLookup(in, lut, out));
+
+    sc_u8 *dst = data<sc_u8>(out);
+    for (size_t i = 0; i < src.size(); i++)
+        ASSERT_EQ(table[src[i]], dst[i]) << "pixel " << i;
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(lut);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, Convolution)
+{
+    std::vector<sc_u8> src(IMAGE_WIDTH * IMAGE_HEIGHT);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = (sc_u8)((i % IMAGE_WIDTH) * 4);
+
+    // horizontal sobel, flipped by the convolution into right - left
+    sc_s16 coef[9] = { 1, 0, -1, 2, 0, -2, 1, 0, -1 };
+
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src[0]);
+    ScBuffer *matrix = CreateScBuffer(3, 3, SC_TYPE_S16, coef);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_S16);
+    ASSERT_TRUE(in != NULL && matrix != NULL && out != NULL);
+
+    EXPECT_EQ(STS_SUCCESS, scvConvolution(in, matrix, out, 3, 2));
+
+    sc_s16 *dst = data<sc_s16>(out);
+    for (int y = 0; y < IMAGE_HEIGHT; y++) {
+        for (int x = 0; x < IMAGE_WIDTH; x++) {
+            bool inner = (y > 0 && y < IMAGE_HEIGHT - 1 && x > 0 && x < IMAGE_WIDTH - 1);
+            ASSERT_EQ(inner ? 16 : 0, dst[y * IMAGE_WIDTH + x]) << "(" << x << ", " << y << ")";
+        }
+    }
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(matrix);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, FastCorners)
+{
+    // a bright square, its four corners are FAST corners
+    std::vector<sc_u8> src(IMAGE_WIDTH * IMAGE_HEIGHT, 0);
+    for (int y = 8; y < 16; y++)
+        for (int x = 10; x < 20; x++)
+            src[y * IMAGE_WIDTH + x] = 200;
+
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src[0]);
+    ScBuffer *raw = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U16);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U16);
+    ASSERT_TRUE(in != NULL && raw != NULL && out != NULL);
+
+    EXPECT_EQ(STS_SUCCESS, scvFastCorners(in, raw, 50, SC_POLICY_CORNERS_9, SC_POLICY_NMS_NO_USE));
+    EXPECT_EQ(STS_SUCCESS, scvFastCorners(in, out, 50, SC_POLICY_CORNERS_9, SC_POLICY_NMS_USE));
+
+    sc_u16 *corner = data<sc_u16>(raw);
+    sc_u16 *nms = data<sc_u16>(out);
+    EXPECT_NE(0, corner[8 * IMAGE_WIDTH + 10]);
+    EXPECT_NE(0, corner[8 * IMAGE_WIDTH + 19]);
+    EXPECT_NE(0, corner[15 * IMAGE_WIDTH + 10]);
+    EXPECT_NE(0, corner[15 * IMAGE_WIDTH + 19]);
+    EXPECT_EQ(0, corner[4 * IMAGE_WIDTH + 4]);
+    EXPECT_EQ(0, corner[12 * IMAGE_WIDTH + 15]);
+
+    int raw_count = 0, nms_count = 0;
+    for (int i = 0; i < IMAGE_WIDTH * IMAGE_HEIGHT; i++) {
+        raw_count += (corner[i] != 0);
+        nms_count += (nms[i] != 0);
+        // a suppressed response is a subset of the raw one
+        if (nms[i] != 0)
+            EXPECT_EQ(corner[i], nms[i]) << "pixel " << i;
+    }
+    EXPECT_GE(nms_count, 4);
+    EXPECT_LE(nms_count, raw_count);
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(raw);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, CannyEdgeDetector)
+{
+    // a vertical step between column 15 and 16
+    std::vector<sc_u8> src(IMAGE_WIDTH * IMAGE_HEIGHT);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = ((i % IMAGE_WIDTH) < 16) ? 20 : 220;
+
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8, &src[0]);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ASSERT_TRUE(in != NULL && out != NULL);
+
+    EXPECT_EQ(STS_SUCCESS, scvCannyEdgeDetector(in, out, SC_POLICY_NORM_L1, 100, 200));
+
+    sc_u8 *dst = data<sc_u8>(out);
+    for (int y = 2; y < IMAGE_HEIGHT - 2; y++) {
+        int edge = 0;
+        for (int x = 0; x < IMAGE_WIDTH; x++) {
+            if (dst[y * IMAGE_WIDTH + x]) {
+                EXPECT_TRUE(x == 15 || x == 16) << "(" << x << ", " << y << ")";
+                edge++;
+            }
+        }
+        EXPECT_GE(edge, 1) << "row " << y;
+    }
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(out);
+}
+
+TEST_F(ScoreEmulatorTest, UnsupportedKernel)
+{
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ASSERT_TRUE(in != NULL);
+
+    ScoreCommand cmd(SCV_HARRISCORNERS);
+    cmd.Put(in);
+    EXPECT_LT(DoOnScore(SCV_HARRISCORNERS, cmd), 0);
+
+    ReleaseScBuffer(in);
+}
+
+TEST_F(ScoreEmulatorTest, Latency)
+{
+    ScBuffer *in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ScBuffer *out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+    ASSERT_TRUE(in != NULL && out != NULL);
+
+    ScoreDeviceEmulator::SetLatency(20000);
+    EXPECT_EQ(20000u, ScoreDeviceEmulator::GetLatency());
+
+    long long start = getTimeUs();
+    EXPECT_EQ(STS_SUCCESS, scvAnd(in, in, out));
+    EXPECT_GE(getTimeUs() - start, 20000);
+
+    ReleaseScBuffer(in);
+    ReleaseScBuffer(out);
+}
+
+struct AndThreadArg {
+    ScBuffer *in;
+    ScBuffer *out;
+    sc_status_t status;
+};
+
+static void *andThread(void *data)
+{
+    AndThreadArg *arg = (AndThreadArg *)data;
+    arg->status = scvAnd(arg->in, arg->in, arg->out);
+    return NULL;
+}
+
+TEST_F(ScoreEmulatorTest, WorkerNum)
+{
+    EXPECT_NE(0, ScoreDeviceEmulator::SetWorkerNum(0));
+    ASSERT_EQ(0, ScoreDeviceEmulator::SetWorkerNum(4));
+    EXPECT_EQ(4u, ScoreDeviceEmulator::GetWorkerNum());
+
+    ScoreDeviceEmulator::SetLatency(50000);
+
+    AndThreadArg arg[4];
+    pthread_t thread[4];
+    for (int i = 0; i < 4; i++) {
+        arg[i].in = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+        arg[i].out = CreateScBuffer(IMAGE_WIDTH, IMAGE_HEIGHT, SC_TYPE_U8);
+        arg[i].status = STS_FAILURE;
+        ASSERT_TRUE(arg[i].in != NULL && arg[i].out != NULL);
+    }
+
+    // four packets overlap on four workers
+    unsigned long count = ScoreDeviceEmulator::GetPacketCount();
+    long long start = getTimeUs();
+    for (int i = 0; i < 4; i++)
+        pthread_create(&thread[i], NULL, andThread, &arg[i]);
+    for (int i = 0; i < 4; i++)
+        pthread_join(thread[i], NULL);
+    long long elapsed = getTimeUs() - start;
+
+    EXPECT_LT(elapsed, 4 * 50000);
+    EXPECT_EQ(count + 4, ScoreDeviceEmulator::GetPacketCount());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(STS_SUCCESS, arg[i].status);
+        ReleaseScBuffer(arg[i].in);
+        ReleaseScBuffer(arg[i].out);
+    }
+}
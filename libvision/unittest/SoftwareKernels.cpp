@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+#include "SoftwareKernels.h"
+
+static std::mutex node_thread_lock;
+static std::map<vx_node, pthread_t> node_thread_map;
+static std::atomic<vx_uint32> init_count(0);
+static std::atomic<vx_uint32> kernel_latency_us(0);
+
+static vx_status VX_CALLBACK swAddOneKernel(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    if (num != 2)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vx_image input = (vx_image)parameters[0];
+    vx_image output = (vx_image)parameters[1];
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t in_addr, out_addr;
+    void *in_base = NULL;
+    void *out_base = NULL;
+    vx_status status;
+
+    status = vxGetValidRegionImage(input, &rect);
+    if (status != VX_SUCCESS)
+        return status;
+
+    status = vxAccessImagePatch(input, &rect, 0, &in_addr, &in_base, VX_READ_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+
+    status = vxAccessImagePatch(output, &rect, 0, &out_addr, &out_base, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS) {
+        vxCommitImagePatch(input, NULL, 0, &in_addr, in_base);
+        return status;
+    }
+
+    for (vx_uint32 y = 0; y < in_addr.dim_y; y++) {
+        vx_uint8 *src = (vx_uint8*)vxFormatImagePatchAddress2d(in_base, 0, y, &in_addr);
+        vx_uint8 *dst = (vx_uint8*)vxFormatImagePatchAddress2d(out_base, 0, y, &out_addr);
+        for (vx_uint32 x = 0; x < in_addr.dim_x; x++)
+            dst[x] = src[x] + 1;
+    }
+
+    if (kernel_latency_us)
+        usleep(kernel_latency_us);
+
+    vxCommitImagePatch(input, NULL, 0, &in_addr, in_base);
+    vxCommitImagePatch(output, &rect, 0, &out_addr, out_base);
+
+    std::lock_guard<std::mutex> lock(node_thread_lock);
+    node_thread_map[node] = pthread_self();
+
+    return VX_SUCCESS;
+}
+
+static vx_status VX_CALLBACK swAddOneInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_parameter param = vxGetParameterByIndex(node, index);
+    vx_image input = NULL;
+    vx_df_image format = VX_DF_IMAGE_VIRT;
+    vx_status status;
+
+    status = vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &input, sizeof(input));
+    if (status == VX_SUCCESS) {
+        vxQueryImage(input, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+        if (format != VX_DF_IMAGE_U8)
+            status = VX_ERROR_INVALID_FORMAT;
+        vxReleaseImage(&input);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK swAddOneOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_parameter param = vxGetParameterByIndex(node, 0);
+    vx_image input = NULL;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format = VX_DF_IMAGE_U8;
+    vx_status status;
+
+    if (index != 1) {
+        vxReleaseParameter(&param);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &input, sizeof(input));
+    if (status == VX_SUCCESS) {
+        vxQueryImage(input, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+        vxQueryImage(input, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+        vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+        vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+        vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+        vxReleaseImage(&input);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_kernel addSwAddOneKernel(vx_context context, const vx_char *target_name)
+{
+    vx_char kernel_name[VX_MAX_KERNEL_NAME];
+    vx_enum kernel_enum = VX_KERNEL_BASE(VX_ID_SAMSUNG, 0) + 0x800;
+    vx_kernel kernel;
+
+    /* each software target gets its own copy of the kernel */
+    if (strcmp(target_name, SW_TARGET_NAME) != 0)
+        kernel_enum++;
+
+    snprintf(kernel_name, sizeof(kernel_name), "%s.add_one", target_name);
+    kernel = vxAddKernel(context, kernel_name, kernel_enum, swAddOneKernel, 2,
+                                swAddOneInputValidator, swAddOneOutputValidator, NULL, NULL);
+    if (vxGetStatus((vx_reference)kernel) != VX_SUCCESS)
+        return NULL;
+
+    if ((vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxAddParameterToKernel(kernel, 1, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxFinalizeKernel(kernel) != VX_SUCCESS)) {
+        vxRemoveKernel(kernel);
+        return NULL;
+    }
+
+    return kernel;
+}
+
+static vx_status VX_CALLBACK swAddKernel(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    if (num != 4)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vx_image in1 = (vx_image)parameters[0];
+    vx_image in2 = (vx_image)parameters[1];
+    vx_scalar policy_param = (vx_scalar)parameters[2];
+    vx_image output = (vx_image)parameters[3];
+    vx_enum policy = VX_CONVERT_POLICY_WRAP;
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t in1_addr, in2_addr, out_addr;
+    void *in1_base = NULL;
+    void *in2_base = NULL;
+    void *out_base = NULL;
+    vx_status status;
+
+    status = vxReadScalarValue(policy_param, &policy);
+    if (status == VX_SUCCESS)
+        status = vxGetValidRegionImage(in1, &rect);
+    if (status != VX_SUCCESS)
+        return status;
+
+    if (vxAccessImagePatch(in1, &rect, 0, &in1_addr, &in1_base, VX_READ_ONLY) != VX_SUCCESS)
+        return VX_FAILURE;
+    if (vxAccessImagePatch(in2, &rect, 0, &in2_addr, &in2_base, VX_READ_ONLY) != VX_SUCCESS) {
+        vxCommitImagePatch(in1, NULL, 0, &in1_addr, in1_base);
+        return VX_FAILURE;
+    }
+    if (vxAccessImagePatch(output, &rect, 0, &out_addr, &out_base, VX_WRITE_ONLY) != VX_SUCCESS) {
+        vxCommitImagePatch(in1, NULL, 0, &in1_addr, in1_base);
+        vxCommitImagePatch(in2, NULL, 0, &in2_addr, in2_base);
+        return VX_FAILURE;
+    }
+
+    for (vx_uint32 y = 0; y < in1_addr.dim_y; y++) {
+        vx_uint8 *src1 = (vx_uint8*)vxFormatImagePatchAddress2d(in1_base, 0, y, &in1_addr);
+        vx_uint8 *src2 = (vx_uint8*)vxFormatImagePatchAddress2d(in2_base, 0, y, &in2_addr);
+        vx_uint8 *dst = (vx_uint8*)vxFormatImagePatchAddress2d(out_base, 0, y, &out_addr);
+        for (vx_uint32 x = 0; x < in1_addr.dim_x; x++) {
+            vx_uint32 sum = src1[x] + src2[x];
+            if ((policy == VX_CONVERT_POLICY_SATURATE) && (sum > 255))
+                sum = 255;
+            dst[x] = (vx_uint8)sum;
+        }
+    }
+
+    vxCommitImagePatch(in1, NULL, 0, &in1_addr, in1_base);
+    vxCommitImagePatch(in2, NULL, 0, &in2_addr, in2_base);
+    vxCommitImagePatch(output, &rect, 0, &out_addr, out_base);
+
+    return VX_SUCCESS;
+}
+
+static vx_status VX_CALLBACK swAddInputValidator(vx_node node, vx_uint32 index)
+{
+    if (index == 2)
+        return VX_SUCCESS;
+
+    return swAddOneInputValidator(node, index);
+}
+
+static vx_status VX_CALLBACK swAddOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    /* the output follows the first input like add_one */
+    return swAddOneOutputValidator(node, (index == 3) ? 1 : index, meta);
+}
+
+static vx_status VX_CALLBACK swInitialize(vx_node node, const vx_reference *parameters, vx_uint32 num)
+{
+    init_count++;
+
+    return VX_SUCCESS;
+}
+
+vx_kernel addSwAddKernel(vx_context context)
+{
+    vx_kernel kernel;
+
+    kernel = vxAddKernel(context, SW_TARGET_NAME ".add", VX_KERNEL_ADD, swAddKernel, 4,
+                                swAddInputValidator, swAddOutputValidator, swInitialize, NULL);
+    if (vxGetStatus((vx_reference)kernel) != VX_SUCCESS)
+        return NULL;
+
+    if ((vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxAddParameterToKernel(kernel, 3, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED) != VX_SUCCESS) ||
+        (vxFinalizeKernel(kernel) != VX_SUCCESS)) {
+        vxRemoveKernel(kernel);
+        return NULL;
+    }
+
+    return kernel;
+}
+
+void setSwKernelLatency(vx_uint32 latency_us)
+{
+    kernel_latency_us = latency_us;
+}
+
+vx_uint32 getSwInitCount(void)
+{
+    return init_count;
+}
+
+void clearSwInitCount(void)
+{
+    init_count = 0;
+}
+
+pthread_t getSwNodeThread(vx_node node)
+{
+    std::lock_guard<std::mutex> lock(node_thread_lock);
+    std::map<vx_node, pthread_t>::iterator iter = node_thread_map.find(node);
+
+    return (iter != node_thread_map.end()) ? iter->second : 0;
+}
+
+void clearSwNodeThreads(void)
+{
+    std::lock_guard<std::mutex> lock(node_thread_lock);
+    node_thread_map.clear();
+}
+
+void fillImage(vx_image image, vx_uint8 value)
+{
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr;
+    void *base = NULL;
+
+    vxGetValidRegionImage(image, &rect);
+    if (vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_WRITE_ONLY) != VX_SUCCESS)
+        return;
+
+    for (vx_uint32 y = 0; y < addr.dim_y; y++)
+        memset(vxFormatImagePatchAddress2d(base, 0, y, &addr), value, addr.dim_x);
+
+    vxCommitImagePatch(image, &rect, 0, &addr, base);
+}
+
+vx_uint8 readImagePixel(vx_image image, vx_uint32 x, vx_uint32 y)
+{
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr;
+    void *base = NULL;
+    vx_uint8 value;
+
+    vxGetValidRegionImage(image, &rect);
+    if (vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_READ_ONLY) != VX_SUCCESS)
+        return 0;
+
+    value = *(vx_uint8*)vxFormatImagePatchAddress2d(base, x, y, &addr);
+    vxCommitImagePatch(image, NULL, 0, &addr, base);
+
+    return value;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_SOFTWARE_KERNELS_H
+#define EXYNOS_VISION_SOFTWARE_KERNELS_H
+
+#include <pthread.h>
+
+#include <VX/vx.h>
+
+/* Software targets, the kernels run on the CPU in the subgraph thread */
+#define SW_TARGET_NAME          "com.samsung.sw"
+#define SW_ALT_TARGET_NAME      "com.samsung.swalt"
+
+/* out = in + 1, U8 images of the same size */
+vx_kernel addSwAddOneKernel(vx_context context, const vx_char *target_name);
+
+/* VX_KERNEL_ADD on the software target, U8 images only */
+vx_kernel addSwAddKernel(vx_context context);
+
+/* time the software kernels spend in addition to their work, 0 by default */
+void setSwKernelLatency(vx_uint32 latency_us);
+
+/* how many times the kernels of the software targets were initialized */
+vx_uint32 getSwInitCount(void);
+void clearSwInitCount(void);
+
+/* the thread that last executed the node, 0 if it never ran */
+pthread_t getSwNodeThread(vx_node node);
+void clearSwNodeThreads(void);
+
+void fillImage(vx_image image, vx_uint8 value);
+vx_uint8 readImagePixel(vx_image image, vx_uint32 x, vx_uint32 y);
+
+#endif
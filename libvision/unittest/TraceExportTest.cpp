@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Timing export of vxExportContextTrace. The binary dump is read back with the
+ * layout of ExynosVisionTraceFormat.h, as the host tool does.
+ */
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+#include <VX/vx_types_ext.h>
+
+#include "ExynosVisionTraceFormat.h"
+#include "SoftwareKernels.h"
+
+#define IMAGE_WIDTH     64
+#define IMAGE_HEIGHT    48
+
+class TraceExportTest : public ::testing::Test {
+protected:
+    vx_context m_context;
+    vx_kernel m_kernel;
+    vx_kernel m_alt_kernel;
+
+    trace_file_header_t m_header;
+    std::map<uint32_t, trace_object_t> m_objects;
+    std::vector<trace_record_t> m_records;
+
+    virtual void SetUp()
+    {
+        m_context = vxCreateContext();
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_context));
+
+        m_kernel = addSwAddOneKernel(m_context, SW_TARGET_NAME);
+        ASSERT_TRUE(m_kernel != NULL);
+        m_alt_kernel = addSwAddOneKernel(m_context, SW_ALT_TARGET_NAME);
+        ASSERT_TRUE(m_alt_kernel != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        vxReleaseKernel(&m_kernel);
+        vxReleaseKernel(&m_alt_kernel);
+        vxReleaseContext(&m_context);
+    }
+
+    void setTrace(vx_bool enable)
+    {
+        ASSERT_EQ(VX_SUCCESS, vxSetContextAttribute(m_context, VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE, &enable, sizeof(enable)));
+    }
+
+    /* input -> sw -> swalt -> sw -> output, one subgraph per node */
+    void runChain(vx_uint32 depth, vx_uint32 frame_num)
+    {
+        vx_graph graph = vxCreateGraph(m_context);
+        ASSERT_EQ(VX_SUCCESS, vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth)));
+
+        vx_image input = vxCreateImage(m_context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+        vx_image output = vxCreateImage(m_context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+        vx_image virt[2];
+        for (vx_uint32 i = 0; i < 2; i++)
+            virt[i] = vxCreateVirtualImage(graph, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+
+        vx_node nodes[3];
+        vx_image src[3] = {input, virt[0], virt[1]};
+        vx_image dst[3] = {virt[0], virt[1], output};
+        for (vx_uint32 i = 0; i < 3; i++) {
+            nodes[i] = vxCreateGenericNode(graph, (i % 2) ? m_alt_kernel : m_kernel);
+            vxSetParameterByIndex(nodes[i], 0, (vx_reference)src[i]);
+            vxSetParameterByIndex(nodes[i], 1, (vx_reference)dst[i]);
+        }
+
+        fillImage(input, 0);
+        ASSERT_EQ(VX_SUCCESS, vxVerifyGraph(graph));
+
+        for (vx_uint32 frame = 0; frame < frame_num; frame++) {
+            if (depth > 1)
+                ASSERT_EQ(VX_SUCCESS, vxScheduleGraph(graph));
+            else
+                ASSERT_EQ(VX_SUCCESS, vxProcessGraph(graph));
+        }
+        if (depth > 1)
+            ASSERT_EQ(VX_SUCCESS, vxWaitGraph(graph));
+        EXPECT_EQ(3, readImagePixel(output, 0, 0));
+
+        for (vx_uint32 i = 0; i < 3; i++)
+            vxReleaseNode(&nodes[i]);
+        for (vx_uint32 i = 0; i < 2; i++)
+            vxReleaseImage(&virt[i]);
+        vxReleaseImage(&input);
+        vxReleaseImage(&output);
+        vxReleaseGraph(&graph);
+    }
+
+    void readDump(const std::string &path)
+    {
+        FILE *fp = fopen(path.c_str(), "rb");
+        ASSERT_TRUE(fp != NULL);
+
+        ASSERT_EQ(1u, fread(&m_header, sizeof(m_header), 1, fp));
+        EXPECT_EQ((uint32_t)TRACE_FILE_MAGIC, m_header.magic);
+        EXPECT_EQ((uint32_t)TRACE_FILE_VERSION, m_header.version);
+
+        for (uint32_t i = 0; i < m_header.object_num; i++) {
+            trace_object_t object;
+            ASSERT_EQ(1u, fread(&object, sizeof(object), 1, fp));
+            m_objects[object.id] = object;
+        }
+
+        m_records.resize(m_header.record_num);
+        if (m_header.record_num)
+            ASSERT_EQ(m_header.record_num, fread(&m_records[0], sizeof(trace_record_t), m_header.record_num, fp));
+
+        fclose(fp);
+    }
+
+    vx_uint32 countRecords(uint32_t type)
+    {
+        vx_uint32 count = 0;
+
+        for (size_t i = 0; i < m_records.size(); i++) {
+            if (m_records[i].type == type)
+                count++;
+        }
+
+        return count;
+    }
+};
+
+TEST_F(TraceExportTest, DisabledByDefault)
+{
+    vx_bool enable = vx_true_e;
+    std::string path = ::testing::TempDir() + "vision_trace_disabled.bin";
+
+    EXPECT_EQ(VX_SUCCESS, vxQueryContext(m_context, VX_CONTEXT_ATTRIBUTE_TRACE_ENABLE, &enable, sizeof(enable)));
+    EXPECT_EQ(vx_false_e, enable);
+
+    runChain(1, 2);
+
+    ASSERT_EQ(VX_SUCCESS, vxExportContextTrace(m_context, VX_TRACE_FORMAT_BINARY, path.c_str()));
+    readDump(path);
+    EXPECT_EQ(0u, m_header.record_num);
+    EXPECT_EQ(0u, m_header.object_num);
+
+    remove(path.c_str());
+}
+
+TEST_F(TraceExportTest, CapacityIsFixedOnceEnabled)
+{
+    vx_uint32 capacity = 1000;
+
+    ASSERT_EQ(VX_SUCCESS, vxSetContextAttribute(m_context, VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY, &capacity, sizeof(capacity)));
+    ASSERT_EQ(VX_SUCCESS, vxQueryContext(m_context, VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY, &capacity, sizeof(capacity)));
+    EXPECT_EQ(1024u, capacity);
+
+    setTrace(vx_true_e);
+    EXPECT_EQ(VX_ERROR_NOT_SUPPORTED, vxSetContextAttribute(m_context, VX_CONTEXT_ATTRIBUTE_TRACE_CAPACITY, &capacity, sizeof(capacity)));
+}
+
+TEST_F(TraceExportTest, RecordsEveryFrameAndCause)
+{
+    const vx_uint32 frame_num = 4;
+    std::string path = ::testing::TempDir() + "vision_trace.bin";
+
+    setTrace(vx_true_e);
+    runChain(2, frame_num);
+    setTrace(vx_false_e);
+
+    ASSERT_EQ(VX_SUCCESS, vxExportContextTrace(m_context, VX_TRACE_FORMAT_BINARY, path.c_str()));
+    readDump(path);
+    remove(path.c_str());
+
+    EXPECT_EQ(0u, m_header.dropped_num);
+    EXPECT_EQ(frame_num, countRecords(TRACE_EVENT_GRAPH_FRAME));
+    EXPECT_EQ(3 * frame_num, countRecords(TRACE_EVENT_SUBGRAPH_FRAME));
+    EXPECT_EQ(3 * frame_num, countRecords(TRACE_EVENT_SUBGRAPH_QUEUE_WAIT));
+    EXPECT_EQ(3 * frame_num, countRecords(TRACE_EVENT_SUBGRAPH_RESOURCE_WAIT));
+    EXPECT_EQ(3 * frame_num, countRecords(TRACE_EVENT_NODE_EXECUTE));
+    EXPECT_EQ(3 * frame_num, countRecords(TRACE_EVENT_NODE_FRAMEWORK));
+
+    /* the chain is caused by the graph trigger and then by the previous subgraph */
+    for (size_t i = 0; i < m_records.size(); i++) {
+        const trace_record_t &record = m_records[i];
+        EXPECT_LE(record.start_us, record.end_us);
+        ASSERT_TRUE(m_objects.count(record.object_id));
+
+        if (record.type != TRACE_EVENT_SUBGRAPH_FRAME)
+            continue;
+
+        const trace_object_t &subgraph = m_objects[record.object_id];
+        EXPECT_EQ((uint32_t)TRACE_OBJECT_SUBGRAPH, subgraph.kind);
+        ASSERT_TRUE(m_objects.count(record.cause_id));
+
+        const trace_object_t &cause = m_objects[record.cause_id];
+        if (cause.kind == TRACE_OBJECT_GRAPH) {
+            EXPECT_EQ(subgraph.parent_id, cause.id);
+        } else {
+            EXPECT_EQ((uint32_t)TRACE_OBJECT_SUBGRAPH, cause.kind);
+            EXPECT_NE(subgraph.id, cause.id);
+        }
+    }
+}
+
+TEST_F(TraceExportTest, ExportsChromeJson)
+{
+    std::string path = ::testing::TempDir() + "vision_trace.json";
+
+    setTrace(vx_true_e);
+    runChain(1, 2);
+
+    ASSERT_EQ(VX_SUCCESS, vxExportContextTrace(m_context, VX_TRACE_FORMAT_CHROME_JSON, path.c_str()));
+
+    FILE *fp = fopen(path.c_str(), "r");
+    ASSERT_TRUE(fp != NULL);
+    std::string json;
+    char buf[1024];
+    size_t size;
+    while ((size = fread(buf, 1, sizeof(buf), fp)) > 0)
+        json.append(buf, size);
+    fclose(fp);
+    remove(path.c_str());
+
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"cat\":\"node\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"queue wait\""));
+    EXPECT_EQ(std::string::npos, json.find("\"name\":\"\""));
+    EXPECT_EQ("]}\n", json.substr(json.size() - 3));
+
+    EXPECT_EQ(VX_ERROR_INVALID_PARAMETERS, vxExportContextTrace(m_context, VX_TYPE_INVALID, path.c_str()));
+}